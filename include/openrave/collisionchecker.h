@@ -78,6 +78,12 @@ public:
         bodyLinkGeom1Name.clear();
         bodyLinkGeom2Name.clear();
         contacts.clear();
+        bodyIndex1 = 0;
+        linkIndex1 = -1;
+        geomIndex1 = -1;
+        bodyIndex2 = 0;
+        linkIndex2 = -1;
+        geomIndex2 = -1;
     }
     
     void SaveToJson(rapidjson::Value& rCollisionPair, rapidjson::Document::AllocatorType& alloc) const;
@@ -92,6 +98,32 @@ public:
     void SetFirstCollision(const std::string& bodyname, const std::string& linkname, const std::string& geomname);
     void SetSecondCollision(const std::string& bodyname, const std::string& linkname, const std::string& geomname);
 
+    /// \brief sets the indices of the first collision, does not touch the names
+    inline void SetFirstCollisionIndices(int bodyIndex, int linkIndex, int geomIndex) {
+        bodyIndex1 = bodyIndex;
+        linkIndex1 = linkIndex;
+        geomIndex1 = geomIndex;
+    }
+    inline void SetSecondCollisionIndices(int bodyIndex, int linkIndex, int geomIndex) {
+        bodyIndex2 = bodyIndex;
+        linkIndex2 = linkIndex;
+        geomIndex2 = geomIndex;
+    }
+
+    /// \brief true if the first collision was recorded with indices only and its names were not resolved yet
+    inline bool IsFirstIndexOnly() const {
+        return bodyIndex1 > 0 && bodyLinkGeom1Name.empty();
+    }
+    inline bool IsSecondIndexOnly() const {
+        return bodyIndex2 > 0 && bodyLinkGeom2Name.empty();
+    }
+
+    /// \brief fills bodyLinkGeom1Name and bodyLinkGeom2Name from the indices if they are not set yet
+    ///
+    /// The indices have to refer to the current state of env, so names should be resolved before bodies are removed from it.
+    /// \return false if one of the bodies is not in env anymore, its name is left empty
+    bool ResolveNames(const EnvironmentBase& env);
+
     /// \brief extracts the first body name
     void ExtractFirstBodyName(string_view& bodyname) const;
     void ExtractSecondBodyName(string_view& bodyname) const;
@@ -128,8 +160,15 @@ public:
     KinBodyPtr ExtractSecondBody(EnvironmentBase& env) const;
     
     // to save on dynamic allocation, only have one string per body/link/geom. Given that names cannot have spaces, can separate with spaces
-    std::string bodyLinkGeom1Name; ///< "bodyname linkname geomname" for first collision
-    std::string bodyLinkGeom2Name; ///< "bodyname linkname geomname" for second collision
+    std::string bodyLinkGeom1Name; ///< "bodyname linkname geomname" for first collision. Empty if the report was filled with CollisionReport::bIndexOnly until \ref ResolveNames is called
+    std::string bodyLinkGeom2Name; ///< "bodyname linkname geomname" for second collision. Empty if the report was filled with CollisionReport::bIndexOnly until \ref ResolveNames is called
+
+    int bodyIndex1 = 0; ///< KinBody::GetEnvironmentBodyIndex of the first collision, 0 if not set
+    int linkIndex1 = -1; ///< KinBody::Link::GetIndex of the first collision, -1 if not set
+    int geomIndex1 = -1; ///< index into KinBody::Link::GetGeometries of the first collision, -1 if not set, if the report is not CollisionReport::bIndexOnly, or if it is not in the current geometries of the link
+    int bodyIndex2 = 0; ///< KinBody::GetEnvironmentBodyIndex of the second collision, 0 if not set
+    int linkIndex2 = -1; ///< KinBody::Link::GetIndex of the second collision, -1 if not set
+    int geomIndex2 = -1; ///< index into KinBody::Link::GetGeometries of the second collision, -1 if not set, if the report is not CollisionReport::bIndexOnly, or if it is not in the current geometries of the link
 
     std::vector<CONTACT> contacts; ///< the convention is that the normal will be "out" of pgeom1's surface. Filled if CO_UseContacts option is set.
 };
@@ -169,6 +208,18 @@ public:
     // set only one collision
     int SetLinkGeomCollision(const KinBody::LinkConstPtr& plink1, const KinBody::GeometryConstPtr& pgeom1, const KinBody::LinkConstPtr& plink2, const KinBody::GeometryConstPtr& pgeom2);
 
+    /// \brief preallocates the collision pairs and their contacts so that the following queries do not allocate
+    ///
+    /// The pairs of vCollisionInfos are never freed by \ref Reset, so a report that is reused across queries keeps its memory.
+    /// \param numCollisions number of collision pairs to allocate
+    /// \param numContactsPerCollision number of contacts to reserve in every pair
+    void Reserve(int numCollisions, int numContactsPerCollision=0);
+
+    /// \brief resolves the names of all the valid collisions recorded with bIndexOnly, see \ref CollisionPairInfo::ResolveNames
+    ///
+    /// \return false if some of the bodies are not in env anymore
+    bool ResolveNames(const EnvironmentBase& env);
+
     std::vector<CollisionPairInfo> vCollisionInfos; ///< all geometry collision pairs. Set when CO_AllGeometryCollisions or CO_AllLinkCollisions or CO_AllGeometryContacts is enabled. The size of the array is not indicative of how many valid collisions there are! See nNumValidCollisions instead. Due to caching and memory constraints, should not resize this vector, instead change nNumValidCollisions
     int nNumValidCollisions = 0; ///< how many infos are valid in vCollisionInfos
     int options = 0; ///< mix of CO_X, the options that the CollisionReport was called with. It is overwritten by the options set on the collision checker writing the report
@@ -176,6 +227,7 @@ public:
     dReal minDistance = 1e20; ///< minimum distance from last query, filled if CO_Distance option is set
     int16_t numWithinTol = 0; ///< number of objects within tolerance of this object, filled if CO_UseTolerance option is set
     uint8_t nKeepPrevious = 0; ///< if 1, will keep all previous data when resetting the collision checker. otherwise will reset
+    bool bIndexOnly = false; ///< if true, the collisions only record the body, link, and geometry indices and leave the names empty. Formatting the names is the main cost of the reports of CO_AllLinkCollisions and CO_AllGeometryCollisions queries, they can be resolved on demand with \ref ResolveNames. Kept by \ref Reset.
 };
 
 typedef CollisionReport COLLISIONREPORT RAVE_DEPRECATED;
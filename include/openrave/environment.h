@@ -263,6 +263,10 @@ public:
         \code
         DAE::getIOPlugin()->setOption(key,value).
         \endcode
+
+        The "collisionlods" attribute holds "groupname errortolerance" pairs. For each pair, every loaded body gets a geometry group
+        where the large collision meshes are decimated with TriMesh::Simplify at that tolerance. Decimated meshes are cached in the database by mesh hash.
+        The decimated groups are not conservative, they can miss contacts up to the tolerance deep.
      */
     virtual bool Load(const std::string& filename, const AttributesList& atts = AttributesList()) = 0;
 
@@ -2351,6 +2351,7 @@ private:
         Save_ActiveManipulatorToolTransform  = 0x00080000, ///< [robot only], saves the active manipulator's LocalToolTransform, LocalToolDirection, and IkSolver
         Save_ManipulatorsToolTransform       = 0x00100000, ///< [robot only], saves every manipulator's LocalToolTransform, LocalToolDirection, and IkSolver
         Save_ConnectedBodies                 = 0x00200000, ///< [robot only], saves the connected body states
+        Save_Lightweight                     = 0x01000000, ///< modifier for the other options. The link transformations and enable states are stored in buffers reused from the body instead of newly allocated, and the link transformations are restored only if the body state changed since it was saved (see \ref GetUpdateStamp). Bodies grabbed by the body are always restored. Use for savers constructed in tight loops.
     };
 
     /// \brief info structure used to initialize a kinbody
@@ -2449,6 +2450,7 @@ protected:
         std::vector<dReal> _vdoflastsetvalues;
         std::vector<dReal> _vMaxVelocities, _vMaxAccelerations, _vMaxJerks, _vDOFWeights, _vDOFLimits[2], _vDOFResolutions;
         std::vector<GrabbedPtr> _vGrabbedBodies;
+        int _nSavedUpdateStamp; ///< update stamp of the body once the state is saved or restored, used by Save_Lightweight
         bool _bRestoreOnDestructor;
 private:
         virtual void _RestoreKinBody(boost::shared_ptr<KinBody> body);
@@ -2495,6 +2497,7 @@ protected:
         std::vector<dReal> _vdoflastsetvalues;
         std::vector<dReal> _vMaxVelocities, _vMaxAccelerations, _vMaxJerks, _vDOFWeights, _vDOFLimits[2], _vDOFResolutions;
         std::vector<GrabbedPtr> _vGrabbedBodies;
+        int _nSavedUpdateStamp; ///< update stamp of the body once the state is saved or restored, used by Save_Lightweight
         bool _bRestoreOnDestructor;
         bool _bReleased; ///< if true, then body should not be restored
 private:
@@ -3123,6 +3126,33 @@ private:
      */
     virtual void ComputeInverseDynamics(boost::array< std::vector<dReal>, 3>& doftorquecomponents, const std::vector<dReal>& dofaccelerations, const ForceTorqueMap& externalforcetorque=ForceTorqueMap()) const;
 
+    /** \brief Computes the inverse dynamics for a batch of states.
+
+        Equivalent to setting every (dofvalues, dofvelocities) state and calling \ref ComputeInverseDynamics, except that all the intermediate
+        buffers are reused across the samples and calls, so after the first call no memory is allocated for bodies without mimic joints.
+        The state of the body is restored before returning.
+        \param[out] doftorques numsamples*GetDOF() torques, where the torques of sample i start at i*GetDOF()
+        \param[in] dofvalues numsamples*GetDOF() dof values
+        \param[in] dofvelocities numsamples*GetDOF() dof velocities. If the size is 0, assumes all velocities are 0
+        \param[in] dofaccelerations numsamples*GetDOF() dof accelerations. If the size is 0, assumes all accelerations are 0
+        \param[in] externalforcetorque [optional] Specifies all the external forces/torques acting on the links at their center of mass, applied to every sample.
+     */
+    virtual void ComputeInverseDynamicsBatch(std::vector<dReal>& doftorques, const std::vector<dReal>& dofvalues, const std::vector<dReal>& dofvelocities, const std::vector<dReal>& dofaccelerations, const ForceTorqueMap& externalforcetorque=ForceTorqueMap());
+
+    /** \brief Computes the joint-space inertia matrix M(dofvalues) at the current dof values.
+
+        Column i is the inverse dynamics torque of a unit acceleration of dof i with zero velocities and no gravity, so it includes the
+        reflected rotor inertia of electric motors.
+        \param[out] massmatrix GetDOF()*GetDOF() symmetric matrix in row-major order
+     */
+    virtual void ComputeMassMatrix(std::vector<dReal>& massmatrix) const;
+
+    /// \brief Computes the coriolis and centripetal torques C(dofvalues,dofvel)*dofvel at the current dof values and velocities, without gravity and motor friction.
+    virtual void ComputeCoriolisTorques(std::vector<dReal>& coriolistorques) const;
+
+    /// \brief Computes the torques G(dofvalues) needed to hold the current dof values against the gravity of the physics engine.
+    virtual void ComputeGravityTorques(std::vector<dReal>& gravitytorques) const;
+
     /** \brief Computes dynamic limits for acceleration and jerks, which are dynamically changing based on the given positions and velocities of the robot.
 
         Since not all robots supports dynamic limits, so this function should be overriden in the subclass.
@@ -3283,6 +3313,27 @@ private:
     /// \param adjacentoptions a bitmask of \ref AdjacentOptions values
     virtual const std::vector<int>& GetNonAdjacentLinks(int adjacentoptions=0) const;
 
+    /** \brief computes for every non-adjacent link pair the regions of joint space where the two links provably cannot collide.
+
+        Each link is bounded by a sphere around its local AABB. For a pair, only the dofs that move one link relative to the other
+        matter, and the distance between the two spheres changes at most by a constant times the change of each of these dofs. The
+        joint limits of these dofs are subdivided until the distance at the center of a cell is larger than the most it can change
+        inside the cell, or until maxevaluations forward kinematics evaluations were spent on the pair.
+
+        Pairs that cannot collide anywhere in the joint limits are removed from \ref GetNonAdjacentLinks. For the rest, the collision
+        checkers can skip the pair at runtime with \ref IsLinkPairCollisionFree. Bodies with closed loops or mimic joints, and pairs
+        moved by joints that are not 1-dof revolute or prismatic, are left as they are.
+        The result is cleared whenever the non-adjacent links are recomputed or the geometry or the joint limits change.
+        \param maxevaluations maximum number of sphere distance evaluations per link pair
+        \return the number of link pairs removed from the non-adjacent links
+     */
+    int ComputeSelfCollisionLinkPairCulling(int maxevaluations=256);
+
+    /// \brief returns true if \ref ComputeSelfCollisionLinkPairCulling proved that the two links cannot collide at the current dof values.
+    ///
+    /// Returns false if nothing is known about the pair.
+    bool IsLinkPairCollisionFree(int linkindex0, int linkindex1) const;
+
     /// \brief adds the pair of links to the adjacency list. This is
     void SetAdjacentLinks(int linkindex0, int linkindex1);
 
@@ -3605,6 +3656,13 @@ protected:
     /// \param[in] externalaccelerations [optional] The external accelerations to add to each link. When doing inverse dynamics, should set the base link's acceleration to -gravity.
     virtual void _ComputeLinkAccelerations(const std::vector<dReal>& dofvelocities, const std::vector<dReal>& dofaccelerations, const std::vector< std::pair<Vector, Vector> >& linkvelocities, std::vector<std::pair<Vector,Vector> >& linkaccelerations, AccelerationMapConstPtr externalaccelerations=AccelerationMapConstPtr()) const;
 
+    /// \brief Recursive Newton Euler inverse dynamics of the current state using the _vDynamics*Cache buffers. \see ComputeInverseDynamics
+    ///
+    /// \param vgravity the gravity acceleration, set to 0 to ignore gravity
+    /// \param bUseVelocities if false, assumes all the link and dof velocities are 0
+    /// \param bAddFriction if true, adds the coulomb and viscous friction of the electric motors
+    void _ComputeInverseDynamics(std::vector<dReal>& doftorques, const std::vector<dReal>& dofaccelerations, const ForceTorqueMap& externalforcetorque, const Vector& vgravity, bool bUseVelocities, bool bAddFriction) const;
+
     /// \brief Called to notify the body that certain groups of parameters have been changed.
     ///
     /// This function in calls every registers calledback that is tracking the changes. It also
@@ -3687,6 +3745,42 @@ protected:
 
     mutable boost::array<std::vector<int>, 4> _vNonAdjacentLinks; ///< contains cached versions of the non-adjacent links depending on values in AdjacentOptions. Declared as mutable since data is cached.
     mutable boost::array<std::set<int>, 4> _cacheSetNonAdjacentLinks; ///< used for caching return value of GetNonAdjacentLinks.
+    /// \brief node of the kd-tree over the joint space of a link pair computed by ComputeSelfCollisionLinkPairCulling
+    struct LinkPairCullingNode
+    {
+        dReal splitvalue; ///< values below go to firstchild, the rest to firstchild+1
+        int32_t firstchild; ///< index of the first child, or -1 if leaf
+        int8_t splitdof; ///< index into LinkPairCulling::vdofindices
+        uint8_t bCollisionFree; ///< for leaves, 1 if the links cannot collide anywhere in the cell
+    };
+
+    /// \brief culling information of one link pair
+    struct LinkPairCulling
+    {
+        std::vector<int> vdofindices; ///< dofs moving one link relative to the other
+        std::vector<dReal> vlower, vupper; ///< range of the root cell for each of vdofindices
+        std::vector<uint8_t> vcircular; ///< 1 if the dof is circular and its value has to be wrapped into [vlower, vlower+2*pi)
+        std::vector<LinkPairCullingNode> vnodes; ///< vnodes[0] is the root
+    };
+
+    std::vector<LinkPairCulling> _vLinkPairCulling; ///< \see ComputeSelfCollisionLinkPairCulling
+    std::vector<int32_t> _vLinkPairCullingIndices; ///< index into _vLinkPairCulling for every pair of links (linkindex0*numlinks+linkindex1), -1 if the pair has no culling information. Empty if no culling is computed or nothing was culled.
+
+    /// \brief buffers handed out to state savers constructed with Save_Lightweight, so that savers in tight loops do not allocate
+    struct StateSaverBuffers
+    {
+        std::vector<Transform> vLinkTransforms;
+        std::vector<dReal> vdoflastsetvalues;
+        std::vector<uint8_t> vEnabledLinks;
+    };
+    std::vector<StateSaverBuffers> _vStateSaverBuffersPool; ///< buffers not used by any state saver, one is taken by every nested state saver
+
+    /// \brief moves pooled buffers into the passed vectors, which should be empty
+    void _AcquireStateSaverBuffers(std::vector<Transform>& vLinkTransforms, std::vector<dReal>& vdoflastsetvalues, std::vector<uint8_t>& vEnabledLinks);
+
+    /// \brief moves the vectors back to the pool, leaving them empty
+    void _ReleaseStateSaverBuffers(std::vector<Transform>& vLinkTransforms, std::vector<dReal>& vdoflastsetvalues, std::vector<uint8_t>& vEnabledLinks);
+
     mutable int _nNonAdjacentLinkCache; ///< specifies what information is currently valid in the AdjacentOptions.  Declared as mutable since data is cached. If 0x80000000 (ie < 0), then everything needs to be recomputed including _setNonAdjacentLinks[0].
     std::vector<Transform> _vInitialLinkTransformations; ///< the initial transformations of each link specifying at least one pose where the robot is collision free
 
@@ -3696,6 +3790,15 @@ protected:
     mutable std::vector< boost::array<dReal, 3> > _vPassiveJointAccelerationsCache;
     mutable std::vector<uint8_t> _vLinksVisitedCache;
     mutable std::vector<dReal> _vTempMimicValues, _vTempMimicValues2, _vTempMimicValues3;
+    mutable std::vector<uint8_t> _vLinksAccelerationComputedCache; ///< used by _ComputeLinkAccelerations
+    // caches for _ComputeInverseDynamics
+    mutable std::vector<dReal> _vDynamicsDOFVelocitiesCache;
+    mutable std::vector<std::pair<Vector,Vector> > _vDynamicsLinkVelocitiesCache, _vDynamicsLinkAccelerationsCache, _vDynamicsLinkForceTorquesCache;
+    mutable std::vector<Vector> _vDynamicsLinkCOMLinearAccelerationsCache, _vDynamicsLinkCOMMomentOfInertiaCache;
+    mutable std::vector<std::pair<int,dReal> > _vDynamicsPartialsCache;
+    mutable AccelerationMapPtr _pDynamicsExternalAccelerationsCache;
+    // caches for ComputeInverseDynamicsBatch and ComputeMassMatrix
+    mutable std::vector<dReal> _vDynamicsSampleVelocitiesCache, _vDynamicsSampleAccelerationsCache, _vDynamicsSampleTorquesCache;
 
 
     ConfigurationSpecification _spec;
@@ -108,6 +108,7 @@ namespace OpenRAVE {
 #include <rapidjson/document.h>
 
 #include <openrave/logging.h>
+#include <openrave/profiling.h>
 
 namespace OpenRAVE {
 
@@ -1079,6 +1080,57 @@ protected:
      */
     static void ConvertData(std::vector<dReal>::iterator ittargetdata, const ConfigurationSpecification& targetspec, std::vector<dReal>::const_iterator itsourcedata, const ConfigurationSpecification& sourcespec, size_t numpoints, EnvironmentBaseConstPtr penv, bool filluninitialized = true);
 
+    /** \brief Conversion from a source to a target specification that is prepared once and then applied to any number of points. Used by \ref ConvertData.
+
+        Preparing matches the groups and parses their names, converting then only copies runs of contiguous values. Groups that need the environment to convert, like filling uninitialized values with the current body values or converting affine rotations, are still converted with \ref ConvertGroupData.
+     */
+    class OPENRAVE_API ConversionPlan
+    {
+public:
+        /// \param filluninitialized see \ref ConvertData
+        /// \param fillmissinggroups if true, the target groups that are not in the source are filled with default values like in \ref ConvertData, otherwise they are left untouched. Only used when filluninitialized is true
+        ConversionPlan(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, bool filluninitialized=true, bool fillmissinggroups=true);
+
+        /// \brief returns true if the plan converts between the specifications with the same options
+        bool IsCompatible(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, bool filluninitialized=true, bool fillmissinggroups=true) const;
+
+        /// \brief same as \ref IsCompatible, but compares the hashes of the specifications before their groups so that most incompatible plans are rejected without comparing the group names.
+        ///
+        /// \param targethash the \ref GetSpecificationHash of targetspec
+        /// \param sourcehash the \ref GetSpecificationHash of sourcespec
+        bool IsCompatible(const ConfigurationSpecification& targetspec, size_t targethash, const ConfigurationSpecification& sourcespec, size_t sourcehash, bool filluninitialized=true, bool fillmissinggroups=true) const;
+
+        /// \brief hash of the groups of spec, computed once per lookup when searching several plans
+        static size_t GetSpecificationHash(const ConfigurationSpecification& spec);
+
+        /// \brief converts numpoints points, the strides are the dofs of the specifications. See \ref ConvertData
+        void Convert(std::vector<dReal>::iterator ittargetdata, const dReal* psourcedata, size_t numpoints, EnvironmentBaseConstPtr penv) const;
+
+        /// \brief indices of the target groups that are not in the source
+        inline const std::vector<int>& GetMissingGroupIndices() const {
+            return _vmissinggroups;
+        }
+
+private:
+        /// \brief dof values of every point copied from sourceoffset to targetoffset
+        struct CopyRun
+        {
+            int targetoffset, sourceoffset, dof;
+        };
+
+        std::vector<Group> _vtargetgroups, _vsourcegroups;
+        int _targetdof, _sourcedof;
+        size_t _targethash, _sourcehash; ///< \ref GetSpecificationHash of the groups
+        std::vector<CopyRun> _vcopyruns; ///< sorted by target offset
+        std::vector< std::pair<int, int> > _vconvertgroups; ///< target and source group indices converted with \ref ConvertGroupData
+        std::vector<int> _vmissinggroups; ///< target group indices that are not in the source
+        bool _filluninitialized, _fillmissinggroups;
+    };
+    typedef boost::shared_ptr<ConversionPlan const> ConversionPlanConstPtr;
+
+    /// \brief returns the plan converting from sourcespec to targetspec. The recently used plans of the calling thread are cached, so only new pairs of specifications are prepared.
+    static ConversionPlanConstPtr GetConversionPlan(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, bool filluninitialized=true);
+
     /// \brief gets the name of the interpolation that represents the derivative of the passed in interpolation.
     ///
     /// For example GetInterpolationDerivative("quadratic") -> "linear"
@@ -2503,6 +2555,18 @@ public:
     void Clear();
 
     AABB ComputeAABB() const;
+
+    /** \brief computes a decimated version of the mesh where every vertex moves by at most fErrorTolerance.
+
+        Vertices are clustered on a grid, each cluster is replaced by the mean of its vertices, and triangles that
+        become degenerate or duplicated are removed. Useful for generating coarse collision geometry of large CAD meshes.
+        The result is not conservative: the cluster means lie inside convex regions of the surface, so the simplified mesh can
+        miss contacts that are shallower than fErrorTolerance. Callers that need a conservative check have to pad by fErrorTolerance.
+        \param fErrorTolerance maximum distance any vertex is moved. If <= 0, the mesh is copied.
+        \param simplified the result, has to be different from *this
+     */
+    void Simplify(dReal fErrorTolerance, TriMesh& simplified) const;
+
     void serialize(std::ostream& o, int options=0) const;
 
     void SerializeJSON(rapidjson::Value& rTriMesh, rapidjson::Document::AllocatorType& allocator, dReal fUnitScale, int options=0) const;
@@ -2711,7 +2775,8 @@ OPENRAVE_API std::string RaveFindDatabaseFile(const std::string& filename, bool
 /// Although environment creation will automatically make sure this function is called, users might want
 /// explicit control of when this happens.
 /// Will not do anything if OpenRAVE runtime is already initialized. If OPENRAVE_* environment variables must be re-read, first call \ref RaveDestroy.
-/// \param bLoadAllPlugins If true will load all the openrave plugins automatically that can be found in the OPENRAVE_PLUGINS environment path
+/// \param bLoadAllPlugins If true will load all the openrave plugins automatically that can be found in the OPENRAVE_PLUGINS environment path.
+/// If false, plugins recorded in the plugin manifest ($OPENRAVE_HOME/plugins.manifest.json, or $OPENRAVE_PLUGINS_MANIFEST) with an unchanged modification time are only loaded when one of their interfaces is first created.
 /// \return 0 if successful, otherwise an error code
 OPENRAVE_API int RaveInitialize(bool bLoadAllPlugins=true, int level = Level_Info);
 
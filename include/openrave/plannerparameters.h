@@ -714,6 +714,7 @@ public:
     dReal ignorefirstcollisionee;     ///< if > 0, will allow the manipulator end effector to be in environment collision for the initial 'ignorefirstcollisionee' seconds of the trajectory. similar to 'ignorefirstcollision'
     dReal ignorelastcollisionee; /// if > 0, will allow the manipulator end effector to get into collision with the environment for the last 'ignorelastcollisionee' seconds of the trajrectory. The kinematics, self collisions, and environment collisions with the other parts of the robot will still be checked
     dReal minimumcompletetime;     ///< specifies the minimum trajectory that must be followed for planner to declare success. If 0, then the entire trajectory has to be followed.
+    bool usedifferentialik;     ///< if true, track the workspace trajectory with jacobian-based differential ik from the previous solution, and only use the analytical ik solver where differential ik does not converge.
     TrajectoryBasePtr workspacetraj;     ///< workspace trajectory
 
 protected:
@@ -733,12 +734,18 @@ typedef boost::shared_ptr<WorkspaceTrajectoryParameters const> WorkspaceTrajecto
 class OPENRAVE_API RRTParameters : public PlannerBase::PlannerParameters
 {
 public:
-    RRTParameters() : _minimumgoalpaths(1), _bProcessing(false) {
+    RRTParameters() : _minimumgoalpaths(1), _bLazyEdgeValidation(false), _bProcessing(false) {
         _vXMLParameters.push_back("minimumgoalpaths");
+        _vXMLParameters.push_back("lazyedgevalidation");
     }
 
     size_t _minimumgoalpaths; ///< minimum number of goals to connect to before exiting. the goal with the shortest path is returned.
 
+    /// \brief if true, the trees are grown by only checking the new configurations. The edges are checked only once they are part of a path connecting the start and goal, and the subtrees behind failed edges are discarded.
+    ///
+    /// Saves most of the edge checks in mostly free spaces since the majority of the tree edges are never part of the final path. Only used by the BiRRT planner.
+    bool _bLazyEdgeValidation;
+
 protected:
     bool _bProcessing;
     virtual bool serialize(std::ostream& O, int options=0) const
@@ -747,6 +754,7 @@ protected:
             return false;
         }
         O << "<minimumgoalpaths>" << _minimumgoalpaths << "</minimumgoalpaths>" << std::endl;
+        O << "<lazyedgevalidation>" << _bLazyEdgeValidation << "</lazyedgevalidation>" << std::endl;
         if( !(options & 1) ) {
             O << _sExtraParameters << std::endl;
         }
@@ -764,7 +772,7 @@ protected:
         case PE_Ignore: return PE_Ignore;
         }
 
-        _bProcessing = name=="minimumgoalpaths";
+        _bProcessing = name=="minimumgoalpaths" || name=="lazyedgevalidation";
         return _bProcessing ? PE_Support : PE_Pass;
     }
 
@@ -774,6 +782,9 @@ protected:
             if( name == "minimumgoalpaths") {
                 _ss >> _minimumgoalpaths;
             }
+            else if( name == "lazyedgevalidation" ) {
+                _ss >> _bLazyEdgeValidation;
+            }
             else {
                 RAVELOG_WARN(str(boost::format("unknown tag %s\n")%name));
             }
@@ -58,6 +58,43 @@ OPENRAVE_API int JitterCurrentConfiguration(PlannerBase::PlannerParametersConstP
  */
 OPENRAVE_API void VerifyTrajectory(PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory, dReal samplingstep=0.002);
 
+/** \brief validates a trajectory like \ref VerifyTrajectory, checking the sampled segments on several threads.
+
+    The time range is split into one shard per thread, and every thread checks its shard in its own clone of the environment of the trajectory. Inside a shard the segments are checked coarse to fine (middle first, then the middles of the halves) so that collisions are found early, and once a segment fails, all threads skip the segments after it.
+    The constraints of the clones are rebuilt from parameters->_configurationspecification and the limits of parameters. If the state or constraint functions of parameters are not the ones PlannerBase::PlannerParameters::SetConfigurationSpecification sets, they cannot be copied to the clones and the trajectory is checked by \ref VerifyTrajectory on the calling thread instead.
+    The clones are kept in a \ref ParallelTrajectoryVerifier per environment and number of threads, so only the first call pays for cloning the environment.
+    Assumes that the environment of the trajectory is locked.
+    \param samplingstep If <= 0, the trajectory is checked by \ref VerifyTrajectory on the calling thread.
+    \param numthreads number of threads, if <= 0 uses the number of cores
+    \throw openrave_exception ORE_InconsistentConstraints with the error of the earliest failing segment.
+ */
+OPENRAVE_API void VerifyTrajectoryParallel(PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory, dReal samplingstep=0.002, int numthreads=0);
+
+/** \brief Parallel trajectory verifier that keeps its cloned environments, see \ref VerifyTrajectoryParallel.
+
+    The clones are synchronized with the environment of the trajectory at every call, re-using the bodies that did not change, so verifying every trajectory before execution does not pay for cloning the environment each time.
+    The constraints of a clone are only rebuilt when the configuration specification or the bodies it uses change.
+ */
+class OPENRAVE_API ParallelTrajectoryVerifier
+{
+public:
+    /// \param numthreads number of threads, if <= 0 uses the number of cores
+    ParallelTrajectoryVerifier(int numthreads=0);
+    virtual ~ParallelTrajectoryVerifier();
+
+    /// \brief validates the trajectory, see \ref VerifyTrajectoryParallel for the parameters
+    virtual void VerifyTrajectory(PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory, dReal samplingstep=0.002);
+
+protected:
+    class CloneVerifier;
+    typedef boost::shared_ptr<CloneVerifier> CloneVerifierPtr;
+
+    std::vector<CloneVerifierPtr> _vcloneverifiers; ///< one clone per thread
+    int _numthreads;
+};
+
+typedef boost::shared_ptr<ParallelTrajectoryVerifier> ParallelTrajectoryVerifierPtr;
+
 /** \brief Extends the last ramp of the trajectory in order to reach a goal. THe configuration space matches the positional data of the trajectory.
 
     Useful when appending jittered points to the trajectory.
@@ -0,0 +1,122 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/** \file profiling.h
+    \brief Runtime toggleable timers and counters of the library hot paths. This file is automatically included by openrave.h.
+
+    Every thread records into its own buffers so recording never takes a lock. When profiling is disabled, a scope costs one relaxed atomic load.
+    The recorded data can be queried and exported as Chrome trace events (chrome://tracing, Perfetto) through the JSON commands of the Profiler module of the logging plugin.
+ */
+#ifndef OPENRAVE_PROFILING_H
+#define OPENRAVE_PROFILING_H
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace OpenRAVE {
+
+/// \brief true if the profiling scopes and counters are recorded, use \ref RaveSetProfilingEnabled to change
+OPENRAVE_API extern std::atomic<bool> g_bRaveProfilingEnabled;
+
+/// \brief enables or disables the recording of the profiling scopes and counters of all threads
+OPENRAVE_API void RaveSetProfilingEnabled(bool bEnabled);
+
+inline bool RaveIsProfilingEnabled()
+{
+    return g_bRaveProfilingEnabled.load(std::memory_order_relaxed);
+}
+
+/// \brief time used by the profiling scopes, ns of a steady clock
+inline uint64_t RaveGetProfilingTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// \brief records a scope of the calling thread.
+///
+/// \param name static string naming the scope, only the pointer is stored
+/// \param starttime start of the scope returned by \ref RaveGetProfilingTime
+/// \param duration duration of the scope in ns
+OPENRAVE_API void RaveProfileScope(const char* name, uint64_t starttime, uint64_t duration);
+
+/// \brief adds count to the counter name of the calling thread. name has to be a static string, only the pointer is stored
+OPENRAVE_API void RaveProfileCount(const char* name, int64_t count=1);
+
+/// \brief statistics of one scope or counter accumulated over all threads
+struct OPENRAVE_API ProfileStatistics
+{
+    std::string name;
+    uint64_t count = 0; ///< number of scopes recorded, or sum of the counts of a counter
+    uint64_t totalns = 0; ///< total duration of the scopes, 0 for counters
+    uint64_t minns = 0; ///< shortest scope, 0 for counters
+    uint64_t maxns = 0; ///< longest scope, 0 for counters
+    bool bcounter = false; ///< true if recorded with \ref RaveProfileCount
+};
+
+/// \brief returns the statistics of all the scopes and counters recorded since the last \ref RaveResetProfiling, sorted by name
+OPENRAVE_API void RaveGetProfileStatistics(std::vector<ProfileStatistics>& vstatistics);
+
+/// \brief writes the last recorded scopes of every thread as a Chrome trace event JSON document
+///
+/// Every thread keeps the most recent scopes in a fixed size ring buffer, older scopes are only reflected in the statistics.
+/// The buffers of exited threads are freed, only the scopes of the last few of them are kept.
+OPENRAVE_API void RaveWriteProfileChromeTrace(std::ostream& os);
+
+/// \brief clears the statistics and scopes of all threads
+OPENRAVE_API void RaveResetProfiling();
+
+/// \brief records the duration of the enclosing scope if profiling was enabled when it started
+class ProfileScope
+{
+public:
+    inline ProfileScope(const char* name) : _name(NULL), _starttime(0)
+    {
+        if( RaveIsProfilingEnabled() ) {
+            _name = name;
+            _starttime = RaveGetProfilingTime();
+        }
+    }
+    inline ~ProfileScope()
+    {
+        if( !!_name ) {
+            RaveProfileScope(_name, _starttime, RaveGetProfilingTime() - _starttime);
+        }
+    }
+
+private:
+    ProfileScope(const ProfileScope&);
+    ProfileScope& operator=(const ProfileScope&);
+
+    const char* _name;
+    uint64_t _starttime;
+};
+
+} // end namespace OpenRAVE
+
+#define OPENRAVE_PROFILE_CONCAT_(a, b) a ## b
+#define OPENRAVE_PROFILE_CONCAT(a, b) OPENRAVE_PROFILE_CONCAT_(a, b)
+
+/// \brief times the enclosing scope under name, which has to be a string literal
+#define OPENRAVE_PROFILE_SCOPE(name) OpenRAVE::ProfileScope OPENRAVE_PROFILE_CONCAT(__raveprofilescope, __LINE__)(name)
+
+/// \brief adds count to the counter name, which has to be a string literal
+#define OPENRAVE_PROFILE_COUNT(name, count) do { if( OpenRAVE::RaveIsProfilingEnabled() ) { OpenRAVE::RaveProfileCount(name, count); } } while(0)
+
+#endif
@@ -88,6 +88,9 @@ public:
             return ST_Camera;
         }
         std::vector<uint8_t> vimagedata;         ///< rgb image data, if camera only outputs in grayscale, fill each channel with the same value
+        std::vector<float> vdepthdata;         ///< width*height depths along the optical axis in meters, row major, 0 where nothing was measured. Empty if the camera does not measure depth.
+        std::vector<float> vpointclouddata;         ///< 3*width*height organized point cloud in the camera coordinate system, NaN where nothing was measured. Empty if the camera does not measure depth.
+        std::vector<int32_t> vbodyindices;         ///< width*height environment body indices of the surfaces seen by each pixel, 0 for none. Only filled by simulated cameras.
         virtual bool serialize(std::ostream& O) const;
     };
 
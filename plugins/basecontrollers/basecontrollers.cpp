@@ -18,6 +18,7 @@
 OpenRAVE::ControllerBasePtr CreateIdealController(OpenRAVE::EnvironmentBasePtr penv, std::istream& sinput);
 OpenRAVE::ControllerBasePtr CreateIdealVelocityController(OpenRAVE::EnvironmentBasePtr penv, std::istream& sinput);
 OpenRAVE::ControllerBasePtr CreateRedirectController(OpenRAVE::EnvironmentBasePtr penv, std::istream& sinput);
+OpenRAVE::ControllerBasePtr CreateStreamingController(OpenRAVE::EnvironmentBasePtr penv, std::istream& sinput);
 
 const std::string BaseControllersPlugin::_pluginname = "BaseControllersPlugin";
 
@@ -26,6 +27,7 @@ BaseControllersPlugin::BaseControllersPlugin()
     _interfaces[OpenRAVE::PT_Controller].push_back("IdealController");
     _interfaces[OpenRAVE::PT_Controller].push_back("IdealVelocityController");
     _interfaces[OpenRAVE::PT_Controller].push_back("RedirectController");
+    _interfaces[OpenRAVE::PT_Controller].push_back("StreamingController");
 }
 
 BaseControllersPlugin::~BaseControllersPlugin() {}
@@ -43,6 +45,9 @@ OpenRAVE::InterfaceBasePtr BaseControllersPlugin::CreateInterface(OpenRAVE::Inte
         else if( interfacename == "redirectcontroller" ) {
             return CreateRedirectController(penv,sinput);
         }
+        else if( interfacename == "streamingcontroller" ) {
+            return CreateStreamingController(penv,sinput);
+        }
         break;
     default:
         break;
@@ -0,0 +1,490 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "plugindefs.h"
+#include "streamingringbuffer.h"
+
+#include <openrave/planningutils.h>
+
+#include <boost/bind/bind.hpp>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace boost::placeholders;
+using namespace streamingcontroller;
+
+class StreamingController : public ControllerBase
+{
+public:
+    StreamingController(EnvironmentBasePtr penv, std::istream& sinput) : ControllerBase(penv), _pbuffer(NULL), _nBufferSize(0), _bSharedMemory(false), _nCapacity(4096), _fServoPeriod(0.001), _fLookahead(0.05), _trajstartindex(0), _fConsumeTime(0), _lastsetindex(0), _nGeneration(0), _bPause(false), _bIsDone(true)
+    {
+        __description = "Pre-samples the trajectory at a fixed servo rate into a single producer, single consumer ring buffer of joint position and velocity setpoints. \
+See streamingringbuffer.h for the layout.\n\n\
+By default the controller consumes the setpoints itself at simulation time and sets the robot like the IdealController. \
+Once the buffer is exported to shared memory with OpenSharedMemory, an external real-time process consumes the setpoints and the robot mirrors the last consumed setpoint.\n\n\
+The producer stays a lookahead ahead of the consumer. When SetPath is called while streaming, the new trajectory is spliced after the last published setpoint with planningutils::InsertActiveDOFWaypointWithRetiming so that positions and velocities stay continuous.\n";
+        RegisterCommand("Pause",boost::bind(&StreamingController::_PauseCommand,this,_1,_2),
+                        "pauses the controller from reacting to commands ");
+        RegisterCommand("SetServoRate",boost::bind(&StreamingController::_SetServoRateCommand,this,_1,_2),
+                        "Sets the servo rate in Hz the setpoints are sampled at, default is 1000. Recreates the buffer. Format is:\n\n  rate");
+        RegisterCommand("SetBufferCapacity",boost::bind(&StreamingController::_SetBufferCapacityCommand,this,_1,_2),
+                        "Sets the number of setpoints in the ring buffer, rounded up to a power of two. Default is 4096. Recreates the buffer. Format is:\n\n  capacity");
+        RegisterCommand("SetLookahead",boost::bind(&StreamingController::_SetLookaheadCommand,this,_1,_2),
+                        "Sets how far ahead of the consumer in seconds setpoints are published, default is 0.05. New trajectories take effect after this. Format is:\n\n  seconds");
+        RegisterCommand("SetSplicePlanner",boost::bind(&StreamingController::_SetSplicePlannerCommand,this,_1,_2),
+                        "Sets the retimer used to splice new trajectories. If empty, uses the default retimer of the trajectory interpolation.");
+        RegisterCommand("OpenSharedMemory",boost::bind(&StreamingController::_OpenSharedMemoryCommand,this,_1,_2),
+                        "Recreates the buffer in the POSIX shared memory object of the given name, consumed by an external process. Format is:\n\n  name");
+        RegisterCommand("CloseSharedMemory",boost::bind(&StreamingController::_CloseSharedMemoryCommand,this,_1,_2),
+                        "Recreates the buffer in process memory, consumed by the controller.");
+        RegisterCommand("GetBufferState",boost::bind(&StreamingController::_GetBufferStateCommand,this,_1,_2),
+                        "Returns the write index, read index, trajectory end index, capacity, and generation of the buffer.");
+    }
+    virtual ~StreamingController() {
+        _DestroyBuffer();
+    }
+
+    virtual bool Init(RobotBasePtr robot, const std::vector<int>& dofindices, int nControlTransformation)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _probot = robot;
+        _dofindices = dofindices;
+        if( nControlTransformation ) {
+            RAVELOG_WARN_FORMAT("env=%s, streaming controller cannot control transformation", GetEnv()->GetNameId());
+        }
+        _ptraj.reset();
+        _samplespec._vgroups.resize(0);
+        if( !!robot && _dofindices.size() > 0 ) {
+            ConfigurationSpecification::Group group;
+            group.offset = 0;
+            group.dof = _dofindices.size();
+            stringstream ss;
+            ss << "joint_values " << robot->GetName();
+            FOREACHC(it, _dofindices) {
+                ss << " " << *it;
+            }
+            group.name = ss.str();
+            group.interpolation = "linear";
+            _samplespec._vgroups.push_back(group);
+            _samplespec.AddDerivativeGroups(1, false);
+        }
+        _bPause = false;
+        return _CreateBuffer();
+    }
+
+    virtual void Reset(int options)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _ptraj.reset();
+        if( !!_pbuffer ) {
+            // hold the last published setpoint from now on
+            std::fill(_vholdsample.begin() + _dofindices.size(), _vholdsample.end(), 0);
+            _pbuffer->trajectoryendindex.store(_pbuffer->writeindex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        _bIsDone = true;
+    }
+
+    virtual const std::vector<int>& GetControlDOFIndices() const {
+        return _dofindices;
+    }
+    virtual int IsControlTransformation() const {
+        return 0;
+    }
+
+    virtual bool SetDesired(const std::vector<dReal>& values, TransformConstPtr trans)
+    {
+        OPENRAVE_ASSERT_OP(values.size(),==,_dofindices.size());
+        std::lock_guard<std::mutex> lock(_mutex);
+        _ptraj.reset();
+        // setpoints jump to the values after the published ones
+        std::copy(values.begin(), values.end(), _vholdsample.begin());
+        std::fill(_vholdsample.begin() + _dofindices.size(), _vholdsample.end(), 0);
+        if( !!_pbuffer ) {
+            _pbuffer->trajectoryendindex.store(_pbuffer->writeindex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        _bIsDone = false;
+        return true;
+    }
+
+    virtual bool SetPath(TrajectoryBaseConstPtr ptraj)
+    {
+        OPENRAVE_ASSERT_FORMAT0(!ptraj || GetEnv()==ptraj->GetEnv(), "trajectory needs to come from the same environment as the controller", ORE_InvalidArguments);
+        EnvironmentLock lockenv(GetEnv()->GetMutex());
+        std::lock_guard<std::mutex> lock(_mutex);
+        if( _bPause ) {
+            RAVELOG_DEBUG_FORMAT("env=%s, StreamingController cannot start trajectories when paused", GetEnv()->GetNameId());
+            return false;
+        }
+        if( !_pbuffer ) {
+            return false;
+        }
+        // on failure, keep streaming the previous trajectory
+        const uint64_t writeindex = _pbuffer->writeindex.load(std::memory_order_relaxed);
+        if( !ptraj ) {
+            _ptraj.reset();
+            std::fill(_vholdsample.begin() + _dofindices.size(), _vholdsample.end(), 0);
+            _pbuffer->trajectoryendindex.store(writeindex, std::memory_order_relaxed);
+            return true;
+        }
+        if( _samplespec._vgroups.size() == 0 ) {
+            return false;
+        }
+
+        RobotBasePtr probot = _probot.lock();
+        if( ptraj->GetConfigurationSpecification().FindCompatibleGroup(_samplespec._vgroups.at(0).name, false) == ptraj->GetConfigurationSpecification()._vgroups.end() ) {
+            RAVELOG_WARN_FORMAT("env=%s, trajectory does not have group %s", GetEnv()->GetNameId()%_samplespec._vgroups.at(0).name);
+            return false;
+        }
+        TrajectoryBasePtr pnewtraj = RaveCreateTrajectory(GetEnv(), ptraj->GetXMLId());
+        pnewtraj->Clone(ptraj, 0);
+        _trajstartindex = writeindex;
+        if( writeindex > 0 ) {
+            // splice at the last published setpoint, which becomes time 0 of the new trajectory
+            const size_t dof = _dofindices.size();
+            std::vector<dReal> vpositions(_vholdsample.begin(), _vholdsample.begin() + dof), vvelocities(_vholdsample.begin() + dof, _vholdsample.end());
+            try {
+                RobotBase::RobotStateSaver saver(probot, KinBody::Save_ActiveDOF);
+                probot->SetActiveDOFs(_dofindices);
+                planningutils::InsertActiveDOFWaypointWithRetiming(0, vpositions, vvelocities, pnewtraj, probot, 1, 1, _splicePlannerName);
+            }
+            catch(const openrave_exception& ex) {
+                RAVELOG_WARN_FORMAT("env=%s, failed to splice the trajectory at setpoint %d: %s", GetEnv()->GetNameId()%writeindex%ex.what());
+                return false;
+            }
+            _trajstartindex = writeindex - 1;
+        }
+        _ptraj = pnewtraj;
+        uint64_t numsamples = (uint64_t)std::ceil(_ptraj->GetDuration()/_fServoPeriod) + 1;
+        _pbuffer->trajectoryendindex.store(_trajstartindex + numsamples, std::memory_order_relaxed);
+        _bIsDone = false;
+        return true;
+    }
+
+    virtual void SimulationStep(dReal fTimeElapsed)
+    {
+        if( _bPause ) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        if( !_pbuffer ) {
+            return;
+        }
+        uint64_t numconsume = 0;
+        if( !_bSharedMemory ) {
+            _fConsumeTime += fTimeElapsed;
+            numconsume = (uint64_t)(_fConsumeTime/_fServoPeriod);
+            _fConsumeTime -= numconsume*_fServoPeriod;
+        }
+        uint64_t readindex = _pbuffer->readindex.load(std::memory_order_acquire);
+        _Produce(readindex + numconsume + (uint64_t)(_fLookahead/_fServoPeriod) + 1);
+        if( numconsume > 0 ) {
+            readindex = std::min(readindex + numconsume, _pbuffer->writeindex.load(std::memory_order_relaxed));
+            _pbuffer->readindex.store(readindex, std::memory_order_release);
+        }
+
+        // mirror the last consumed setpoint on the robot
+        if( readindex > 0 && readindex != _lastsetindex ) {
+            RobotBasePtr probot = _probot.lock();
+            if( !!probot && _dofindices.size() > 0 ) {
+                const size_t dof = _dofindices.size();
+                const double* psample = GetStreamingRingBufferSample(_pbuffer, readindex - 1);
+                _vsetvalues.resize(dof);
+                _vsetvelocities.resize(dof);
+                for(size_t idof = 0; idof < dof; ++idof) {
+                    _vsetvalues[idof] = psample[idof];
+                    _vsetvelocities[idof] = psample[dof + idof];
+                }
+                probot->SetDOFValues(_vsetvalues, KinBody::CLA_CheckLimitsSilent, _dofindices);
+                probot->SetDOFVelocities(_vsetvelocities, KinBody::CLA_CheckLimitsSilent, _dofindices);
+            }
+            _lastsetindex = readindex;
+        }
+        if( readindex >= _pbuffer->trajectoryendindex.load(std::memory_order_relaxed) ) {
+            _bIsDone = true;
+            _ptraj.reset();
+        }
+    }
+
+    virtual bool IsDone() {
+        return _bIsDone;
+    }
+    virtual dReal GetTime() const {
+        if( !_pbuffer ) {
+            return 0;
+        }
+        uint64_t readindex = _pbuffer->readindex.load(std::memory_order_relaxed);
+        return readindex > _trajstartindex ? (readindex - _trajstartindex)*_fServoPeriod : 0;
+    }
+    virtual RobotBasePtr GetRobot() const {
+        return _probot.lock();
+    }
+
+private:
+    /// \brief publishes setpoints until targetindex, without overwriting the ones not consumed yet
+    void _Produce(uint64_t targetindex)
+    {
+        const uint64_t readindex = _pbuffer->readindex.load(std::memory_order_acquire);
+        targetindex = std::min(targetindex, readindex + _nCapacity);
+        uint64_t writeindex = _pbuffer->writeindex.load(std::memory_order_relaxed);
+        if( writeindex >= targetindex ) {
+            return;
+        }
+        const size_t dof = _dofindices.size();
+        const uint64_t numsamples = targetindex - writeindex;
+        uint64_t numtrajsamples = 0;
+        if( !!_ptraj ) {
+            const uint64_t endindex = _pbuffer->trajectoryendindex.load(std::memory_order_relaxed);
+            if( endindex > writeindex ) {
+                numtrajsamples = std::min(numsamples, endindex - writeindex);
+            }
+        }
+        if( numtrajsamples > 0 ) {
+            // sample all the setpoints with one conversion
+            const dReal fduration = _ptraj->GetDuration();
+            _vsampletimes.resize(numtrajsamples);
+            for(uint64_t isample = 0; isample < numtrajsamples; ++isample) {
+                _vsampletimes[isample] = std::min(fduration, (writeindex + isample - _trajstartindex)*_fServoPeriod);
+            }
+            _ptraj->SamplePoints(_vsampledata, _vsampletimes, _samplespec);
+            for(uint64_t isample = 0; isample < numtrajsamples; ++isample) {
+                std::copy(_vsampledata.begin() + isample*2*dof, _vsampledata.begin() + (isample+1)*2*dof, GetStreamingRingBufferSample(_pbuffer, writeindex + isample));
+            }
+            // the trajectory ends at rest on its last setpoint
+            std::copy(_vsampledata.end() - 2*dof, _vsampledata.end(), _vholdsample.begin());
+            if( writeindex + numtrajsamples >= _pbuffer->trajectoryendindex.load(std::memory_order_relaxed) ) {
+                std::fill(_vholdsample.begin() + dof, _vholdsample.end(), 0);
+            }
+        }
+        for(uint64_t isample = numtrajsamples; isample < numsamples; ++isample) {
+            std::copy(_vholdsample.begin(), _vholdsample.end(), GetStreamingRingBufferSample(_pbuffer, writeindex + isample));
+        }
+        _pbuffer->writeindex.store(targetindex, std::memory_order_release);
+    }
+
+    /// \brief creates the buffer either in process memory or in the shared memory object _sharedmemoryname. Starts by holding the current robot configuration.
+    bool _CreateBuffer()
+    {
+        _DestroyBuffer();
+        const size_t dof = _dofindices.size();
+        _vholdsample.resize(2*dof);
+        std::fill(_vholdsample.begin(), _vholdsample.end(), 0);
+        RobotBasePtr probot = _probot.lock();
+        if( !!probot && dof > 0 ) {
+            std::vector<dReal> vvalues;
+            probot->GetDOFValues(vvalues, _dofindices);
+            std::copy(vvalues.begin(), vvalues.end(), _vholdsample.begin());
+        }
+
+        _nBufferSize = GetStreamingRingBufferSize(dof, _nCapacity);
+        void* pmemory = NULL;
+        if( _sharedmemoryname.size() > 0 ) {
+#ifndef _WIN32
+            int fd = shm_open(_sharedmemoryname.c_str(), O_CREAT|O_RDWR, 0666);
+            if( fd < 0 ) {
+                RAVELOG_WARN_FORMAT("env=%s, failed to open shared memory %s: %s", GetEnv()->GetNameId()%_sharedmemoryname%strerror(errno));
+                return false;
+            }
+            if( ftruncate(fd, _nBufferSize) != 0 ) {
+                RAVELOG_WARN_FORMAT("env=%s, failed to resize shared memory %s to %d bytes: %s", GetEnv()->GetNameId()%_sharedmemoryname%_nBufferSize%strerror(errno));
+                close(fd);
+                return false;
+            }
+            pmemory = mmap(NULL, _nBufferSize, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if( pmemory == MAP_FAILED ) {
+                RAVELOG_WARN_FORMAT("env=%s, failed to map shared memory %s: %s", GetEnv()->GetNameId()%_sharedmemoryname%strerror(errno));
+                return false;
+            }
+            _bSharedMemory = true;
+#else
+            RAVELOG_WARN_FORMAT("env=%s, shared memory is not supported on this platform", GetEnv()->GetNameId());
+            return false;
+#endif
+        }
+        else {
+            pmemory = ::operator new(_nBufferSize, std::align_val_t(alignof(StreamingRingBufferHeader)));
+        }
+
+        _pbuffer = new (pmemory) StreamingRingBufferHeader();
+        _pbuffer->version = STREAMING_RING_BUFFER_VERSION;
+        _pbuffer->dof = dof;
+        _pbuffer->capacity = _nCapacity;
+        _pbuffer->servoperiod = _fServoPeriod;
+        _pbuffer->generation = ++_nGeneration;
+        _pbuffer->closed.store(0, std::memory_order_relaxed);
+        _pbuffer->writeindex.store(0, std::memory_order_relaxed);
+        _pbuffer->readindex.store(0, std::memory_order_relaxed);
+        _pbuffer->trajectoryendindex.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        _pbuffer->magic = STREAMING_RING_BUFFER_MAGIC;
+        _ptraj.reset();
+        _trajstartindex = 0;
+        _fConsumeTime = 0;
+        _lastsetindex = 0;
+        _bIsDone = true;
+        return true;
+    }
+
+    void _DestroyBuffer()
+    {
+        if( !_pbuffer ) {
+            return;
+        }
+        // has to be visible before the object is unlinked, so that the consumer of the old mapping knows to open the name again
+        _pbuffer->closed.store(1, std::memory_order_release);
+        _pbuffer->magic = 0;
+        _pbuffer->~StreamingRingBufferHeader();
+#ifndef _WIN32
+        if( _bSharedMemory ) {
+            munmap(_pbuffer, _nBufferSize);
+            shm_unlink(_sharedmemoryname.c_str());
+        }
+        else
+#endif
+        {
+            ::operator delete(_pbuffer, std::align_val_t(alignof(StreamingRingBufferHeader)));
+        }
+        _pbuffer = NULL;
+        _bSharedMemory = false;
+    }
+
+    bool _PauseCommand(std::ostream& os, std::istream& is)
+    {
+        is >> _bPause;
+        return !!is;
+    }
+
+    bool _SetServoRateCommand(std::ostream& os, std::istream& is)
+    {
+        dReal frate = 0;
+        is >> frate;
+        if( !is || frate <= 0 ) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _fServoPeriod = 1/frate;
+        return _CreateBuffer();
+    }
+
+    bool _SetBufferCapacityCommand(std::ostream& os, std::istream& is)
+    {
+        uint32_t capacity = 0;
+        is >> capacity;
+        if( !is || capacity == 0 || capacity > 0x80000000 ) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _nCapacity = 1;
+        while(_nCapacity < capacity) {
+            _nCapacity <<= 1;
+        }
+        return _CreateBuffer();
+    }
+
+    bool _SetLookaheadCommand(std::ostream& os, std::istream& is)
+    {
+        dReal flookahead = 0;
+        is >> flookahead;
+        if( !is || flookahead < 0 ) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _fLookahead = flookahead;
+        return true;
+    }
+
+    bool _SetSplicePlannerCommand(std::ostream& os, std::istream& is)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _splicePlannerName.clear();
+        is >> _splicePlannerName;
+        return true;
+    }
+
+    bool _OpenSharedMemoryCommand(std::ostream& os, std::istream& is)
+    {
+        std::string name;
+        is >> name;
+        if( name.empty() ) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _DestroyBuffer();
+        _sharedmemoryname = name;
+        if( !_CreateBuffer() ) {
+            _sharedmemoryname.clear();
+            _CreateBuffer();
+            return false;
+        }
+        return true;
+    }
+
+    bool _CloseSharedMemoryCommand(std::ostream& os, std::istream& is)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _DestroyBuffer();
+        _sharedmemoryname.clear();
+        return _CreateBuffer();
+    }
+
+    bool _GetBufferStateCommand(std::ostream& os, std::istream& is)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if( !_pbuffer ) {
+            return false;
+        }
+        os << _pbuffer->writeindex.load(std::memory_order_relaxed) << " " << _pbuffer->readindex.load(std::memory_order_relaxed) << " " << _pbuffer->trajectoryendindex.load(std::memory_order_relaxed) << " " << _pbuffer->capacity << " " << _pbuffer->generation;
+        return true;
+    }
+
+    RobotBaseWeakPtr _probot;
+    std::vector<int> _dofindices;
+    ConfigurationSpecification _samplespec; ///< joint values and velocities of _dofindices
+    TrajectoryBasePtr _ptraj; ///< trajectory being streamed, already spliced with the previous setpoints
+
+    StreamingRingBufferHeader* _pbuffer; ///< the header of the buffer, followed by the setpoints
+    size_t _nBufferSize; ///< size of _pbuffer in bytes
+    std::string _sharedmemoryname; ///< if not empty, _pbuffer is mapped from this POSIX shared memory object
+    bool _bSharedMemory; ///< true if _pbuffer is in shared memory and consumed by an external process
+    uint32_t _nCapacity; ///< number of setpoints in the buffer, a power of two
+    dReal _fServoPeriod; ///< time between setpoints
+    dReal _fLookahead; ///< how far in time the producer publishes ahead of the consumer
+
+    std::string _splicePlannerName;
+    uint64_t _trajstartindex; ///< setpoint index of time 0 of _ptraj
+    std::vector<dReal> _vholdsample; ///< positions and velocities published when there is no trajectory. Also the last published setpoint.
+    dReal _fConsumeTime; ///< time not consumed yet when the controller is the consumer
+    uint64_t _lastsetindex; ///< read index the robot was last set at
+    uint64_t _nGeneration; ///< generation of the last created buffer
+
+    // caches
+    std::vector<dReal> _vsampletimes, _vsampledata, _vsetvalues, _vsetvelocities;
+
+    bool _bPause, _bIsDone;
+    std::mutex _mutex;
+};
+
+ControllerBasePtr CreateStreamingController(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return ControllerBasePtr(new StreamingController(penv,sinput));
+}
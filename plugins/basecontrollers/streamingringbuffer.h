@@ -0,0 +1,100 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/** \file streamingringbuffer.h
+    \brief Memory layout of the setpoint ring buffer written by the StreamingController.
+
+    The header does not depend on OpenRAVE so that real-time processes reading the buffer from shared memory can include it directly.
+    The buffer is single producer (the controller) and single consumer (the servo loop). Sample i is the setpoint for servo tick i,
+    counted from the moment the buffer was created, and holds the positions followed by the velocities of all the controlled dofs.
+    Installed as include/openrave-X.Y/streamingringbuffer.h.
+
+    The controller recreates the buffer under the same shared memory name when its servo rate or capacity changes. Before it unlinks
+    the old object it sets closed, so a consumer that sees IsStreamingRingBufferClosed has to unmap the buffer and open the name again.
+    The new buffer has a larger generation.
+ */
+#ifndef OPENRAVE_STREAMING_RING_BUFFER_H
+#define OPENRAVE_STREAMING_RING_BUFFER_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace streamingcontroller {
+
+static const uint32_t STREAMING_RING_BUFFER_MAGIC = 0x4253524f; ///< "ORSB"
+static const uint32_t STREAMING_RING_BUFFER_VERSION = 2;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring buffer indices have to be lock free to be shared between processes");
+
+/// \brief placed at the beginning of the buffer, followed by capacity samples of 2*dof doubles each
+struct StreamingRingBufferHeader
+{
+    uint32_t magic; ///< STREAMING_RING_BUFFER_MAGIC once the producer has initialized the buffer
+    uint32_t version; ///< STREAMING_RING_BUFFER_VERSION
+    uint32_t dof; ///< number of controlled dofs
+    uint32_t capacity; ///< number of samples in the ring, a power of two
+    double servoperiod; ///< time between two consecutive samples, in seconds
+    uint64_t generation; ///< incremented by the producer every time it recreates the buffer
+    uint64_t reserved[4];
+
+    alignas(64) std::atomic<uint64_t> writeindex; ///< number of samples published by the producer. Samples [readindex, writeindex) can be read.
+    alignas(64) std::atomic<uint64_t> readindex; ///< number of samples consumed by the consumer. The producer never overwrites samples at or after readindex.
+    alignas(64) std::atomic<uint64_t> trajectoryendindex; ///< index of the first sample after the current trajectory finishes. Samples after it hold the final setpoint.
+    alignas(64) std::atomic<uint32_t> closed; ///< set to 1 by the producer before it releases the buffer, no samples are published afterwards
+};
+
+/// \brief true if the producer released the buffer, the consumer has to open the shared memory object again to get the new one
+inline bool IsStreamingRingBufferClosed(const StreamingRingBufferHeader* pheader)
+{
+    return pheader->closed.load(std::memory_order_acquire) != 0;
+}
+
+/// \brief total size in bytes of a buffer with the given dof and capacity
+inline size_t GetStreamingRingBufferSize(uint32_t dof, uint32_t capacity)
+{
+    return sizeof(StreamingRingBufferHeader) + sizeof(double)*2*dof*(size_t)capacity;
+}
+
+/// \brief returns the sample of index, which is valid only while index is in [readindex, writeindex)
+inline double* GetStreamingRingBufferSample(StreamingRingBufferHeader* pheader, uint64_t index)
+{
+    double* psamples = reinterpret_cast<double*>(reinterpret_cast<uint8_t*>(pheader) + sizeof(StreamingRingBufferHeader));
+    return psamples + 2*(size_t)pheader->dof*(size_t)(index & (pheader->capacity - 1));
+}
+
+/** \brief consumer side: copies the next sample into positions and velocities (each dof values) and advances readindex.
+
+    Wait-free, so it can be called from the servo loop.
+    \return false if no sample is available, which means the producer fell behind or closed the buffer (see IsStreamingRingBufferClosed)
+ */
+inline bool ReadStreamingRingBufferSample(StreamingRingBufferHeader* pheader, double* positions, double* velocities)
+{
+    const uint64_t readindex = pheader->readindex.load(std::memory_order_relaxed);
+    if( readindex >= pheader->writeindex.load(std::memory_order_acquire) ) {
+        return false;
+    }
+    const double* psample = GetStreamingRingBufferSample(pheader, readindex);
+    for(uint32_t idof = 0; idof < pheader->dof; ++idof) {
+        positions[idof] = psample[idof];
+        velocities[idof] = psample[pheader->dof + idof];
+    }
+    pheader->readindex.store(readindex + 1, std::memory_order_release);
+    return true;
+}
+
+} // end namespace streamingcontroller
+
+#endif
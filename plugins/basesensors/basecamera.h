@@ -18,6 +18,8 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include "cameraraytracer.h"
+
 class BaseCameraSensor : public SensorBase
 {
 protected:
@@ -35,7 +37,7 @@ public:
                 }
                 return PE_Ignore;
             }
-            static boost::array<string, 18> tags = { { "sensor", "kk", "width", "height", "framerate", "power", "color", "focal_length","image_dimensions","intrinsic","measurement_time", "format", "distortion_model", "distortion_coeffs", "target_region", "gain", "hardware_id"}};
+            static boost::array<string, 18> tags = { { "sensor", "kk", "width", "height", "framerate", "power", "color", "focal_length","image_dimensions","intrinsic","measurement_time", "format", "distortion_model", "distortion_coeffs", "target_region", "gain", "hardware_id", "raytrace"}};
             if( find(tags.begin(),tags.end(),name) == tags.end() ) {
                 return PE_Pass;
             }
@@ -118,6 +120,9 @@ public:
             else if( name == "hardware_id" ) {
                 ss >> _psensor->_pgeom->hardware_id;
             }
+            else if( name == "raytrace" ) {
+                ss >> _psensor->_bRayTrace;
+            }
             else {
                 RAVELOG_WARN(str(boost::format("bad tag: %s")%name));
             }
@@ -185,6 +190,8 @@ public:
                         "Set the dimensions of the image (width,height)");
         RegisterCommand("SaveImage",boost::bind(&BaseCameraSensor::_SaveImage,this,_1,_2),
                         "Saves the next camera image to the given filename");
+        RegisterCommand("SetRayTracing",boost::bind(&BaseCameraSensor::_SetRayTracing,this,_1,_2),
+                        "Renders the images by ray tracing the environment on the cpu instead of with the viewer, which also fills the depth, point cloud and body indices of the sensor data. Format::\n\n  SetRayTracing enable [geometrygroup name] [numthreads N]\n\nIf geometrygroup is set, links having this geometry group are rendered with its geometries. If numthreads is 0, all the cores are used.");
         _pgeom.reset(new CameraGeomData());
         _pdata.reset(new CameraSensorData());
         _bPower = false;
@@ -193,6 +200,8 @@ public:
         //_numchannels = 3;
         _bRenderGeometry = true;
         _bRenderData = false;
+        _bRayTrace = false;
+        _nRayTraceThreads = 0;
         _Reset();
     }
 
@@ -253,8 +262,14 @@ public:
     virtual void _Reset()
     {
         _pdata->vimagedata.resize(0);
+        _pdata->vdepthdata.resize(0);
+        _pdata->vpointclouddata.resize(0);
+        _pdata->vbodyindices.resize(0);
         _pdata->__stamp = 0;
         _vimagedata.clear(); // do not resize vector here since it might never be used and it will take up lots of memory!
+        _vdepthdata.clear();
+        _vpointclouddata.clear();
+        _vbodyindices.clear();
         _fTimeToImage = 0;
         _graphgeometry.reset();
         _dataviewer.reset();
@@ -277,7 +292,19 @@ public:
             if( _fTimeToImage <= 0 ) {
                 _fTimeToImage = 1 / (float)framerate;
                 GetEnv()->UpdatePublishedBodies();
-                if( !!GetEnv()->GetViewer() ) {
+                if( _bRayTrace ) {
+                    _raytracer.Build(GetEnv(), _raytracegeometrygroup);
+                    _raytracer.Render(_trans, _pgeom->KK.fx, _pgeom->KK.fy, _pgeom->KK.cx, _pgeom->KK.cy, _pgeom->width, _pgeom->height, _nRayTraceThreads, _vdepthdata, _vpointclouddata, _vbodyindices, _vimagedata);
+                    // swap so that the buffers of the previous image are reused for the next one
+                    std::lock_guard<std::mutex> lock(_mutexdata);
+                    pdata->vimagedata.swap(_vimagedata);
+                    pdata->vdepthdata.swap(_vdepthdata);
+                    pdata->vpointclouddata.swap(_vpointclouddata);
+                    pdata->vbodyindices.swap(_vbodyindices);
+                    pdata->__stamp = GetEnv()->GetSimulationTime();
+                    pdata->__trans = _trans;
+                }
+                else if( !!GetEnv()->GetViewer() ) {
                     _vimagedata.resize(3*_pgeom->width*_pgeom->height);
                     if( GetEnv()->GetViewer()->GetCameraImage(_vimagedata, _pgeom->width, _pgeom->height, _trans, _pgeom->KK) ) {
                         // copy the data
@@ -357,6 +384,38 @@ public:
         }
         return false;
     }
+    bool _SetRayTracing(ostream& sout, istream& sinput)
+    {
+        bool bRayTrace = false;
+        sinput >> bRayTrace;
+        if( !sinput ) {
+            return false;
+        }
+        string cmd;
+        while(!sinput.eof()) {
+            sinput >> cmd;
+            if( !sinput ) {
+                break;
+            }
+            std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
+            if( cmd == "geometrygroup" ) {
+                sinput >> _raytracegeometrygroup;
+            }
+            else if( cmd == "numthreads" ) {
+                sinput >> _nRayTraceThreads;
+            }
+            else {
+                RAVELOG_WARN_FORMAT("env=%s, unrecognized command: %s", GetEnv()->GetNameId()%cmd);
+                return false;
+            }
+            if( !sinput ) {
+                return false;
+            }
+        }
+        _bRayTrace = bRayTrace;
+        _Reset();
+        return true;
+    }
     bool _SaveImage(ostream& sout, istream& sinput)
     {
         RAVELOG_WARN("SaveImage not implemented yet\n");
@@ -384,6 +443,9 @@ public:
         _bRenderGeometry = r->_bRenderGeometry;
         _bRenderData = r->_bRenderData;
         _bPower = r->_bPower;
+        _bRayTrace = r->_bRayTrace;
+        _raytracegeometrygroup = r->_raytracegeometrygroup;
+        _nRayTraceThreads = r->_nRayTraceThreads;
         _Reset();
     }
 
@@ -395,6 +457,9 @@ public:
         ss << _vColor.x << " " << _vColor.y << " " << _vColor.z;
         writer->AddChild("color",atts)->SetCharData(ss.str());
         writer->AddChild("format",atts)->SetCharData(_channelformat.size() > 0 ? _channelformat : std::string("uint8"));
+        if( _bRayTrace ) {
+            writer->AddChild("raytrace",atts)->SetCharData("1");
+        }
     }
 
 protected:
@@ -446,6 +511,8 @@ protected:
 
     // more geom stuff
     vector<uint8_t> _vimagedata;
+    vector<float> _vdepthdata, _vpointclouddata;
+    vector<int32_t> _vbodyindices;
     RaveVector<float> _vColor;
 
     Transform _trans;
@@ -460,6 +527,10 @@ protected:
 
     bool _bRenderGeometry, _bRenderData;
     bool _bPower;     ///< if true, gather data, otherwise don't
+    bool _bRayTrace; ///< if true, images are ray traced by _raytracer instead of rendered by the viewer
+    std::string _raytracegeometrygroup; ///< if not empty, geometry group to ray trace the links having it with
+    int _nRayTraceThreads; ///< 0 to use all the cores
+    CameraRayTracer _raytracer;
 
     friend class BaseCameraXMLReader;
 };
@@ -0,0 +1,582 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef OPENRAVE_CAMERA_RAY_TRACER_H
+#define OPENRAVE_CAMERA_RAY_TRACER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+/// \brief threads kept alive between frames that run the same task together, so that rendering a frame does not start new threads
+class RayTraceWorkerPool
+{
+public:
+    RayTraceWorkerPool() : _pfn(NULL), _generation(0), _nrunning(0), _bStop(false) {
+    }
+    ~RayTraceWorkerPool() {
+        _Stop();
+    }
+
+    /// \brief runs fn on numthreads threads including the calling one, and returns once all of them returned
+    void Run(int numthreads, const std::function<void()>& fn)
+    {
+        if( numthreads <= 1 ) {
+            fn();
+            return;
+        }
+        if( (int)_vthreads.size() != numthreads-1 ) {
+            _Stop();
+            std::lock_guard<std::mutex> lock(_mutex);
+            for(int ithread = 1; ithread < numthreads; ++ithread) {
+                _vthreads.emplace_back(&RayTraceWorkerPool::_Work, this, _generation);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _pfn = &fn;
+            _nrunning = _vthreads.size();
+            ++_generation;
+        }
+        _condwork.notify_all();
+        fn();
+        std::unique_lock<std::mutex> lock(_mutex);
+        _conddone.wait(lock, [this]() {
+            return _nrunning == 0;
+        });
+        _pfn = NULL;
+    }
+
+private:
+    void _Work(uint64_t generation)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while(true) {
+            _condwork.wait(lock, [this, generation]() {
+                return _bStop || _generation != generation;
+            });
+            if( _bStop ) {
+                return;
+            }
+            generation = _generation;
+            const std::function<void()>* pfn = _pfn;
+            lock.unlock();
+            (*pfn)();
+            lock.lock();
+            if( --_nrunning == 0 ) {
+                _conddone.notify_one();
+            }
+        }
+    }
+
+    void _Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _bStop = true;
+        }
+        _condwork.notify_all();
+        FOREACH(itthread, _vthreads) {
+            itthread->join();
+        }
+        _vthreads.clear();
+        _bStop = false;
+    }
+
+    std::vector<std::thread> _vthreads;
+    std::mutex _mutex;
+    std::condition_variable _condwork, _conddone;
+    const std::function<void()>* _pfn; ///< task of the current generation
+    uint64_t _generation; ///< incremented for every task
+    int _nrunning; ///< number of workers that did not finish the current task
+    bool _bStop;
+};
+
+/** \brief CPU ray tracer rendering pinhole camera images of the environment without a viewer.
+
+    Build gathers the world-space triangles of the visible geometries into a bounding volume hierarchy, Render then traces square packets of
+    neighboring pixels through it together on the threads of a persistent worker pool. Since all the rays of a camera share the origin, packets are coherent and most
+    bounding boxes are either missed or hit by the whole packet.
+ */
+class CameraRayTracer
+{
+    static const int PACKET_WIDTH = 4; ///< pixels are traced in PACKET_WIDTH x PACKET_WIDTH packets
+    static const int PACKET_SIZE = PACKET_WIDTH*PACKET_WIDTH;
+    static const int MAX_LEAF_TRIANGLES = 4;
+    static const int MAX_DEPTH = 64;
+    static const int NUM_BINS = 16;
+
+    struct Triangle
+    {
+        RaveVector<float> v0, e1, e2; ///< first vertex and the two edges starting from it
+        RaveVector<float> normal; ///< unnormalized
+        int32_t bodyindex;
+        uint32_t colorindex;
+    };
+
+    /// \brief leaves store count triangles starting at start, internal nodes store their children at start and start+1
+    struct BVHNode
+    {
+        float vmin[3], vmax[3];
+        uint32_t start;
+        uint16_t count;
+        uint16_t axis;
+    };
+
+    struct RayPacket
+    {
+        float dir[PACKET_SIZE][3]; ///< unnormalized directions whose z component in the camera frame is 1, so hit distances are depths
+        float invdir[PACKET_SIZE][3];
+        float tmax[PACKET_SIZE]; ///< distance of the closest hit, or infinity. Negative for rays outside of the image
+        uint32_t hit[PACKET_SIZE]; ///< index of the closest triangle
+    };
+
+public:
+    CameraRayTracer() {
+    }
+
+    /// \brief gathers the triangles of the visible geometries of all bodies and builds the hierarchy. Environment has to be locked.
+    ///
+    /// \param geometrygroup if not empty, links having this geometry group are rendered with its geometries instead of their current ones. Can be used to render visual meshes different from the collision meshes.
+    void Build(EnvironmentBasePtr penv, const std::string& geometrygroup)
+    {
+        _vtriangles.resize(0);
+        _vcolors.resize(0);
+        _vnodes.resize(0);
+        penv->GetBodies(_vbodies);
+        FOREACHC(itbody, _vbodies) {
+            int32_t bodyindex = (*itbody)->GetEnvironmentBodyIndex();
+            FOREACHC(itlink, (*itbody)->GetLinks()) {
+                const KinBody::Link& link = **itlink;
+                const Transform tlink = link.GetTransform();
+                if( geometrygroup.size() > 0 && link.GetGroupNumGeometries(geometrygroup) >= 0 ) {
+                    FOREACHC(itinfo, link.GetGeometriesFromGroup(geometrygroup)) {
+                        const KinBody::GeometryInfo& info = **itinfo;
+                        if( !info._bVisible ) {
+                            continue;
+                        }
+                        if( info._meshcollision.vertices.size() > 0 ) {
+                            _AddMesh(info._meshcollision, tlink*info.GetTransform(), bodyindex, info._vDiffuseColor);
+                        }
+                        else {
+                            // group geometries are not tessellated until they are set on the link
+                            KinBody::GeometryInfo tessellated = info;
+                            tessellated.InitCollisionMesh();
+                            _AddMesh(tessellated._meshcollision, tlink*info.GetTransform(), bodyindex, info._vDiffuseColor);
+                        }
+                    }
+                }
+                else {
+                    FOREACHC(itgeom, link.GetGeometries()) {
+                        if( (*itgeom)->IsVisible() ) {
+                            _AddMesh((*itgeom)->GetCollisionMesh(), tlink*(*itgeom)->GetTransform(), bodyindex, (*itgeom)->GetDiffuseColor());
+                        }
+                    }
+                }
+            }
+        }
+        _vbodies.resize(0); // do not hold references to the bodies
+        _BuildHierarchy();
+    }
+
+    /// \brief renders the image of a camera at tcamera looking along its z axis. Can be called from any thread once Build returned, concurrent calls share the worker pool and run one after the other.
+    ///
+    /// \param[out] vdepthdata width*height depths along the optical axis, row major, 0 where nothing was hit
+    /// \param[out] vpointclouddata 3*width*height organized point cloud in the camera frame, NaN where nothing was hit
+    /// \param[out] vbodyindices width*height environment body indices, 0 where nothing was hit
+    /// \param[out] vimagedata 3*width*height rgb image of the diffuse colors shaded by the angle of incidence
+    /// \param numthreads number of threads to trace with, 0 to use all the cores
+    void Render(const Transform& tcamera, dReal fx, dReal fy, dReal cx, dReal cy, int width, int height, int numthreads,
+                std::vector<float>& vdepthdata, std::vector<float>& vpointclouddata, std::vector<int32_t>& vbodyindices, std::vector<uint8_t>& vimagedata) const
+    {
+        const size_t numpixels = (size_t)width*height;
+        vdepthdata.resize(numpixels);
+        vpointclouddata.resize(3*numpixels);
+        vbodyindices.resize(numpixels);
+        vimagedata.resize(3*numpixels);
+        if( numpixels == 0 ) {
+            return;
+        }
+
+        const int numpacketsx = (width+PACKET_WIDTH-1)/PACKET_WIDTH;
+        const int numpackets = numpacketsx*((height+PACKET_WIDTH-1)/PACKET_WIDTH);
+        if( numthreads <= 0 ) {
+            numthreads = std::max(1, (int)std::thread::hardware_concurrency());
+        }
+        numthreads = std::min(numthreads, numpackets);
+
+        std::atomic<int> nextpacket(0);
+        auto tracepackets = [&]() {
+            RayPacket packet;
+            for(int ipacket = nextpacket++; ipacket < numpackets; ipacket = nextpacket++) {
+                _RenderPacket(tcamera, fx, fy, cx, cy, width, height, (ipacket%numpacketsx)*PACKET_WIDTH, (ipacket/numpacketsx)*PACKET_WIDTH, packet, vdepthdata, vpointclouddata, vbodyindices, vimagedata);
+            }
+        };
+        std::lock_guard<std::mutex> lock(_mutexrender);
+        _workerpool.Run(numthreads, tracepackets);
+    }
+
+    size_t GetNumTriangles() const {
+        return _vtriangles.size();
+    }
+
+private:
+    void _AddMesh(const TriMesh& mesh, const Transform& t, int32_t bodyindex, const RaveVector<float>& color)
+    {
+        if( mesh.indices.size() < 3 ) {
+            return;
+        }
+        const uint32_t colorindex = _vcolors.size();
+        _vcolors.push_back(color);
+        _vtriangles.reserve(_vtriangles.size() + mesh.indices.size()/3);
+        for(size_t i = 0; i+2 < mesh.indices.size(); i += 3) {
+            const Vector v0 = t*mesh.vertices.at(mesh.indices[i]), v1 = t*mesh.vertices.at(mesh.indices[i+1]), v2 = t*mesh.vertices.at(mesh.indices[i+2]);
+            Triangle tri;
+            tri.v0 = RaveVector<float>(v0.x, v0.y, v0.z);
+            tri.e1 = RaveVector<float>(v1.x-v0.x, v1.y-v0.y, v1.z-v0.z);
+            tri.e2 = RaveVector<float>(v2.x-v0.x, v2.y-v0.y, v2.z-v0.z);
+            tri.normal = tri.e1.cross(tri.e2);
+            if( tri.normal.lengthsqr3() <= 0 ) {
+                continue; // degenerate
+            }
+            tri.bodyindex = bodyindex;
+            tri.colorindex = colorindex;
+            _vtriangles.push_back(tri);
+        }
+    }
+
+    /// \brief builds the hierarchy with a binned surface area heuristic and reorders _vtriangles along the leaves
+    void _BuildHierarchy()
+    {
+        const uint32_t numtriangles = _vtriangles.size();
+        if( numtriangles == 0 ) {
+            return;
+        }
+        _vcentroids.resize(numtriangles);
+        _vtriindices.resize(numtriangles);
+        for(uint32_t itri = 0; itri < numtriangles; ++itri) {
+            const Triangle& tri = _vtriangles[itri];
+            _vcentroids[itri] = tri.v0 + (tri.e1 + tri.e2)*(1.0f/3.0f);
+            _vtriindices[itri] = itri;
+        }
+
+        struct BuildTask
+        {
+            uint32_t node, start, count, depth;
+        };
+        std::vector<BuildTask> vtasks;
+        _vnodes.reserve(2*numtriangles/MAX_LEAF_TRIANGLES+1);
+        _vnodes.resize(1);
+        vtasks.push_back({0, 0, numtriangles, 0});
+        while( vtasks.size() > 0 ) {
+            const BuildTask task = vtasks.back();
+            vtasks.pop_back();
+
+            float vmin[3], vmax[3], vcmin[3], vcmax[3];
+            for(int j = 0; j < 3; ++j) {
+                vmin[j] = vcmin[j] = std::numeric_limits<float>::max();
+                vmax[j] = vcmax[j] = -std::numeric_limits<float>::max();
+            }
+            for(uint32_t i = task.start; i < task.start+task.count; ++i) {
+                _ExpandBounds(_vtriangles[_vtriindices[i]], vmin, vmax);
+                const RaveVector<float>& c = _vcentroids[_vtriindices[i]];
+                for(int j = 0; j < 3; ++j) {
+                    vcmin[j] = std::min(vcmin[j], c[j]);
+                    vcmax[j] = std::max(vcmax[j], c[j]);
+                }
+            }
+            BVHNode& node = _vnodes[task.node];
+            for(int j = 0; j < 3; ++j) {
+                node.vmin[j] = vmin[j];
+                node.vmax[j] = vmax[j];
+            }
+            node.start = task.start;
+            node.count = task.count;
+            node.axis = 0;
+
+            int axis = 0;
+            for(int j = 1; j < 3; ++j) {
+                if( vcmax[j]-vcmin[j] > vcmax[axis]-vcmin[axis] ) {
+                    axis = j;
+                }
+            }
+            const float extent = vcmax[axis]-vcmin[axis];
+            if( task.count <= MAX_LEAF_TRIANGLES || (int)task.depth >= MAX_DEPTH || extent <= 0 ) {
+                if( task.count > 0xffff ) {
+                    RAVELOG_WARN_FORMAT("could not split %d triangles, some will not be rendered", task.count);
+                    node.count = 0xffff;
+                }
+                continue;
+            }
+
+            // bin the centroids and find the split minimizing the surface area heuristic
+            uint32_t vbincounts[NUM_BINS] = {0};
+            float vbinmin[NUM_BINS][3], vbinmax[NUM_BINS][3];
+            for(int ibin = 0; ibin < NUM_BINS; ++ibin) {
+                for(int j = 0; j < 3; ++j) {
+                    vbinmin[ibin][j] = std::numeric_limits<float>::max();
+                    vbinmax[ibin][j] = -std::numeric_limits<float>::max();
+                }
+            }
+            const float binscale = NUM_BINS*(1-1e-5f)/extent;
+            for(uint32_t i = task.start; i < task.start+task.count; ++i) {
+                const int ibin = std::min(NUM_BINS-1, (int)((_vcentroids[_vtriindices[i]][axis]-vcmin[axis])*binscale));
+                vbincounts[ibin]++;
+                _ExpandBounds(_vtriangles[_vtriindices[i]], vbinmin[ibin], vbinmax[ibin]);
+            }
+            float vrightcosts[NUM_BINS];
+            {
+                float vrmin[3], vrmax[3];
+                for(int j = 0; j < 3; ++j) {
+                    vrmin[j] = std::numeric_limits<float>::max();
+                    vrmax[j] = -std::numeric_limits<float>::max();
+                }
+                uint32_t rightcount = 0;
+                for(int ibin = NUM_BINS-1; ibin > 0; --ibin) {
+                    rightcount += vbincounts[ibin];
+                    for(int j = 0; j < 3; ++j) {
+                        vrmin[j] = std::min(vrmin[j], vbinmin[ibin][j]);
+                        vrmax[j] = std::max(vrmax[j], vbinmax[ibin][j]);
+                    }
+                    vrightcosts[ibin] = rightcount > 0 ? rightcount*_ComputeHalfArea(vrmin, vrmax) : 0;
+                }
+            }
+            int bestsplit = -1;
+            float bestcost = task.count*_ComputeHalfArea(vmin, vmax);
+            {
+                float vlmin[3], vlmax[3];
+                for(int j = 0; j < 3; ++j) {
+                    vlmin[j] = std::numeric_limits<float>::max();
+                    vlmax[j] = -std::numeric_limits<float>::max();
+                }
+                uint32_t leftcount = 0;
+                for(int ibin = 0; ibin < NUM_BINS-1; ++ibin) {
+                    leftcount += vbincounts[ibin];
+                    for(int j = 0; j < 3; ++j) {
+                        vlmin[j] = std::min(vlmin[j], vbinmin[ibin][j]);
+                        vlmax[j] = std::max(vlmax[j], vbinmax[ibin][j]);
+                    }
+                    if( leftcount == 0 || leftcount == task.count ) {
+                        continue;
+                    }
+                    const float cost = leftcount*_ComputeHalfArea(vlmin, vlmax) + vrightcosts[ibin+1];
+                    if( cost < bestcost ) {
+                        bestcost = cost;
+                        bestsplit = ibin+1;
+                    }
+                }
+            }
+
+            uint32_t leftcount;
+            if( bestsplit >= 0 ) {
+                uint32_t* pmiddle = std::partition(&_vtriindices[task.start], &_vtriindices[task.start]+task.count, [&](uint32_t itri) {
+                    return std::min(NUM_BINS-1, (int)((_vcentroids[itri][axis]-vcmin[axis])*binscale)) < bestsplit;
+                });
+                leftcount = pmiddle - &_vtriindices[task.start];
+            }
+            else if( task.count > 0xffff ) {
+                // splitting does not pay off, but the leaf would be too large
+                leftcount = task.count/2;
+                std::nth_element(&_vtriindices[task.start], &_vtriindices[task.start+leftcount], &_vtriindices[task.start]+task.count, [&](uint32_t itri0, uint32_t itri1) {
+                    return _vcentroids[itri0][axis] < _vcentroids[itri1][axis];
+                });
+            }
+            else {
+                continue;
+            }
+
+            const uint32_t childindex = _vnodes.size();
+            node.start = childindex;
+            node.count = 0;
+            node.axis = axis;
+            _vnodes.resize(childindex+2); // invalidates node
+            vtasks.push_back({childindex, task.start, leftcount, task.depth+1});
+            vtasks.push_back({childindex+1, task.start+leftcount, task.count-leftcount, task.depth+1});
+        }
+
+        // store the triangles in leaf order
+        _vsortedtriangles.resize(numtriangles);
+        for(uint32_t i = 0; i < numtriangles; ++i) {
+            _vsortedtriangles[i] = _vtriangles[_vtriindices[i]];
+        }
+        _vtriangles.swap(_vsortedtriangles);
+    }
+
+    void _RenderPacket(const Transform& tcamera, dReal fx, dReal fy, dReal cx, dReal cy, int width, int height, int x0, int y0, RayPacket& packet,
+                       std::vector<float>& vdepthdata, std::vector<float>& vpointclouddata, std::vector<int32_t>& vbodyindices, std::vector<uint8_t>& vimagedata) const
+    {
+        const float origin[3] = {(float)tcamera.trans.x, (float)tcamera.trans.y, (float)tcamera.trans.z};
+        for(int i = 0; i < PACKET_SIZE; ++i) {
+            const int x = x0 + i%PACKET_WIDTH, y = y0 + i/PACKET_WIDTH;
+            const Vector vdir = tcamera.rotate(Vector((x-cx)/fx, (y-cy)/fy, 1));
+            for(int j = 0; j < 3; ++j) {
+                packet.dir[i][j] = vdir[j];
+                packet.invdir[i][j] = 1/packet.dir[i][j];
+            }
+            packet.tmax[i] = (x < width && y < height) ? std::numeric_limits<float>::infinity() : -1;
+            packet.hit[i] = 0;
+        }
+
+        _TracePacket(origin, packet);
+
+        const float fnan = std::numeric_limits<float>::quiet_NaN();
+        for(int i = 0; i < PACKET_SIZE; ++i) {
+            if( packet.tmax[i] < 0 ) {
+                continue;
+            }
+            const int x = x0 + i%PACKET_WIDTH, y = y0 + i/PACKET_WIDTH;
+            const size_t index = (size_t)y*width + x;
+            if( packet.tmax[i] == std::numeric_limits<float>::infinity() ) {
+                vdepthdata[index] = 0;
+                vpointclouddata[3*index] = vpointclouddata[3*index+1] = vpointclouddata[3*index+2] = fnan;
+                vbodyindices[index] = 0;
+                vimagedata[3*index] = vimagedata[3*index+1] = vimagedata[3*index+2] = 0;
+                continue;
+            }
+            const float depth = packet.tmax[i];
+            vdepthdata[index] = depth;
+            vpointclouddata[3*index] = depth*(x-cx)/fx;
+            vpointclouddata[3*index+1] = depth*(y-cy)/fy;
+            vpointclouddata[3*index+2] = depth;
+            const Triangle& tri = _vtriangles[packet.hit[i]];
+            vbodyindices[index] = tri.bodyindex;
+            const float dirdotnormal = packet.dir[i][0]*tri.normal.x + packet.dir[i][1]*tri.normal.y + packet.dir[i][2]*tri.normal.z;
+            const float dirlensqr = packet.dir[i][0]*packet.dir[i][0] + packet.dir[i][1]*packet.dir[i][1] + packet.dir[i][2]*packet.dir[i][2];
+            const float shade = std::fabs(dirdotnormal)/std::sqrt(dirlensqr*tri.normal.lengthsqr3());
+            const RaveVector<float>& color = _vcolors[tri.colorindex];
+            for(int j = 0; j < 3; ++j) {
+                vimagedata[3*index+j] = (uint8_t)std::max(0.0f, std::min(255.0f, 255*color[j]*shade));
+            }
+        }
+    }
+
+    /// \brief finds the closest hits of the packet rays, visiting the nodes hit by any of the rays
+    void _TracePacket(const float origin[3], RayPacket& packet) const
+    {
+        if( _vnodes.size() == 0 ) {
+            return;
+        }
+        uint32_t vstack[2*MAX_DEPTH+2];
+        int stacksize = 0;
+        vstack[stacksize++] = 0;
+        while( stacksize > 0 ) {
+            const BVHNode& node = _vnodes[vstack[--stacksize]];
+            if( !_IntersectsPacket(node, origin, packet) ) {
+                continue;
+            }
+            if( node.count > 0 ) {
+                for(uint32_t itri = node.start; itri < node.start+node.count; ++itri) {
+                    _IntersectTriangle(_vtriangles[itri], itri, origin, packet);
+                }
+                continue;
+            }
+            // visit the child closest to the camera first so that far nodes are culled by the closer hits
+            if( packet.dir[0][node.axis] < 0 ) {
+                vstack[stacksize++] = node.start;
+                vstack[stacksize++] = node.start+1;
+            }
+            else {
+                vstack[stacksize++] = node.start+1;
+                vstack[stacksize++] = node.start;
+            }
+        }
+    }
+
+    static bool _IntersectsPacket(const BVHNode& node, const float origin[3], const RayPacket& packet)
+    {
+        for(int i = 0; i < PACKET_SIZE; ++i) {
+            float tnear = 0, tfar = packet.tmax[i];
+            for(int j = 0; j < 3 && tnear <= tfar; ++j) {
+                float t0 = (node.vmin[j]-origin[j])*packet.invdir[i][j];
+                float t1 = (node.vmax[j]-origin[j])*packet.invdir[i][j];
+                if( t0 > t1 ) {
+                    std::swap(t0, t1);
+                }
+                tnear = std::max(tnear, t0);
+                tfar = std::min(tfar, t1);
+            }
+            if( tnear <= tfar ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// \brief Moller-Trumbore intersection of the triangle with all the rays of the packet
+    static void _IntersectTriangle(const Triangle& tri, uint32_t itri, const float origin[3], RayPacket& packet)
+    {
+        const float s[3] = {origin[0]-tri.v0.x, origin[1]-tri.v0.y, origin[2]-tri.v0.z};
+        // q = s x e1 does not depend on the ray direction
+        const float q[3] = {s[1]*tri.e1.z - s[2]*tri.e1.y, s[2]*tri.e1.x - s[0]*tri.e1.z, s[0]*tri.e1.y - s[1]*tri.e1.x};
+        const float t = tri.e2.x*q[0] + tri.e2.y*q[1] + tri.e2.z*q[2];
+        for(int i = 0; i < PACKET_SIZE; ++i) {
+            const float* d = packet.dir[i];
+            // det = -d.(e1 x e2)
+            const float det = -(d[0]*tri.normal.x + d[1]*tri.normal.y + d[2]*tri.normal.z);
+            if( std::fabs(det) < 1e-12f ) {
+                continue;
+            }
+            const float invdet = 1/det;
+            const float thit = t*invdet;
+            if( thit <= 0 || thit >= packet.tmax[i] ) {
+                continue;
+            }
+            const float u = (d[0]*q[0] + d[1]*q[1] + d[2]*q[2])*invdet;
+            if( u < 0 || u > 1 ) {
+                continue;
+            }
+            // p = d x e2, u = s.p/det
+            const float p[3] = {d[1]*tri.e2.z - d[2]*tri.e2.y, d[2]*tri.e2.x - d[0]*tri.e2.z, d[0]*tri.e2.y - d[1]*tri.e2.x};
+            const float b1 = (s[0]*p[0] + s[1]*p[1] + s[2]*p[2])*invdet;
+            if( b1 < 0 || b1 + u > 1 ) {
+                continue;
+            }
+            packet.tmax[i] = thit;
+            packet.hit[i] = itri;
+        }
+    }
+
+    static void _ExpandBounds(const Triangle& tri, float vmin[3], float vmax[3])
+    {
+        for(int j = 0; j < 3; ++j) {
+            const float v0 = tri.v0[j], v1 = v0 + tri.e1[j], v2 = v0 + tri.e2[j];
+            vmin[j] = std::min(vmin[j], std::min(v0, std::min(v1, v2)));
+            vmax[j] = std::max(vmax[j], std::max(v0, std::max(v1, v2)));
+        }
+    }
+
+    static float _ComputeHalfArea(const float vmin[3], const float vmax[3])
+    {
+        const float dx = vmax[0]-vmin[0], dy = vmax[1]-vmin[1], dz = vmax[2]-vmin[2];
+        return dx*dy + dy*dz + dz*dx;
+    }
+
+    std::vector<Triangle> _vtriangles; ///< sorted along the leaves of _vnodes
+    std::vector<RaveVector<float> > _vcolors; ///< diffuse colors of the geometries
+    std::vector<BVHNode> _vnodes; ///< the root is at index 0
+    mutable RayTraceWorkerPool _workerpool;
+    mutable std::mutex _mutexrender; ///< protects _workerpool
+
+    // cache
+    std::vector<KinBodyPtr> _vbodies;
+    std::vector< RaveVector<float> > _vcentroids;
+    std::vector<uint32_t> _vtriindices;
+    std::vector<Triangle> _vsortedtriangles;
+};
+
+#endif
@@ -17,6 +17,9 @@
 namespace configurationcache
 {
 
+static std::mutex s_mutexSharedSelfCacheTrees; ///< protects s_mapSharedSelfCacheTrees
+static std::map<std::string, CacheTreeWeakPtr> s_mapSharedSelfCacheTrees; ///< self collision cache trees of all checkers in the process indexed by the cache hash, so that checkers tracking the same robot share the collected configurations
+
 class CacheCollisionChecker : public CollisionCheckerBase
 {
 public:
@@ -52,6 +55,10 @@ public:
                         "load self collision cache");
         RegisterCommand("GetCacheTimes",boost::bind(&CacheCollisionChecker::_GetCacheTimesCommand,this,_1,_2),
                         "get the cache times: insert, query, collision checking, load");
+        RegisterCommand("SetLinkSpherePadding",boost::bind(&CacheCollisionChecker::_SetLinkSpherePaddingCommand,this,_1,_2),
+                        "set the distance the robot link spheres are inflated by when invalidating free configurations around a changed body. [padding]");
+        RegisterCommand("SetShareCacheWithClones",boost::bind(&CacheCollisionChecker::_SetShareCacheWithClonesCommand,this,_1,_2),
+                        "if 1, checkers cloned from this checker share the collision cache as long as their environments do not change. Default is 0. [0/1]");
         std::string collisionname="ode";
         sinput >> collisionname;
         _pintchecker = RaveCreateCollisionChecker(GetEnv(), collisionname);
@@ -59,6 +66,7 @@ public:
         _cachedcollisionchecks=0;
         _cachedcollisionhits=0;
         _cachedfreehits = 0;
+        _bShareCacheWithClones = false;
 
         _selfcachedcollisionchecks=0;
         _selfcachedcollisionhits=0;
@@ -166,9 +174,20 @@ public:
         }
 
         _strRobotName = clone->_strRobotName;
+        _bShareCacheWithClones = clone->_bShareCacheWithClones;
         _probot.reset(); // have to rest to force creating a new cache
         _probot = GetRobot();
 
+        // the cloned bodies are in the same state as the reference, so the reference's configurations are valid here too. the caches
+        // make a private copy as soon as their environment changes
+        if( _bShareCacheWithClones && (cloningoptions & Clone_Bodies) && !!_cache && !!clone->_cache && clone->_cache->GetCacheTree()->GetWeights() == _cache->GetCacheTree()->GetWeights() ) {
+            _cache->SetCacheTree(clone->_cache->GetCacheTree());
+            _cache->SetCollisionThresh(clone->_cache->GetCollisionThresh());
+            _cache->SetFreeSpaceThresh(clone->_cache->GetFreeSpaceThresh());
+            _cache->SetInsertionDistanceMult(clone->_cache->GetInsertionDistanceMult());
+            _cache->SetLinkSpherePadding(clone->_cache->GetLinkSpherePadding());
+        }
+
         _cachedcollisionchecks=clone->_cachedcollisionchecks;
         _cachedcollisionhits=clone->_cachedcollisionhits;
         _cachedfreehits=clone->_cachedfreehits;
@@ -406,6 +425,7 @@ protected:
             _selfcache.reset(new ConfigurationCache(_probot, false)); //envupdates should be disabled for self collision cache
 
             _SetParams();
+            _ShareSelfCache();
         }
 
         // check if a selfcache for this robot exists on this disk
@@ -476,6 +496,23 @@ protected:
         return true;
     }
 
+    virtual bool _SetLinkSpherePaddingCommand(std::ostream& sout, std::istream& sinput)
+    {
+        dReal padding = 0;
+        sinput >> padding;
+        if( !sinput || !_cache ) {
+            return false;
+        }
+        _cache->SetLinkSpherePadding(padding);
+        return true;
+    }
+
+    virtual bool _SetShareCacheWithClonesCommand(std::ostream& sout, std::istream& sinput)
+    {
+        sinput >> _bShareCacheWithClones;
+        return !!sinput;
+    }
+
     virtual bool _SetCacheParametersCommand(std::ostream& sout, std::istream& sinput)
     {
 
@@ -647,6 +684,7 @@ protected:
         _selfcache.reset(new ConfigurationCache(_probot, false)); //envupdates should be disabled for self collision cache
 
         _SetParams();
+        _ShareSelfCache();
 
         _cachedcollisionchecks=0;
         _cachedcollisionhits=0;
@@ -657,6 +695,30 @@ protected:
         _selfcachedfreehits=0;
     }
 
+    /// \brief shares the self collision cache tree with all other checkers of the process whose robot has the same cache hash
+    void _ShareSelfCache()
+    {
+        std::string cachehash = GetCacheHash();
+        std::lock_guard<std::mutex> lock(s_mutexSharedSelfCacheTrees);
+        std::map<std::string, CacheTreeWeakPtr>::iterator it = s_mapSharedSelfCacheTrees.begin();
+        while( it != s_mapSharedSelfCacheTrees.end() ) {
+            if( it->second.expired() ) {
+                s_mapSharedSelfCacheTrees.erase(it++);
+            }
+            else {
+                ++it;
+            }
+        }
+        CacheTreePtr pcachetree = s_mapSharedSelfCacheTrees[cachehash].lock();
+        if( !!pcachetree && pcachetree->GetWeights().size() == _selfcache->GetCacheTree()->GetWeights().size() ) {
+            _selfcache->SetCacheTree(pcachetree);
+            RAVELOG_VERBOSE_FORMAT("env=%s, robot %s shares self collision cache with %d nodes", GetEnv()->GetNameId()%_probot->GetName()%pcachetree->GetNumNodes());
+        }
+        else {
+            s_mapSharedSelfCacheTrees[cachehash] = _selfcache->GetCacheTree();
+        }
+    }
+
     void _UpdateRobotDOF()
     {
         // if DOF changed, reset environment cache
@@ -682,6 +744,7 @@ protected:
     std::string _robothash;
     RobotBasePtr _probot; ///< robot pointer, shouldn't be used directly, use with GetRobot()
     int _numdofs;
+    bool _bShareCacheWithClones; ///< if true, clones of this checker share its environment collision cache
     int _cachedcollisionchecks, _cachedcollisionhits, _cachedfreehits, _size;
     int _selfcachedcollisionchecks, _selfcachedcollisionhits, _selfcachedfreehits;
     uint64_t _stime, _ftime, _intime, _querytime, _loadtime, _savetime, _rawtime, _resettime, _selfintime, _selfquerytime, _selfrawtime;
@@ -17,7 +17,10 @@
 #include <boost/lexical_cast.hpp>
 
 #include <boost/multi_array.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <algorithm>
+#include <cstdio>
 
 using boost::multi_array;
 using boost::extents;
@@ -123,9 +126,11 @@ void CacheTreeNode::SetCollisionInfo(int robotlinkindex, int type)
 //    }
 //}
 
-CacheTree::CacheTree(RobotBasePtr& pstaterobot, int statedof)
+CacheTree::CacheTree(RobotBasePtr& pstaterobot, int statedof, int numlinkspheres)
 {
-    _poolNodes.reset(new boost::pool<>(sizeof(CacheTreeNode)+sizeof(dReal)*statedof));
+    _statedof = statedof;
+    _numlinkspheres = numlinkspheres;
+    _poolNodes.reset(new boost::pool<>(_GetNodeMemorySize()));
     _vnodes.resize(0);
     _dummycs.resize(0);
     _fulldirname.resize(0);
@@ -147,9 +152,10 @@ CacheTree::~CacheTree()
 
 void CacheTree::Init(const std::vector<dReal>& weights, dReal maxdistance)
 {
-    Reset();
+    // set the dof before Reset so that the pool allocates nodes of the correct size
     _weights = weights;
     _statedof = (int)_weights.size();
+    Reset();
     _numnodes = 0;
     _base = 2.0;
     _fBaseInv = 1/_base;
@@ -187,7 +193,7 @@ void CacheTree::Reset()
     }
     // purge_memory leaks!
     //_poolNodes.purge_memory();
-    _poolNodes.reset(new boost::pool<>(sizeof(CacheTreeNode)+sizeof(dReal)*_statedof));
+    _poolNodes.reset(new boost::pool<>(_GetNodeMemorySize()));
     //_pNodesPool.reset(new boost::pool<>(sizeof(Node)+_dof*sizeof(dReal)));
     _numnodes = 0;
 }
@@ -196,7 +202,7 @@ void CacheTree::Reset()
 static int s_CacheTreeId = 0;
 #endif
 
-CacheTreeNodePtr CacheTree::_CreateCacheTreeNode(const std::vector<dReal>& cs, CollisionReportPtr report)
+CacheTreeNodePtr CacheTree::_CreateCacheTreeNode(const std::vector<dReal>& cs, CollisionReportPtr report, const Vector* plinkspheres, RobotBase* probot)
 {
     // allocate memory for the structure and the internal state vectors
     void* pmemory;
@@ -204,12 +210,18 @@ CacheTreeNodePtr CacheTree::_CreateCacheTreeNode(const std::vector<dReal>& cs, C
         //std::lock_guard<std::mutex> lock(_mutexpool);
         pmemory = _poolNodes->malloc();
     }
-    //Vector* plinkspheres = (Vector*)((uint8_t*)pmemory + sizeof(CacheTreeNode) + sizeof(dReal)*_statedof);
-    CacheTreeNodePtr newnode = new (pmemory) CacheTreeNode(cs, NULL);
+    Vector* pnodelinkspheres = NULL;
+    if( !!plinkspheres ) {
+        pnodelinkspheres = _GetLinkSpheresMemory(pmemory);
+        if( !!pnodelinkspheres ) {
+            std::copy(plinkspheres, plinkspheres+_numlinkspheres, pnodelinkspheres);
+        }
+    }
+    CacheTreeNodePtr newnode = new (pmemory) CacheTreeNode(cs, pnodelinkspheres);
 #ifdef _DEBUG
     newnode->id = s_CacheTreeId++;
 #endif
-    newnode->SetCollisionInfo(*_pstaterobot, report);
+    newnode->SetCollisionInfo(!!probot ? *probot : *_pstaterobot, report);
     return newnode;
 }
 
@@ -221,8 +233,15 @@ CacheTreeNodePtr CacheTree::_CloneCacheTreeNode(CacheTreeNodeConstPtr refnode)
         //std::lock_guard<std::mutex> lock(_mutexpool);
         pmemory = _poolNodes->malloc();
     }
-    //Vector* plinkspheres = (Vector*)((uint8_t*)pmemory + sizeof(CacheTreeNode) + sizeof(dReal)*_statedof);
-    CacheTreeNodePtr clonenode = new (pmemory) CacheTreeNode(refnode->GetConfigurationState(), _statedof, refnode->_plinkspheres);
+    // copy the link spheres since refnode owns its memory and can be deleted before the clone
+    Vector* plinkspheres = NULL;
+    if( !!refnode->_plinkspheres ) {
+        plinkspheres = _GetLinkSpheresMemory(pmemory);
+        if( !!plinkspheres ) {
+            std::copy(refnode->_plinkspheres, refnode->_plinkspheres+_numlinkspheres, plinkspheres);
+        }
+    }
+    CacheTreeNodePtr clonenode = new (pmemory) CacheTreeNode(refnode->GetConfigurationState(), _statedof, plinkspheres);
 #ifdef _DEBUG
     clonenode->id = s_CacheTreeId++;
 #endif
@@ -444,11 +463,11 @@ std::pair<CacheTreeNodeConstPtr, dReal> CacheTree::FindNearestNode(const std::ve
     return bestnode;
 }
 
-int CacheTree::InsertNode(const std::vector<dReal>& cs, CollisionReportPtr report, dReal fMinSeparationDist)
+int CacheTree::InsertNode(const std::vector<dReal>& cs, CollisionReportPtr report, dReal fMinSeparationDist, const Vector* plinkspheres, RobotBasePtr probot)
 {
 
     OPENRAVE_ASSERT_OP(cs.size(),==,_weights.size());
-    CacheTreeNodePtr nodein = _CreateCacheTreeNode(cs, report);
+    CacheTreeNodePtr nodein = _CreateCacheTreeNode(cs, report, plinkspheres, probot.get());
     // if there is no root, make this the root, otherwise call the lowlevel  insert
     if( _numnodes == 0 ) {
         // no root
@@ -791,6 +810,50 @@ void CacheTree::GetNodeValuesList(std::vector<CacheTreeNodePtr>& lvals)
         }
     }
 }
+
+void CacheTree::CopyFrom(const CacheTree& reference)
+{
+    OPENRAVE_ASSERT_OP(reference._statedof,==,_statedof);
+    Reset();
+    _numlinkspheres = reference._numlinkspheres;
+    _poolNodes.reset(new boost::pool<>(_GetNodeMemorySize()));
+    _weights = reference._weights;
+    _base = reference._base;
+    _fBaseInv = reference._fBaseInv;
+    _fBaseInv2 = reference._fBaseInv2;
+    _fBaseChildMult = reference._fBaseChildMult;
+    _maxdistance = reference._maxdistance;
+    _maxlevel = reference._maxlevel;
+    _minlevel = reference._minlevel;
+    _fMaxLevelBound = reference._fMaxLevelBound;
+    _vsetLevelNodes.resize(reference._vsetLevelNodes.size());
+
+    // first copy every node, then remap the children to the copies
+    std::map<CacheTreeNodeConstPtr, CacheTreeNodePtr> mapCopiedNodes;
+    FOREACHC(itlevelnodes, reference._vsetLevelNodes) {
+        FOREACHC(itnode, *itlevelnodes) {
+            CacheTreeNodePtr newnode = _CloneCacheTreeNode(*itnode);
+            newnode->_collidinglink = (*itnode)->_collidinglink;
+            newnode->_robotlinkindex = (*itnode)->_robotlinkindex;
+            newnode->_level = (*itnode)->_level;
+            newnode->_hasselfchild = (*itnode)->_hasselfchild;
+            newnode->_usenn = (*itnode)->_usenn;
+            mapCopiedNodes[*itnode] = newnode;
+        }
+    }
+    for(size_t ilevel = 0; ilevel < reference._vsetLevelNodes.size(); ++ilevel) {
+        FOREACHC(itnode, reference._vsetLevelNodes[ilevel]) {
+            CacheTreeNodePtr newnode = mapCopiedNodes[*itnode];
+            newnode->_vchildren.resize((*itnode)->_vchildren.size());
+            for(size_t ichild = 0; ichild < (*itnode)->_vchildren.size(); ++ichild) {
+                newnode->_vchildren[ichild] = mapCopiedNodes.at((*itnode)->_vchildren[ichild]);
+            }
+            _vsetLevelNodes[ilevel].insert(newnode);
+        }
+    }
+    _numnodes = reference._numnodes;
+}
+
 int CacheTree::RemoveCollisionConfigurations()
 {
 
@@ -806,9 +869,11 @@ int CacheTree::RemoveCollisionConfigurations()
     return nremoved;
 }
 
+/// \brief identifies cache files written by SaveCache, increase the version whenever the layout changes
+static const char s_CacheFileMagic[8] = {'O','R','C','A','C','H','E','2'};
+
 int CacheTree::SaveCache(std::string filename)
 {
-    //std::lock_guard<std::mutex> lock(_mutexpool);
     _mapNodeIndices.clear();
     int index=0;
     int knownnodes=0;
@@ -821,14 +886,24 @@ int CacheTree::SaveCache(std::string filename)
         }
     }
 
-    _numnodes = knownnodes;
+    // all nodes have to be written in order to keep the tree valid, the unknown nodes are only skipped in the count
+    int numnodes = index;
     _fulldirname = RaveFindDatabaseFile(std::string("selfcache.")+filename,false);
 
-    RAVELOG_DEBUG_FORMAT("Writing cache to %s, size=%d", _fulldirname%_numnodes);
+    RAVELOG_DEBUG_FORMAT("Writing cache to %s, size=%d, known=%d", _fulldirname%numnodes%knownnodes);
 
+    // write to a temporary file and rename it at the end so that other processes mapping the cache never see a partial file
+    const std::string tempfilename = _fulldirname + ".tmp" + boost::lexical_cast<std::string>(utils::GetMicroTime());
     FILE* pfile;
-    pfile = fopen(_fulldirname.c_str(),"wb");
+    pfile = fopen(tempfilename.c_str(),"wb");
+    if( !pfile ) {
+        RAVELOG_WARN_FORMAT("failed to open %s for writing the cache", tempfilename);
+        return 0;
+    }
 
+    int dRealSize = sizeof(dReal);
+    fwrite(s_CacheFileMagic, sizeof(s_CacheFileMagic), 1, pfile);
+    fwrite(&dRealSize, sizeof(dRealSize), 1, pfile);
     fwrite(&_statedof, sizeof(_statedof), 1, pfile);
     fwrite(&_weights[0], sizeof(_weights[0])*_weights.size(), 1, pfile);
     fwrite(&_base, sizeof(_base), 1, pfile);
@@ -838,75 +913,118 @@ int CacheTree::SaveCache(std::string filename)
     fwrite(&_maxdistance, sizeof(_maxdistance), 1, pfile);
     fwrite(&_maxlevel, sizeof(_maxlevel), 1, pfile);
     fwrite(&_minlevel, sizeof(_minlevel), 1, pfile);
-    fwrite(&_numnodes, sizeof(_numnodes), 1, pfile);
+    fwrite(&numnodes, sizeof(numnodes), 1, pfile);
     fwrite(&_fMaxLevelBound, sizeof(_fMaxLevelBound), 1, pfile);
 
     FOREACH(itlevelnodes, _vsetLevelNodes) {
         FOREACH(itnode, *itlevelnodes) {
             _newnode = *itnode;
-            // TODO save only configuration != CNT_Unknown without losing the validity of the tree
-            if (true) { //_newnode->_conftype != CNT_Unknown) {
-                fwrite(&_newnode->_level, sizeof(_newnode->_level), 1, pfile);
-                fwrite(_newnode->GetConfigurationState(), sizeof(dReal)*_statedof, 1, pfile);
-                fwrite(&_newnode->_conftype, sizeof(_newnode->_conftype), 1, pfile);
-
-                if (_newnode->_conftype == CNT_Collision ) {
-                    // note, this assumes the colliding body name never changes across environments, which is a false assumption
-                    _collidingbodyname = _newnode->GetCollidingLink()->GetParent()->GetName();
-                    int namelength = _collidingbodyname.size();
-                    fwrite(&namelength, sizeof(namelength), 1, pfile);
-                    fwrite(_collidingbodyname.c_str(), _collidingbodyname.size(), 1, pfile);
-                    int linkindex = _newnode->GetCollidingLink()->GetIndex();
-                    fwrite(&linkindex, sizeof(linkindex), 1, pfile);
-                    fwrite(&_newnode->_robotlinkindex, sizeof(_newnode->_robotlinkindex), 1, pfile);
-                }
+            fwrite(&_newnode->_level, sizeof(_newnode->_level), 1, pfile);
+            fwrite(_newnode->GetConfigurationState(), sizeof(dReal)*_statedof, 1, pfile);
+            fwrite(&_newnode->_conftype, sizeof(_newnode->_conftype), 1, pfile);
+
+            if (_newnode->_conftype == CNT_Collision ) {
+                // note, this assumes the colliding body name never changes across environments, which is a false assumption
+                _collidingbodyname = _newnode->GetCollidingLink()->GetParent()->GetName();
+                int namelength = _collidingbodyname.size();
+                fwrite(&namelength, sizeof(namelength), 1, pfile);
+                fwrite(_collidingbodyname.c_str(), _collidingbodyname.size(), 1, pfile);
+                int linkindex = _newnode->GetCollidingLink()->GetIndex();
+                fwrite(&linkindex, sizeof(linkindex), 1, pfile);
+                fwrite(&_newnode->_robotlinkindex, sizeof(_newnode->_robotlinkindex), 1, pfile);
+            }
 
-                fwrite(&_newnode->_hasselfchild, sizeof(_newnode->_hasselfchild), 1, pfile);
-                fwrite(&_newnode->_usenn, sizeof(_newnode->_usenn), 1, pfile);
-                int numchildren = _newnode->_vchildren.size();
-                fwrite(&numchildren, sizeof(numchildren), 1, pfile);
+            fwrite(&_newnode->_hasselfchild, sizeof(_newnode->_hasselfchild), 1, pfile);
+            fwrite(&_newnode->_usenn, sizeof(_newnode->_usenn), 1, pfile);
+            int numchildren = _newnode->_vchildren.size();
+            fwrite(&numchildren, sizeof(numchildren), 1, pfile);
 
-                FOREACHC(itchild, (*itnode)->_vchildren) {
-                    int cindex = _mapNodeIndices[*itchild];
-                    fwrite(&cindex, sizeof(cindex), 1, pfile);
-                }
+            FOREACHC(itchild, (*itnode)->_vchildren) {
+                int cindex = _mapNodeIndices[*itchild];
+                fwrite(&cindex, sizeof(cindex), 1, pfile);
             }
         }
     }
 
-    fclose(pfile);
+    bool bwritesuccess = ferror(pfile) == 0;
+    bwritesuccess &= fclose(pfile) == 0;
+    if( !bwritesuccess || std::rename(tempfilename.c_str(), _fulldirname.c_str()) != 0 ) {
+        RAVELOG_WARN_FORMAT("failed to write cache %s", _fulldirname);
+        std::remove(tempfilename.c_str());
+        return 0;
+    }
 
     return 1;
 }
 
+namespace {
+
+/// \brief sequentially reads values from a memory mapped cache file, checking the bounds of the region
+class MappedCacheReader
+{
+public:
+    MappedCacheReader(const uint8_t* pdata, size_t size) : _pdata(pdata), _size(size), _offset(0) {
+    }
+
+    /// \brief copies numbytes into pdest, returns false if the region is exhausted
+    bool Read(void* pdest, size_t numbytes) {
+        if( _offset + numbytes > _size ) {
+            return false;
+        }
+        std::copy(_pdata + _offset, _pdata + _offset + numbytes, (uint8_t*)pdest);
+        _offset += numbytes;
+        return true;
+    }
+
+    template <typename T>
+    bool Read(T& value) {
+        return Read(&value, sizeof(value));
+    }
+
+private:
+    const uint8_t* _pdata;
+    size_t _size;
+    size_t _offset;
+};
+
+}
+
 int CacheTree::LoadCache(std::string filename, EnvironmentBasePtr penv)
 {
-    //std::lock_guard<std::mutex> lock(_mutexpool);
     _fulldirname = RaveFindDatabaseFile(std::string("selfcache.")+filename,false);
 
-    FILE* pfile = fopen(_fulldirname.c_str(),"rb");
-    size_t outs;
+    // map the whole file to parse it without buffered reads, the nodes are copied out of the mapping
+    boost::interprocess::file_mapping filemapping;
+    boost::interprocess::mapped_region mappedregion;
+    try {
+        boost::interprocess::file_mapping(_fulldirname.c_str(), boost::interprocess::read_only).swap(filemapping);
+        boost::interprocess::mapped_region(filemapping, boost::interprocess::read_only).swap(mappedregion);
+    }
+    catch(const boost::interprocess::interprocess_exception& ex) {
+        RAVELOG_VERBOSE_FORMAT("could not map cache %s: %s", _fulldirname%ex.what());
+        return 0;
+    }
 
-    if (!pfile) {
+    MappedCacheReader reader((const uint8_t*)mappedregion.get_address(), mappedregion.get_size());
+    char magic[sizeof(s_CacheFileMagic)];
+    int dRealSize = 0, statedof = 0;
+    if( !reader.Read(magic, sizeof(magic)) || !std::equal(magic, magic+sizeof(magic), s_CacheFileMagic) || !reader.Read(dRealSize) || dRealSize != (int)sizeof(dReal) || !reader.Read(statedof) || statedof != _statedof ) {
+        RAVELOG_WARN_FORMAT("cache %s has an incompatible format, ignoring", _fulldirname);
         return 0;
     }
 
     Reset();
-    outs = fread(&_statedof, sizeof(_statedof), 1, pfile);
-
     _weights.resize(_statedof,1.0);
     _curconf.resize(_statedof,1.0);
-    outs = fread(&_weights[0], sizeof(_weights[0])*_weights.size(), 1, pfile);
-
-    outs = fread(&_base, sizeof(_base), 1, pfile);
-    outs = fread(&_fBaseInv, sizeof(_fBaseInv), 1, pfile);
-    outs = fread(&_fBaseInv2, sizeof(_fBaseInv2), 1, pfile);
-    outs = fread(&_fBaseChildMult, sizeof(_fBaseChildMult), 1, pfile);
-    outs = fread(&_maxdistance, sizeof(_maxdistance), 1, pfile);
-    outs = fread(&_maxlevel, sizeof(_maxlevel), 1, pfile);
-    outs = fread(&_minlevel, sizeof(_minlevel), 1, pfile);
-    outs = fread(&_numnodes, sizeof(_numnodes), 1, pfile);
-    outs = fread(&_fMaxLevelBound, sizeof(_fMaxLevelBound), 1, pfile);
+
+    bool bsuccess = reader.Read(&_weights[0], sizeof(_weights[0])*_weights.size());
+    bsuccess = bsuccess && reader.Read(_base) && reader.Read(_fBaseInv) && reader.Read(_fBaseInv2) && reader.Read(_fBaseChildMult);
+    bsuccess = bsuccess && reader.Read(_maxdistance) && reader.Read(_maxlevel) && reader.Read(_minlevel) && reader.Read(_numnodes) && reader.Read(_fMaxLevelBound);
+    if( !bsuccess || _numnodes < 0 ) {
+        RAVELOG_WARN_FORMAT("cache %s is truncated, ignoring", _fulldirname);
+        _numnodes = 0;
+        return 0;
+    }
 
     int maxenclevel = max(_EncodeLevel(_maxlevel), _EncodeLevel(_minlevel));
     _vsetLevelNodes.resize(maxenclevel+1);
@@ -918,52 +1036,79 @@ int CacheTree::LoadCache(std::string filename, EnvironmentBasePtr penv)
         _vnodes[i] = _CreateCacheTreeNode(_dummycs, CollisionReportPtr());
     }
 
-    for (int inode = 0; inode < _numnodes; ++inode)
+    for (int inode = 0; inode < _numnodes && bsuccess; ++inode)
     {
         _newnode = _vnodes.at(inode);
-        outs = fread(&_newnode->_level, sizeof(_newnode->_level), 1, pfile);
-        outs = fread(_newnode->_pcstate, sizeof(dReal)*_statedof, 1, pfile);
-        outs = fread(&_newnode->_conftype, sizeof(_newnode->_conftype), 1, pfile);
+        bsuccess = reader.Read(_newnode->_level) && reader.Read(_newnode->_pcstate, sizeof(dReal)*_statedof) && reader.Read(_newnode->_conftype);
+        if( !bsuccess ) {
+            break;
+        }
 
         if( _newnode->_conftype == CNT_Collision ) {
-            int namelength;
-            outs = fread(&namelength, sizeof(namelength), 1, pfile);
-            _collidingbodyname.resize(namelength);
-            outs = fread(&_collidingbodyname[0], namelength, 1, pfile);
-            int collidinglinkindex;
-            outs = fread(&collidinglinkindex, sizeof(collidinglinkindex), 1, pfile);
+            int namelength = 0, collidinglinkindex = 0;
+            bsuccess = reader.Read(namelength) && namelength >= 0;
+            if( bsuccess ) {
+                _collidingbodyname.resize(namelength);
+                bsuccess = (namelength == 0 || reader.Read(&_collidingbodyname[0], namelength)) && reader.Read(collidinglinkindex) && reader.Read(_newnode->_robotlinkindex);
+            }
+            if( !bsuccess ) {
+                break;
+            }
             _pcollidingbody = penv->GetKinBody(_collidingbodyname);
-            if( !_pcollidingbody ) {
+            if( !_pcollidingbody || collidinglinkindex < 0 || collidinglinkindex >= (int)_pcollidingbody->GetLinks().size() ) {
+                // without the colliding link the node cannot be reported, so forget its collision information
                 RAVELOG_WARN_FORMAT("loading cache expected colliding body %s, but none found", _collidingbodyname);
+                _newnode->SetType(CNT_Unknown);
             }
             else {
                 _newnode->_collidinglink = _pcollidingbody->GetLinks().at(collidinglinkindex);
             }
-            outs = fread(&_newnode->_robotlinkindex, sizeof(_newnode->_robotlinkindex), 1, pfile);
         }
 
-        outs = fread(&_newnode->_hasselfchild, sizeof(_newnode->_hasselfchild), 1, pfile);
-        outs = fread(&_newnode->_usenn, sizeof(_newnode->_usenn), 1, pfile);
-        int numchildren;
-        outs = fread(&numchildren, sizeof(numchildren), 1, pfile);
+        int numchildren = 0;
+        bsuccess = reader.Read(_newnode->_hasselfchild) && reader.Read(_newnode->_usenn) && reader.Read(numchildren) && numchildren >= 0;
+        if( !bsuccess ) {
+            break;
+        }
         _newnode->_vchildren.resize(numchildren);
 
         // create the copies of the children and insert them
-        for(int i = 0; i < numchildren; ++i) {
-            int childid;
-            outs = fread(&childid, sizeof(childid), 1, pfile);
-            _newnode->_vchildren[i] = _vnodes.at(childid);
+        for(int i = 0; i < numchildren && bsuccess; ++i) {
+            int childid = -1;
+            bsuccess = reader.Read(childid) && childid >= 0 && childid < _numnodes;
+            if( bsuccess ) {
+                _newnode->_vchildren[i] = _vnodes[childid];
+            }
         }
 
-        _vsetLevelNodes.at(_EncodeLevel(_newnode->_level)).insert(_newnode);
+        int enclevel = _EncodeLevel(_newnode->_level);
+        if( enclevel >= (int)_vsetLevelNodes.size() ) {
+            bsuccess = false;
+            break;
+        }
+        _vsetLevelNodes[enclevel].insert(_newnode);
     }
 
-    fclose(pfile);
+    if( !bsuccess ) {
+        RAVELOG_WARN_FORMAT("cache %s is corrupted, ignoring", _fulldirname);
+        // nodes not yet inserted into _vsetLevelNodes are not destroyed by Reset
+        std::set<CacheTreeNodePtr> setinserted;
+        FOREACH(itlevelnodes, _vsetLevelNodes) {
+            setinserted.insert(itlevelnodes->begin(), itlevelnodes->end());
+        }
+        FOREACH(itnode, _vnodes) {
+            if( setinserted.count(*itnode) == 0 ) {
+                (*itnode)->~CacheTreeNode();
+            }
+        }
+        _vnodes.resize(0);
+        Reset();
+        return 0;
+    }
 
     _vnodes.resize(0);
 
-    int numloaded = GetNumKnownNodes();
-    OPENRAVE_ASSERT_OP(numloaded,==,_numnodes);
+    RAVELOG_VERBOSE_FORMAT("loaded %d nodes (%d known) from %s", _numnodes%GetNumKnownNodes()%_fulldirname);
     return 1;
 }
 
@@ -974,7 +1119,7 @@ int CacheTree::UpdateCollisionConfigurations(KinBodyPtr pbody)
         FOREACH(itlevelnodes, _vsetLevelNodes) {
             FOREACH(itnode, *itlevelnodes) {
                 _newnode = *itnode;
-                if ((_newnode->GetType() == CNT_Collision) && (pbody == _newnode->GetCollidingLink()->GetParent())) {
+                if ((_newnode->GetType() == CNT_Collision) && _IsCollidingWithBody(*_newnode, *pbody)) {
                     _newnode->SetType(CNT_Unknown);
                     nremoved += 1;
                 }
@@ -986,7 +1131,7 @@ int CacheTree::UpdateCollisionConfigurations(KinBodyPtr pbody)
     return nremoved;
 }
 
-int CacheTree::UpdateFreeConfigurations(KinBodyPtr pbody) //todo only remove those with overlaping linkspheres
+int CacheTree::UpdateFreeConfigurations(const AABB& ab, dReal fLinkSpherePadding)
 {
     int nremoved=0;
     if (_numnodes > 0) {
@@ -994,8 +1139,23 @@ int CacheTree::UpdateFreeConfigurations(KinBodyPtr pbody) //todo only remove tho
         FOREACH(itlevelnodes, _vsetLevelNodes) {
             FOREACH(itnode, *itlevelnodes) {
                 if (((*itnode)->GetType() == CNT_Free)) {
-                    (*itnode)->SetType(CNT_Unknown);
-                    nremoved += 1;
+                    const Vector* plinkspheres = (*itnode)->GetLinkSpheres();
+                    bool boverlap = !plinkspheres;
+                    for(int isphere = 0; isphere < _numlinkspheres && !boverlap; ++isphere) {
+                        // squared distance from the sphere center to the box
+                        dReal fdist2 = 0;
+                        for(int idim = 0; idim < 3; ++idim) {
+                            dReal f = RaveFabs(plinkspheres[isphere][idim] - ab.pos[idim]) - ab.extents[idim];
+                            if( f > 0 ) {
+                                fdist2 += f*f;
+                            }
+                        }
+                        boverlap = fdist2 <= Sqr(RaveSqrt(plinkspheres[isphere].w) + fLinkSpherePadding);
+                    }
+                    if( boverlap ) {
+                        (*itnode)->SetType(CNT_Unknown);
+                        nremoved += 1;
+                    }
                 }
             }
         }
@@ -1007,6 +1167,19 @@ int CacheTree::UpdateFreeConfigurations(KinBodyPtr pbody) //todo only remove tho
     return nremoved;
 }
 
+bool CacheTree::_IsCollidingWithBody(const CacheTreeNode& node, const KinBody& body)
+{
+    KinBodyPtr pcollidingbody = node.GetCollidingLink()->GetParent(true);
+    if( !pcollidingbody ) {
+        return true; // body was destroyed, so node is stale
+    }
+    if( pcollidingbody.get() == &body ) {
+        return true;
+    }
+    // the tree can be shared with caches of cloned environments, so compare by name if the body is from another environment
+    return pcollidingbody->GetEnv() != body.GetEnv() && pcollidingbody->GetName() == body.GetName();
+}
+
 int CacheTree::RemoveFreeConfigurations()
 {
     int nremoved=0;
@@ -1142,8 +1315,10 @@ bool CacheTree::Validate()
     return true;
 }
 
-ConfigurationCache::ConfigurationCache(RobotBasePtr pstaterobot, bool envupdates) : _cachetree(pstaterobot, pstaterobot->GetDOF())
+ConfigurationCache::ConfigurationCache(RobotBasePtr pstaterobot, bool envupdates)
 {
+    // only the environment cache needs link spheres to localize invalidations
+    _pcachetree.reset(new CacheTree(pstaterobot, pstaterobot->GetDOF(), envupdates ? (int)pstaterobot->GetLinks().size() : 0));
     _userdatakey = std::string("configurationcache") + boost::lexical_cast<std::string>(this);
     _pstaterobot = pstaterobot;
     _penv = pstaterobot->GetEnv();
@@ -1203,6 +1378,7 @@ ConfigurationCache::ConfigurationCache(RobotBasePtr pstaterobot, bool envupdates
     _collisionthresh = 1.0; // discretization distance used by the original collisionchecker
     _freespacethresh = 0.2; // half disc. distance used by the original collisionchecker
     _insertiondistancemult = 0.5;
+    _linkspherepadding = 0.05;
 
 
     _handleJointLimitChange = pstaterobot->RegisterChangeCallback(KinBody::Prop_JointLimits, boost::bind(&ConfigurationCache::_UpdateRobotJointLimits, this));
@@ -1216,11 +1392,11 @@ ConfigurationCache::ConfigurationCache(RobotBasePtr pstaterobot, bool envupdates
         maxdistance += f*f;
     }
 
-    _cachetree.Init(_vweights, RaveSqrt(maxdistance));
+    _pcachetree->Init(_vweights, RaveSqrt(maxdistance));
 
     if (IS_DEBUGLEVEL(Level_Verbose)) {
         stringstream ss; ss << std::setprecision(std::numeric_limits<OpenRAVE::dReal>::digits10+1);
-        ss << "Initializing cache,  maxdistance " << _cachetree.GetMaxDistance() << ", weights [";
+        ss << "Initializing cache,  maxdistance " << _pcachetree->GetMaxDistance() << ", weights [";
         for (size_t i = 0; i < _vweights.size(); ++i) {
             ss << _vweights[i] << " ";
         }
@@ -1243,7 +1419,10 @@ ConfigurationCache::ConfigurationCache(RobotBasePtr pstaterobot, bool envupdates
 
 ConfigurationCache::~ConfigurationCache()
 {
-    _cachetree.Reset();
+    // a shared tree is still used by other caches
+    if( !IsCacheTreeShared() ) {
+        _pcachetree->Reset();
+    }
     // have to destroy all the change callbacks!
     FOREACH(it, _listCachedData) {
         KinBodyCachedDataPtr pdata = it->lock();
@@ -1256,7 +1435,46 @@ ConfigurationCache::~ConfigurationCache()
 
 void ConfigurationCache::SetWeights(const std::vector<dReal>& weights)
 {
-    _cachetree.SetWeights(weights);
+    std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+    _pcachetree->SetWeights(weights);
+}
+
+void ConfigurationCache::SetCacheTree(CacheTreePtr pcachetree)
+{
+    OPENRAVE_ASSERT_OP_FORMAT((int)pcachetree->GetWeights().size(), ==, (int)_pcachetree->GetWeights().size(), "cannot share cache tree of robot %s since state dof differ", _pstaterobot->GetName(), ORE_InvalidArguments);
+    _pcachetree = pcachetree;
+}
+
+void ConfigurationCache::_DetachSharedCacheTree()
+{
+    if( IsCacheTreeShared() ) {
+        CacheTreePtr pnewcachetree(new CacheTree(_pstaterobot, _pstaterobot->GetDOF(), _pcachetree->GetNumLinkSpheres()));
+        {
+            std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+            pnewcachetree->CopyFrom(*_pcachetree);
+        }
+        RAVELOG_VERBOSE_FORMAT("env=%s, environment of robot %s changed, detaching shared cache with %d nodes", _penv->GetNameId()%_pstaterobot->GetName()%pnewcachetree->GetNumNodes());
+        _pcachetree = pnewcachetree;
+    }
+}
+
+bool ConfigurationCache::_ComputeLinkSpheres()
+{
+    const std::vector<KinBody::LinkPtr>& vlinks = _pstaterobot->GetLinks();
+    if( (int)vlinks.size() != _pcachetree->GetNumLinkSpheres() ) {
+        return false;
+    }
+    // grabbed bodies move with the robot, but are not enclosed by the link spheres
+    if( _pstaterobot->GetNumGrabbed() > 0 ) {
+        return false;
+    }
+    _vlinkspheres.resize(vlinks.size());
+    for(size_t ilink = 0; ilink < vlinks.size(); ++ilink) {
+        AABB ab = vlinks[ilink]->ComputeAABB();
+        _vlinkspheres[ilink] = ab.pos;
+        _vlinkspheres[ilink].w = ab.extents.lengthsqr3();
+    }
+    return true;
 }
 
 bool ConfigurationCache::InsertConfiguration(const std::vector<dReal>& conf, CollisionReportPtr report, dReal distin)
@@ -1269,34 +1487,46 @@ bool ConfigurationCache::InsertConfiguration(const std::vector<dReal>& conf, Col
             }
         }
     }
-    int ret = _cachetree.InsertNode(conf, report, !report ? _freespacethresh*_insertiondistancemult : _collisionthresh*_insertiondistancemult);
+    // free nodes remember where the robot links are, so that only nodes close to a changed body have to be invalidated
+    const Vector* plinkspheres = NULL;
+    if( !report && _pcachetree->GetNumLinkSpheres() > 0 && _ComputeLinkSpheres() ) {
+        plinkspheres = &_vlinkspheres[0];
+    }
+    std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+    int ret = _pcachetree->InsertNode(conf, report, !report ? _freespacethresh*_insertiondistancemult : _collisionthresh*_insertiondistancemult, plinkspheres, _pstaterobot);
     BOOST_ASSERT(ret!=0);
     return ret==1;
 }
 
 int ConfigurationCache::GetNumKnownNodes()
 {
-    return _cachetree.GetNumKnownNodes();
+    std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+    return _pcachetree->GetNumKnownNodes();
 }
 
 int ConfigurationCache::RemoveCollisionConfigurations()
 {
-    return _cachetree.RemoveCollisionConfigurations();
+    std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+    return _pcachetree->RemoveCollisionConfigurations();
 }
 
 int ConfigurationCache::UpdateCollisionConfigurations(KinBodyPtr pbody)
 {
-    return _cachetree.UpdateCollisionConfigurations(pbody);
+    std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+    return _pcachetree->UpdateCollisionConfigurations(pbody);
 }
 
 int ConfigurationCache::UpdateFreeConfigurations(KinBodyPtr pbody)
 {
-    return _cachetree.UpdateFreeConfigurations(pbody);
+    AABB ab = pbody->ComputeAABB(true);
+    std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+    return _pcachetree->UpdateFreeConfigurations(ab, _linkspherepadding);
 }
 
 int ConfigurationCache::RemoveFreeConfigurations()
 {
-    return _cachetree.RemoveFreeConfigurations();
+    std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+    return _pcachetree->RemoveFreeConfigurations();
 }
 
 void ConfigurationCache::GetDOFValues(std::vector<dReal>& values)
@@ -1323,7 +1553,8 @@ void ConfigurationCache::GetDOFValues(std::vector<dReal>& values)
 
 int ConfigurationCache::CheckCollision(const std::vector<dReal>& conf, KinBody::LinkConstPtr& robotlink, KinBody::LinkConstPtr& collidinglink, dReal& closestdist)
 {
-    std::pair<CacheTreeNodeConstPtr, dReal> knn = _cachetree.FindNearestNode(conf, _collisionthresh, _freespacethresh);
+    std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+    std::pair<CacheTreeNodeConstPtr, dReal> knn = _pcachetree->FindNearestNode(conf, _collisionthresh, _freespacethresh);
 
     if( !!knn.first ) {
 
@@ -1337,6 +1568,17 @@ int ConfigurationCache::CheckCollision(const std::vector<dReal>& conf, KinBody::
                 robotlink = _pstaterobot->GetLinks().at(knn.first->GetRobotLinkIndex());
             }
             collidinglink = knn.first->GetCollidingLink();
+            KinBodyPtr pcollidingbody = collidinglink->GetParent(true);
+            if( !!pcollidingbody && pcollidingbody->GetEnv() != _penv ) {
+                // node was inserted by a cache sharing the tree from a cloned environment
+                KinBodyPtr pbody = _penv->GetKinBody(pcollidingbody->GetName());
+                if( !!pbody && collidinglink->GetIndex() < (int)pbody->GetLinks().size() ) {
+                    collidinglink = pbody->GetLinks()[collidinglink->GetIndex()];
+                }
+                else {
+                    return -1;
+                }
+            }
             return 1;
         }
         return 0;
@@ -1346,7 +1588,8 @@ int ConfigurationCache::CheckCollision(const std::vector<dReal>& conf, KinBody::
 
 std::pair<std::vector<dReal>, dReal> ConfigurationCache::FindNearestNode(const std::vector<dReal>& conf, dReal dist)
 {
-    std::pair<CacheTreeNodeConstPtr, dReal> knn = _cachetree.FindNearestNode(conf, dist, CNT_Any);
+    std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+    std::pair<CacheTreeNodeConstPtr, dReal> knn = _pcachetree->FindNearestNode(conf, dist, CNT_Any);
 
     if( !!knn.first ) {
         return make_pair(std::vector<dReal>(knn.first->GetConfigurationState(), knn.first->GetConfigurationState()+_lowerlimit.size()), knn.second);
@@ -1364,21 +1607,34 @@ int ConfigurationCache::CheckCollision(KinBody::LinkConstPtr& robotlink, KinBody
 void ConfigurationCache::Reset()
 {
     RAVELOG_DEBUG("Resetting cache\n");
-    _cachetree.Reset();
+    if( IsCacheTreeShared() ) {
+        // do not clear the configurations of the other caches
+        CacheTreePtr poldcachetree = _pcachetree;
+        _pcachetree.reset(new CacheTree(_pstaterobot, _pstaterobot->GetDOF(), poldcachetree->GetNumLinkSpheres()));
+        std::lock_guard<std::mutex> lock(poldcachetree->GetMutex());
+        _pcachetree->Init(poldcachetree->GetWeights(), poldcachetree->GetMaxDistance());
+        _pcachetree->SetBase(poldcachetree->GetBase());
+    }
+    else {
+        std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+        _pcachetree->Reset();
+    }
 }
 
 bool ConfigurationCache::Validate()
 {
-    return _cachetree.Validate();
+    std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+    return _pcachetree->Validate();
 }
 
 void ConfigurationCache::_UpdateUntrackedBody(KinBodyPtr pbody)
 {
-    // body's state has changed, so remove collision space and invalidate free space.
+    // body's state has changed, so remove collision space and invalidate the free space around the body.
     if(_envupdates) {
         RAVELOG_VERBOSE_FORMAT("%s %s","Updating untracked bodies"%pbody->GetName());
+        _DetachSharedCacheTree();
         UpdateCollisionConfigurations(pbody);
-        RemoveFreeConfigurations();
+        UpdateFreeConfigurations(pbody);
     }
 }
 
@@ -1386,8 +1642,9 @@ void ConfigurationCache::_UpdateAddRemoveBodies(KinBodyPtr pbody, int action)
 {
     if( action == 1 ) {
         if (_envupdates) {
-            // invalidate the freespace of a cache given a new body in the scene
-            if (RemoveFreeConfigurations() > 0) {
+            // invalidate the freespace of a cache overlapping with the new body in the scene
+            _DetachSharedCacheTree();
+            if (UpdateFreeConfigurations(pbody) > 0) {
                 RAVELOG_DEBUG_FORMAT("%s %s %d","Updating add/remove bodies"%pbody->GetName()%action);
             }
             KinBodyCachedDataPtr pinfo(new KinBodyCachedData());
@@ -1398,6 +1655,7 @@ void ConfigurationCache::_UpdateAddRemoveBodies(KinBodyPtr pbody, int action)
     }
     else if( action == 0 ) {
         if (_envupdates) {
+            _DetachSharedCacheTree();
             if ( UpdateCollisionConfigurations(pbody) > 0) {
                 RAVELOG_DEBUG_FORMAT("%s %s %d","Updating add/remove bodies"%pbody->GetName()%action);
                 // remove all configurations that collide with this body
@@ -1423,12 +1681,14 @@ void ConfigurationCache::_UpdateRobotJointLimits()
             // otherwise, distances larger than this value could be inserted into the tree
             dReal maxdistance = 0;
             for (size_t i = 0; i < _lowerlimit.size(); ++i) {
-                dReal f = (_upperlimit[i] - _lowerlimit[i]) * _cachetree.GetWeights().at(i);
+                dReal f = (_upperlimit[i] - _lowerlimit[i]) * _pcachetree->GetWeights().at(i);
                 maxdistance += f*f;
             }
             maxdistance = RaveSqrt(maxdistance);
-            if( maxdistance > _cachetree.GetMaxDistance()+g_fEpsilonLinear ) {
-                _cachetree.SetMaxDistance(maxdistance);
+            if( maxdistance > _pcachetree->GetMaxDistance()+g_fEpsilonLinear ) {
+                _DetachSharedCacheTree();
+                std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+                _pcachetree->SetMaxDistance(maxdistance);
             }
 
             _lowerlimit = _newlowerlimit;
@@ -1454,6 +1714,7 @@ void ConfigurationCache::_UpdateRobotGrabbed()
 
     if (newGrab) {
         RAVELOG_DEBUG("Updating robot grabbed\n");
+        _DetachSharedCacheTree();
         FOREACH(newbody, _vnewgrabbedbodies){
             UpdateCollisionConfigurations((*newbody));
         }
@@ -17,6 +17,7 @@
 
 #include "openraveplugindefs.h"
 #include <deque>
+#include <mutex>
 #include <boost/pool/pool.hpp>
 
 #define _(msgid) OpenRAVE::RaveGetLocalizedTextForDomain("openrave_plugins_configurationcache", msgid)
@@ -61,6 +62,11 @@ public:
         return _robotlinkindex;
     }
 
+    /// \brief returns the enclosing spheres of the robot links at this configuration (xyz is center, w is radius^2), or NULL if they were not recorded
+    inline const Vector* GetLinkSpheres() const {
+        return _plinkspheres;
+    }
+
     /// \brief returns true if configuration is in collision
     bool IsInCollision() const {
         return _conftype == CNT_Collision;
@@ -165,7 +171,8 @@ class CacheTree
 {
 public:
 
-    CacheTree(RobotBasePtr& pstaterobot, int statedof);
+    /// \param numlinkspheres if > 0, every node reserves memory for this many link spheres that can be filled at insertion time and used for localized invalidation of free configurations
+    CacheTree(RobotBasePtr& pstaterobot, int statedof, int numlinkspheres=0);
 
     virtual ~CacheTree();
 
@@ -191,8 +198,10 @@ public:
     /// \brief inserts node in the tree. If node is too close to other nodes in the tree, then does not insert.
     ///
     /// \param[in] fMinSeparationDist the max distance a node should be separated from its closest neighbor. If node is collision, then only applies to collision neighbors, free neighbors are ignored.
+    /// \param[in] plinkspheres if not NULL, GetNumLinkSpheres() enclosing spheres of the robot links at cs that are copied into the node
+    /// \param[in] probot the robot the report was computed for. If empty, uses the robot the tree was created with. Has to be set when the tree is shared across environments.
     /// \return 1 if point is inserted and parent found. 0 if no parent found and point is not inserted. -1 if parent found but point not inserted since it is close to fMinSeparationDist
-    int InsertNode(const std::vector<dReal>& cs, CollisionReportPtr report, dReal fMinSeparationDist);
+    int InsertNode(const std::vector<dReal>& cs, CollisionReportPtr report, dReal fMinSeparationDist, const Vector* plinkspheres=NULL, RobotBasePtr probot=RobotBasePtr());
 
     /// \brief removes node from the tree
     ///
@@ -207,6 +216,19 @@ public:
         return _numnodes;
     }
 
+    /// \brief number of link spheres every node can hold
+    int GetNumLinkSpheres() const {
+        return _numlinkspheres;
+    }
+
+    /// \brief resets the tree and deep copies all nodes of reference into it. Both trees must have the same state dof.
+    void CopyFrom(const CacheTree& reference);
+
+    /// \brief mutex protecting the tree for users sharing it across threads. CacheTree itself does not lock it.
+    inline std::mutex& GetMutex() const {
+        return _mutex;
+    }
+
     /// \brief return the configuration values for all nodes in the tree
     void GetNodeValues(std::vector<dReal>& vals) const;
 
@@ -252,23 +274,38 @@ public:
     /// \brief sets all collision configurations with pbody in its report to CNT_Unknown
     int UpdateCollisionConfigurations(KinBodyPtr pbody);
 
-    /// \brief sets all free configurations to CNT_Unknown, TODO, only set those that overlap with the new body
-    int UpdateFreeConfigurations(KinBodyPtr pbody);
+    /// \brief sets free configurations whose link spheres (inflated by fLinkSpherePadding) overlap with ab to CNT_Unknown. Free configurations without link spheres are always reset.
+    int UpdateFreeConfigurations(const AABB& ab, dReal fLinkSpherePadding);
 
     /// \brief returns the number of configurations in the tree that are not CNT_Unknown
     int GetNumKnownNodes();
 
-    /// \brief save cache to disk
+    /// \brief save cache to disk. The file is first written to a temporary file and then renamed so that concurrent readers never see a partially written cache.
     int SaveCache(std::string filename);
 
-    /// \brief load cache from disk
+    /// \brief load cache from disk. The file is memory mapped only while it is parsed, its nodes are copied into the node pool of the tree and the mapping is released before returning.
+    ///
+    /// \return 1 if the cache was loaded, 0 if the file does not exist or is not a valid cache file
     int LoadCache(std::string filename, EnvironmentBasePtr penv);
 
 private:
     /// \brief creates new node on the pool
-    CacheTreeNodePtr _CreateCacheTreeNode(const std::vector<dReal>& cs, CollisionReportPtr report);
+    CacheTreeNodePtr _CreateCacheTreeNode(const std::vector<dReal>& cs, CollisionReportPtr report, const Vector* plinkspheres=NULL, RobotBase* probot=NULL);
     CacheTreeNodePtr _CloneCacheTreeNode(CacheTreeNodeConstPtr refnode);
 
+    /// \brief returns the memory where the link spheres of a node allocated at pmemory are stored, NULL if the tree does not hold link spheres
+    inline Vector* _GetLinkSpheresMemory(void* pmemory) const {
+        return _numlinkspheres > 0 ? (Vector*)((uint8_t*)pmemory + sizeof(CacheTreeNode) + sizeof(dReal)*_statedof) : NULL;
+    }
+
+    /// \brief the allocation size of one node including its state and link spheres
+    inline size_t _GetNodeMemorySize() const {
+        return sizeof(CacheTreeNode) + sizeof(dReal)*_statedof + sizeof(Vector)*_numlinkspheres;
+    }
+
+    /// \brief returns true if the collision node's colliding link belongs to body or to the body with the same name in a cloned environment
+    static bool _IsCollidingWithBody(const CacheTreeNode& node, const KinBody& body);
+
     /// \brief deletes the node from the pool and calls its destructor.
     void _DeleteCacheTreeNode(CacheTreeNodePtr pnode);
 
@@ -333,6 +370,7 @@ private:
     dReal _base, _fBaseInv, _fBaseInv2, _fBaseChildMult; ///< a constant used to control the max level of traversion. _fBaseInv = 1/_base, _fBaseInv2=Sqr(_fBaseInv), _fBaseChildMult=1/(_base-1)
 
     int _statedof; ///< the state space DOF tree is configured for
+    int _numlinkspheres; ///< number of link spheres allocated after the state of every node
     int _maxlevel; ///< the maximum allowed levels in the tree, this is where the root node starts (inclusive)
     int _minlevel; ///< the minimum allowed levels in the tree (inclusive)
     int _numnodes; ///< the number of nodes in the current tree starting at the root at _vsetLevelNodes.at(_EncodeLevel(_maxlevel))
@@ -344,9 +382,12 @@ private:
 
     std::vector<CacheTreeNodePtr> _vnodes; ///< for loading
     std::vector<dReal> _dummycs; ///< for loading
+
+    mutable std::mutex _mutex; ///< see GetMutex()
 };
 
 typedef OPENRAVE_SHARED_PTR<CacheTree> CacheTreePtr;
+typedef OPENRAVE_WEAK_PTR<CacheTree> CacheTreeWeakPtr;
 
 /** Maintains an up-to-date cache tree synchronized to the openrave environment. Tracks bodies being added removed, states changing, etc.
    The state of cache consists of the active DOFs of the robot that is passed in at constructor time.
@@ -377,7 +418,7 @@ public:
     /// \brief removes all free configurations
     int RemoveFreeConfigurations();
 
-    /// \brief removes all free configurations, to be updated to only remove those with linkspheres that overlap with the body
+    /// \brief removes free configurations whose link spheres overlap with the AABB of pbody
     int UpdateFreeConfigurations(KinBodyPtr pbody);
 
     /// \brief determine if current configuration is whithin threshold of a collision in the cache (_collisionthresh), known to be in collision, or requires an explicit collision check
@@ -395,7 +436,7 @@ public:
 
     /// \brief number of nodes currently in the cover tree
     int GetNumNodes() const {
-        return _cachetree.GetNumNodes();
+        return _pcachetree->GetNumNodes();
     }
 
     /// \brief number of nodes with known type, i.e., != CNT_Unknown
@@ -403,7 +444,8 @@ public:
 
     /// \brief return configuration values for all nodes in the tree, calls cachetree's function
     void GetNodeValues(std::vector<dReal>& vals) const {
-        _cachetree.GetNodeValues(vals);
+        std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+        _pcachetree->GetNodeValues(vals);
     }
 
     /// \brief return nearest configuration and distance
@@ -411,7 +453,7 @@ public:
 
     /// \brief return distance between two configurations as computed by the tree (for testing)
     dReal ComputeDistance(const std::vector<dReal>& qi, const std::vector<dReal>& qf) const {
-        return _cachetree.ComputeDistance(qi,qf);
+        return _pcachetree->ComputeDistance(qi,qf);
     }
 
     /// \brief the cache will assume a new configuration is in collision if the nearest node in the tree is below this distance
@@ -429,7 +471,8 @@ public:
     /// \brief set the base parameter
     inline void SetBase(dReal base)
     {
-        _cachetree.SetBase(base);
+        std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+        _pcachetree->SetBase(base);
     }
 
     /// \brief disable environment updates
@@ -474,7 +517,7 @@ public:
     /// \brief returns the base parameter
     inline dReal GetBase() const
     {
-        return _cachetree.GetBase();
+        return _pcachetree->GetBase();
     }
 
     /// \brief returns the robot
@@ -488,19 +531,53 @@ public:
     /// \brief remove all nodes in collision with pbody, for testing
     inline void UpdateCollisionNodes(KinBodyPtr pbody)
     {
-        _cachetree.UpdateCollisionNodes(pbody);
+        std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+        _pcachetree->UpdateCollisionNodes(pbody);
     }
 
     /// \brief saves the cache to disk
     inline void SaveCache(std::string filename)
     {
-        _cachetree.SaveCache(filename);
+        std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+        _pcachetree->SaveCache(filename);
     }
 
     /// \brief loads cache from disk
     inline void LoadCache(std::string filename, EnvironmentBasePtr penv)
     {
-        _cachetree.LoadCache(filename, penv);
+        std::lock_guard<std::mutex> lock(_pcachetree->GetMutex());
+        _pcachetree->LoadCache(filename, penv);
+    }
+
+    /// \brief free configurations are only invalidated by a body if their link spheres inflated by this distance overlap with the body
+    inline void SetLinkSpherePadding(dReal padding)
+    {
+        _linkspherepadding = padding;
+    }
+
+    /// \brief returns the link sphere padding
+    inline dReal GetLinkSpherePadding() const
+    {
+        return _linkspherepadding;
+    }
+
+    /// \brief returns the cache tree, which can be passed to SetCacheTree of caches in other (cloned) environments in order to share the collected configurations
+    inline CacheTreePtr GetCacheTree() const
+    {
+        return _pcachetree;
+    }
+
+    /// \brief shares pcachetree with this cache. All access to the tree is serialized through the tree's mutex.
+    ///
+    /// When an environment change would invalidate nodes of a shared tree, this cache first makes a private copy of the
+    /// tree (copy-on-write), so that caches in environments that did not change keep their nodes.
+    /// \param pcachetree has to be configured for the same state dof
+    void SetCacheTree(CacheTreePtr pcachetree);
+
+    /// \brief returns true if the cache tree is shared with another cache
+    inline bool IsCacheTreeShared() const
+    {
+        return _pcachetree.use_count() > 1;
     }
 
 private:
@@ -516,7 +593,15 @@ private:
     /// \brief called when grabbeb bodies are updated
     void _UpdateRobotGrabbed();
 
-    CacheTree _cachetree; ///< cache tree datastructure with configurations and their collision information
+    /// \brief if the cache tree is shared, replace it with a private copy. Has to be called before invalidating any nodes because of changes in this cache's environment.
+    void _DetachSharedCacheTree();
+
+    /// \brief computes the enclosing spheres of the robot links at the current robot state into _vlinkspheres
+    ///
+    /// \return false if the spheres do not bound the robot, for example because it is grabbing bodies
+    bool _ComputeLinkSpheres();
+
+    CacheTreePtr _pcachetree; ///< cache tree datastructure with configurations and their collision information, can be shared across caches of cloned environments
 
     RobotBasePtr _pstaterobot;
     std::vector<int> _vRobotActiveIndices;
@@ -531,6 +616,7 @@ private:
     std::vector<dReal> _newupperlimit, _newlowerlimit;
     std::vector<CacheTreeNodePtr> _cachetreenodes;
     std::vector<dReal> _vweights;
+    std::vector<Vector> _vlinkspheres; ///< cache for _ComputeLinkSpheres
 
     class KinBodyCachedData : public UserData
     {
@@ -545,6 +631,7 @@ public:
 
     dReal _collisionthresh; ///< configurations in this distance range (from a collsion configuration in the tree) will be assumed to be in collision
     dReal _freespacethresh; ///< configurations in this distance range (from a free configuration in the tree)  will be assumed to not be in collision
+    dReal _linkspherepadding; ///< see SetLinkSpherePadding
     dReal _insertiondistancemult; ///< only insert nodes if they are far from the nearest node in the tree. The distance is computed by multiplying this number of _collisionthresh or _freespacethresh. Distance a configuration must have from the nearest configuration in the tree in order for it be inserted
     std::string _userdatakey;
     UserDataPtr _handleJointLimitChange, _handleGrabbedChange; ///< handles for changes in the robot's joint limits and grabbed bodies
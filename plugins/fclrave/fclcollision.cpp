@@ -135,6 +135,8 @@ namespace fclrave
         // TODO : Consider removing these which could be more harmful than anything else
         RegisterCommand("SetBroadphaseAlgorithm", boost::bind(&FCLCollisionChecker::SetBroadphaseAlgorithmCommand, this, _1, _2), "sets the broadphase algorithm (Naive, SaP, SSaP, IntervalTree, DynamicAABBTree, DynamicAABBTree_Array)");
         RegisterCommand("SetBVHRepresentation", boost::bind(&FCLCollisionChecker::_SetBVHRepresentation, this, _1, _2), "sets the Bouding Volume Hierarchy representation for meshes (AABB, OBB, OBBRSS, RSS, kIDS)");
+        RegisterCommand("SetConvexGeometryGroup", boost::bind(&FCLCollisionChecker::_SetConvexGeometryGroup, this, _1, _2), "sets the geometry group whose meshes are convex pieces (for example 'convexdecomposition') so that they are checked with GJK/EPA instead of a BVH. No name disables it.");
+        RegisterCommand("GetNumSharedGeometries", boost::bind(&FCLCollisionChecker::_GetNumSharedGeometries, this, _1, _2), "returns the number of mesh collision geometries reused from the checker this one was cloned from");
 
         RAVELOG_VERBOSE_FORMAT("FCLCollisionChecker %s created in env %d", _userdatakey % penv->GetId());
 
@@ -195,11 +197,17 @@ namespace fclrave
         // We don't clone Kinbody's specific geometry group
         _fclspace->SetGeometryGroup(r->GetGeometryGroup());
         _fclspace->SetBVHRepresentation(r->GetBVHRepresentation());
+        _fclspace->SetConvexGeometryGroup(r->_fclspace->GetConvexGeometryGroup());
         _SetBroadphaseAlgorithm(r->GetBroadphaseAlgorithm());
 
         // We don't want to clone _bIsSelfCollisionChecker since a self collision checker can be created by cloning a environment collision checker
         _options = r->_options;
         _numMaxContacts = r->_numMaxContacts;
+        if (cloningoptions & OpenRAVE::Clone_Bodies)
+        {
+            // the cloned bodies reuse the BVHs of the reference instead of rebuilding them when they are initialized
+            _fclspace->SeedFromSpace(*r->_fclspace);
+        }
         RAVELOG_VERBOSE(str(boost::format("FCL User data cloning env %d into env %d") % r->GetEnv()->GetId() % GetEnv()->GetId()));
     }
 
@@ -244,6 +252,20 @@ namespace fclrave
         return !!sinput;
     }
 
+    bool FCLCollisionChecker::_SetConvexGeometryGroup(ostream &sout, istream &sinput)
+    {
+        std::string groupname;
+        sinput >> groupname;
+        _fclspace->SetConvexGeometryGroup(groupname);
+        return true;
+    }
+
+    bool FCLCollisionChecker::_GetNumSharedGeometries(ostream &sout, istream &sinput)
+    {
+        sout << _fclspace->GetNumSharedGeometries();
+        return true;
+    }
+
     bool FCLCollisionChecker::InitEnvironment()
     {
         RAVELOG_VERBOSE(str(boost::format("FCL User data initializing %s in env %d") % _userdatakey % GetEnv()->GetId()));
@@ -815,6 +837,11 @@ namespace fclrave
             {
                 continue;
             }
+            // precomputed by KinBody::ComputeSelfCollisionLinkPairCulling
+            if (pbody->IsLinkPairCollisionFree(index1, index2))
+            {
+                continue;
+            }
             FOREACH(itgeom1, pLINK1.vgeoms)
             {
                 FOREACH(itgeom2, pLINK2.vgeoms)
@@ -898,6 +925,10 @@ namespace fclrave
                 {
                     continue;
                 }
+                if (pbody->IsLinkPairCollisionFree(index1, index2))
+                {
+                    continue;
+                }
                 FOREACH(itgeom1, pLINK1.vgeoms)
                 {
                     FOREACH(itgeom2, pLINK2.vgeoms)
@@ -1387,8 +1418,20 @@ namespace fclrave
 
     std::pair<FCLSpace::FCLKinBodyInfo::FCLGeometryInfo *, GeometryConstPtr> FCLCollisionChecker::GetCollisionGeometry(const fcl::CollisionObject<float> &collObj)
     {
-        const std::shared_ptr<const fcl::CollisionGeometry<float>> &collgeom = collObj.collisionGeometry();
-        FCLSpace::FCLKinBodyInfo::FCLGeometryInfo *geom_raw = static_cast<FCLSpace::FCLKinBodyInfo::FCLGeometryInfo *>(collgeom->getUserData());
+        // collision geometries are shared between cloned spaces, so the geometry info is found through the link of the collision object
+        FCLSpace::FCLKinBodyInfo::FCLGeometryInfo *geom_raw = nullptr;
+        const FCLSpace::FCLKinBodyInfo::LinkInfo *link_raw = static_cast<const FCLSpace::FCLKinBodyInfo::LinkInfo *>(collObj.getUserData());
+        if (!!link_raw)
+        {
+            for (size_t igeom = 0; igeom < link_raw->vgeominfos.size() && igeom < link_raw->vgeoms.size(); ++igeom)
+            {
+                if (link_raw->vgeoms[igeom].second.get() == &collObj)
+                {
+                    geom_raw = link_raw->vgeominfos[igeom].get();
+                    break;
+                }
+            }
+        }
         if (!!geom_raw)
         {
             const GeometryConstPtr pgeom = geom_raw->GetGeometry();
@@ -159,6 +159,12 @@ namespace fclrave
         /// e.g. "SetBVHRepresentation OBB"
         bool _SetBVHRepresentation(ostream &sout, istream &sinput);
 
+        /// Sets the geometry group whose meshes are converted to fcl::Convex, e.g. "SetConvexGeometryGroup convexdecomposition"
+        bool _SetConvexGeometryGroup(ostream &sout, istream &sinput);
+
+        /// Returns the number of mesh collision geometries reused from the checker this one was cloned from, e.g. "GetNumSharedGeometries"
+        bool _GetNumSharedGeometries(ostream &sout, istream &sinput);
+
         std::string const &GetBVHRepresentation() const
         {
             return _fclspace->GetBVHRepresentation();
@@ -2,6 +2,8 @@
 
 #include "fclspace.h"
 
+#include <cstring>
+
 namespace fclrave
 {
 
@@ -15,6 +17,78 @@ namespace fclrave
         return model;
     }
 
+#ifdef FCLRAVE_HAS_CONVEX
+    /// \brief converts a closed convex mesh to a fcl::Convex so that it is checked with GJK/EPA instead of traversing a BVH
+    CollisionGeometryPtr ConvertConvexMeshToFCL(std::vector<fcl::Vector3f> const &points, std::vector<fcl::Triangle> const &triangles)
+    {
+        std::shared_ptr<std::vector<int>> const faces = std::make_shared<std::vector<int>>();
+        faces->reserve(4 * triangles.size());
+        for (const fcl::Triangle &triangle : triangles)
+        {
+            faces->push_back(3);
+            faces->push_back(triangle[0]);
+            faces->push_back(triangle[1]);
+            faces->push_back(triangle[2]);
+        }
+        return std::make_shared<fcl::Convex<float>>(std::make_shared<const std::vector<fcl::Vector3f>>(points), (int)triangles.size(), faces);
+    }
+#endif
+
+    /// \brief collision object that does not write into its collision geometry
+    ///
+    /// The constructor of fcl::CollisionObject calls computeLocalAABB on the geometry. The geometry can be shared with the spaces
+    /// of cloned environments that check collisions at the same time, so the local AABB is computed once when the geometry is
+    /// created in FCLSpace::_GetOrCreateFCLGeom, and this object only reads it.
+    class SharedGeometryCollisionObject : public fcl::CollisionObject<float>
+    {
+    public:
+        SharedGeometryCollisionObject(const CollisionGeometryPtr &pgeom) : fcl::CollisionObject<float>(CollisionGeometryPtr())
+        {
+            cgeom = pgeom;
+            cgeom_const = pgeom;
+            computeAABB();
+        }
+    };
+
+    /// \brief hash of the data a mesh collision geometry is built from, 0 for the geometries that are cheap to build and not shared
+    static uint64_t ComputeGeometryHash(const KinBody::GeometryInfo &info, bool bConvex)
+    {
+        if (info._type != OpenRAVE::GT_TriMesh && info._type != OpenRAVE::GT_ConicalFrustum && info._type != OpenRAVE::GT_Axial)
+        {
+            return 0;
+        }
+        const OpenRAVE::TriMesh &mesh = info._meshcollision;
+        if (mesh.vertices.empty() || mesh.indices.empty())
+        {
+            return 0;
+        }
+        // FNV-1a on 32bit words, the vertices are hashed as the floats fcl stores
+        uint64_t hash = 14695981039346656037ull;
+        const auto combine = [&hash](uint32_t word)
+        {
+            hash = (hash ^ word) * 1099511628211ull;
+        };
+        combine((uint32_t)info._type);
+        combine((uint32_t)bConvex);
+        combine((uint32_t)mesh.vertices.size());
+        combine((uint32_t)mesh.indices.size());
+        for (const Vector &v : mesh.vertices)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                const float f = (float)v[i];
+                uint32_t word;
+                memcpy(&word, &f, sizeof(word));
+                combine(word);
+            }
+        }
+        for (int32_t index : mesh.indices)
+        {
+            combine((uint32_t)index);
+        }
+        return hash != 0 ? hash : 1;
+    }
+
     void FCLSpace::FCLKinBodyInfo::Reset()
     {
         FOREACH(itlink, vlinks)
@@ -46,7 +120,7 @@ namespace fclrave
     FCLSpace::FCLSpace(EnvironmentBasePtr penv, const std::string &userdatakey)
         : _penv(penv), _userdatakey(userdatakey), _currentpinfo(1, FCLKinBodyInfoPtr()) // initialize with one null pointer, this is a place holder for null pointer so that we can return by reference. env id 0 means invalid so it's consistent with the definition as well
           ,
-          _bIsSelfCollisionChecker(true)
+          _nSharedGeometries(0), _bIsSelfCollisionChecker(true)
     {
         // After many test, OBB seems to be the only real option (followed by kIOS which is needed for distance checking)
         SetBVHRepresentation("OBB");
@@ -72,6 +146,62 @@ namespace fclrave
         _currentpinfo.erase(_currentpinfo.begin() + 1, _currentpinfo.end());
         _cachedpinfo.clear();
         _vecInitializedBodies.clear();
+        _mapSeedGeometries.clear();
+    }
+
+    void FCLSpace::SeedFromSpace(const FCLSpace &r)
+    {
+        _mapSeedGeometries.clear();
+        if (r._bvhRepresentation != _bvhRepresentation || r._convexGeometryGroup != _convexGeometryGroup)
+        {
+            return;
+        }
+
+        const auto addinfo = [this](int bodyIndex, const FCLKinBodyInfoPtr &pinfo)
+        {
+            if (!pinfo || pinfo->vlinks.empty())
+            {
+                return;
+            }
+            KinBodyPtr pbody = pinfo->GetBody();
+            if (!pbody)
+            {
+                return;
+            }
+            SeedBodyGeometries seed;
+            seed.bodyname = pbody->GetName();
+            seed.vlinkgeometries.resize(pinfo->vlinks.size());
+            bool bHasGeometries = false;
+            for (size_t ilink = 0; ilink < pinfo->vlinks.size(); ++ilink)
+            {
+                const FCLKinBodyInfo::LinkInfo &linkinfo = *pinfo->vlinks[ilink];
+                for (size_t igeom = 0; igeom < linkinfo.vgeomhashes.size() && igeom < linkinfo.vgeoms.size(); ++igeom)
+                {
+                    if (linkinfo.vgeomhashes[igeom] != 0)
+                    {
+                        seed.vlinkgeometries[ilink].emplace_back(linkinfo.vgeomhashes[igeom], linkinfo.vgeoms[igeom].second->collisionGeometry());
+                        bHasGeometries = true;
+                    }
+                }
+            }
+            if (bHasGeometries)
+            {
+                _mapSeedGeometries[std::make_pair(bodyIndex, pinfo->_geometrygroup)] = std::move(seed);
+            }
+        };
+
+        for (int bodyIndex = 1; bodyIndex < (int)r._currentpinfo.size(); ++bodyIndex)
+        {
+            addinfo(bodyIndex, r._currentpinfo[bodyIndex]);
+        }
+        for (int bodyIndex = 1; bodyIndex < (int)r._cachedpinfo.size(); ++bodyIndex)
+        {
+            for (const std::pair<const std::string, FCLKinBodyInfoPtr> &cached : r._cachedpinfo[bodyIndex])
+            {
+                addinfo(bodyIndex, cached.second);
+            }
+        }
+        RAVELOG_VERBOSE_FORMAT("env=%s, seeded %d body geometries from env %d (userdatakey %s)", _penv->GetNameId() % _mapSeedGeometries.size() % r._penv->GetId() % _userdatakey);
     }
 
     void FCLSpace::ReloadKinBodyLinks(KinBodyConstPtr pbody, FCLKinBodyInfoPtr pinfo)
@@ -85,9 +215,19 @@ namespace fclrave
 
         pinfo->vlinks.clear();
         pinfo->vlinks.reserve(pbody->GetLinks().size());
+
+        // geometries of the body this one was cloned from
+        std::map<std::pair<int, std::string>, SeedBodyGeometries>::iterator itseed = _mapSeedGeometries.find(std::make_pair(pbody->GetEnvironmentBodyIndex(), pinfo->_geometrygroup));
+        const SeedBodyGeometries *pseed = nullptr;
+        if (itseed != _mapSeedGeometries.end() && itseed->second.bodyname == pbody->GetName() && itseed->second.vlinkgeometries.size() == pbody->GetLinks().size())
+        {
+            pseed = &itseed->second;
+        }
+
         FOREACHC(itlink, pbody->GetLinks())
         {
             const KinBody::LinkPtr &plink = *itlink;
+            const std::vector<std::pair<uint64_t, CollisionGeometryPtr>> *pseedgeometries = !!pseed ? &pseed->vlinkgeometries[itlink - pbody->GetLinks().begin()] : nullptr;
             boost::shared_ptr<FCLKinBodyInfo::LinkInfo> linkinfo(new FCLKinBodyInfo::LinkInfo(plink));
 
             fcl::AABB<float> enclosingBV;
@@ -95,6 +235,8 @@ namespace fclrave
             // Glue code for a unified access to geometries
             if (pinfo->_geometrygroup.size() > 0 && plink->GetGroupNumGeometries(pinfo->_geometrygroup) >= 0)
             {
+                // the meshes of the convex geometry group are convex pieces, so they can skip the BVH
+                const bool bConvexGroup = pinfo->_geometrygroup == _convexGeometryGroup;
                 const std::vector<KinBody::GeometryInfoPtr> &vgeometryinfos = plink->GetGeometriesFromGroup(pinfo->_geometrygroup);
                 FOREACH(itgeominfo, vgeometryinfos)
                 {
@@ -105,23 +247,24 @@ namespace fclrave
                         throw OpenRAVE::OpenRAVEException(str(boost::format("Failed to access geometry info %d for link %s:%s with geometrygroup %s") % igeominfo % plink->GetParent()->GetName() % plink->GetName() % pinfo->_geometrygroup), OpenRAVE::ORE_InvalidState);
                     }
                     const KinBody::GeometryInfo &geominfo = *pgeominfo;
-                    const CollisionGeometryPtr pfclgeom = _CreateFCLGeomFromGeometryInfo(geominfo);
+                    const uint64_t geomhash = ComputeGeometryHash(geominfo, bConvexGroup);
+                    const CollisionGeometryPtr pfclgeom = _GetOrCreateFCLGeom(geominfo, bConvexGroup, geomhash, pseedgeometries);
 
                     if (!pfclgeom)
                     {
                         continue;
                     }
-                    // because user data is null pointer here, in CheckNarrowPhaseGeomCollision report.pgeom ends up being null pointer and we lose the geometry information.
+                    // because vgeominfos is empty here, in CheckNarrowPhaseGeomCollision report.pgeom ends up being null pointer and we lose the geometry information.
                     // maybe pass plink->GetGeometries()[index] where index=distance(vgeometryinfos.begin(), itgeominfo)?
                     // or, should the collision report store names of body, link, and geom?
                     // also, currently there is no information about which geometry group was used for collision checking.
                     // It's usually obvious immediately after CheckCollision is called, but later on, it it is not that obvious collision report is computed with which geometry group.
-                    pfclgeom->setUserData(nullptr);
 
                     // We do not set the transformation here and leave it to _Synchronize
-                    CollisionObjectPtr pfclcoll = boost::make_shared<fcl::CollisionObject<float>>(pfclgeom);
+                    CollisionObjectPtr pfclcoll = boost::make_shared<SharedGeometryCollisionObject>(pfclgeom);
                     pfclcoll->setUserData(linkinfo.get());
                     linkinfo->vgeoms.push_back(TransformCollisionPair(geominfo.GetTransform(), pfclcoll));
+                    linkinfo->vgeomhashes.push_back(geomhash);
 
                     KinBody::Link::Geometry _tmpgeometry(boost::shared_ptr<KinBody::Link>(), geominfo);
                     if (itgeominfo == vgeometryinfos.begin())
@@ -141,23 +284,25 @@ namespace fclrave
                 {
                     const KinBody::GeometryPtr &pgeom = *itgeom;
                     const KinBody::GeometryInfo &geominfo = pgeom->GetInfo();
-                    const CollisionGeometryPtr pfclgeom = _CreateFCLGeomFromGeometryInfo(geominfo);
+                    const uint64_t geomhash = ComputeGeometryHash(geominfo, false);
+                    const CollisionGeometryPtr pfclgeom = _GetOrCreateFCLGeom(geominfo, false, geomhash, pseedgeometries);
 
                     if (!pfclgeom)
                     {
                         continue;
                     }
+                    // the collision geometry can be shared with cloned spaces, so the geometry info is found from the index of the collision object in vgeoms instead of the user data of the collision geometry
                     boost::shared_ptr<FCLKinBodyInfo::FCLGeometryInfo> pfclgeominfo(new FCLKinBodyInfo::FCLGeometryInfo(pgeom));
                     pfclgeominfo->bodylinkgeomname = pbody->GetName() + "/" + plink->GetName() + "/" + pgeom->GetName();
-                    pfclgeom->setUserData(pfclgeominfo.get());
                     // save the pointers
                     linkinfo->vgeominfos.push_back(pfclgeominfo);
 
                     // We do not set the transformation here and leave it to _Synchronize
-                    CollisionObjectPtr pfclcoll = boost::make_shared<fcl::CollisionObject<float>>(pfclgeom);
+                    CollisionObjectPtr pfclcoll = boost::make_shared<SharedGeometryCollisionObject>(pfclgeom);
                     pfclcoll->setUserData(linkinfo.get());
 
                     linkinfo->vgeoms.push_back(TransformCollisionPair(geominfo.GetTransform(), pfclcoll));
+                    linkinfo->vgeomhashes.push_back(geomhash);
 
                     KinBody::Link::Geometry _tmpgeometry(boost::shared_ptr<KinBody::Link>(), geominfo);
                     if (itgeom == vgeometries.begin())
@@ -192,6 +337,34 @@ namespace fclrave
             RAVELOG_DEBUG_FORMAT("FCLSPACECOLLISIONOBJECT|%s|%s", linkinfo->linkBV.second.get() % linkinfo->bodylinkname);
 #endif
         }
+
+        if (itseed != _mapSeedGeometries.end())
+        {
+            // the seed is only valid for the first initialization, afterwards the geometries are tracked by the callbacks
+            _mapSeedGeometries.erase(itseed);
+        }
+    }
+
+    CollisionGeometryPtr FCLSpace::_GetOrCreateFCLGeom(const KinBody::GeometryInfo &info, bool bConvex, uint64_t hash, const std::vector<std::pair<uint64_t, CollisionGeometryPtr>> *pseedgeometries)
+    {
+        if (hash != 0 && !!pseedgeometries)
+        {
+            for (const std::pair<uint64_t, CollisionGeometryPtr> &seedgeometry : *pseedgeometries)
+            {
+                if (seedgeometry.first == hash)
+                {
+                    ++_nSharedGeometries;
+                    return seedgeometry.second;
+                }
+            }
+        }
+        const CollisionGeometryPtr pfclgeom = _CreateFCLGeomFromGeometryInfo(info, bConvex);
+        if (!!pfclgeom)
+        {
+            // the only write into the geometry, see SharedGeometryCollisionObject
+            pfclgeom->computeLocalAABB();
+        }
+        return pfclgeom;
     }
 
     FCLSpace::FCLKinBodyInfoPtr FCLSpace::InitKinBody(KinBodyConstPtr pbody, FCLKinBodyInfoPtr pinfo, bool bSetToCurrentPInfo)
@@ -390,7 +563,7 @@ namespace fclrave
         }
 
         // reinitialize all the FCLKinBodyInfo
-
+        _mapSeedGeometries.clear();
         for (const KinBodyConstPtr &pbody : _vecInitializedBodies)
         {
             if (!pbody)
@@ -409,6 +582,40 @@ namespace fclrave
         return _bvhRepresentation;
     }
 
+    void FCLSpace::SetConvexGeometryGroup(const std::string &groupname)
+    {
+        if (groupname == _convexGeometryGroup)
+        {
+            return;
+        }
+#ifndef FCLRAVE_HAS_CONVEX
+        if (groupname.size() > 0)
+        {
+            RAVELOG_WARN_FORMAT("env=%s, fcl was compiled without fcl::Convex support, meshes of geometry group '%s' will use the %s BVH", _penv->GetNameId() % groupname % _bvhRepresentation);
+        }
+#endif
+        _convexGeometryGroup = groupname;
+
+        // reinitialize the bodies that might be using the group
+        _mapSeedGeometries.clear();
+        for (const KinBodyConstPtr &pbody : _vecInitializedBodies)
+        {
+            if (!pbody)
+            {
+                continue;
+            }
+            FCLKinBodyInfoPtr &pinfo = GetInfo(*pbody);
+            pinfo->nGeometryUpdateStamp++;
+            InitKinBody(pbody, pinfo);
+        }
+        _cachedpinfo.clear();
+    }
+
+    const std::string &FCLSpace::GetConvexGeometryGroup() const
+    {
+        return _convexGeometryGroup;
+    }
+
     void FCLSpace::Synchronize()
     {
         // We synchronize only the initialized bodies, which differs from oderave
@@ -546,7 +753,7 @@ namespace fclrave
         contents.emplace_back(std::make_shared<fcl::CollisionObject<float>>(fclGeom, fclTrans));
     }
 
-    CollisionGeometryPtr FCLSpace::_CreateFCLGeomFromGeometryInfo(const KinBody::GeometryInfo &info)
+    CollisionGeometryPtr FCLSpace::_CreateFCLGeomFromGeometryInfo(const KinBody::GeometryInfo &info, bool bConvex)
     {
         switch (info._type)
         {
@@ -661,6 +868,12 @@ namespace fclrave
                 fcl_triangles[itri] = fcl::Triangle(tri_indices[0], tri_indices[1], tri_indices[2]);
             }
 
+#ifdef FCLRAVE_HAS_CONVEX
+            if (bConvex && info._type == OpenRAVE::GT_TriMesh)
+            {
+                return ConvertConvexMeshToFCL(fcl_points, fcl_triangles);
+            }
+#endif
             return _meshFactory(fcl_points, fcl_triangles);
         }
 
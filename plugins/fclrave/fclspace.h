@@ -135,6 +135,7 @@ namespace fclrave
 
                     // make sure to clear vgeominfos after vgeoms because the CollisionObject inside each vgeom element has a corresponding vgeominfo as a void pointer.
                     vgeominfos.resize(0);
+                    vgeomhashes.resize(0);
                 }
 
                 inline KinBody::LinkPtr GetLink() const
@@ -143,11 +144,12 @@ namespace fclrave
                 }
 
                 KinBody::LinkWeakPtr _plink;
-                vector<boost::shared_ptr<FCLGeometryInfo>> vgeominfos; ///< info for every geometry of the link
+                vector<boost::shared_ptr<FCLGeometryInfo>> vgeominfos; ///< info for every geometry of the link, same order as vgeoms. Empty if the link uses a geometry group.
 
                 // int nLastStamp; ///< Tracks if the collision geometries are up to date wrt the body update stamp. This is for narrow phase collision
                 TranslationCollisionPair linkBV;            ///< pair of the translation and collision object corresponding to a bounding OBB for the link
                 std::vector<TransformCollisionPair> vgeoms; ///< vector of transformations and collision object; one per geometries
+                std::vector<uint64_t> vgeomhashes;          ///< same order as vgeoms, hash of the mesh of the collision geometry used to share it with cloned spaces. 0 if the geometry is not shared.
                 std::string bodylinkname;                   // for debugging purposes
                 bool bFromKinBodyLink;                      ///< if true, then from kinbodylink. Otherwise from standalone object that does not have any KinBody associations
             };
@@ -204,6 +206,20 @@ namespace fclrave
         void DestroyEnvironment();
 
         FCLKinBodyInfoPtr InitKinBody(KinBodyConstPtr pbody, FCLKinBodyInfoPtr pinfo = FCLKinBodyInfoPtr(), bool bSetToCurrentPInfo = true);
+
+        /// \brief keeps the mesh collision geometries of the bodies initialized in r so that the bodies cloned from them reuse them
+        ///
+        /// The fcl collision geometries are immutable once built, so the BVHs are shared between the spaces instead of being rebuilt.
+        /// A geometry is only reused if its mesh hashes to the same value. The kept geometries are released once their body is initialized.
+        /// Has to be called while r's environment is locked, usually from FCLCollisionChecker::Clone.
+        /// The shared geometries are never written to after they are created, so both environments can check collisions concurrently.
+        void SeedFromSpace(const FCLSpace &r);
+
+        /// \brief number of collision geometries reused from the seeded space since this space was created
+        size_t GetNumSharedGeometries() const
+        {
+            return _nSharedGeometries;
+        }
         void ReloadKinBodyLinks(KinBodyConstPtr pbody, FCLKinBodyInfoPtr pinfo);
 
         bool HasNamedGeometry(const KinBody &body, const std::string &groupname);
@@ -221,6 +237,14 @@ namespace fclrave
 
         std::string const &GetBVHRepresentation() const;
 
+        /// \brief sets the geometry group whose meshes are all convex, like the one created by the ConvexDecomposition module
+        ///
+        /// Meshes of that group are checked with fcl::Convex (GJK/EPA) instead of a BVH. Reinitializes all the KinbodyInfo if needed.
+        /// \param groupname if empty, all meshes use the BVH representation
+        void SetConvexGeometryGroup(const std::string &groupname);
+
+        const std::string &GetConvexGeometryGroup() const;
+
         void Synchronize();
 
         void Synchronize(const KinBody &body);
@@ -290,7 +314,13 @@ namespace fclrave
 
     private:
         // what about the tests on non-zero size (eg. box extents) ?
-        CollisionGeometryPtr _CreateFCLGeomFromGeometryInfo(const KinBody::GeometryInfo &info);
+        /// \param bConvex if true, the info is a convex piece and its mesh is converted to fcl::Convex instead of a BVH
+        CollisionGeometryPtr _CreateFCLGeomFromGeometryInfo(const KinBody::GeometryInfo &info, bool bConvex = false);
+
+        /// \brief returns the geometry of the seed that has hash, or creates a new one from info and computes its local AABB
+        ///
+        /// \param pseedgeometries the geometries of the seed link, can be null
+        CollisionGeometryPtr _GetOrCreateFCLGeom(const KinBody::GeometryInfo &info, bool bConvex, uint64_t hash, const std::vector<std::pair<uint64_t, CollisionGeometryPtr>> *pseedgeometries);
 
         /// \brief pass in info.GetBody() as a reference to avoid dereferencing the weak pointer in FCLKinBodyInfo
         void _Synchronize(FCLKinBodyInfo &info, const KinBody &body);
@@ -358,11 +388,21 @@ namespace fclrave
 
         std::string _bvhRepresentation;
         MeshFactory _meshFactory;
+        std::string _convexGeometryGroup; ///< name of the geometry group whose meshes are converted to fcl::Convex. If empty, all meshes use _meshFactory.
 
         std::vector<KinBodyConstPtr> _vecInitializedBodies;                 ///< vector of the kinbody initialized in this space. index is the environment body index. nullptr means uninitialized.
         std::vector<std::map<std::string, FCLKinBodyInfoPtr>> _cachedpinfo; ///< Associates to each body id and geometry group name the corresponding kinbody info if already initialized and not currently set as user data. Index of vector is the environment id. index 0 holds null pointer because kin bodies in the env should have positive index.
         std::vector<FCLKinBodyInfoPtr> _currentpinfo;                       ///< maps kinbody environment id to the kinbodyinfo struct constaining fcl objects. Index of the vector is the environment id (id of the body in the env, not __nUniqueId of env) of the kinbody at that index. The index being environment id makes it easier to compare objects without getting a handle to their pointers. Whenever a FCLKinBodyInfoPtr goes into this map, it is removed from _cachedpinfo. Index of vector is the environment id. index 0 holds null pointer because kin bodies in the env should have positive index.
 
+        /// \brief collision geometries of the space this space was cloned from, see SeedFromSpace
+        struct SeedBodyGeometries
+        {
+            std::string bodyname;
+            std::vector<std::vector<std::pair<uint64_t, CollisionGeometryPtr>>> vlinkgeometries; ///< for every link, the hashes and collision geometries of its meshes
+        };
+        std::map<std::pair<int, std::string>, SeedBodyGeometries> _mapSeedGeometries; ///< key is the environment body index and the geometry group name
+        size_t _nSharedGeometries; ///< see GetNumSharedGeometries
+
         std::vector<int> _vecAttachedEnvBodyIndicesCache; ///< cache
         std::vector<KinBodyPtr> _vecAttachedBodiesCache;  ///< cache
 
@@ -14,6 +14,7 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "plugindefs.h"
+#include "wrenchspace.h"
 
 #include <algorithm>
 #include <condition_variable>
@@ -155,6 +156,7 @@ public:
         bool bComputeStableContacts = false;
         bool bComputeForceClosure = false;
         bool bOutputFinal = false;
+        bool bUseWrenchSpace = false;
         dReal friction = 0;
 
         GraspParametersPtr params(new GraspParameters(GetEnv()));
@@ -271,6 +273,11 @@ public:
                 // initialization
                 sinput >> bComputeForceClosure;
             }
+            else if( cmd == "forceclosuremethod" ) {
+                string method;
+                sinput >> method;
+                bUseWrenchSpace = _ParseForceClosureMethod(method);
+            }
             else if( cmd == "collision" ) {
                 // initialiation
                 string name; sinput >> name;
@@ -414,7 +421,7 @@ public:
                 for(size_t i = 0; i < c.size(); ++i) {
                     c[i] = contacts[i].first;
                 }
-                analysis = _AnalyzeContacts3D(c,friction,8);
+                analysis = _AnalyzeContacts3D(c,friction,8,bUseWrenchSpace ? &_wrenchevaluator : NULL);
             }
             catch(const std::exception& ex) {
                 RAVELOG_WARN("AnalyzeContacts3D: %s\n",ex.what());
@@ -675,6 +682,7 @@ public:
             ftranslationstepmult = 0.1;
             nGraspingNoiseRetries = 0;
             forceclosurethreshold = 0;
+            bUseWrenchSpace = false;
             ffinestep = 0.001f;
             bCheckGraspIK = false;
         }
@@ -687,6 +695,7 @@ public:
         dReal fgraspingnoise;
         bool bComputeForceClosure;
         dReal forceclosurethreshold;
+        bool bUseWrenchSpace; ///< if true, use WrenchSpaceEvaluator instead of a full qhull convex hull for force closure. The volume is then only a lower bound of the hull volume
         dReal friction;
         string collisionchecker;
         dReal ftranslationstepmult;
@@ -771,6 +780,11 @@ public:
             else if( cmd == "forceclosure" ) {
                 sinput >> worker_params->bComputeForceClosure >> worker_params->forceclosurethreshold;
             }
+            else if( cmd == "forceclosuremethod" ) {
+                string method;
+                sinput >> method;
+                worker_params->bUseWrenchSpace = _ParseForceClosureMethod(method);
+            }
             else if( cmd == "collisionchecker" ) {
                 sinput >> worker_params->collisionchecker;
             }
@@ -931,6 +945,7 @@ public:
             PlannerBasePtr planner = RaveCreatePlanner(pcloneenv,"Grasper");
             RobotBasePtr probot = pcloneenv->GetRobot(_robot->GetName());
             string strsavetraj;
+            WrenchSpaceEvaluator wrenchevaluator;
 
             probot->SetActiveManipulator(worker_params->manipname);
 
@@ -1064,7 +1079,7 @@ public:
                         for(size_t i = 0; i < c.size(); ++i) {
                             c[i] = grasp_params->contacts[i].first;
                         }
-                        analysis = _AnalyzeContacts3D(c,worker_params->friction,8);
+                        analysis = _AnalyzeContacts3D(c,worker_params->friction,8,worker_params->bUseWrenchSpace ? &wrenchevaluator : NULL, worker_params->forceclosurethreshold);
                         if( analysis.mindist < worker_params->forceclosurethreshold ) {
                             RAVELOG_DEBUG(str(boost::format("grasp %d: force closure failed")%grasp_params->id));
                             continue;
@@ -1591,10 +1606,26 @@ protected:
         }
     }
 
-    virtual GRASPANALYSIS _AnalyzeContacts3D(const vector<CONTACT>& contacts, dReal mu, int Nconepoints)
+    /// \brief returns true if method is "wrenchspace", false if "qhull"
+    static bool _ParseForceClosureMethod(const std::string& method)
+    {
+        if( method == "wrenchspace" ) {
+            return true;
+        }
+        else if( method == "qhull" ) {
+            return false;
+        }
+        throw OPENRAVE_EXCEPTION_FORMAT("unknown force closure method '%s', supported methods are wrenchspace and qhull", method, ORE_InvalidArguments);
+    }
+
+    /// \brief analyzes the force closure of the contacts by discretizing each friction cone into Nconepoints wrenches
+    ///
+    /// \param pevaluator if not NULL, used to compute the quality without building the full convex hull. The returned volume is then only a lower bound of the hull volume.
+    /// \param fThreshold if > 0 and pevaluator is set, the evaluation can stop early once the quality is known to be below fThreshold
+    virtual GRASPANALYSIS _AnalyzeContacts3D(const vector<CONTACT>& contacts, dReal mu, int Nconepoints, WrenchSpaceEvaluator* pevaluator=NULL, dReal fThreshold=0)
     {
         if( mu == 0 ) {
-            return _AnalyzeContacts3D(contacts);
+            return _AnalyzeContacts3D(contacts, pevaluator, fThreshold);
         }
 
         if( contacts.size() > 16 ) {
@@ -1604,7 +1635,8 @@ protected:
             for(size_t i = 0; i < reducedcontacts.capacity(); ++i) {
                 reducedcontacts.push_back( contacts.at((i*contacts.size())/reducedcontacts.capacity()) );
             }
-            GRASPANALYSIS analysis = _AnalyzeContacts3D(reducedcontacts, mu, Nconepoints);
+            // no threshold since the quality of a subset is only a lower bound of the quality of all the contacts
+            GRASPANALYSIS analysis = _AnalyzeContacts3D(reducedcontacts, mu, Nconepoints, pevaluator);
             if( analysis.mindist > 1e-9 ) {
                 return analysis;
             }
@@ -1630,10 +1662,10 @@ protected:
                 newcontacts.push_back(CONTACT(itcontact->pos, (itcontact->norm + mu*it->first*right + mu*it->second*up).normalize3(),0));
             }
         }
-        return _AnalyzeContacts3D(newcontacts);
+        return _AnalyzeContacts3D(newcontacts, pevaluator, fThreshold);
     }
 
-    virtual GRASPANALYSIS _AnalyzeContacts3D(const vector<CONTACT>& contacts)
+    virtual GRASPANALYSIS _AnalyzeContacts3D(const vector<CONTACT>& contacts, WrenchSpaceEvaluator* pevaluator=NULL, dReal fThreshold=0)
     {
         if( contacts.size() < 7 ) {
             RAVELOG_DEBUG("need at least 7 contact wrenches to have force closure in 3D\n");
@@ -1653,6 +1685,16 @@ protected:
             *itpoint++ = v.z;
         }
 
+        if( !!pevaluator ) {
+            double mindist = 0, volume = 0;
+            if( pevaluator->Evaluate(vpoints, fThreshold, mindist, volume) ) {
+                analysis.mindist = mindist;
+                analysis.volume = volume;
+                return analysis;
+            }
+            RAVELOG_DEBUG("wrench space evaluation is degenerate, falling back to convex hull\n");
+        }
+
         analysis.volume = _ComputeConvexHull(vpoints,vconvexplanes,boost::shared_ptr< vector<int> >(),6);
         if( vconvexplanes.size() == 0 ) {
             return analysis;
@@ -1815,6 +1857,7 @@ protected:
     PlannerBasePtr _planner;
     RobotBasePtr _robot;
     CollisionReportPtr _report;
+    WrenchSpaceEvaluator _wrenchevaluator; ///< used by the Grasp command, GraspThreaded workers have their own
     std::mutex _mutex;
     FILE *outfile;
     FILE *errfile;
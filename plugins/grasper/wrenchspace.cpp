@@ -0,0 +1,451 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "wrenchspace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+WrenchSpaceEvaluator::WrenchSpaceEvaluator() : _pwrenches(NULL), _numpoints(0), _fEpsilon(0), _visitid(0)
+{
+    std::fill(_vinterior, _vinterior+s_dim, 0.0);
+}
+
+bool WrenchSpaceEvaluator::Evaluate(const std::vector<double>& vwrenches, double fThreshold, double& mindist, double& volume)
+{
+    mindist = 0;
+    volume = 0;
+    _pwrenches = vwrenches.empty() ? NULL : &vwrenches[0];
+    _numpoints = (int)vwrenches.size()/s_dim;
+    _vfacets.resize(0);
+    _vheap.resize(0);
+    if( _numpoints <= s_dim ) {
+        return true; // need at least s_dim+1 wrenches to enclose the origin
+    }
+
+    double fscale = 0;
+    for(size_t i = 0; i < vwrenches.size(); ++i) {
+        fscale = std::max(fscale, std::fabs(vwrenches[i]));
+    }
+    if( fscale <= 0 ) {
+        return true;
+    }
+    _fEpsilon = 1e-10*fscale;
+
+    int initret = _InitSimplex();
+    if( initret <= 0 ) {
+        return initret == 0; // wrenches not spanning the space cannot have the origin in their interior
+    }
+
+    double fupperbound = std::numeric_limits<double>::infinity();
+    // every iteration adds a wrench that is outside the polytope, so there cannot be more iterations than wrenches
+    for(int iter = 0; iter <= _numpoints && !_vheap.empty(); ++iter) {
+        std::pop_heap(_vheap.begin(), _vheap.end(), std::greater< std::pair<double, int> >());
+        int ifacet = _vheap.back().second;
+        _vheap.pop_back();
+        if( !_vfacets[ifacet].bvalid ) {
+            --iter;
+            continue;
+        }
+
+        // support wrench along the facet normal
+        const WrenchFacet& facet = _vfacets[ifacet];
+        int isupport = -1;
+        double fsupport = -std::numeric_limits<double>::infinity();
+        for(int ipoint = 0; ipoint < _numpoints; ++ipoint) {
+            const double* ppoint = _GetPoint(ipoint);
+            double f = 0;
+            for(int i = 0; i < s_dim; ++i) {
+                f += facet.normal[i]*ppoint[i];
+            }
+            if( f > fsupport ) {
+                fsupport = f;
+                isupport = ipoint;
+            }
+        }
+
+        if( facet.offset < -_fEpsilon ) {
+            // origin is outside of the polytope
+            if( fsupport <= _fEpsilon ) {
+                // the facet normal separates the origin from all the wrenches
+                volume = _ComputeVolume();
+                return true;
+            }
+        }
+        else {
+            // facet is the closest to the origin, so its offset is a lower bound of the quality and fsupport an upper bound
+            fupperbound = std::min(fupperbound, fsupport);
+            if( fsupport - facet.offset <= _fEpsilon || fupperbound - facet.offset <= _fEpsilon ) {
+                mindist = facet.offset > _fEpsilon ? facet.offset : 0;
+                volume = _ComputeVolume();
+                return true;
+            }
+            if( fThreshold > 0 && fupperbound < fThreshold ) {
+                mindist = fupperbound > _fEpsilon ? fupperbound : 0;
+                volume = _ComputeVolume();
+                return true;
+            }
+        }
+
+        if( !_AddPoint(isupport, ifacet) ) {
+            return false;
+        }
+    }
+    return false;
+}
+
+int WrenchSpaceEvaluator::_InitSimplex()
+{
+    // greedily pick the wrenches that are farthest from the affine span of the previously picked ones
+    int vsimplex[s_dim+1];
+    double vcentroid[s_dim] = {0};
+    for(int ipoint = 0; ipoint < _numpoints; ++ipoint) {
+        for(int i = 0; i < s_dim; ++i) {
+            vcentroid[i] += _GetPoint(ipoint)[i];
+        }
+    }
+    for(int i = 0; i < s_dim; ++i) {
+        vcentroid[i] /= _numpoints;
+    }
+
+    double fmaxdist2 = -1;
+    for(int ipoint = 0; ipoint < _numpoints; ++ipoint) {
+        double fdist2 = 0;
+        for(int i = 0; i < s_dim; ++i) {
+            double f = _GetPoint(ipoint)[i] - vcentroid[i];
+            fdist2 += f*f;
+        }
+        if( fdist2 > fmaxdist2 ) {
+            fmaxdist2 = fdist2;
+            vsimplex[0] = ipoint;
+        }
+    }
+
+    const double* porigin = _GetPoint(vsimplex[0]);
+    _vbasis.resize(s_dim*s_dim);
+    double vresidual[s_dim];
+    for(int ibasis = 0; ibasis < s_dim; ++ibasis) {
+        double fbestdist2 = 0;
+        int ibest = -1;
+        for(int ipoint = 0; ipoint < _numpoints; ++ipoint) {
+            const double* ppoint = _GetPoint(ipoint);
+            for(int i = 0; i < s_dim; ++i) {
+                vresidual[i] = ppoint[i] - porigin[i];
+            }
+            for(int iprev = 0; iprev < ibasis; ++iprev) {
+                const double* pbasis = &_vbasis[s_dim*iprev];
+                double fdot = 0;
+                for(int i = 0; i < s_dim; ++i) {
+                    fdot += vresidual[i]*pbasis[i];
+                }
+                for(int i = 0; i < s_dim; ++i) {
+                    vresidual[i] -= fdot*pbasis[i];
+                }
+            }
+            double fdist2 = 0;
+            for(int i = 0; i < s_dim; ++i) {
+                fdist2 += vresidual[i]*vresidual[i];
+            }
+            if( fdist2 > fbestdist2 ) {
+                fbestdist2 = fdist2;
+                ibest = ipoint;
+            }
+        }
+        if( ibest < 0 || fbestdist2 <= _fEpsilon*_fEpsilon ) {
+            return 0;
+        }
+        vsimplex[ibasis+1] = ibest;
+
+        // orthonormalize the new direction (twice for numerical stability)
+        double* pnewbasis = &_vbasis[s_dim*ibasis];
+        const double* pbest = _GetPoint(ibest);
+        for(int i = 0; i < s_dim; ++i) {
+            pnewbasis[i] = pbest[i] - porigin[i];
+        }
+        for(int ipass = 0; ipass < 2; ++ipass) {
+            for(int iprev = 0; iprev < ibasis; ++iprev) {
+                const double* pbasis = &_vbasis[s_dim*iprev];
+                double fdot = 0;
+                for(int i = 0; i < s_dim; ++i) {
+                    fdot += pnewbasis[i]*pbasis[i];
+                }
+                for(int i = 0; i < s_dim; ++i) {
+                    pnewbasis[i] -= fdot*pbasis[i];
+                }
+            }
+        }
+        double fnorm = 0;
+        for(int i = 0; i < s_dim; ++i) {
+            fnorm += pnewbasis[i]*pnewbasis[i];
+        }
+        fnorm = 1/std::sqrt(fnorm);
+        for(int i = 0; i < s_dim; ++i) {
+            pnewbasis[i] *= fnorm;
+        }
+    }
+
+    std::fill(_vinterior, _vinterior+s_dim, 0.0);
+    for(int ivertex = 0; ivertex <= s_dim; ++ivertex) {
+        for(int i = 0; i < s_dim; ++i) {
+            _vinterior[i] += _GetPoint(vsimplex[ivertex])[i]/(s_dim+1);
+        }
+    }
+
+    // facet i holds all the simplex vertices except i, so the neighbor opposite to vertex j is facet j
+    _vfacets.resize(s_dim+1);
+    for(int ifacet = 0; ifacet <= s_dim; ++ifacet) {
+        WrenchFacet& facet = _vfacets[ifacet];
+        int index = 0;
+        for(int ivertex = 0; ivertex <= s_dim; ++ivertex) {
+            if( ivertex != ifacet ) {
+                facet.vertices[index] = vsimplex[ivertex];
+                facet.neighbors[index] = ivertex;
+                ++index;
+            }
+        }
+        facet.visitid = 0;
+        facet.bvisible = false;
+        facet.bvalid = true;
+        if( !_ComputeFacetPlane(facet) ) {
+            return -1;
+        }
+        _vheap.push_back(std::make_pair(facet.offset, ifacet));
+        std::push_heap(_vheap.begin(), _vheap.end(), std::greater< std::pair<double, int> >());
+    }
+    _visitid = 0;
+    return 1;
+}
+
+bool WrenchSpaceEvaluator::_ComputeFacetPlane(WrenchFacet& facet)
+{
+    // the normal is the null space of the s_dim-1 edge vectors, solve with gaussian elimination using full pivoting
+    double A[s_dim-1][s_dim];
+    const double* pfirst = _GetPoint(facet.vertices[0]);
+    for(int irow = 0; irow < s_dim-1; ++irow) {
+        const double* ppoint = _GetPoint(facet.vertices[irow+1]);
+        for(int i = 0; i < s_dim; ++i) {
+            A[irow][i] = ppoint[i] - pfirst[i];
+        }
+    }
+
+    int vcolumns[s_dim];
+    for(int i = 0; i < s_dim; ++i) {
+        vcolumns[i] = i;
+    }
+    for(int irow = 0; irow < s_dim-1; ++irow) {
+        int ipivotrow = irow, ipivotcol = irow;
+        double fpivot = 0;
+        for(int i = irow; i < s_dim-1; ++i) {
+            for(int j = irow; j < s_dim; ++j) {
+                if( std::fabs(A[i][vcolumns[j]]) > fpivot ) {
+                    fpivot = std::fabs(A[i][vcolumns[j]]);
+                    ipivotrow = i;
+                    ipivotcol = j;
+                }
+            }
+        }
+        if( fpivot <= 1e-6*_fEpsilon ) {
+            return false;
+        }
+        if( ipivotrow != irow ) {
+            for(int j = 0; j < s_dim; ++j) {
+                std::swap(A[irow][j], A[ipivotrow][j]);
+            }
+        }
+        std::swap(vcolumns[irow], vcolumns[ipivotcol]);
+        double finvpivot = 1/A[irow][vcolumns[irow]];
+        for(int i = irow+1; i < s_dim-1; ++i) {
+            double fmult = A[i][vcolumns[irow]]*finvpivot;
+            if( fmult != 0 ) {
+                for(int j = irow; j < s_dim; ++j) {
+                    A[i][vcolumns[j]] -= fmult*A[irow][vcolumns[j]];
+                }
+            }
+        }
+    }
+
+    // the remaining column is free, set it to 1 and back substitute
+    double* pnormal = facet.normal;
+    pnormal[vcolumns[s_dim-1]] = 1;
+    for(int irow = s_dim-2; irow >= 0; --irow) {
+        double f = 0;
+        for(int j = irow+1; j < s_dim; ++j) {
+            f += A[irow][vcolumns[j]]*pnormal[vcolumns[j]];
+        }
+        pnormal[vcolumns[irow]] = -f/A[irow][vcolumns[irow]];
+    }
+
+    double fnorm = 0;
+    for(int i = 0; i < s_dim; ++i) {
+        fnorm += pnormal[i]*pnormal[i];
+    }
+    fnorm = 1/std::sqrt(fnorm);
+    facet.offset = 0;
+    double finterior = 0;
+    for(int i = 0; i < s_dim; ++i) {
+        pnormal[i] *= fnorm;
+        facet.offset += pnormal[i]*pfirst[i];
+        finterior += pnormal[i]*_vinterior[i];
+    }
+    if( finterior > facet.offset ) {
+        for(int i = 0; i < s_dim; ++i) {
+            pnormal[i] = -pnormal[i];
+        }
+        facet.offset = -facet.offset;
+    }
+    return true;
+}
+
+bool WrenchSpaceEvaluator::_AddPoint(int ipoint, int ifacet)
+{
+    const double* ppoint = _GetPoint(ipoint);
+    ++_visitid;
+    _vvisible.resize(0);
+    _vhorizon.resize(0);
+    _vfacets[ifacet].visitid = _visitid;
+    _vfacets[ifacet].bvisible = true;
+    _vvisible.push_back(ifacet);
+
+    // flood the visible region and collect the ridges on its boundary
+    for(size_t ivisible = 0; ivisible < _vvisible.size(); ++ivisible) {
+        int icurfacet = _vvisible[ivisible];
+        for(int k = 0; k < s_dim; ++k) {
+            WrenchFacet& neighbor = _vfacets[_vfacets[icurfacet].neighbors[k]];
+            if( neighbor.visitid != _visitid ) {
+                neighbor.visitid = _visitid;
+                neighbor.bvisible = _GetSignedDistance(neighbor, ppoint) > _fEpsilon;
+                if( neighbor.bvisible ) {
+                    _vvisible.push_back(_vfacets[icurfacet].neighbors[k]);
+                }
+            }
+            if( !neighbor.bvisible ) {
+                _vhorizon.push_back(std::make_pair(icurfacet, k));
+            }
+        }
+    }
+
+    // connect every horizon ridge to the new point
+    _vridges.resize(0);
+    for(size_t ihorizon = 0; ihorizon < _vhorizon.size(); ++ihorizon) {
+        int ivisiblefacet = _vhorizon[ihorizon].first, k = _vhorizon[ihorizon].second;
+        WrenchFacet newfacet;
+        int index = 0;
+        for(int j = 0; j < s_dim; ++j) {
+            if( j != k ) {
+                newfacet.vertices[index] = _vfacets[ivisiblefacet].vertices[j];
+                newfacet.neighbors[index] = -1;
+                ++index;
+            }
+        }
+        int ioutsidefacet = _vfacets[ivisiblefacet].neighbors[k];
+        newfacet.vertices[s_dim-1] = ipoint;
+        newfacet.neighbors[s_dim-1] = ioutsidefacet;
+        newfacet.visitid = _visitid;
+        newfacet.bvisible = false;
+        newfacet.bvalid = true;
+        if( !_ComputeFacetPlane(newfacet) ) {
+            return false;
+        }
+
+        int inewfacet = (int)_vfacets.size();
+        WrenchFacet& outsidefacet = _vfacets[ioutsidefacet];
+        for(int j = 0; j < s_dim; ++j) {
+            if( outsidefacet.neighbors[j] == ivisiblefacet ) {
+                outsidefacet.neighbors[j] = inewfacet;
+                break;
+            }
+        }
+        _vfacets.push_back(newfacet);
+
+        // the new facets are adjacent across the ridges containing the new point
+        for(int m = 0; m < s_dim-1; ++m) {
+            RidgeKey key;
+            int keyindex = 0;
+            for(int j = 0; j < s_dim-1; ++j) {
+                if( j != m ) {
+                    key[keyindex++] = newfacet.vertices[j];
+                }
+            }
+            std::sort(key.begin(), key.end());
+            _vridges.push_back(std::make_pair(key, std::make_pair(inewfacet, m)));
+        }
+    }
+
+    std::sort(_vridges.begin(), _vridges.end());
+    for(size_t iridge = 0; iridge < _vridges.size(); iridge += 2) {
+        if( iridge+1 >= _vridges.size() || _vridges[iridge].first != _vridges[iridge+1].first ) {
+            return false; // horizon is not a closed manifold, numerical issues
+        }
+        _vfacets[_vridges[iridge].second.first].neighbors[_vridges[iridge].second.second] = _vridges[iridge+1].second.first;
+        _vfacets[_vridges[iridge+1].second.first].neighbors[_vridges[iridge+1].second.second] = _vridges[iridge].second.first;
+    }
+
+    for(size_t ivisible = 0; ivisible < _vvisible.size(); ++ivisible) {
+        _vfacets[_vvisible[ivisible]].bvalid = false;
+    }
+    for(int inewfacet = (int)_vfacets.size()-(int)_vhorizon.size(); inewfacet < (int)_vfacets.size(); ++inewfacet) {
+        _vheap.push_back(std::make_pair(_vfacets[inewfacet].offset, inewfacet));
+        std::push_heap(_vheap.begin(), _vheap.end(), std::greater< std::pair<double, int> >());
+    }
+    return true;
+}
+
+double WrenchSpaceEvaluator::_ComputeVolume()
+{
+    // sum of the simplices formed by the interior point and every facet
+    double fvolume = 0;
+    for(size_t ifacet = 0; ifacet < _vfacets.size(); ++ifacet) {
+        const WrenchFacet& facet = _vfacets[ifacet];
+        if( !facet.bvalid ) {
+            continue;
+        }
+        double A[s_dim][s_dim];
+        for(int irow = 0; irow < s_dim; ++irow) {
+            const double* ppoint = _GetPoint(facet.vertices[irow]);
+            for(int i = 0; i < s_dim; ++i) {
+                A[irow][i] = ppoint[i] - _vinterior[i];
+            }
+        }
+        double fdet = 1;
+        for(int icol = 0; icol < s_dim && fdet != 0; ++icol) {
+            int ipivot = icol;
+            for(int irow = icol+1; irow < s_dim; ++irow) {
+                if( std::fabs(A[irow][icol]) > std::fabs(A[ipivot][icol]) ) {
+                    ipivot = irow;
+                }
+            }
+            if( A[ipivot][icol] == 0 ) {
+                fdet = 0;
+                break;
+            }
+            if( ipivot != icol ) {
+                for(int j = 0; j < s_dim; ++j) {
+                    std::swap(A[icol][j], A[ipivot][j]);
+                }
+            }
+            fdet *= A[icol][icol];
+            for(int irow = icol+1; irow < s_dim; ++irow) {
+                double fmult = A[irow][icol]/A[icol][icol];
+                for(int j = icol; j < s_dim; ++j) {
+                    A[irow][j] -= fmult*A[icol][j];
+                }
+            }
+        }
+        fvolume += std::fabs(fdet);
+    }
+    return fvolume/720; // 6!
+}
@@ -0,0 +1,108 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef OPENRAVE_GRASPER_WRENCHSPACE_H
+#define OPENRAVE_GRASPER_WRENCHSPACE_H
+
+#include <array>
+#include <utility>
+#include <vector>
+
+/** \brief Decides force closure and computes the epsilon quality of a set of 6D contact wrenches without building their full convex hull.
+
+    The epsilon quality is the distance from the origin to the boundary of the convex hull of the wrenches, and is positive
+    only if the origin is in the interior of the hull (force closure). The evaluator grows a simplicial polytope inside the hull:
+
+    1. Starting from a full dimensional simplex of wrenches, while the origin is outside a facet, the wrench with the largest support
+       along that facet's normal is added. If that support is not positive, the facet normal separates the origin from all wrenches
+       and there is no force closure.
+    2. Once the origin is enclosed, the facet closest to the origin gives a lower bound of the quality and the support along its normal
+       an upper bound. The facet is expanded with the support wrench until both bounds meet, so only the part of the hull facing
+       the origin is ever built.
+
+    All storage is kept in the evaluator and reused across calls, so after warming up evaluations do not allocate. An evaluator
+    is not thread-safe; use one per thread.
+ */
+class WrenchSpaceEvaluator
+{
+public:
+    WrenchSpaceEvaluator();
+
+    /// \brief evaluates the wrenches
+    ///
+    /// \param vwrenches 6*N values, every 6 values are one wrench (force, torque)
+    /// \param fThreshold if > 0, stops as soon as the quality is known to be below fThreshold and returns an upper bound of it in mindist
+    /// \param[out] mindist the epsilon quality, 0 if there is no force closure
+    /// \param[out] volume the volume of the polytope built inside the hull; it is a lower bound of the hull volume since only the part facing the origin is built
+    /// \return false if the evaluation ran into a numerical degeneracy, in which case the caller should fall back to a full convex hull
+    bool Evaluate(const std::vector<double>& vwrenches, double fThreshold, double& mindist, double& volume);
+
+private:
+    static const int s_dim = 6;
+
+    struct WrenchFacet
+    {
+        int vertices[s_dim];
+        int neighbors[s_dim]; ///< neighbors[i] is the facet sharing all vertices except vertices[i]
+        double normal[s_dim]; ///< unit normal pointing away from the polytope
+        double offset; ///< normal.dot(x) == offset on the facet plane, so offset is the distance of the facet to the origin, negative if the origin is outside the facet
+        int visitid; ///< last _AddPoint pass that classified this facet
+        bool bvisible; ///< valid if visitid is the current pass
+        bool bvalid; ///< false if the facet has been replaced
+    };
+
+    typedef std::array<int, s_dim-2> RidgeKey; ///< sorted vertices of a ridge between two new facets, excluding the added point
+
+    inline const double* _GetPoint(int ipoint) const {
+        return _pwrenches + s_dim*ipoint;
+    }
+
+    inline double _GetSignedDistance(const WrenchFacet& facet, const double* ppoint) const {
+        double f = -facet.offset;
+        for(int i = 0; i < s_dim; ++i) {
+            f += facet.normal[i]*ppoint[i];
+        }
+        return f;
+    }
+
+    /// \brief finds s_dim+1 wrenches spanning the space and creates the initial simplex from them
+    ///
+    /// \return 1 if the simplex was created, 0 if the wrenches do not span the space, -1 on numerical failure
+    int _InitSimplex();
+
+    /// \brief computes the normal and offset of the facet from its vertices and orients it away from _vinterior
+    bool _ComputeFacetPlane(WrenchFacet& facet);
+
+    /// \brief adds the point to the polytope, replacing all facets visible from it. ifacet has to be visible from the point.
+    bool _AddPoint(int ipoint, int ifacet);
+
+    /// \brief the volume of the current polytope
+    double _ComputeVolume();
+
+    const double* _pwrenches;
+    int _numpoints;
+    double _fEpsilon; ///< distance tolerance scaled by the magnitude of the wrenches
+    int _visitid;
+    double _vinterior[s_dim]; ///< point strictly inside the polytope, used to orient the facets
+
+    std::vector<WrenchFacet> _vfacets;
+    std::vector< std::pair<double, int> > _vheap; ///< min-heap of (offset, facet index), invalid facets are skipped when popped
+    std::vector<int> _vvisible;
+    std::vector< std::pair<int, int> > _vhorizon; ///< (visible facet, index of the vertex opposite to the horizon ridge)
+    std::vector< std::pair<RidgeKey, std::pair<int, int> > > _vridges; ///< (ridge, (new facet, vertex index opposite to the ridge))
+    std::vector<double> _vbasis; ///< for _InitSimplex
+};
+
+#endif
@@ -32,6 +32,7 @@
 
 OpenRAVE::IkSolverBasePtr CreateIkSolverFromName(const string& _name, const std::vector<dReal>& vfreeinc, dReal ikthreshold, OpenRAVE::EnvironmentBasePtr penv);
 OpenRAVE::ModuleBasePtr CreateIkFastModule(OpenRAVE::EnvironmentBasePtr penv, std::istream& sinput);
+OpenRAVE::IkSolverBasePtr CreateNumericalIkSolver(OpenRAVE::EnvironmentBasePtr penv, std::istream& sinput);
 void DestroyIkFastLibraries();
 
 const std::string IKFastSolversPlugin::_pluginname = "IKFastSolversPlugin";
@@ -40,6 +41,7 @@ IKFastSolversPlugin::IKFastSolversPlugin()
 {
     _interfaces[PT_Module].push_back("ikfast");
     _interfaces[PT_IkSolver].push_back("ikfast");
+    _interfaces[PT_IkSolver].push_back("numericalik");
     //_interfaces[PT_IkSolver].push_back("wam7ikfast");
     //_interfaces[PT_IkSolver].push_back("pa10ikfast");
     //_interfaces[PT_IkSolver].push_back("pumaikfast");
@@ -97,6 +99,9 @@ OpenRAVE::InterfaceBasePtr IKFastSolversPlugin::CreateInterface(OpenRAVE::Interf
                 }
             }
         }
+        else if( interfacename == "numericalik" ) {
+            return CreateNumericalIkSolver(penv, sinput);
+        }
 //        else {
 //            vector<dReal> vfreeinc((istream_iterator<dReal>(sinput)), istream_iterator<dReal>());
 //            if( interfacename == "wam7ikfast" ) {
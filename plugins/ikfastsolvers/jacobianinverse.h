@@ -127,7 +127,7 @@ public:
         //_vGoalAxisAngle = axisAngleFromQuat(tgoal.rot);
         //_vGoalPosition = tgoal.trans;
         
-        KinBody::KinBodyStateSaver saver(probot, KinBody::Save_LinkTransformation);
+        KinBody::KinBodyStateSaver saver(probot, KinBody::Save_LinkTransformation|KinBody::Save_Lightweight);
         Transform tbase = manip.GetBase()->GetTransform();
         Transform trobot = probot->GetTransform();
         probot->SetTransform(tbase.inverse()*trobot); // transform so that the manip's base is at the identity and matches tgoal
@@ -316,7 +316,7 @@ public:
         RobotBasePtr probot = manip.GetRobot();
         uint32_t checklimits = bIgnoreJointLimits ? OpenRAVE::KinBody::CLA_Nothing : OpenRAVE::KinBody::CLA_CheckLimitsSilent; // if not ignoring limits, silently clamp the values to their limits.
 
-        KinBody::KinBodyStateSaver saver(probot, KinBody::Save_LinkTransformation);
+        KinBody::KinBodyStateSaver saver(probot, KinBody::Save_LinkTransformation|KinBody::Save_Lightweight);
         Transform tbase = manip.GetBase()->GetTransform();
         Transform trobot = probot->GetTransform();
         probot->SetTransform(tbase.inverse()*trobot); // transform so that the manip's base is at the identity and matches tgoal
@@ -0,0 +1,1389 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "plugindefs.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include <boost/bind/bind.hpp>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+using namespace boost::placeholders;
+
+namespace numericalik {
+
+/// \brief serial chain from the manipulator base link to the tool that is evaluated without touching the robot, so several seeds can be refined at the same time
+///
+/// All transforms are in the manipulator base link frame, which is also the frame of the ik parameterizations.
+class KinematicChain
+{
+public:
+    struct ChainJoint
+    {
+        Transform tleft, tright; ///< internal hierarchy transforms of the joint
+        Transform tfixed; ///< transform of the joint if it does not belong to the arm
+        Vector vaxis; ///< axis in the joint frame
+        KinBody::JointWeakPtr pjoint; ///< set for moving joints that do not belong to the arm, their values are frozen by \ref UpdateFixedJoints
+        int armindex = -1; ///< index into the arm configuration, -1 if the joint is fixed
+        bool bRevolute = true;
+    };
+
+    /// \return false if the chain from the manipulator base to the end effector has joints that cannot be modeled
+    bool Init(const RobotBase::Manipulator& manip)
+    {
+        _vchainjoints.resize(0);
+        RobotBasePtr probot = manip.GetRobot();
+        std::vector<KinBody::JointPtr> vjoints;
+        std::vector<KinBody::LinkPtr> vlinks;
+        if( !probot->GetChain(manip.GetBase()->GetIndex(), manip.GetEndEffector()->GetIndex(), vjoints) || !probot->GetChain(manip.GetBase()->GetIndex(), manip.GetEndEffector()->GetIndex(), vlinks) ) {
+            RAVELOG_WARN_FORMAT("env=%s, manip %s:%s has no chain from base to end effector", probot->GetEnv()->GetNameId()%probot->GetName()%manip.GetName());
+            return false;
+        }
+        OPENRAVE_ASSERT_OP(vlinks.size(),==,vjoints.size()+1);
+
+        const std::vector<int>& varmindices = manip.GetArmIndices();
+        std::vector<uint8_t> vhasarmdof(varmindices.size(), 0);
+        for(size_t ijoint = 0; ijoint < vjoints.size(); ++ijoint) {
+            const KinBody::JointPtr& pjoint = vjoints[ijoint];
+            if( pjoint->GetHierarchyChildLink() != vlinks[ijoint+1] ) {
+                RAVELOG_WARN_FORMAT("env=%s, manip %s:%s joint %s goes against the link hierarchy", probot->GetEnv()->GetNameId()%probot->GetName()%manip.GetName()%pjoint->GetName());
+                return false;
+            }
+            ChainJoint chainjoint;
+            chainjoint.tleft = pjoint->GetInternalHierarchyLeftTransform();
+            chainjoint.tright = pjoint->GetInternalHierarchyRightTransform();
+            chainjoint.vaxis = pjoint->GetInternalHierarchyAxis(0);
+            if( pjoint->IsStatic() ) {
+                // the kinematics only use the left transform of static joints
+                chainjoint.tfixed = chainjoint.tleft;
+                _vchainjoints.push_back(chainjoint);
+                continue;
+            }
+            if( pjoint->IsMimic() || (pjoint->GetType() != KinBody::JointRevolute && pjoint->GetType() != KinBody::JointPrismatic) ) {
+                RAVELOG_WARN_FORMAT("env=%s, manip %s:%s joint %s is not a single revolute or prismatic joint", probot->GetEnv()->GetNameId()%probot->GetName()%manip.GetName()%pjoint->GetName());
+                return false;
+            }
+            chainjoint.bRevolute = pjoint->IsRevolute(0);
+            std::vector<int>::const_iterator itarmindex = std::find(varmindices.begin(), varmindices.end(), pjoint->GetDOFIndex());
+            if( pjoint->GetDOFIndex() >= 0 && itarmindex != varmindices.end() ) {
+                chainjoint.armindex = itarmindex - varmindices.begin();
+                vhasarmdof[chainjoint.armindex] = 1;
+            }
+            else {
+                chainjoint.pjoint = pjoint;
+            }
+            _vchainjoints.push_back(chainjoint);
+        }
+        for(size_t iarm = 0; iarm < vhasarmdof.size(); ++iarm) {
+            if( !vhasarmdof[iarm] ) {
+                RAVELOG_WARN_FORMAT("env=%s, manip %s:%s arm dof %d is not in the chain from base to end effector", probot->GetEnv()->GetNameId()%probot->GetName()%manip.GetName()%varmindices[iarm]);
+                return false;
+            }
+        }
+        _armdof = (int)varmindices.size();
+        _ttool = manip.GetLocalToolTransform();
+        _vtooldirection = manip.GetLocalToolDirection();
+        UpdateFixedJoints();
+        return true;
+    }
+
+    /// \brief freezes the moving joints of the chain that do not belong to the arm at their current values
+    void UpdateFixedJoints()
+    {
+        for(ChainJoint& chainjoint : _vchainjoints) {
+            KinBody::JointPtr pjoint = chainjoint.pjoint.lock();
+            if( !pjoint ) {
+                continue;
+            }
+            Transform tjoint;
+            if( chainjoint.bRevolute ) {
+                tjoint.rot = quatFromAxisAngle(chainjoint.vaxis, pjoint->GetValue(0));
+            }
+            else {
+                tjoint.trans = chainjoint.vaxis * pjoint->GetValue(0);
+            }
+            chainjoint.tfixed = chainjoint.tleft * tjoint * chainjoint.tright;
+        }
+    }
+
+    /// \brief computes the tool transform of the arm configuration
+    ///
+    /// \param paxes if not NULL, filled with the armdof axes of the arm joints, used for the jacobian
+    /// \param panchors if not NULL, filled with the armdof points on the axes of the arm joints
+    void ComputeTransform(const dReal* pconfig, Transform& ttool, Vector* paxes=NULL, Vector* panchors=NULL) const
+    {
+        Transform t;
+        for(const ChainJoint& chainjoint : _vchainjoints) {
+            if( chainjoint.armindex < 0 ) {
+                t = t * chainjoint.tfixed;
+                continue;
+            }
+            t = t * chainjoint.tleft;
+            if( !!paxes ) {
+                paxes[chainjoint.armindex] = t.rotate(chainjoint.vaxis);
+                panchors[chainjoint.armindex] = t.trans;
+            }
+            Transform tjoint;
+            if( chainjoint.bRevolute ) {
+                tjoint.rot = quatFromAxisAngle(chainjoint.vaxis, pconfig[chainjoint.armindex]);
+            }
+            else {
+                tjoint.trans = chainjoint.vaxis * pconfig[chainjoint.armindex];
+            }
+            t = t * tjoint * chainjoint.tright;
+        }
+        ttool = t * _ttool;
+    }
+
+    inline int GetArmDOF() const {
+        return _armdof;
+    }
+    inline const Vector& GetToolDirection() const {
+        return _vtooldirection;
+    }
+    inline bool IsRevolute(int armindex) const {
+        for(const ChainJoint& chainjoint : _vchainjoints) {
+            if( chainjoint.armindex == armindex ) {
+                return chainjoint.bRevolute;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::vector<ChainJoint> _vchainjoints;
+    Transform _ttool; ///< local tool transform of the manipulator
+    Vector _vtooldirection; ///< local tool direction of the manipulator
+    int _armdof = 0;
+};
+
+/// \brief tool poses of random arm configurations, used to start the refinement close to the goal
+struct SeedTable
+{
+    inline int GetNumSeeds() const {
+        return armdof > 0 ? (int)(vconfigs.size()/armdof) : 0;
+    }
+
+    int armdof = 0;
+    std::vector<dReal> vlower, vupper; ///< arm limits the configurations were sampled in
+    std::vector<float> vposes; ///< 7 values per seed, translation xyz and rotation quaternion
+    std::vector<float> vconfigs; ///< armdof values per seed
+    dReal freach = 0; ///< largest distance of a seed tool position from the manipulator base
+};
+typedef boost::shared_ptr<SeedTable> SeedTablePtr;
+typedef boost::shared_ptr<SeedTable const> SeedTableConstPtr;
+
+static const int32_t s_seedTableVersion = 1;
+
+/// \brief seed tables shared by all solvers of the process, the key is the database filename
+static std::mutex s_mutexSeedTables;
+static std::map<std::string, boost::weak_ptr<SeedTable const> > s_mapSeedTables;
+
+inline bool _AreLimitsEqual(const std::vector<dReal>& vlimits0, const std::vector<dReal>& vlimits1)
+{
+    if( vlimits0.size() != vlimits1.size() ) {
+        return false;
+    }
+    for(size_t i = 0; i < vlimits0.size(); ++i) {
+        if( RaveFabs(vlimits0[i] - vlimits1[i]) > 1e-6 ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// \brief reads a table written by \ref _WriteSeedTable, returns an empty pointer if the file does not exist or does not match the limits
+static SeedTablePtr _ReadSeedTable(const std::string& fullfilename, int armdof, int numseeds, const std::vector<dReal>& vlower, const std::vector<dReal>& vupper)
+{
+    std::ifstream f(fullfilename.c_str(), std::ios::binary);
+    if( !f ) {
+        return SeedTablePtr();
+    }
+    int32_t version = 0, filearmdof = 0, filenumseeds = 0;
+    f.read((char*)&version, sizeof(version));
+    f.read((char*)&filearmdof, sizeof(filearmdof));
+    f.read((char*)&filenumseeds, sizeof(filenumseeds));
+    if( !f || version != s_seedTableVersion || filearmdof != armdof || filenumseeds != numseeds ) {
+        return SeedTablePtr();
+    }
+    SeedTablePtr ptable(new SeedTable());
+    ptable->armdof = armdof;
+    std::vector<double> vlimits(2*armdof);
+    f.read((char*)vlimits.data(), vlimits.size()*sizeof(double));
+    ptable->vlower.assign(vlimits.begin(), vlimits.begin()+armdof);
+    ptable->vupper.assign(vlimits.begin()+armdof, vlimits.end());
+    if( !f || !_AreLimitsEqual(ptable->vlower, vlower) || !_AreLimitsEqual(ptable->vupper, vupper) ) {
+        return SeedTablePtr();
+    }
+    double freach = 0;
+    f.read((char*)&freach, sizeof(freach));
+    ptable->freach = freach;
+    ptable->vposes.resize(7*numseeds);
+    ptable->vconfigs.resize(armdof*numseeds);
+    f.read((char*)ptable->vposes.data(), ptable->vposes.size()*sizeof(float));
+    f.read((char*)ptable->vconfigs.data(), ptable->vconfigs.size()*sizeof(float));
+    if( !f ) {
+        return SeedTablePtr();
+    }
+    return ptable;
+}
+
+/// \brief writes the table to a temporary file that is then renamed, so processes generating the same table do not read partial files
+static bool _WriteSeedTable(const std::string& fullfilename, const SeedTable& table)
+{
+    std::string tempfilename = str(boost::format("%s.%d")%fullfilename%RaveRandomInt());
+    {
+        std::ofstream f(tempfilename.c_str(), std::ios::binary);
+        if( !f ) {
+            return false;
+        }
+        int32_t version = s_seedTableVersion, armdof = table.armdof, numseeds = table.GetNumSeeds();
+        f.write((const char*)&version, sizeof(version));
+        f.write((const char*)&armdof, sizeof(armdof));
+        f.write((const char*)&numseeds, sizeof(numseeds));
+        std::vector<double> vlimits(table.vlower.begin(), table.vlower.end());
+        vlimits.insert(vlimits.end(), table.vupper.begin(), table.vupper.end());
+        f.write((const char*)vlimits.data(), vlimits.size()*sizeof(double));
+        double freach = table.freach;
+        f.write((const char*)&freach, sizeof(freach));
+        f.write((const char*)table.vposes.data(), table.vposes.size()*sizeof(float));
+        f.write((const char*)table.vconfigs.data(), table.vconfigs.size()*sizeof(float));
+        if( !f ) {
+            f.close();
+            std::remove(tempfilename.c_str());
+            return false;
+        }
+    }
+    if( std::rename(tempfilename.c_str(), fullfilename.c_str()) != 0 ) {
+        std::remove(tempfilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+/// \brief solves (A + lambda I) x = b in place for a symmetric positive definite A of size n, b is overwritten with x
+inline bool _SolveCholesky(dReal* A, dReal* b, int n)
+{
+    for(int j = 0; j < n; ++j) {
+        dReal d = A[j*n+j];
+        for(int k = 0; k < j; ++k) {
+            d -= A[j*n+k]*A[j*n+k];
+        }
+        if( d <= 0 ) {
+            return false;
+        }
+        d = RaveSqrt(d);
+        A[j*n+j] = d;
+        for(int i = j+1; i < n; ++i) {
+            dReal s = A[i*n+j];
+            for(int k = 0; k < j; ++k) {
+                s -= A[i*n+k]*A[j*n+k];
+            }
+            A[i*n+j] = s/d;
+        }
+    }
+    for(int i = 0; i < n; ++i) {
+        dReal s = b[i];
+        for(int k = 0; k < i; ++k) {
+            s -= A[i*n+k]*b[k];
+        }
+        b[i] = s/A[i*n+i];
+    }
+    for(int i = n-1; i >= 0; --i) {
+        dReal s = b[i];
+        for(int k = i+1; k < n; ++k) {
+            s -= A[k*n+i]*b[k];
+        }
+        b[i] = s/A[i*n+i];
+    }
+    return true;
+}
+
+/// \brief damped least squares (Levenberg-Marquardt) refinement of seeds towards an ik goal. Every thread uses its own refiner
+class SeedRefiner
+{
+public:
+    SeedRefiner(const KinematicChain& chain, const std::vector<dReal>& vlower, const std::vector<dReal>& vupper, const std::vector<uint8_t>& vcircular, bool bIgnoreJointLimits) : _chain(chain), _vlower(vlower), _vupper(vupper), _vcircular(vcircular), _bIgnoreJointLimits(bIgnoreJointLimits)
+    {
+        const int armdof = chain.GetArmDOF();
+        _vaxes.resize(armdof);
+        _vanchors.resize(armdof);
+        _vnewaxes.resize(armdof);
+        _vnewanchors.resize(armdof);
+        _vjacobian.resize(6*armdof);
+        _vnew.resize(armdof);
+    }
+
+    /// \brief moves vconfig towards the goal
+    ///
+    /// \return true if the error of the tool is below ferrorthresh
+    bool Refine(const IkParameterization& param, std::vector<dReal>& vconfig, dReal ferrorthresh, int nMaxIterations)
+    {
+        const int armdof = _chain.GetArmDOF();
+        const int nrows = _GetNumRows(param.GetType());
+        const dReal ferrorthresh2 = ferrorthresh*ferrorthresh;
+        _ApplyLimits(vconfig.data());
+
+        Transform ttool, tnewtool;
+        dReal verror[6], vnewerror[6];
+        _chain.ComputeTransform(vconfig.data(), ttool, _vaxes.data(), _vanchors.data());
+        dReal ferror2 = _ComputeError(param, ttool, verror);
+        dReal flambda = 1e-3;
+        for(int iter = 0; iter < nMaxIterations; ++iter) {
+            if( ferror2 <= ferrorthresh2 ) {
+                return true;
+            }
+            _ComputeJacobian(param.GetType(), ttool);
+
+            // step = J^T (J J^T + lambda I)^-1 error
+            dReal A[36], x[6];
+            for(int i = 0; i < nrows; ++i) {
+                for(int j = 0; j <= i; ++j) {
+                    dReal f = 0;
+                    for(int k = 0; k < armdof; ++k) {
+                        f += _vjacobian[i*armdof+k]*_vjacobian[j*armdof+k];
+                    }
+                    A[i*nrows+j] = f;
+                    A[j*nrows+i] = f;
+                }
+                A[i*nrows+i] += flambda;
+                x[i] = verror[i];
+            }
+            if( !_SolveCholesky(A, x, nrows) ) {
+                flambda *= 8;
+                continue;
+            }
+            dReal fmaxstep = 0;
+            for(int k = 0; k < armdof; ++k) {
+                dReal f = 0;
+                for(int i = 0; i < nrows; ++i) {
+                    f += _vjacobian[i*armdof+k]*x[i];
+                }
+                _vnew[k] = f;
+                fmaxstep = max(fmaxstep, RaveFabs(f));
+            }
+            // large steps leave the region where the jacobian is valid
+            const dReal fstepscale = fmaxstep > 0.5 ? 0.5/fmaxstep : 1;
+            for(int k = 0; k < armdof; ++k) {
+                _vnew[k] = vconfig[k] + _vnew[k]*fstepscale;
+            }
+            _ApplyLimits(_vnew.data());
+
+            _chain.ComputeTransform(_vnew.data(), tnewtool, _vnewaxes.data(), _vnewanchors.data());
+            dReal fnewerror2 = _ComputeError(param, tnewtool, vnewerror);
+            if( fnewerror2 < ferror2 ) {
+                vconfig.swap(_vnew);
+                _vaxes.swap(_vnewaxes);
+                _vanchors.swap(_vnewanchors);
+                ttool = tnewtool;
+                ferror2 = fnewerror2;
+                std::copy(vnewerror, vnewerror+nrows, verror);
+                flambda = max(flambda*dReal(0.5), dReal(1e-9));
+            }
+            else {
+                flambda *= 8;
+                if( flambda > 1e4 ) {
+                    // stuck in a local minimum or at the joint limits
+                    break;
+                }
+            }
+        }
+        return ferror2 <= ferrorthresh2;
+    }
+
+private:
+    static inline int _GetNumRows(IkParameterizationType iktype)
+    {
+        return (iktype == IKP_Transform6D || iktype == IKP_TranslationDirection5D) ? 6 : 3;
+    }
+
+    void _ApplyLimits(dReal* pconfig) const
+    {
+        for(size_t i = 0; i < _vlower.size(); ++i) {
+            if( _vcircular[i] ) {
+                pconfig[i] = utils::NormalizeCircularAngle(pconfig[i], -PI, PI);
+            }
+            else if( !_bIgnoreJointLimits ) {
+                pconfig[i] = max(_vlower[i], min(_vupper[i], pconfig[i]));
+            }
+        }
+    }
+
+    /// \brief fills the error vector of the goal and returns its squared norm
+    dReal _ComputeError(const IkParameterization& param, const Transform& ttool, dReal* perror) const
+    {
+        Vector v0, v1;
+        switch(param.GetType()) {
+        case IKP_Transform6D: {
+            const Transform& tgoal = param.GetTransform6D();
+            v0 = tgoal.trans - ttool.trans;
+            v1 = axisAngleFromQuat(quatMultiply(tgoal.rot, quatInverse(ttool.rot)));
+            break;
+        }
+        case IKP_Rotation3D:
+            v0 = axisAngleFromQuat(quatMultiply(param.GetRotation3D(), quatInverse(ttool.rot)));
+            break;
+        case IKP_Translation3D:
+            v0 = param.GetTranslation3D() - ttool.trans;
+            break;
+        case IKP_Direction3D:
+            v0 = param.GetDirection3D() - ttool.rotate(_chain.GetToolDirection());
+            break;
+        case IKP_TranslationDirection5D: {
+            const RAY ray = param.GetTranslationDirection5D();
+            v0 = ray.pos - ttool.trans;
+            v1 = ray.dir - ttool.rotate(_chain.GetToolDirection());
+            break;
+        }
+        default:
+            throw OPENRAVE_EXCEPTION_FORMAT(_("numericalik does not support ik type 0x%x"), param.GetType(), ORE_InvalidArguments);
+        }
+        perror[0] = v0.x; perror[1] = v0.y; perror[2] = v0.z;
+        perror[3] = v1.x; perror[4] = v1.y; perror[5] = v1.z;
+        return v0.lengthsqr3() + v1.lengthsqr3();
+    }
+
+    /// \brief fills the rows of the jacobian matching \ref _ComputeError from the current axes
+    void _ComputeJacobian(IkParameterizationType iktype, const Transform& ttool)
+    {
+        const int armdof = _chain.GetArmDOF();
+        const Vector vdirection = ttool.rotate(_chain.GetToolDirection());
+        for(int k = 0; k < armdof; ++k) {
+            const Vector& vaxis = _vaxes[k];
+            const bool bRevolute = _chain.IsRevolute(k);
+            Vector vtranslation = bRevolute ? vaxis.cross(ttool.trans - _vanchors[k]) : vaxis;
+            Vector vrotation = bRevolute ? vaxis : Vector(0,0,0);
+            Vector vdirectionchange = bRevolute ? vaxis.cross(vdirection) : Vector(0,0,0);
+            Vector v0, v1;
+            switch(iktype) {
+            case IKP_Transform6D: v0 = vtranslation; v1 = vrotation; break;
+            case IKP_Rotation3D: v0 = vrotation; break;
+            case IKP_Translation3D: v0 = vtranslation; break;
+            case IKP_Direction3D: v0 = vdirectionchange; break;
+            case IKP_TranslationDirection5D: v0 = vtranslation; v1 = vdirectionchange; break;
+            default: break;
+            }
+            _vjacobian[0*armdof+k] = v0.x; _vjacobian[1*armdof+k] = v0.y; _vjacobian[2*armdof+k] = v0.z;
+            _vjacobian[3*armdof+k] = v1.x; _vjacobian[4*armdof+k] = v1.y; _vjacobian[5*armdof+k] = v1.z;
+        }
+    }
+
+    const KinematicChain& _chain;
+    const std::vector<dReal>& _vlower, &_vupper;
+    const std::vector<uint8_t>& _vcircular;
+    bool _bIgnoreJointLimits;
+
+    std::vector<Vector> _vaxes, _vanchors, _vnewaxes, _vnewanchors;
+    std::vector<dReal> _vjacobian; ///< 6 x armdof, row major
+    std::vector<dReal> _vnew;
+};
+
+/// \brief kd-tree over the seeds in one of the spaces the distance of a seed to the goal is computed in
+///
+/// The tree prunes with the squared distance in its own space times a scale, so the nearest seeds are exact as long as that is a lower bound of the seed distance.
+class SeedKdTree
+{
+public:
+    /// \param dim dimension of the points
+    /// \param vpoints dim values per seed, swapped into the tree
+    void Build(int dim, std::vector<float>& vpoints)
+    {
+        _dim = dim;
+        _vpoints.swap(vpoints);
+        const int numpoints = dim > 0 ? (int)(_vpoints.size()/dim) : 0;
+        _vindices.resize(numpoints);
+        for(int i = 0; i < numpoints; ++i) {
+            _vindices[i] = i;
+        }
+        _vaxes.resize(numpoints);
+        _Build(0, numpoints);
+    }
+
+    /// \brief adds the seeds that are nearer than the farthest seed of the heap
+    ///
+    /// \param pquery point in the space of the tree
+    /// \param fscale the seed distance is at least fscale times the squared distance in the space of the tree
+    /// \param distfn returns the seed distance of a seed index
+    /// \param numnearest maximum size of the heap
+    /// \param vheap max heap of (seed distance, seed index), can already hold the seeds of another query
+    template <typename F>
+    void Search(const dReal* pquery, dReal fscale, const F& distfn, int numnearest, std::vector< std::pair<dReal, int> >& vheap) const
+    {
+        if( numnearest > 0 ) {
+            _Search(0, (int)_vindices.size(), pquery, fscale, distfn, numnearest, vheap);
+        }
+    }
+
+private:
+    void _Build(int begin, int end)
+    {
+        if( end - begin <= s_nLeafSize ) {
+            return;
+        }
+        // split the axis with the largest spread at the median
+        int axis = 0;
+        float fmaxspread = -1;
+        for(int i = 0; i < _dim; ++i) {
+            float fmin = std::numeric_limits<float>::max(), fmax = -std::numeric_limits<float>::max();
+            for(int j = begin; j < end; ++j) {
+                const float f = _vpoints[_vindices[j]*_dim+i];
+                fmin = min(fmin, f);
+                fmax = max(fmax, f);
+            }
+            if( fmax - fmin > fmaxspread ) {
+                fmaxspread = fmax - fmin;
+                axis = i;
+            }
+        }
+        const int mid = (begin + end)/2;
+        std::nth_element(_vindices.begin()+begin, _vindices.begin()+mid, _vindices.begin()+end, [this, axis](int index0, int index1) {
+            return _vpoints[index0*_dim+axis] < _vpoints[index1*_dim+axis];
+        });
+        _vaxes[mid] = axis;
+        _Build(begin, mid);
+        _Build(mid+1, end);
+    }
+
+    template <typename F>
+    void _Search(int begin, int end, const dReal* pquery, dReal fscale, const F& distfn, int numnearest, std::vector< std::pair<dReal, int> >& vheap) const
+    {
+        if( end - begin <= s_nLeafSize ) {
+            for(int j = begin; j < end; ++j) {
+                _AddSeed(_vindices[j], distfn, numnearest, vheap);
+            }
+            return;
+        }
+        const int mid = (begin + end)/2;
+        const int axis = _vaxes[mid];
+        const dReal fdiff = pquery[axis] - _vpoints[_vindices[mid]*_dim+axis];
+        _AddSeed(_vindices[mid], distfn, numnearest, vheap);
+        const bool bLower = fdiff < 0;
+        _Search(bLower ? begin : mid+1, bLower ? mid : end, pquery, fscale, distfn, numnearest, vheap);
+        if( (int)vheap.size() < numnearest || fscale*fdiff*fdiff < vheap.front().first ) {
+            _Search(bLower ? mid+1 : begin, bLower ? end : mid, pquery, fscale, distfn, numnearest, vheap);
+        }
+    }
+
+    template <typename F>
+    static void _AddSeed(int iseed, const F& distfn, int numnearest, std::vector< std::pair<dReal, int> >& vheap)
+    {
+        const dReal fdist2 = distfn(iseed);
+        const bool bFull = (int)vheap.size() >= numnearest;
+        if( bFull && fdist2 >= vheap.front().first ) {
+            return;
+        }
+        // the heap can already hold the seed from another query
+        for(const std::pair<dReal, int>& item : vheap) {
+            if( item.second == iseed ) {
+                return;
+            }
+        }
+        if( bFull ) {
+            std::pop_heap(vheap.begin(), vheap.end());
+            vheap.pop_back();
+        }
+        vheap.emplace_back(fdist2, iseed);
+        std::push_heap(vheap.begin(), vheap.end());
+    }
+
+    static const int s_nLeafSize = 8;
+
+    int _dim = 0;
+    std::vector<float> _vpoints; ///< _dim values per seed
+    std::vector<int> _vindices; ///< seed indices, every range is split at its middle
+    std::vector<uint8_t> _vaxes; ///< split axis of the range whose middle is at the same position in _vindices
+};
+
+/// \brief the seeds of a table indexed by tool position, tool rotation, and tool direction
+struct SeedIndex
+{
+    void Build(const SeedTable& table, const Vector& vtooldir)
+    {
+        const int numseeds = table.GetNumSeeds();
+        std::vector<float> vtranslations(3*numseeds), vrotations(4*numseeds), vdirections(3*numseeds);
+        for(int iseed = 0; iseed < numseeds; ++iseed) {
+            const float* ppose = &table.vposes[7*iseed];
+            std::copy(ppose, ppose+3, &vtranslations[3*iseed]);
+            std::copy(ppose+3, ppose+7, &vrotations[4*iseed]);
+            const Vector vdir = quatRotate(Vector(ppose[3], ppose[4], ppose[5], ppose[6]), vtooldir);
+            vdirections[3*iseed+0] = vdir.x;
+            vdirections[3*iseed+1] = vdir.y;
+            vdirections[3*iseed+2] = vdir.z;
+        }
+        translationtree.Build(3, vtranslations);
+        rotationtree.Build(4, vrotations);
+        directiontree.Build(3, vdirections);
+    }
+
+    SeedKdTree translationtree; ///< xyz of the tool
+    SeedKdTree rotationtree; ///< quaternion of the tool, q and -q are the same rotation so it is searched with both signs of the goal
+    SeedKdTree directiontree; ///< direction of the tool
+};
+
+/// \brief threads that refine the seeds, kept alive across solves so every call does not pay for creating them
+///
+/// The pool only grows up to the largest number of threads a call asked for, the workers a call does not need keep waiting.
+class RefineWorkerPool
+{
+public:
+    RefineWorkerPool() : _pfn(NULL), _generation(0), _nworkers(0), _nrunning(0), _bStop(false) {
+    }
+    ~RefineWorkerPool() {
+        _Stop();
+    }
+
+    /// \brief runs fn on numthreads threads including the calling one, and returns once all of them returned
+    void Run(int numthreads, const std::function<void()>& fn)
+    {
+        if( numthreads <= 1 ) {
+            fn();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            while( (int)_vthreads.size() < numthreads-1 ) {
+                _vthreads.emplace_back(&RefineWorkerPool::_Work, this, (int)_vthreads.size(), _generation);
+            }
+            _pfn = &fn;
+            _nworkers = numthreads-1;
+            _nrunning = _nworkers;
+            ++_generation;
+        }
+        _condwork.notify_all();
+        fn();
+        std::unique_lock<std::mutex> lock(_mutex);
+        _conddone.wait(lock, [this]() {
+            return _nrunning == 0;
+        });
+        _pfn = NULL;
+    }
+
+private:
+    void _Work(int iworker, uint64_t generation)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while(true) {
+            _condwork.wait(lock, [this, generation]() {
+                return _bStop || _generation != generation;
+            });
+            if( _bStop ) {
+                return;
+            }
+            generation = _generation;
+            if( iworker >= _nworkers ) {
+                continue;
+            }
+            const std::function<void()>* pfn = _pfn;
+            lock.unlock();
+            (*pfn)();
+            lock.lock();
+            if( --_nrunning == 0 ) {
+                _conddone.notify_one();
+            }
+        }
+    }
+
+    void _Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _bStop = true;
+        }
+        _condwork.notify_all();
+        FOREACH(itthread, _vthreads) {
+            itthread->join();
+        }
+        _vthreads.clear();
+        _bStop = false;
+    }
+
+    std::vector<std::thread> _vthreads;
+    std::mutex _mutex;
+    std::condition_variable _condwork, _conddone;
+    const std::function<void()>* _pfn; ///< task of the current generation
+    uint64_t _generation; ///< incremented for every task
+    int _nworkers; ///< number of workers running the current task, the first ones of _vthreads
+    int _nrunning; ///< number of workers that did not finish the current task
+    bool _bStop;
+};
+
+/// \brief numerical ik for manipulators without an ikfast solver.
+///
+/// Starts from the seeds of a precomputed table whose tool poses are nearest to the goal and refines them in parallel with damped least squares on a copy of the arm chain.
+class NumericalIkSolver : public IkSolverBase
+{
+public:
+    NumericalIkSolver(EnvironmentBasePtr penv, std::istream& sinput) : IkSolverBase(penv)
+    {
+        __description = "Numerical ik for manipulators without an ikfast solver. Refines the arm configurations of a precomputed seed table whose tool poses are nearest to the goal with damped least squares, on several threads. The seed table is cached in the database directory under the kinematics hash of the manipulator.\n\nSupports Transform6D, Rotation3D, Translation3D, Direction3D and TranslationDirection5D on serial chains of revolute and prismatic joints, including redundant arms.\n\nArguments: [numseeds N] [numnearestseeds K] [numthreads T]";
+        RegisterCommand("SetIkThreshold",boost::bind(&NumericalIkSolver::_SetIkThresholdCommand,this,_1,_2),
+                        "sets the ik threshold for validating returned ik solutions");
+        RegisterCommand("SetRefineParameters",boost::bind(&NumericalIkSolver::_SetRefineParametersCommand,this,_1,_2),
+                        "format: errorthreshold maxiterations numnearestseeds numnearestseedsall numthreads\n\nworkspace error the refinement stops at, maximum iterations per seed, number of seeds refined by Solve and SolveAll, and the number of threads refining them (0 for all cores)");
+        RegisterCommand("GetRefineParameters",boost::bind(&NumericalIkSolver::_GetRefineParametersCommand,this,_1,_2),
+                        "returns errorthreshold maxiterations numnearestseeds numnearestseedsall numthreads");
+        RegisterCommand("SetNumSeeds",boost::bind(&NumericalIkSolver::_SetNumSeedsCommand,this,_1,_2),
+                        "sets the number of seeds of the table, the table is loaded or generated on the next call");
+
+        std::string cmd;
+        while(!sinput.eof()) {
+            sinput >> cmd;
+            if( !sinput ) {
+                break;
+            }
+            std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
+            if( cmd == "numseeds" ) {
+                sinput >> _numseeds;
+            }
+            else if( cmd == "numnearestseeds" ) {
+                sinput >> _numnearestseeds;
+            }
+            else if( cmd == "numthreads" ) {
+                sinput >> _numthreads;
+            }
+            else {
+                RAVELOG_WARN_FORMAT("env=%s, unrecognized numericalik argument %s", GetEnv()->GetNameId()%cmd);
+                break;
+            }
+        }
+    }
+    virtual ~NumericalIkSolver() {
+    }
+
+    inline boost::shared_ptr<NumericalIkSolver> shared_solver() {
+        return boost::static_pointer_cast<NumericalIkSolver>(shared_from_this());
+    }
+    inline boost::weak_ptr<NumericalIkSolver> weak_solver() {
+        return shared_solver();
+    }
+
+    virtual bool Init(RobotBase::ManipulatorConstPtr pmanip)
+    {
+        RobotBasePtr probot = pmanip->GetRobot();
+        _pmanip.reset();
+        _cblimits.reset();
+        _pseedtable.reset();
+        _pindexedtable.reset(); // the direction tree depends on the tool direction of the manipulator
+        RobotBase::ManipulatorPtr pfoundmanip = probot->GetManipulator(pmanip->GetName());
+        if( !pfoundmanip || pfoundmanip != pmanip ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("manipulator '%s' not found in robot '%s'"), pmanip->GetName()%probot->GetName(), ORE_InvalidArguments);
+        }
+        if( !_chain.Init(*pmanip) ) {
+            return false;
+        }
+        _pmanip = pfoundmanip;
+        _kinematicshash = pmanip->GetKinematicsStructureHash();
+        pmanip->GetChildLinks(_vchildlinks);
+        _cblimits = probot->RegisterChangeCallback(KinBody::Prop_JointLimits,boost::bind(&NumericalIkSolver::_UpdateJointLimits,boost::bind(&utils::sptr_from<NumericalIkSolver>, weak_solver())));
+        _UpdateJointLimits();
+        return true;
+    }
+
+    virtual bool Supports(IkParameterizationType iktype) const
+    {
+        return iktype == IKP_Transform6D || iktype == IKP_Rotation3D || iktype == IKP_Translation3D || iktype == IKP_Direction3D || iktype == IKP_TranslationDirection5D;
+    }
+
+    const std::string& GetKinematicsStructureHash() const {
+        return _kinematicshash;
+    }
+
+    virtual bool Solve(const IkParameterization& param, const std::vector<dReal>& q0, int filteroptions, boost::shared_ptr< std::vector<dReal> > result)
+    {
+        std::vector<dReal> q0local = q0; // copy in case result points to q0
+        if( !!result ) {
+            result->resize(0);
+        }
+        IkReturn ikreturn(IKRA_Success);
+        IkReturnPtr pikreturn(&ikreturn,utils::null_deleter());
+        if( !Solve(param,q0local,filteroptions,pikreturn) ) {
+            return false;
+        }
+        if( !!result ) {
+            *result = ikreturn._vsolution;
+        }
+        return true;
+    }
+
+    virtual bool SolveAll(const IkParameterization& param, int filteroptions, std::vector< std::vector<dReal> >& qSolutions)
+    {
+        std::vector<IkReturnPtr> vikreturns;
+        qSolutions.resize(0);
+        if( !SolveAll(param,filteroptions,vikreturns) ) {
+            return false;
+        }
+        qSolutions.resize(vikreturns.size());
+        for(size_t i = 0; i < vikreturns.size(); ++i) {
+            qSolutions[i] = vikreturns[i]->_vsolution;
+        }
+        return qSolutions.size()>0;
+    }
+
+    /// \brief there are no free parameters, so vFreeParameters is ignored
+    virtual bool Solve(const IkParameterization& param, const std::vector<dReal>& q0, const std::vector<dReal>& vFreeParameters, int filteroptions, boost::shared_ptr< std::vector<dReal> > result)
+    {
+        return Solve(param, q0, filteroptions, result);
+    }
+
+    virtual bool SolveAll(const IkParameterization& param, const std::vector<dReal>& vFreeParameters, int filteroptions, std::vector< std::vector<dReal> >& qSolutions)
+    {
+        return SolveAll(param, filteroptions, qSolutions);
+    }
+
+    virtual bool Solve(const IkParameterization& param, const std::vector<dReal>& q0, const std::vector<dReal>& vFreeParameters, int filteroptions, IkReturnPtr ikreturn)
+    {
+        return Solve(param, q0, filteroptions, ikreturn);
+    }
+
+    virtual bool SolveAll(const IkParameterization& param, const std::vector<dReal>& vFreeParameters, int filteroptions, std::vector<IkReturnPtr>& vikreturns)
+    {
+        return SolveAll(param, filteroptions, vikreturns);
+    }
+
+    virtual bool Solve(const IkParameterization& param, const std::vector<dReal>& q0, int filteroptions, IkReturnPtr ikreturn)
+    {
+        if( !!ikreturn ) {
+            ikreturn->Clear();
+        }
+        RobotBase::ManipulatorPtr pmanip(_pmanip);
+        RobotBasePtr probot = pmanip->GetRobot();
+        RobotBase::RobotStateSaver saver(probot);
+        probot->SetActiveDOFs(pmanip->GetArmIndices());
+        CollisionOptionsStateSaver optionstate(GetEnv()->GetCollisionChecker(),GetEnv()->GetCollisionChecker()->GetCollisionOptions()|CO_ActiveDOFs,false);
+
+        std::vector< std::vector<dReal> > vsolutions;
+        _ComputeSolutions(param, q0, _numnearestseeds, filteroptions, vsolutions);
+        if( vsolutions.size() == 0 ) {
+            if( !!ikreturn ) {
+                ikreturn->_action = IKRA_RejectKinematics;
+            }
+            return false;
+        }
+
+        int retactionall = IKRA_Reject;
+        IkParameterization paramnew;
+        for(std::vector<dReal>& vsolution : vsolutions) {
+            IkReturnPtr localret(new IkReturn(IKRA_Success));
+            IkReturnAction retaction = _ValidateSolution(param, filteroptions, vsolution, localret, paramnew);
+            if( retaction == IKRA_Success ) {
+                localret->_vsolution.swap(vsolution);
+                if( !!ikreturn ) {
+                    *ikreturn = *localret;
+                }
+                _CallFinishCallbacks(localret, pmanip, pmanip->GetBase()->GetTransform() * paramnew);
+                return true;
+            }
+            retactionall |= retaction;
+            if( retaction & IKRA_Quit ) {
+                break;
+            }
+        }
+        if( !!ikreturn ) {
+            ikreturn->_action = static_cast<IkReturnAction>(retactionall);
+        }
+        return false;
+    }
+
+    virtual bool SolveAll(const IkParameterization& param, int filteroptions, std::vector<IkReturnPtr>& vikreturns)
+    {
+        vikreturns.resize(0);
+        RobotBase::ManipulatorPtr pmanip(_pmanip);
+        RobotBasePtr probot = pmanip->GetRobot();
+        RobotBase::RobotStateSaver saver(probot);
+        probot->SetActiveDOFs(pmanip->GetArmIndices());
+        CollisionOptionsStateSaver optionstate(GetEnv()->GetCollisionChecker(),GetEnv()->GetCollisionChecker()->GetCollisionOptions()|CO_ActiveDOFs,false);
+
+        std::vector< std::vector<dReal> > vsolutions;
+        _ComputeSolutions(param, std::vector<dReal>(), _numnearestseedsall, filteroptions, vsolutions);
+        IkParameterization paramnew;
+        for(std::vector<dReal>& vsolution : vsolutions) {
+            IkReturnPtr localret(new IkReturn(IKRA_Success));
+            IkReturnAction retaction = _ValidateSolution(param, filteroptions, vsolution, localret, paramnew);
+            if( retaction == IKRA_Success ) {
+                localret->_vsolution.swap(vsolution);
+                _CallFinishCallbacks(localret, pmanip, pmanip->GetBase()->GetTransform() * paramnew);
+                vikreturns.push_back(localret);
+            }
+            else if( retaction & IKRA_Quit ) {
+                return false;
+            }
+        }
+        return vikreturns.size()>0;
+    }
+
+    virtual int GetNumFreeParameters() const
+    {
+        return 0;
+    }
+
+    virtual bool GetFreeParameters(std::vector<dReal>& vFreeParameters) const
+    {
+        vFreeParameters.resize(0);
+        return true;
+    }
+
+    virtual bool GetFreeIndices(std::vector<int>& vFreeIndices) const
+    {
+        vFreeIndices.resize(0);
+        return true;
+    }
+
+    virtual RobotBase::ManipulatorPtr GetManipulator() const {
+        return _pmanip.lock();
+    }
+
+    virtual void Clone(InterfaceBaseConstPtr preference, int cloningoptions)
+    {
+        IkSolverBase::Clone(preference, cloningoptions);
+        boost::shared_ptr<NumericalIkSolver const> r = boost::dynamic_pointer_cast<NumericalIkSolver const>(preference);
+        _ikthreshold = r->_ikthreshold;
+        _ferrorthresh = r->_ferrorthresh;
+        _nMaxIterations = r->_nMaxIterations;
+        _numseeds = r->_numseeds;
+        _numnearestseeds = r->_numnearestseeds;
+        _numnearestseedsall = r->_numnearestseedsall;
+        _numthreads = r->_numthreads;
+
+        _pmanip.reset();
+        _cblimits.reset();
+        _pseedtable.reset();
+        _vchildlinks.resize(0);
+        RobotBase::ManipulatorPtr rmanip = r->_pmanip.lock();
+        if( !!rmanip ) {
+            RobotBasePtr probot = GetEnv()->GetRobot(rmanip->GetRobot()->GetName());
+            if( !!probot ) {
+                RobotBase::ManipulatorPtr pmanip = probot->GetManipulator(rmanip->GetName());
+                if( !!pmanip && Init(pmanip) ) {
+                    // the table only depends on the kinematics, so share it with the reference
+                    if( !!r->_pseedtable && _AreLimitsEqual(r->_pseedtable->vlower, _vlower) && _AreLimitsEqual(r->_pseedtable->vupper, _vupper) && r->_pseedtable->GetNumSeeds() == _numseeds ) {
+                        _pseedtable = r->_pseedtable;
+                    }
+                }
+            }
+        }
+    }
+
+protected:
+    bool _SetIkThresholdCommand(ostream& sout, istream& sinput)
+    {
+        sinput >> _ikthreshold;
+        return !!sinput;
+    }
+
+    bool _SetRefineParametersCommand(ostream& sout, istream& sinput)
+    {
+        dReal ferrorthresh = _ferrorthresh;
+        int nMaxIterations = _nMaxIterations, numnearestseeds = _numnearestseeds, numnearestseedsall = _numnearestseedsall, numthreads = _numthreads;
+        sinput >> ferrorthresh >> nMaxIterations >> numnearestseeds >> numnearestseedsall >> numthreads;
+        if( !sinput ) {
+            return false;
+        }
+        _ferrorthresh = ferrorthresh;
+        _nMaxIterations = nMaxIterations;
+        _numnearestseeds = numnearestseeds;
+        _numnearestseedsall = numnearestseedsall;
+        _numthreads = numthreads;
+        return true;
+    }
+
+    bool _GetRefineParametersCommand(ostream& sout, istream& sinput)
+    {
+        sout << _ferrorthresh << " " << _nMaxIterations << " " << _numnearestseeds << " " << _numnearestseedsall << " " << _numthreads;
+        return true;
+    }
+
+    bool _SetNumSeedsCommand(ostream& sout, istream& sinput)
+    {
+        int numseeds = 0;
+        sinput >> numseeds;
+        if( !sinput || numseeds < 0 ) {
+            return false;
+        }
+        _numseeds = numseeds;
+        _pseedtable.reset();
+        return true;
+    }
+
+    void _UpdateJointLimits()
+    {
+        RobotBase::ManipulatorPtr pmanip = _pmanip.lock();
+        if( !pmanip ) {
+            return;
+        }
+        RobotBasePtr probot = pmanip->GetRobot();
+        probot->GetDOFLimits(_vlower, _vupper, pmanip->GetArmIndices());
+        _vcircular.resize(_vlower.size());
+        for(size_t i = 0; i < pmanip->GetArmIndices().size(); ++i) {
+            const int dofindex = pmanip->GetArmIndices()[i];
+            KinBody::JointPtr pjoint = probot->GetJointFromDOFIndex(dofindex);
+            _vcircular[i] = pjoint->IsCircular(dofindex-pjoint->GetDOFIndex());
+        }
+        if( !!_pseedtable && (!_AreLimitsEqual(_pseedtable->vlower, _vlower) || !_AreLimitsEqual(_pseedtable->vupper, _vupper)) ) {
+            _pseedtable.reset();
+        }
+    }
+
+    /// \brief returns the seed table of the current limits, reading it from the database or generating it if necessary
+    const SeedTable& _GetSeedTable()
+    {
+        if( !!_pseedtable ) {
+            return *_pseedtable;
+        }
+        const int armdof = _chain.GetArmDOF();
+        const std::string filename = str(boost::format("kinematics.%s/numericalik.%d.seeds")%_kinematicshash%_numseeds);
+        std::lock_guard<std::mutex> lock(s_mutexSeedTables);
+        std::map<std::string, boost::weak_ptr<SeedTable const> >::iterator it = s_mapSeedTables.find(filename);
+        if( it != s_mapSeedTables.end() ) {
+            SeedTableConstPtr pcachedtable = it->second.lock();
+            if( !!pcachedtable && _AreLimitsEqual(pcachedtable->vlower, _vlower) && _AreLimitsEqual(pcachedtable->vupper, _vupper) ) {
+                _pseedtable = pcachedtable;
+                return *_pseedtable;
+            }
+        }
+
+        SeedTablePtr ptable;
+        std::string fullfilename = RaveFindDatabaseFile(filename);
+        if( fullfilename.size() > 0 ) {
+            ptable = _ReadSeedTable(fullfilename, armdof, _numseeds, _vlower, _vupper);
+        }
+        if( !ptable ) {
+            uint64_t starttime = utils::GetMicroTime();
+            ptable = _GenerateSeedTable();
+            std::string directory = RaveGetHomeDirectory() + "/kinematics." + _kinematicshash;
+#ifndef _WIN32
+            mkdir(directory.c_str(),S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH | S_IRWXU);
+#else
+            CreateDirectory(directory.c_str(),NULL);
+#endif
+            fullfilename = RaveGetHomeDirectory() + "/" + filename;
+            if( !_WriteSeedTable(fullfilename, *ptable) ) {
+                RAVELOG_WARN_FORMAT("env=%s, failed to write the numericalik seed table %s", GetEnv()->GetNameId()%fullfilename);
+            }
+            RAVELOG_DEBUG_FORMAT("env=%s, generated %d numericalik seeds in %fs to %s", GetEnv()->GetNameId()%_numseeds%((utils::GetMicroTime()-starttime)*1e-6)%fullfilename);
+        }
+        _pseedtable = ptable;
+        s_mapSeedTables[filename] = _pseedtable;
+        return *_pseedtable;
+    }
+
+    /// \brief samples the arm configurations uniformly in the limits, circular joints in one revolution
+    SeedTablePtr _GenerateSeedTable() const
+    {
+        const int armdof = _chain.GetArmDOF();
+        SeedTablePtr ptable(new SeedTable());
+        ptable->armdof = armdof;
+        ptable->vlower = _vlower;
+        ptable->vupper = _vupper;
+        ptable->vposes.resize(7*_numseeds);
+        ptable->vconfigs.resize(armdof*_numseeds);
+        std::mt19937 rng(_numseeds); // deterministic so all processes generate the same table
+        std::uniform_real_distribution<dReal> uniform(0, 1);
+        std::vector<dReal> vconfig(armdof);
+        Transform ttool;
+        dReal freach2 = 0;
+        for(int iseed = 0; iseed < _numseeds; ++iseed) {
+            for(int i = 0; i < armdof; ++i) {
+                const dReal flower = _vcircular[i] ? -PI : _vlower[i];
+                const dReal fupper = _vcircular[i] ? PI : _vupper[i];
+                vconfig[i] = flower + (fupper - flower)*uniform(rng);
+                ptable->vconfigs[iseed*armdof+i] = vconfig[i];
+            }
+            _chain.ComputeTransform(vconfig.data(), ttool);
+            float* ppose = &ptable->vposes[7*iseed];
+            ppose[0] = ttool.trans.x; ppose[1] = ttool.trans.y; ppose[2] = ttool.trans.z;
+            ppose[3] = ttool.rot.x; ppose[4] = ttool.rot.y; ppose[5] = ttool.rot.z; ppose[6] = ttool.rot.w;
+            freach2 = max(freach2, ttool.trans.lengthsqr3());
+        }
+        ptable->freach = RaveSqrt(freach2);
+        return ptable;
+    }
+
+    /// \brief returns the indices of the numnearest seeds whose tool poses are closest to the goal, nearest first
+    ///
+    /// Rotations are weighted by the reach of the arm over pi, so half a turn of the tool counts as much as moving it across the workspace.
+    /// The seeds are searched in the tree of the tool translation if the goal has one, otherwise in the tree of the tool rotation or direction.
+    void _FindNearestSeeds(const SeedTable& table, const IkParameterization& param, int numnearest, std::vector<int>& vindices)
+    {
+        vindices.resize(0);
+        const int numseeds = table.GetNumSeeds();
+        if( numseeds == 0 || numnearest <= 0 ) {
+            return;
+        }
+        if( _pindexedtable.get() != &table ) {
+            _seedindex.Build(table, _chain.GetToolDirection());
+            _pindexedtable = _pseedtable;
+        }
+        const IkParameterizationType iktype = param.GetType();
+        const bool bTranslation = iktype == IKP_Transform6D || iktype == IKP_Translation3D || iktype == IKP_TranslationDirection5D;
+        const bool bRotation = iktype == IKP_Transform6D || iktype == IKP_Rotation3D;
+        const bool bDirection = iktype == IKP_Direction3D || iktype == IKP_TranslationDirection5D;
+        Vector vgoaltrans, vgoalrot, vgoaldir;
+        switch(iktype) {
+        case IKP_Transform6D: vgoaltrans = param.GetTransform6D().trans; vgoalrot = param.GetTransform6D().rot; break;
+        case IKP_Rotation3D: vgoalrot = param.GetRotation3D(); break;
+        case IKP_Translation3D: vgoaltrans = param.GetTranslation3D(); break;
+        case IKP_Direction3D: vgoaldir = param.GetDirection3D(); break;
+        case IKP_TranslationDirection5D: vgoaltrans = param.GetTranslationDirection5D().pos; vgoaldir = param.GetTranslationDirection5D().dir; break;
+        default: break;
+        }
+        const dReal fangleweight2 = max(table.freach*table.freach/(PI*PI), dReal(1e-4));
+        const Vector& vtooldir = _chain.GetToolDirection();
+
+        auto computedist2 = [&](int iseed) {
+            const float* ppose = &table.vposes[7*iseed];
+            dReal fdist2 = 0;
+            if( bTranslation ) {
+                const dReal dx = ppose[0]-vgoaltrans.x, dy = ppose[1]-vgoaltrans.y, dz = ppose[2]-vgoaltrans.z;
+                fdist2 += dx*dx + dy*dy + dz*dz;
+            }
+            if( bRotation ) {
+                // for small angles, angle^2 ~= 8*(1-|cos(angle/2)|)
+                const dReal fdot = RaveFabs(ppose[3]*vgoalrot.x + ppose[4]*vgoalrot.y + ppose[5]*vgoalrot.z + ppose[6]*vgoalrot.w);
+                fdist2 += fangleweight2*8*(1-min(fdot, dReal(1)));
+            }
+            if( bDirection ) {
+                const Vector vdir = quatRotate(Vector(ppose[3], ppose[4], ppose[5], ppose[6]), vtooldir);
+                fdist2 += fangleweight2*(vdir-vgoaldir).lengthsqr3();
+            }
+            return fdist2;
+        };
+
+        _vnearestheap.resize(0);
+        if( bTranslation ) {
+            const dReal vquery[3] = {vgoaltrans.x, vgoaltrans.y, vgoaltrans.z};
+            _seedindex.translationtree.Search(vquery, 1, computedist2, numnearest, _vnearestheap);
+        }
+        else if( bRotation ) {
+            // 8*(1-|q.g|) is 4 times the squared distance of q to the nearer of g and -g
+            const dReal vquery[4] = {vgoalrot.x, vgoalrot.y, vgoalrot.z, vgoalrot.w};
+            const dReal vnegquery[4] = {-vgoalrot.x, -vgoalrot.y, -vgoalrot.z, -vgoalrot.w};
+            _seedindex.rotationtree.Search(vquery, 4*fangleweight2, computedist2, numnearest, _vnearestheap);
+            _seedindex.rotationtree.Search(vnegquery, 4*fangleweight2, computedist2, numnearest, _vnearestheap);
+        }
+        else {
+            const dReal vquery[3] = {vgoaldir.x, vgoaldir.y, vgoaldir.z};
+            _seedindex.directiontree.Search(vquery, fangleweight2, computedist2, numnearest, _vnearestheap);
+        }
+        std::sort_heap(_vnearestheap.begin(), _vnearestheap.end());
+        vindices.resize(_vnearestheap.size());
+        for(size_t i = 0; i < _vnearestheap.size(); ++i) {
+            vindices[i] = _vnearestheap[i].second;
+        }
+    }
+
+    inline dReal _ComputeConfigDistSqr(const std::vector<dReal>& vconfig0, const std::vector<dReal>& vconfig1) const
+    {
+        dReal fdist2 = 0;
+        for(size_t i = 0; i < vconfig0.size(); ++i) {
+            const dReal f = _vcircular[i] ? utils::SubtractCircularAngle(vconfig0[i], vconfig1[i]) : vconfig0[i] - vconfig1[i];
+            fdist2 += f*f;
+        }
+        return fdist2;
+    }
+
+    /// \brief refines q0 and the nearest seeds of the table in parallel and returns the distinct converged configurations
+    ///
+    /// If q0 is set, the solutions are sorted by their distance to q0, otherwise by the distance of their seed to the goal.
+    void _ComputeSolutions(const IkParameterization& param, const std::vector<dReal>& q0, int numnearestseeds, int filteroptions, std::vector< std::vector<dReal> >& vsolutions)
+    {
+        vsolutions.resize(0);
+        if( !Supports(param.GetType()) ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("numericalik does not support ik type 0x%x"), param.GetType(), ORE_InvalidArguments);
+        }
+        OPENRAVE_PROFILE_SCOPE("ik.NumericalRefine");
+        const int armdof = _chain.GetArmDOF();
+        _chain.UpdateFixedJoints();
+        const SeedTable& table = _GetSeedTable();
+
+        std::vector< std::vector<dReal> > vseeds;
+        if( (int)q0.size() == armdof ) {
+            vseeds.push_back(q0);
+        }
+        std::vector<int> vnearestindices;
+        _FindNearestSeeds(table, param, numnearestseeds, vnearestindices);
+        for(int iseed : vnearestindices) {
+            vseeds.emplace_back(table.vconfigs.begin() + iseed*armdof, table.vconfigs.begin() + (iseed+1)*armdof);
+        }
+        if( vseeds.size() == 0 ) {
+            return;
+        }
+
+        // every seed is refined independently, threads take the next seed until none are left
+        std::vector<uint8_t> vconverged(vseeds.size(), 0);
+        std::atomic<int> nextseed(0);
+        const bool bIgnoreJointLimits = !!(filteroptions&IKFO_IgnoreJointLimits);
+        const std::function<void()> refineseeds = [&]() {
+            SeedRefiner refiner(_chain, _vlower, _vupper, _vcircular, bIgnoreJointLimits);
+            for(int iseed = nextseed++; iseed < (int)vseeds.size(); iseed = nextseed++) {
+                vconverged[iseed] = refiner.Refine(param, vseeds[iseed], _ferrorthresh, _nMaxIterations);
+            }
+        };
+        // there is no use for more threads than seeds, so the pool never grows past the number of seeds of the largest call
+        const int numthreads = _numthreads > 0 ? _numthreads : max(1, (int)std::thread::hardware_concurrency());
+        _workerpool.Run(min(numthreads, (int)vseeds.size()), refineseeds);
+
+        const dReal fsamesolutionthresh2 = 1e-6;
+        for(size_t iseed = 0; iseed < vseeds.size(); ++iseed) {
+            if( !vconverged[iseed] ) {
+                continue;
+            }
+            bool bSame = false;
+            for(const std::vector<dReal>& vsolution : vsolutions) {
+                if( _ComputeConfigDistSqr(vsolution, vseeds[iseed]) < fsamesolutionthresh2 ) {
+                    bSame = true;
+                    break;
+                }
+            }
+            if( !bSame ) {
+                vsolutions.push_back(vseeds[iseed]);
+            }
+        }
+        if( (int)q0.size() == armdof && vsolutions.size() > 1 ) {
+            std::vector< std::pair<dReal, int> > vdists(vsolutions.size());
+            for(size_t i = 0; i < vsolutions.size(); ++i) {
+                vdists[i] = std::make_pair(_ComputeConfigDistSqr(vsolutions[i], q0), (int)i);
+            }
+            std::stable_sort(vdists.begin(), vdists.end());
+            std::vector< std::vector<dReal> > vsorted(vsolutions.size());
+            for(size_t i = 0; i < vdists.size(); ++i) {
+                vsorted[i].swap(vsolutions[vdists[i].second]);
+            }
+            vsolutions.swap(vsorted);
+        }
+    }
+
+    /// \brief enables or disables the end effector links, disabled links keep their enable state saved in _vchildlinksenabled
+    void _SetChildLinksCheckable(bool bCheckable)
+    {
+        if( bCheckable ) {
+            for(size_t i = 0; i < _vchildlinks.size(); ++i) {
+                _vchildlinks[i]->Enable(!!_vchildlinksenabled[i]);
+            }
+        }
+        else {
+            for(const KinBody::LinkPtr& plink : _vchildlinks) {
+                plink->Enable(false);
+            }
+        }
+    }
+
+    /// \brief checks the solution with the robot kinematics, the custom filters, and the collisions
+    ///
+    /// The robot is left at the solution. paramnew is set to the ik parameterization of the solution in the manipulator base frame.
+    IkReturnAction _ValidateSolution(const IkParameterization& param, int filteroptions, std::vector<dReal>& vsolution, IkReturnPtr localret, IkParameterization& paramnew)
+    {
+        RobotBase::ManipulatorPtr pmanip(_pmanip);
+        RobotBasePtr probot = pmanip->GetRobot();
+        probot->SetActiveDOFValues(vsolution, KinBody::CLA_Nothing);
+
+        // the chain copies the kinematics of the robot, check the result with the robot itself anyway
+        paramnew = pmanip->GetIkParameterization(param, false);
+        const dReal ikworkspacedist = param.ComputeDistanceSqr(paramnew);
+        if( ikworkspacedist > _ikthreshold ) {
+            RAVELOG_VERBOSE_FORMAT("env=%s, ignoring bad numericalik for %s:%s dist=%e", GetEnv()->GetNameId()%probot->GetName()%pmanip->GetName()%RaveSqrt(ikworkspacedist));
+            return IKRA_RejectKinematicsPrecision;
+        }
+
+        if( !(filteroptions & IKFO_IgnoreCustomFilters) && _HasFilterInRange(1, IKSP_MaxPriority) ) {
+            IkReturnAction retaction = _CallFilters(vsolution, pmanip, paramnew, localret, 1, IKSP_MaxPriority);
+            if( retaction != IKRA_Success ) {
+                return static_cast<IkReturnAction>(retaction|IKRA_RejectCustomFilter);
+            }
+        }
+
+        const bool bCheckSelfCollision = !(filteroptions & IKFO_IgnoreSelfCollisions);
+        const bool bCheckEnvCollision = !!(filteroptions & IKFO_CheckEnvCollisions);
+        if( bCheckSelfCollision || bCheckEnvCollision ) {
+            _vchildlinksenabled.resize(_vchildlinks.size());
+            for(size_t i = 0; i < _vchildlinks.size(); ++i) {
+                _vchildlinksenabled[i] = _vchildlinks[i]->IsEnabled();
+            }
+        }
+        if( bCheckSelfCollision ) {
+            const bool bIgnoreEndEffector = !!(filteroptions & IKFO_IgnoreEndEffectorSelfCollisions);
+            if( bIgnoreEndEffector ) {
+                _SetChildLinksCheckable(false);
+            }
+            const bool bSelfCollision = probot->CheckSelfCollision();
+            if( bIgnoreEndEffector ) {
+                _SetChildLinksCheckable(true);
+            }
+            if( bSelfCollision ) {
+                return IKRA_RejectSelfCollision;
+            }
+        }
+        if( bCheckEnvCollision ) {
+            const bool bIgnoreEndEffector = !!(filteroptions & IKFO_IgnoreEndEffectorEnvCollisions);
+            if( bIgnoreEndEffector ) {
+                _SetChildLinksCheckable(false);
+            }
+            const bool bEnvCollision = GetEnv()->CheckCollision(KinBodyConstPtr(probot));
+            if( bIgnoreEndEffector ) {
+                _SetChildLinksCheckable(true);
+            }
+            if( bEnvCollision ) {
+                return IKRA_RejectEnvCollision;
+            }
+        }
+
+        if( !(filteroptions & IKFO_IgnoreCustomFilters) && _HasFilterInRange(IKSP_MinPriority, 0) ) {
+            IkReturnAction retaction = _CallFilters(vsolution, pmanip, paramnew, localret, IKSP_MinPriority, 0);
+            if( retaction != IKRA_Success ) {
+                return static_cast<IkReturnAction>(retaction|IKRA_RejectCustomFilter);
+            }
+        }
+        localret->_action = IKRA_Success;
+        return IKRA_Success;
+    }
+
+    RobotBase::ManipulatorWeakPtr _pmanip;
+    UserDataPtr _cblimits;
+    std::string _kinematicshash; ///< kinematics structure hash of the manipulator, names the seed table in the database
+    KinematicChain _chain;
+    SeedTableConstPtr _pseedtable; ///< loaded on the first solve, reset when the number of seeds or the limits change
+    SeedTableConstPtr _pindexedtable; ///< table _seedindex was built for
+    SeedIndex _seedindex; ///< nearest seed search structures of _pindexedtable
+    std::vector< std::pair<dReal, int> > _vnearestheap; ///< cache for _FindNearestSeeds
+    RefineWorkerPool _workerpool; ///< threads of _ComputeSolutions
+    std::vector<dReal> _vlower, _vupper; ///< arm limits
+    std::vector<uint8_t> _vcircular; ///< 1 if the arm dof is circular
+    std::vector<KinBody::LinkPtr> _vchildlinks; ///< end effector links
+    std::vector<uint8_t> _vchildlinksenabled; ///< enable state of _vchildlinks while validating a solution
+
+    dReal _ikthreshold = 1e-4; ///< squared workspace distance between the goal and the robot at the solution
+    dReal _ferrorthresh = 1e-6; ///< workspace error the refinement stops at
+    int _nMaxIterations = 100; ///< maximum refinement iterations per seed
+    int _numseeds = 10000; ///< number of seeds of the table
+    int _numnearestseeds = 8; ///< number of seeds refined by Solve, besides q0
+    int _numnearestseedsall = 64; ///< number of seeds refined by SolveAll
+    int _numthreads = 0; ///< maximum number of threads refining the seeds, 0 to use all the cores. A call never uses more threads than it has seeds
+};
+
+} // end namespace numericalik
+
+IkSolverBasePtr CreateNumericalIkSolver(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return IkSolverBasePtr(new numericalik::NumericalIkSolver(penv, sinput));
+}
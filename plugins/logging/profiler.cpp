@@ -0,0 +1,133 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "plugindefs.h"
+
+#include <sstream>
+
+#include <boost/bind/bind.hpp>
+#include <openrave/openravejson.h>
+
+using namespace boost::placeholders;
+
+/// \brief JSON command surface of the library profiling scopes and counters, see openrave/profiling.h
+class Profiler : public ModuleBase
+{
+public:
+    Profiler(EnvironmentBasePtr penv, std::istream& sinput) : ModuleBase(penv)
+    {
+        __description = "Controls and queries the timers and counters of the library hot paths: collision queries, forward kinematics, ik solves, planner iterations, constraint checks and trajectory sampling. The recording is shared by all environments of the process and every thread records into its own buffers without locking.";
+        RegisterJSONCommand("SetEnabled", boost::bind(&Profiler::_SetEnabledCommand, this, _1, _2, _3),
+                            "Enables or disables the recording. Input {\"enabled\": bool, \"reset\": bool}, reset clears the previous recording first.");
+        RegisterJSONCommand("Reset", boost::bind(&Profiler::_ResetCommand, this, _1, _2, _3),
+                            "Clears the statistics and scopes of all threads.");
+        RegisterJSONCommand("GetStatistics", boost::bind(&Profiler::_GetStatisticsCommand, this, _1, _2, _3),
+                            "Returns {\"enabled\": bool, \"statistics\": [{\"name\", \"count\", \"totalNs\", \"minNs\", \"maxNs\", \"meanNs\", \"isCounter\"}]} accumulated over all threads since the last reset.");
+        RegisterJSONCommand("GetChromeTrace", boost::bind(&Profiler::_GetChromeTraceCommand, this, _1, _2, _3),
+                            "Exports the most recent scopes of every thread as Chrome trace events. Input {\"filename\": string}, if filename is set the trace is written to the file and {\"filename\": string} is returned, otherwise the trace document is returned.");
+
+        std::string cmd;
+        while(!sinput.eof()) {
+            sinput >> cmd;
+            if( !sinput ) {
+                break;
+            }
+            std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
+            if( cmd == "enabled" ) {
+                bool bEnabled = false;
+                sinput >> bEnabled;
+                RaveSetProfilingEnabled(bEnabled);
+            }
+            else {
+                RAVELOG_WARN_FORMAT("env=%s, unrecognized profiler argument %s", GetEnv()->GetNameId()%cmd);
+                break;
+            }
+        }
+    }
+
+protected:
+    bool _SetEnabledCommand(const rapidjson::Value& input, rapidjson::Value& output, rapidjson::Document::AllocatorType& alloc)
+    {
+        if( orjson::GetJsonValueByKey<bool>(input, "reset", false) ) {
+            RaveResetProfiling();
+        }
+        RaveSetProfilingEnabled(orjson::GetJsonValueByKey<bool>(input, "enabled", true));
+        output.SetObject();
+        orjson::SetJsonValueByKey(output, "enabled", RaveIsProfilingEnabled(), alloc);
+        return true;
+    }
+
+    bool _ResetCommand(const rapidjson::Value& input, rapidjson::Value& output, rapidjson::Document::AllocatorType& alloc)
+    {
+        RaveResetProfiling();
+        output.SetObject();
+        return true;
+    }
+
+    bool _GetStatisticsCommand(const rapidjson::Value& input, rapidjson::Value& output, rapidjson::Document::AllocatorType& alloc)
+    {
+        std::vector<ProfileStatistics> vstatistics;
+        RaveGetProfileStatistics(vstatistics);
+        output.SetObject();
+        orjson::SetJsonValueByKey(output, "enabled", RaveIsProfilingEnabled(), alloc);
+        rapidjson::Value rStatistics(rapidjson::kArrayType);
+        rStatistics.Reserve(vstatistics.size(), alloc);
+        for(const ProfileStatistics& statistics : vstatistics) {
+            rapidjson::Value rStatistic(rapidjson::kObjectType);
+            orjson::SetJsonValueByKey(rStatistic, "name", statistics.name, alloc);
+            orjson::SetJsonValueByKey(rStatistic, "count", statistics.count, alloc);
+            orjson::SetJsonValueByKey(rStatistic, "isCounter", statistics.bcounter, alloc);
+            if( !statistics.bcounter ) {
+                orjson::SetJsonValueByKey(rStatistic, "totalNs", statistics.totalns, alloc);
+                orjson::SetJsonValueByKey(rStatistic, "minNs", statistics.minns, alloc);
+                orjson::SetJsonValueByKey(rStatistic, "maxNs", statistics.maxns, alloc);
+                orjson::SetJsonValueByKey(rStatistic, "meanNs", statistics.count > 0 ? (double)statistics.totalns/(double)statistics.count : 0.0, alloc);
+            }
+            rStatistics.PushBack(rStatistic, alloc);
+        }
+        output.AddMember("statistics", rStatistics, alloc);
+        return true;
+    }
+
+    bool _GetChromeTraceCommand(const rapidjson::Value& input, rapidjson::Value& output, rapidjson::Document::AllocatorType& alloc)
+    {
+        std::string filename = orjson::GetJsonValueByKey<std::string>(input, "filename", std::string());
+        if( filename.size() > 0 ) {
+            std::ofstream f(filename.c_str());
+            if( !f ) {
+                throw OPENRAVE_EXCEPTION_FORMAT("env=%s, failed to open %s for writing the profiling trace", GetEnv()->GetNameId()%filename, ORE_InvalidArguments);
+            }
+            RaveWriteProfileChromeTrace(f);
+            output.SetObject();
+            orjson::SetJsonValueByKey(output, "filename", filename, alloc);
+            return true;
+        }
+
+        std::stringstream ss;
+        RaveWriteProfileChromeTrace(ss);
+        rapidjson::Document doc;
+        doc.Parse(ss.str().c_str());
+        if( doc.HasParseError() ) {
+            throw OPENRAVE_EXCEPTION_FORMAT("env=%s, failed to parse the profiling trace", GetEnv()->GetNameId(), ORE_Assert);
+        }
+        output.CopyFrom(doc, alloc);
+        return true;
+    }
+};
+
+ModuleBasePtr CreateProfiler(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return ModuleBasePtr(new Profiler(penv,sinput));
+}
@@ -0,0 +1,1029 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "plugindefs.h"
+#include "staterecordformat.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include <boost/bind/bind.hpp>
+
+using namespace boost::placeholders;
+
+namespace staterecorder {
+
+/// \brief recorded state of one body
+struct BodyState
+{
+    int id = 0; ///< environment body index
+    std::string name;
+    std::vector<Transform> vLinkTransforms;
+    std::vector<dReal> vDOFValues, vDOFVelocities;
+    std::vector< std::pair<int32_t, int32_t> > vGrabbed; ///< environment body index of the grabbed body and index of the grabbing link
+};
+
+/// \brief recorded state of the environment at one timestamp
+struct FrameState
+{
+    uint64_t timestamp = 0;
+    std::vector<BodyState> vbodies; ///< sorted by id
+};
+
+typedef boost::shared_ptr<FrameState> FrameStatePtr;
+
+static bool _IsSameBodyStructure(const BodyState& state0, const BodyState& state1)
+{
+    return state0.name == state1.name && state0.vLinkTransforms.size() == state1.vLinkTransforms.size() && state0.vDOFValues.size() == state1.vDOFValues.size();
+}
+
+static bool _IsSameValue(const Transform& t0, const Transform& t1)
+{
+    return t0.rot.x == t1.rot.x && t0.rot.y == t1.rot.y && t0.rot.z == t1.rot.z && t0.rot.w == t1.rot.w && t0.trans.x == t1.trans.x && t0.trans.y == t1.trans.y && t0.trans.z == t1.trans.z;
+}
+
+static bool _IsSameValue(dReal f0, dReal f1)
+{
+    return f0 == f1;
+}
+
+/// \brief encodes frames into chunks and writes them to a file. Not thread safe.
+class StateLogWriter
+{
+public:
+    StateLogWriter() : _nMaxChunkFrames(100), _nMaxChunkBytes(1<<20), _nFileOffset(0), _bWriteError(false) {
+        memset(&_chunkheader, 0, sizeof(_chunkheader));
+    }
+    ~StateLogWriter() {
+        Close();
+    }
+
+    bool Open(const std::string& filename, uint32_t maxchunkframes, uint64_t maxchunkbytes)
+    {
+        Close();
+        _ofile.open(filename.c_str(), std::ios::binary|std::ios::trunc);
+        if( !_ofile ) {
+            return false;
+        }
+        _nMaxChunkFrames = std::max(maxchunkframes, (uint32_t)1);
+        _nMaxChunkBytes = maxchunkbytes;
+        _nFileOffset = 0;
+        _bWriteError = false;
+        _vindex.resize(0);
+        _vchunkdata.resize(0);
+        _vprevbodies.resize(0);
+        memset(&_chunkheader, 0, sizeof(_chunkheader));
+
+        StateLogHeader header;
+        memcpy(header.magic, STATELOG_MAGIC, sizeof(header.magic));
+        header.version = STATELOG_VERSION;
+        header.realsize = sizeof(dReal);
+        return _WriteFile(&header, sizeof(header));
+    }
+
+    bool IsOpen() const {
+        return _ofile.is_open();
+    }
+
+    /// \brief encodes the frame into the current chunk, writes the chunk once it is full
+    void AddFrame(const FrameState& frame)
+    {
+        if( _chunkheader.numframes == 0 ) {
+            // keyframe, encode against an empty environment
+            _vprevbodies.resize(0);
+            _chunkheader.starttimestamp = frame.timestamp;
+        }
+        _EncodeFrame(frame);
+        _chunkheader.endtimestamp = frame.timestamp;
+        _chunkheader.numframes++;
+        // reuses the capacity of the previous body states
+        _vprevbodies = frame.vbodies;
+        if( _chunkheader.numframes >= _nMaxChunkFrames || _vchunkdata.size() >= _nMaxChunkBytes ) {
+            FlushChunk();
+        }
+    }
+
+    /// \brief writes the current chunk even if it is not full, so that a crash loses at most the frames after the call
+    void FlushChunk()
+    {
+        if( _chunkheader.numframes == 0 ) {
+            return;
+        }
+        StateLogIndexEntry entry;
+        entry.offset = _nFileOffset;
+        entry.starttimestamp = _chunkheader.starttimestamp;
+        entry.endtimestamp = _chunkheader.endtimestamp;
+        _chunkheader.magic = STATELOG_CHUNK_MAGIC;
+        _chunkheader.payloadsize = _vchunkdata.size();
+        if( _WriteFile(&_chunkheader, sizeof(_chunkheader)) && _WriteFile(_vchunkdata.data(), _vchunkdata.size()) ) {
+            _ofile.flush();
+            _vindex.push_back(entry);
+        }
+        _vchunkdata.resize(0);
+        _chunkheader.numframes = 0;
+    }
+
+    /// \brief writes the remaining frames and the chunk index
+    void Close()
+    {
+        if( !_ofile.is_open() ) {
+            return;
+        }
+        FlushChunk();
+        StateLogIndexFooter footer;
+        footer.indexoffset = _nFileOffset;
+        footer.numchunks = _vindex.size();
+        footer.magic = STATELOG_INDEX_MAGIC;
+        if( _vindex.size() > 0 ) {
+            _WriteFile(_vindex.data(), _vindex.size()*sizeof(StateLogIndexEntry));
+        }
+        _WriteFile(&footer, sizeof(footer));
+        _ofile.close();
+    }
+
+    uint64_t GetNumBytesWritten() const {
+        return _nFileOffset;
+    }
+    size_t GetNumChunks() const {
+        return _vindex.size();
+    }
+    bool HasWriteError() const {
+        return _bWriteError;
+    }
+
+private:
+    void _EncodeFrame(const FrameState& frame)
+    {
+        _Append(frame.timestamp);
+
+        // match the bodies against the previous frame. Bodies that changed name or structure under the same id are removed and added again
+        _vremovedids.resize(0);
+        _vpprevstates.resize(frame.vbodies.size());
+        size_t iprev = 0;
+        for(size_t ibody = 0; ibody < frame.vbodies.size(); ++ibody) {
+            const BodyState& state = frame.vbodies[ibody];
+            while( iprev < _vprevbodies.size() && _vprevbodies[iprev].id < state.id ) {
+                _vremovedids.push_back(_vprevbodies[iprev].id);
+                ++iprev;
+            }
+            _vpprevstates[ibody] = NULL;
+            if( iprev < _vprevbodies.size() && _vprevbodies[iprev].id == state.id ) {
+                if( _IsSameBodyStructure(_vprevbodies[iprev], state) ) {
+                    _vpprevstates[ibody] = &_vprevbodies[iprev];
+                }
+                else {
+                    _vremovedids.push_back(state.id);
+                }
+                ++iprev;
+            }
+        }
+        for(; iprev < _vprevbodies.size(); ++iprev) {
+            _vremovedids.push_back(_vprevbodies[iprev].id);
+        }
+
+        _Append((uint32_t)_vremovedids.size());
+        FOREACHC(itid, _vremovedids) {
+            _Append((int32_t)*itid);
+        }
+
+        uint32_t numadded = 0;
+        for(size_t ibody = 0; ibody < frame.vbodies.size(); ++ibody) {
+            numadded += !_vpprevstates[ibody];
+        }
+        _Append(numadded);
+        for(size_t ibody = 0; ibody < frame.vbodies.size(); ++ibody) {
+            if( !_vpprevstates[ibody] ) {
+                const BodyState& state = frame.vbodies[ibody];
+                _Append((int32_t)state.id);
+                _Append((uint16_t)state.name.size());
+                _Append(state.name.c_str(), state.name.size());
+                _Append((uint32_t)state.vLinkTransforms.size());
+                _Append((uint32_t)state.vDOFValues.size());
+            }
+        }
+
+        size_t numchangedoffset = _vchunkdata.size();
+        uint32_t numchanged = 0;
+        _Append(numchanged);
+        for(size_t ibody = 0; ibody < frame.vbodies.size(); ++ibody) {
+            if( _EncodeBody(frame.vbodies[ibody], _vpprevstates[ibody]) ) {
+                ++numchanged;
+            }
+        }
+        memcpy(&_vchunkdata[numchangedoffset], &numchanged, sizeof(numchanged));
+    }
+
+    /// \brief encodes the values of state that differ from pprev, or all the values if pprev is NULL
+    /// \return false if nothing changed, in which case nothing is written
+    bool _EncodeBody(const BodyState& state, const BodyState* pprev)
+    {
+        size_t startoffset = _vchunkdata.size();
+        _Append((int32_t)state.id);
+        uint8_t flags = 0;
+        _Append(flags);
+        if( _AppendChangedValues(state.vLinkTransforms, !!pprev ? &pprev->vLinkTransforms : NULL) ) {
+            flags |= STATELOG_BODY_LINKTRANSFORMS;
+        }
+        if( _AppendChangedValues(state.vDOFValues, !!pprev ? &pprev->vDOFValues : NULL) ) {
+            flags |= STATELOG_BODY_DOFVALUES;
+        }
+        if( _AppendChangedValues(state.vDOFVelocities, !!pprev ? &pprev->vDOFVelocities : NULL) ) {
+            flags |= STATELOG_BODY_DOFVELOCITIES;
+        }
+        if( (!pprev && state.vGrabbed.size() > 0) || (!!pprev && pprev->vGrabbed != state.vGrabbed) ) {
+            _Append((uint32_t)state.vGrabbed.size());
+            FOREACHC(itgrabbed, state.vGrabbed) {
+                _Append(itgrabbed->first);
+                _Append(itgrabbed->second);
+            }
+            flags |= STATELOG_BODY_GRABBED;
+        }
+        if( flags == 0 ) {
+            _vchunkdata.resize(startoffset);
+            return false;
+        }
+        _vchunkdata[startoffset+sizeof(int32_t)] = flags;
+        return true;
+    }
+
+    /// \brief appends a bitmask of the changed values followed by the changed values
+    /// \return false if no value changed, in which case nothing is written
+    template <typename T>
+    bool _AppendChangedValues(const std::vector<T>& vvalues, const std::vector<T>* pvprevvalues)
+    {
+        size_t maskoffset = _vchunkdata.size();
+        _vchunkdata.resize(maskoffset + (vvalues.size()+7)/8, 0);
+        bool bChanged = false;
+        for(size_t i = 0; i < vvalues.size(); ++i) {
+            if( !pvprevvalues || !_IsSameValue(vvalues[i], pvprevvalues->at(i)) ) {
+                _vchunkdata[maskoffset + i/8] |= (uint8_t)(1<<(i%8));
+                _AppendValue(vvalues[i]);
+                bChanged = true;
+            }
+        }
+        if( !bChanged ) {
+            _vchunkdata.resize(maskoffset);
+        }
+        return bChanged;
+    }
+
+    void _AppendValue(const Transform& t)
+    {
+        const dReal values[7] = {t.rot.x, t.rot.y, t.rot.z, t.rot.w, t.trans.x, t.trans.y, t.trans.z};
+        _Append(values, sizeof(values));
+    }
+    void _AppendValue(dReal f)
+    {
+        _Append(f);
+    }
+
+    template <typename T>
+    void _Append(const T& value)
+    {
+        _Append(&value, sizeof(value));
+    }
+    void _Append(const void* pdata, size_t size)
+    {
+        const uint8_t* pbytes = reinterpret_cast<const uint8_t*>(pdata);
+        _vchunkdata.insert(_vchunkdata.end(), pbytes, pbytes+size);
+    }
+
+    bool _WriteFile(const void* pdata, size_t size)
+    {
+        if( _bWriteError ) {
+            return false;
+        }
+        _ofile.write(reinterpret_cast<const char*>(pdata), size);
+        if( !_ofile ) {
+            RAVELOG_ERROR("failed to write state log, dropping the remaining frames\n");
+            _bWriteError = true;
+            return false;
+        }
+        _nFileOffset += size;
+        return true;
+    }
+
+    std::ofstream _ofile;
+    uint32_t _nMaxChunkFrames;
+    uint64_t _nMaxChunkBytes;
+    uint64_t _nFileOffset;
+    bool _bWriteError;
+    StateLogChunkHeader _chunkheader; ///< header of the chunk being encoded
+    std::vector<uint8_t> _vchunkdata; ///< encoded frames of the current chunk
+    std::vector<StateLogIndexEntry> _vindex;
+    std::vector<BodyState> _vprevbodies; ///< state of the last encoded frame
+
+    // cache
+    std::vector<int> _vremovedids;
+    std::vector<const BodyState*> _vpprevstates;
+};
+
+/// \brief reads state logs, seeking through the chunk index
+class StateLogReader
+{
+public:
+    StateLogReader() : _realsize(0), _nCachedChunkIndex(-1) {
+    }
+
+    bool Open(const std::string& filename)
+    {
+        Close();
+        _ifile.open(filename.c_str(), std::ios::binary);
+        if( !_ifile ) {
+            return false;
+        }
+        _ifile.seekg(0, std::ios::end);
+        uint64_t filesize = _ifile.tellg();
+        _ifile.seekg(0, std::ios::beg);
+
+        StateLogHeader header;
+        if( !_ReadFile(&header, sizeof(header)) || memcmp(header.magic, STATELOG_MAGIC, sizeof(header.magic)) != 0 || header.version != STATELOG_VERSION || (header.realsize != sizeof(float) && header.realsize != sizeof(double)) ) {
+            RAVELOG_WARN_FORMAT("%s is not a valid state log", filename);
+            Close();
+            return false;
+        }
+        _realsize = header.realsize;
+
+        StateLogIndexFooter footer;
+        if( filesize >= sizeof(header) + sizeof(footer) ) {
+            _ifile.seekg(filesize - sizeof(footer), std::ios::beg);
+            if( _ReadFile(&footer, sizeof(footer)) && footer.magic == STATELOG_INDEX_MAGIC && footer.indexoffset + footer.numchunks*sizeof(StateLogIndexEntry) + sizeof(footer) == filesize ) {
+                _vindex.resize(footer.numchunks);
+                _ifile.seekg(footer.indexoffset, std::ios::beg);
+                if( _vindex.size() == 0 || _ReadFile(_vindex.data(), _vindex.size()*sizeof(StateLogIndexEntry)) ) {
+                    return true;
+                }
+            }
+        }
+
+        // recorder did not stop cleanly, so rebuild the index from the chunk headers. A partially written last chunk is ignored.
+        RAVELOG_INFO_FORMAT("%s has no chunk index, scanning chunks", filename);
+        _vindex.resize(0);
+        _ifile.clear();
+        uint64_t offset = sizeof(header);
+        StateLogChunkHeader chunkheader;
+        while( offset + sizeof(chunkheader) <= filesize ) {
+            _ifile.seekg(offset, std::ios::beg);
+            if( !_ReadFile(&chunkheader, sizeof(chunkheader)) || chunkheader.magic != STATELOG_CHUNK_MAGIC || offset + sizeof(chunkheader) + chunkheader.payloadsize > filesize ) {
+                break;
+            }
+            StateLogIndexEntry entry;
+            entry.offset = offset;
+            entry.starttimestamp = chunkheader.starttimestamp;
+            entry.endtimestamp = chunkheader.endtimestamp;
+            _vindex.push_back(entry);
+            offset += sizeof(chunkheader) + chunkheader.payloadsize;
+        }
+        return true;
+    }
+
+    void Close()
+    {
+        if( _ifile.is_open() ) {
+            _ifile.close();
+        }
+        _ifile.clear();
+        _vindex.resize(0);
+        _vchunkdata.resize(0);
+        _nCachedChunkIndex = -1;
+    }
+
+    bool IsOpen() const {
+        return _ifile.is_open();
+    }
+
+    const std::vector<StateLogIndexEntry>& GetIndex() const {
+        return _vindex;
+    }
+
+    /// \brief decodes the last recorded frame at or before timestamp
+    ///
+    /// \return false if there is no frame before timestamp or the log is corrupted
+    bool ReadFrame(uint64_t timestamp, FrameState& frame)
+    {
+        // last chunk starting at or before timestamp
+        std::vector<StateLogIndexEntry>::const_iterator itentry = std::upper_bound(_vindex.begin(), _vindex.end(), timestamp, [](uint64_t t, const StateLogIndexEntry& entry) {
+            return t < entry.starttimestamp;
+        });
+        if( itentry == _vindex.begin() ) {
+            return false;
+        }
+        --itentry;
+        if( !_LoadChunk(itentry - _vindex.begin()) ) {
+            return false;
+        }
+
+        _mapbodies.clear();
+        size_t offset = 0;
+        uint64_t frametimestamp = 0;
+        bool bDecoded = false;
+        while( offset < _vchunkdata.size() ) {
+            uint64_t nexttimestamp = 0;
+            size_t peekoffset = offset;
+            if( !_Read(peekoffset, nexttimestamp) ) {
+                return false;
+            }
+            if( bDecoded && nexttimestamp > timestamp ) {
+                break;
+            }
+            if( !_DecodeFrame(offset, frametimestamp) ) {
+                RAVELOG_WARN_FORMAT("state log chunk at offset %d is corrupted", itentry->offset);
+                return false;
+            }
+            bDecoded = true;
+        }
+
+        frame.timestamp = frametimestamp;
+        frame.vbodies.resize(0);
+        frame.vbodies.reserve(_mapbodies.size());
+        FOREACHC(itbody, _mapbodies) {
+            frame.vbodies.push_back(itbody->second);
+        }
+        return true;
+    }
+
+private:
+    bool _LoadChunk(int ichunk)
+    {
+        if( _nCachedChunkIndex == ichunk ) {
+            return true;
+        }
+        _nCachedChunkIndex = -1;
+        StateLogChunkHeader chunkheader;
+        _ifile.clear();
+        _ifile.seekg(_vindex.at(ichunk).offset, std::ios::beg);
+        if( !_ReadFile(&chunkheader, sizeof(chunkheader)) || chunkheader.magic != STATELOG_CHUNK_MAGIC ) {
+            return false;
+        }
+        _vchunkdata.resize(chunkheader.payloadsize);
+        if( !_ReadFile(_vchunkdata.data(), _vchunkdata.size()) ) {
+            return false;
+        }
+        _nCachedChunkIndex = ichunk;
+        return true;
+    }
+
+    /// \brief applies the frame at offset to _mapbodies and advances offset
+    bool _DecodeFrame(size_t& offset, uint64_t& timestamp)
+    {
+        if( !_Read(offset, timestamp) ) {
+            return false;
+        }
+        uint32_t num = 0;
+        if( !_Read(offset, num) ) {
+            return false;
+        }
+        for(uint32_t i = 0; i < num; ++i) {
+            int32_t id = 0;
+            if( !_Read(offset, id) ) {
+                return false;
+            }
+            _mapbodies.erase(id);
+        }
+
+        if( !_Read(offset, num) ) {
+            return false;
+        }
+        for(uint32_t i = 0; i < num; ++i) {
+            int32_t id = 0;
+            uint16_t namelength = 0;
+            uint32_t numlinks = 0, numdofs = 0;
+            if( !_Read(offset, id) || !_Read(offset, namelength) || offset + namelength > _vchunkdata.size() ) {
+                return false;
+            }
+            BodyState& state = _mapbodies[id];
+            state.id = id;
+            state.name.assign(reinterpret_cast<const char*>(&_vchunkdata[offset]), namelength);
+            offset += namelength;
+            if( !_Read(offset, numlinks) || !_Read(offset, numdofs) ) {
+                return false;
+            }
+            state.vLinkTransforms.resize(numlinks);
+            state.vDOFValues.resize(numdofs);
+            state.vDOFVelocities.resize(numdofs);
+            state.vGrabbed.resize(0);
+        }
+
+        if( !_Read(offset, num) ) {
+            return false;
+        }
+        for(uint32_t i = 0; i < num; ++i) {
+            int32_t id = 0;
+            uint8_t flags = 0;
+            if( !_Read(offset, id) || !_Read(offset, flags) ) {
+                return false;
+            }
+            std::map<int, BodyState>::iterator itbody = _mapbodies.find(id);
+            if( itbody == _mapbodies.end() ) {
+                return false;
+            }
+            BodyState& state = itbody->second;
+            if( (flags & STATELOG_BODY_LINKTRANSFORMS) && !_ReadChangedValues(offset, state.vLinkTransforms) ) {
+                return false;
+            }
+            if( (flags & STATELOG_BODY_DOFVALUES) && !_ReadChangedValues(offset, state.vDOFValues) ) {
+                return false;
+            }
+            if( (flags & STATELOG_BODY_DOFVELOCITIES) && !_ReadChangedValues(offset, state.vDOFVelocities) ) {
+                return false;
+            }
+            if( flags & STATELOG_BODY_GRABBED ) {
+                uint32_t numgrabbed = 0;
+                if( !_Read(offset, numgrabbed) || offset + numgrabbed*2*sizeof(int32_t) > _vchunkdata.size() ) {
+                    return false;
+                }
+                state.vGrabbed.resize(numgrabbed);
+                FOREACH(itgrabbed, state.vGrabbed) {
+                    _Read(offset, itgrabbed->first);
+                    _Read(offset, itgrabbed->second);
+                }
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool _ReadChangedValues(size_t& offset, std::vector<T>& vvalues)
+    {
+        size_t maskoffset = offset;
+        offset += (vvalues.size()+7)/8;
+        if( offset > _vchunkdata.size() ) {
+            return false;
+        }
+        for(size_t i = 0; i < vvalues.size(); ++i) {
+            if( (_vchunkdata[maskoffset + i/8] & (1<<(i%8))) && !_ReadValue(offset, vvalues[i]) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool _ReadValue(size_t& offset, Transform& t)
+    {
+        return _ReadReal(offset, t.rot.x) && _ReadReal(offset, t.rot.y) && _ReadReal(offset, t.rot.z) && _ReadReal(offset, t.rot.w) && _ReadReal(offset, t.trans.x) && _ReadReal(offset, t.trans.y) && _ReadReal(offset, t.trans.z);
+    }
+    bool _ReadValue(size_t& offset, dReal& f)
+    {
+        return _ReadReal(offset, f);
+    }
+
+    /// \brief reads a real with the precision of the recording machine
+    bool _ReadReal(size_t& offset, dReal& f)
+    {
+        if( _realsize == sizeof(float) ) {
+            float value = 0;
+            if( !_Read(offset, value) ) {
+                return false;
+            }
+            f = value;
+            return true;
+        }
+        double value = 0;
+        if( !_Read(offset, value) ) {
+            return false;
+        }
+        f = value;
+        return true;
+    }
+
+    template <typename T>
+    bool _Read(size_t& offset, T& value)
+    {
+        if( offset + sizeof(T) > _vchunkdata.size() ) {
+            return false;
+        }
+        memcpy(&value, &_vchunkdata[offset], sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    bool _ReadFile(void* pdata, size_t size)
+    {
+        _ifile.read(reinterpret_cast<char*>(pdata), size);
+        return !!_ifile;
+    }
+
+    std::ifstream _ifile;
+    uint32_t _realsize;
+    std::vector<StateLogIndexEntry> _vindex;
+    std::vector<uint8_t> _vchunkdata; ///< payload of the chunk _nCachedChunkIndex
+    int _nCachedChunkIndex;
+    std::map<int, BodyState> _mapbodies; ///< decoded state, indexed by id
+};
+
+} // end namespace staterecorder
+
+using namespace staterecorder;
+
+/// \brief records the environment state into delta-encoded chunked logs and restores it from them
+///
+/// Capturing only copies the state into a preallocated frame pool on the calling thread, encoding and writing happen on a background thread.
+/// When the writer falls behind and the pool runs out, new frames are dropped instead of blocking the caller.
+class StateRecorder : public ModuleBase
+{
+public:
+    StateRecorder(EnvironmentBasePtr penv, std::istream& sinput) : ModuleBase(penv)
+    {
+        __description = "Records the state of the environment (link transforms, dof values and velocities, grabbed bodies, added and removed bodies) into a compact delta-encoded binary log, and restores the environment to any recorded timestamp. Frames are captured every simulation step once the module is added to the environment, or explicitly with Record. Encoding and file writing happen on a background thread with a bounded number of buffered frames so that recording never stalls the caller.";
+        RegisterCommand("Start",boost::bind(&StateRecorder::_StartCommand,this,_1,_2),
+                        "Starts recording into a file, stopping any previous recording. Format::\n\n  Start [chunkframes N] [chunkbytes N] [maxbufferedframes N] [timing simtime/realtime] [everystep 0/1] filename [filename]\\n\n\nThe filename is read until the end of the line.");
+        RegisterCommand("Stop",boost::bind(&StateRecorder::_StopCommand,this,_1,_2),
+                        "Writes the buffered frames and the chunk index and closes the file. Format::\n\n  Stop\n\n");
+        RegisterCommand("Record",boost::bind(&StateRecorder::_RecordCommand,this,_1,_2),
+                        "Captures one frame of the current environment state. Format::\n\n  Record [timestamp]\n\nIf the timestamp (us) is not given, the recording timing is used.");
+        RegisterCommand("GetStatistics",boost::bind(&StateRecorder::_GetStatisticsCommand,this,_1,_2),
+                        "Returns the number of captured frames, dropped frames, written chunks and written bytes of the current recording.");
+        RegisterCommand("Open",boost::bind(&StateRecorder::_OpenCommand,this,_1,_2),
+                        "Opens a log for restoring. Format::\n\n  Open filename\n\nLogs of recordings that were not stopped cleanly are indexed by scanning their chunks.");
+        RegisterCommand("GetTimeRange",boost::bind(&StateRecorder::_GetTimeRangeCommand,this,_1,_2),
+                        "Returns the first and last timestamps (us) of the opened log.");
+        RegisterCommand("Restore",boost::bind(&StateRecorder::_RestoreCommand,this,_1,_2),
+                        "Sets the bodies of the environment to the last frame of the opened log at or before the timestamp. Bodies are matched by name. Format::\n\n  Restore timestamp\n\nReturns the timestamp of the restored frame.");
+        _bRecording = false;
+        _nRecordingId = 0;
+        _bRecordEveryStep = true;
+        _bUseSimulationTime = true;
+        _bContinueThread = true;
+        _bWriterBusy = false;
+        _nMaxBufferedFrames = 64;
+        _nCapturedFrames = _nDroppedFrames = 0;
+        _threadwrite = boost::make_shared<std::thread>(std::bind(&StateRecorder::_WriteThread, this));
+    }
+    virtual ~StateRecorder()
+    {
+        _StopRecording();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _bContinueThread = false;
+            _condnewframe.notify_all();
+        }
+        _threadwrite->join();
+    }
+
+    virtual void Destroy() {
+        _StopRecording();
+        _reader.Close();
+    }
+
+    virtual bool SimulationStep(dReal fElapsedTime)
+    {
+        if( _bRecordEveryStep ) {
+            _CaptureFrame(_GetTimestamp());
+        }
+        return false;
+    }
+
+protected:
+    bool _StartCommand(ostream& sout, istream& sinput)
+    {
+        uint32_t chunkframes = 100;
+        uint64_t chunkbytes = 1<<20;
+        size_t maxbufferedframes = 64;
+        bool bUseSimulationTime = true, bRecordEveryStep = true;
+        std::string filename;
+        string cmd;
+        while(!sinput.eof()) {
+            sinput >> cmd;
+            if( !sinput ) {
+                break;
+            }
+            std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
+            if( cmd == "chunkframes" ) {
+                sinput >> chunkframes;
+            }
+            else if( cmd == "chunkbytes" ) {
+                sinput >> chunkbytes;
+            }
+            else if( cmd == "maxbufferedframes" ) {
+                sinput >> maxbufferedframes;
+            }
+            else if( cmd == "timing" ) {
+                string type;
+                sinput >> type;
+                if( type == "simtime" ) {
+                    bUseSimulationTime = true;
+                }
+                else if( type == "realtime" ) {
+                    bUseSimulationTime = false;
+                }
+                else {
+                    RAVELOG_WARN_FORMAT("env=%s, unknown timing %s", GetEnv()->GetNameId()%type);
+                }
+            }
+            else if( cmd == "everystep" ) {
+                sinput >> bRecordEveryStep;
+            }
+            else if( cmd == "filename" ) {
+                if( !getline(sinput, filename) ) {
+                    return false;
+                }
+                boost::trim(filename);
+            }
+            else {
+                RAVELOG_WARN_FORMAT("env=%s, unrecognized command: %s", GetEnv()->GetNameId()%cmd);
+                return false;
+            }
+            if( sinput.fail() || !sinput ) {
+                break;
+            }
+        }
+        if( filename.size() == 0 ) {
+            RAVELOG_WARN_FORMAT("env=%s, no filename given to record to", GetEnv()->GetNameId());
+            return false;
+        }
+
+        EnvironmentLock lockenv(GetEnv()->GetMutex());
+        _StopRecording();
+        {
+            std::lock_guard<std::mutex> lockwriter(_mutexwriter);
+            if( !_writer.Open(filename, chunkframes, chunkbytes) ) {
+                RAVELOG_WARN_FORMAT("env=%s, failed to open %s for recording", GetEnv()->GetNameId()%filename);
+                return false;
+            }
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _nMaxBufferedFrames = std::max(maxbufferedframes, (size_t)1);
+        // preallocate the pool so that capturing does not allocate frames
+        while( _listFreeFrames.size() < _nMaxBufferedFrames ) {
+            _listFreeFrames.push_back(boost::make_shared<FrameState>());
+        }
+        _listFreeFrames.resize(_nMaxBufferedFrames);
+        _bUseSimulationTime = bUseSimulationTime;
+        _bRecordEveryStep = bRecordEveryStep;
+        _nCapturedFrames = _nDroppedFrames = 0;
+        _bRecording = true;
+        ++_nRecordingId;
+        RAVELOG_INFO_FORMAT("env=%s, recording state to %s", GetEnv()->GetNameId()%filename);
+        return true;
+    }
+
+    bool _StopCommand(ostream& sout, istream& sinput)
+    {
+        EnvironmentLock lockenv(GetEnv()->GetMutex());
+        _StopRecording();
+        return true;
+    }
+
+    bool _RecordCommand(ostream& sout, istream& sinput)
+    {
+        uint64_t timestamp = 0;
+        sinput >> timestamp;
+        if( !sinput ) {
+            timestamp = _GetTimestamp();
+        }
+        EnvironmentLock lockenv(GetEnv()->GetMutex());
+        return _CaptureFrame(timestamp);
+    }
+
+    bool _GetStatisticsCommand(ostream& sout, istream& sinput)
+    {
+        uint64_t numcaptured, numdropped;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            numcaptured = _nCapturedFrames;
+            numdropped = _nDroppedFrames;
+        }
+        std::lock_guard<std::mutex> lockwriter(_mutexwriter);
+        sout << numcaptured << " " << numdropped << " " << _writer.GetNumChunks() << " " << _writer.GetNumBytesWritten();
+        return true;
+    }
+
+    bool _OpenCommand(ostream& sout, istream& sinput)
+    {
+        std::string filename;
+        if( !getline(sinput, filename) ) {
+            return false;
+        }
+        boost::trim(filename);
+        return _reader.Open(filename);
+    }
+
+    bool _GetTimeRangeCommand(ostream& sout, istream& sinput)
+    {
+        if( !_reader.IsOpen() || _reader.GetIndex().size() == 0 ) {
+            return false;
+        }
+        sout << _reader.GetIndex().front().starttimestamp << " " << _reader.GetIndex().back().endtimestamp;
+        return true;
+    }
+
+    bool _RestoreCommand(ostream& sout, istream& sinput)
+    {
+        uint64_t timestamp = 0;
+        sinput >> timestamp;
+        if( !sinput || !_reader.IsOpen() ) {
+            return false;
+        }
+        if( !_reader.ReadFrame(timestamp, _restoreframe) ) {
+            RAVELOG_WARN_FORMAT("env=%s, no recorded frame at or before timestamp %d", GetEnv()->GetNameId()%timestamp);
+            return false;
+        }
+
+        EnvironmentLock lockenv(GetEnv()->GetMutex());
+        // map the recorded ids to the bodies of this environment
+        std::map<int, KinBodyPtr> mapidbodies;
+        FOREACHC(itstate, _restoreframe.vbodies) {
+            KinBodyPtr pbody = GetEnv()->GetKinBody(itstate->name);
+            if( !pbody ) {
+                RAVELOG_WARN_FORMAT("env=%s, recorded body %s is not in the environment, skipping", GetEnv()->GetNameId()%itstate->name);
+                continue;
+            }
+            if( pbody->GetLinks().size() != itstate->vLinkTransforms.size() || pbody->GetDOF() != (int)itstate->vDOFValues.size() ) {
+                RAVELOG_WARN_FORMAT("env=%s, body %s has %d links and %d dofs, but was recorded with %d links and %d dofs, skipping", GetEnv()->GetNameId()%itstate->name%pbody->GetLinks().size()%pbody->GetDOF()%itstate->vLinkTransforms.size()%itstate->vDOFValues.size());
+                continue;
+            }
+            mapidbodies[itstate->id] = pbody;
+        }
+
+        FOREACHC(itstate, _restoreframe.vbodies) {
+            std::map<int, KinBodyPtr>::iterator itbody = mapidbodies.find(itstate->id);
+            if( itbody == mapidbodies.end() ) {
+                continue;
+            }
+            KinBodyPtr pbody = itbody->second;
+            pbody->SetLinkTransformations(itstate->vLinkTransforms, itstate->vDOFValues);
+            if( itstate->vDOFVelocities.size() > 0 ) {
+                pbody->SetDOFVelocities(itstate->vDOFVelocities, KinBody::CLA_Nothing);
+            }
+        }
+
+        // grabs are restored once all the bodies are in place since grabbing stores the relative transforms
+        FOREACHC(itstate, _restoreframe.vbodies) {
+            std::map<int, KinBodyPtr>::iterator itbody = mapidbodies.find(itstate->id);
+            if( itbody == mapidbodies.end() ) {
+                continue;
+            }
+            KinBodyPtr pbody = itbody->second;
+            pbody->ReleaseAllGrabbed();
+            FOREACHC(itgrabbed, itstate->vGrabbed) {
+                std::map<int, KinBodyPtr>::iterator itgrabbedbody = mapidbodies.find(itgrabbed->first);
+                if( itgrabbedbody == mapidbodies.end() || itgrabbed->second < 0 || itgrabbed->second >= (int)pbody->GetLinks().size() ) {
+                    RAVELOG_WARN_FORMAT("env=%s, cannot restore grabbed body %d of %s, skipping", GetEnv()->GetNameId()%itgrabbed->first%itstate->name);
+                    continue;
+                }
+                pbody->Grab(itgrabbedbody->second, pbody->GetLinks().at(itgrabbed->second), rapidjson::Value());
+            }
+        }
+        sout << _restoreframe.timestamp;
+        return true;
+    }
+
+    uint64_t _GetTimestamp()
+    {
+        return _bUseSimulationTime ? GetEnv()->GetSimulationTime() : utils::GetMicroTime();
+    }
+
+    /// \brief copies the environment state into a pooled frame and queues it for writing. Environment has to be locked.
+    ///
+    /// \return false if not recording or the frame was dropped
+    bool _CaptureFrame(uint64_t timestamp)
+    {
+        FrameStatePtr frame;
+        uint64_t recordingid;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if( !_bRecording ) {
+                return false;
+            }
+            if( _listFreeFrames.size() == 0 ) {
+                if( _nDroppedFrames++ == 0 ) {
+                    RAVELOG_WARN_FORMAT("env=%s, state recorder writer is falling behind, dropping frames", GetEnv()->GetNameId());
+                }
+                return false;
+            }
+            frame = _listFreeFrames.back();
+            _listFreeFrames.pop_back();
+            recordingid = _nRecordingId;
+        }
+
+        GetEnv()->GetBodies(_vcapturebodies);
+        frame->timestamp = timestamp;
+        frame->vbodies.resize(_vcapturebodies.size());
+        for(size_t ibody = 0; ibody < _vcapturebodies.size(); ++ibody) {
+            const KinBody& body = *_vcapturebodies[ibody];
+            BodyState& state = frame->vbodies[ibody];
+            state.id = body.GetEnvironmentBodyIndex();
+            state.name = body.GetName();
+            body.GetLinkTransformations(state.vLinkTransforms);
+            body.GetDOFValues(state.vDOFValues);
+            body.GetDOFVelocities(state.vDOFVelocities);
+            state.vGrabbed.resize(0);
+            for(int igrabbed = 0; igrabbed < body.GetNumGrabbed(); ++igrabbed) {
+                KinBodyPtr pgrabbed = body.GetGrabbedBody(igrabbed);
+                if( !pgrabbed ) {
+                    continue;
+                }
+                KinBody::LinkPtr plink = body.IsGrabbing(*pgrabbed);
+                if( !!plink ) {
+                    state.vGrabbed.push_back(std::make_pair((int32_t)pgrabbed->GetEnvironmentBodyIndex(), (int32_t)plink->GetIndex()));
+                }
+            }
+        }
+        _vcapturebodies.resize(0); // do not hold references to the bodies
+        std::sort(frame->vbodies.begin(), frame->vbodies.end(), [](const BodyState& state0, const BodyState& state1) {
+            return state0.id < state1.id;
+        });
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if( !_bRecording || recordingid != _nRecordingId ) {
+            // the recording was stopped while copying, so the frame belongs to neither the closed file nor the next one
+            if( _listFreeFrames.size() < _nMaxBufferedFrames ) {
+                _listFreeFrames.push_back(frame);
+            }
+            return false;
+        }
+        _listQueuedFrames.push_back(frame);
+        _nCapturedFrames++;
+        _condnewframe.notify_one();
+        return true;
+    }
+
+    /// \brief stops capturing, waits until the queued frames are written and closes the file
+    void _StopRecording()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _bRecording = false;
+            ++_nRecordingId;
+            while( _listQueuedFrames.size() > 0 || _bWriterBusy ) {
+                _condframewritten.wait(lock);
+            }
+        }
+        std::lock_guard<std::mutex> lockwriter(_mutexwriter);
+        _writer.Close();
+    }
+
+    void _WriteThread()
+    {
+        while(true) {
+            FrameStatePtr frame;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                while( _bContinueThread && _listQueuedFrames.size() == 0 ) {
+                    _condnewframe.wait(lock);
+                }
+                if( _listQueuedFrames.size() == 0 ) {
+                    return;
+                }
+                frame = _listQueuedFrames.front();
+                _listQueuedFrames.pop_front();
+                _bWriterBusy = true;
+            }
+
+            try {
+                std::lock_guard<std::mutex> lockwriter(_mutexwriter);
+                if( _writer.IsOpen() ) {
+                    _writer.AddFrame(*frame);
+                }
+            }
+            catch(const std::exception& ex) {
+                RAVELOG_WARN_FORMAT("failed to write state frame: %s", ex.what());
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if( _listFreeFrames.size() < _nMaxBufferedFrames ) {
+                _listFreeFrames.push_back(frame);
+            }
+            _bWriterBusy = false;
+            _condframewritten.notify_all();
+        }
+    }
+
+    std::mutex _mutex; ///< protects the frame lists and the recording flags
+    std::mutex _mutexwriter; ///< protects _writer
+    std::condition_variable _condnewframe, _condframewritten;
+    boost::shared_ptr<std::thread> _threadwrite;
+    bool _bContinueThread, _bWriterBusy;
+    bool _bRecording;
+    uint64_t _nRecordingId; ///< changed by every start and stop, so that frames captured across a stop are not queued
+    bool _bRecordEveryStep; ///< if true, captures a frame every SimulationStep
+    bool _bUseSimulationTime; ///< if true, timestamps are the simulation time, otherwise real time
+    size_t _nMaxBufferedFrames; ///< maximum number of frames waiting to be written
+    uint64_t _nCapturedFrames, _nDroppedFrames;
+    std::list<FrameStatePtr> _listFreeFrames, _listQueuedFrames;
+
+    StateLogWriter _writer;
+    StateLogReader _reader;
+    FrameState _restoreframe;
+    std::vector<KinBodyPtr> _vcapturebodies;
+};
+
+ModuleBasePtr CreateStateRecorder(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return ModuleBasePtr(new StateRecorder(penv,sinput));
+}
@@ -0,0 +1,92 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/** \file staterecordformat.h
+    \brief File layout of the environment state logs written by the StateRecorder module.
+
+    The header does not depend on OpenRAVE so that offline tools can parse the logs directly. All values are stored in the byte order of the recording machine.
+
+    A log is a StateLogHeader followed by a sequence of chunks and, if the recording was stopped cleanly, by an index of the chunks and a StateLogIndexFooter.
+    A chunk is a StateLogChunkHeader followed by payloadsize bytes of frames. The first frame of every chunk is a keyframe encoded against an empty
+    environment, every following frame only encodes what changed since the previous frame of the same chunk, so a chunk can be decoded without reading any other chunk.
+
+    A frame is:
+    - uint64 timestamp (us)
+    - uint32 number of removed bodies, followed by the int32 body ids
+    - uint32 number of added bodies, followed for each body by int32 id, uint16 name length, name, uint32 number of links, uint32 number of dofs
+    - uint32 number of changed bodies, followed for each body by int32 id, uint8 STATELOG_BODY_X flags and for each set flag:
+      - STATELOG_BODY_LINKTRANSFORMS: a bitmask of (numlinks+7)/8 bytes, then 7 reals (quaternion, translation) per set bit
+      - STATELOG_BODY_DOFVALUES, STATELOG_BODY_DOFVELOCITIES: a bitmask of (numdofs+7)/8 bytes, then 1 real per set bit
+      - STATELOG_BODY_GRABBED: uint32 number of grabbed bodies, then int32 grabbed body id and int32 grabbing link index for each
+
+    Body ids are the environment body indices at recording time. Bodies that are added are always followed by a changed entry carrying their full state.
+ */
+#ifndef OPENRAVE_STATE_RECORD_FORMAT_H
+#define OPENRAVE_STATE_RECORD_FORMAT_H
+
+#include <stdint.h>
+
+namespace staterecorder {
+
+static const char STATELOG_MAGIC[8] = {'O','R','S','T','L','O','G','\0'};
+static const uint32_t STATELOG_VERSION = 1;
+static const uint32_t STATELOG_CHUNK_MAGIC = 0x4353524f; ///< "ORSC"
+static const uint32_t STATELOG_INDEX_MAGIC = 0x4953524f; ///< "ORSI"
+
+enum StateLogBodyFlags
+{
+    STATELOG_BODY_LINKTRANSFORMS = 1,
+    STATELOG_BODY_DOFVALUES = 2,
+    STATELOG_BODY_DOFVELOCITIES = 4,
+    STATELOG_BODY_GRABBED = 8,
+};
+
+/// \brief placed at the beginning of the file
+struct StateLogHeader
+{
+    char magic[8]; ///< STATELOG_MAGIC
+    uint32_t version; ///< STATELOG_VERSION
+    uint32_t realsize; ///< size in bytes of the reals stored in the frames, 4 or 8
+};
+
+/// \brief placed at the beginning of every chunk
+struct StateLogChunkHeader
+{
+    uint32_t magic; ///< STATELOG_CHUNK_MAGIC
+    uint32_t numframes; ///< number of frames in the chunk, the first one being the keyframe
+    uint64_t payloadsize; ///< number of bytes of frames following the header
+    uint64_t starttimestamp; ///< timestamp of the keyframe
+    uint64_t endtimestamp; ///< timestamp of the last frame
+};
+
+/// \brief one entry of the index written after the last chunk
+struct StateLogIndexEntry
+{
+    uint64_t offset; ///< file offset of the StateLogChunkHeader
+    uint64_t starttimestamp;
+    uint64_t endtimestamp;
+};
+
+/// \brief placed at the end of the file after numchunks StateLogIndexEntry. Missing if the recorder did not stop cleanly, in which case readers have to scan the chunks.
+struct StateLogIndexFooter
+{
+    uint64_t indexoffset; ///< file offset of the first StateLogIndexEntry
+    uint32_t numchunks;
+    uint32_t magic; ///< STATELOG_INDEX_MAGIC
+};
+
+} // end namespace staterecorder
+
+#endif
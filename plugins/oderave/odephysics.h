@@ -139,6 +139,13 @@ public:
                 }
                 RAVELOG_DEBUG("Setting QuickStep iterations to: %d\n",_physics->_num_iterations);
             }
+            else if( name == "numthreads") {
+                int temp=0;
+                _ss >> temp;
+                if (temp > 0) {
+                    _physics->SetNumThreads(temp);
+                }
+            }
             else if( name == "surfacelayer") {
                 float temp=0;
                 _ss >> temp;
@@ -170,8 +177,8 @@ public:
             }
         }
 
-        static const boost::array<string, 11>& GetTags() {
-            static const boost::array<string, 11> tags = {{"friction","selfcollision", "gravity", "contact", "erp", "cfm", "elastic_reduction_parameter", "constraint_force_mixing", "dcontactapprox", "numiterations", "surfacelayer" }};
+        static const boost::array<string, 12>& GetTags() {
+            static const boost::array<string, 12> tags = {{"friction","selfcollision", "gravity", "contact", "erp", "cfm", "elastic_reduction_parameter", "constraint_force_mixing", "dcontactapprox", "numiterations", "numthreads", "surfacelayer" }};
             return tags;
         }
 
@@ -199,8 +206,10 @@ It is possible to set ODE physics engine and its properties inside the <environm
       <selfcollision>1</selfcollision>\n\
       <dcontactapprox>1</dcontactapprox>\n\
       <numiterations>1</numiterations>\n\
+      <numthreads>4</numthreads>\n\
     </odeproperties>\n\
   </physicsengine>\n\n\
+ODE partitions the bodies into islands connected by joints and contacts. When **numthreads** is greater than 1, the islands are stepped in parallel on a pool of that many threads (requires ODE built with threading support).\n\n\
 The possible properties that can be set are: ";
         FOREACHC(it, PhysicsPropertiesXMLReader::GetTags()) {
             ss << "**" << *it << "**, ";
@@ -216,6 +225,13 @@ The possible properties that can be set are: ";
         _surface_mode = 0;
         _surfacelayer = 0.001;
         _options = OpenRAVE::PEO_SelfCollisions;
+        _numthreads = 1;
+#ifdef ODE_HAVE_THREADING_IMPL
+        _threading = NULL;
+        _threadpool = NULL;
+#endif
+        RegisterCommand("SetNumThreads",boost::bind(&ODEPhysicsEngine::_SetNumThreadsCommand,this,_1,_2),
+                        "sets the number of threads used to step the islands of bodies in parallel");
 
         memset(_jointadd, 0, sizeof(_jointadd));
         _jointadd[dJointTypeBall] = DummyAddForce;
@@ -235,6 +251,7 @@ The possible properties that can be set are: ";
         _jointgetvel[dJointTypeHinge2].push_back(dJointGetHinge2Angle2Rate);
     }
     virtual ~ODEPhysicsEngine() {
+        _DestroyThreading();
         _odespace->Destroy();
     }
 
@@ -243,6 +260,7 @@ The possible properties that can be set are: ";
         _report.reset(new CollisionReport());
 
         _odespace->SetSynchronizationCallback(boost::bind(&ODEPhysicsEngine::_SyncCallback, shared_physics(),_1));
+        _DestroyThreading(); // Init recreates the world
         if( !_odespace->Init() ) {
             return false;
         }
@@ -260,6 +278,7 @@ The possible properties that can be set are: ";
         dWorldSetCFM(_odespace->GetWorld(),_globalcfm);
         dWorldSetQuickStepNumIterations (_odespace->GetWorld(), _num_iterations);
         dWorldSetContactSurfaceLayer(_odespace->GetWorld(), _surfacelayer);
+        _InitThreading();
         return true;
     }
 
@@ -326,6 +345,27 @@ The possible properties that can be set are: ";
             dWorldSetCFM(_odespace->GetWorld(),_globalcfm);
             dWorldSetQuickStepNumIterations (_odespace->GetWorld(), _num_iterations);
         }
+        SetNumThreads(r->_numthreads);
+    }
+
+    /// \brief sets the number of threads the islands are stepped with, 1 steps everything in the calling thread
+    void SetNumThreads(int numthreads)
+    {
+        if( numthreads < 1 ) {
+            numthreads = 1;
+        }
+        if( _numthreads != numthreads ) {
+            _numthreads = numthreads;
+            if( !!_odespace && _odespace->IsInitialized() ) {
+                _DestroyThreading();
+                _InitThreading();
+            }
+        }
+    }
+
+    int GetNumThreads() const
+    {
+        return _numthreads;
     }
 
     virtual bool SetLinkVelocity(KinBody::LinkPtr plink, const Vector& _linearvel, const Vector& angularvel)
@@ -491,7 +531,7 @@ The possible properties that can be set are: ";
 
     virtual void SimulateStep(OpenRAVE::dReal fTimeElapsed)
     {
-        _odespace->Synchronize();
+        _odespace->SynchronizeChanged();
 
         bool bHasCallbacks = GetEnv()->HasRegisteredCollisionCallbacks();
         if( bHasCallbacks ) {
@@ -515,16 +555,29 @@ The possible properties that can be set are: ";
             }
         }
 
+        // islands of bodies connected by joints and contacts are solved independently, in parallel if _InitThreading set up a pool
         dWorldQuickStep(_odespace->GetWorld(), fTimeElapsed);
         dJointGroupEmpty (_odespace->GetContactGroup());
 
-        // synchronize all the objects from the ODE world to the OpenRAVE world
+        // synchronize the objects ODE moved from the ODE world to the OpenRAVE world
         Transform t;
         FOREACHC(itbody, vbodies) {
             ODESpace::KinBodyInfoPtr pinfo = _odespace->GetInfo(*itbody);
             BOOST_ASSERT( pinfo->vlinks.size() == (*itbody)->GetLinks().size());
             if( (*itbody)->IsEnabled() ) {
-                vector<Transform> vtrans(pinfo->vlinks.size());
+                bool bMoved = false;
+                FOREACHC(itlink, pinfo->vlinks) {
+                    if( dBodyIsEnabled((*itlink)->body) ) {
+                        bMoved = true;
+                        break;
+                    }
+                }
+                if( !bMoved ) {
+                    // all links are static or disabled, so do not touch the body and keep its update stamp
+                    continue;
+                }
+                vector<Transform>& vtrans = _vtranscache;
+                vtrans.resize(pinfo->vlinks.size());
                 for(size_t i = 0; i < pinfo->vlinks.size(); ++i) {
                     const dReal* prot = dBodyGetQuaternion(pinfo->vlinks[i]->body);
                     Vector vrot(prot[0],prot[1],prot[2],prot[3]);
@@ -541,6 +594,7 @@ The possible properties that can be set are: ";
             else {
                 // the body isn't enabled, so set a different timestamp in order for physics to synchornize it on the next run.
                 pinfo->nLastStamp = (*itbody)->GetUpdateStamp()-1;
+                _odespace->MarkChanged(pinfo);
             }
         }
 
@@ -667,6 +721,66 @@ private:
         //        dJointAttach (c,b1,b2);
     }
 
+    bool _SetNumThreadsCommand(ostream& sout, istream& sinput)
+    {
+        int numthreads = 1;
+        sinput >> numthreads;
+        if( !sinput ) {
+            return false;
+        }
+        SetNumThreads(numthreads);
+        return true;
+    }
+
+    /// \brief lets ODE step independent islands on a thread pool of _numthreads threads
+    void _InitThreading()
+    {
+#ifdef ODE_HAVE_THREADING_IMPL
+        if( _numthreads <= 1 || !!_threading ) {
+            return;
+        }
+        _threading = dThreadingAllocateMultiThreadedImplementation();
+        if( !_threading ) {
+            RAVELOG_WARN("failed to allocate ode threading implementation, stepping islands serially\n");
+            return;
+        }
+        _threadpool = dThreadingAllocateThreadPool(_numthreads, 0, dAllocateMaskAll, NULL);
+        if( !_threadpool ) {
+            RAVELOG_WARN(str(boost::format("failed to allocate ode thread pool of %d threads, stepping islands serially")%_numthreads));
+            dThreadingFreeImplementation(_threading);
+            _threading = NULL;
+            return;
+        }
+        dThreadingThreadPoolServeMultiThreadedImplementation(_threadpool, _threading);
+        dWorldSetStepThreadingImplementation(_odespace->GetWorld(), dThreadingImplementationGetFunctions(_threading), _threading);
+        dWorldSetStepIslandsProcessingMaxThreadCount(_odespace->GetWorld(), _numthreads);
+        RAVELOG_DEBUG(str(boost::format("stepping ode islands with %d threads")%_numthreads));
+#else
+        if( _numthreads > 1 ) {
+            RAVELOG_WARN(str(boost::format("ode was not built with threading support, ignoring numthreads=%d")%_numthreads));
+        }
+#endif
+    }
+
+    void _DestroyThreading()
+    {
+#ifdef ODE_HAVE_THREADING_IMPL
+        if( !_threading ) {
+            return;
+        }
+        // the pool threads may still be serving the implementation, so wait for them before freeing either
+        dThreadingImplementationShutdownProcessing(_threading);
+        dThreadingThreadPoolWaitIdleState(_threadpool);
+        dThreadingFreeThreadPool(_threadpool);
+        if( !!_odespace && _odespace->IsInitialized() ) {
+            dWorldSetStepThreadingImplementation(_odespace->GetWorld(), NULL, NULL);
+        }
+        dThreadingFreeImplementation(_threading);
+        _threading = NULL;
+        _threadpool = NULL;
+#endif
+    }
+
     void _SyncCallback(ODESpace::KinBodyInfoConstPtr pinfo)
     {
         // things very difficult when dynamics are not reset
@@ -696,6 +810,12 @@ private:
     float _surfacelayer;  ///> Surface layer depth
 
     int _num_iterations; ///> Max QuickStep iterations for each timestep
+    int _numthreads; ///> number of threads islands are stepped with
+#ifdef ODE_HAVE_THREADING_IMPL
+    dThreadingImplementationID _threading;
+    dThreadingThreadPoolID _threadpool;
+#endif
+    vector<Transform> _vtranscache;
 
     typedef void (*JointSetFn)(dJointID, int param, dReal val);
     typedef dReal (*JointGetFn)(dJointID);
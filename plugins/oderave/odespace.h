@@ -140,6 +140,7 @@ public:
             jointgroup = dJointGroupCreate(0);
             space = dHashSpaceCreate(_ode->space);
             nLastStamp = 0;
+            _bChanged = false;
         }
 
         virtual ~KinBodyInfo() {
@@ -201,6 +202,7 @@ public:
             _geometrycallback.reset();
             _staticcallback.reset();
             _bodyremovedcallback.reset();
+            _transformcallback.reset();
         }
 
         KinBodyPtr GetBody() {
@@ -216,8 +218,9 @@ public:
         ///< the pointer to this Link is the userdata
         vector<dJointID> vjoints;
         vector<dJointFeedback> vjointfeedback;
-        OpenRAVE::UserDataPtr _geometrycallback, _staticcallback, _bodyremovedcallback;
+        OpenRAVE::UserDataPtr _geometrycallback, _staticcallback, _bodyremovedcallback, _transformcallback;
         boost::weak_ptr<ODESpace> _odespace;
+        bool _bChanged; ///< true if the body is queued in ODESpace::_vchangedinfos
 
         dSpaceID space;                             ///< space that contanis all the collision objects of this chain
         dJointGroupID jointgroup;
@@ -228,6 +231,7 @@ private:
 
     typedef boost::shared_ptr<KinBodyInfo> KinBodyInfoPtr;
     typedef boost::shared_ptr<KinBodyInfo const> KinBodyInfoConstPtr;
+    typedef boost::weak_ptr<KinBodyInfo> KinBodyInfoWeakPtr;
     typedef boost::function<void (KinBodyInfoPtr)> SynchronizeCallbackFn;
 
     ODESpace(EnvironmentBasePtr penv, const std::string& userdatakey, bool bUsingPhysics) : _penv(penv), _userdatakey(userdatakey), _bUsingPhysics(bUsingPhysics)
@@ -484,6 +488,10 @@ private:
             pinfo->_staticcallback = pbody->RegisterChangeCallback(KinBody::Prop_LinkStatic|KinBody::Prop_LinkDynamics, boost::bind(&ODESpace::_ResetKinBodyCallback,boost::bind(&OpenRAVE::utils::sptr_from<ODESpace>, weak_space()),boost::weak_ptr<KinBody const>(pbody)));
         }
         pinfo->_bodyremovedcallback = pbody->RegisterChangeCallback(KinBody::Prop_BodyRemoved, boost::bind(&ODESpace::RemoveUserData, boost::bind(&OpenRAVE::utils::sptr_from<ODESpace>, weak_space()), boost::bind(&OpenRAVE::utils::sptr_from<const KinBody>, boost::weak_ptr<const KinBody>(pbody))));
+        if( _bUsingPhysics ) {
+            // physics only synchronizes the bodies that were queued by this callback, see SynchronizeChanged
+            pinfo->_transformcallback = pbody->RegisterChangeCallback(KinBody::Prop_LinkTransforms|KinBody::Prop_LinkEnable, boost::bind(&ODESpace::_MarkChangedCallback,boost::bind(&OpenRAVE::utils::sptr_from<ODESpace>, weak_space()),KinBodyInfoWeakPtr(pinfo)));
+        }
 
         pbody->SetUserData(_userdatakey, pinfo);
         _setInitializedBodies.insert(pbody);
@@ -539,6 +547,42 @@ private:
         }
     }
 
+    /// \brief synchronizes only the bodies whose transforms or enable state changed since they were last synchronized
+    ///
+    /// Unlike Synchronize(), bodies are not lazily initialized, so every body has to have gone through InitKinBody. Only available when using physics.
+    void SynchronizeChanged()
+    {
+        BOOST_ASSERT(_bUsingPhysics);
+#ifdef ODE_HAVE_ALLOCATE_DATA_THREAD
+        dAllocateODEDataForThread(dAllocateMaskAll);
+#endif
+        std::lock_guard<std::mutex> lockode(_ode->_mutex);
+        {
+            std::lock_guard<std::mutex> lock(_mutexChanged);
+            _vchangedinfos.swap(_vsynchronizeinfos);
+        }
+        FOREACH(itinfo, _vsynchronizeinfos) {
+            KinBodyInfoPtr pinfo = itinfo->lock();
+            if( !!pinfo ) {
+                pinfo->_bChanged = false;
+                if( !!pinfo->GetBody() ) {
+                    _Synchronize(pinfo,false);
+                }
+            }
+        }
+        _vsynchronizeinfos.resize(0);
+    }
+
+    /// \brief queues the body for the next SynchronizeChanged call
+    void MarkChanged(KinBodyInfoPtr pinfo)
+    {
+        std::lock_guard<std::mutex> lock(_mutexChanged);
+        if( !pinfo->_bChanged ) {
+            pinfo->_bChanged = true;
+            _vchangedinfos.push_back(pinfo);
+        }
+    }
+
     void Synchronize(KinBodyConstPtr pbody)
     {
         KinBodyInfoPtr pinfo = GetCreateInfo(pbody).first;
@@ -717,6 +761,14 @@ private:
         }
     }
 
+    void _MarkChangedCallback(KinBodyInfoWeakPtr _pinfo)
+    {
+        KinBodyInfoPtr pinfo = _pinfo.lock();
+        if( !!pinfo ) {
+            MarkChanged(pinfo);
+        }
+    }
+
     void _ResetKinBodyCallback(boost::weak_ptr<KinBody const> _pbody)
     {
         KinBodyConstPtr pbody(_pbody);
@@ -735,6 +787,9 @@ private:
     std::string _geometrygroup;
     SynchronizeCallbackFn _synccallback;
     std::set<KinBodyConstPtr> _setInitializedBodies; ///< set of bodies that have been initialized and user data is set
+    std::mutex _mutexChanged; ///< protects _vchangedinfos, change callbacks can be called without _ode->_mutex
+    std::vector<KinBodyInfoWeakPtr> _vchangedinfos; ///< bodies to be synchronized by SynchronizeChanged
+    std::vector<KinBodyInfoWeakPtr> _vsynchronizeinfos; ///< cache for SynchronizeChanged
     bool _bUsingPhysics;
 };
 
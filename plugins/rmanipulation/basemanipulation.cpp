@@ -37,6 +37,7 @@ public:
 - minsteps - The minimum number of steps that need to be taken in order for success to declared. If robot doesn't reach this number of steps, it fails.\n\n\
 - maxsteps - The maximum number of steps the robot should take.\n\n\
 - direction - The workspace direction to move end effector in.\n\n\
+- differentialik - If 1, track the line with jacobian-based differential ik and only fall back to the ik solver where it does not converge.\n\n\
 Method wraps the WorkspaceTrajectoryTracker planner. For more details on parameters, check out its documentation.");
         RegisterCommand("MoveManipulator",boost::bind(&BaseManipulation::MoveManipulator,this,_1,_2),
                         "Moves arm joints of active manipulator to a given set of joint values");
@@ -248,6 +249,9 @@ protected:
             else if( cmd == "maxdeviationangle" ) {
                 sinput >> params->maxdeviationangle;
             }
+            else if( cmd == "differentialik" ) {
+                sinput >> params->usedifferentialik;
+            }
             else if( cmd == "jacobian" ) {
                 RAVELOG_WARN("MoveHandStraight jacobian parameter not supported anymore\n");
             }
@@ -0,0 +1,443 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "plugindefs.h"
+
+#include <cstdio>
+#include <iomanip>
+#include <boost/bind/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "NvConvexDecomposition.h"
+
+using namespace boost::placeholders;
+
+namespace {
+
+static const char s_ConvexDecompositionFileMagic[8] = {'O','R','C','D','E','C','0','1'};
+
+/// \brief parameters of the decomposition, they are all part of the cache filename
+struct ConvexDecompositionParameters
+{
+    dReal padding = 0; ///< distance to push the faces of the hulls outwards
+    float skinwidth = 0;
+    int depth = 8; ///< maximum recursion depth of the decomposition
+    int maxhullvertices = 64;
+    float concavity = 0.1f; ///< concavity threshold percent
+    float merge = 30.0f; ///< merge threshold percent
+    float volumesplit = 0.1f; ///< volume split threshold percent
+    bool useinitialisland = true;
+    bool useisland = false;
+
+    std::string GetHash() const
+    {
+        std::stringstream ss;
+        ss << std::setprecision(std::numeric_limits<dReal>::digits10+1);
+        ss << padding << " " << skinwidth << " " << depth << " " << maxhullvertices << " " << concavity << " " << merge << " " << volumesplit << " " << useinitialisland << " " << useisland;
+        return utils::GetMD5HashString(ss.str());
+    }
+};
+
+/// \brief a convex piece of a link geometry
+struct ConvexPiece
+{
+    int geometryindex = 0; ///< index of the source geometry in the link
+    bool bCopyGeometry = false; ///< if true, the source geometry is already convex and is used as is
+    std::vector<float> vertices; ///< 3*n coordinates in the geometry frame
+    std::vector<int32_t> indices;
+};
+
+typedef std::vector< std::vector<ConvexPiece> > LinkConvexPieces;
+
+}
+
+/// \brief builds convex decompositions of all the collision geometries of a body and stores them as a geometry group of its links.
+///
+/// The result is cached in the database keyed by the kinematics-geometry hash of the body and the decomposition parameters.
+/// Collision checkers can then use the geometry group as a convex proxy of the body, for example fcl with SetConvexGeometryGroup.
+class ConvexDecomposition : public ModuleBase
+{
+public:
+    ConvexDecomposition(EnvironmentBasePtr penv) : ModuleBase(penv) {
+        __description = "Computes the convex decomposition of the collision geometries of a body and stores them as an extra geometry group of each link. \
+The decompositions are cached in the openrave database so they are computed only once for each kinematics-geometry hash.";
+        RegisterCommand("Build",boost::bind(&ConvexDecomposition::BuildCommand,this,_1,_2),
+                        "Loads or computes the convex decomposition of a body and stores it in a geometry group. Parameters:\n\n\
+* body - name of the body\n\
+* groupname - name of the geometry group to set, default is convexdecomposition\n\
+* padding - distance to push the hull faces outward, default is 0\n\
+* skinwidth, depth, maxhullvertices, concavity, merge, volumesplit, useinitialisland, useisland - decomposition parameters\n\
+* nocache - if set, does not read or write the database\n\n\
+Returns the number of convex pieces.");
+        RegisterCommand("GetCacheFilename",boost::bind(&ConvexDecomposition::GetCacheFilenameCommand,this,_1,_2),
+                        "Returns the database filename the decomposition of a body would be cached to. Takes the same parameters as Build.");
+    }
+    virtual ~ConvexDecomposition() {
+    }
+
+protected:
+    /// \brief parses the body and decomposition parameters shared by all commands
+    KinBodyPtr _ParseParameters(istream& sinput, ConvexDecompositionParameters& params, std::string& groupname, bool& bUseCache)
+    {
+        KinBodyPtr pbody;
+        string cmd;
+        while(!sinput.eof()) {
+            sinput >> cmd;
+            if( !sinput ) {
+                break;
+            }
+            std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
+
+            if( cmd == "body" ) {
+                string name;
+                sinput >> name;
+                pbody = GetEnv()->GetKinBody(name);
+                if( !pbody ) {
+                    throw OPENRAVE_EXCEPTION_FORMAT("env=%s, could not find body %s", GetEnv()->GetNameId()%name, ORE_InvalidArguments);
+                }
+            }
+            else if( cmd == "groupname" ) {
+                sinput >> groupname;
+            }
+            else if( cmd == "padding" ) {
+                sinput >> params.padding;
+            }
+            else if( cmd == "skinwidth" ) {
+                sinput >> params.skinwidth;
+            }
+            else if( cmd == "depth" ) {
+                sinput >> params.depth;
+            }
+            else if( cmd == "maxhullvertices" ) {
+                sinput >> params.maxhullvertices;
+            }
+            else if( cmd == "concavity" ) {
+                sinput >> params.concavity;
+            }
+            else if( cmd == "merge" ) {
+                sinput >> params.merge;
+            }
+            else if( cmd == "volumesplit" ) {
+                sinput >> params.volumesplit;
+            }
+            else if( cmd == "useinitialisland" ) {
+                sinput >> params.useinitialisland;
+            }
+            else if( cmd == "useisland" ) {
+                sinput >> params.useisland;
+            }
+            else if( cmd == "nocache" ) {
+                bUseCache = false;
+            }
+            else {
+                throw OPENRAVE_EXCEPTION_FORMAT("env=%s, unrecognized command: %s", GetEnv()->GetNameId()%cmd, ORE_InvalidArguments);
+            }
+
+            if( !sinput ) {
+                throw OPENRAVE_EXCEPTION_FORMAT("env=%s, failed processing command %s", GetEnv()->GetNameId()%cmd, ORE_InvalidArguments);
+            }
+        }
+        if( !pbody ) {
+            throw OPENRAVE_EXCEPTION_FORMAT0("need to specify a body", ORE_InvalidArguments);
+        }
+        return pbody;
+    }
+
+    std::string _GetCacheFilename(const KinBody& body, const ConvexDecompositionParameters& params, bool bRead) const
+    {
+        return RaveFindDatabaseFile(std::string("convexdecomposition.") + body.GetKinematicsGeometryHash() + "." + params.GetHash(), bRead);
+    }
+
+    bool GetCacheFilenameCommand(ostream& sout, istream& sinput)
+    {
+        ConvexDecompositionParameters params;
+        std::string groupname;
+        bool bUseCache = true;
+        KinBodyPtr pbody = _ParseParameters(sinput, params, groupname, bUseCache);
+        sout << _GetCacheFilename(*pbody, params, false);
+        return true;
+    }
+
+    bool BuildCommand(ostream& sout, istream& sinput)
+    {
+        ConvexDecompositionParameters params;
+        std::string groupname = "convexdecomposition";
+        bool bUseCache = true;
+        EnvironmentLock lock(GetEnv()->GetMutex());
+        KinBodyPtr pbody = _ParseParameters(sinput, params, groupname, bUseCache);
+
+        LinkConvexPieces vlinkpieces;
+        bool bLoaded = false;
+        if( bUseCache ) {
+            std::string filename = _GetCacheFilename(*pbody, params, true);
+            if( filename.size() > 0 ) {
+                bLoaded = _LoadCache(filename, *pbody, vlinkpieces);
+            }
+        }
+        if( !bLoaded ) {
+            uint64_t starttime = utils::GetMicroTime();
+            _ComputeDecomposition(*pbody, params, vlinkpieces);
+            RAVELOG_DEBUG_FORMAT("env=%s, computed convex decomposition of %s in %fs", GetEnv()->GetNameId()%pbody->GetName()%(1e-6*(utils::GetMicroTime()-starttime)));
+            if( bUseCache ) {
+                _SaveCache(_GetCacheFilename(*pbody, params, false), vlinkpieces);
+            }
+        }
+
+        std::vector< std::vector<KinBody::GeometryInfoPtr> > vlinkgeometries(pbody->GetLinks().size());
+        int numpieces = 0;
+        for(size_t ilink = 0; ilink < vlinkpieces.size(); ++ilink) {
+            const std::vector<KinBody::GeometryPtr>& vgeometries = pbody->GetLinks()[ilink]->GetGeometries();
+            std::vector<KinBody::GeometryInfoPtr>& vgeometryinfos = vlinkgeometries[ilink];
+            int ipiece = 0;
+            FOREACHC(itpiece, vlinkpieces[ilink]) {
+                const KinBody::GeometryInfo& sourceinfo = vgeometries.at(itpiece->geometryindex)->GetInfo();
+                KinBody::GeometryInfoPtr pinfo(new KinBody::GeometryInfo());
+                if( itpiece->bCopyGeometry ) {
+                    *pinfo = sourceinfo;
+                }
+                else {
+                    pinfo->_type = GT_TriMesh;
+                    pinfo->_t = sourceinfo._t;
+                    pinfo->_vDiffuseColor = sourceinfo._vDiffuseColor;
+                    pinfo->_vAmbientColor = sourceinfo._vAmbientColor;
+                    pinfo->_bVisible = sourceinfo._bVisible;
+                    pinfo->_meshcollision.vertices.resize(itpiece->vertices.size()/3);
+                    for(size_t ivertex = 0; ivertex < pinfo->_meshcollision.vertices.size(); ++ivertex) {
+                        pinfo->_meshcollision.vertices[ivertex] = Vector(itpiece->vertices[3*ivertex], itpiece->vertices[3*ivertex+1], itpiece->vertices[3*ivertex+2]);
+                    }
+                    pinfo->_meshcollision.indices = itpiece->indices;
+                }
+                pinfo->_id = sourceinfo._id + "_convex" + boost::lexical_cast<std::string>(ipiece);
+                pinfo->_name = sourceinfo._name + "_convex" + boost::lexical_cast<std::string>(ipiece);
+                vgeometryinfos.push_back(pinfo);
+                ++ipiece;
+            }
+            numpieces += ipiece;
+        }
+        pbody->SetLinkGroupGeometries(groupname, vlinkgeometries);
+        sout << numpieces;
+        return true;
+    }
+
+    void _ComputeDecomposition(const KinBody& body, const ConvexDecompositionParameters& params, LinkConvexPieces& vlinkpieces)
+    {
+        vlinkpieces.resize(0);
+        vlinkpieces.resize(body.GetLinks().size());
+        CONVEX_DECOMPOSITION::iConvexDecomposition* ic = CONVEX_DECOMPOSITION::createConvexDecomposition();
+        try {
+            FOREACHC(itlink, body.GetLinks()) {
+                std::vector<ConvexPiece>& vpieces = vlinkpieces.at((*itlink)->GetIndex());
+                const std::vector<KinBody::GeometryPtr>& vgeometries = (*itlink)->GetGeometries();
+                for(size_t igeom = 0; igeom < vgeometries.size(); ++igeom) {
+                    const KinBody::GeometryInfo& info = vgeometries[igeom]->GetInfo();
+                    if( (info._type == GT_Box || info._type == GT_Sphere || info._type == GT_Cylinder) && params.padding == 0 ) {
+                        // primitives are convex and collision checkers handle them natively
+                        vpieces.push_back(ConvexPiece());
+                        vpieces.back().geometryindex = igeom;
+                        vpieces.back().bCopyGeometry = true;
+                        continue;
+                    }
+
+                    const TriMesh& mesh = info._meshcollision;
+                    if( mesh.indices.size() == 0 ) {
+                        continue;
+                    }
+                    ic->reset();
+                    float tri[3][3];
+                    for(size_t i = 0; i+2 < mesh.indices.size(); i += 3) {
+                        for(int j = 0; j < 3; ++j) {
+                            const Vector& v = mesh.vertices.at(mesh.indices[i+j]);
+                            tri[j][0] = v.x; tri[j][1] = v.y; tri[j][2] = v.z;
+                        }
+                        ic->addTriangle(tri[0], tri[1], tri[2]);
+                    }
+                    ic->computeConvexDecomposition(params.skinwidth, params.depth, params.maxhullvertices, params.concavity, params.merge, params.volumesplit, params.useinitialisland, params.useisland, false);
+                    CONVEX_DECOMPOSITION::ConvexHullResult result;
+                    for(uint32_t ihull = 0; ihull < ic->getHullCount(); ++ihull) {
+                        ic->getConvexHullResult(ihull, result);
+                        if( result.mTcount == 0 ) {
+                            continue;
+                        }
+                        vpieces.push_back(ConvexPiece());
+                        ConvexPiece& piece = vpieces.back();
+                        piece.geometryindex = igeom;
+                        piece.vertices.assign(result.mVertices, result.mVertices + 3*result.mVcount);
+                        piece.indices.assign(result.mIndices, result.mIndices + 3*result.mTcount);
+                        if( params.padding != 0 ) {
+                            _PadHull(piece, params.padding);
+                        }
+                    }
+                    RAVELOG_VERBOSE_FORMAT("env=%s, link %s geometry %d: %d triangles decomposed into %d hulls", GetEnv()->GetNameId()%(*itlink)->GetName()%igeom%(mesh.indices.size()/3)%ic->getHullCount());
+                }
+            }
+        }
+        catch(...) {
+            CONVEX_DECOMPOSITION::releaseConvexDecomposition(ic);
+            throw;
+        }
+        CONVEX_DECOMPOSITION::releaseConvexDecomposition(ic);
+    }
+
+    /// \brief moves the vertices of a convex hull so that each of its faces is pushed outward by at least padding
+    static void _PadHull(ConvexPiece& piece, dReal padding)
+    {
+        const size_t numvertices = piece.vertices.size()/3;
+        Vector vcenter;
+        for(size_t i = 0; i < numvertices; ++i) {
+            vcenter += Vector(piece.vertices[3*i], piece.vertices[3*i+1], piece.vertices[3*i+2]);
+        }
+        vcenter *= dReal(1)/numvertices;
+
+        std::vector<Vector> vfacenormals(piece.indices.size()/3), vvertexnormals(numvertices);
+        for(size_t iface = 0; iface < vfacenormals.size(); ++iface) {
+            const int32_t* pindices = &piece.indices[3*iface];
+            Vector v[3];
+            for(int j = 0; j < 3; ++j) {
+                v[j] = Vector(piece.vertices[3*pindices[j]], piece.vertices[3*pindices[j]+1], piece.vertices[3*pindices[j]+2]);
+            }
+            Vector vnormal = (v[1]-v[0]).cross(v[2]-v[0]);
+            dReal flen = RaveSqrt(vnormal.lengthsqr3());
+            if( flen <= g_fEpsilon ) {
+                continue;
+            }
+            vnormal *= 1/flen;
+            if( vnormal.dot3(v[0]-vcenter) < 0 ) {
+                vnormal = -vnormal;
+            }
+            vfacenormals[iface] = vnormal;
+            for(int j = 0; j < 3; ++j) {
+                vvertexnormals[pindices[j]] += vnormal;
+            }
+        }
+
+        // the offset along the vertex normal has to cover padding along the normal of every adjacent face
+        std::vector<dReal> vmincos(numvertices, 1);
+        for(size_t i = 0; i < numvertices; ++i) {
+            dReal flen = RaveSqrt(vvertexnormals[i].lengthsqr3());
+            if( flen > g_fEpsilon ) {
+                vvertexnormals[i] *= 1/flen;
+            }
+        }
+        for(size_t iface = 0; iface < vfacenormals.size(); ++iface) {
+            for(int j = 0; j < 3; ++j) {
+                int32_t ivertex = piece.indices[3*iface+j];
+                vmincos[ivertex] = min(vmincos[ivertex], vvertexnormals[ivertex].dot3(vfacenormals[iface]));
+            }
+        }
+        for(size_t i = 0; i < numvertices; ++i) {
+            dReal foffset = padding/max(vmincos[i], dReal(0.1));
+            for(int j = 0; j < 3; ++j) {
+                piece.vertices[3*i+j] += foffset*vvertexnormals[i][j];
+            }
+        }
+    }
+
+    bool _LoadCache(const std::string& filename, const KinBody& body, LinkConvexPieces& vlinkpieces)
+    {
+        FILE* pfile = fopen(filename.c_str(), "rb");
+        if( !pfile ) {
+            return false;
+        }
+        bool bsuccess = true;
+        char magic[sizeof(s_ConvexDecompositionFileMagic)];
+        uint32_t numlinks = 0;
+        bsuccess = fread(magic, sizeof(magic), 1, pfile) == 1 && std::equal(magic, magic+sizeof(magic), s_ConvexDecompositionFileMagic);
+        bsuccess = bsuccess && fread(&numlinks, sizeof(numlinks), 1, pfile) == 1 && numlinks == body.GetLinks().size();
+        if( bsuccess ) {
+            vlinkpieces.resize(0);
+            vlinkpieces.resize(numlinks);
+            for(uint32_t ilink = 0; ilink < numlinks && bsuccess; ++ilink) {
+                const int numgeometries = body.GetLinks()[ilink]->GetGeometries().size();
+                uint32_t numpieces = 0;
+                bsuccess = fread(&numpieces, sizeof(numpieces), 1, pfile) == 1;
+                for(uint32_t ipiece = 0; ipiece < numpieces && bsuccess; ++ipiece) {
+                    vlinkpieces[ilink].push_back(ConvexPiece());
+                    ConvexPiece& piece = vlinkpieces[ilink].back();
+                    uint8_t bCopyGeometry = 0;
+                    uint32_t numvertices = 0, numindices = 0;
+                    bsuccess = fread(&piece.geometryindex, sizeof(piece.geometryindex), 1, pfile) == 1 && piece.geometryindex >= 0 && piece.geometryindex < numgeometries;
+                    bsuccess = bsuccess && fread(&bCopyGeometry, sizeof(bCopyGeometry), 1, pfile) == 1;
+                    bsuccess = bsuccess && fread(&numvertices, sizeof(numvertices), 1, pfile) == 1 && fread(&numindices, sizeof(numindices), 1, pfile) == 1;
+                    if( !bsuccess ) {
+                        break;
+                    }
+                    piece.bCopyGeometry = !!bCopyGeometry;
+                    piece.vertices.resize(3*numvertices);
+                    piece.indices.resize(numindices);
+                    bsuccess = (numvertices == 0 || fread(&piece.vertices[0], sizeof(float)*piece.vertices.size(), 1, pfile) == 1) && (numindices == 0 || fread(&piece.indices[0], sizeof(int32_t)*numindices, 1, pfile) == 1);
+                    for(size_t i = 0; i < piece.indices.size() && bsuccess; ++i) {
+                        bsuccess = piece.indices[i] >= 0 && piece.indices[i] < (int32_t)numvertices;
+                    }
+                }
+            }
+        }
+        fclose(pfile);
+        if( !bsuccess ) {
+            RAVELOG_WARN_FORMAT("env=%s, convex decomposition cache %s is invalid, ignoring", GetEnv()->GetNameId()%filename);
+            return false;
+        }
+        RAVELOG_DEBUG_FORMAT("env=%s, loaded convex decomposition of %s from %s", GetEnv()->GetNameId()%body.GetName()%filename);
+        return true;
+    }
+
+    bool _SaveCache(const std::string& filename, const LinkConvexPieces& vlinkpieces)
+    {
+        if( filename.size() == 0 ) {
+            return false;
+        }
+        // write to a temporary file and rename it at the end so that other processes never load a partial file
+        const std::string tempfilename = filename + ".tmp" + boost::lexical_cast<std::string>(utils::GetMicroTime());
+        FILE* pfile = fopen(tempfilename.c_str(), "wb");
+        if( !pfile ) {
+            RAVELOG_WARN_FORMAT("env=%s, failed to open %s for writing the convex decomposition", GetEnv()->GetNameId()%tempfilename);
+            return false;
+        }
+        uint32_t numlinks = vlinkpieces.size();
+        fwrite(s_ConvexDecompositionFileMagic, sizeof(s_ConvexDecompositionFileMagic), 1, pfile);
+        fwrite(&numlinks, sizeof(numlinks), 1, pfile);
+        FOREACHC(itpieces, vlinkpieces) {
+            uint32_t numpieces = itpieces->size();
+            fwrite(&numpieces, sizeof(numpieces), 1, pfile);
+            FOREACHC(itpiece, *itpieces) {
+                uint8_t bCopyGeometry = itpiece->bCopyGeometry;
+                uint32_t numvertices = itpiece->vertices.size()/3, numindices = itpiece->indices.size();
+                fwrite(&itpiece->geometryindex, sizeof(itpiece->geometryindex), 1, pfile);
+                fwrite(&bCopyGeometry, sizeof(bCopyGeometry), 1, pfile);
+                fwrite(&numvertices, sizeof(numvertices), 1, pfile);
+                fwrite(&numindices, sizeof(numindices), 1, pfile);
+                if( numvertices > 0 ) {
+                    fwrite(&itpiece->vertices[0], sizeof(float)*itpiece->vertices.size(), 1, pfile);
+                }
+                if( numindices > 0 ) {
+                    fwrite(&itpiece->indices[0], sizeof(int32_t)*numindices, 1, pfile);
+                }
+            }
+        }
+
+        bool bwritesuccess = ferror(pfile) == 0;
+        bwritesuccess &= fclose(pfile) == 0;
+        if( !bwritesuccess || std::rename(tempfilename.c_str(), filename.c_str()) != 0 ) {
+            RAVELOG_WARN_FORMAT("env=%s, failed to write convex decomposition %s", GetEnv()->GetNameId()%filename);
+            std::remove(tempfilename.c_str());
+            return false;
+        }
+        RAVELOG_DEBUG_FORMAT("env=%s, wrote convex decomposition to %s", GetEnv()->GetNameId()%filename);
+        return true;
+    }
+};
+
+ModuleBasePtr CreateConvexDecomposition(EnvironmentBasePtr penv) {
+    return ModuleBasePtr(new ConvexDecomposition(penv));
+}
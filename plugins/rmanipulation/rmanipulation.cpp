@@ -20,6 +20,9 @@ OpenRAVE::ModuleBasePtr CreateBaseManipulation(OpenRAVE::EnvironmentBasePtr penv
 //OpenRAVE::ModuleBasePtr CreateTaskCaging(OpenRAVE::EnvironmentBasePtr penv);
 OpenRAVE::ModuleBasePtr CreateTaskManipulation(OpenRAVE::EnvironmentBasePtr penv);
 OpenRAVE::ModuleBasePtr CreateVisualFeedback(OpenRAVE::EnvironmentBasePtr penv);
+#ifdef OPENRAVE_HAS_CONVEXDECOMPOSITION
+OpenRAVE::ModuleBasePtr CreateConvexDecomposition(OpenRAVE::EnvironmentBasePtr penv);
+#endif
 
 RManipulationPlugin::RManipulationPlugin()
 {
@@ -27,6 +30,9 @@ RManipulationPlugin::RManipulationPlugin()
     _interfaces[PT_Module].push_back("TaskManipulation");
     _interfaces[PT_Module].push_back("TaskCaging");
     _interfaces[PT_Module].push_back("VisualFeedback");
+#ifdef OPENRAVE_HAS_CONVEXDECOMPOSITION
+    _interfaces[PT_Module].push_back("ConvexDecomposition");
+#endif
 }
 
 RManipulationPlugin::~RManipulationPlugin() {}
@@ -47,6 +53,11 @@ OpenRAVE::InterfaceBasePtr RManipulationPlugin::CreateInterface(OpenRAVE::Interf
         else if( interfacename == "visualfeedback") {
             return CreateVisualFeedback(penv);
         }
+#ifdef OPENRAVE_HAS_CONVEXDECOMPOSITION
+        else if( interfacename == "convexdecomposition") {
+            return CreateConvexDecomposition(penv);
+        }
+#endif
         break;
     default:
         break;
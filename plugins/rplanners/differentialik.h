@@ -0,0 +1,291 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef OPENRAVE_DIFFERENTIAL_IK_H
+#define OPENRAVE_DIFFERENTIAL_IK_H
+
+#include "openraveplugindefs.h"
+
+namespace rplanners {
+
+/** \brief velocity-resolved inverse kinematics of a manipulator tracking end effector transforms.
+
+    Every step solves the damped least squares problem
+
+      min |J dq - e|^2 + lambda^2 |dq|^2  s.t.  lower <= dq <= upper
+
+    where e is the 6D error of the manipulator transform (translation, then axis-angle rotation), and the bounds come from the joint
+    limits and, if a time step is set, from the joint velocity limits. The bounds are enforced with an active set: dofs that leave
+    their bounds are clamped and the problem is solved again with the remaining dofs.
+
+    All the workspaces are allocated in Init, so solving does not allocate memory. The robot has to be locked by the caller,
+    its arm dof values are modified while solving.
+ */
+class DifferentialIKSolver
+{
+public:
+    DifferentialIKSolver() : _eelinkindex(-1), _fDamping(1e-3), _fErrorThresh2(1e-12), _fRotationWeight(1), _fTimeStep(0), _nMaxIterations(20) {
+    }
+
+    /// \brief allocates the workspaces for the manipulator's arm dofs. Has to be called again if the arm indices change.
+    void Init(RobotBase::ManipulatorConstPtr pmanip)
+    {
+        _pmanip = pmanip;
+        RobotBasePtr probot = pmanip->GetRobot();
+        _probot = probot;
+        _eelinkindex = pmanip->GetEndEffector()->GetIndex();
+        _varmindices = pmanip->GetArmIndices();
+        const size_t armdof = _varmindices.size();
+        probot->GetDOFLimits(_vlower, _vupper, _varmindices);
+        probot->GetDOFVelocityLimits(_vmaxvelocities, _varmindices);
+        _vcurvalues.resize(armdof);
+        _vdeltavalues.resize(armdof);
+        _vsteplower.resize(armdof);
+        _vstepupper.resize(armdof);
+        _vfree.resize(armdof);
+        _vtransjacobian.resize(3*armdof);
+        _vrotjacobian.resize(3*armdof);
+        _vjacobian.resize(6*armdof);
+    }
+
+    /// \brief damping of the least squares, the larger the more stable close to singularities and the slower the convergence
+    void SetDamping(dReal fdamping) {
+        _fDamping = fdamping;
+    }
+
+    /// \brief the goal is reached when the norm of the weighted 6D error is below errorthresh
+    void SetErrorThresh(dReal errorthresh) {
+        _fErrorThresh2 = errorthresh*errorthresh;
+    }
+
+    /// \brief scales the rotation error (radians) with respect to the translation error (meters)
+    void SetRotationWeight(dReal frotationweight) {
+        _fRotationWeight = frotationweight;
+    }
+
+    /// \brief overrides the joint velocity limits of the arm dofs read from the robot in Init
+    void SetVelocityLimits(const std::vector<dReal>& vmaxvelocities) {
+        OPENRAVE_ASSERT_OP(vmaxvelocities.size(),==,_varmindices.size());
+        _vmaxvelocities = vmaxvelocities;
+    }
+
+    /// \brief if > 0, the motion from one goal to the next is bounded by the joint velocity limits times ftimestep
+    void SetTimeStep(dReal ftimestep) {
+        _fTimeStep = ftimestep;
+    }
+
+    /// \brief maximum number of steps to converge to one goal
+    void SetMaxIterations(int nMaxIterations) {
+        _nMaxIterations = nMaxIterations;
+    }
+
+    /** \brief moves the arm from vsolution toward tgoal until the error is below the threshold
+
+        \param tgoal goal transform of the manipulator in the world frame
+        \param vsolution arm dof values to start from. Set to the solution on success, and to the closest values found otherwise
+        \return true if the goal was reached
+     */
+    bool Solve(const Transform& tgoal, std::vector<dReal>& vsolution)
+    {
+        OPENRAVE_ASSERT_OP(vsolution.size(),==,_varmindices.size());
+        std::copy(vsolution.begin(), vsolution.end(), _vcurvalues.begin());
+        _ComputeStepBounds(vsolution);
+        const bool bSuccess = _Solve(tgoal);
+        std::copy(_vcurvalues.begin(), _vcurvalues.end(), vsolution.begin());
+        return bSuccess;
+    }
+
+protected:
+    /// \brief sets the absolute bounds the arm can move to from vprevvalues
+    void _ComputeStepBounds(const std::vector<dReal>& vprevvalues)
+    {
+        for(size_t i = 0; i < _varmindices.size(); ++i) {
+            _vsteplower[i] = _vlower[i];
+            _vstepupper[i] = _vupper[i];
+            if( _fTimeStep > 0 && _vmaxvelocities[i] > 0 ) {
+                _vsteplower[i] = max(_vsteplower[i], vprevvalues[i] - _vmaxvelocities[i]*_fTimeStep);
+                _vstepupper[i] = min(_vstepupper[i], vprevvalues[i] + _vmaxvelocities[i]*_fTimeStep);
+            }
+        }
+    }
+
+    /// \brief iterates from _vcurvalues toward tgoal
+    bool _Solve(const Transform& tgoal)
+    {
+        RobotBasePtr probot = _probot.lock();
+        if( !probot ) {
+            return false;
+        }
+        const int armdof = _varmindices.size();
+        dReal error[6];
+        for(int iter = 0; iter < _nMaxIterations; ++iter) {
+            probot->SetDOFValues(_vcurvalues, KinBody::CLA_Nothing, _varmindices);
+            const Transform tcur = _pmanip->GetTransform();
+            const Vector vtranserror = tgoal.trans - tcur.trans;
+            const Vector vroterror = axisAngleFromQuat(quatMultiply(tgoal.rot, quatInverse(tcur.rot)));
+            error[0] = vtranserror.x; error[1] = vtranserror.y; error[2] = vtranserror.z;
+            error[3] = _fRotationWeight*vroterror.x; error[4] = _fRotationWeight*vroterror.y; error[5] = _fRotationWeight*vroterror.z;
+            dReal ferror2 = 0;
+            for(int i = 0; i < 6; ++i) {
+                ferror2 += error[i]*error[i];
+            }
+            if( ferror2 <= _fErrorThresh2 ) {
+                return true;
+            }
+
+            probot->ComputeJacobianTranslation(_eelinkindex, tcur.trans, _vtransjacobian, _varmindices);
+            probot->ComputeJacobianAxisAngle(_eelinkindex, _vrotjacobian, _varmindices);
+            for(int i = 0; i < 3*armdof; ++i) {
+                _vjacobian[i] = _vtransjacobian[i];
+                _vjacobian[3*armdof+i] = _fRotationWeight*_vrotjacobian[i];
+            }
+            if( !_SolveBoundedStep(error) ) {
+                return false;
+            }
+            bool bMoved = false;
+            for(int i = 0; i < armdof; ++i) {
+                _vcurvalues[i] += _vdeltavalues[i];
+                bMoved |= RaveFabs(_vdeltavalues[i]) > g_fEpsilon;
+            }
+            if( !bMoved ) {
+                return false; // stuck at the bounds
+            }
+        }
+        probot->SetDOFValues(_vcurvalues, KinBody::CLA_Nothing, _varmindices);
+        const Transform tcur = _pmanip->GetTransform();
+        const Vector vroterror = axisAngleFromQuat(quatMultiply(tgoal.rot, quatInverse(tcur.rot)));
+        return (tgoal.trans - tcur.trans).lengthsqr3() + _fRotationWeight*_fRotationWeight*vroterror.lengthsqr3() <= _fErrorThresh2;
+    }
+
+    /// \brief computes _vdeltavalues from the current _vjacobian and error, keeping _vcurvalues + _vdeltavalues within the step bounds
+    bool _SolveBoundedStep(const dReal* error)
+    {
+        const int armdof = _varmindices.size();
+        for(int i = 0; i < armdof; ++i) {
+            _vdeltavalues[i] = 0;
+            _vfree[i] = 1;
+        }
+        const dReal fdamping2 = _fDamping*_fDamping;
+        dReal residual[6], A[36], y[6];
+        for(int iactiveset = 0; iactiveset <= armdof; ++iactiveset) {
+            // residual of the clamped dofs
+            for(int r = 0; r < 6; ++r) {
+                residual[r] = error[r];
+                for(int i = 0; i < armdof; ++i) {
+                    if( !_vfree[i] ) {
+                        residual[r] -= _vjacobian[r*armdof+i]*_vdeltavalues[i];
+                    }
+                }
+            }
+            // (Jf Jf^T + lambda^2 I) y = residual, dqf = Jf^T y
+            for(int r = 0; r < 6; ++r) {
+                for(int c = 0; c <= r; ++c) {
+                    dReal f = r == c ? fdamping2 : 0;
+                    for(int i = 0; i < armdof; ++i) {
+                        if( _vfree[i] ) {
+                            f += _vjacobian[r*armdof+i]*_vjacobian[c*armdof+i];
+                        }
+                    }
+                    A[r*6+c] = f;
+                }
+            }
+            if( !_SolveCholesky6(A, residual, y) ) {
+                return false;
+            }
+            bool bClamped = false;
+            for(int i = 0; i < armdof; ++i) {
+                if( !_vfree[i] ) {
+                    continue;
+                }
+                dReal fdelta = 0;
+                for(int r = 0; r < 6; ++r) {
+                    fdelta += _vjacobian[r*armdof+i]*y[r];
+                }
+                _vdeltavalues[i] = fdelta;
+                const dReal fnewvalue = _vcurvalues[i] + fdelta;
+                if( fnewvalue < _vsteplower[i] ) {
+                    _vdeltavalues[i] = _vsteplower[i] - _vcurvalues[i];
+                    _vfree[i] = 0;
+                    bClamped = true;
+                }
+                else if( fnewvalue > _vstepupper[i] ) {
+                    _vdeltavalues[i] = _vstepupper[i] - _vcurvalues[i];
+                    _vfree[i] = 0;
+                    bClamped = true;
+                }
+            }
+            if( !bClamped ) {
+                break;
+            }
+        }
+        return true;
+    }
+
+    /// \brief solves A x = b for a symmetric positive definite 6x6 A, of which only the lower triangle is used
+    static bool _SolveCholesky6(dReal* A, const dReal* b, dReal* x)
+    {
+        for(int j = 0; j < 6; ++j) {
+            dReal fdiag = A[j*6+j];
+            for(int k = 0; k < j; ++k) {
+                fdiag -= A[j*6+k]*A[j*6+k];
+            }
+            if( fdiag <= 0 ) {
+                return false;
+            }
+            fdiag = RaveSqrt(fdiag);
+            A[j*6+j] = fdiag;
+            for(int i = j+1; i < 6; ++i) {
+                dReal f = A[i*6+j];
+                for(int k = 0; k < j; ++k) {
+                    f -= A[i*6+k]*A[j*6+k];
+                }
+                A[i*6+j] = f/fdiag;
+            }
+        }
+        for(int i = 0; i < 6; ++i) {
+            dReal f = b[i];
+            for(int k = 0; k < i; ++k) {
+                f -= A[i*6+k]*x[k];
+            }
+            x[i] = f/A[i*6+i];
+        }
+        for(int i = 5; i >= 0; --i) {
+            dReal f = x[i];
+            for(int k = i+1; k < 6; ++k) {
+                f -= A[k*6+i]*x[k];
+            }
+            x[i] = f/A[i*6+i];
+        }
+        return true;
+    }
+
+    RobotBase::ManipulatorConstPtr _pmanip;
+    RobotBaseWeakPtr _probot;
+    int _eelinkindex;
+    std::vector<int> _varmindices;
+    std::vector<dReal> _vlower, _vupper, _vmaxvelocities;
+    dReal _fDamping, _fErrorThresh2, _fRotationWeight, _fTimeStep;
+    int _nMaxIterations;
+
+    // workspaces
+    std::vector<dReal> _vcurvalues, _vdeltavalues, _vsteplower, _vstepupper;
+    std::vector<uint8_t> _vfree; ///< 1 if the dof is not clamped by the active set
+    std::vector<dReal> _vtransjacobian, _vrotjacobian; ///< 3 x armdof each
+    std::vector<dReal> _vjacobian; ///< 6 x armdof, translation rows followed by the weighted rotation rows
+};
+
+} // end namespace rplanners
+
+#endif
@@ -17,6 +17,128 @@ namespace OpenRAVE {
 
 namespace PiecewisePolynomialsInternal {
 
+namespace {
+
+const int s_maxCheckedDegree = 5; ///< polynomials of higher degrees are checked through Polynomial::FindAllLocalExtrema
+const int s_maxCriticalPoints = 16; ///< upper bound of the number of critical points kept for each derivative of a quintic
+
+/// \brief s_fDerivativeFactors[ideriv][icoeff] is the factor multiplied to the coefficient of t^(icoeff + ideriv) of a quintic
+///        to get the coefficient of t^icoeff of its ideriv-th derivative.
+const dReal s_fDerivativeFactors[4][s_maxCheckedDegree + 1] = {
+    {1, 1, 1, 1, 1, 1},
+    {1, 2, 3, 4, 5, 0},
+    {2, 6, 12, 20, 0, 0},
+    {6, 24, 60, 0, 0, 0},
+};
+
+/// \brief Evaluate the polynomial with the given coefficients (weakest term first) at t using Horner's scheme.
+inline dReal EvalCoeffs(const dReal* vcoeffs, const int degree, const dReal t)
+{
+    dReal val = vcoeffs[degree];
+    for( int icoeff = degree - 1; icoeff >= 0; --icoeff ) {
+        val = val*t + vcoeffs[icoeff];
+    }
+    return val;
+}
+
+/// \brief Find the root of q in (a, b), given that q(a) and q(b) have opposite signs and q is monotonic in [a, b]. Newton
+///        steps are taken as long as they stay inside the bracket, which shrinks at every iteration. Otherwise, bisect.
+dReal FindBracketedRoot(const dReal* q, const dReal* dq, const int degree, dReal a, dReal b, const dReal fa)
+{
+    const bool bNegativeAtA = fa < 0;
+    const dReal tol = 4*std::numeric_limits<dReal>::epsilon()*std::max(RaveFabs(a), RaveFabs(b));
+    dReal t = 0.5*(a + b);
+    for( int iter = 0; iter < 100; ++iter ) {
+        const dReal ft = EvalCoeffs(q, degree, t);
+        if( ft == 0 ) {
+            return t;
+        }
+        if( (ft < 0) == bNegativeAtA ) {
+            a = t;
+        }
+        else {
+            b = t;
+        }
+        if( b - a <= tol ) {
+            break;
+        }
+        const dReal dft = EvalCoeffs(dq, degree - 1, t);
+        dReal tnext = 0.5*(a + b);
+        if( dft != 0 ) {
+            const dReal tnewton = t - ft/dft;
+            if( tnewton > a && tnewton < b ) {
+                if( RaveFabs(tnewton - t) <= tol ) {
+                    return tnewton;
+                }
+                tnext = tnewton;
+            }
+        }
+        t = tnext;
+    }
+    return 0.5*(a + b);
+}
+
+/// \brief Find the points in (0, T) at which q changes sign, in ascending order.
+///
+/// \param q coefficients of q (weakest term first)
+/// \param dq coefficients of the derivative of q
+/// \param degree degree of q, which must be at most four
+/// \param vdqroots points in (0, T) at which dq changes sign, in ascending order. q is monotonic in between.
+/// \param[out] vroots must have room for s_maxCriticalPoints values.
+/// \return the number of points written to vroots
+///
+/// Points of vdqroots at which q is almost zero are also kept. q might have a pair of roots too close to them to be
+/// separated, and checking more points than necessary never hides a violation.
+int FindSignChanges(const dReal* q, const dReal* dq, const int degree, const dReal T, const dReal* vdqroots, const int numdqroots, dReal* vroots)
+{
+    int numroots = 0;
+    if( degree == 1 ) {
+        if( q[1] != 0 ) {
+            const dReal t = -q[0]/q[1];
+            if( t > 0 && t < T ) {
+                vroots[numroots++] = t;
+            }
+        }
+        return numroots;
+    }
+    if( degree == 2 && q[2] != 0 ) {
+        // Closed-form formula that avoids cancellation. q changes sign only if the discriminant is strictly positive.
+        const dReal det = q[1]*q[1] - 4*q[2]*q[0];
+        if( det > 0 ) {
+            const dReal temp = q[1] >= 0 ? -0.5*(q[1] + RaveSqrt(det)) : -0.5*(q[1] - RaveSqrt(det));
+            dReal t0 = temp/q[2];
+            dReal t1 = temp != 0 ? q[0]/temp : t0;
+            if( t0 > t1 ) {
+                std::swap(t0, t1);
+            }
+            if( t0 > 0 && t0 < T ) {
+                vroots[numroots++] = t0;
+            }
+            if( t1 > t0 && t1 > 0 && t1 < T ) {
+                vroots[numroots++] = t1;
+            }
+        }
+        return numroots;
+    }
+
+    dReal a = 0, fa = q[0];
+    for( int iinterval = 0; iinterval <= numdqroots; ++iinterval ) {
+        const dReal b = iinterval < numdqroots ? vdqroots[iinterval] : T;
+        const dReal fb = EvalCoeffs(q, degree, b);
+        if( (fa < 0 && fb > 0) || (fa > 0 && fb < 0) ) {
+            vroots[numroots++] = FindBracketedRoot(q, dq, degree, a, b, fa);
+        }
+        if( iinterval < numdqroots && RaveFabs(fb) <= g_fPolynomialEpsilon ) {
+            vroots[numroots++] = b;
+        }
+        a = b;
+        fa = fb;
+    }
+    return numroots;
+}
+
+} // end namespace
+
 const char* GetPolynomialCheckReturnString(PolynomialCheckReturn ret)
 {
     switch(ret) {
@@ -42,6 +164,9 @@ PolynomialChecker::PolynomialChecker(size_t ndof_, int envid_) : ndof(ndof_), en
     _cacheXVect.resize(ndof);
     _cacheVVect.resize(ndof);
     _cacheAVect.resize(ndof);
+    _cacheCoeffsVect.resize((s_maxCheckedDegree + 1)*ndof);
+    _cacheDurationsVect.resize(ndof);
+    _cacheFinalValuesVect.resize(4*ndof);
 }
 
 void PolynomialChecker::Initialize(size_t ndof_, int envid_)
@@ -54,6 +179,9 @@ void PolynomialChecker::Initialize(size_t ndof_, int envid_)
     _cacheXVect.resize(ndof_);
     _cacheVVect.resize(ndof_);
     _cacheAVect.resize(ndof_);
+    _cacheCoeffsVect.resize((s_maxCheckedDegree + 1)*ndof_);
+    _cacheDurationsVect.resize(ndof_);
+    _cacheFinalValuesVect.resize(4*ndof_);
 }
 
 PolynomialCheckReturn PolynomialChecker::CheckPolynomialValues(const Polynomial& p, const dReal t, const dReal x, const dReal v, const dReal a)
@@ -196,6 +324,10 @@ PolynomialCheckReturn PolynomialChecker::CheckPolynomialLimits(const Polynomial&
     }
 
     // Now bounadries are ok. Check in-between values.
+    if( p.degree <= (size_t)s_maxCheckedDegree ) {
+        return _CheckCriticalPoints(&p.vcoeffs[0], (int)p.degree, T, xmin, xmax, vm, am, jm, bCheckVelocity, bCheckAcceleration, bCheckJerk);
+    }
+
     // Check position limits
     for( std::vector<Coordinate>::const_iterator it = p.GetExtrema().begin(); it != p.GetExtrema().end(); ++it ) {
         if( it->point >= -g_fPolynomialEpsilon && it->point <= T + g_fPolynomialEpsilon ) {
@@ -268,6 +400,55 @@ PolynomialCheckReturn PolynomialChecker::CheckPolynomialLimits(const Polynomial&
     return PCR_Normal;
 }
 
+PolynomialCheckReturn PolynomialChecker::_CheckCriticalPoints(const dReal* vcoeffs, const int degree, const dReal T, const dReal xmin, const dReal xmax, const dReal vm, const dReal am, const dReal jm,
+                                                              const bool bCheckVelocity, const bool bCheckAcceleration, const bool bCheckJerk)
+{
+    BOOST_ASSERT(degree <= s_maxCheckedDegree);
+    if( degree <= 0 ) {
+        return PCR_Normal;
+    }
+
+    // vderivcoeffs[ideriv] are the coefficients of the ideriv-th derivative of p, which has degree (degree - ideriv).
+    dReal vderivcoeffs[s_maxCheckedDegree + 1][s_maxCheckedDegree + 1];
+    for( int icoeff = 0; icoeff <= degree; ++icoeff ) {
+        vderivcoeffs[0][icoeff] = vcoeffs[icoeff];
+    }
+    for( int ideriv = 1; ideriv <= degree; ++ideriv ) {
+        for( int icoeff = 0; icoeff <= degree - ideriv; ++icoeff ) {
+            vderivcoeffs[ideriv][icoeff] = (icoeff + 1)*vderivcoeffs[ideriv - 1][icoeff + 1];
+        }
+    }
+
+    // vcriticalpoints[ideriv] are the points in (0, T) at which the ideriv-th derivative changes sign, i.e. the local
+    // extrema of the (ideriv - 1)-th derivative. Compute them starting from the highest derivative since each derivative
+    // is monotonic in between the critical points of the next one.
+    dReal vcriticalpoints[s_maxCheckedDegree + 1][s_maxCriticalPoints];
+    int numcriticalpoints[s_maxCheckedDegree + 1];
+    numcriticalpoints[degree] = 0; // constant
+    for( int ideriv = degree - 1; ideriv >= 1; --ideriv ) {
+        numcriticalpoints[ideriv] = FindSignChanges(vderivcoeffs[ideriv], vderivcoeffs[ideriv + 1], degree - ideriv, T,
+                                                    vcriticalpoints[ideriv + 1], numcriticalpoints[ideriv + 1], vcriticalpoints[ideriv]);
+    }
+
+    const bool vbcheck[4] = {true, bCheckVelocity, bCheckAcceleration, bCheckJerk};
+    const dReal vlower[4] = {xmin, -vm, -am, -jm};
+    const dReal vupper[4] = {xmax, vm, am, jm};
+    const dReal vepsilon[4] = {g_fPolynomialEpsilon, g_fPolynomialEpsilon, g_fPolynomialEpsilon, epsilonForJerkLimitsChecking};
+    const PolynomialCheckReturn vret[4] = {PCR_PositionLimitsViolation, PCR_VelocityLimitsViolation, PCR_AccelerationLimitsViolation, PCR_JerkLimitsViolation};
+    for( int ideriv = 0; ideriv < 4 && ideriv < degree; ++ideriv ) {
+        if( !vbcheck[ideriv] ) {
+            continue;
+        }
+        for( int ipoint = 0; ipoint < numcriticalpoints[ideriv + 1]; ++ipoint ) {
+            const dReal t = vcriticalpoints[ideriv + 1][ipoint];
+            if( !_CheckLimit(t, EvalCoeffs(vderivcoeffs[ideriv], degree - ideriv, t), vlower[ideriv], vupper[ideriv], vepsilon[ideriv]) ) {
+                return vret[ideriv];
+            }
+        }
+    }
+    return PCR_Normal;
+}
+
 PolynomialCheckReturn PolynomialChecker::CheckPiecewisePolynomial(const PiecewisePolynomial& p, const dReal xmin, const dReal xmax, const dReal vm, const dReal am, const dReal jm,
                                                                   const dReal x0, const dReal x1, const dReal v0, const dReal v1, const dReal a0, const dReal a1)
 {
@@ -400,8 +581,85 @@ PolynomialCheckReturn PolynomialChecker::CheckChunkLimits(const Chunk& c, const
                                                           const std::vector<dReal>& vmVect, const std::vector<dReal>& amVect, const std::vector<dReal>& jmVect)
 {
     PolynomialCheckReturn ret = PCR_Normal;
+    bool bAllChecked = true; // true if all polynomials can be checked by _CheckCriticalPoints
+    for( size_t idof = 0; idof < ndof; ++idof ) {
+        if( c.vpolynomials[idof].degree > (size_t)s_maxCheckedDegree ) {
+            bAllChecked = false;
+            break;
+        }
+    }
+    if( !bAllChecked ) {
+        for( size_t idof = 0; idof < ndof; ++idof ) {
+            ret = CheckPolynomialLimits(c.vpolynomials[idof], xminVect[idof], xmaxVect[idof], vmVect[idof], amVect[idof], jmVect[idof]);
+            if( ret != PCR_Normal ) {
+#ifdef JERK_LIMITED_POLY_CHECKER_DEBUG
+                _failedDOF = idof;
+#endif
+                return ret;
+            }
+        }
+        return PCR_Normal;
+    }
+
+    // Lay out the coefficients so that each coefficient of all DOFs is contiguous. The loops over DOFs below then have no
+    // dependencies between iterations and can be vectorized by the compiler.
+    std::fill(_cacheCoeffsVect.begin(), _cacheCoeffsVect.end(), 0);
     for( size_t idof = 0; idof < ndof; ++idof ) {
-        ret = CheckPolynomialLimits(c.vpolynomials[idof], xminVect[idof], xmaxVect[idof], vmVect[idof], amVect[idof], jmVect[idof]);
+        const Polynomial& p = c.vpolynomials[idof];
+        for( size_t icoeff = 0; icoeff <= p.degree; ++icoeff ) {
+            _cacheCoeffsVect[icoeff*ndof + idof] = p.vcoeffs[icoeff];
+        }
+        _cacheDurationsVect[idof] = p.duration;
+    }
+
+    // Evaluate the position, velocity, acceleration, and jerk of all DOFs at their durations.
+    const dReal* pcoeffs = &_cacheCoeffsVect[0];
+    const dReal* pdurations = &_cacheDurationsVect[0];
+    for( int ideriv = 0; ideriv < 4; ++ideriv ) {
+        dReal* pvalues = &_cacheFinalValuesVect[ideriv*ndof];
+        const dReal* pfactors = s_fDerivativeFactors[ideriv];
+        const int maxcoeff = s_maxCheckedDegree - ideriv;
+        const dReal* pleadcoeffs = pcoeffs + (maxcoeff + ideriv)*ndof;
+        for( size_t idof = 0; idof < ndof; ++idof ) {
+            pvalues[idof] = pfactors[maxcoeff]*pleadcoeffs[idof];
+        }
+        for( int icoeff = maxcoeff - 1; icoeff >= 0; --icoeff ) {
+            const dReal fFactor = pfactors[icoeff];
+            const dReal* pcurcoeffs = pcoeffs + (icoeff + ideriv)*ndof;
+            for( size_t idof = 0; idof < ndof; ++idof ) {
+                pvalues[idof] = pvalues[idof]*pdurations[idof] + fFactor*pcurcoeffs[idof];
+            }
+        }
+    }
+
+    // Check the DOFs one by one in the same order as CheckPolynomialLimits so that the same violation is reported.
+    const dReal* pfinalvalues = &_cacheFinalValuesVect[0];
+    for( size_t idof = 0; idof < ndof; ++idof ) {
+        const Polynomial& p = c.vpolynomials[idof];
+        const dReal T = pdurations[idof];
+        const dReal xmin = xminVect[idof], xmax = xmaxVect[idof], vm = vmVect[idof], am = amVect[idof], jm = jmVect[idof];
+        const bool vbcheck[4] = {true, p.degree > 0 && vm > g_fPolynomialEpsilon, p.degree > 1 && am > g_fPolynomialEpsilon, p.degree > 2 && jm > g_fPolynomialEpsilon};
+        const dReal vlower[4] = {xmin, -vm, -am, -jm};
+        const dReal vupper[4] = {xmax, vm, am, jm};
+        const dReal vepsilon[4] = {g_fPolynomialEpsilon, g_fPolynomialEpsilon, g_fPolynomialEpsilon, epsilonForJerkLimitsChecking};
+        const PolynomialCheckReturn vret[4] = {PCR_PositionLimitsViolation, PCR_VelocityLimitsViolation, PCR_AccelerationLimitsViolation, PCR_JerkLimitsViolation};
+        for( int ideriv = 0; ideriv < 4; ++ideriv ) {
+            if( !vbcheck[ideriv] ) {
+                continue;
+            }
+            const dReal initialValue = s_fDerivativeFactors[ideriv][0]*pcoeffs[ideriv*ndof + idof];
+            if( !_CheckLimit(0, initialValue, vlower[ideriv], vupper[ideriv], vepsilon[ideriv]) ) {
+                ret = vret[ideriv];
+                break;
+            }
+            if( !_CheckLimit(T, pfinalvalues[ideriv*ndof + idof], vlower[ideriv], vupper[ideriv], vepsilon[ideriv]) ) {
+                ret = vret[ideriv];
+                break;
+            }
+        }
+        if( ret == PCR_Normal ) {
+            ret = _CheckCriticalPoints(&p.vcoeffs[0], (int)p.degree, T, xmin, xmax, vm, am, jm, vbcheck[1], vbcheck[2], vbcheck[3]);
+        }
         if( ret != PCR_Normal ) {
 #ifdef JERK_LIMITED_POLY_CHECKER_DEBUG
             _failedDOF = idof;
@@ -412,6 +670,23 @@ PolynomialCheckReturn PolynomialChecker::CheckChunkLimits(const Chunk& c, const
     return PCR_Normal;
 }
 
+PolynomialCheckReturn PolynomialChecker::CheckChunksLimits(const std::vector<Chunk>& vchunks, const std::vector<dReal>& xminVect, const std::vector<dReal>& xmaxVect,
+                                                           const std::vector<dReal>& vmVect, const std::vector<dReal>& amVect, const std::vector<dReal>& jmVect)
+{
+    PolynomialCheckReturn ret = PCR_Normal;
+    for( std::vector<Chunk>::const_iterator itchunk = vchunks.begin(); itchunk != vchunks.end(); ++itchunk ) {
+        ret = CheckChunkLimits(*itchunk, xminVect, xmaxVect, vmVect, amVect, jmVect);
+        if( ret != PCR_Normal ) {
+            _failedIndex = (itchunk - vchunks.begin());
+#ifdef JERK_LIMITED_POLY_CHECKER_DEBUG
+            RAVELOG_VERBOSE_FORMAT("chunkIndex=%d/%d; idof=%d; t=%.15f; value=%.15f; expected=%.15f; result=%s", _failedIndex%vchunks.size()%_failedDOF%_failedPoint%_failedValue%_expectedValue%GetPolynomialCheckReturnString(ret));
+#endif
+            return ret;
+        }
+    }
+    return PCR_Normal;
+}
+
 PolynomialCheckReturn PolynomialChecker::CheckPiecewisePolynomialTrajectory(const PiecewisePolynomialTrajectory& traj, const std::vector<dReal>& xminVect, const std::vector<dReal>& xmaxVect,
                                                                             const std::vector<dReal>& vmVect, const std::vector<dReal>& amVect, const std::vector<dReal>& jmVect,
                                                                             const std::vector<dReal>& x0Vect, const std::vector<dReal>& x1Vect,
@@ -121,10 +121,16 @@ public:
     /// \brief Check if the input chunk evaluates to the given values at time t.
     PolynomialCheckReturn CheckChunkValues(const Chunk& c, dReal t, const std::vector<dReal>& xVect, const std::vector<dReal>& vVect, const std::vector<dReal>& aVect);
 
-    /// \brief Check if the input chunk respects all limits
+    /// \brief Check if the input chunk respects all limits. The boundary values of all DOFs are evaluated together and the
+    ///        critical points of polynomials of degree up to five are computed without allocating memory.
     PolynomialCheckReturn CheckChunkLimits(const Chunk& c, const std::vector<dReal>& xminVect, const std::vector<dReal>& xmaxVect,
                                            const std::vector<dReal>& vmVect, const std::vector<dReal>& amVect, const std::vector<dReal>& jmVect);
 
+    /// \brief Check if all the input chunks respect all limits. Unlike CheckChunks, continuity between chunks is not checked.
+    ///        If a chunk violates the limits, _failedIndex is set to its index.
+    PolynomialCheckReturn CheckChunksLimits(const std::vector<Chunk>& vchunks, const std::vector<dReal>& xminVect, const std::vector<dReal>& xmaxVect,
+                                            const std::vector<dReal>& vmVect, const std::vector<dReal>& amVect, const std::vector<dReal>& jmVect);
+
     /// \brief Check if the input sequence of chunks is consistent and respects all limits
     PolynomialCheckReturn CheckChunks(const std::vector<Chunk>& chunks, const std::vector<dReal>& xminVect, const std::vector<dReal>& xmaxVect,
                                       const std::vector<dReal>& vmVect, const std::vector<dReal>& amVect, const std::vector<dReal>& jmVect,
@@ -147,16 +153,38 @@ public:
 
     std::vector<Coordinate> _cacheCoordsVect;
     std::vector<dReal> _cacheXVect, _cacheVVect, _cacheAVect;
+    std::vector<dReal> _cacheCoeffsVect; ///< coefficients of all DOFs of a chunk padded to quintic, stored as _cacheCoeffsVect[icoeff*ndof + idof]
+    std::vector<dReal> _cacheDurationsVect; ///< durations of all DOFs of a chunk
+    std::vector<dReal> _cacheFinalValuesVect; ///< position, velocity, acceleration, and jerk of all DOFs of a chunk at their durations, stored as _cacheFinalValuesVect[ideriv*ndof + idof]
 
+    size_t _failedIndex = 0; ///< index of the chunk that violated the limits in the last call to CheckChunksLimits
 #ifdef JERK_LIMITED_POLY_CHECKER_DEBUG
     dReal _failedPoint;
     dReal _failedValue;
     dReal _expectedValue;
-    size_t _failedIndex;
     size_t _failedDOF;
 #endif
 
 private:
+    /// \brief Check the values of p, p', p'', and p''' at their critical points in (0, T), where p has the given coefficients
+    ///        (weakest term first) and degree. degree must be at most five. Boundary values are not checked.
+    PolynomialCheckReturn _CheckCriticalPoints(const dReal* vcoeffs, const int degree, const dReal T, const dReal xmin, const dReal xmax, const dReal vm, const dReal am, const dReal jm,
+                                               const bool bCheckVelocity, const bool bCheckAcceleration, const bool bCheckJerk);
+
+    /// \brief Check if val is within [lower - epsilon, upper + epsilon]. If not, keep the failure info for debugging.
+    inline bool _CheckLimit(const dReal t, const dReal val, const dReal lower, const dReal upper, const dReal epsilon)
+    {
+        if( val > upper + epsilon || val < lower - epsilon ) {
+#ifdef JERK_LIMITED_POLY_CHECKER_DEBUG
+            _failedPoint = t;
+            _failedValue = val;
+            _expectedValue = val > upper ? upper : lower;
+#endif
+            return false;
+        }
+        return true;
+    }
+
     // Specific tolerance for checking discrepancies.
     dReal epsilonForPositionDiscrepancyChecking = g_fPolynomialEpsilon;
     dReal epsilonForVelocityDiscrepancyChecking = g_fPolynomialEpsilon;
@@ -192,6 +192,31 @@ public:
             std::vector<PiecewisePolynomials::Chunk>& vFinalChunks = _cacheFinalChunks; // for storing chunks before putting them into the final trajcetory
             PiecewisePolynomials::Chunk &trimmedChunk = _cacheTrimmedChunk, &remChunk = _cacheRemChunk;
 
+            // Check joint limits + velocity/acceleration/jerk limits of all the chunks not yet checked in one batch
+            tempInterpolatedChunks.resize(0);
+            FOREACHC(itChunk, pwptraj.vchunks) {
+                if( !itChunk->constraintChecked ) {
+                    tempInterpolatedChunks.push_back(*itChunk);
+                }
+            }
+            if( tempInterpolatedChunks.size() > 0 ) {
+                int limitsret = _limitsChecker.CheckChunksLimits(tempInterpolatedChunks, _parameters->_vConfigLowerLimit, _parameters->_vConfigUpperLimit, _parameters->_vConfigVelocityLimit, _parameters->_vConfigAccelerationLimit, _parameters->_vConfigJerkLimit);
+                if( limitsret != PiecewisePolynomials::PCR_Normal ) {
+                    // _failedIndex is the index among the unchecked chunks, find the corresponding chunk of the trajectory
+                    size_t iChunk = 0, iUncheckedChunk = 0;
+                    for( ; iChunk < pwptraj.vchunks.size(); ++iChunk ) {
+                        if( !pwptraj.vchunks[iChunk].constraintChecked ) {
+                            if( iUncheckedChunk == _limitsChecker._failedIndex ) {
+                                break;
+                            }
+                            ++iUncheckedChunk;
+                        }
+                    }
+                    RAVELOG_WARN_FORMAT("env=%d, Detected limits violation after shortcutting; iChunk=%d; limitsret=0x%x", _envId%iChunk%limitsret);
+                    return PS_Failed;
+                }
+            }
+
             for( std::vector<PiecewisePolynomials::Chunk>::const_iterator itChunk = pwptraj.vchunks.begin(); itChunk != pwptraj.vchunks.end(); ++itChunk ) {
                 ++_progress._iteration;
                 if( _CallCallbacks(_progress) == PA_Interrupt ) {
@@ -207,13 +232,6 @@ public:
                     vFinalChunks[0] = trimmedChunk;
                 }
                 else {
-                    // Check joint limits + velocity/acceleration/jerk limits
-                    int limitsret = _limitsChecker.CheckChunkLimits(trimmedChunk, _parameters->_vConfigLowerLimit, _parameters->_vConfigUpperLimit, _parameters->_vConfigVelocityLimit, _parameters->_vConfigAccelerationLimit, _parameters->_vConfigJerkLimit);
-                    if( limitsret != PiecewisePolynomials::PCR_Normal ) {
-                        RAVELOG_WARN_FORMAT("env=%d, Detected limits violation after shortcutting; iChunk=%d; limitsret=0x%x", _envId%(itChunk - pwptraj.vchunks.begin())%limitsret);
-                        return PS_Failed;
-                    }
-
                     // Check other remaining constraints. Ignore the first and the last bits of the trajectory.
                     bool bTrimmedFront = false;
                     bool bTrimmedBack = false;
@@ -3,6 +3,7 @@
 #define RAMP_OPTIM_PARABOLIC_COMMON_H
 
 #include <openrave/openrave.h>
+#include <type_traits>
 
 namespace OpenRAVE {
 
@@ -165,6 +166,27 @@ inline void ScaleVector(std::vector<dReal>& v, dReal scale)
     }
 }
 
+/// \brief Call fn(std::integral_constant<size_t, N>()) with N = ndof for the common manipulator dofs 6, 7 and 8, and with N = 0
+/// for all other dofs. fn can then use N as a compile-time loop bound so that the compiler unrolls and vectorizes the loop.
+template <typename Fn>
+inline void DispatchFixedDOF(size_t ndof, Fn&& fn)
+{
+    switch( ndof ) {
+    case 6:
+        fn(std::integral_constant<size_t, 6>());
+        break;
+    case 7:
+        fn(std::integral_constant<size_t, 7>());
+        break;
+    case 8:
+        fn(std::integral_constant<size_t, 8>());
+        break;
+    default:
+        fn(std::integral_constant<size_t, 0>());
+        break;
+    }
+}
+
 /// \brief Solve the quadratic equation and return the number of roots found
 inline int SolveQuadratic(dReal a, dReal b, dReal c, dReal& x1, dReal& x2)
 {
@@ -619,6 +619,51 @@ void ParabolicCurve::TrimBack(dReal t)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // RampND
+// The kernels below loop over NDOF values when NDOF > 0, otherwise over the runtime ndof. See DispatchFixedDOF.
+
+/// \brief x = x0 + t*(v0 + 0.5*t*a) for every dof
+template <size_t NDOF>
+static inline void _EvalPosKernel(const dReal* pdata, size_t ndof, dReal t, dReal* px)
+{
+    const size_t n = NDOF > 0 ? NDOF : ndof;
+    const dReal* px0 = pdata + DATA_OFFSET_X0*n;
+    const dReal* pv0 = pdata + DATA_OFFSET_V0*n;
+    const dReal* pa = pdata + DATA_OFFSET_A*n;
+    for (size_t idof = 0; idof < n; ++idof) {
+        px[idof] = px0[idof] + t*(pv0[idof] + 0.5*t*pa[idof]);
+    }
+}
+
+/// \brief v = v0 + t*a for every dof
+template <size_t NDOF>
+static inline void _EvalVelKernel(const dReal* pdata, size_t ndof, dReal t, dReal* pv)
+{
+    const size_t n = NDOF > 0 ? NDOF : ndof;
+    const dReal* pv0 = pdata + DATA_OFFSET_V0*n;
+    const dReal* pa = pdata + DATA_OFFSET_A*n;
+    for (size_t idof = 0; idof < n; ++idof) {
+        pv[idof] = pv0[idof] + t*pa[idof];
+    }
+}
+
+/// \brief Compute the accelerations of a ramp of duration t > 0 from the boundary conditions stored in pdata, using the same
+/// procedure as in ParabolicCurve::SetSegment.
+template <size_t NDOF>
+static inline void _ComputeAccelerationKernel(dReal* pdata, size_t ndof, dReal t)
+{
+    const size_t n = NDOF > 0 ? NDOF : ndof;
+    const dReal* px0 = pdata + DATA_OFFSET_X0*n;
+    const dReal* px1 = pdata + DATA_OFFSET_X1*n;
+    const dReal* pv0 = pdata + DATA_OFFSET_V0*n;
+    const dReal* pv1 = pdata + DATA_OFFSET_V1*n;
+    dReal* pa = pdata + DATA_OFFSET_A*n;
+    dReal tSqr = t*t;
+    dReal divMult = 1/(t*(0.5*tSqr + 2));
+    for (size_t idof = 0; idof < n; ++idof) {
+        pa[idof] = -(pv0[idof]*tSqr + t*(px0[idof] - px1[idof]) + 2*(pv0[idof] - pv1[idof]))*divMult;
+    }
+}
+
 RampND::RampND(size_t ndof)
 {
     OPENRAVE_ASSERT_OP(ndof, >, 0);
@@ -653,12 +698,9 @@ RampND::RampND(const std::vector<dReal>& x0Vect, const std::vector<dReal>& x1Vec
             std::fill(IT_A_BEGIN(_data, _ndof), IT_A_END(_data, _ndof), 0);
         }
         else {
-            // Calculating accelerations using the same procedure as in ParabolicCurve::SetSegment.
-            dReal tSqr = t*t;
-            dReal divMult = 1/(t*(0.5*tSqr + 2));
-            for (size_t idof = 0; idof < _ndof; ++idof) {
-                _data[DATA_OFFSET_A*_ndof + idof] = -(v0Vect[idof]*tSqr + t*(x0Vect[idof] - x1Vect[idof]) + 2*(v0Vect[idof] - v1Vect[idof]))*divMult;
-            }
+            DispatchFixedDOF(_ndof, [&](auto fixeddof) {
+                _ComputeAccelerationKernel<decltype(fixeddof)::value>(_data.data(), _ndof, t);
+            });
         }
     }
     else {
@@ -681,9 +723,9 @@ void RampND::EvalPos(dReal t, std::vector<dReal>::iterator it) const
         return;
     }
 
-    for (size_t idof = 0; idof < _ndof; ++idof) {
-        *(it + idof) = GetX0At(idof) + t*(GetV0At(idof) + 0.5*t*GetAAt(idof));
-    }
+    DispatchFixedDOF(_ndof, [&](auto fixeddof) {
+        _EvalPosKernel<decltype(fixeddof)::value>(_data.data(), _ndof, t, &(*it));
+    });
     return;
 }
 
@@ -698,9 +740,9 @@ void RampND::EvalVel(dReal t, std::vector<dReal>::iterator it) const
         return;
     }
 
-    for (size_t idof = 0; idof < _ndof; ++idof) {
-        *(it + idof) = GetV0At(idof) + t*GetAAt(idof);
-    }
+    DispatchFixedDOF(_ndof, [&](auto fixeddof) {
+        _EvalVelKernel<decltype(fixeddof)::value>(_data.data(), _ndof, t, &(*it));
+    });
     return;
 }
 
@@ -722,9 +764,9 @@ void RampND::EvalPos(dReal t, std::vector<dReal>& xVect) const
     }
 
     xVect.resize(_ndof);
-    for (size_t idof = 0; idof < _ndof; ++idof) {
-        xVect[idof] = GetX0At(idof) + t*(GetV0At(idof) + 0.5*t*GetAAt(idof));
-    }
+    DispatchFixedDOF(_ndof, [&](auto fixeddof) {
+        _EvalPosKernel<decltype(fixeddof)::value>(_data.data(), _ndof, t, xVect.data());
+    });
     return;
 }
 
@@ -740,9 +782,9 @@ void RampND::EvalVel(dReal t, std::vector<dReal>& vVect) const
     }
 
     vVect.resize(_ndof);
-    for (size_t idof = 0; idof < _ndof; ++idof) {
-        vVect[idof] = GetV0At(idof) + t*GetAAt(idof);
-    }
+    DispatchFixedDOF(_ndof, [&](auto fixeddof) {
+        _EvalVelKernel<decltype(fixeddof)::value>(_data.data(), _ndof, t, vVect.data());
+    });
     return;
 }
 
@@ -791,12 +833,9 @@ void RampND::Initialize(const std::vector<dReal>& x0Vect, const std::vector<dRea
             std::fill(IT_A_BEGIN(_data, _ndof), IT_A_END(_data, _ndof), 0);
         }
         else {
-            // Calculating accelerations using the same procedure as in ParabolicCurve::SetSegment.
-            dReal tSqr = t*t;
-            dReal divMult = 1/(t*(0.5*tSqr + 2));
-            for (size_t idof = 0; idof < _ndof; ++idof) {
-                _data[DATA_OFFSET_A*_ndof + idof] = -(v0Vect[idof]*tSqr + t*(x0Vect[idof] - x1Vect[idof]) + 2*(v0Vect[idof] - v1Vect[idof]))*divMult;
-            }
+            DispatchFixedDOF(_ndof, [&](auto fixeddof) {
+                _ComputeAccelerationKernel<decltype(fixeddof)::value>(_data.data(), _ndof, t);
+            });
         }
     }
     else {
@@ -37,6 +37,7 @@ OpenRAVE::PlannerBasePtr CreateCubicTrajectoryRetimer2(OpenRAVE::EnvironmentBase
 OpenRAVE::PlannerBasePtr CreateCubicSmoother(OpenRAVE::EnvironmentBasePtr penv, std::istream& sinput);
 OpenRAVE::PlannerBasePtr CreateQuinticSmoother(OpenRAVE::EnvironmentBasePtr penv, std::istream& sinput);
 OpenRAVE::PlannerBasePtr CreateQuinticTrajectoryRetimer(OpenRAVE::EnvironmentBasePtr penv, std::istream& sinput);
+OpenRAVE::PlannerBasePtr CreateToppraTrajectoryRetimer(OpenRAVE::EnvironmentBasePtr penv, std::istream& sinput);
 }
 
 const std::string RPlannersPlugin::_pluginname = "RPlannersPlugin";
@@ -54,6 +55,7 @@ RPlannersPlugin::RPlannersPlugin()
     _interfaces[PT_Planner].push_back("ParabolicTrajectoryRetimer2");
     _interfaces[PT_Planner].push_back("CubicTrajectoryRetimer");
     _interfaces[PT_Planner].push_back("CubicTrajectoryRetimer2");
+    _interfaces[PT_Planner].push_back("ToppraTrajectoryRetimer");
     _interfaces[PT_Planner].push_back("WorkspaceTrajectoryTracker");
     _interfaces[PT_Planner].push_back("LinearSmoother");
     _interfaces[PT_Planner].push_back("ParabolicSmoother");
@@ -95,6 +97,9 @@ OpenRAVE::InterfaceBasePtr RPlannersPlugin::CreateInterface(OpenRAVE::InterfaceT
         else if( interfacename == "lineartrajectoryretimer" ) {
             return rplanners::CreateLinearTrajectoryRetimer(penv,sinput);
         }
+        else if( interfacename == "toppratrajectoryretimer" ) {
+            return rplanners::CreateToppraTrajectoryRetimer(penv,sinput);
+        }
         else if( interfacename == "parabolictrajectoryretimer" ) {
             return rplanners::CreateParabolicTrajectoryRetimer(penv,sinput);
         }
@@ -83,6 +83,7 @@ public:
         _level = 0;
         _hasselfchild = 0;
         _usenn = 1;
+        _edgevalidated = 1;
         _userdata = 0;
     }
     SimpleNode(SimpleNode* parent, const dReal* pconfig, int dof) : rrtparent(parent) {
@@ -90,6 +91,7 @@ public:
         _level = 0;
         _hasselfchild = 0;
         _usenn = 1;
+        _edgevalidated = 1;
         _userdata = 0;
     }
     ~SimpleNode() {
@@ -100,6 +102,7 @@ public:
     int16_t _level; ///< the level the node belongs to
     uint8_t _hasselfchild; ///< if 1, then _vchildren has contains a clone of this node in the level below it.
     uint8_t _usenn; ///< if 1, then use part of the nearest neighbor search, otherwise ignore
+    uint8_t _edgevalidated; ///< if 1, then the edge from rrtparent to this node satisfies all constraints. Only 0 for nodes added with lazy edge validation.
     uint32_t _userdata; ///< user specified data tagging this node
 
 #ifdef _DEBUG
@@ -137,6 +140,15 @@ public:
 
     /// invalidates any nodes that point to parentbase. nodes can still be references from outside, but just won't be used as part of the nearest neighbor search
     virtual void InvalidateNodesWithParent(NodeBasePtr parentbase) = 0;
+
+    /// \brief if true, Extend only checks the new configurations and leaves the edges to them unchecked until ValidateEdge is called
+    virtual void SetLazyEdgeValidation(bool bLazy) = 0;
+
+    /// \brief checks the edge from the rrt parent of node to node with all the constraints if it has not been checked yet
+    ///
+    /// If the checked path deviates from the straight line, the checked configurations are inserted between the parent and node.
+    /// \return true if the edge satisfies all the constraints
+    virtual bool ValidateEdge(NodeBasePtr node, int constraintFilterOptions=0xffff|CFO_FillCheckedConfiguration) = 0;
 };
 
 /// Cache stores configuration information in a data structure based on the Cover Tree (Beygelzimer et al. 2006 http://hunch.net/~jl/projects/cover_tree/icml_final/final-icml.pdf)
@@ -159,6 +171,7 @@ public:
         _maxlevel = 0;
         _minlevel = 0;
         _fMaxLevelBound = 0;
+        _bLazyEdgeValidation = false;
     }
 
     ~SpatialTree() {
@@ -194,6 +207,7 @@ public:
             _vsetLevelNodes.resize(enclevel+1);
         }
         _constraintreturn.reset(new ConstraintFilterReturn());
+        _bLazyEdgeValidation = false;
     }
 
     virtual void Reset()
@@ -360,6 +374,25 @@ public:
                 return ET_Failed;
             }
 
+            if( _bLazyEdgeValidation ) {
+                // only check the new configuration, the edge is checked by ValidateEdge once it is part of a candidate path
+                if( params->CheckPathAllConstraints(_vNewConfig, _vNewConfig, std::vector<dReal>(), std::vector<dReal>(), 0, IT_OpenStart, constraintFilterOptions|CFO_FromPathSampling, _constraintreturn) != 0 ) {
+                    return bHasAdded ? ET_Sucess : ET_Failed;
+                }
+                NodePtr pnewnode = _InsertNode(pnode, _vNewConfig, 0); ///< set userdata to 0
+                if( !!pnewnode ) {
+                    pnewnode->_edgevalidated = 0;
+                    pnode = pnewnode;
+                    lastnode = pnode;
+                    bHasAdded = true;
+                }
+                if( bHasAdded && bOneStep ) {
+                    return ET_Connected;
+                }
+                _vCurConfig.swap(_vNewConfig);
+                continue;
+            }
+
             // necessary to pass in _constraintreturn since _neighstatefn can have constraints and it can change the interpolation. Use _constraintreturn->_bHasRampDeviatedFromInterpolation to figure out if something changed.
             if( _fromgoal ) {
                 if( params->CheckPathAllConstraints(_vNewConfig, _vCurConfig, std::vector<dReal>(), std::vector<dReal>(), 0, IT_OpenEnd, constraintFilterOptions|CFO_FromPathSampling, _constraintreturn) != 0 ) {
@@ -448,6 +481,58 @@ public:
         return bHasAdded ? ET_Sucess : ET_Failed;
     }
 
+    virtual void SetLazyEdgeValidation(bool bLazy)
+    {
+        _bLazyEdgeValidation = bLazy;
+    }
+
+    virtual bool ValidateEdge(NodeBasePtr nodebase, int constraintFilterOptions=0xffff|CFO_FillCheckedConfiguration)
+    {
+        NodePtr node = (NodePtr)nodebase;
+        if( node->_edgevalidated || !node->rrtparent ) {
+            return true;
+        }
+        NodePtr parent = node->rrtparent;
+        boost::shared_ptr<PlannerBase> planner(_planner);
+        PlannerBase::PlannerParametersConstPtr params = planner->GetParameters();
+        _vCurConfig.resize(_dof);
+        std::copy(parent->q, parent->q+_dof, _vCurConfig.begin());
+        std::copy(node->q, node->q+_dof, _vNewConfig.begin());
+        // same checks as Extend, the parent is always valid
+        int ret;
+        if( _fromgoal ) {
+            ret = params->CheckPathAllConstraints(_vNewConfig, _vCurConfig, std::vector<dReal>(), std::vector<dReal>(), 0, IT_OpenEnd, constraintFilterOptions|CFO_FromPathSampling, _constraintreturn);
+        }
+        else {
+            ret = params->CheckPathAllConstraints(_vCurConfig, _vNewConfig, std::vector<dReal>(), std::vector<dReal>(), 0, IT_OpenStart, constraintFilterOptions|CFO_FromPathSampling, _constraintreturn);
+        }
+        if( ret != 0 ) {
+            return false;
+        }
+
+        if( _constraintreturn->_bHasRampDeviatedFromInterpolation ) {
+            // the checked path is not a straight line, so insert the checked configurations from the parent side like Extend does
+            const int numconfigs = (int)_constraintreturn->_configurations.size()/_dof;
+            NodePtr pprevnode = parent;
+            for(int iconfig = 0; iconfig < numconfigs; ++iconfig) {
+                int index = (_fromgoal ? numconfigs - 1 - iconfig : iconfig)*_dof;
+                std::copy(_constraintreturn->_configurations.begin() + index, _constraintreturn->_configurations.begin() + index + _dof, _vNewConfig.begin());
+                if( _ComputeDistance(node->q, _vNewConfig) <= _mindistance ) {
+                    break;
+                }
+                NodePtr pnewnode = _InsertNode(pprevnode, _vNewConfig, 0);
+                if( !pnewnode ) {
+                    // too close to another node, so cannot represent the checked path
+                    return false;
+                }
+                pprevnode = pnewnode;
+            }
+            node->rrtparent = pprevnode;
+        }
+        node->_edgevalidated = 1;
+        return true;
+    }
+
     virtual int GetNumNodes() const {
         return _numnodes;
     }
@@ -1067,6 +1152,7 @@ private:
     int _minlevel; ///< the minimum allowed levels in the tree (inclusive)
     int _numnodes; ///< the number of nodes in the current tree starting at the root at _vsetLevelNodes.at(_EncodeLevel(_maxlevel))
     dReal _fMaxLevelBound; // pow(_base, _maxlevel)
+    bool _bLazyEdgeValidation; ///< if true, Extend does not check the edges to the new nodes
 
     // cache
     vector<NodePtr> _vchildcache;
@@ -318,6 +318,8 @@ Some python code to display data::\n\
 
         // TODO perhaps distmetricfn should take into number of revolutions of circular joints
         _treeBackward.Init(shared_planner(), _parameters->GetDOF(), _parameters->_distmetricfn, _parameters->_fStepLength, _parameters->_distmetricfn(_parameters->_vConfigLowerLimit, _parameters->_vConfigUpperLimit));
+        _treeForward.SetLazyEdgeValidation(_parameters->_bLazyEdgeValidation);
+        _treeBackward.SetLazyEdgeValidation(_parameters->_bLazyEdgeValidation);
 
         //read in all goals
         if( (_parameters->vgoalconfig.size() % _parameters->GetDOF()) != 0 ) {
@@ -363,7 +365,7 @@ Some python code to display data::\n\
         if( _vgoalpaths.capacity() < _parameters->_minimumgoalpaths ) {
             _vgoalpaths.reserve(_parameters->_minimumgoalpaths);
         }
-        RAVELOG_DEBUG_FORMAT("env=%s, BiRRT Planner Initialized, initial=%d, goal=%d, step=%f", GetEnv()->GetNameId()%_vecInitialNodes.size()%_treeBackward.GetNumNodes()%_parameters->_fStepLength);
+        RAVELOG_DEBUG_FORMAT("env=%s, BiRRT Planner Initialized, initial=%d, goal=%d, step=%f, lazy=%d", GetEnv()->GetNameId()%_vecInitialNodes.size()%_treeBackward.GetNumNodes()%_parameters->_fStepLength%_parameters->_bLazyEdgeValidation);
         return PlannerStatus(PS_HasSolution);
     }
 
@@ -376,6 +378,7 @@ Some python code to display data::\n\
         }
 
         EnvironmentLock lock(GetEnv()->GetMutex());
+        OPENRAVE_PROFILE_SCOPE("planner.BiRRT.PlanPath");
         uint64_t basetimeus = utils::GetMonotonicTime();
 
         int constraintFilterOptions = 0xffff|CFO_FillCheckedConfiguration;
@@ -399,6 +402,7 @@ Some python code to display data::\n\
         while(_vgoalpaths.size() < _parameters->_minimumgoalpaths && iter < 3*_parameters->_nMaxIterations) {
             RAVELOG_VERBOSE_FORMAT("env=%s, iter=%d, forward=%d, backward=%d", GetEnv()->GetNameId()%(iter/3)%_treeForward.GetNumNodes()%_treeBackward.GetNumNodes());
             ++iter;
+            OPENRAVE_PROFILE_SCOPE("planner.BiRRT.Iteration");
 
             // have to check callbacks at the beginning since code can continue
             callbackaction = _CallCallbacks(progress);
@@ -494,6 +498,15 @@ Some python code to display data::\n\
                 planningstatus.AddCollisionReport(_treeBackward.GetConstraintReport()->_report);
             }
 
+            if( et == ET_Connected && _parameters->_bLazyEdgeValidation ) {
+                NodeBase* iConnectedForward = TreeA == &_treeForward ? iConnectedA : iConnectedB;
+                NodeBase* iConnectedBackward = TreeA == &_treeBackward ? iConnectedA : iConnectedB;
+                if( !_ValidateLazyPath(_treeForward, iConnectedForward, constraintFilterOptions, planningstatus) || !_ValidateLazyPath(_treeBackward, iConnectedBackward, constraintFilterOptions, planningstatus) ) {
+                    // the subtrees behind the failed edges are not used anymore, so keep growing the trees from the valid nodes
+                    et = ET_Failed;
+                }
+            }
+
             if( et == ET_Connected ) {
                 // connected, process goal
                 _vgoalpaths.push_back(GOALPATH());
@@ -562,6 +575,29 @@ Some python code to display data::\n\
         return status;
     }
 
+    /// \brief checks all the edges from the root of tree to node that were not checked when they were added with lazy edge validation
+    ///
+    /// Edges are checked starting from the root. The first failed edge invalidates the subtree behind it.
+    /// \return true if the path from the root to node satisfies all the constraints
+    bool _ValidateLazyPath(SpatialTree<SimpleNode>& tree, NodeBase* node, int constraintFilterOptions, PlannerStatus& planningstatus)
+    {
+        _vlazypathnodes.resize(0);
+        for(SimpleNode* pnode = (SimpleNode*)node; !!pnode && !pnode->_edgevalidated; pnode = pnode->rrtparent) {
+            _vlazypathnodes.push_back(pnode);
+        }
+        for(std::vector<SimpleNode*>::reverse_iterator itnode = _vlazypathnodes.rbegin(); itnode != _vlazypathnodes.rend(); ++itnode) {
+            if( !tree.ValidateEdge(*itnode, constraintFilterOptions) ) {
+                if( constraintFilterOptions&CFO_FillCollisionReport ) {
+                    planningstatus.AddCollisionReport(tree.GetConstraintReport()->_report);
+                }
+                RAVELOG_VERBOSE_FORMAT("env=%s, lazy edge %d/%d from the root failed, invalidating its subtree", GetEnv()->GetNameId()%(itnode - _vlazypathnodes.rbegin())%_vlazypathnodes.size());
+                tree.InvalidateNodesWithParent(*itnode);
+                return false;
+            }
+        }
+        return true;
+    }
+
     virtual void _ExtractPath(GOALPATH& goalpath, NodeBase* iConnectedForward, NodeBase* iConnectedBackward)
     {
 //        list< std::vector<dReal> > vecnodes;
@@ -688,6 +724,7 @@ protected:
     std::vector< NodeBase* > _vecGoalNodes;
     size_t _nValidGoals; ///< num valid goals
     std::vector<GOALPATH> _vgoalpaths;
+    std::vector<SimpleNode*> _vlazypathnodes; ///< cache for _ValidateLazyPath
 };
 
 class BasicRrtPlanner : public RrtPlanner<SimpleNode>
@@ -767,6 +804,7 @@ public:
         }
 
         EnvironmentLock lock(GetEnv()->GetMutex());
+        OPENRAVE_PROFILE_SCOPE("planner.BasicRRT.PlanPath");
         uint32_t basetime = utils::GetMilliTime();
 
         NodeBasePtr lastnode; // the last node visited by the RRT
@@ -788,6 +826,7 @@ public:
 
         while(iter < _parameters->_nMaxIterations) {
             iter++;
+            OPENRAVE_PROFILE_SCOPE("planner.BasicRRT.Iteration");
             if( !!bestGoalNode && iter >= _parameters->_nMinIterations ) {
                 break;
             }
@@ -992,6 +1031,7 @@ public:
             return OPENRAVE_PLANNER_STATUS(PS_Failed);
         }
         EnvironmentLock lock(GetEnv()->GetMutex());
+        OPENRAVE_PROFILE_SCOPE("planner.ExplorationRRT.PlanPath");
         vector<dReal> vSampleConfig;
 
         PlannerParameters::StateSaver savestate(_parameters);
@@ -1000,6 +1040,7 @@ public:
         int iter = 0;
         while(iter < _parameters->_nMaxIterations && _treeForward.GetNumNodes() < _parameters->_nExpectedDataSize ) {
             ++iter;
+            OPENRAVE_PROFILE_SCOPE("planner.ExplorationRRT.Iteration");
 
             if( RaveRandomFloat() < _parameters->_fExploreProb ) {
                 // explore
@@ -0,0 +1,745 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "openraveplugindefs.h"
+
+namespace rplanners {
+
+/** \brief Time-optimal retiming of a fixed geometric path by reachability analysis (TOPP-RA).
+
+    The path q(s) is discretized into a grid s_0, ..., s_N. The unknowns are x_i = sdot^2 at every grid point and u_i = sddot,
+    constant in [s_i, s_{i+1}], so that x_{i+1} = x_i + 2*(s_{i+1} - s_i)*u_i. Since qdot = q_s*sdot and qddot = q_s*u + q_ss*x,
+    all the constraints at a grid point are linear in (u, x):
+
+    - velocity:     (q_s*sdot)^2 <= vmax^2, i.e. x <= vmax^2/q_s^2
+    - acceleration: -amax <= q_s*u + q_ss*x <= amax
+    - torque:       -taumax <= a*u + b*x + c <= taumax, where a = M(q)*q_s, b = M(q)*q_ss + C(q,q_s)*q_s, c = G(q)
+
+    A backward pass computes the controllable sets [kmin_i, kmax_i] (the values of x_i from which the end of the path can be reached
+    at rest) by solving two small 2D linear programs per grid point. A forward pass then greedily takes the largest feasible u_i that
+    keeps x_{i+1} inside the next controllable set. Both passes are linear in the number of grid points.
+ */
+class ToppraTrajectoryRetimer : public PlannerBase
+{
+public:
+    class ToppraParameters : public ConstraintTrajectoryTimingParameters
+    {
+public:
+        ToppraParameters() : ConstraintTrajectoryTimingParameters(), gridpoints(100), usetorquelimits(1), _bToppraProcessing(false) {
+            _vXMLParameters.push_back("gridpoints");
+            _vXMLParameters.push_back("usetorquelimits");
+        }
+
+        int gridpoints; ///< number of intervals to discretize the path into. Every segment between two waypoints gets at least two intervals.
+        int usetorquelimits; ///< if 1, constrain the joint torques by the torque limits of the robot whenever the active dofs support it
+
+protected:
+        bool _bToppraProcessing;
+        virtual bool serialize(std::ostream& O, int options=0) const
+        {
+            if( !ConstraintTrajectoryTimingParameters::serialize(O, options&~1) ) {
+                return false;
+            }
+            O << "<gridpoints>" << gridpoints << "</gridpoints>" << std::endl;
+            O << "<usetorquelimits>" << usetorquelimits << "</usetorquelimits>" << std::endl;
+            if( !(options & 1) ) {
+                O << _sExtraParameters << std::endl;
+            }
+            return !!O;
+        }
+
+        ProcessElement startElement(const std::string& name, const AttributesList& atts)
+        {
+            if( _bToppraProcessing ) {
+                return PE_Ignore;
+            }
+            switch( ConstraintTrajectoryTimingParameters::startElement(name,atts) ) {
+            case PE_Pass: break;
+            case PE_Support: return PE_Support;
+            case PE_Ignore: return PE_Ignore;
+            }
+            _bToppraProcessing = name=="gridpoints" || name=="usetorquelimits";
+            return _bToppraProcessing ? PE_Support : PE_Pass;
+        }
+
+        virtual bool endElement(const std::string& name)
+        {
+            if( _bToppraProcessing ) {
+                if( name == "gridpoints" ) {
+                    _ss >> gridpoints;
+                }
+                else if( name == "usetorquelimits" ) {
+                    _ss >> usetorquelimits;
+                }
+                else {
+                    RAVELOG_WARN(str(boost::format("unknown tag %s\n")%name));
+                }
+                _bToppraProcessing = false;
+                return false;
+            }
+            // give a chance for the default parameters to get processed
+            return ConstraintTrajectoryTimingParameters::endElement(name);
+        }
+    };
+    typedef boost::shared_ptr<ToppraParameters> ToppraParametersPtr;
+
+    ToppraTrajectoryRetimer(EnvironmentBasePtr penv, std::istream& sinput) : PlannerBase(penv)
+    {
+        __description = "Time-optimal retiming of a fixed geometric path under joint velocity, acceleration, and torque limits using reachability analysis (TOPP-RA).\n\n\
+If the parameters have timestamps, the path is the one traced by the input trajectory, which needs velocities. Otherwise, the path goes linearly through all the waypoints and stops at every corner. \
+The output has cubic interpolation with a point at every grid point, so every waypoint is hit. Torque limits are used only when the configuration space is the active dofs of a robot without affine dofs; friction is not considered.\n\n\
+Extra parameters: <gridpoints> (number of path intervals, default 100) and <usetorquelimits> (default 1).";
+    }
+
+    virtual PlannerStatus InitPlan(RobotBasePtr pbase, PlannerParametersConstPtr params) override
+    {
+        EnvironmentLock lock(GetEnv()->GetMutex());
+        params->Validate();
+        _parameters.reset(new ToppraParameters());
+        _parameters->copy(params);
+        _probot = pbase;
+        return _InitPlan() ? PlannerStatus(PS_HasSolution) : PlannerStatus(PS_Failed);
+    }
+
+    virtual PlannerStatus InitPlan(RobotBasePtr pbase, std::istream& isParameters) override
+    {
+        EnvironmentLock lock(GetEnv()->GetMutex());
+        _parameters.reset(new ToppraParameters());
+        isParameters >> *_parameters;
+        _parameters->Validate();
+        _probot = pbase;
+        return _InitPlan() ? PlannerStatus(PS_HasSolution) : PlannerStatus(PS_Failed);
+    }
+
+    virtual PlannerParametersConstPtr GetParameters() const override
+    {
+        return _parameters;
+    }
+
+    virtual PlannerStatus PlanPath(TrajectoryBasePtr ptraj, int planningoptions) override
+    {
+        BOOST_ASSERT(!!_parameters && !!ptraj && ptraj->GetEnv()==GetEnv());
+        const int ndof = _parameters->GetDOF();
+        const ConfigurationSpecification& posspec = _parameters->_configurationspecification;
+        const size_t numpoints = ptraj->GetNumWaypoints();
+        if( numpoints == 0 ) {
+            std::string description = str(boost::format("env=%s, there's nothing to retime")%GetEnv()->GetNameId());
+            return OPENRAVE_PLANNER_STATUS(description, PS_Failed);
+        }
+
+        uint64_t starttime = utils::GetMicroTime();
+        bool bSuccess;
+        if( _parameters->_hastimestamps ) {
+            bSuccess = _InitPathFromTrajectory(ptraj);
+        }
+        else {
+            bSuccess = _InitPathFromWaypoints(ptraj);
+        }
+        if( !bSuccess ) {
+            std::string description = str(boost::format("env=%s, failed to extract the path to retime")%GetEnv()->GetNameId());
+            RAVELOG_WARN(description);
+            return OPENRAVE_PLANNER_STATUS(description, PS_Failed);
+        }
+
+        const int numgrid = (int)_vgrid.size();
+        _vx.resize(numgrid);
+        _vu.resize(numgrid);
+        if( numgrid == 1 ) {
+            // all the waypoints are the same
+            _vx[0] = 0;
+            _vu[0] = 0;
+        }
+        else {
+            if( _bUseTorqueLimits ) {
+                _ComputeTorqueCoefficients();
+            }
+            if( !_ComputeControllableSets() ) {
+                std::string description = str(boost::format("env=%s, path cannot be followed under the limits, it is not controllable")%GetEnv()->GetNameId());
+                RAVELOG_WARN(description);
+                return OPENRAVE_PLANNER_STATUS(description, PS_Failed);
+            }
+            if( !_ComputeForwardPass() ) {
+                std::string description = str(boost::format("env=%s, failed to compute the time-optimal parameterization along the path")%GetEnv()->GetNameId());
+                RAVELOG_WARN(description);
+                return OPENRAVE_PLANNER_STATUS(description, PS_Failed);
+            }
+        }
+
+        // sdot^2 is linear in s in every interval, so the time to traverse it is 2*ds/(sdot_i + sdot_{i+1})
+        _vdeltatimes.resize(numgrid);
+        _vdeltatimes[0] = 0;
+        dReal totaltime = 0;
+        for(int igrid = 0; igrid+1 < numgrid; ++igrid) {
+            dReal fsumsdot = RaveSqrt(_vx[igrid]) + RaveSqrt(_vx[igrid+1]);
+            if( fsumsdot <= g_fEpsilon ) {
+                std::string description = str(boost::format("env=%s, path speed is zero at grid points %d and %d, cannot compute the duration")%GetEnv()->GetNameId()%igrid%(igrid+1));
+                RAVELOG_WARN(description);
+                return OPENRAVE_PLANNER_STATUS(description, PS_Failed);
+            }
+            _vdeltatimes[igrid+1] = 2*(_vgrid[igrid+1] - _vgrid[igrid])/fsumsdot;
+            totaltime += _vdeltatimes[igrid+1];
+        }
+
+        // write the trajectory
+        ConfigurationSpecification newspec = posspec;
+        FOREACH(itgroup, newspec._vgroups) {
+            itgroup->interpolation = "cubic";
+        }
+        newspec.AddDerivativeGroups(1, false);
+        newspec.AddDerivativeGroups(2, false);
+        int timeoffset = newspec.AddDeltaTimeGroup();
+        _vgroupoffsets.resize(0);
+        FOREACHC(itgroup, posspec._vgroups) {
+            std::vector<ConfigurationSpecification::Group>::const_iterator itpos = newspec.FindCompatibleGroup(itgroup->name, true);
+            std::vector<ConfigurationSpecification::Group>::const_iterator itvel = newspec.FindTimeDerivativeGroup(*itpos, true);
+            std::vector<ConfigurationSpecification::Group>::const_iterator itaccel = newspec.FindTimeDerivativeGroup(*itvel, true);
+            OPENRAVE_ASSERT_OP(itvel->dof, ==, itgroup->dof);
+            OPENRAVE_ASSERT_OP(itaccel->dof, ==, itgroup->dof);
+            _vgroupoffsets.push_back(boost::array<int, 5>({{itgroup->offset, itpos->offset, itvel->offset, itaccel->offset, itgroup->dof}}));
+        }
+        const int newdof = newspec.GetDOF();
+        _vtrajdata.resize(numgrid*newdof);
+        std::fill(_vtrajdata.begin(), _vtrajdata.end(), 0);
+        for(int igrid = 0; igrid < numgrid; ++igrid) {
+            const dReal* ppos = &_vpathpos[igrid*ndof];
+            const dReal* pqs = &_vpathvel[igrid*ndof];
+            const dReal* pqss = &_vpathaccel[igrid*ndof];
+            const dReal sdot = RaveSqrt(_vx[igrid]);
+            const dReal u = _vu[igrid];
+            std::vector<dReal>::iterator itdata = _vtrajdata.begin() + igrid*newdof;
+            FOREACHC(itoffsets, _vgroupoffsets) {
+                const int orgoffset = (*itoffsets)[0];
+                for(int j = 0; j < (*itoffsets)[4]; ++j) {
+                    *(itdata + (*itoffsets)[1] + j) = ppos[orgoffset+j];
+                    *(itdata + (*itoffsets)[2] + j) = pqs[orgoffset+j]*sdot;
+                    *(itdata + (*itoffsets)[3] + j) = pqs[orgoffset+j]*u + pqss[orgoffset+j]*_vx[igrid];
+                }
+            }
+            *(itdata + timeoffset) = _vdeltatimes[igrid];
+        }
+        ptraj->Init(newspec);
+        ptraj->Insert(0, _vtrajdata);
+
+        RAVELOG_DEBUG_FORMAT("env=%s, toppra retimed %d waypoints with %d grid points (torque limits=%d), duration=%.6fs, computation time=%.3fs", GetEnv()->GetNameId()%numpoints%numgrid%_bUseTorqueLimits%totaltime%(0.000001f*(float)(utils::GetMicroTime()-starttime)));
+        return _ProcessPostPlanners(RobotBasePtr(), ptraj);
+    }
+
+protected:
+    /// \brief a*u + b*x <= c
+    struct LinearConstraint2D
+    {
+        LinearConstraint2D() : a(0), b(0), c(0) {
+        }
+        LinearConstraint2D(dReal a_, dReal b_, dReal c_) : a(a_), b(b_), c(c_) {
+        }
+        dReal a, b, c;
+    };
+
+    bool _InitPlan()
+    {
+        const int ndof = _parameters->GetDOF();
+        if( (int)_parameters->_vConfigVelocityLimit.size() != ndof || (int)_parameters->_vConfigAccelerationLimit.size() != ndof ) {
+            RAVELOG_WARN_FORMAT("env=%s, velocity and acceleration limits need to be set for all %d dofs", GetEnv()->GetNameId()%ndof);
+            return false;
+        }
+        if( _parameters->_interpolation.size() > 0 && _parameters->_interpolation != "cubic" ) {
+            RAVELOG_WARN_FORMAT("env=%s, toppra retimer only outputs cubic interpolation, %s is not supported", GetEnv()->GetNameId()%_parameters->_interpolation);
+            return false;
+        }
+        if( _parameters->gridpoints < 2 ) {
+            RAVELOG_WARN_FORMAT("env=%s, gridpoints=%d needs to be at least 2", GetEnv()->GetNameId()%_parameters->gridpoints);
+            return false;
+        }
+
+        // torque limits are only supported when the configuration space is the active dofs of the robot since the inverse dynamics
+        // need to map the path to robot dofs
+        _bUseTorqueLimits = false;
+        _vtorquedofindices.resize(0);
+        _vtorquelimits.resize(0);
+        if( _parameters->usetorquelimits && !!_probot ) {
+            const std::vector<int>& vactiveindices = _probot->GetActiveDOFIndices();
+            bool bIsActiveDOFSpace = _probot->GetAffineDOF() == 0 && _probot->GetActiveDOF() == ndof;
+            if( bIsActiveDOFSpace ) {
+                // every configuration index has to hold the active dof of the robot at the same index, otherwise the torque limits
+                // of the robot do not apply to the configuration space
+                std::vector<int> vuseddofindices, vusedconfigindices;
+                _parameters->_configurationspecification.ExtractUsedIndices(_probot, vuseddofindices, vusedconfigindices);
+                bIsActiveDOFSpace = (int)vuseddofindices.size() == ndof;
+                for(size_t iused = 0; iused < vuseddofindices.size() && bIsActiveDOFSpace; ++iused) {
+                    bIsActiveDOFSpace = vusedconfigindices[iused] >= 0 && vusedconfigindices[iused] < ndof && vactiveindices.at(vusedconfigindices[iused]) == vuseddofindices[iused];
+                }
+            }
+            if( bIsActiveDOFSpace ) {
+                std::vector<dReal> vdoftorquelimits;
+                _probot->GetDOFTorqueLimits(vdoftorquelimits);
+                for(int j = 0; j < ndof; ++j) {
+                    dReal ftorquelimit = vdoftorquelimits.at(vactiveindices[j]);
+                    if( ftorquelimit > 0 ) {
+                        _vtorquedofindices.push_back(j);
+                        _vtorquelimits.push_back(ftorquelimit);
+                    }
+                }
+                _bUseTorqueLimits = _vtorquedofindices.size() > 0;
+            }
+            else {
+                RAVELOG_DEBUG_FORMAT("env=%s, configuration space is not the active dofs of robot %s, so ignoring torque limits", GetEnv()->GetNameId()%_probot->GetName());
+            }
+        }
+        return true;
+    }
+
+    /// \brief the path is the one traced by the timed input trajectory, parameterized by its time
+    bool _InitPathFromTrajectory(TrajectoryBasePtr ptraj)
+    {
+        const int ndof = _parameters->GetDOF();
+        const ConfigurationSpecification& trajspec = ptraj->GetConfigurationSpecification();
+        if( trajspec.FindCompatibleGroup("deltatime", false) == trajspec._vgroups.end() ) {
+            RAVELOG_WARN_FORMAT("env=%s, trajectory does not have timestamps, even though parameters say timestamps are needed", GetEnv()->GetNameId());
+            return false;
+        }
+        ConfigurationSpecification velspec = _parameters->_configurationspecification.ConvertToVelocitySpecification();
+        ConfigurationSpecification accelspec = _parameters->_configurationspecification.ConvertToDerivativeSpecification(2);
+        bool bHasAccelerations = true;
+        FOREACHC(itgroup, velspec._vgroups) {
+            if( trajspec.FindCompatibleGroup(*itgroup, true) == trajspec._vgroups.end() ) {
+                RAVELOG_WARN_FORMAT("env=%s, trajectory does not have velocity group '%s', which is needed to get the path tangents", GetEnv()->GetNameId()%itgroup->name);
+                return false;
+            }
+        }
+        FOREACHC(itgroup, accelspec._vgroups) {
+            if( trajspec.FindCompatibleGroup(*itgroup, true) == trajspec._vgroups.end() ) {
+                bHasAccelerations = false;
+                break;
+            }
+        }
+
+        const dReal duration = ptraj->GetDuration();
+        if( ptraj->GetNumWaypoints() == 1 || duration <= g_fEpsilon ) {
+            _vgrid.resize(1);
+            _vgrid[0] = 0;
+            ptraj->Sample(_vpathpos, 0, _parameters->_configurationspecification);
+            _vpathvel.resize(ndof);
+            _vpathaccel.resize(ndof);
+            std::fill(_vpathvel.begin(), _vpathvel.end(), 0);
+            std::fill(_vpathaccel.begin(), _vpathaccel.end(), 0);
+            _vmaxx.resize(1);
+            _vmaxx[0] = 0;
+            return true;
+        }
+
+        const int numintervals = _parameters->gridpoints;
+        _vgrid.resize(numintervals+1);
+        for(int igrid = 0; igrid <= numintervals; ++igrid) {
+            _vgrid[igrid] = duration*igrid/numintervals;
+        }
+        _vgrid[numintervals] = duration;
+        ptraj->SamplePoints(_vpathpos, _vgrid, _parameters->_configurationspecification);
+        ptraj->SamplePoints(_vpathvel, _vgrid, velspec);
+        if( bHasAccelerations ) {
+            ptraj->SamplePoints(_vpathaccel, _vgrid, accelspec);
+        }
+        else {
+            // central differences of the velocities, one-sided at the ends
+            const dReal fstep = 0.5*duration/numintervals;
+            _vsampletimes.resize(2*(numintervals+1));
+            for(int igrid = 0; igrid <= numintervals; ++igrid) {
+                _vsampletimes[2*igrid] = max(dReal(0), _vgrid[igrid] - fstep);
+                _vsampletimes[2*igrid+1] = min(duration, _vgrid[igrid] + fstep);
+            }
+            ptraj->SamplePoints(_vsampledata, _vsampletimes, velspec);
+            _vpathaccel.resize((numintervals+1)*ndof);
+            for(int igrid = 0; igrid <= numintervals; ++igrid) {
+                dReal fidelta = 1/(_vsampletimes[2*igrid+1] - _vsampletimes[2*igrid]);
+                for(int j = 0; j < ndof; ++j) {
+                    _vpathaccel[igrid*ndof+j] = (_vsampledata[(2*igrid+1)*ndof+j] - _vsampledata[2*igrid*ndof+j])*fidelta;
+                }
+            }
+        }
+
+        _vmaxx.resize(numintervals+1);
+        for(int igrid = 0; igrid <= numintervals; ++igrid) {
+            _vmaxx[igrid] = _ComputeMaxSquaredPathSpeed(&_vpathvel[igrid*ndof]);
+        }
+        // start and end at rest
+        _vmaxx[0] = 0;
+        _vmaxx[numintervals] = 0;
+        return true;
+    }
+
+    /// \brief the path goes linearly through the waypoints, parameterized by its arc length. It has to stop at every corner.
+    bool _InitPathFromWaypoints(TrajectoryBasePtr ptraj)
+    {
+        const int ndof = _parameters->GetDOF();
+        const size_t numpoints = ptraj->GetNumWaypoints();
+        ptraj->GetWaypoints(0, numpoints, _vwaypoints, _parameters->_configurationspecification);
+
+        // compute the directions and lengths of all the non-degenerate segments
+        _vsegmentstarts.resize(0);
+        _vsegmentdiffs.resize(0);
+        _vsegmentlengths.resize(0);
+        dReal ftotallength = 0;
+        std::vector<dReal> vdiff(ndof), vprev(ndof);
+        for(size_t ipoint = 0; ipoint+1 < numpoints; ++ipoint) {
+            std::copy(_vwaypoints.begin() + (ipoint+1)*ndof, _vwaypoints.begin() + (ipoint+2)*ndof, vdiff.begin());
+            std::copy(_vwaypoints.begin() + ipoint*ndof, _vwaypoints.begin() + (ipoint+1)*ndof, vprev.begin());
+            _parameters->_diffstatefn(vdiff, vprev);
+            dReal flength = 0;
+            for(int j = 0; j < ndof; ++j) {
+                flength += vdiff[j]*vdiff[j];
+            }
+            flength = RaveSqrt(flength);
+            if( flength <= g_fEpsilonLinear ) {
+                continue;
+            }
+            _vsegmentstarts.push_back(ipoint);
+            _vsegmentdiffs.insert(_vsegmentdiffs.end(), vdiff.begin(), vdiff.end());
+            _vsegmentlengths.push_back(flength);
+            ftotallength += flength;
+        }
+
+        const int numsegments = (int)_vsegmentlengths.size();
+        if( numsegments == 0 ) {
+            _vgrid.resize(1);
+            _vgrid[0] = 0;
+            _vpathpos.assign(_vwaypoints.begin(), _vwaypoints.begin()+ndof);
+            _vpathvel.resize(ndof);
+            _vpathaccel.resize(ndof);
+            std::fill(_vpathvel.begin(), _vpathvel.end(), 0);
+            std::fill(_vpathaccel.begin(), _vpathaccel.end(), 0);
+            _vmaxx.resize(1);
+            _vmaxx[0] = 0;
+            return true;
+        }
+
+        _vgrid.resize(0);
+        _vpathpos.resize(0);
+        _vpathvel.resize(0);
+        _vmaxx.resize(0);
+        dReal fcurs = 0;
+        for(int iseg = 0; iseg < numsegments; ++iseg) {
+            const dReal* pstart = &_vwaypoints[_vsegmentstarts[iseg]*ndof];
+            const dReal* pdiff = &_vsegmentdiffs[iseg*ndof];
+            const dReal flength = _vsegmentlengths[iseg];
+            // the path stops at the segment ends, so need at least two intervals to have a non-zero speed in between
+            int numintervals = max(2, (int)(_parameters->gridpoints*flength/ftotallength + 0.5));
+            bool bStopAtStart = true;
+            if( iseg > 0 ) {
+                // do not stop if the previous segment has the same direction
+                const dReal* pprevdiff = &_vsegmentdiffs[(iseg-1)*ndof];
+                const dReal fprevlength = _vsegmentlengths[iseg-1];
+                dReal fdirdiff = 0;
+                for(int j = 0; j < ndof; ++j) {
+                    fdirdiff = max(fdirdiff, RaveFabs(pdiff[j]/flength - pprevdiff[j]/fprevlength));
+                }
+                bStopAtStart = fdirdiff > g_fEpsilonLinear;
+            }
+            for(int iinterval = 0; iinterval < numintervals; ++iinterval) {
+                dReal f = dReal(iinterval)/numintervals;
+                _vgrid.push_back(fcurs + f*flength);
+                for(int j = 0; j < ndof; ++j) {
+                    _vpathpos.push_back(pstart[j] + f*pdiff[j]);
+                    _vpathvel.push_back(pdiff[j]/flength);
+                }
+                if( iinterval == 0 && bStopAtStart ) {
+                    _vmaxx.push_back(0);
+                }
+                else {
+                    _vmaxx.push_back(_ComputeMaxSquaredPathSpeed(&_vpathvel[_vpathvel.size()-ndof]));
+                }
+            }
+            fcurs += flength;
+        }
+        // the last waypoint, where the path stops
+        const int ilastsegment = numsegments-1;
+        _vgrid.push_back(fcurs);
+        for(int j = 0; j < ndof; ++j) {
+            _vpathpos.push_back(_vwaypoints[_vsegmentstarts[ilastsegment]*ndof+j] + _vsegmentdiffs[ilastsegment*ndof+j]);
+            _vpathvel.push_back(_vsegmentdiffs[ilastsegment*ndof+j]/_vsegmentlengths[ilastsegment]);
+        }
+        _vmaxx.push_back(0);
+        // straight lines have no curvature
+        _vpathaccel.resize(_vpathvel.size());
+        std::fill(_vpathaccel.begin(), _vpathaccel.end(), 0);
+        return true;
+    }
+
+    /// \brief the largest sdot^2 that respects the velocity limits given the path tangent q_s
+    dReal _ComputeMaxSquaredPathSpeed(const dReal* pqs) const
+    {
+        dReal fmaxx = s_fMaxVariable;
+        for(size_t j = 0; j < _parameters->_vConfigVelocityLimit.size(); ++j) {
+            dReal fvel = _parameters->_vConfigVelocityLimit[j];
+            dReal fqs2 = pqs[j]*pqs[j];
+            if( fqs2*s_fMaxVariable > fvel*fvel ) {
+                fmaxx = min(fmaxx, fvel*fvel/fqs2);
+            }
+        }
+        return fmaxx;
+    }
+
+    /// \brief computes a, b, c of the torque constraints a*u + b*x + c at every grid point
+    void _ComputeTorqueCoefficients()
+    {
+        const int ndof = _parameters->GetDOF();
+        const int numgrid = (int)_vgrid.size();
+        const int numtorques = (int)_vtorquedofindices.size();
+        const std::vector<int>& vactiveindices = _probot->GetActiveDOFIndices();
+        KinBody::KinBodyStateSaver saver(_probot, KinBody::Save_LinkTransformation|KinBody::Save_LinkVelocities);
+        _probot->GetDOFValues(_vfulldofvalues);
+        _vfulldofvelocities.resize(_vfulldofvalues.size());
+        _vfulldofaccelerations.resize(_vfulldofvalues.size());
+        std::fill(_vfulldofvelocities.begin(), _vfulldofvelocities.end(), 0);
+        _vtorquea.resize(numgrid*numtorques);
+        _vtorqueb.resize(numgrid*numtorques);
+        _vtorquec.resize(numgrid*numtorques);
+        for(int igrid = 0; igrid < numgrid; ++igrid) {
+            std::fill(_vfulldofaccelerations.begin(), _vfulldofaccelerations.end(), 0);
+            for(int j = 0; j < ndof; ++j) {
+                _vfulldofvalues[vactiveindices[j]] = _vpathpos[igrid*ndof+j];
+                _vfulldofvelocities[vactiveindices[j]] = _vpathvel[igrid*ndof+j];
+                _vfulldofaccelerations[vactiveindices[j]] = _vpathaccel[igrid*ndof+j];
+            }
+            _probot->SetDOFValues(_vfulldofvalues, KinBody::CLA_Nothing);
+            _probot->SetDOFVelocities(_vfulldofvelocities, KinBody::CLA_Nothing);
+            // with qdot = q_s and qddot = q_ss: [M*q_ss, C(q,q_s)*q_s, G]
+            _probot->ComputeInverseDynamics(_vtorquecomponents, _vfulldofaccelerations);
+            for(int itorque = 0; itorque < numtorques; ++itorque) {
+                int idof = vactiveindices[_vtorquedofindices[itorque]];
+                _vtorqueb[igrid*numtorques+itorque] = _vtorquecomponents[0][idof] + _vtorquecomponents[1][idof];
+                _vtorquec[igrid*numtorques+itorque] = _vtorquecomponents[2][idof];
+            }
+            // with qddot = q_s: [M*q_s, ...]
+            for(int j = 0; j < ndof; ++j) {
+                _vfulldofaccelerations[vactiveindices[j]] = _vpathvel[igrid*ndof+j];
+            }
+            _probot->ComputeInverseDynamics(_vtorquecomponents, _vfulldofaccelerations);
+            for(int itorque = 0; itorque < numtorques; ++itorque) {
+                int idof = vactiveindices[_vtorquedofindices[itorque]];
+                _vtorquea[igrid*numtorques+itorque] = _vtorquecomponents[0][idof];
+            }
+        }
+    }
+
+    /// \brief fills _vconstraints with the acceleration and torque constraints at the grid point
+    void _BuildConstraints(int igrid)
+    {
+        const int ndof = _parameters->GetDOF();
+        _vconstraints.resize(0);
+        const dReal* pqs = &_vpathvel[igrid*ndof];
+        const dReal* pqss = &_vpathaccel[igrid*ndof];
+        for(int j = 0; j < ndof; ++j) {
+            dReal faccel = _parameters->_vConfigAccelerationLimit[j];
+            if( faccel > 0 ) {
+                _vconstraints.push_back(LinearConstraint2D(pqs[j], pqss[j], faccel));
+                _vconstraints.push_back(LinearConstraint2D(-pqs[j], -pqss[j], faccel));
+            }
+        }
+        if( _bUseTorqueLimits ) {
+            const int numtorques = (int)_vtorquedofindices.size();
+            for(int itorque = 0; itorque < numtorques; ++itorque) {
+                const int index = igrid*numtorques+itorque;
+                _vconstraints.push_back(LinearConstraint2D(_vtorquea[index], _vtorqueb[index], _vtorquelimits[itorque] - _vtorquec[index]));
+                _vconstraints.push_back(LinearConstraint2D(-_vtorquea[index], -_vtorqueb[index], _vtorquelimits[itorque] + _vtorquec[index]));
+            }
+        }
+        _vconstraints.push_back(LinearConstraint2D(0, 1, _vmaxx[igrid]));
+        _vconstraints.push_back(LinearConstraint2D(0, -1, 0));
+    }
+
+    /// \brief backward pass computing the controllable sets [_vkmin, _vkmax]
+    bool _ComputeControllableSets()
+    {
+        const int numgrid = (int)_vgrid.size();
+        _vkmin.resize(numgrid);
+        _vkmax.resize(numgrid);
+        _vkmin[numgrid-1] = 0;
+        _vkmax[numgrid-1] = 0;
+        for(int igrid = numgrid-2; igrid >= 0; --igrid) {
+            const dReal fdelta2 = 2*(_vgrid[igrid+1] - _vgrid[igrid]);
+            _BuildConstraints(igrid);
+            // x + 2*delta*u has to be in the next controllable set
+            _vconstraints.push_back(LinearConstraint2D(fdelta2, 1, _vkmax[igrid+1]));
+            _vconstraints.push_back(LinearConstraint2D(-fdelta2, -1, -_vkmin[igrid+1]));
+            dReal u, x;
+            if( !_SolveLP2D(0, 1, u, x) ) {
+                RAVELOG_DEBUG_FORMAT("env=%s, grid point %d/%d at s=%.15e is not controllable", GetEnv()->GetNameId()%igrid%numgrid%_vgrid[igrid]);
+                return false;
+            }
+            _vkmax[igrid] = max(dReal(0), x);
+            if( !_SolveLP2D(0, -1, u, x) ) {
+                return false;
+            }
+            _vkmin[igrid] = max(dReal(0), x);
+        }
+        if( _vkmin[0] > s_fLPEpsilon ) {
+            RAVELOG_DEBUG_FORMAT("env=%s, cannot start the path at rest, min speed^2=%.15e", GetEnv()->GetNameId()%_vkmin[0]);
+            return false;
+        }
+        return true;
+    }
+
+    /// \brief forward pass greedily taking the largest path acceleration that keeps the path controllable
+    bool _ComputeForwardPass()
+    {
+        const int numgrid = (int)_vgrid.size();
+        _vx[0] = 0;
+        for(int igrid = 0; igrid+1 < numgrid; ++igrid) {
+            const dReal fdelta2 = 2*(_vgrid[igrid+1] - _vgrid[igrid]);
+            const dReal x = _vx[igrid];
+            _BuildConstraints(igrid);
+            _vconstraints.push_back(LinearConstraint2D(fdelta2, 1, _vkmax[igrid+1]));
+            _vconstraints.push_back(LinearConstraint2D(-fdelta2, -1, -_vkmin[igrid+1]));
+            dReal ulower = -s_fMaxVariable, uupper = s_fMaxVariable;
+            FOREACHC(itconstraint, _vconstraints) {
+                dReal frhs = itconstraint->c - itconstraint->b*x;
+                if( itconstraint->a > s_fLPEpsilon ) {
+                    uupper = min(uupper, frhs/itconstraint->a);
+                }
+                else if( itconstraint->a < -s_fLPEpsilon ) {
+                    ulower = max(ulower, frhs/itconstraint->a);
+                }
+            }
+            dReal u = uupper;
+            if( ulower > uupper ) {
+                // x is in the controllable set, so this can only come from numerical errors
+                if( ulower > uupper + s_fLPEpsilon*(1 + RaveFabs(uupper)) ) {
+                    RAVELOG_DEBUG_FORMAT("env=%s, no feasible path acceleration at grid point %d/%d, [%.15e, %.15e]", GetEnv()->GetNameId()%igrid%numgrid%ulower%uupper);
+                }
+                u = 0.5*(ulower + uupper);
+            }
+            dReal xnext = x + fdelta2*u;
+            // keep the next state inside the controllable set to prevent numerical errors from accumulating
+            if( xnext > _vkmax[igrid+1] ) {
+                xnext = _vkmax[igrid+1];
+            }
+            else if( xnext < _vkmin[igrid+1] ) {
+                xnext = _vkmin[igrid+1];
+            }
+            _vu[igrid] = (xnext - x)/fdelta2;
+            _vx[igrid+1] = xnext;
+        }
+        _vu[numgrid-1] = _vu[numgrid-2];
+        return true;
+    }
+
+    /** \brief maximizes fobju*u + fobjx*x subject to _vconstraints and |u|, |x| <= s_fMaxVariable
+
+        Incremental 2D linear programming (Seidel). The optimum is kept as constraints are added. Whenever the optimum violates a new
+        constraint, the new optimum lies on that constraint's line and is found by a 1D linear program over the previous constraints.
+        Ties are broken by the perpendicular objective so the optimum is always a unique vertex.
+        \return false if infeasible
+     */
+    bool _SolveLP2D(dReal fobju, dReal fobjx, dReal& u, dReal& x)
+    {
+        // secondary objective to break ties
+        const dReal fobj2u = -fobjx, fobj2x = fobju;
+        const int numconstraints = (int)_vconstraints.size();
+        // bounding box is added as the first constraints so that every 1D problem is bounded
+        _vlpconstraints.resize(4 + numconstraints);
+        _vlpconstraints[0] = LinearConstraint2D(1, 0, s_fMaxVariable);
+        _vlpconstraints[1] = LinearConstraint2D(-1, 0, s_fMaxVariable);
+        _vlpconstraints[2] = LinearConstraint2D(0, 1, s_fMaxVariable);
+        _vlpconstraints[3] = LinearConstraint2D(0, -1, s_fMaxVariable);
+        std::copy(_vconstraints.begin(), _vconstraints.end(), _vlpconstraints.begin() + 4);
+
+        u = (fobju > 0 || (fobju == 0 && fobj2u > 0)) ? s_fMaxVariable : -s_fMaxVariable;
+        x = (fobjx > 0 || (fobjx == 0 && fobj2x > 0)) ? s_fMaxVariable : -s_fMaxVariable;
+        for(int iconstraint = 4; iconstraint < 4 + numconstraints; ++iconstraint) {
+            const LinearConstraint2D& constraint = _vlpconstraints[iconstraint];
+            if( constraint.a*u + constraint.b*x <= constraint.c + s_fLPEpsilon*(1 + RaveFabs(constraint.c)) ) {
+                continue;
+            }
+            dReal fnormsqr = constraint.a*constraint.a + constraint.b*constraint.b;
+            if( fnormsqr <= s_fLPEpsilon*s_fLPEpsilon ) {
+                // 0 <= c is violated
+                return false;
+            }
+            // line is p0 + t*d
+            const dReal p0u = constraint.a*constraint.c/fnormsqr, p0x = constraint.b*constraint.c/fnormsqr;
+            const dReal du = -constraint.b, dx = constraint.a;
+            dReal tlower = -std::numeric_limits<dReal>::infinity(), tupper = std::numeric_limits<dReal>::infinity();
+            for(int iprev = 0; iprev < iconstraint; ++iprev) {
+                const LinearConstraint2D& prev = _vlpconstraints[iprev];
+                dReal alpha = prev.a*du + prev.b*dx;
+                dReal beta = prev.c - prev.a*p0u - prev.b*p0x;
+                if( RaveFabs(alpha) <= s_fLPEpsilon*fnormsqr ) {
+                    // parallel
+                    if( beta < -s_fLPEpsilon*(1 + RaveFabs(prev.c)) ) {
+                        return false;
+                    }
+                }
+                else if( alpha > 0 ) {
+                    tupper = min(tupper, beta/alpha);
+                }
+                else {
+                    tlower = max(tlower, beta/alpha);
+                }
+            }
+            if( tlower > tupper + s_fLPEpsilon*(1 + RaveFabs(tupper)) ) {
+                return false;
+            }
+            dReal t;
+            if( tlower > tupper ) {
+                t = 0.5*(tlower + tupper);
+            }
+            else {
+                dReal fobjdir = fobju*du + fobjx*dx;
+                if( RaveFabs(fobjdir) <= s_fLPEpsilon*RaveSqrt(fnormsqr) ) {
+                    fobjdir = fobj2u*du + fobj2x*dx;
+                }
+                t = fobjdir > 0 ? tupper : tlower;
+            }
+            u = p0u + t*du;
+            x = p0x + t*dx;
+        }
+        return true;
+    }
+
+    static const dReal s_fMaxVariable; ///< bound on |u| and |x| keeping the linear programs bounded
+    static const dReal s_fLPEpsilon;
+
+    ToppraParametersPtr _parameters;
+    RobotBasePtr _probot;
+    bool _bUseTorqueLimits;
+    std::vector<int> _vtorquedofindices; ///< indices into the configuration of the dofs with torque limits
+    std::vector<dReal> _vtorquelimits; ///< torque limits of _vtorquedofindices
+
+    std::vector<dReal> _vgrid; ///< path parameter s at every grid point
+    std::vector<dReal> _vpathpos, _vpathvel, _vpathaccel; ///< q, q_s, q_ss at every grid point
+    std::vector<dReal> _vmaxx; ///< upper bound of sdot^2 at every grid point from the velocity limits
+    std::vector<dReal> _vtorquea, _vtorqueb, _vtorquec; ///< torque = a*u + b*x + c at every grid point for every dof in _vtorquedofindices
+    std::vector<dReal> _vkmin, _vkmax; ///< controllable sets of sdot^2
+    std::vector<dReal> _vx, _vu; ///< sdot^2 and sddot at every grid point
+
+    // caches
+    std::vector<LinearConstraint2D> _vconstraints, _vlpconstraints;
+    std::vector<dReal> _vwaypoints, _vsegmentdiffs, _vsegmentlengths;
+    std::vector<size_t> _vsegmentstarts;
+    std::vector<dReal> _vsampletimes, _vsampledata;
+    std::vector<dReal> _vfulldofvalues, _vfulldofvelocities, _vfulldofaccelerations;
+    boost::array< std::vector<dReal>, 3> _vtorquecomponents;
+    std::vector<dReal> _vdeltatimes, _vtrajdata;
+    std::vector< boost::array<int, 5> > _vgroupoffsets; ///< for every group of the configuration: offset in the configuration, position, velocity, acceleration offsets in the output, dof
+};
+
+const dReal ToppraTrajectoryRetimer::s_fMaxVariable = 1e10;
+const dReal ToppraTrajectoryRetimer::s_fLPEpsilon = 1e-9;
+
+PlannerBasePtr CreateToppraTrajectoryRetimer(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return PlannerBasePtr(new ToppraTrajectoryRetimer(penv, sinput));
+}
+
+} // end namespace rplanners
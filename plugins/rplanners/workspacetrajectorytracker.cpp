@@ -14,6 +14,7 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "openraveplugindefs.h"
+#include "differentialik.h"
 
 class WorkspaceTrajectoryTracker : public PlannerBase
 {
@@ -37,6 +38,8 @@ Planner Parameters\n\
 \n\
 - **dReal minimumcompletetime** - specifies the minimum trajectory that must be followed for planner to declare success. If 0, then the entire trajectory has to be followed.\n\
 \n\
+- **bool usedifferentialik** - track the trajectory with jacobian-based differential ik from the previous solution, and only call the analytical ik solver where it does not converge. The manipulator does not need an ik solver if differential ik always converges.\n\
+\n\
 - **TrajectoryBasePtr workspacetraj** - workspace trajectory of the end effector, needs to hold 'ikparam_values' groups\n\
 \n\
 ";
@@ -119,17 +122,27 @@ Planner Parameters\n\
         }
 
         if( !_manip->GetIkSolver() ) {
-            const std::string msg(str(boost::format("manipulator %s does not have ik solver set\n")%_manip->GetName()));
-            RAVELOG_ERROR(msg);
-            return PlannerStatus(msg, PS_Failed);
+            if( !parameters->usedifferentialik ) {
+                const std::string msg(str(boost::format("manipulator %s does not have ik solver set\n")%_manip->GetName()));
+                RAVELOG_ERROR(msg);
+                return PlannerStatus(msg, PS_Failed);
+            }
         }
-
-        if( !_manip->GetIkSolver()->Supports(IKP_Transform6D) ) {
+        else if( !_manip->GetIkSolver()->Supports(IKP_Transform6D) ) {
             const std::string msg(str(boost::format("WorkspaceTrajectoryTracker: unsupported iktype for manipulator %s")%_manip->GetName()));
             RAVELOG_ERROR(msg);
             return PlannerStatus(msg, PS_Failed);
         }
 
+        if( parameters->usedifferentialik ) {
+            _differentialik.Init(_manip);
+            // consecutive workspace samples are _fStepLength apart in time
+            if( parameters->_vConfigVelocityLimit.size() == _manip->GetArmIndices().size() ) {
+                _differentialik.SetVelocityLimits(parameters->_vConfigVelocityLimit);
+            }
+            _differentialik.SetTimeStep(parameters->_fStepLength);
+        }
+
         _retimerplanner = RaveCreatePlanner(GetEnv(),"lineartrajectoryretimer");
         _parameters = parameters;
         return PlannerStatus(PS_HasSolution);
@@ -239,7 +252,10 @@ Planner Parameters\n\
             poutputtraj->Insert(poutputtraj->GetNumWaypoints(),_parameters->vinitialconfig,_parameters->_configurationspecification);
         }
 
-        UserDataPtr filterhandle = _manip->GetIkSolver()->RegisterCustomFilter(0,boost::bind(&WorkspaceTrajectoryTracker::_ValidateSolution,this,_1,_2,_3));
+        UserDataPtr filterhandle;
+        if( !!_manip->GetIkSolver() ) {
+            filterhandle = _manip->GetIkSolver()->RegisterCustomFilter(0,boost::bind(&WorkspaceTrajectoryTracker::_ValidateSolution,this,_1,_2,_3));
+        }
         vector<dReal> vsolution;
         if( !_parameters->greedysearch ) {
             RAVELOG_ERROR("WorkspaceTrajectoryTracker::PlanPath - do not support non-greedy search\n");
@@ -251,14 +267,15 @@ Planner Parameters\n\
         for(; ittrans != listtransforms.end(); ftime += _parameters->_fStepLength, ++ittrans) {
             _filteroptions = (ftime >= fstarttime) ? IKFO_CheckEnvCollisions : 0;
             IkParameterization ikparam1(*ittrans,IKP_Transform6D);
-            if( !_manip->FindIKSolution(ikparam1,vsolution,_filteroptions) ) {
+            const bool bDifferentialSolution = _parameters->usedifferentialik && _FindDifferentialIKSolution(*ittrans,vsolution);
+            if( !bDifferentialSolution && !_FindIKSolution(ikparam1,vsolution) ) {
                 if( _filteroptions == 0 ) {
                     // haven't even checked with environment collisions, so a solution really doesn't exist
                     return PlannerStatus(PS_Failed);
                 }
                 if(( ftime < _parameters->ignorefirstcollision) && bPrevInCollision ) {
                     _filteroptions = 0;
-                    if( !_manip->FindIKSolution(ikparam1,vsolution,_filteroptions) ) {
+                    if( !_FindIKSolution(ikparam1,vsolution) ) {
                         return PlannerStatus(PS_Failed);
                     }
                 }
@@ -301,6 +318,40 @@ Planner Parameters\n\
     }
 
 protected:
+    bool _FindIKSolution(const IkParameterization& ikparam, std::vector<dReal>& vsolution)
+    {
+        if( !_manip->GetIkSolver() ) {
+            return false;
+        }
+        return _manip->FindIKSolution(ikparam,vsolution,_filteroptions);
+    }
+
+    /// \brief moves from the previous solution (or the current configuration for the first point) to tgoal with differential ik, and validates the result like the ik filter does
+    bool _FindDifferentialIKSolution(const Transform& tgoal, std::vector<dReal>& vsolution)
+    {
+        RobotBase::RobotStateSaver saver(_robot, KinBody::Save_LinkTransformation|KinBody::Save_LinkEnable|KinBody::Save_ActiveDOF|KinBody::Save_ActiveManipulator|KinBody::Save_Lightweight);
+        if( _vprevsolution.size() > 0 ) {
+            vsolution = _vprevsolution;
+        }
+        else {
+            _robot->GetActiveDOFValues(vsolution);
+        }
+        if( !_differentialik.Solve(tgoal, vsolution) ) {
+            return false;
+        }
+        // the ik solver passes the goal in the frame of the manipulator base to the custom filter
+        if( _ValidateSolution(vsolution, _manip, IkParameterization(_tbaseinv*tgoal, IKP_Transform6D)) != IKRA_Success ) {
+            return false;
+        }
+        if( !(_filteroptions & IKFO_CheckEnvCollisions) ) {
+            // the ik solver checks self-collisions even without IKFO_CheckEnvCollisions
+            _robot->SetActiveDOFs(_manip->GetArmIndices());
+            _robot->SetActiveDOFValues(vsolution);
+            return !_robot->CheckSelfCollision();
+        }
+        return true;
+    }
+
     void _SetPreviousSolution(const std::vector<dReal>& vsolution, bool bsetjacobian=true)
     {
         if( bsetjacobian ) {
@@ -329,7 +380,7 @@ protected:
 
     IkReturnAction _ValidateSolution(std::vector<dReal>& vsolution, RobotBase::ManipulatorConstPtr pmanip, const IkParameterization& ikp)
     {
-        RobotBase::RobotStateSaver saver(_robot);
+        RobotBase::RobotStateSaver saver(_robot, KinBody::Save_LinkTransformation|KinBody::Save_LinkEnable|KinBody::Save_ActiveDOF|KinBody::Save_ActiveManipulator|KinBody::Save_Lightweight);
 
         // check if continuous with previous solution using the jacobian
         if( _mjacobian.num_elements() > 0 ) {
@@ -438,6 +489,7 @@ protected:
     IkParameterization _ikprev;
     vector<dReal> _vprevsolution;
     PlannerBasePtr _retimerplanner;
+    rplanners::DifferentialIKSolver _differentialik;
 };
 
 PlannerBasePtr CreateWorkspaceTrajectoryTracker(EnvironmentBasePtr penv, std::istream& sinput) {
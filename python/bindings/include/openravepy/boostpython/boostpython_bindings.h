@@ -125,6 +125,32 @@ inline py::numeric::array toPyArray(const boost::array<T, N>& v)
     return toPyArrayN(v.data(), N);
 }
 
+template <typename T>
+inline void _DeleteAdoptedVector(PyObject* pycapsule)
+{
+    delete reinterpret_cast<std::vector<T>*>(PyCapsule_GetPointer(pycapsule, nullptr));
+}
+
+/// \brief hands the memory of v over to a new numpy array without copying, v is left empty.
+///
+/// The array keeps the storage alive through a capsule set as its base object.
+template <typename T>
+inline py::numeric::array toPyArrayAdopt(std::vector<T>&& v, std::vector<npy_intp>& dims)
+{
+    size_t numel = 1;
+    for(npy_intp dim : dims) {
+        numel *= dim;
+    }
+    if( dims.empty() || numel == 0 ) {
+        return static_cast<py::numeric::array>(py::empty_array_astype<T>());
+    }
+    BOOST_ASSERT(numel == v.size());
+    std::vector<T>* pstorage = new std::vector<T>(std::move(v));
+    PyObject *pyvalues = PyArray_SimpleNewFromData(dims.size(), dims.data(), select_npy_type<T>::type, pstorage->data());
+    PyArray_SetBaseObject((PyArrayObject*)pyvalues, PyCapsule_New(pstorage, nullptr, &_DeleteAdoptedVector<T>));
+    return static_cast<py::numeric::array>(py::handle<>(pyvalues));
+}
+
 #endif // OPENRAVE_BINDINGS_PYARRAY
 
 template <typename T>
@@ -45,9 +45,24 @@ public:
     py::object ExtractFirstBodyLinkGeomNames();
     py::object ExtractSecondBodyLinkGeomNames();
 
+    int FindFirstMatchingLinkIndex(py::object olinks) const;
+    int FindSecondMatchingLinkIndex(py::object olinks) const;
+
+    /// \brief fills the names from the indices if the pair was recorded with CollisionReport::bIndexOnly
+    bool ResolveNames(PyEnvironmentBasePtr pyenv);
+
     std::string bodyLinkGeom1Name;
     std::string bodyLinkGeom2Name;
+    int bodyIndex1 = 0;
+    int linkIndex1 = -1;
+    int geomIndex1 = -1;
+    int bodyIndex2 = 0;
+    int linkIndex2 = -1;
+    int geomIndex2 = -1;
     py::list contacts;
+
+private:
+    void _FillCollisionPairInfo(CollisionPairInfo& cpinfo) const;
 };
 
 class OPENRAVEPY_API PyCollisionReport
@@ -62,11 +77,15 @@ public:
     object __unicode__() const;
     void Reset(int coloptions=0);
 
+    /// \brief resolves the names of all the collisions recorded with bIndexOnly
+    bool ResolveNames(PyEnvironmentBasePtr pyenv);
+
     py::list collisionInfos; // list of PyCollisionPairInfo
     int options = 0;
     OpenRAVE::dReal minDistance = 1e20;
     int numWithinTol = 0;
     uint32_t nKeepPrevious = 0;
+    bool bIndexOnly = false; ///< passed to the CollisionReport of the queries, kept by Reset
 };
 
 } // namespace openravepy
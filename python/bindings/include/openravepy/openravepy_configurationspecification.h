@@ -94,6 +94,8 @@ public:
 
     object ConvertDataFromPrevious(object otargetdata, PyConfigurationSpecificationPtr pytargetspec, object osourcedata, size_t numpoints, PyEnvironmentBasePtr pyenv);
 
+    object ConvertGroupData(object otargetdata, PyConfigurationSpecificationPtr pytargetspec, const ConfigurationSpecification::Group& gtarget, object osourcedata, const ConfigurationSpecification::Group& gsource, size_t numpoints, PyEnvironmentBasePtr pyenv, bool filluninitialized = true);
+
     py::list GetGroups();
 
     bool __eq__(PyConfigurationSpecificationPtr p);
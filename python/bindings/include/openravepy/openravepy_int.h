@@ -239,6 +239,29 @@ private:
 
 typedef OPENRAVE_SHARED_PTR<PythonThreadSaver> PythonThreadSaverPtr;
 
+/// \brief gets the memory of a caller-provided numpy array so that results can be written into it without allocating a new array.
+///
+/// \param oarray has to be a C-contiguous, aligned, and writeable numpy array whose element type is T. Its shape is not checked.
+/// \param[out] ppdata set to the start of the array memory
+/// \return number of elements of the array
+template <typename T>
+inline size_t ExtractWriteableContiguousArray(const py::object& oarray, T** ppdata)
+{
+    PyObject* pyo = oarray.ptr();
+    if( pyo == nullptr || !PyArray_Check(pyo) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0(_("output has to be a numpy array"), ORE_InvalidArguments);
+    }
+    PyArrayObject* pyarr = reinterpret_cast<PyArrayObject*>(pyo);
+    if( PyArray_TYPE(pyarr) != select_npy_type<T>::type ) {
+        throw OPENRAVE_EXCEPTION_FORMAT(_("output array has type %d, expected %d"), PyArray_TYPE(pyarr)%int(select_npy_type<T>::type), ORE_InvalidArguments);
+    }
+    if( !PyArray_ISCARRAY(pyarr) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0(_("output array has to be C-contiguous, aligned, and writeable"), ORE_InvalidArguments);
+    }
+    *ppdata = reinterpret_cast<T*>(PyArray_DATA(pyarr));
+    return PyArray_SIZE(pyarr);
+}
+
 inline RaveVector<float> ExtractFloat3(const py::object& o)
 {
     return RaveVector<float>(py::extract<float>(o[py::to_object(0)]), py::extract<float>(o[py::to_object(1)]), py::extract<float>(o[py::to_object(2)]));
@@ -205,6 +205,9 @@ public:
     py::object GetDOFValues(py::object oindices) const;
     py::object GetDOFVelocities() const;
     py::object GetDOFVelocities(py::object oindices) const;
+    /// \brief writes the DOF values into a caller-provided contiguous numpy array of size GetDOF(), avoids allocating a new array every call
+    void GetDOFValuesInto(py::object oout) const;
+    void GetDOFVelocitiesInto(py::object oout) const;
     py::object GetDOFLimits() const;
     py::object GetDOFVelocityLimits() const;
     py::object GetDOFAccelerationLimits() const;
@@ -245,6 +248,9 @@ public:
     py::object GetTransform() const;
     py::object GetTransformPose() const;
     py::object GetLinkTransformations(bool returndoflastvlaues=false) const;
+    /// \brief returns all link transforms as one (numlinks, 7) array of [quaternion, translation] poses instead of a list of 4x4 matrices
+    py::object GetLinkTransformPoses() const;
+    void GetLinkTransformPosesInto(py::object oout) const;
     void SetLinkTransformations(py::object transforms, py::object odoflastvalues=py::none_());
     void SetLinkVelocities(py::object ovelocities);
     py::object GetLinkEnableStates() const;
@@ -297,6 +303,10 @@ public:
     py::object ComputeHessianTranslation(int index, py::object oposition, py::object oindices=py::none_());
     py::object ComputeHessianAxisAngle(int index, py::object oindices=py::none_());
     py::object ComputeInverseDynamics(py::object odofaccelerations, py::object oexternalforcetorque=py::none_(), bool returncomponents=false);
+    py::object ComputeInverseDynamicsBatch(py::object odofvalues, py::object odofvelocities=py::none_(), py::object odofaccelerations=py::none_(), py::object oexternalforcetorque=py::none_());
+    py::object ComputeMassMatrix() const;
+    py::object ComputeCoriolisTorques() const;
+    py::object ComputeGravityTorques() const;
     py::object GetDOFDynamicAccelerationJerkLimits(py::object oDOFPositions, py::object oDOFVelocities) const;
     void SetSelfCollisionChecker(PyCollisionCheckerBasePtr pycollisionchecker);
     PyInterfaceBasePtr GetSelfCollisionChecker();
@@ -333,6 +343,8 @@ public:
     py::object GetReferenceURI() const;
     py::object GetNonAdjacentLinks() const;
     py::object GetNonAdjacentLinks(int adjacentoptions) const;
+    int ComputeSelfCollisionLinkPairCulling(int maxevaluations=256);
+    bool IsLinkPairCollisionFree(int linkindex0, int linkindex1) const;
     void SetAdjacentLinks(int linkindex0, int linkindex1);
     void SetAdjacentLinksCombinations(py::object olinkIndices);
     py::object GetAdjacentLinks() const;
@@ -50,10 +50,20 @@ public:
 
     object SampleFromPrevious(object odata, dReal time, PyConfigurationSpecificationPtr pyspec) const;
 
+    /// \brief samples into a caller-provided contiguous numpy array, avoids allocating a new array every call
+    void SampleInto(object oout, dReal time) const;
+
+    void SampleInto(object oout, dReal time, PyConfigurationSpecificationPtr pyspec) const;
+
     object SamplePoints2D(object otimes) const;
 
     object SamplePoints2D(object otimes, PyConfigurationSpecificationPtr pyspec) const;
 
+    /// \brief samples all times into a caller-provided contiguous numpy array of shape (len(otimes), dof)
+    void SamplePoints2DInto(object oout, object otimes) const;
+
+    void SamplePoints2DInto(object oout, object otimes, PyConfigurationSpecificationPtr pyspec) const;
+
     object SamplePointsSameDeltaTime2D(dReal deltatime, bool ensureLastPoint) const;
 
     object SamplePointsSameDeltaTime2D(dReal deltatime, bool ensureLastPoint, PyConfigurationSpecificationPtr pyspec) const;
@@ -179,6 +179,27 @@ inline py::array_t<T> toPyArray(const boost::array<T, N>& v)
     return toPyArrayN(v.data(), N);
 }
 
+/// \brief hands the memory of v over to a new numpy array without copying, v is left empty.
+///
+/// The array keeps the storage alive through a capsule set as its base object.
+template <typename T>
+inline py::array_t<T> toPyArrayAdopt(std::vector<T>&& v, std::vector<npy_intp>& dims)
+{
+    if( v.empty() ) {
+        return toPyArrayN((T*)nullptr, dims);
+    }
+    size_t numel = 1;
+    for(npy_intp dim : dims) {
+        numel *= dim;
+    }
+    BOOST_ASSERT(numel == v.size());
+    std::vector<T>* pstorage = new std::vector<T>(std::move(v));
+    py::capsule base(pstorage, [](void* p) {
+        delete reinterpret_cast<std::vector<T>*>(p);
+    });
+    return py::array_t<T>(dims, pstorage->data(), base);
+}
+
 #endif // OPENRAVE_BINDINGS_PYARRAY
 
 template <typename type>
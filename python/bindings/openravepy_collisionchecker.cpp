@@ -74,6 +74,12 @@ PyCollisionPairInfo::PyCollisionPairInfo(const CollisionPairInfo& cpinfo)
 {
     bodyLinkGeom1Name = cpinfo.bodyLinkGeom1Name;
     bodyLinkGeom2Name = cpinfo.bodyLinkGeom2Name;
+    bodyIndex1 = cpinfo.bodyIndex1;
+    linkIndex1 = cpinfo.linkIndex1;
+    geomIndex1 = cpinfo.geomIndex1;
+    bodyIndex2 = cpinfo.bodyIndex2;
+    linkIndex2 = cpinfo.linkIndex2;
+    geomIndex2 = cpinfo.geomIndex2;
     for(const CONTACT& c : cpinfo.contacts) {
         contacts.append(PYCONTACT(c));
     }
@@ -108,6 +114,54 @@ py::object PyCollisionPairInfo::ExtractSecondBodyLinkGeomNames()
     return py::make_tuple(ConvertStringToUnicode(std::string(bodyname)), ConvertStringToUnicode(std::string(linkname)), ConvertStringToUnicode(std::string(geomname)));
 }
 
+void PyCollisionPairInfo::_FillCollisionPairInfo(CollisionPairInfo& cpinfo) const
+{
+    cpinfo.bodyLinkGeom1Name = bodyLinkGeom1Name;
+    cpinfo.bodyLinkGeom2Name = bodyLinkGeom2Name;
+    cpinfo.bodyIndex1 = bodyIndex1;
+    cpinfo.linkIndex1 = linkIndex1;
+    cpinfo.geomIndex1 = geomIndex1;
+    cpinfo.bodyIndex2 = bodyIndex2;
+    cpinfo.linkIndex2 = linkIndex2;
+    cpinfo.geomIndex2 = geomIndex2;
+}
+
+int PyCollisionPairInfo::FindFirstMatchingLinkIndex(py::object olinks) const
+{
+    std::vector<KinBody::LinkPtr> vlinks;
+    const size_t numLinks = len(olinks);
+    vlinks.reserve(numLinks);
+    for(size_t ilink = 0; ilink < numLinks; ++ilink) {
+        vlinks.push_back(openravepy::GetKinBodyLink(olinks[ilink]));
+    }
+    CollisionPairInfo cpinfo;
+    _FillCollisionPairInfo(cpinfo);
+    return cpinfo.FindFirstMatchingLinkIndex(vlinks);
+}
+
+int PyCollisionPairInfo::FindSecondMatchingLinkIndex(py::object olinks) const
+{
+    std::vector<KinBody::LinkPtr> vlinks;
+    const size_t numLinks = len(olinks);
+    vlinks.reserve(numLinks);
+    for(size_t ilink = 0; ilink < numLinks; ++ilink) {
+        vlinks.push_back(openravepy::GetKinBodyLink(olinks[ilink]));
+    }
+    CollisionPairInfo cpinfo;
+    _FillCollisionPairInfo(cpinfo);
+    return cpinfo.FindSecondMatchingLinkIndex(vlinks);
+}
+
+bool PyCollisionPairInfo::ResolveNames(PyEnvironmentBasePtr pyenv)
+{
+    CollisionPairInfo cpinfo;
+    _FillCollisionPairInfo(cpinfo);
+    bool bSuccess = cpinfo.ResolveNames(*openravepy::GetEnvironment(pyenv));
+    bodyLinkGeom1Name = cpinfo.bodyLinkGeom1Name;
+    bodyLinkGeom2Name = cpinfo.bodyLinkGeom2Name;
+    return bSuccess;
+}
+
 PyCollisionReport::PyCollisionReport() {
 }
 PyCollisionReport::PyCollisionReport(const CollisionReport& report)
@@ -126,6 +180,7 @@ void PyCollisionReport::Init(const CollisionReport& report)
     minDistance = report.minDistance;
     numWithinTol = report.numWithinTol;
     nKeepPrevious = report.nKeepPrevious;
+    bIndexOnly = report.bIndexOnly;
 }
 
 void PyCollisionReport::Reset(int coloptions)
@@ -137,6 +192,15 @@ void PyCollisionReport::Reset(int coloptions)
     nKeepPrevious = 0;
 }
 
+bool PyCollisionReport::ResolveNames(PyEnvironmentBasePtr pyenv)
+{
+    bool bSuccess = true;
+    for(int index = 0; index < len(collisionInfos); ++index) {
+        bSuccess &= py::extract<bool>(collisionInfos[index].attr("ResolveNames")(pyenv));
+    }
+    return bSuccess;
+}
+
 std::string PyCollisionReport::__str__() const
 {
     std::stringstream s;
@@ -228,6 +292,7 @@ bool PyCollisionCheckerBase::CheckCollision(PyKinBodyPtr pbody1, PyCollisionRepo
     CHECK_POINTER(pbody1);
     CollisionReport report;
     CollisionReportPtr preport(&report,utils::null_deleter());
+    report.bIndexOnly = pyreport->bIndexOnly;
     bool bCollision = _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), preport);
     pyreport->Init(report);
     return bCollision;
@@ -250,6 +315,7 @@ bool PyCollisionCheckerBase::CheckCollision(PyKinBodyPtr pbody1, PyKinBodyPtr pb
     CHECK_POINTER(pbody2);
     CollisionReport report;
     CollisionReportPtr preport(&report,utils::null_deleter());
+    report.bIndexOnly = pyreport->bIndexOnly;
     bool bCollision = _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)), preport);
     pyreport->Init(report);
     return bCollision;
@@ -277,6 +343,7 @@ bool PyCollisionCheckerBase::CheckCollision(object o1, PyCollisionReportPtr pyre
 
     CollisionReport report;
     CollisionReportPtr preport(&report,utils::null_deleter());
+    report.bIndexOnly = pyreport->bIndexOnly;
 
     CHECK_POINTER(o1);
     KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
@@ -317,6 +384,7 @@ bool PyCollisionCheckerBase::CheckCollision(object o1, object o2)
             if( epyreport2.check() ) {
                 CollisionReport report;
                 CollisionReportPtr preport(&report,utils::null_deleter());
+                report.bIndexOnly = ((PyCollisionReportPtr)epyreport2)->bIndexOnly;
                 bool bCollision = _pCollisionChecker->CheckCollision(plink,preport);
                 ((PyCollisionReportPtr)epyreport2)->Init(report);
                 return bCollision;
@@ -340,6 +408,7 @@ bool PyCollisionCheckerBase::CheckCollision(object o1, object o2)
             if( epyreport2.check() ) {
                 CollisionReport report;
                 CollisionReportPtr preport(&report,utils::null_deleter());
+                report.bIndexOnly = ((PyCollisionReportPtr)epyreport2)->bIndexOnly;
                 bool bCollision = _pCollisionChecker->CheckCollision(pbody,preport);
                 ((PyCollisionReportPtr)epyreport2)->Init(report);
                 return bCollision;
@@ -360,6 +429,7 @@ bool PyCollisionCheckerBase::CheckCollision(object o1, object o2, PyCollisionRep
 
     CollisionReport report;
     CollisionReportPtr preport(&report,utils::null_deleter());
+    report.bIndexOnly = pyreport->bIndexOnly;
 
     bool bCollision = false;
     KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
@@ -427,6 +497,7 @@ bool PyCollisionCheckerBase::CheckCollision(object o1, PyKinBodyPtr pybody2, PyC
 
     CollisionReport report;
     CollisionReportPtr preport(&report,utils::null_deleter());
+    report.bIndexOnly = pyreport->bIndexOnly;
 
     CHECK_POINTER(o1);
     CHECK_POINTER(pybody2);
@@ -499,6 +570,7 @@ bool PyCollisionCheckerBase::CheckCollision(object o1, object bodyexcluded, obje
 
     CollisionReport report;
     CollisionReportPtr preport(&report,utils::null_deleter());
+    report.bIndexOnly = pyreport->bIndexOnly;
 
     std::vector<KinBodyConstPtr> vbodyexcluded;
     KinBody::LinkConstPtr plink1 = openravepy::GetKinBodyLinkConst(o1);
@@ -572,6 +644,7 @@ bool PyCollisionCheckerBase::CheckCollision(PyKinBodyPtr pbody, object bodyexclu
 
     CollisionReport report;
     CollisionReportPtr preport(&report,utils::null_deleter());
+    report.bIndexOnly = pyreport->bIndexOnly;
 
     std::vector<KinBodyConstPtr> vbodyexcluded;
     size_t numBodyExcluded = len(bodyexcluded);
@@ -613,6 +686,7 @@ bool PyCollisionCheckerBase::CheckCollision(OPENRAVE_SHARED_PTR<PyRay> pyray, Py
 
     CollisionReport report;
     CollisionReportPtr preport(&report,utils::null_deleter());
+    report.bIndexOnly = pyreport->bIndexOnly;
     bool bCollision = _pCollisionChecker->CheckCollision(pyray->r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), preport);
     pyreport->Init(report);
     return bCollision;
@@ -730,6 +804,7 @@ bool PyCollisionCheckerBase::CheckCollision(OPENRAVE_SHARED_PTR<PyRay> pyray, Py
 
     CollisionReport report;
     CollisionReportPtr preport(&report,utils::null_deleter());
+    report.bIndexOnly = pyreport->bIndexOnly;
 
     bool bCollision = _pCollisionChecker->CheckCollision(pyray->r, preport);
     pyreport->Init(report);
@@ -742,6 +817,7 @@ bool PyCollisionCheckerBase::CheckCollisionTriMesh(object otrimesh, PyKinBodyPtr
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     TriMesh trimesh;
@@ -762,6 +838,7 @@ bool PyCollisionCheckerBase::CheckCollisionTriMesh(object otrimesh, PyCollisionR
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     TriMesh trimesh;
@@ -781,6 +858,7 @@ bool PyCollisionCheckerBase::CheckCollisionOBB(object oaabb, object otransform,
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     AABB aabb = ExtractAABB(oaabb);
@@ -798,6 +876,7 @@ bool PyCollisionCheckerBase::CheckCollisionOBB(object oaabb, object otransform,
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     const AABB aabb = ExtractAABB(oaabb);
@@ -825,6 +904,7 @@ bool PyCollisionCheckerBase::CheckSelfCollision(object o1, PyCollisionReportPtr
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     KinBody::LinkConstPtr plink1 = openravepy::GetKinBodyLinkConst(o1);
@@ -970,6 +1050,15 @@ void init_openravepy_collisionchecker()
     .def("__unicode__",&PyCollisionPairInfo::__unicode__)
     .def("ExtractFirstBodyLinkGeomNames", &PyCollisionPairInfo::ExtractFirstBodyLinkGeomNames)
     .def("ExtractSecondBodyLinkGeomNames", &PyCollisionPairInfo::ExtractSecondBodyLinkGeomNames)
+    .def_readonly("bodyIndex1", &PyCollisionPairInfo::bodyIndex1)
+    .def_readonly("linkIndex1", &PyCollisionPairInfo::linkIndex1)
+    .def_readonly("geomIndex1", &PyCollisionPairInfo::geomIndex1)
+    .def_readonly("bodyIndex2", &PyCollisionPairInfo::bodyIndex2)
+    .def_readonly("linkIndex2", &PyCollisionPairInfo::linkIndex2)
+    .def_readonly("geomIndex2", &PyCollisionPairInfo::geomIndex2)
+    .def("FindFirstMatchingLinkIndex", &PyCollisionPairInfo::FindFirstMatchingLinkIndex, PY_ARGS("links") DOXY_FN(CollisionPairInfo, FindFirstMatchingLinkIndex))
+    .def("FindSecondMatchingLinkIndex", &PyCollisionPairInfo::FindSecondMatchingLinkIndex, PY_ARGS("links") DOXY_FN(CollisionPairInfo, FindSecondMatchingLinkIndex))
+    .def("ResolveNames", &PyCollisionPairInfo::ResolveNames, PY_ARGS("env") DOXY_FN(CollisionPairInfo, ResolveNames))
     ;
 #ifdef USE_PYBIND11_PYTHON_BINDINGS
     class_<PyCollisionReport, OPENRAVE_SHARED_PTR<PyCollisionReport> >(m, "CollisionReport", DOXY_CLASS(CollisionReport))
@@ -982,6 +1071,8 @@ void init_openravepy_collisionchecker()
     .def_readonly("minDistance",&PyCollisionReport::minDistance)
     .def_readonly("numWithinTol",&PyCollisionReport::numWithinTol)
     .def_readonly("nKeepPrevious", &PyCollisionReport::nKeepPrevious)
+    .def_readwrite("bIndexOnly", &PyCollisionReport::bIndexOnly)
+    .def("ResolveNames", &PyCollisionReport::ResolveNames, PY_ARGS("env") DOXY_FN(CollisionReport, ResolveNames))
     .def("__str__",&PyCollisionReport::__str__)
     .def("__unicode__",&PyCollisionReport::__unicode__)
 #ifdef USE_PYBIND11_PYTHON_BINDINGS
@@ -527,6 +527,13 @@ public:
         }
     }
 
+    object Simplify(dReal fErrorTolerance) const {
+        TriMesh mesh, simplified;
+        GetTriMesh(mesh);
+        mesh.Simplify(fErrorTolerance, simplified);
+        return py::to_object(OPENRAVE_SHARED_PTR<PyTriMesh>(new PyTriMesh(simplified)));
+    }
+
     std::string __str__() {
         return boost::str(boost::format("<trimesh: verts %d, tris=%d>")%len(vertices)%len(indices));
     }
@@ -821,6 +828,17 @@ object PyConfigurationSpecification::ConvertDataFromPrevious(object otargetdata,
     return toPyArray(vtargetdata);
 }
 
+// converts only gsource of the current spec into gtarget of pytargetspec, the other values of otargetdata are kept
+object PyConfigurationSpecification::ConvertGroupData(object otargetdata, PyConfigurationSpecificationPtr pytargetspec, const ConfigurationSpecification::Group& gtarget, object osourcedata, const ConfigurationSpecification::Group& gsource, size_t numpoints, PyEnvironmentBasePtr pyenv, bool filluninitialized)
+{
+    std::vector<dReal> vtargetdata = ExtractArray<dReal>(otargetdata);
+    std::vector<dReal> vsourcedata = ExtractArray<dReal>(osourcedata);
+    OPENRAVE_ASSERT_OP((int)vtargetdata.size(),>=,pytargetspec->_spec.GetDOF()*(int)numpoints);
+    OPENRAVE_ASSERT_OP((int)vsourcedata.size(),>=,_spec.GetDOF()*(int)numpoints);
+    ConfigurationSpecification::ConvertGroupData(vtargetdata.begin()+gtarget.offset, pytargetspec->_spec.GetDOF(), gtarget, vsourcedata.begin()+gsource.offset, _spec.GetDOF(), gsource, numpoints, openravepy::GetEnvironment(pyenv), filluninitialized);
+    return toPyArray(vtargetdata);
+}
+
 py::list PyConfigurationSpecification::GetGroups()
 {
     py::list ogroups;
@@ -2015,6 +2033,7 @@ void init_openravepy_global()
 #endif
     .def_readwrite("vertices",&PyTriMesh::vertices)
     .def_readwrite("indices",&PyTriMesh::indices)
+    .def("Simplify",&PyTriMesh::Simplify, PY_ARGS("errortolerance") DOXY_FN(TriMesh,Simplify))
     .def("__str__",&PyTriMesh::__str__)
     .def("__unicode__",&PyTriMesh::__unicode__)
 #ifdef USE_PYBIND11_PYTHON_BINDINGS
@@ -2199,6 +2218,21 @@ void init_openravepy_global()
             .def("ConvertData", &PyConfigurationSpecification::ConvertData, PY_ARGS("targetspec", "sourcedata", "numpoints", "env", "filluninitialized") DOXY_FN(ConfigurationSpecification, ConvertData))
 #endif
             .def("ConvertDataFromPrevious", &PyConfigurationSpecification::ConvertDataFromPrevious, PY_ARGS("targetdata", "targetspec", "sourcedata", "numpoints", "env") DOXY_FN(ConfigurationSpecification, ConvertData))
+#ifdef USE_PYBIND11_PYTHON_BINDINGS
+            .def("ConvertGroupData", &PyConfigurationSpecification::ConvertGroupData,
+                 "targetdata"_a,
+                 "targetspec"_a,
+                 "targetgroup"_a,
+                 "sourcedata"_a,
+                 "sourcegroup"_a,
+                 "numpoints"_a,
+                 "env"_a,
+                 "filluninitialized"_a = true,
+                 DOXY_FN(ConfigurationSpecification, ConvertGroupData)
+                 )
+#else
+            .def("ConvertGroupData", &PyConfigurationSpecification::ConvertGroupData, PY_ARGS("targetdata", "targetspec", "targetgroup", "sourcedata", "sourcegroup", "numpoints", "env", "filluninitialized") DOXY_FN(ConfigurationSpecification, ConvertGroupData))
+#endif
             .def("GetGroups", &PyConfigurationSpecification::GetGroups, /*PY_ARGS("env")*/ "returns a list of the groups")
             .def("__eq__",&PyConfigurationSpecification::__eq__)
             .def("__ne__",&PyConfigurationSpecification::__ne__)
@@ -1340,6 +1340,7 @@ object PyEnvironmentBase::GetCollisionChecker()
 bool PyEnvironmentBase::CheckCollision(PyKinBodyPtr pbody1)
 {
     CHECK_POINTER(pbody1);
+    openravepy::PythonThreadSaver threadsaver;
     return _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)));
 }
 bool PyEnvironmentBase::CheckCollision(PyKinBodyPtr pbody1, PyCollisionReportPtr pyreport)
@@ -1349,9 +1350,14 @@ bool PyEnvironmentBase::CheckCollision(PyKinBodyPtr pbody1, PyCollisionReportPtr
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
-    bool bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), preport);
+    bool bCollision;
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), preport);
+    }
     if( !!pyreport ) {
         pyreport->Init(report);
     }
@@ -1362,6 +1368,7 @@ bool PyEnvironmentBase::CheckCollision(PyKinBodyPtr pbody1, PyKinBodyPtr pbody2)
 {
     CHECK_POINTER(pbody1);
     CHECK_POINTER(pbody2);
+    openravepy::PythonThreadSaver threadsaver;
     return _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)));
 }
 
@@ -1373,9 +1380,14 @@ bool PyEnvironmentBase::CheckCollision(PyKinBodyPtr pbody1, PyKinBodyPtr pbody2,
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
-    bool bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)), preport);
+    bool bCollision;
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)), preport);
+    }
     if( !!pyreport ) {
         pyreport->Init(report);
     }
@@ -1387,10 +1399,12 @@ bool PyEnvironmentBase::CheckCollision(object o1)
     CHECK_POINTER(o1);
     KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
     if( !!plink ) {
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(plink);
     }
     KinBodyConstPtr pbody = openravepy::GetKinBody(o1);
     if( !!pbody ) {
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(pbody);
     }
     throw OPENRAVE_EXCEPTION_FORMAT0(_("CheckCollision(object) invalid argument"),ORE_InvalidArguments);
@@ -1403,16 +1417,19 @@ bool PyEnvironmentBase::CheckCollision(object o1, PyCollisionReportPtr pyreport)
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
     bool bCollision;
     if( !!plink ) {
+        openravepy::PythonThreadSaver threadsaver;
         bCollision = _penv->CheckCollision(plink,preport);
     }
     else {
         KinBodyConstPtr pbody = openravepy::GetKinBody(o1);
         if( !!pbody ) {
+            openravepy::PythonThreadSaver threadsaver;
             bCollision = _penv->CheckCollision(pbody,preport);
         }
         else {
@@ -1433,10 +1450,12 @@ bool PyEnvironmentBase::CheckCollision(object o1, object o2)
     if( !!plink ) {
         KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
         if( !!plink2 ) {
+            openravepy::PythonThreadSaver threadsaver;
             return _penv->CheckCollision(plink,plink2);
         }
         KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
         if( !!pbody2 ) {
+            openravepy::PythonThreadSaver threadsaver;
             return _penv->CheckCollision(plink,pbody2);
         }
 
@@ -1445,7 +1464,12 @@ bool PyEnvironmentBase::CheckCollision(object o1, object o2)
             if( epyreport2.check() ) {
                 CollisionReport report;
                 CollisionReportPtr preport(&report,utils::null_deleter());
-                bool bCollision = _penv->CheckCollision(plink,preport);
+                report.bIndexOnly = ((PyCollisionReportPtr)epyreport2)->bIndexOnly;
+                bool bCollision;
+                {
+                    openravepy::PythonThreadSaver threadsaver;
+                    bCollision = _penv->CheckCollision(plink,preport);
+                }
                 ((PyCollisionReportPtr)epyreport2)->Init(report);
                 return bCollision;
             }
@@ -1457,10 +1481,12 @@ bool PyEnvironmentBase::CheckCollision(object o1, object o2)
     if( !!pbody ) {
         KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
         if( !!plink2 ) {
+            openravepy::PythonThreadSaver threadsaver;
             return _penv->CheckCollision(plink2,pbody);
         }
         KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
         if( !!pbody2 ) {
+            openravepy::PythonThreadSaver threadsaver;
             return _penv->CheckCollision(pbody,pbody2);
         }
 
@@ -1469,7 +1495,12 @@ bool PyEnvironmentBase::CheckCollision(object o1, object o2)
             if( epyreport2.check() ) {
                 CollisionReport report;
                 CollisionReportPtr preport(&report,utils::null_deleter());
-                bool bCollision = _penv->CheckCollision(pbody,preport);
+                report.bIndexOnly = ((PyCollisionReportPtr)epyreport2)->bIndexOnly;
+                bool bCollision;
+                {
+                    openravepy::PythonThreadSaver threadsaver;
+                    bCollision = _penv->CheckCollision(pbody,preport);
+                }
                 ((PyCollisionReportPtr)epyreport2)->Init(report);
                 return bCollision;
             }
@@ -1488,6 +1519,7 @@ bool PyEnvironmentBase::CheckCollision(object o1, object o2, PyCollisionReportPt
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     bool bCollision = false;
@@ -1495,11 +1527,13 @@ bool PyEnvironmentBase::CheckCollision(object o1, object o2, PyCollisionReportPt
     if( !!plink ) {
         KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
         if( !!plink2 ) {
+            openravepy::PythonThreadSaver threadsaver;
             bCollision = _penv->CheckCollision(plink,plink2, preport);
         }
         else {
             KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
             if( !!pbody2 ) {
+                openravepy::PythonThreadSaver threadsaver;
                 bCollision = _penv->CheckCollision(plink,pbody2, preport);
             }
             else {
@@ -1511,11 +1545,13 @@ bool PyEnvironmentBase::CheckCollision(object o1, object o2, PyCollisionReportPt
         if( !!pbody ) {
             KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
             if( !!plink2 ) {
+                openravepy::PythonThreadSaver threadsaver;
                 bCollision = _penv->CheckCollision(plink2,pbody, preport);
             }
             else {
                 KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
                 if( !!pbody2 ) {
+                    openravepy::PythonThreadSaver threadsaver;
                     bCollision = _penv->CheckCollision(pbody,pbody2, preport);
                 }
                 else {
@@ -1541,10 +1577,12 @@ bool PyEnvironmentBase::CheckCollision(object o1, PyKinBodyPtr pybody2)
     KinBodyConstPtr pbody2 = openravepy::GetKinBody(pybody2);
     KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
     if( !!plink ) {
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(plink,pbody2);
     }
     KinBodyConstPtr pbody1 = openravepy::GetKinBody(o1);
     if( !!pbody1 ) {
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(pbody1,pbody2);
     }
     throw OPENRAVE_EXCEPTION_FORMAT0(_("CheckCollision(object) invalid argument"),ORE_InvalidArguments);
@@ -1558,17 +1596,20 @@ bool PyEnvironmentBase::CheckCollision(object o1, PyKinBodyPtr pybody2, PyCollis
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     KinBodyConstPtr pbody2 = openravepy::GetKinBody(pybody2);
     KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
     bool bCollision = false;
     if( !!plink ) {
+        openravepy::PythonThreadSaver threadsaver;
         bCollision = _penv->CheckCollision(plink,pbody2,preport);
     }
     else {
         KinBodyConstPtr pbody1 = openravepy::GetKinBody(o1);
         if( !!pbody1 ) {
+            openravepy::PythonThreadSaver threadsaver;
             bCollision = _penv->CheckCollision(pbody1,pbody2,preport);
         }
         else {
@@ -1611,9 +1652,11 @@ bool PyEnvironmentBase::CheckCollision(object o1, object bodyexcluded, object li
         }
     }
     if( !!plink1 ) {
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(plink1,vbodyexcluded,vlinkexcluded);
     }
     else if( !!pbody1 ) {
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(pbody1,vbodyexcluded,vlinkexcluded);
     }
     else {
@@ -1627,6 +1670,7 @@ bool PyEnvironmentBase::CheckCollision(object o1, object bodyexcluded, object li
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     std::vector<KinBodyConstPtr> vbodyexcluded;
@@ -1655,9 +1699,11 @@ bool PyEnvironmentBase::CheckCollision(object o1, object bodyexcluded, object li
 
     bool bCollision=false;
     if( !!plink1 ) {
+        openravepy::PythonThreadSaver threadsaver;
         bCollision = _penv->CheckCollision(plink1, vbodyexcluded, vlinkexcluded, preport);
     }
     else if( !!pbody1 ) {
+        openravepy::PythonThreadSaver threadsaver;
         bCollision = _penv->CheckCollision(pbody1, vbodyexcluded, vlinkexcluded, preport);
     }
     else {
@@ -1692,6 +1738,7 @@ bool PyEnvironmentBase::CheckCollision(PyKinBodyPtr pbody, object bodyexcluded,
             RAVELOG_ERROR("failed to get excluded link\n");
         }
     }
+    openravepy::PythonThreadSaver threadsaver;
     return _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody)),vbodyexcluded,vlinkexcluded);
 }
 
@@ -1701,6 +1748,7 @@ bool PyEnvironmentBase::CheckCollision(PyKinBodyPtr pbody, object bodyexcluded,
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     std::vector<KinBodyConstPtr> vbodyexcluded;
@@ -1724,7 +1772,11 @@ bool PyEnvironmentBase::CheckCollision(PyKinBodyPtr pbody, object bodyexcluded,
         }
     }
 
-    bool bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody)), vbodyexcluded, vlinkexcluded, preport);
+    bool bCollision;
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody)), vbodyexcluded, vlinkexcluded, preport);
+    }
     if( !!pyreport ) {
         pyreport->Init(report);
     }
@@ -1733,6 +1785,7 @@ bool PyEnvironmentBase::CheckCollision(PyKinBodyPtr pbody, object bodyexcluded,
 
 bool PyEnvironmentBase::CheckCollision(OPENRAVE_SHARED_PTR<PyRay> pyray, PyKinBodyPtr pbody)
 {
+    openravepy::PythonThreadSaver threadsaver;
     return _penv->CheckCollision(pyray->r,KinBodyConstPtr(openravepy::GetKinBody(pbody)));
 }
 
@@ -1742,9 +1795,14 @@ bool PyEnvironmentBase::CheckCollision(OPENRAVE_SHARED_PTR<PyRay> pyray, PyKinBo
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
-    bool bCollision = _penv->CheckCollision(pyray->r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), preport);
+    bool bCollision;
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        bCollision = _penv->CheckCollision(pyray->r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), preport);
+    }
     if( !!pyreport ) {
         pyreport->Init(report);
     }
@@ -1857,6 +1915,7 @@ bool PyEnvironmentBase::CheckCollision(OPENRAVE_SHARED_PTR<PyRay> pyray, PyColli
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     bool bCollision = _penv->CheckCollision(pyray->r, preport);
@@ -2949,6 +2949,26 @@ object PyKinBody::GetDOFVelocities(object oindices) const
     return toPyArray(values);
 }
 
+void PyKinBody::GetDOFValuesInto(object oout) const
+{
+    dReal* pout = nullptr;
+    const size_t nout = ExtractWriteableContiguousArray(oout, &pout);
+    static thread_local std::vector<dReal> values;
+    _pbody->GetDOFValues(values);
+    OPENRAVE_ASSERT_OP(nout, ==, values.size());
+    std::copy(values.begin(), values.end(), pout);
+}
+
+void PyKinBody::GetDOFVelocitiesInto(object oout) const
+{
+    dReal* pout = nullptr;
+    const size_t nout = ExtractWriteableContiguousArray(oout, &pout);
+    static thread_local std::vector<dReal> values;
+    _pbody->GetDOFVelocities(values);
+    OPENRAVE_ASSERT_OP(nout, ==, values.size());
+    std::copy(values.begin(), values.end(), pout);
+}
+
 object PyKinBody::GetDOFLimits() const
 {
     std::vector<dReal> vlower, vupper;
@@ -3388,6 +3408,40 @@ object PyKinBody::GetLinkTransformations(bool returndoflastvlaues) const
     return otransforms;
 }
 
+/// \brief writes link transforms as consecutive [qw, qx, qy, qz, tx, ty, tz] rows, same layout as toPyArray(Transform)
+static void _WriteLinkTransformPoses(const std::vector<KinBody::LinkPtr>& vlinks, dReal* ppose)
+{
+    for(const KinBody::LinkPtr& plink : vlinks) {
+        const Transform& t = plink->GetTransform();
+        ppose[0] = t.rot.x;
+        ppose[1] = t.rot.y;
+        ppose[2] = t.rot.z;
+        ppose[3] = t.rot.w;
+        ppose[4] = t.trans.x;
+        ppose[5] = t.trans.y;
+        ppose[6] = t.trans.z;
+        ppose += 7;
+    }
+}
+
+object PyKinBody::GetLinkTransformPoses() const
+{
+    const std::vector<KinBody::LinkPtr>& vlinks = _pbody->GetLinks();
+    std::vector<dReal> vposes(7*vlinks.size());
+    _WriteLinkTransformPoses(vlinks, vposes.data());
+    std::vector<npy_intp> dims = { npy_intp(vlinks.size()), 7 };
+    return toPyArrayAdopt(std::move(vposes), dims);
+}
+
+void PyKinBody::GetLinkTransformPosesInto(object oout) const
+{
+    dReal* pout = nullptr;
+    const size_t nout = ExtractWriteableContiguousArray(oout, &pout);
+    const std::vector<KinBody::LinkPtr>& vlinks = _pbody->GetLinks();
+    OPENRAVE_ASSERT_OP(nout, ==, 7*vlinks.size());
+    _WriteLinkTransformPoses(vlinks, pout);
+}
+
 void PyKinBody::SetLinkTransformations(object transforms, object odoflastvalues)
 {
     size_t numtransforms = len(transforms);
@@ -3934,16 +3988,11 @@ object PyKinBody::ComputeHessianAxisAngle(int index, object oindices)
     return toPyArray(vhessian,dims);
 }
 
-object PyKinBody::ComputeInverseDynamics(object odofaccelerations, object oexternalforcetorque, bool returncomponents)
+static void _ExtractForceTorqueMap(object oexternalforcetorque, KinBody::ForceTorqueMap& mapExternalForceTorque)
 {
-    std::vector<dReal> vDOFAccelerations;
-    if( !IS_PYTHONOBJECT_NONE(odofaccelerations) ) {
-        vDOFAccelerations = ExtractArray<dReal>(odofaccelerations);
-    }
-    KinBody::ForceTorqueMap mapExternalForceTorque;
+    mapExternalForceTorque.clear();
     if( !IS_PYTHONOBJECT_NONE(oexternalforcetorque) ) {
         py::dict odict = (py::dict)oexternalforcetorque;
-        std::vector<dReal> v;
 #ifdef USE_PYBIND11_PYTHON_BINDINGS
         for (const std::pair<py::handle, py::handle>& item : odict) {
             int linkindex = py::extract<int>(item.first);
@@ -3961,6 +4010,16 @@ object PyKinBody::ComputeInverseDynamics(object odofaccelerations, object oexter
         }
 #endif
     }
+}
+
+object PyKinBody::ComputeInverseDynamics(object odofaccelerations, object oexternalforcetorque, bool returncomponents)
+{
+    std::vector<dReal> vDOFAccelerations;
+    if( !IS_PYTHONOBJECT_NONE(odofaccelerations) ) {
+        vDOFAccelerations = ExtractArray<dReal>(odofaccelerations);
+    }
+    KinBody::ForceTorqueMap mapExternalForceTorque;
+    _ExtractForceTorqueMap(oexternalforcetorque, mapExternalForceTorque);
     if( returncomponents ) {
         boost::array< std::vector<dReal>, 3> vDOFTorqueComponents;
         _pbody->ComputeInverseDynamics(vDOFTorqueComponents,vDOFAccelerations,mapExternalForceTorque);
@@ -3973,6 +4032,48 @@ object PyKinBody::ComputeInverseDynamics(object odofaccelerations, object oexter
     }
 }
 
+object PyKinBody::ComputeInverseDynamicsBatch(object odofvalues, object odofvelocities, object odofaccelerations, object oexternalforcetorque)
+{
+    std::vector<dReal> vDOFValues = ExtractArray<dReal>(odofvalues);
+    std::vector<dReal> vDOFVelocities, vDOFAccelerations;
+    if( !IS_PYTHONOBJECT_NONE(odofvelocities) ) {
+        vDOFVelocities = ExtractArray<dReal>(odofvelocities);
+    }
+    if( !IS_PYTHONOBJECT_NONE(odofaccelerations) ) {
+        vDOFAccelerations = ExtractArray<dReal>(odofaccelerations);
+    }
+    KinBody::ForceTorqueMap mapExternalForceTorque;
+    _ExtractForceTorqueMap(oexternalforcetorque, mapExternalForceTorque);
+    std::vector<dReal> vDOFTorques;
+    _pbody->ComputeInverseDynamicsBatch(vDOFTorques, vDOFValues, vDOFVelocities, vDOFAccelerations, mapExternalForceTorque);
+    const int dof = _pbody->GetDOF();
+    std::vector<npy_intp> dims(2); dims[0] = dof > 0 ? vDOFTorques.size()/dof : 0; dims[1] = dof;
+    return toPyArray(vDOFTorques,dims);
+}
+
+object PyKinBody::ComputeMassMatrix() const
+{
+    std::vector<dReal> vMassMatrix;
+    _pbody->ComputeMassMatrix(vMassMatrix);
+    const int dof = _pbody->GetDOF();
+    std::vector<npy_intp> dims(2); dims[0] = dof; dims[1] = dof;
+    return toPyArray(vMassMatrix,dims);
+}
+
+object PyKinBody::ComputeCoriolisTorques() const
+{
+    std::vector<dReal> vCoriolisTorques;
+    _pbody->ComputeCoriolisTorques(vCoriolisTorques);
+    return toPyArray(vCoriolisTorques);
+}
+
+object PyKinBody::ComputeGravityTorques() const
+{
+    std::vector<dReal> vGravityTorques;
+    _pbody->ComputeGravityTorques(vGravityTorques);
+    return toPyArray(vGravityTorques);
+}
+
 object PyKinBody::GetDOFDynamicAccelerationJerkLimits(py::object oDOFPositions, py::object oDOFVelocities) const
 {
     if( IS_PYTHONOBJECT_NONE(oDOFPositions) || IS_PYTHONOBJECT_NONE(oDOFVelocities) ) {
@@ -4003,9 +4104,15 @@ bool PyKinBody::CheckSelfCollision(PyCollisionReportPtr pyreport, PyCollisionChe
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
-    bool bCollision = _pbody->CheckSelfCollision(preport, openravepy::GetCollisionChecker(pycollisionchecker));
+    CollisionCheckerBasePtr pcollisionchecker = openravepy::GetCollisionChecker(pycollisionchecker);
+    bool bCollision;
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        bCollision = _pbody->CheckSelfCollision(preport, pcollisionchecker);
+    }
     if( !!pyreport ) {
         pyreport->Init(report);
     }
@@ -4256,6 +4363,16 @@ object PyKinBody::GetNonAdjacentLinks(int adjacentoptions) const
     return ononadjacent;
 }
 
+int PyKinBody::ComputeSelfCollisionLinkPairCulling(int maxevaluations)
+{
+    return _pbody->ComputeSelfCollisionLinkPairCulling(maxevaluations);
+}
+
+bool PyKinBody::IsLinkPairCollisionFree(int linkindex0, int linkindex1) const
+{
+    return _pbody->IsLinkPairCollisionFree(linkindex0, linkindex1);
+}
+
 void PyKinBody::SetAdjacentLinks(int linkindex0, int linkindex1)
 {
     _pbody->SetAdjacentLinks(linkindex0, linkindex1);
@@ -4871,6 +4988,8 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(ComputeJacobianAxisAngle_overloads, Compu
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(ComputeHessianTranslation_overloads, ComputeHessianTranslation, 2, 3)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(ComputeHessianAxisAngle_overloads, ComputeHessianAxisAngle, 1, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(ComputeInverseDynamics_overloads, ComputeInverseDynamics, 1, 3)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(ComputeInverseDynamicsBatch_overloads, ComputeInverseDynamicsBatch, 1, 4)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(ComputeSelfCollisionLinkPairCulling_overloads, ComputeSelfCollisionLinkPairCulling, 0, 1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(Restore_overloads, Restore, 0,1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(ExtractInfo_overloads, ExtractInfo, 0,1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(CreateKinBodyStateSaver_overloads, CreateKinBodyStateSaver, 0,1)
@@ -5744,6 +5863,8 @@ void init_openravepy_kinbody()
                          .def("GetDOFValues",getdofvalues2,PY_ARGS("indices") DOXY_FN(KinBody,GetDOFValues))
                          .def("GetDOFVelocities",getdofvelocities1, DOXY_FN(KinBody,GetDOFVelocities))
                          .def("GetDOFVelocities",getdofvelocities2, PY_ARGS("indices") DOXY_FN(KinBody,GetDOFVelocities))
+                         .def("GetDOFValuesInto",&PyKinBody::GetDOFValuesInto, PY_ARGS("out") "Writes the DOF values into out, a contiguous writeable numpy array of size GetDOF()")
+                         .def("GetDOFVelocitiesInto",&PyKinBody::GetDOFVelocitiesInto, PY_ARGS("out") "Writes the DOF velocities into out, a contiguous writeable numpy array of size GetDOF()")
                          .def("GetDOFLimits",getdoflimits1, DOXY_FN(KinBody,GetDOFLimits))
                          .def("GetDOFLimits",getdoflimits2, PY_ARGS("indices") DOXY_FN(KinBody,GetDOFLimits))
                          .def("GetDOFVelocityLimits",getdofvelocitylimits1, DOXY_FN(KinBody,GetDOFVelocityLimits))
@@ -5820,6 +5941,8 @@ void init_openravepy_kinbody()
                          .def("GetLinkTransformations",&PyKinBody::GetLinkTransformations, GetLinkTransformations_overloads(PY_ARGS("returndoflastvlaues") DOXY_FN(KinBody,GetLinkTransformations)))
 #endif
                          .def("GetBodyTransformations",&PyKinBody::GetLinkTransformations, DOXY_FN(KinBody,GetLinkTransformations))
+                         .def("GetLinkTransformPoses",&PyKinBody::GetLinkTransformPoses, "Returns the link transforms as a (numlinks, 7) array of [quaternion, translation] poses")
+                         .def("GetLinkTransformPosesInto",&PyKinBody::GetLinkTransformPosesInto, PY_ARGS("out") "Writes the link poses into out, a contiguous writeable numpy array of shape (numlinks, 7)")
 #ifdef USE_PYBIND11_PYTHON_BINDINGS
                          .def("SetLinkTransformations",&PyKinBody::SetLinkTransformations,
                               "transforms"_a,
@@ -6019,6 +6142,20 @@ void init_openravepy_kinbody()
 #else
                          .def("ComputeInverseDynamics",&PyKinBody::ComputeInverseDynamics, ComputeInverseDynamics_overloads(PY_ARGS("dofaccelerations","externalforcetorque","returncomponents") sComputeInverseDynamicsDoc.c_str()))
 #endif
+#ifdef USE_PYBIND11_PYTHON_BINDINGS
+                         .def("ComputeInverseDynamicsBatch", &PyKinBody::ComputeInverseDynamicsBatch,
+                              "dofvalues"_a,
+                              "dofvelocities"_a = py::none_(),
+                              "dofaccelerations"_a = py::none_(),
+                              "externalforcetorque"_a = py::none_(),
+                              DOXY_FN(KinBody, ComputeInverseDynamicsBatch)
+                              )
+#else
+                         .def("ComputeInverseDynamicsBatch",&PyKinBody::ComputeInverseDynamicsBatch, ComputeInverseDynamicsBatch_overloads(PY_ARGS("dofvalues","dofvelocities","dofaccelerations","externalforcetorque") DOXY_FN(KinBody, ComputeInverseDynamicsBatch)))
+#endif
+                         .def("ComputeMassMatrix",&PyKinBody::ComputeMassMatrix, DOXY_FN(KinBody,ComputeMassMatrix))
+                         .def("ComputeCoriolisTorques",&PyKinBody::ComputeCoriolisTorques, DOXY_FN(KinBody,ComputeCoriolisTorques))
+                         .def("ComputeGravityTorques",&PyKinBody::ComputeGravityTorques, DOXY_FN(KinBody,ComputeGravityTorques))
                          .def("GetDOFDynamicAccelerationJerkLimits",&PyKinBody::GetDOFDynamicAccelerationJerkLimits, PY_ARGS("dofPositions","dofVelocities") DOXY_FN(KinBody,ComputeDynamicLimits))
                          .def("SetSelfCollisionChecker",&PyKinBody::SetSelfCollisionChecker,PY_ARGS("collisionchecker") DOXY_FN(KinBody,SetSelfCollisionChecker))
                          .def("GetSelfCollisionChecker", &PyKinBody::GetSelfCollisionChecker, /*PY_ARGS("collisionchecker")*/ DOXY_FN(KinBody,GetSelfCollisionChecker))
@@ -6074,6 +6211,15 @@ void init_openravepy_kinbody()
                          .def("GetXMLFilename",&PyKinBody::GetURI, DOXY_FN(InterfaceBase,GetURI))
                          .def("GetNonAdjacentLinks",GetNonAdjacentLinks1, DOXY_FN(KinBody,GetNonAdjacentLinks))
                          .def("GetNonAdjacentLinks",GetNonAdjacentLinks2, PY_ARGS("adjacentoptions") DOXY_FN(KinBody,GetNonAdjacentLinks))
+#ifdef USE_PYBIND11_PYTHON_BINDINGS
+                         .def("ComputeSelfCollisionLinkPairCulling", &PyKinBody::ComputeSelfCollisionLinkPairCulling,
+                              "maxevaluations"_a = 256,
+                              DOXY_FN(KinBody, ComputeSelfCollisionLinkPairCulling)
+                              )
+#else
+                         .def("ComputeSelfCollisionLinkPairCulling",&PyKinBody::ComputeSelfCollisionLinkPairCulling, ComputeSelfCollisionLinkPairCulling_overloads(PY_ARGS("maxevaluations") DOXY_FN(KinBody, ComputeSelfCollisionLinkPairCulling)))
+#endif
+                         .def("IsLinkPairCollisionFree",&PyKinBody::IsLinkPairCollisionFree, PY_ARGS("linkindex0", "linkindex1") DOXY_FN(KinBody,IsLinkPairCollisionFree))
                          .def("SetAdjacentLinks",&PyKinBody::SetAdjacentLinks, PY_ARGS("linkindex0", "linkindex1") DOXY_FN(KinBody,SetAdjacentLinks))
                          .def("SetAdjacentLinksCombinations",&PyKinBody::SetAdjacentLinksCombinations, PY_ARGS("linkIndices") DOXY_FN(KinBody,SetAdjacentLinksCombinations))
                          .def("GetAdjacentLinks",&PyKinBody::GetAdjacentLinks, DOXY_FN(KinBody,GetAdjacentLinks))
@@ -6122,6 +6268,7 @@ void init_openravepy_kinbody()
         .value("ActiveManipulatorToolTransform",KinBody::Save_ActiveManipulatorToolTransform)
         .value("ManipulatorsToolTransform", KinBody::Save_ManipulatorsToolTransform)
         .value("ConnectedBodies", KinBody::Save_ConnectedBodies)
+        .value("Lightweight", KinBody::Save_Lightweight)
         ;
 #ifdef USE_PYBIND11_PYTHON_BINDINGS
         // CheckLimitsAction belongs to KinBody, not openravepy._openravepy_.openravepy_int
@@ -99,6 +99,39 @@ void pyVerifyTrajectory(object pyparameters, PyTrajectoryBasePtr pytraj, dReal s
     OpenRAVE::planningutils::VerifyTrajectory(openravepy::GetPlannerParametersConst(pyparameters), openravepy::GetTrajectory(pytraj),samplingstep);
 }
 
+void pyVerifyTrajectoryParallel(object pyparameters, PyTrajectoryBasePtr pytraj, dReal samplingstep, int numthreads=0, bool releasegil=true)
+{
+    openravepy::PythonThreadSaverPtr statesaver;
+    if( releasegil ) {
+        statesaver.reset(new openravepy::PythonThreadSaver());
+    }
+    OpenRAVE::planningutils::VerifyTrajectoryParallel(openravepy::GetPlannerParametersConst(pyparameters), openravepy::GetTrajectory(pytraj),samplingstep,numthreads);
+}
+
+class PyParallelTrajectoryVerifier
+{
+public:
+    PyParallelTrajectoryVerifier(int numthreads=0) : _verifier(numthreads) {
+    }
+    virtual ~PyParallelTrajectoryVerifier() {
+    }
+
+    void VerifyTrajectory(object pyparameters, PyTrajectoryBasePtr pytraj, dReal samplingstep=0.002, bool releasegil=true)
+    {
+        PlannerBase::PlannerParametersConstPtr parameters = openravepy::GetPlannerParametersConst(pyparameters);
+        TrajectoryBaseConstPtr ptraj = openravepy::GetTrajectory(pytraj);
+        openravepy::PythonThreadSaverPtr statesaver;
+        if( releasegil ) {
+            statesaver.reset(new openravepy::PythonThreadSaver());
+        }
+        _verifier.VerifyTrajectory(parameters, ptraj, samplingstep);
+    }
+
+    OpenRAVE::planningutils::ParallelTrajectoryVerifier _verifier;
+};
+
+typedef OPENRAVE_SHARED_PTR<PyParallelTrajectoryVerifier> PyParallelTrajectoryVerifierPtr;
+
 // GIL is assumed locked
 object pySmoothActiveDOFTrajectory(PyTrajectoryBasePtr pytraj, PyRobotBasePtr pyrobot, dReal fmaxvelmult=1.0, dReal fmaxaccelmult=1.0, const std::string& plannername="", const std::string& plannerparameters="")
 {
@@ -526,6 +559,7 @@ BOOST_PYTHON_FUNCTION_OVERLOADS(ExtendActiveDOFWaypoint_overloads, planningutils
 BOOST_PYTHON_FUNCTION_OVERLOADS(InsertActiveDOFWaypointWithRetiming_overloads, planningutils::pyInsertActiveDOFWaypointWithRetiming, 5, 9)
 BOOST_PYTHON_FUNCTION_OVERLOADS(InsertWaypointWithSmoothing_overloads, planningutils::pyInsertWaypointWithSmoothing, 4, 7)
 BOOST_PYTHON_FUNCTION_OVERLOADS(VerifyTrajectory_overloads, planningutils::pyVerifyTrajectory, 3, 4)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(VerifyTrajectory_overloads2, VerifyTrajectory, 2, 4)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(Check_overloads, Check, 5, 8)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(CheckWithAccelerations_overloads, CheckWithAccelerations, 7, 10)
@@ -601,6 +635,17 @@ void InitPlanningUtils()
                                .def("VerifyTrajectory",planningutils::pyVerifyTrajectory, PY_ARGS("parameters","trajectory","samplingstep", "releasegil") DOXY_FN1(VerifyTrajectory))
                                .staticmethod("VerifyTrajectory")
 #endif
+#ifdef USE_PYBIND11_PYTHON_BINDINGS
+                               .def_static("VerifyTrajectoryParallel",planningutils::pyVerifyTrajectoryParallel,
+                                           "parameters"_a,
+                                           "trajectory"_a,
+                                           "samplingstep"_a,
+                                           "numthreads"_a=0,
+                                           "releasegil"_a=true, DOXY_FN1(VerifyTrajectoryParallel))
+#else
+                               .def("VerifyTrajectoryParallel",planningutils::pyVerifyTrajectoryParallel, PY_ARGS("parameters","trajectory","samplingstep","numthreads","releasegil") DOXY_FN1(VerifyTrajectoryParallel))
+                               .staticmethod("VerifyTrajectoryParallel")
+#endif
 #ifdef USE_PYBIND11_PYTHON_BINDINGS
                                .def_static("SmoothActiveDOFTrajectory", planningutils::pySmoothActiveDOFTrajectory,
                                            "trajectory"_a,
@@ -861,6 +906,27 @@ void InitPlanningUtils()
         .def("GetIkParameterizationIndex", &planningutils::PyManipulatorIKGoalSampler::GetIkParameterizationIndex, PY_ARGS("index") DOXY_FN(planningutils::ManipulatorIKGoalSampler, GetIkParameterizationIndex))
         ;
 
+#ifdef USE_PYBIND11_PYTHON_BINDINGS
+        class_<planningutils::PyParallelTrajectoryVerifier, planningutils::PyParallelTrajectoryVerifierPtr >(planningutils, "ParallelTrajectoryVerifier", DOXY_CLASS(planningutils::ParallelTrajectoryVerifier))
+        .def(init<int>(), "numthreads"_a = 0)
+#else
+        class_<planningutils::PyParallelTrajectoryVerifier, planningutils::PyParallelTrajectoryVerifierPtr >("ParallelTrajectoryVerifier", DOXY_CLASS(planningutils::ParallelTrajectoryVerifier), no_init)
+        .def(init<>())
+        .def(init<int>(py::args("numthreads")))
+#endif
+#ifdef USE_PYBIND11_PYTHON_BINDINGS
+        .def("VerifyTrajectory", &planningutils::PyParallelTrajectoryVerifier::VerifyTrajectory,
+             "parameters"_a,
+             "trajectory"_a,
+             "samplingstep"_a = 0.002,
+             "releasegil"_a = true,
+             DOXY_FN(planningutils::ParallelTrajectoryVerifier, VerifyTrajectory)
+             )
+#else
+        .def("VerifyTrajectory",&planningutils::PyParallelTrajectoryVerifier::VerifyTrajectory,VerifyTrajectory_overloads2(PY_ARGS("parameters","trajectory","samplingstep","releasegil") DOXY_FN(planningutils::ParallelTrajectoryVerifier,VerifyTrajectory)))
+#endif
+        ;
+
 #ifdef USE_PYBIND11_PYTHON_BINDINGS
         class_<planningutils::PyActiveDOFTrajectorySmoother, planningutils::PyActiveDOFTrajectorySmootherPtr >(planningutils, "ActiveDOFTrajectorySmoother", DOXY_CLASS(planningutils::ActiveDOFTrajectorySmoother))
         .def(init<PyRobotBasePtr, const std::string&, const std::string&>(), "robot"_a, "plannername"_a, "plannerparameters"_a)
@@ -1204,6 +1204,7 @@ bool PyRobotBase::PyManipulator::CheckEndEffectorCollision(PyCollisionReportPtr
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     bool bcollision = _pmanip->CheckEndEffectorCollision(preport);
@@ -1219,6 +1220,7 @@ bool PyRobotBase::PyManipulator::CheckEndEffectorCollision(object otrans, PyColl
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     bool bCollision;
@@ -1241,6 +1243,7 @@ bool PyRobotBase::PyManipulator::CheckEndEffectorSelfCollision(PyCollisionReport
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     bool bcollision = _pmanip->CheckEndEffectorSelfCollision(preport);
@@ -1256,6 +1259,7 @@ bool PyRobotBase::PyManipulator::CheckEndEffectorSelfCollision(object otrans, Py
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     bool bCollision;
@@ -1282,6 +1286,7 @@ bool PyRobotBase::PyManipulator::CheckIndependentCollision(PyCollisionReportPtr
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     bool bCollision = _pmanip->CheckIndependentCollision(preport);
@@ -2213,6 +2218,7 @@ bool PyRobotBase::CheckLinkSelfCollision(int ilinkindex, object olinktrans, PyCo
     CollisionReportPtr preport;
     if( !!pyreport ) {
         preport = CollisionReportPtr(&report,utils::null_deleter());
+        report.bIndexOnly = pyreport->bIndexOnly;
     }
 
     bool bCollision = _probot->CheckLinkSelfCollision(ilinkindex, ExtractTransform(olinktrans), preport);
@@ -377,6 +377,19 @@ PySensorBase::PyCameraSensorData::PyCameraSensorData(OPENRAVE_SHARED_PTR<SensorB
         imagedata = py::to_array_astype<uint8_t>(pyvalues);
 #endif // USE_PYBIND11_PYTHON_BINDINGS
     }
+
+    const size_t numpixels = pgeom->height * pgeom->width;
+    std::vector<npy_intp> dims(2); dims[0] = pgeom->height; dims[1] = pgeom->width;
+    if( pdata->vdepthdata.size() == numpixels && numpixels > 0 ) {
+        depthdata = toPyArray(pdata->vdepthdata, dims);
+    }
+    if( pdata->vbodyindices.size() == numpixels && numpixels > 0 ) {
+        bodyindices = toPyArray(pdata->vbodyindices, dims);
+    }
+    if( pdata->vpointclouddata.size() == 3*numpixels && numpixels > 0 ) {
+        dims.push_back(3);
+        pointclouddata = toPyArray(pdata->vpointclouddata, dims);
+    }
 }
 PySensorBase::PyCameraSensorData::PyCameraSensorData(OPENRAVE_SHARED_PTR<SensorBase::CameraGeomData const> pgeom) : PySensorData(SensorBase::ST_Camera), intrinsics(pgeom->intrinsics)
 {
@@ -807,6 +820,9 @@ void init_openravepy_sensor()
 #endif
         .def_readonly("transform",&PySensorBase::PyCameraSensorData::transform)
         .def_readonly("imagedata",&PySensorBase::PyCameraSensorData::imagedata)
+        .def_readonly("depthdata",&PySensorBase::PyCameraSensorData::depthdata)
+        .def_readonly("pointclouddata",&PySensorBase::PyCameraSensorData::pointclouddata)
+        .def_readonly("bodyindices",&PySensorBase::PyCameraSensorData::bodyindices)
         .def_readonly("KK",&PySensorBase::PyCameraSensorData::KK)
         .def_readonly("intrinsics",&PySensorBase::PyCameraSensorData::intrinsics)
         ;
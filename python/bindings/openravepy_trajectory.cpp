@@ -252,28 +252,40 @@ object PyTrajectoryBase::SampleFromPrevious(object odata, dReal time, OPENRAVE_S
     return this->SampleFromPrevious(odata, time, pyspec);
 }
 
+/// \brief converts sampled or waypoint data into a 2D numpy array with one row per point. The memory of values is handed over to the array, so no copy is made.
+static object _ConvertToObject(std::vector<dReal>&& values, int numdof)
+{
+    std::vector<npy_intp> dims = { npy_intp(values.size()/numdof), npy_intp(numdof) };
+    return toPyArrayAdopt(std::move(values), dims);
+}
+
+/// \brief samples the trajectory once while the GIL is held.
+///
+/// The sampling functions below release the GIL so that other python threads can run while a long trajectory is sampled.
+/// Sampling is const, but the first sample after a modification lazily computes the timing caches of the trajectory
+/// (accumulated times, inverse delta times), so that has to happen here before the GIL is released. Afterwards concurrent
+/// samples of the same trajectory only read it. Modifying a trajectory from one thread while another thread samples it is not supported.
+static void _ComputeSamplingCache(const TrajectoryBase& traj, std::vector<dReal>& vworkspace)
+{
+    if( traj.GetNumWaypoints() > 0 ) {
+        traj.Sample(vworkspace, 0);
+    }
+}
+
 object PyTrajectoryBase::SamplePoints2D(object otimes) const
 {
     std::vector<dReal>& vtimes = _vtimesCache;
     if (!ExtractContiguousArrayToVector(otimes, vtimes)) {
         vtimes = ExtractArray<dReal>(otimes);
     }
-    std::vector<dReal>& values = _vdataCache;
-    _ptrajectory->SamplePoints(values,vtimes);
-
-    const int numdof = _ptrajectory->GetConfigurationSpecification().GetDOF();
-#ifdef USE_PYBIND11_PYTHON_BINDINGS
-    py::array_t<dReal> pypos = toPyArray(values);
-    pypos.resize({(int) values.size()/numdof, numdof});
-    return pypos;
-#else // USE_PYBIND11_PYTHON_BINDINGS
-    npy_intp dims[] = { npy_intp(values.size()/numdof), npy_intp(numdof) };
-    PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
-    if( !values.empty() ) {
-        memcpy(PyArray_DATA(pypos), values.data(), values.size()*sizeof(values[0]));
+    std::vector<dReal> values;
+    _ComputeSamplingCache(*_ptrajectory, values);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->SamplePoints(values,vtimes);
     }
-    return py::to_array_astype<dReal>(pypos);
-#endif // USE_PYBIND11_PYTHON_BINDINGS
+    const int numdof = _ptrajectory->GetConfigurationSpecification().GetDOF();
+    return _ConvertToObject(std::move(values), numdof);
 }
 
 object PyTrajectoryBase::SamplePoints2D(object otimes, PyConfigurationSpecificationPtr pyspec) const
@@ -283,48 +295,92 @@ object PyTrajectoryBase::SamplePoints2D(object otimes, PyConfigurationSpecificat
     if (!ExtractContiguousArrayToVector(otimes, vtimes)) {
         vtimes = ExtractArray<dReal>(otimes);
     }
+    std::vector<dReal> values;
+    _ComputeSamplingCache(*_ptrajectory, values);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->SamplePoints(values, vtimes, spec);
+    }
+    return _ConvertToObject(std::move(values), spec.GetDOF());
+}
+
+void PyTrajectoryBase::SampleInto(object oout, dReal time) const
+{
+    dReal* pout = nullptr;
+    const size_t nout = ExtractWriteableContiguousArray(oout, &pout);
     std::vector<dReal>& values = _vdataCache;
-    _ptrajectory->SamplePoints(values, vtimes, spec);
+    _ComputeSamplingCache(*_ptrajectory, values);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->Sample(values,time);
+    }
+    OPENRAVE_ASSERT_OP(nout, ==, values.size());
+    std::copy(values.begin(), values.end(), pout);
+}
 
-    const int numdof = spec.GetDOF();
-#ifdef USE_PYBIND11_PYTHON_BINDINGS
-    py::array_t<dReal> pypos = toPyArray(values);
-    pypos.resize({(int) values.size()/numdof, numdof});
-    return pypos;
-#else // USE_PYBIND11_PYTHON_BINDINGS
-    npy_intp dims[] = { npy_intp(values.size()/numdof), npy_intp(numdof) };
-    PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
-    if( !values.empty() ) {
-        memcpy(PyArray_DATA(pypos), values.data(), values.size()*sizeof(values[0]));
+void PyTrajectoryBase::SampleInto(object oout, dReal time, PyConfigurationSpecificationPtr pyspec) const
+{
+    const ConfigurationSpecification spec = openravepy::GetConfigurationSpecification(pyspec);
+    dReal* pout = nullptr;
+    const size_t nout = ExtractWriteableContiguousArray(oout, &pout);
+    std::vector<dReal>& values = _vdataCache;
+    _ComputeSamplingCache(*_ptrajectory, values);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->Sample(values,time,spec,true);
     }
-    return py::to_array_astype<dReal>(pypos);
-#endif // USE_PYBIND11_PYTHON_BINDINGS
+    OPENRAVE_ASSERT_OP(nout, ==, values.size());
+    std::copy(values.begin(), values.end(), pout);
 }
 
+void PyTrajectoryBase::SamplePoints2DInto(object oout, object otimes) const
+{
+    dReal* pout = nullptr;
+    const size_t nout = ExtractWriteableContiguousArray(oout, &pout);
+    std::vector<dReal>& vtimes = _vtimesCache;
+    if (!ExtractContiguousArrayToVector(otimes, vtimes)) {
+        vtimes = ExtractArray<dReal>(otimes);
+    }
+    std::vector<dReal>& values = _vdataCache;
+    _ComputeSamplingCache(*_ptrajectory, values);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->SamplePoints(values,vtimes);
+    }
+    OPENRAVE_ASSERT_OP(nout, ==, values.size());
+    std::copy(values.begin(), values.end(), pout);
+}
 
-object _ConvertToObject(const std::vector<dReal>& values, int numdof)
+void PyTrajectoryBase::SamplePoints2DInto(object oout, object otimes, PyConfigurationSpecificationPtr pyspec) const
 {
-#ifdef USE_PYBIND11_PYTHON_BINDINGS
-    py::array_t<dReal> pypos = toPyArray(values);
-    pypos.resize({(int) values.size()/numdof, numdof});
-    return pypos;
-#else // USE_PYBIND11_PYTHON_BINDINGS
-    npy_intp dims[] = { npy_intp(values.size()/numdof), npy_intp(numdof) };
-    PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
-    if( !values.empty() ) {
-        memcpy(PyArray_DATA(pypos), values.data(), values.size()*sizeof(values[0]));
+    const ConfigurationSpecification spec = openravepy::GetConfigurationSpecification(pyspec);
+    dReal* pout = nullptr;
+    const size_t nout = ExtractWriteableContiguousArray(oout, &pout);
+    std::vector<dReal>& vtimes = _vtimesCache;
+    if (!ExtractContiguousArrayToVector(otimes, vtimes)) {
+        vtimes = ExtractArray<dReal>(otimes);
     }
-    return py::to_array_astype<dReal>(pypos);
-#endif // USE_PYBIND11_PYTHON_BINDINGS
+    std::vector<dReal>& values = _vdataCache;
+    _ComputeSamplingCache(*_ptrajectory, values);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->SamplePoints(values,vtimes,spec);
+    }
+    OPENRAVE_ASSERT_OP(nout, ==, values.size());
+    std::copy(values.begin(), values.end(), pout);
 }
 
 object PyTrajectoryBase::SamplePointsSameDeltaTime2D(dReal deltatime,
                                                      bool ensureLastPoint) const
 {
-    std::vector<dReal>& values = _vdataCache;
-    _ptrajectory->SamplePointsSameDeltaTime(values, deltatime, ensureLastPoint);
+    std::vector<dReal> values;
+    _ComputeSamplingCache(*_ptrajectory, values);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->SamplePointsSameDeltaTime(values, deltatime, ensureLastPoint);
+    }
     const int numdof = _ptrajectory->GetConfigurationSpecification().GetDOF();
-    return _ConvertToObject(values, numdof);
+    return _ConvertToObject(std::move(values), numdof);
 }
 
 
@@ -332,12 +388,15 @@ object PyTrajectoryBase::SamplePointsSameDeltaTime2D(dReal deltatime,
                                                      bool ensureLastPoint,
                                                      PyConfigurationSpecificationPtr pyspec) const
 {
-    std::vector<dReal>& values = _vdataCache;
+    std::vector<dReal> values;
     ConfigurationSpecification spec = openravepy::GetConfigurationSpecification(pyspec);
-    _ptrajectory->SamplePointsSameDeltaTime(values, deltatime, ensureLastPoint, spec);
-
+    _ComputeSamplingCache(*_ptrajectory, values);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->SamplePointsSameDeltaTime(values, deltatime, ensureLastPoint, spec);
+    }
     const int numdof = spec.GetDOF();
-    return _ConvertToObject(values, numdof);
+    return _ConvertToObject(std::move(values), numdof);
 }
 
 object PyTrajectoryBase::SamplePointsSameDeltaTime2D(dReal deltatime,
@@ -353,10 +412,14 @@ object PyTrajectoryBase::SampleRangeSameDeltaTime2D(dReal deltatime,
                                                     dReal stopTime,
                                                     bool ensureLastPoint) const
 {
-    std::vector<dReal>& values = _vdataCache;
-    _ptrajectory->SampleRangeSameDeltaTime(values, deltatime, startTime, stopTime, ensureLastPoint);
+    std::vector<dReal> values;
+    _ComputeSamplingCache(*_ptrajectory, values);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->SampleRangeSameDeltaTime(values, deltatime, startTime, stopTime, ensureLastPoint);
+    }
     const int numdof = _ptrajectory->GetConfigurationSpecification().GetDOF();
-    return _ConvertToObject(values, numdof);
+    return _ConvertToObject(std::move(values), numdof);
 }
 
 
@@ -366,12 +429,15 @@ object PyTrajectoryBase::SampleRangeSameDeltaTime2D(dReal deltatime,
                                                     bool ensureLastPoint,
                                                     PyConfigurationSpecificationPtr pyspec) const
 {
-    std::vector<dReal>& values = _vdataCache;
+    std::vector<dReal> values;
     ConfigurationSpecification spec = openravepy::GetConfigurationSpecification(pyspec);
-    _ptrajectory->SampleRangeSameDeltaTime(values, deltatime, startTime, stopTime, ensureLastPoint, spec);
-
+    _ComputeSamplingCache(*_ptrajectory, values);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->SampleRangeSameDeltaTime(values, deltatime, startTime, stopTime, ensureLastPoint, spec);
+    }
     const int numdof = spec.GetDOF();
-    return _ConvertToObject(values, numdof);
+    return _ConvertToObject(std::move(values), numdof);
 }
 
 object PyTrajectoryBase::SampleRangeSameDeltaTime2D(dReal deltatime,
@@ -421,22 +487,10 @@ object PyTrajectoryBase::GetWaypoints(size_t startindex, size_t endindex, OPENRA
 // similar to GetWaypoints except returns a 2D array, one row for every waypoint
 object PyTrajectoryBase::GetWaypoints2D(size_t startindex, size_t endindex) const
 {
-    std::vector<dReal>& values = _vdataCache;
+    std::vector<dReal> values;
     _ptrajectory->GetWaypoints(startindex,endindex,values);
     const int numdof = _ptrajectory->GetConfigurationSpecification().GetDOF();
-
-#ifdef USE_PYBIND11_PYTHON_BINDINGS
-    py::array_t<dReal> pypos = toPyArray(values);
-    pypos.resize({(int) values.size()/numdof, numdof});
-    return pypos;
-#else // USE_PYBIND11_PYTHON_BINDINGS
-    npy_intp dims[] = { npy_intp(values.size()/numdof), npy_intp(numdof) };
-    PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
-    if( !values.empty() ) {
-        memcpy(PyArray_DATA(pypos), values.data(), values.size()*sizeof(values[0]));
-    }
-    return py::to_array_astype<dReal>(pypos);
-#endif // USE_PYBIND11_PYTHON_BINDINGS
+    return _ConvertToObject(std::move(values), numdof);
 }
 
 object PyTrajectoryBase::__getitem__(int index) const
@@ -512,23 +566,13 @@ object PyTrajectoryBase::GetAllWaypoints2D() const
 
 object PyTrajectoryBase::GetWaypoints2D(size_t startindex, size_t endindex, PyConfigurationSpecificationPtr pyspec) const
 {
-    std::vector<dReal>& values = _vdataCache;
+    std::vector<dReal> values;
     ConfigurationSpecification spec = openravepy::GetConfigurationSpecification(pyspec);
-    _ptrajectory->GetWaypoints(startindex,endindex,values,spec);
-    const int numdof = spec.GetDOF();
-    const int nvalues = values.size();
-#ifdef USE_PYBIND11_PYTHON_BINDINGS
-    py::array_t<dReal> pypos = toPyArray(values);
-    pypos.resize({nvalues/numdof, numdof});
-    return pypos;
-#else // USE_PYBIND11_PYTHON_BINDINGS
-    npy_intp dims[] = { npy_intp(nvalues/numdof), npy_intp(numdof) };
-    PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
-    if( !values.empty() ) {
-        memcpy(PyArray_DATA(pypos), values.data(), nvalues*sizeof(values[0]));
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        _ptrajectory->GetWaypoints(startindex,endindex,values,spec);
     }
-    return py::to_array_astype<dReal>(pypos);
-#endif // USE_PYBIND11_PYTHON_BINDINGS
+    return _ConvertToObject(std::move(values), spec.GetDOF());
 }
 
 object PyTrajectoryBase::GetWaypoints2D(size_t startindex, size_t endindex, OPENRAVE_SHARED_PTR<ConfigurationSpecification::Group> pygroup) const
@@ -677,6 +721,10 @@ void init_openravepy_trajectory()
     object (PyTrajectoryBase::*Sample1)(dReal) const = &PyTrajectoryBase::Sample;
     object (PyTrajectoryBase::*Sample2)(dReal, PyConfigurationSpecificationPtr) const = &PyTrajectoryBase::Sample;
     object (PyTrajectoryBase::*Sample3)(dReal, OPENRAVE_SHARED_PTR<ConfigurationSpecification::Group>) const = &PyTrajectoryBase::Sample;
+    void (PyTrajectoryBase::*SampleInto1)(object, dReal) const = &PyTrajectoryBase::SampleInto;
+    void (PyTrajectoryBase::*SampleInto2)(object, dReal, PyConfigurationSpecificationPtr) const = &PyTrajectoryBase::SampleInto;
+    void (PyTrajectoryBase::*SamplePoints2DInto1)(object, object) const = &PyTrajectoryBase::SamplePoints2DInto;
+    void (PyTrajectoryBase::*SamplePoints2DInto2)(object, object, PyConfigurationSpecificationPtr) const = &PyTrajectoryBase::SamplePoints2DInto;
     object (PyTrajectoryBase::*SampleFromPrevious1)(object, dReal, PyConfigurationSpecificationPtr) const = &PyTrajectoryBase::SampleFromPrevious;
     object (PyTrajectoryBase::*SampleFromPrevious2)(object, dReal, OPENRAVE_SHARED_PTR<ConfigurationSpecification::Group>) const = &PyTrajectoryBase::SampleFromPrevious;
     object (PyTrajectoryBase::*SamplePoints2D1)(object) const = &PyTrajectoryBase::SamplePoints2D;
@@ -720,11 +768,15 @@ void init_openravepy_trajectory()
     .def("Sample",Sample1, PY_ARGS("time") DOXY_FN(TrajectoryBase,Sample "std::vector; dReal"))
     .def("Sample",Sample2, PY_ARGS("time","spec") DOXY_FN(TrajectoryBase,Sample "std::vector; dReal; const ConfigurationSpecification"))
     .def("Sample",Sample3, PY_ARGS("time","group") DOXY_FN(TrajectoryBase,Sample "std::vector; dReal; const ConfigurationSpecification::Group"))
+    .def("SampleInto",SampleInto1, PY_ARGS("out","time") "Samples the trajectory at time and writes the result into out, a contiguous writeable numpy array of the trajectory DOF")
+    .def("SampleInto",SampleInto2, PY_ARGS("out","time","spec") "Samples the trajectory at time with spec and writes the result into out, a contiguous writeable numpy array of spec DOF")
     .def("SampleFromPrevious", SampleFromPrevious1, PY_ARGS("data","time","spec") DOXY_FN(TrajectoryBase,Sample "std::vector; dReal; const ConfigurationSpecification"))
     .def("SampleFromPrevious", SampleFromPrevious2, PY_ARGS("data","time","group") DOXY_FN(TrajectoryBase,Sample "std::vector; dReal; const ConfigurationSpecification::Group"))
     .def("SamplePoints2D",SamplePoints2D1, PY_ARGS("times") DOXY_FN(TrajectoryBase,SamplePoints2D "std::vector; std::vector"))
     .def("SamplePoints2D",SamplePoints2D2, PY_ARGS("times","spec") DOXY_FN(TrajectoryBase,SamplePoints2D "std::vector; std::vector; const ConfigurationSpecification"))
     .def("SamplePoints2D",SamplePoints2D3, PY_ARGS("times","group") DOXY_FN(TrajectoryBase,SamplePoints2D "std::vector; std::vector; const ConfigurationSpecification::Group"))
+    .def("SamplePoints2DInto",SamplePoints2DInto1, PY_ARGS("out","times") "Samples the trajectory at times and writes the result into out, a contiguous writeable numpy array of shape (len(times), dof)")
+    .def("SamplePoints2DInto",SamplePoints2DInto2, PY_ARGS("out","times","spec") "Samples the trajectory at times with spec and writes the result into out, a contiguous writeable numpy array of shape (len(times), spec dof)")
     .def("SamplePointsSameDeltaTime2D",SamplePointsSameDeltaTime2D1, PY_ARGS("deltatime","ensurelastpoint") DOXY_FN(TrajectoryBase,SamplePointsSameDeltaTime2D "dReal; bool"))
     .def("SamplePointsSameDeltaTime2D",SamplePointsSameDeltaTime2D2, PY_ARGS("deltatime","ensurelastpoint","spec") DOXY_FN(TrajectoryBase,SamplePointsSameDeltaTime2D "dReal; bool; const ConfigurationSpecification"))
 #ifdef USE_PYBIND11_PYTHON_BINDINGS
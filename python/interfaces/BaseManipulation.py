@@ -81,7 +81,7 @@ class BaseManipulation:
         print(cmd)
         return self.prob.SendCommand(cmd)
 
-    def MoveHandStraight(self,direction,minsteps=None,maxsteps=None,stepsize=None,ignorefirstcollision=None,starteematrix=None,greedysearch=None,execute=None,outputtraj=None,maxdeviationangle=None,steplength=None,planner=None,outputtrajobj=None):
+    def MoveHandStraight(self,direction,minsteps=None,maxsteps=None,stepsize=None,ignorefirstcollision=None,starteematrix=None,greedysearch=None,execute=None,outputtraj=None,maxdeviationangle=None,steplength=None,planner=None,outputtrajobj=None,differentialik=None):
         """See :ref:`module-basemanipulation-movehandstraight`
         """
         cmd = 'MoveHandStraight direction %.15e %.15e %.15e '%(direction[0],direction[1],direction[2])
@@ -107,6 +107,8 @@ class BaseManipulation:
             cmd += 'ignorefirstcollision %.15e '%ignorefirstcollision
         if maxdeviationangle is not None:
             cmd += 'maxdeviationangle %.15e '%maxdeviationangle
+        if differentialik is not None:
+            cmd += 'differentialik %d '%differentialik
         res = self.prob.SendCommand(cmd)
         if res is None:
             raise PlanningError('MoveHandStraight')
@@ -58,8 +58,10 @@ class Grasper:
         clone.avoidlinks = [clone.robot.GetLink(link.GetName()) for link in self.avoidlinks]
         envother.Add(clone.prob,True,clone.args)
         return clone
-    def Grasp(self, direction=None, roll=None, position=None, standoff=None, target=None, stablecontacts=False, forceclosure=False, transformrobot=True, onlycontacttarget=True, tightgrasp=False, graspingnoise=None, execute=None, translationstepmult=None, outputfinal=False, manipulatordirection=None, coarsestep=None, finestep=None, vintersectplane=None, chuckingdirection=None, ordereddofindices=None, avoidcontact=False):
+    def Grasp(self, direction=None, roll=None, position=None, standoff=None, target=None, stablecontacts=False, forceclosure=False, transformrobot=True, onlycontacttarget=True, tightgrasp=False, graspingnoise=None, execute=None, translationstepmult=None, outputfinal=False, manipulatordirection=None, coarsestep=None, finestep=None, vintersectplane=None, chuckingdirection=None, ordereddofindices=None, avoidcontact=False, forceclosuremethod=None):
         """See :ref:`module-grasper-grasp`
+
+        :param forceclosuremethod: 'qhull' (default) or 'wrenchspace'. wrenchspace computes the same mindist without the full convex hull, but the returned volume is only a lower bound of the hull volume.
         """
         cmd = 'Grasp '
         if direction is not None:
@@ -97,6 +99,8 @@ class Grasper:
                 cmd += '%d '%value
         if avoidcontact:
             cmd += 'avoidcontact '
+        if forceclosuremethod is not None:
+            cmd += 'forceclosuremethod %s '%forceclosuremethod
         res = self.prob.SendCommand(cmd)
         if res is None:
             raise PlanningError('Grasp failed')
@@ -119,8 +123,10 @@ class Grasper:
         contacts = reshape(array([float64(s) for s in resvalues],float64),(len(resvalues)//6,6))
         return contacts,finalconfig,mindist,volume
 
-    def GraspThreaded(self,approachrays,standoffs,preshapes,rolls,manipulatordirections=None,target=None,transformrobot=True,onlycontacttarget=True,tightgrasp=False,graspingnoise=None,forceclosurethreshold=None,collisionchecker=None,translationstepmult=None,numthreads=None,startindex=None,maxgrasps=None,finestep=None):
+    def GraspThreaded(self,approachrays,standoffs,preshapes,rolls,manipulatordirections=None,target=None,transformrobot=True,onlycontacttarget=True,tightgrasp=False,graspingnoise=None,forceclosurethreshold=None,collisionchecker=None,translationstepmult=None,numthreads=None,startindex=None,maxgrasps=None,finestep=None,forceclosuremethod=None):
         """See :ref:`module-grasper-graspthreaded`
+
+        :param forceclosuremethod: see :meth:`Grasp`
         """
         cmd = 'GraspThreaded '
         if target is not None:
@@ -142,6 +148,8 @@ class Grasper:
             cmd += 'finestep %.15e '%finestep
         if numthreads is not None:
             cmd += 'numthreads %d '%numthreads
+        if forceclosuremethod is not None:
+            cmd += 'forceclosuremethod %s '%forceclosuremethod
         cmd += 'approachrays %d '%len(approachrays)
         for f in approachrays.flat:
             cmd += str(f) + ' '
@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# Copyright (C) 2026 OpenRAVE Contributors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Compares two result files of openrave_benchmark.
+
+The minimum time per call of each benchmark is compared since it is the least sensitive to the load of the machine. Exits with 1 if any benchmark is slower than the threshold, so it can be used in continuous integration::
+
+  comparebenchmarks.py baseline.json current.json --threshold=0.1
+"""
+from __future__ import print_function
+import sys, json
+from optparse import OptionParser
+
+def LoadResults(filename):
+    with open(filename, 'r') as f:
+        results = json.load(f)
+    return dict((benchmark['name'], benchmark) for benchmark in results['benchmarks'])
+
+def CompareResults(baseline, current, threshold):
+    """returns the names of the benchmarks that are more than threshold slower in current"""
+    regressions = []
+    print('%-50s %14s %14s %8s'%('benchmark', 'baseline ns', 'current ns', 'change'))
+    for name in sorted(set(baseline.keys()) | set(current.keys())):
+        base = baseline.get(name)
+        cur = current.get(name)
+        if base is None or cur is None or 'minNs' not in base or 'minNs' not in cur:
+            reason = 'missing' if base is None or cur is None else (base.get('skipped') or cur.get('skipped'))
+            print('%-50s %s'%(name, reason))
+            continue
+        change = cur['minNs']/base['minNs'] - 1 if base['minNs'] > 0 else 0
+        flag = ''
+        if change > threshold:
+            regressions.append(name)
+            flag = ' REGRESSION'
+        print('%-50s %14.1f %14.1f %+7.1f%%%s'%(name, base['minNs'], cur['minNs'], 100*change, flag))
+    return regressions
+
+if __name__ == "__main__":
+    parser = OptionParser(usage='usage: %prog [options] baseline.json current.json', description='Compares two result files of openrave_benchmark.')
+    parser.add_option('--threshold', action='store', type='float', dest='threshold', default=0.1,
+                      help='Relative slowdown above which a benchmark is reported as a regression (default=%default)')
+    (options, args) = parser.parse_args()
+    if len(args) != 2:
+        parser.error('need the baseline and current result files')
+    regressions = CompareResults(LoadResults(args[0]), LoadResults(args[1]), options.threshold)
+    if len(regressions) > 0:
+        print('%d regressions: %s'%(len(regressions), ', '.join(regressions)))
+        sys.exit(1)
@@ -0,0 +1,565 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/** \file openravebenchmark.cpp
+    \brief Micro-benchmarks of the core hot paths.
+
+    Every benchmark prepares its environment and inputs, then times batches of calls of a single operation. The inputs are generated from a fixed seed so
+    that runs of different builds measure the same work. Results are written as JSON and can be compared with comparebenchmarks.py.
+
+    The scenes are loaded from the OpenRAVE data directories, so the benchmarks have to be run against an installed or OPENRAVE_DATA configured tree.
+ */
+#include "libopenrave-core/openrave-core.h"
+#include <openrave/openravejson.h>
+#include <openrave/utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+
+#include <boost/format.hpp>
+
+using namespace OpenRAVE;
+using namespace std;
+
+namespace openravebenchmark {
+
+/// \brief benchmark ready to be timed
+struct BenchmarkCase
+{
+    std::function<void()> operation; ///< timed, has to be repeatable
+    EnvironmentBasePtr penv; ///< destroyed once the benchmark finished
+};
+
+typedef std::function<void(BenchmarkCase&)> BenchmarkFactory; ///< fills the case, the environment is destroyed even if it throws
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::string skipreason; ///< if not empty, the benchmark could not run
+    uint64_t numiterations = 0; ///< total number of timed calls
+    std::vector<double> vsamples; ///< nanoseconds per call of every timed batch
+};
+
+static const int s_nNumSamples = 10;
+static const int s_nMinNumSamples = 3;
+static const uint32_t s_nSeed = 0x4f524245;
+
+static EnvironmentBasePtr _CreateEnvironment()
+{
+    EnvironmentBasePtr penv = RaveCreateEnvironment();
+    CollisionCheckerBasePtr pchecker = RaveCreateCollisionChecker(penv, "fcl_");
+    if( !pchecker ) {
+        penv->Destroy();
+        throw OPENRAVE_EXCEPTION_FORMAT0("fcl_ collision checker is not available", ORE_InvalidPlugin);
+    }
+    penv->SetCollisionChecker(pchecker);
+    return penv;
+}
+
+static void _LoadScene(EnvironmentBasePtr penv, const std::string& filename)
+{
+    if( !penv->Load(filename) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT("failed to load %s", filename, ORE_InvalidArguments);
+    }
+}
+
+static RobotBasePtr _GetFirstRobot(EnvironmentBasePtr penv)
+{
+    std::vector<RobotBasePtr> vrobots;
+    penv->GetRobots(vrobots);
+    if( vrobots.size() == 0 ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0("scene has no robot", ORE_InvalidArguments);
+    }
+    return vrobots.at(0);
+}
+
+/// \brief returns numconfigs configurations of the dofs uniformly sampled in the limits
+static std::vector< std::vector<dReal> > _SampleConfigurations(KinBodyConstPtr pbody, const std::vector<int>& vdofindices, size_t numconfigs, std::mt19937& rng)
+{
+    std::vector<dReal> vlower, vupper;
+    pbody->GetDOFLimits(vlower, vupper, vdofindices);
+    std::vector< std::vector<dReal> > vconfigs(numconfigs, std::vector<dReal>(vlower.size()));
+    std::uniform_real_distribution<double> distribution(0, 1);
+    for(std::vector<dReal>& vconfig : vconfigs) {
+        for(size_t idof = 0; idof < vlower.size(); ++idof) {
+            // revolute joints without limits report +-inf
+            dReal lower = std::max(vlower[idof], (dReal)-PI), upper = std::min(vupper[idof], (dReal)PI);
+            vconfig[idof] = lower + (upper-lower)*distribution(rng);
+        }
+    }
+    return vconfigs;
+}
+
+static std::vector<int> _GetAllDOFIndices(KinBodyConstPtr pbody)
+{
+    std::vector<int> vdofindices(pbody->GetDOF());
+    for(int idof = 0; idof < pbody->GetDOF(); ++idof) {
+        vdofindices[idof] = idof;
+    }
+    return vdofindices;
+}
+
+static void _CreateSetDOFValues(BenchmarkCase& bcase, const std::string& robotfilename)
+{
+    bcase.penv = _CreateEnvironment();
+    _LoadScene(bcase.penv, robotfilename);
+    RobotBasePtr probot = _GetFirstRobot(bcase.penv);
+    std::mt19937 rng(s_nSeed);
+    boost::shared_ptr< std::vector< std::vector<dReal> > > pvconfigs(new std::vector< std::vector<dReal> >(_SampleConfigurations(probot, _GetAllDOFIndices(probot), 256, rng)));
+    boost::shared_ptr<size_t> pindex(new size_t(0));
+    bcase.operation = [probot, pvconfigs, pindex]() {
+        probot->SetDOFValues(pvconfigs->at((*pindex)++ % pvconfigs->size()), KinBody::CLA_Nothing);
+    };
+}
+
+static void _CreateCalculateJacobian(BenchmarkCase& bcase, const std::string& robotfilename)
+{
+    bcase.penv = _CreateEnvironment();
+    _LoadScene(bcase.penv, robotfilename);
+    RobotBasePtr probot = _GetFirstRobot(bcase.penv);
+    std::mt19937 rng(s_nSeed);
+    probot->SetDOFValues(_SampleConfigurations(probot, _GetAllDOFIndices(probot), 1, rng).at(0), KinBody::CLA_Nothing);
+    RobotBase::ManipulatorPtr pmanip = probot->GetActiveManipulator();
+    const int linkindex = !!pmanip ? pmanip->GetEndEffector()->GetIndex() : (int)probot->GetLinks().size()-1;
+    const Vector position = probot->GetLinks().at(linkindex)->GetTransform().trans;
+    boost::shared_ptr< std::vector<dReal> > pvjacobian(new std::vector<dReal>());
+    bcase.operation = [probot, linkindex, position, pvjacobian]() {
+        probot->CalculateJacobian(linkindex, position, *pvjacobian);
+    };
+}
+
+static void _CreateComputeInverseDynamics(BenchmarkCase& bcase, const std::string& robotfilename)
+{
+    bcase.penv = _CreateEnvironment();
+    _LoadScene(bcase.penv, robotfilename);
+    RobotBasePtr probot = _GetFirstRobot(bcase.penv);
+    std::mt19937 rng(s_nSeed);
+    std::vector<int> vdofindices = _GetAllDOFIndices(probot);
+    probot->SetDOFValues(_SampleConfigurations(probot, vdofindices, 1, rng).at(0), KinBody::CLA_Nothing);
+    std::vector<dReal> vvelocities(probot->GetDOF());
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    for(dReal& velocity : vvelocities) {
+        velocity = distribution(rng);
+    }
+    probot->SetDOFVelocities(vvelocities, KinBody::CLA_Nothing);
+    boost::shared_ptr< std::vector<dReal> > pvaccelerations(new std::vector<dReal>(probot->GetDOF())), pvtorques(new std::vector<dReal>());
+    for(dReal& acceleration : *pvaccelerations) {
+        acceleration = distribution(rng);
+    }
+    bcase.operation = [probot, pvaccelerations, pvtorques]() {
+        probot->ComputeInverseDynamics(*pvtorques, *pvaccelerations);
+    };
+}
+
+/// \brief every call moves the robot to the next sampled configuration and checks it, so the broadphase has to be updated like in planning
+static void _CreateCheckCollision(BenchmarkCase& bcase, const std::string& scenefilename, bool bSelfCollision)
+{
+    bcase.penv = _CreateEnvironment();
+    _LoadScene(bcase.penv, scenefilename);
+    RobotBasePtr probot = _GetFirstRobot(bcase.penv);
+    std::mt19937 rng(s_nSeed);
+    boost::shared_ptr< std::vector< std::vector<dReal> > > pvconfigs(new std::vector< std::vector<dReal> >(_SampleConfigurations(probot, _GetAllDOFIndices(probot), 256, rng)));
+    boost::shared_ptr<size_t> pindex(new size_t(0));
+    EnvironmentBasePtr penv = bcase.penv;
+    if( bSelfCollision ) {
+        bcase.operation = [probot, pvconfigs, pindex]() {
+            probot->SetDOFValues(pvconfigs->at((*pindex)++ % pvconfigs->size()), KinBody::CLA_Nothing);
+            probot->CheckSelfCollision();
+        };
+    }
+    else {
+        bcase.operation = [penv, probot, pvconfigs, pindex]() {
+            probot->SetDOFValues(pvconfigs->at((*pindex)++ % pvconfigs->size()), KinBody::CLA_Nothing);
+            penv->CheckCollision(KinBodyConstPtr(probot));
+        };
+    }
+}
+
+static void _CreateTrajectorySample(BenchmarkCase& bcase, const std::string& robotfilename)
+{
+    bcase.penv = _CreateEnvironment();
+    _LoadScene(bcase.penv, robotfilename);
+    RobotBasePtr probot = _GetFirstRobot(bcase.penv);
+    std::mt19937 rng(s_nSeed);
+    std::vector<int> vdofindices = _GetAllDOFIndices(probot);
+    ConfigurationSpecification spec = probot->GetConfigurationSpecificationIndices(vdofindices, "quadratic");
+    spec += spec.ConvertToVelocitySpecification();
+    const int deltatimeoffset = spec.AddDeltaTimeGroup();
+    std::vector< std::vector<dReal> > vconfigs = _SampleConfigurations(probot, vdofindices, 200, rng);
+    std::vector<dReal> vtrajdata(spec.GetDOF()*vconfigs.size(), 0);
+    for(size_t iwaypoint = 0; iwaypoint < vconfigs.size(); ++iwaypoint) {
+        std::copy(vconfigs[iwaypoint].begin(), vconfigs[iwaypoint].end(), vtrajdata.begin() + iwaypoint*spec.GetDOF());
+        vtrajdata[iwaypoint*spec.GetDOF() + deltatimeoffset] = iwaypoint > 0 ? 0.05 : 0;
+    }
+    TrajectoryBasePtr ptraj = RaveCreateTrajectory(bcase.penv, "");
+    ptraj->Init(spec);
+    ptraj->Insert(0, vtrajdata);
+    boost::shared_ptr< std::vector<dReal> > pvtimes(new std::vector<dReal>(1024)), pvsample(new std::vector<dReal>());
+    std::uniform_real_distribution<double> distribution(0, ptraj->GetDuration());
+    for(dReal& sampletime : *pvtimes) {
+        sampletime = distribution(rng);
+    }
+    boost::shared_ptr<size_t> pindex(new size_t(0));
+    bcase.operation = [ptraj, pvtimes, pvsample, pindex]() {
+        ptraj->Sample(*pvsample, pvtimes->at((*pindex)++ % pvtimes->size()));
+    };
+}
+
+/// \brief converts 1000 points between specifications with different dof orders, interpolations and groups
+static void _CreateConvertData(BenchmarkCase& bcase, const std::string& robotfilename)
+{
+    bcase.penv = _CreateEnvironment();
+    _LoadScene(bcase.penv, robotfilename);
+    RobotBasePtr probot = _GetFirstRobot(bcase.penv);
+    std::vector<int> vdofindices = _GetAllDOFIndices(probot);
+    ConfigurationSpecification sourcespec = probot->GetConfigurationSpecificationIndices(vdofindices, "cubic");
+    sourcespec += sourcespec.ConvertToVelocitySpecification();
+    sourcespec.AddDeltaTimeGroup();
+    std::reverse(vdofindices.begin(), vdofindices.end());
+    ConfigurationSpecification targetspec = probot->GetConfigurationSpecificationIndices(vdofindices, "linear");
+    targetspec.AddDeltaTimeGroup();
+
+    const size_t numpoints = 1000;
+    boost::shared_ptr< std::vector<dReal> > pvsourcedata(new std::vector<dReal>(sourcespec.GetDOF()*numpoints)), pvtargetdata(new std::vector<dReal>(targetspec.GetDOF()*numpoints));
+    std::mt19937 rng(s_nSeed);
+    std::uniform_real_distribution<double> distribution(-1, 1);
+    for(dReal& value : *pvsourcedata) {
+        value = distribution(rng);
+    }
+    EnvironmentBaseConstPtr penv = bcase.penv;
+    bcase.operation = [sourcespec, targetspec, pvsourcedata, pvtargetdata, penv, numpoints]() {
+        ConfigurationSpecification::ConvertData(pvtargetdata->begin(), targetspec, pvsourcedata->begin(), sourcespec, numpoints, penv);
+    };
+}
+
+/// \brief solves all the Transform6D solutions of end effector poses reached by sampled configurations
+static void _CreateIkSolveAll(BenchmarkCase& bcase, const std::string& robotfilename)
+{
+    bcase.penv = _CreateEnvironment();
+    _LoadScene(bcase.penv, robotfilename);
+    RobotBasePtr probot = _GetFirstRobot(bcase.penv);
+    RobotBase::ManipulatorPtr pmanip = probot->GetActiveManipulator();
+    if( !pmanip ) {
+        throw OPENRAVE_EXCEPTION_FORMAT("%s has no manipulator", robotfilename, ORE_InvalidArguments);
+    }
+    ModuleBasePtr pikfast = RaveCreateModule(bcase.penv, "ikfast");
+    if( !pikfast ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0("ikfast module is not available", ORE_InvalidPlugin);
+    }
+    bcase.penv->Add(pikfast, true, "");
+    std::stringstream ssin, ssout;
+    ssin << "LoadIKFastSolver " << probot->GetName() << " " << (int)IKP_Transform6D;
+    if( !pikfast->SendCommand(ssout, ssin) || !pmanip->GetIkSolver() ) {
+        throw OPENRAVE_EXCEPTION_FORMAT("failed to load the Transform6D ikfast solver of %s", probot->GetName(), ORE_InvalidState);
+    }
+
+    std::mt19937 rng(s_nSeed);
+    std::vector< std::vector<dReal> > vconfigs = _SampleConfigurations(probot, pmanip->GetArmIndices(), 256, rng);
+    boost::shared_ptr< std::vector<IkParameterization> > pvikparams(new std::vector<IkParameterization>());
+    {
+        RobotBase::RobotStateSaver saver(probot);
+        for(const std::vector<dReal>& vconfig : vconfigs) {
+            probot->SetDOFValues(vconfig, KinBody::CLA_Nothing, pmanip->GetArmIndices());
+            pvikparams->push_back(pmanip->GetIkParameterization(IKP_Transform6D));
+        }
+    }
+    boost::shared_ptr< std::vector< std::vector<dReal> > > pvsolutions(new std::vector< std::vector<dReal> >());
+    boost::shared_ptr<size_t> pindex(new size_t(0));
+    bcase.operation = [pmanip, pvikparams, pvsolutions, pindex]() {
+        pmanip->FindIKSolutions(pvikparams->at((*pindex)++ % pvikparams->size()), *pvsolutions, IKFO_IgnoreSelfCollisions);
+    };
+}
+
+/// \brief plans the arm of the first robot of the scene between fixed collision-free configurations
+static void _CreateBiRRT(BenchmarkCase& bcase, const std::string& scenefilename)
+{
+    bcase.penv = _CreateEnvironment();
+    _LoadScene(bcase.penv, scenefilename);
+    RobotBasePtr probot = _GetFirstRobot(bcase.penv);
+    RobotBase::ManipulatorPtr pmanip = probot->GetActiveManipulator();
+    if( !pmanip ) {
+        throw OPENRAVE_EXCEPTION_FORMAT("robot %s has no manipulator", probot->GetName(), ORE_InvalidArguments);
+    }
+    probot->SetActiveDOFs(pmanip->GetArmIndices());
+    PlannerBasePtr planner = RaveCreatePlanner(bcase.penv, "birrt");
+    if( !planner ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0("birrt planner is not available", ORE_InvalidPlugin);
+    }
+
+    PlannerBase::PlannerParametersPtr params(new PlannerBase::PlannerParameters());
+    params->_nMaxIterations = 4000;
+    params->SetRobotActiveJoints(probot);
+    probot->GetActiveDOFValues(params->vinitialconfig);
+    std::mt19937 rng(s_nSeed);
+    {
+        RobotBase::RobotStateSaver saver(probot);
+        for(int itry = 0; itry < 1000 && params->vgoalconfig.size() == 0; ++itry) {
+            std::vector<dReal> vgoal = _SampleConfigurations(probot, pmanip->GetArmIndices(), 1, rng).at(0);
+            probot->SetActiveDOFValues(vgoal);
+            if( !bcase.penv->CheckCollision(KinBodyConstPtr(probot)) && !probot->CheckSelfCollision() ) {
+                params->vgoalconfig = vgoal;
+            }
+        }
+    }
+    if( params->vgoalconfig.size() == 0 ) {
+        throw OPENRAVE_EXCEPTION_FORMAT("could not sample a collision-free goal in %s", scenefilename, ORE_InvalidState);
+    }
+    TrajectoryBasePtr ptraj = RaveCreateTrajectory(bcase.penv, "");
+    bcase.operation = [probot, planner, params, ptraj]() {
+        // same random samples every call
+        RaveInitRandomGeneration(s_nSeed);
+        if( !planner->InitPlan(probot, params) || !(planner->PlanPath(ptraj).GetStatusCode() & PS_HasSolution) ) {
+            throw OPENRAVE_EXCEPTION_FORMAT0("birrt failed to plan", ORE_Failed);
+        }
+    };
+}
+
+static void _CreateLoadURI(BenchmarkCase& bcase, const std::string& filename)
+{
+    bcase.penv = _CreateEnvironment();
+    EnvironmentBasePtr penv = bcase.penv;
+    _LoadScene(penv, filename);
+    penv->Reset();
+    bcase.operation = [penv, filename]() {
+        penv->Load(filename);
+        penv->Reset();
+    };
+}
+
+static void _CreateLoadJSON(BenchmarkCase& bcase, const std::string& scenefilename)
+{
+    bcase.penv = _CreateEnvironment();
+    EnvironmentBasePtr penv = bcase.penv;
+    _LoadScene(penv, scenefilename);
+    boost::shared_ptr<rapidjson::Document> prEnvInfo(new rapidjson::Document());
+    prEnvInfo->SetObject();
+    penv->SerializeJSON(*prEnvInfo, prEnvInfo->GetAllocator());
+    penv->Reset();
+    bcase.operation = [penv, prEnvInfo]() {
+        std::vector<KinBodyPtr> vCreatedBodies, vModifiedBodies, vRemovedBodies;
+        penv->LoadJSON(*prEnvInfo, UFIM_Exact, vCreatedBodies, vModifiedBodies, vRemovedBodies);
+        penv->Reset();
+    };
+}
+
+static std::vector< std::pair<std::string, BenchmarkFactory> > _GetBenchmarks()
+{
+    std::vector< std::pair<std::string, BenchmarkFactory> > vbenchmarks;
+    const char* robots[] = {"robots/barrettwam.robot.xml", "robots/puma.robot.xml"};
+    const char* robotnames[] = {"barrettwam", "puma"};
+    for(int irobot = 0; irobot < 2; ++irobot) {
+        const std::string robotfilename = robots[irobot], robotname = robotnames[irobot];
+        vbenchmarks.emplace_back("kinbody.setdofvalues." + robotname, std::bind(_CreateSetDOFValues, std::placeholders::_1, robotfilename));
+        vbenchmarks.emplace_back("kinbody.calculatejacobian." + robotname, std::bind(_CreateCalculateJacobian, std::placeholders::_1, robotfilename));
+        vbenchmarks.emplace_back("kinbody.computeinversedynamics." + robotname, std::bind(_CreateComputeInverseDynamics, std::placeholders::_1, robotfilename));
+        vbenchmarks.emplace_back("trajectory.sample." + robotname, std::bind(_CreateTrajectorySample, std::placeholders::_1, robotfilename));
+        vbenchmarks.emplace_back("configurationspecification.convertdata." + robotname, std::bind(_CreateConvertData, std::placeholders::_1, robotfilename));
+        vbenchmarks.emplace_back("ikfast.solveall." + robotname, std::bind(_CreateIkSolveAll, std::placeholders::_1, robotfilename));
+    }
+    vbenchmarks.emplace_back("fcl.checkcollision.env.lab1", std::bind(_CreateCheckCollision, std::placeholders::_1, std::string("data/lab1.env.xml"), false));
+    vbenchmarks.emplace_back("fcl.checkcollision.self.lab1", std::bind(_CreateCheckCollision, std::placeholders::_1, std::string("data/lab1.env.xml"), true));
+    vbenchmarks.emplace_back("fcl.checkcollision.env.pr2test1", std::bind(_CreateCheckCollision, std::placeholders::_1, std::string("data/pr2test1.env.xml"), false));
+    vbenchmarks.emplace_back("fcl.checkcollision.self.pr2test1", std::bind(_CreateCheckCollision, std::placeholders::_1, std::string("data/pr2test1.env.xml"), true));
+    vbenchmarks.emplace_back("planning.birrt.lab1", std::bind(_CreateBiRRT, std::placeholders::_1, std::string("data/lab1.env.xml")));
+    vbenchmarks.emplace_back("planning.birrt.hanoi_complex2", std::bind(_CreateBiRRT, std::placeholders::_1, std::string("data/hanoi_complex2.env.xml")));
+    vbenchmarks.emplace_back("load.xml.lab1", std::bind(_CreateLoadURI, std::placeholders::_1, std::string("data/lab1.env.xml")));
+    vbenchmarks.emplace_back("load.collada.barrett-wam-sensors", std::bind(_CreateLoadURI, std::placeholders::_1, std::string("robots/barrett-wam-sensors.zae")));
+    vbenchmarks.emplace_back("load.json.lab1", std::bind(_CreateLoadJSON, std::placeholders::_1, std::string("data/lab1.env.xml")));
+    return vbenchmarks;
+}
+
+static double _ElapsedNanoseconds(uint64_t starttime)
+{
+    return (double)(utils::GetNanoPerformanceTime() - starttime);
+}
+
+/// \brief times batches of the operation so that every batch lasts about mintime/s_nNumSamples
+static BenchmarkResult _RunBenchmark(const std::string& name, const BenchmarkFactory& factory, double mintime)
+{
+    BenchmarkResult result;
+    result.name = name;
+    BenchmarkCase bcase;
+    try {
+        factory(bcase);
+
+        // the first batch also warms up the caches
+        const double targetbatchtime = mintime*1e9/s_nNumSamples;
+        uint64_t batchsize = 1;
+        double batchtime = 0;
+        while(true) {
+            uint64_t starttime = utils::GetNanoPerformanceTime();
+            for(uint64_t i = 0; i < batchsize; ++i) {
+                bcase.operation();
+            }
+            batchtime = _ElapsedNanoseconds(starttime);
+            if( batchtime >= targetbatchtime || batchsize >= ((uint64_t)1<<32) ) {
+                break;
+            }
+            batchsize = batchtime > 0 ? std::max(batchsize*2, std::min(batchsize*100, (uint64_t)(1.2*batchsize*targetbatchtime/batchtime))) : batchsize*100;
+        }
+
+        // slow operations get fewer samples to keep the total time close to mintime
+        int numsamples = s_nNumSamples;
+        if( batchsize == 1 && batchtime > targetbatchtime ) {
+            numsamples = std::max(s_nMinNumSamples, std::min(s_nNumSamples, (int)(mintime*1e9/batchtime)));
+        }
+        for(int isample = 0; isample < numsamples; ++isample) {
+            uint64_t starttime = utils::GetNanoPerformanceTime();
+            for(uint64_t i = 0; i < batchsize; ++i) {
+                bcase.operation();
+            }
+            result.vsamples.push_back(_ElapsedNanoseconds(starttime)/batchsize);
+            result.numiterations += batchsize;
+        }
+    }
+    catch(const std::exception& ex) {
+        result.skipreason = ex.what();
+        result.vsamples.clear();
+    }
+    bcase.operation = nullptr;
+    if( !!bcase.penv ) {
+        bcase.penv->Destroy();
+    }
+    return result;
+}
+
+static void _SerializeResults(const std::vector<BenchmarkResult>& vresults, double mintime, rapidjson::Document& rResults)
+{
+    rapidjson::Document::AllocatorType& allocator = rResults.GetAllocator();
+    rResults.SetObject();
+    orjson::SetJsonValueByKey(rResults, "version", 1, allocator);
+    orjson::SetJsonValueByKey(rResults, "openraveVersion", std::string(OPENRAVE_VERSION_STRING), allocator);
+    orjson::SetJsonValueByKey(rResults, "realSize", (int)sizeof(dReal), allocator);
+    orjson::SetJsonValueByKey(rResults, "timestamp", (int64_t)time(NULL), allocator);
+    orjson::SetJsonValueByKey(rResults, "minTime", mintime, allocator);
+    rapidjson::Value rBenchmarks(rapidjson::kArrayType);
+    for(const BenchmarkResult& result : vresults) {
+        rapidjson::Value rBenchmark(rapidjson::kObjectType);
+        orjson::SetJsonValueByKey(rBenchmark, "name", result.name, allocator);
+        if( result.skipreason.size() > 0 ) {
+            orjson::SetJsonValueByKey(rBenchmark, "skipped", result.skipreason, allocator);
+        }
+        else {
+            std::vector<double> vsorted = result.vsamples;
+            std::sort(vsorted.begin(), vsorted.end());
+            double mean = 0, variance = 0;
+            for(double sample : vsorted) {
+                mean += sample;
+            }
+            mean /= vsorted.size();
+            for(double sample : vsorted) {
+                variance += (sample-mean)*(sample-mean);
+            }
+            variance /= vsorted.size();
+            const size_t n = vsorted.size();
+            const double median = (n % 2) ? vsorted[n/2] : 0.5*(vsorted[n/2-1]+vsorted[n/2]);
+            orjson::SetJsonValueByKey(rBenchmark, "iterations", result.numiterations, allocator);
+            orjson::SetJsonValueByKey(rBenchmark, "minNs", vsorted.front(), allocator);
+            orjson::SetJsonValueByKey(rBenchmark, "medianNs", median, allocator);
+            orjson::SetJsonValueByKey(rBenchmark, "meanNs", mean, allocator);
+            orjson::SetJsonValueByKey(rBenchmark, "stddevNs", std::sqrt(variance), allocator);
+            orjson::SetJsonValueByKey(rBenchmark, "samplesNs", result.vsamples, allocator);
+        }
+        rBenchmarks.PushBack(rBenchmark, allocator);
+    }
+    rResults.AddMember("benchmarks", rBenchmarks, allocator);
+}
+
+} // end namespace openravebenchmark
+
+using namespace openravebenchmark;
+
+int main(int argc, char ** argv)
+{
+    std::string outputfilename, filter;
+    double mintime = 1;
+    bool bList = false;
+    int debuglevel = Level_Warn;
+    for(int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if( arg == "-h" || arg == "--help" ) {
+            std::cout << "openrave_benchmark [--filter substring] [--mintime seconds] [--output results.json] [--list] [-d debuglevel]" << std::endl << std::endl
+                      << "Times the core hot paths and writes the results as JSON to the output file or stdout." << std::endl
+                      << "Compare two result files with comparebenchmarks.py." << std::endl;
+            return 0;
+        }
+        else if( arg == "--list" ) {
+            bList = true;
+        }
+        else if( i+1 < argc && arg == "--filter" ) {
+            filter = argv[++i];
+        }
+        else if( i+1 < argc && arg == "--mintime" ) {
+            mintime = atof(argv[++i]);
+        }
+        else if( i+1 < argc && arg == "--output" ) {
+            outputfilename = argv[++i];
+        }
+        else if( i+1 < argc && arg == "-d" ) {
+            debuglevel = atoi(argv[++i]);
+        }
+        else {
+            std::cerr << "unknown option " << arg << ", see --help" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector< std::pair<std::string, BenchmarkFactory> > vbenchmarks = _GetBenchmarks();
+    if( bList ) {
+        for(const std::pair<std::string, BenchmarkFactory>& benchmark : vbenchmarks) {
+            std::cout << benchmark.first << std::endl;
+        }
+        return 0;
+    }
+
+    RaveInitialize(true, debuglevel);
+    std::vector<BenchmarkResult> vresults;
+    for(const std::pair<std::string, BenchmarkFactory>& benchmark : vbenchmarks) {
+        if( filter.size() > 0 && benchmark.first.find(filter) == std::string::npos ) {
+            continue;
+        }
+        vresults.push_back(_RunBenchmark(benchmark.first, benchmark.second, mintime));
+        const BenchmarkResult& result = vresults.back();
+        if( result.skipreason.size() > 0 ) {
+            std::cerr << boost::format("%-50s skipped: %s")%result.name%result.skipreason << std::endl;
+        }
+        else {
+            std::cerr << boost::format("%-50s %14.1f ns")%result.name%(*std::min_element(result.vsamples.begin(), result.vsamples.end())) << std::endl;
+        }
+    }
+    RaveDestroy();
+
+    rapidjson::Document rResults;
+    _SerializeResults(vresults, mintime, rResults);
+    if( outputfilename.size() > 0 ) {
+        std::ofstream f(outputfilename.c_str());
+        orjson::DumpJson(rResults, f, 4);
+        if( !f ) {
+            std::cerr << "failed to write " << outputfilename << std::endl;
+            return 1;
+        }
+    }
+    else {
+        orjson::DumpJson(rResults, std::cout, 4);
+        std::cout << std::endl;
+    }
+    return 0;
+}
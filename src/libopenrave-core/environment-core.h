@@ -594,6 +594,8 @@ public:
             RAVELOG_WARN("Failed to load URI: '%s' is not a URI.", uri.c_str());
             return false;
         }
+        EnvironmentLock lockenv(GetMutex());
+        CollisionLODLoadScope collisionlodscope(*this, atts);
         if (_IsColladaFile(path)) {
             return RaveParseColladaURI(shared_from_this(), uri, atts);
         }
@@ -622,6 +624,7 @@ public:
     virtual bool Load(const std::string& filename, const AttributesList& atts) override
     {
         EnvironmentLock lockenv(GetMutex());
+        CollisionLODLoadScope collisionlodscope(*this, atts);
         OpenRAVEXMLParser::GetXMLErrorCount() = 0;
         std::string path;
         if (_IsURI(filename, path)) {
@@ -694,6 +697,7 @@ public:
     virtual bool LoadData(const std::string& data, const AttributesList& atts, const std::string& uri)
     {
         EnvironmentLock lockenv(GetMutex());
+        CollisionLODLoadScope collisionlodscope(*this, atts);
         if( _IsColladaData(data) ) {
             return RaveParseColladaData(shared_from_this(), data, atts);
         }
@@ -994,6 +998,9 @@ public:
     {
         EnvironmentLock lockenv(GetMutex());
         CHECK_INTERFACE(pbody);
+        if( _vCollisionLODs.size() > 0 ) {
+            _GenerateCollisionLODGroups(*pbody, _vCollisionLODs);
+        }
         if( !utils::IsValidName(pbody->GetName()) ) {
             if( addMode & IAM_StrictNameChecking ) {
                 throw openrave_exception(str(boost::format(_("Body name: '%s' is not valid"))%pbody->GetName()));
@@ -1035,6 +1042,9 @@ public:
         if( !robot->IsRobot() ) {
             throw openrave_exception(str(boost::format(_("kinbody '%s' is not a robot"))%robot->GetName()));
         }
+        if( _vCollisionLODs.size() > 0 ) {
+            _GenerateCollisionLODGroups(*robot, _vCollisionLODs);
+        }
         if( !utils::IsValidName(robot->GetName()) ) {
             if( addMode & IAM_StrictNameChecking ) {
                 throw openrave_exception(str(boost::format(_("Robot name: '%s' is not valid"))%robot->GetName()));
@@ -1492,6 +1502,7 @@ public:
     {
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(pbody1);
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollision");
         return _pCurrentChecker->CheckCollision(pbody1,report);
     }
 
@@ -1500,6 +1511,7 @@ public:
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(pbody1);
         CHECK_COLLISION_BODY(pbody2);
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollision");
         return _pCurrentChecker->CheckCollision(pbody1,pbody2,report);
     }
 
@@ -1507,6 +1519,7 @@ public:
     {
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(plink->GetParent());
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollision");
         return _pCurrentChecker->CheckCollision(plink,report);
     }
 
@@ -1515,6 +1528,7 @@ public:
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(plink1->GetParent());
         CHECK_COLLISION_BODY(plink2->GetParent());
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollision");
         return _pCurrentChecker->CheckCollision(plink1,plink2,report);
     }
 
@@ -1523,6 +1537,7 @@ public:
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(plink->GetParent());
         CHECK_COLLISION_BODY(pbody);
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollision");
         return _pCurrentChecker->CheckCollision(plink,pbody,report);
     }
 
@@ -1530,6 +1545,7 @@ public:
     {
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(plink->GetParent());
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollision");
         return _pCurrentChecker->CheckCollision(plink,vbodyexcluded,vlinkexcluded,report);
     }
 
@@ -1537,6 +1553,7 @@ public:
     {
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(pbody);
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollision");
         return _pCurrentChecker->CheckCollision(pbody,vbodyexcluded,vlinkexcluded,report);
     }
 
@@ -1544,16 +1561,19 @@ public:
     {
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(plink->GetParent());
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollisionRay");
         return _pCurrentChecker->CheckCollision(ray,plink,report);
     }
     virtual bool CheckCollision(const RAY& ray, KinBodyConstPtr pbody, CollisionReportPtr report) override
     {
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(pbody);
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollisionRay");
         return _pCurrentChecker->CheckCollision(ray,pbody,report);
     }
     virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report) override
     {
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollisionRay");
         return _pCurrentChecker->CheckCollision(ray,report);
     }
 
@@ -1561,6 +1581,7 @@ public:
     {
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(pbody);
+        OPENRAVE_PROFILE_SCOPE("collision.CheckCollisionTriMesh");
         return _pCurrentChecker->CheckCollision(trimesh,pbody,report);
     }
 
@@ -1568,6 +1589,7 @@ public:
     {
         EnvironmentLock lockenv(GetMutex());
         CHECK_COLLISION_BODY(pbody);
+        OPENRAVE_PROFILE_SCOPE("collision.CheckStandaloneSelfCollision");
         return _pCurrentChecker->CheckStandaloneSelfCollision(pbody,report);
     }
 
@@ -1874,6 +1896,10 @@ public:
             if( robot->__struri.empty() ) {
                 robot->__struri = filename;
             }
+            std::vector< std::pair<std::string, dReal> > vCollisionLODs;
+            if( _ParseCollisionLODs(atts, vCollisionLODs) ) {
+                _GenerateCollisionLODGroups(*robot, vCollisionLODs);
+            }
         }
 
         return robot;
@@ -2095,6 +2121,10 @@ public:
             if( body->__struri.empty() ) {
                 body->__struri = filename;
             }
+            std::vector< std::pair<std::string, dReal> > vCollisionLODs;
+            if( _ParseCollisionLODs(atts, vCollisionLODs) ) {
+                _GenerateCollisionLODGroups(*body, vCollisionLODs);
+            }
         }
 
         return body;
@@ -3449,6 +3479,147 @@ public:
 
 protected:
 
+    /// \brief while alive, the bodies added to the environment get the collision LOD geometry groups of the collisionlods load attribute
+    class CollisionLODLoadScope
+    {
+public:
+        CollisionLODLoadScope(Environment& env, const AttributesList& atts) : _env(env), _bSet(false) {
+            std::vector< std::pair<std::string, dReal> > vCollisionLODs;
+            if( Environment::_ParseCollisionLODs(atts, vCollisionLODs) ) {
+                _vPreviousCollisionLODs.swap(_env._vCollisionLODs);
+                _env._vCollisionLODs.swap(vCollisionLODs);
+                _bSet = true;
+            }
+        }
+        ~CollisionLODLoadScope() {
+            if( _bSet ) {
+                _env._vCollisionLODs.swap(_vPreviousCollisionLODs);
+            }
+        }
+
+private:
+        Environment& _env;
+        std::vector< std::pair<std::string, dReal> > _vPreviousCollisionLODs;
+        bool _bSet;
+    };
+
+    /// \brief parses the collisionlods attribute, which is a list of "groupname errortolerance" pairs
+    ///
+    /// \return true if the attribute is present
+    static bool _ParseCollisionLODs(const AttributesList& atts, std::vector< std::pair<std::string, dReal> >& vCollisionLODs)
+    {
+        vCollisionLODs.resize(0);
+        bool bFound = false;
+        FOREACHC(itatt, atts) {
+            if( itatt->first == "collisionlods" ) {
+                bFound = true;
+                vCollisionLODs.resize(0);
+                std::stringstream ss(itatt->second);
+                std::string groupname;
+                dReal fErrorTolerance = 0;
+                while( !!(ss >> groupname >> fErrorTolerance) ) {
+                    if( groupname.size() == 0 || fErrorTolerance < 0 ) {
+                        throw OPENRAVE_EXCEPTION_FORMAT(_("invalid collisionlods attribute '%s'"), itatt->second, ORE_InvalidArguments);
+                    }
+                    vCollisionLODs.emplace_back(groupname, fErrorTolerance);
+                }
+            }
+        }
+        return bFound;
+    }
+
+    /// \brief stores a decimated copy of the geometries of every link of body in each of the geometry groups of vCollisionLODs
+    ///
+    /// Groups that the body already defines are kept. The decimated meshes are not inflated, so they can miss contacts up to the
+    /// tolerance deep. Planners that check the coarse groups first have to treat distances below the tolerance as possible contact
+    /// and fall back to the original geometries there.
+    void _GenerateCollisionLODGroups(KinBody& body, const std::vector< std::pair<std::string, dReal> >& vCollisionLODs)
+    {
+        std::vector< std::vector<KinBody::GeometryInfoPtr> > vlinkgeometries(body.GetLinks().size());
+        for(const std::pair<std::string, dReal>& lod : vCollisionLODs) {
+            bool bHasGroup = false;
+            for(const KinBody::LinkPtr& plink : body.GetLinks()) {
+                if( plink->GetGroupNumGeometries(lod.first) >= 0 ) {
+                    bHasGroup = true;
+                    break;
+                }
+            }
+            if( bHasGroup ) {
+                RAVELOG_DEBUG_FORMAT("env=%s, body '%s' already has geometry group '%s', so not generating it", GetNameId()%body.GetName()%lod.first);
+                continue;
+            }
+
+            size_t numtriangles = 0, numsimplifiedtriangles = 0;
+            for(const KinBody::LinkPtr& plink : body.GetLinks()) {
+                std::vector<KinBody::GeometryInfoPtr>& vgeometryinfos = vlinkgeometries.at(plink->GetIndex());
+                vgeometryinfos.resize(0);
+                for(const KinBody::GeometryPtr& pgeom : plink->GetGeometries()) {
+                    const KinBody::GeometryInfo& info = pgeom->GetInfo();
+                    KinBody::GeometryInfoPtr pinfo(new KinBody::GeometryInfo(info));
+                    // small meshes are not worth decimating
+                    if( info._type == GT_TriMesh && info._meshcollision.indices.size() >= 3*256 ) {
+                        _GetSimplifiedCollisionMesh(info._meshcollision, lod.second, pinfo->_meshcollision);
+                        pinfo->_filenamecollision.clear();
+                        numtriangles += info._meshcollision.indices.size()/3;
+                        numsimplifiedtriangles += pinfo->_meshcollision.indices.size()/3;
+                    }
+                    vgeometryinfos.push_back(pinfo);
+                }
+            }
+            body.SetLinkGroupGeometries(lod.first, vlinkgeometries);
+            RAVELOG_DEBUG_FORMAT("env=%s, body '%s' geometry group '%s' (tolerance=%f) reduced %d mesh triangles to %d", GetNameId()%body.GetName()%lod.first%lod.second%numtriangles%numsimplifiedtriangles);
+        }
+    }
+
+    /// \brief simplifies the mesh with TriMesh::Simplify, caching the result in the database by the hash of the mesh and the tolerance
+    void _GetSimplifiedCollisionMesh(const TriMesh& mesh, dReal fErrorTolerance, TriMesh& simplified)
+    {
+        std::string meshdata;
+        meshdata.resize(sizeof(Vector)*mesh.vertices.size() + sizeof(int32_t)*mesh.indices.size());
+        std::copy((const char*)mesh.vertices.data(), (const char*)(mesh.vertices.data() + mesh.vertices.size()), &meshdata[0]);
+        std::copy((const char*)mesh.indices.data(), (const char*)(mesh.indices.data() + mesh.indices.size()), &meshdata[sizeof(Vector)*mesh.vertices.size()]);
+        const std::string cachename = str(boost::format("collisionlod.%s.%.6g")%utils::GetMD5HashString(meshdata)%fErrorTolerance);
+
+        const std::string readfilename = RaveFindDatabaseFile(cachename, true);
+        if( readfilename.size() > 0 ) {
+            std::ifstream f(readfilename.c_str(), std::ios::binary);
+            uint32_t header[3] = {0, 0, 0}; // sizeof(dReal), number of vertices, number of indices
+            if( !!f.read((char*)header, sizeof(header)) && header[0] == sizeof(dReal) ) {
+                simplified.vertices.resize(header[1]);
+                simplified.indices.resize(header[2]);
+                if( !!f.read((char*)simplified.vertices.data(), sizeof(Vector)*header[1]) && !!f.read((char*)simplified.indices.data(), sizeof(int32_t)*header[2]) ) {
+                    return;
+                }
+            }
+            RAVELOG_WARN_FORMAT("env=%s, collision LOD cache %s is invalid, regenerating it", GetNameId()%readfilename);
+        }
+
+        mesh.Simplify(fErrorTolerance, simplified);
+
+        const std::string filename = RaveFindDatabaseFile(cachename, false);
+        if( filename.size() == 0 ) {
+            return;
+        }
+        // write to a temporary file and rename it at the end so that other processes never read a partial file
+        const std::string tempfilename = str(boost::format("%s.tmp%d")%filename%utils::GetMicroTime());
+        {
+            std::ofstream f(tempfilename.c_str(), std::ios::binary);
+            const uint32_t header[3] = {(uint32_t)sizeof(dReal), (uint32_t)simplified.vertices.size(), (uint32_t)simplified.indices.size()};
+            f.write((const char*)header, sizeof(header));
+            f.write((const char*)simplified.vertices.data(), sizeof(Vector)*simplified.vertices.size());
+            f.write((const char*)simplified.indices.data(), sizeof(int32_t)*simplified.indices.size());
+            f.close();
+            if( !f ) {
+                RAVELOG_WARN_FORMAT("env=%s, failed to write collision LOD cache %s", GetNameId()%tempfilename);
+                std::remove(tempfilename.c_str());
+                return;
+            }
+        }
+        if( std::rename(tempfilename.c_str(), filename.c_str()) != 0 ) {
+            std::remove(tempfilename.c_str());
+        }
+    }
+
     void _Init()
     {
         _homedirectory = RaveGetHomeDirectory();
@@ -4469,6 +4640,7 @@ protected:
     std::map<std::string, uint64_t> _mapUInt64Parameters; ///< a custom user-driven parameters
     std::vector<uint8_t> _vRapidJsonLoadBuffer;
     boost::shared_ptr<rapidjson::MemoryPoolAllocator<> > _prLoadEnvAlloc; ///< allocator used for loading environments
+    std::vector< std::pair<std::string, dReal> > _vCollisionLODs; ///< geometry groups and error tolerances generated for the bodies added while loading with the collisionlods attribute, see CollisionLODLoadScope
 
     bool _bInit;                   ///< environment is initialized
     bool _bEnableSimulation;            ///< enable simulation loop
@@ -317,17 +317,13 @@ public:
             Insert(index, pdata, nDataElements, bOverwrite);
         }
         else {
-            std::vector< std::vector<ConfigurationSpecification::Group>::const_iterator > vconvertgroups(_spec._vgroups.size());
-            for(size_t i = 0; i < vconvertgroups.size(); ++i) {
-                vconvertgroups[i] = spec.FindCompatibleGroup(_spec._vgroups[i]);
-            }
             size_t numpoints = nDataElements/spec.GetDOF();
             size_t sourceindex = 0;
             std::vector<dReal>::iterator ittargetdata;
             if( bOverwrite && index*_spec.GetDOF() < _vtrajdata.size() ) {
                 size_t copyelements = min(numpoints,_vtrajdata.size()/_spec.GetDOF()-index);
                 ittargetdata = _vtrajdata.begin()+index*_spec.GetDOF();
-                _ConvertData(ittargetdata, pdata, vconvertgroups, spec, copyelements, false);
+                _ConvertData(ittargetdata, pdata, spec, copyelements, false);
                 sourceindex = copyelements*spec.GetDOF();
                 index += copyelements;
             }
@@ -335,7 +331,7 @@ public:
                 size_t numelements = (nDataElements-sourceindex)/spec.GetDOF();
                 std::vector<dReal> vtemp(numelements*_spec.GetDOF());
                 ittargetdata = vtemp.begin();
-                _ConvertData(ittargetdata, pdata+sourceindex, vconvertgroups, spec, numelements, true);
+                _ConvertData(ittargetdata, pdata+sourceindex, spec, numelements, true);
                 _vtrajdata.insert(_vtrajdata.begin()+index*_spec.GetDOF(),vtemp.begin(),vtemp.end());
             }
             _bChanged = true;
@@ -356,6 +352,7 @@ public:
 
     void Sample(std::vector<dReal>& data, dReal time) const override
     {
+        OPENRAVE_PROFILE_SCOPE("trajectory.Sample");
         BOOST_ASSERT(_bInit);
         BOOST_ASSERT(_timeoffset>=0);
         BOOST_ASSERT(time >= 0);
@@ -400,6 +397,7 @@ public:
 
     void Sample(std::vector<dReal>& data, dReal time, const ConfigurationSpecification& spec, bool reintializeData) const override
     {
+        OPENRAVE_PROFILE_SCOPE("trajectory.Sample");
         BOOST_ASSERT(_bInit);
         OPENRAVE_ASSERT_OP(_timeoffset,>=,0);
         OPENRAVE_ASSERT_OP(time, >=, -g_fEpsilon);
@@ -862,13 +860,16 @@ public:
     }
 
 protected:
-    void _ConvertData(std::vector<dReal>::iterator ittargetdata, const dReal* psourcedata, const std::vector< std::vector<ConfigurationSpecification::Group>::const_iterator >& vconvertgroups, const ConfigurationSpecification& spec, size_t numelements, bool filluninitialized)
+    void _ConvertData(std::vector<dReal>::iterator ittargetdata, const dReal* psourcedata, const ConfigurationSpecification& spec, size_t numelements, bool filluninitialized)
     {
-        for(size_t igroup = 0; igroup < vconvertgroups.size(); ++igroup) {
-            if( vconvertgroups[igroup] != spec._vgroups.end() ) {
-                ConfigurationSpecification::ConvertGroupData(ittargetdata+_spec._vgroups[igroup].offset, _spec.GetDOF(), _spec._vgroups[igroup], psourcedata+vconvertgroups[igroup]->offset, spec.GetDOF(), *vconvertgroups[igroup],numelements,GetEnv(),filluninitialized);
-            }
-            else if( filluninitialized ) {
+        // the groups that are not in spec are filled below without the current body values, so the plan leaves them untouched
+        ConfigurationSpecification::ConversionPlanConstPtr& pplan = filluninitialized ? _pinsertplan : _poverwriteplan;
+        if( !pplan || !pplan->IsCompatible(_spec, spec, filluninitialized, false) ) {
+            pplan.reset(new ConfigurationSpecification::ConversionPlan(_spec, spec, filluninitialized, false));
+        }
+        pplan->Convert(ittargetdata, psourcedata, numelements, GetEnv());
+        if( filluninitialized ) {
+            for(int igroup : pplan->GetMissingGroupIndices()) {
                 vector<dReal> vdefaultvalues(_spec._vgroups[igroup].dof,0);
                 const string& groupname = _spec._vgroups[igroup].name;
                 if( groupname.size() >= 16 && groupname.substr(0,16) == "affine_transform" ) {
@@ -1735,6 +1736,7 @@ protected:
 
     void _SampleRangeSameDeltaTime(std::vector<dReal>& data, dReal deltatime, dReal startTime, dReal stopTime, bool ensureLastPoint) const
     {
+        OPENRAVE_PROFILE_SCOPE("trajectory.SampleRangeSameDeltaTime");
         BOOST_ASSERT(_bInit);
         BOOST_ASSERT(_timeoffset>=0);
         OPENRAVE_ASSERT_OP_FORMAT0(startTime,>=,0, "start time needs to be non-negative", ORE_InvalidArguments);
@@ -1814,6 +1816,7 @@ protected:
     int _timeoffset;
 
     std::vector<dReal> _vtrajdata;
+    ConfigurationSpecification::ConversionPlanConstPtr _poverwriteplan, _pinsertplan; ///< conversions of the last specification given to Insert
     mutable std::vector<dReal> _vaccumtime, _vdeltainvtime;
     bool _bInit;
     mutable bool _bChanged; ///< if true, then _ComputeInternal() has to be called in order to compute _vaccumtime and _vdeltainvtime
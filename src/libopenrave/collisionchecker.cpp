@@ -67,11 +67,20 @@ void CollisionPairInfo::Swap(CollisionPairInfo& rhs)
     bodyLinkGeom1Name.swap(rhs.bodyLinkGeom1Name);
     bodyLinkGeom2Name.swap(rhs.bodyLinkGeom2Name);
     contacts.swap(rhs.contacts);
+    std::swap(bodyIndex1, rhs.bodyIndex1);
+    std::swap(linkIndex1, rhs.linkIndex1);
+    std::swap(geomIndex1, rhs.geomIndex1);
+    std::swap(bodyIndex2, rhs.bodyIndex2);
+    std::swap(linkIndex2, rhs.linkIndex2);
+    std::swap(geomIndex2, rhs.geomIndex2);
 }
 
 void CollisionPairInfo::SwapFirstSecond()
 {
     std::swap(bodyLinkGeom1Name, bodyLinkGeom2Name);
+    std::swap(bodyIndex1, bodyIndex2);
+    std::swap(linkIndex1, linkIndex2);
+    std::swap(geomIndex1, geomIndex2);
     for(CONTACT& c : contacts) {
         c.norm = -c.norm;
         c.depth = -c.depth;
@@ -96,6 +105,38 @@ void CollisionPairInfo::SetSecondCollision(const std::string& bodyname, const st
     bodyLinkGeom2Name += geomname;
 }
 
+/// \brief writes "bodyname linkname geomname" of the indices into bodyLinkGeomName, keeps the capacity of the string
+inline bool _ResolveBodyLinkGeomName(const EnvironmentBase& env, int bodyIndex, int linkIndex, int geomIndex, std::string& bodyLinkGeomName)
+{
+    KinBodyPtr pbody = env.GetBodyFromEnvironmentBodyIndex(bodyIndex);
+    if( !pbody ) {
+        return false;
+    }
+    bodyLinkGeomName = pbody->GetName();
+    if( linkIndex >= 0 && linkIndex < (int)pbody->GetLinks().size() ) {
+        const KinBody::Link& link = *pbody->GetLinks()[linkIndex];
+        bodyLinkGeomName.push_back(' ');
+        bodyLinkGeomName += link.GetName();
+        bodyLinkGeomName.push_back(' ');
+        if( geomIndex >= 0 && geomIndex < (int)link.GetGeometries().size() ) {
+            bodyLinkGeomName += link.GetGeometries()[geomIndex]->GetName();
+        }
+    }
+    return true;
+}
+
+bool CollisionPairInfo::ResolveNames(const EnvironmentBase& env)
+{
+    bool bSuccess = true;
+    if( IsFirstIndexOnly() ) {
+        bSuccess &= _ResolveBodyLinkGeomName(env, bodyIndex1, linkIndex1, geomIndex1, bodyLinkGeom1Name);
+    }
+    if( IsSecondIndexOnly() ) {
+        bSuccess &= _ResolveBodyLinkGeomName(env, bodyIndex2, linkIndex2, geomIndex2, bodyLinkGeom2Name);
+    }
+    return bSuccess;
+}
+
 void CollisionPairInfo::ExtractFirstBodyName(string_view& bodyname) const
 {
     bodyname = string_view();
@@ -229,8 +270,17 @@ void CollisionPairInfo::ExtractSecondBodyLinkGeomNames(string_view& bodyname, st
     _ExtractBodyLinkGeomNames(bodyLinkGeom2Name, bodyname, linkname, geomname);
 }
 
-inline int _CompareLink(const std::string& bodyLinkGeomName, const KinBody::Link& link)
+inline int _CompareLink(const std::string& bodyLinkGeomName, int bodyIndex, int linkIndex, const KinBody::Link& link)
 {
+    if( bodyIndex > 0 && bodyLinkGeomName.empty() ) {
+        // index only collision
+        if( linkIndex != link.GetIndex() ) {
+            return linkIndex < link.GetIndex() ? -1 : 1;
+        }
+        const int linkBodyIndex = link.GetParent()->GetEnvironmentBodyIndex();
+        return bodyIndex == linkBodyIndex ? 0 : (bodyIndex < linkBodyIndex ? -1 : 1);
+    }
+
     // compare the linkname first since getting parent requires atomic operations
     size_t firstindex = bodyLinkGeomName.find_first_of(' ');
     if( firstindex == std::string::npos ) {
@@ -258,12 +308,12 @@ inline int _CompareLink(const std::string& bodyLinkGeomName, const KinBody::Link
 
 int CollisionPairInfo::CompareFirstLink(const KinBody::Link& link) const
 {
-    return _CompareLink(bodyLinkGeom1Name, link);
+    return _CompareLink(bodyLinkGeom1Name, bodyIndex1, linkIndex1, link);
 }
 
 int CollisionPairInfo::CompareSecondLink(const KinBody::Link& link) const
 {
-    return _CompareLink(bodyLinkGeom2Name, link);
+    return _CompareLink(bodyLinkGeom2Name, bodyIndex2, linkIndex2, link);
 }
 
 int CollisionPairInfo::CompareFirstBodyName(const std::string& bodyname) const
@@ -284,12 +334,25 @@ int CollisionPairInfo::CompareSecondBodyName(const std::string& bodyname) const
     return strncmp(bodyLinkGeom2Name.c_str(), bodyname.c_str(), bodyname.size());
 }
 
-inline int _FindMatchingLinkIndex(const std::string& bodyLinkGeomName, const std::vector<KinBody::LinkPtr>& vlinks)
+inline int _FindMatchingLinkIndex(const std::string& bodyLinkGeomName, int bodyIndex, int linkIndex, const std::vector<KinBody::LinkPtr>& vlinks)
 {
     if( vlinks.size() == 0 ) {
         return -1;
     }
 
+    if( bodyIndex > 0 && bodyLinkGeomName.empty() ) {
+        // index only collision
+        if( vlinks[0]->GetParent()->GetEnvironmentBodyIndex() != bodyIndex ) {
+            return -1;
+        }
+        for(int ilink = 0; ilink < (int)vlinks.size(); ++ilink) {
+            if( vlinks[ilink]->GetIndex() == linkIndex ) {
+                return ilink;
+            }
+        }
+        return -1;
+    }
+
     size_t firstindex = bodyLinkGeomName.find_first_of(' ');
     if( firstindex == std::string::npos ) {
         return -1;
@@ -328,12 +391,12 @@ inline int _FindMatchingLinkIndex(const std::string& bodyLinkGeomName, const std
 
 int CollisionPairInfo::FindFirstMatchingLinkIndex(const std::vector<KinBody::LinkPtr>& vlinks) const
 {
-    return _FindMatchingLinkIndex(bodyLinkGeom1Name, vlinks);
+    return _FindMatchingLinkIndex(bodyLinkGeom1Name, bodyIndex1, linkIndex1, vlinks);
 }
 
 int CollisionPairInfo::FindSecondMatchingLinkIndex(const std::vector<KinBody::LinkPtr>& vlinks) const
 {
-    return _FindMatchingLinkIndex(bodyLinkGeom1Name, vlinks);
+    return _FindMatchingLinkIndex(bodyLinkGeom2Name, bodyIndex2, linkIndex2, vlinks);
 }
 
 inline int _CompareLinkName(const std::string& bodyLinkGeomName, const std::string& linkname)
@@ -360,9 +423,13 @@ int CollisionPairInfo::CompareSecondLinkName(const std::string& linkname) const
     return _CompareLinkName(bodyLinkGeom2Name, linkname);
 }
 
-inline KinBodyPtr _ExtractBody(const std::string& bodyLinkGeomName, EnvironmentBase& env)
+inline KinBodyPtr _ExtractBody(const std::string& bodyLinkGeomName, int bodyIndex, EnvironmentBase& env)
 {
     if( bodyLinkGeomName.empty() ) {
+        if( bodyIndex > 0 ) {
+            // index only collision
+            return env.GetBodyFromEnvironmentBodyIndex(bodyIndex);
+        }
         return KinBodyPtr();
     }
 
@@ -380,12 +447,12 @@ inline KinBodyPtr _ExtractBody(const std::string& bodyLinkGeomName, EnvironmentB
 
 KinBodyPtr CollisionPairInfo::ExtractFirstBody(EnvironmentBase& env) const
 {
-    return _ExtractBody(bodyLinkGeom1Name, env);
+    return _ExtractBody(bodyLinkGeom1Name, bodyIndex1, env);
 }
 
 KinBodyPtr CollisionPairInfo::ExtractSecondBody(EnvironmentBase& env) const
 {
-    return _ExtractBody(bodyLinkGeom2Name, env);
+    return _ExtractBody(bodyLinkGeom2Name, bodyIndex2, env);
 }
 
 void CollisionPairInfo::SaveToJson(rapidjson::Value& rCollision, rapidjson::Document::AllocatorType& alloc) const
@@ -393,6 +460,14 @@ void CollisionPairInfo::SaveToJson(rapidjson::Value& rCollision, rapidjson::Docu
     rCollision.SetObject();
     orjson::SetJsonValueByKey(rCollision, "bodyLinkGeom1Name", bodyLinkGeom1Name, alloc);
     orjson::SetJsonValueByKey(rCollision, "bodyLinkGeom2Name", bodyLinkGeom2Name, alloc);
+    if( IsFirstIndexOnly() ) {
+        std::array<int, 3> indices = {{bodyIndex1, linkIndex1, geomIndex1}};
+        orjson::SetJsonValueByKey(rCollision, "bodyLinkGeom1Indices", indices, alloc);
+    }
+    if( IsSecondIndexOnly() ) {
+        std::array<int, 3> indices = {{bodyIndex2, linkIndex2, geomIndex2}};
+        orjson::SetJsonValueByKey(rCollision, "bodyLinkGeom2Indices", indices, alloc);
+    }
 
     rapidjson::Value rContacts;
     rContacts.SetArray();
@@ -414,6 +489,15 @@ void CollisionPairInfo::LoadFromJson(const rapidjson::Value& rCollision)
 
     orjson::LoadJsonValueByKey(rCollision, "bodyLinkGeom1Name", bodyLinkGeom1Name);
     orjson::LoadJsonValueByKey(rCollision, "bodyLinkGeom2Name", bodyLinkGeom2Name);
+    std::array<int, 3> indices;
+    if( rCollision.HasMember("bodyLinkGeom1Indices") ) {
+        orjson::LoadJsonValueByKey(rCollision, "bodyLinkGeom1Indices", indices);
+        SetFirstCollisionIndices(indices[0], indices[1], indices[2]);
+    }
+    if( rCollision.HasMember("bodyLinkGeom2Indices") ) {
+        orjson::LoadJsonValueByKey(rCollision, "bodyLinkGeom2Indices", indices);
+        SetSecondCollisionIndices(indices[0], indices[1], indices[2]);
+    }
 
     rapidjson::Value::ConstMemberIterator itContacts = rCollision.FindMember("contacts");
     if( itContacts != rCollision.MemberEnd() ) {
@@ -453,6 +537,7 @@ void CollisionReport::Swap(CollisionReport& rhs)
     std::swap(minDistance, rhs.minDistance);
     std::swap(numWithinTol, rhs.numWithinTol);
     std::swap(nKeepPrevious, rhs.nKeepPrevious);
+    std::swap(bIndexOnly, rhs.bIndexOnly);
 }
 
 CollisionReport& CollisionReport::operator=(const CollisionReport& rhs)
@@ -469,6 +554,7 @@ CollisionReport& CollisionReport::operator=(const CollisionReport& rhs)
     minDistance = rhs.minDistance;
     numWithinTol = rhs.numWithinTol;
     nKeepPrevious = rhs.nKeepPrevious;
+    bIndexOnly = rhs.bIndexOnly;
     return *this;
 }
 
@@ -478,7 +564,21 @@ std::string CollisionReport::__str__() const
     s << "[";
     for(int index = 0; index < nNumValidCollisions; ++index) {
         const CollisionPairInfo& cpinfo = vCollisionInfos.at(index);
-        s << "(" << cpinfo.bodyLinkGeom1Name << ")x(" << cpinfo.bodyLinkGeom2Name << ")";
+        s << "(";
+        if( cpinfo.IsFirstIndexOnly() ) {
+            s << "#" << cpinfo.bodyIndex1 << " " << cpinfo.linkIndex1 << " " << cpinfo.geomIndex1;
+        }
+        else {
+            s << cpinfo.bodyLinkGeom1Name;
+        }
+        s << ")x(";
+        if( cpinfo.IsSecondIndexOnly() ) {
+            s << "#" << cpinfo.bodyIndex2 << " " << cpinfo.linkIndex2 << " " << cpinfo.geomIndex2;
+        }
+        else {
+            s << cpinfo.bodyLinkGeom2Name;
+        }
+        s << ")";
         if( cpinfo.contacts.size() > 0 ) {
             s << ", c=" << cpinfo.contacts.size();
         }
@@ -543,6 +643,77 @@ void CollisionReport::LoadFromJson(const rapidjson::Value& rCollisionReport)
     orjson::LoadJsonValueByKey(rCollisionReport, "numWithinTol", numWithinTol);
 }
 
+void CollisionReport::Reserve(int numCollisions, int numContactsPerCollision)
+{
+    if( numCollisions > (int)vCollisionInfos.size() ) {
+        vCollisionInfos.resize(numCollisions);
+    }
+    if( numContactsPerCollision > 0 ) {
+        for(CollisionPairInfo& cpinfo : vCollisionInfos) {
+            cpinfo.contacts.reserve(numContactsPerCollision);
+        }
+    }
+}
+
+bool CollisionReport::ResolveNames(const EnvironmentBase& env)
+{
+    bool bSuccess = true;
+    for(int index = 0; index < nNumValidCollisions; ++index) {
+        bSuccess &= vCollisionInfos[index].ResolveNames(env);
+    }
+    return bSuccess;
+}
+
+/// \brief returns the index of pgeom in the current geometries of link, -1 if not found
+inline int _GetGeometryIndex(const KinBody::Link& link, const KinBody::Geometry* pgeom)
+{
+    if( !pgeom ) {
+        return -1;
+    }
+    const std::vector<KinBody::GeometryPtr>& vgeometries = link.GetGeometries();
+    for(int igeom = 0; igeom < (int)vgeometries.size(); ++igeom) {
+        if( vgeometries[igeom].get() == pgeom ) {
+            return igeom;
+        }
+    }
+    return -1;
+}
+
+/// \brief sets the first collision to the link and geometry. With bIndexOnly, the names are left empty. Otherwise the geometry index is not searched since it is only needed to resolve the names.
+inline void _SetFirstLinkGeomCollision(CollisionPairInfo& cpinfo, const KinBody::Link& link, const KinBody::Geometry* pgeom, bool bIndexOnly)
+{
+    KinBodyPtr pbody = link.GetParent();
+    if( bIndexOnly ) {
+        cpinfo.SetFirstCollisionIndices(pbody->GetEnvironmentBodyIndex(), link.GetIndex(), _GetGeometryIndex(link, pgeom));
+    }
+    else {
+        cpinfo.SetFirstCollisionIndices(pbody->GetEnvironmentBodyIndex(), link.GetIndex(), -1);
+        cpinfo.SetFirstCollision(pbody->GetName(), link.GetName(), !!pgeom ? pgeom->GetName() : std::string());
+    }
+}
+
+inline void _SetSecondLinkGeomCollision(CollisionPairInfo& cpinfo, const KinBody::Link& link, const KinBody::Geometry* pgeom, bool bIndexOnly)
+{
+    KinBodyPtr pbody = link.GetParent();
+    if( bIndexOnly ) {
+        cpinfo.SetSecondCollisionIndices(pbody->GetEnvironmentBodyIndex(), link.GetIndex(), _GetGeometryIndex(link, pgeom));
+    }
+    else {
+        cpinfo.SetSecondCollisionIndices(pbody->GetEnvironmentBodyIndex(), link.GetIndex(), -1);
+        cpinfo.SetSecondCollision(pbody->GetName(), link.GetName(), !!pgeom ? pgeom->GetName() : std::string());
+    }
+}
+
+/// \brief true if the two collisions refer to the same pair. Index only collisions are compared with their indices, otherwise with their names
+inline bool _IsSameCollision(const CollisionPairInfo& cpinfo0, const CollisionPairInfo& cpinfo1, bool bIndexOnly)
+{
+    if( bIndexOnly ) {
+        return cpinfo0.bodyIndex1 == cpinfo1.bodyIndex1 && cpinfo0.linkIndex1 == cpinfo1.linkIndex1 && cpinfo0.geomIndex1 == cpinfo1.geomIndex1
+               && cpinfo0.bodyIndex2 == cpinfo1.bodyIndex2 && cpinfo0.linkIndex2 == cpinfo1.linkIndex2 && cpinfo0.geomIndex2 == cpinfo1.geomIndex2;
+    }
+    return cpinfo0.bodyLinkGeom1Name == cpinfo1.bodyLinkGeom1Name && cpinfo0.bodyLinkGeom2Name == cpinfo1.bodyLinkGeom2Name;
+}
+
 int CollisionReport::AddCollision()
 {
     // first write the collision as if it was unique
@@ -561,11 +732,10 @@ int CollisionReport::AddLinkCollision(const KinBody::Link& link1)
     }
     CollisionPairInfo& addcpinfo = vCollisionInfos[nNumValidCollisions];
     addcpinfo.Reset(); // might be old data
-    addcpinfo.SetFirstCollision(link1.GetParent()->GetName(), link1.GetName(), std::string());
+    _SetFirstLinkGeomCollision(addcpinfo, link1, NULL, bIndexOnly);
     // now check if there exists one like it already
     for(int icollision = 0; icollision < nNumValidCollisions; ++icollision) {
-        const CollisionPairInfo& checkcpinfo = vCollisionInfos[icollision];
-        if( checkcpinfo.bodyLinkGeom1Name == addcpinfo.bodyLinkGeom1Name && checkcpinfo.bodyLinkGeom2Name.empty() ) {
+        if( _IsSameCollision(vCollisionInfos[icollision], addcpinfo, bIndexOnly) ) {
             return icollision;
         }
     }
@@ -581,12 +751,11 @@ int CollisionReport::AddLinkCollision(const KinBody::Link& link1, const KinBody:
     }
     CollisionPairInfo& addcpinfo = vCollisionInfos[nNumValidCollisions];
     addcpinfo.Reset(); // might be old data
-    addcpinfo.SetFirstCollision(link1.GetParent()->GetName(), link1.GetName(), std::string());
-    addcpinfo.SetSecondCollision(link2.GetParent()->GetName(), link2.GetName(), std::string());
+    _SetFirstLinkGeomCollision(addcpinfo, link1, NULL, bIndexOnly);
+    _SetSecondLinkGeomCollision(addcpinfo, link2, NULL, bIndexOnly);
     // now check if there exists one like it already
     for(int icollision = 0; icollision < nNumValidCollisions; ++icollision) {
-        const CollisionPairInfo& checkcpinfo = vCollisionInfos[icollision];
-        if( checkcpinfo.bodyLinkGeom1Name == addcpinfo.bodyLinkGeom1Name && checkcpinfo.bodyLinkGeom2Name == addcpinfo.bodyLinkGeom2Name ) {
+        if( _IsSameCollision(vCollisionInfos[icollision], addcpinfo, bIndexOnly) ) {
             return icollision;
         }
     }
@@ -603,16 +772,15 @@ int CollisionReport::AddLinkGeomCollision(const KinBody::LinkConstPtr& plink1, c
     CollisionPairInfo& addcpinfo = vCollisionInfos[nNumValidCollisions];
     addcpinfo.Reset(); // might be old data
     if( !!plink1 ) {
-        addcpinfo.SetFirstCollision(plink1->GetParent()->GetName(), plink1->GetName(), !!pgeom1 ? pgeom1->GetName() : std::string());
+        _SetFirstLinkGeomCollision(addcpinfo, *plink1, pgeom1.get(), bIndexOnly);
     }
     if( !!plink2 ) {
-        addcpinfo.SetSecondCollision(plink2->GetParent()->GetName(), plink2->GetName(), !!pgeom2 ? pgeom2->GetName() : std::string());
+        _SetSecondLinkGeomCollision(addcpinfo, *plink2, pgeom2.get(), bIndexOnly);
     }
 
     // now check if there exists one like it already
     for(int icollision = 0; icollision < nNumValidCollisions; ++icollision) {
-        const CollisionPairInfo& checkcpinfo = vCollisionInfos[icollision];
-        if( checkcpinfo.bodyLinkGeom1Name == addcpinfo.bodyLinkGeom1Name && checkcpinfo.bodyLinkGeom2Name == addcpinfo.bodyLinkGeom2Name ) {
+        if( _IsSameCollision(vCollisionInfos[icollision], addcpinfo, bIndexOnly) ) {
             return icollision;
         }
     }
@@ -628,10 +796,10 @@ int CollisionReport::SetLinkGeomCollision(const KinBody::LinkConstPtr& plink1, c
     CollisionPairInfo& addcpinfo = vCollisionInfos[0];
     addcpinfo.Reset(); // might be old data
     if( !!plink1 ) {
-        addcpinfo.SetFirstCollision(plink1->GetParent()->GetName(), plink1->GetName(), !!pgeom1 ? pgeom1->GetName() : std::string());
+        _SetFirstLinkGeomCollision(addcpinfo, *plink1, pgeom1.get(), bIndexOnly);
     }
     if( !!plink2 ) {
-        addcpinfo.SetSecondCollision(plink2->GetParent()->GetName(), plink2->GetName(), !!pgeom2 ? pgeom2->GetName() : std::string());
+        _SetSecondLinkGeomCollision(addcpinfo, *plink2, pgeom2.get(), bIndexOnly);
     }
     nNumValidCollisions = 1;
     return 0;
@@ -21,6 +21,7 @@
 #include <openrave/xmlreaders.h>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/bind/bind.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/lexical_cast.hpp>
 
 using boost::placeholders::_1;
@@ -1795,66 +1796,259 @@ void ConfigurationSpecification::ConvertGroupData(std::vector<dReal>::iterator i
     }
 }
 
-void ConfigurationSpecification::ConvertData(std::vector<dReal>::iterator ittargetdata, const ConfigurationSpecification &targetspec, std::vector<dReal>::const_iterator itsourcedata, const ConfigurationSpecification &sourcespec, size_t numpoints, EnvironmentBaseConstPtr penv, bool filluninitialized)
+/// \brief computes for every target dof the index of the source dof it is copied from, -1 if it is not in the source.
+///
+/// Only handles the groups whose names fully determine the transfer. Returns false for the groups that have to be converted with ConvertGroupData, like affine and ikparam conversions or names missing their indices.
+static bool _GetGroupTransferIndices(const ConfigurationSpecification::Group& gtarget, const ConfigurationSpecification::Group& gsource, std::vector<int>& vtransferindices)
 {
-    for(size_t igroup = 0; igroup < targetspec._vgroups.size(); ++igroup) {
-        std::vector<ConfigurationSpecification::Group>::const_iterator itcompatgroup = sourcespec.FindCompatibleGroup(targetspec._vgroups[igroup]);
-        if( itcompatgroup != sourcespec._vgroups.end() ) {
-            ConfigurationSpecification::ConvertGroupData(ittargetdata+targetspec._vgroups[igroup].offset, targetspec.GetDOF(), targetspec._vgroups[igroup], itsourcedata+itcompatgroup->offset, sourcespec.GetDOF(), *itcompatgroup,numpoints,penv,filluninitialized);
-        }
-        else if( filluninitialized ) {
-            vector<dReal> vdefaultvalues(targetspec._vgroups[igroup].dof,0);
-            const string& name = targetspec._vgroups[igroup].name;
-            if( name.size() >= 12 && name.substr(0,12) == "joint_values" ) {
-                string bodyname;
-                stringstream ss(name.substr(12));
-                ss >> bodyname;
-                if( !!ss ) {
-                    if( !!penv ) {
-                        KinBodyPtr body = penv->GetKinBody(bodyname);
-                        if( !!body ) {
-                            vector<dReal> values;
-                            body->GetDOFValues(values);
-                            std::vector<int> indices((istream_iterator<int>(ss)), istream_iterator<int>());
-                            for(size_t i = 0; i < indices.size(); ++i) {
-                                vdefaultvalues.at(i) = values.at(indices[i]);
-                            }
-                        }
+    vtransferindices.resize(0);
+    if( gsource.name == gtarget.name ) {
+        if( gsource.dof != gtarget.dof ) {
+            return false;
+        }
+        for(int i = 0; i < gtarget.dof; ++i) {
+            vtransferindices.push_back(i);
+        }
+        return true;
+    }
+
+    stringstream ss(gtarget.name);
+    std::vector<std::string> targettokens((istream_iterator<std::string>(ss)), istream_iterator<std::string>());
+    ss.clear();
+    ss.str(gsource.name);
+    std::vector<std::string> sourcetokens((istream_iterator<std::string>(ss)), istream_iterator<std::string>());
+    if( targettokens.size() == 0 || sourcetokens.size() == 0 || targettokens[0] != sourcetokens[0] ) {
+        return false;
+    }
+
+    if( (targettokens[0].size() >= 6 && targettokens[0].substr(0,6) == "joint_") || targettokens[0] == "grab" ) {
+        if( (int)sourcetokens.size() < gsource.dof+2 || (int)targettokens.size() < gtarget.dof+2 ) {
+            return false;
+        }
+        std::vector<int> vsourceindices(gsource.dof), vtargetindices(gtarget.dof);
+        try {
+            for(int i = 0; i < gsource.dof; ++i) {
+                vsourceindices[i] = boost::lexical_cast<int>(sourcetokens[i+2]);
+            }
+            for(int i = 0; i < gtarget.dof; ++i) {
+                vtargetindices[i] = boost::lexical_cast<int>(targettokens[i+2]);
+            }
+        }
+        catch(const boost::bad_lexical_cast&) {
+            return false;
+        }
+        for(int targetindex : vtargetindices) {
+            std::vector<int>::iterator it = find(vsourceindices.begin(),vsourceindices.end(),targetindex);
+            vtransferindices.push_back(it != vsourceindices.end() ? static_cast<int>(it-vsourceindices.begin()) : -1);
+        }
+        return true;
+    }
+    else if( targettokens[0].size() >= 13 && targettokens[0].substr(0,13) == "outputSignals" ) {
+        if( (int)sourcetokens.size() < gsource.dof+1 || (int)targettokens.size() < gtarget.dof+1 ) {
+            return false;
+        }
+        std::vector<std::string>::const_iterator itsourcebegin = sourcetokens.begin()+1, itsourceend = sourcetokens.begin()+1+gsource.dof;
+        for(int i = 0; i < gtarget.dof; ++i) {
+            std::vector<std::string>::const_iterator it = find(itsourcebegin,itsourceend,targettokens[i+1]);
+            vtransferindices.push_back(it != itsourceend ? static_cast<int>(it-itsourcebegin) : -1);
+        }
+        return true;
+    }
+    return false;
+}
+
+/// \brief fills the values of a target group that is not in the source, uses the current body values when the environment is available
+static void _FillDefaultGroupData(std::vector<dReal>::iterator ittargetdata, size_t targetstride, const ConfigurationSpecification::Group& gtarget, size_t numpoints, EnvironmentBaseConstPtr penv)
+{
+    vector<dReal> vdefaultvalues(gtarget.dof,0);
+    const string& name = gtarget.name;
+    if( name.size() >= 12 && name.substr(0,12) == "joint_values" ) {
+        string bodyname;
+        stringstream ss(name.substr(12));
+        ss >> bodyname;
+        if( !!ss ) {
+            if( !!penv ) {
+                KinBodyPtr body = penv->GetKinBody(bodyname);
+                if( !!body ) {
+                    vector<dReal> values;
+                    body->GetDOFValues(values);
+                    std::vector<int> indices((istream_iterator<int>(ss)), istream_iterator<int>());
+                    for(size_t i = 0; i < indices.size(); ++i) {
+                        vdefaultvalues.at(i) = values.at(indices[i]);
                     }
                 }
             }
-            else if( name.size() >= 16 && name.substr(0,16) == "affine_transform" ) {
-                string bodyname;
-                int affinedofs;
-                stringstream ss(name.substr(16));
-                ss >> bodyname >> affinedofs;
-                if( !!ss ) {
-                    Transform tdefault;
-                    if( !!penv ) {
-                        KinBodyPtr body = penv->GetKinBody(bodyname);
-                        if( !!body ) {
-                            tdefault = body->GetTransform();
-                        }
-                    }
-                    BOOST_ASSERT((int)vdefaultvalues.size() == RaveGetAffineDOF(affinedofs));
-                    RaveGetAffineDOFValuesFromTransform(vdefaultvalues.begin(),tdefault,affinedofs);
+        }
+    }
+    else if( name.size() >= 16 && name.substr(0,16) == "affine_transform" ) {
+        string bodyname;
+        int affinedofs;
+        stringstream ss(name.substr(16));
+        ss >> bodyname >> affinedofs;
+        if( !!ss ) {
+            Transform tdefault;
+            if( !!penv ) {
+                KinBodyPtr body = penv->GetKinBody(bodyname);
+                if( !!body ) {
+                    tdefault = body->GetTransform();
                 }
             }
-            else if( name.size() >= 13 && name.substr(0,13) == "outputSignals") {
-                std::fill(vdefaultvalues.begin(), vdefaultvalues.end(), -1);
+            BOOST_ASSERT((int)vdefaultvalues.size() == RaveGetAffineDOF(affinedofs));
+            RaveGetAffineDOFValuesFromTransform(vdefaultvalues.begin(),tdefault,affinedofs);
+        }
+    }
+    else if( name.size() >= 13 && name.substr(0,13) == "outputSignals") {
+        std::fill(vdefaultvalues.begin(), vdefaultvalues.end(), -1);
+    }
+    else if( name != "deltatime" ) {
+        // messages are too frequent
+        //RAVELOG_VERBOSE(str(boost::format("cannot initialize unknown group '%s'")%name));
+    }
+    int offset = gtarget.offset;
+    for(size_t i = 0; i < numpoints; ++i, offset += targetstride) {
+        for(size_t j = 0; j < vdefaultvalues.size(); ++j) {
+            *(ittargetdata+offset+j) = vdefaultvalues[j];
+        }
+    }
+}
+
+ConfigurationSpecification::ConversionPlan::ConversionPlan(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, bool filluninitialized, bool fillmissinggroups) : _vtargetgroups(targetspec._vgroups), _vsourcegroups(sourcespec._vgroups), _targetdof(targetspec.GetDOF()), _sourcedof(sourcespec.GetDOF()), _targethash(GetSpecificationHash(targetspec)), _sourcehash(GetSpecificationHash(sourcespec)), _filluninitialized(filluninitialized), _fillmissinggroups(fillmissinggroups)
+{
+    // collect every copied value, then merge the values that are contiguous in both the target and the source
+    std::vector<CopyRun> vcopyvalues;
+    std::vector<int> vtransferindices;
+    for(int igroup = 0; igroup < (int)_vtargetgroups.size(); ++igroup) {
+        const Group& gtarget = _vtargetgroups[igroup];
+        std::vector<Group>::const_iterator itcompatgroup = sourcespec.FindCompatibleGroup(gtarget);
+        if( itcompatgroup == sourcespec._vgroups.end() ) {
+            _vmissinggroups.push_back(igroup);
+            continue;
+        }
+
+        bool bcopy = _GetGroupTransferIndices(gtarget, *itcompatgroup, vtransferindices);
+        if( bcopy && filluninitialized && find(vtransferindices.begin(), vtransferindices.end(), -1) != vtransferindices.end() ) {
+            // the uninitialized values are filled from the environment
+            bcopy = false;
+        }
+        if( !bcopy ) {
+            _vconvertgroups.emplace_back(igroup, static_cast<int>(itcompatgroup-sourcespec._vgroups.begin()));
+            continue;
+        }
+
+        for(int j = 0; j < (int)vtransferindices.size(); ++j) {
+            if( vtransferindices[j] >= 0 ) {
+                CopyRun copyvalue;
+                copyvalue.targetoffset = gtarget.offset+j;
+                copyvalue.sourceoffset = itcompatgroup->offset+vtransferindices[j];
+                copyvalue.dof = 1;
+                vcopyvalues.push_back(copyvalue);
+            }
+        }
+    }
+
+    std::sort(vcopyvalues.begin(), vcopyvalues.end(), [](const CopyRun& a, const CopyRun& b) {
+        return a.targetoffset < b.targetoffset;
+    });
+    for(const CopyRun& copyvalue : vcopyvalues) {
+        if( _vcopyruns.size() > 0 && _vcopyruns.back().targetoffset+_vcopyruns.back().dof == copyvalue.targetoffset && _vcopyruns.back().sourceoffset+_vcopyruns.back().dof == copyvalue.sourceoffset ) {
+            _vcopyruns.back().dof += 1;
+        }
+        else {
+            _vcopyruns.push_back(copyvalue);
+        }
+    }
+}
+
+bool ConfigurationSpecification::ConversionPlan::IsCompatible(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, bool filluninitialized, bool fillmissinggroups) const
+{
+    return IsCompatible(targetspec, GetSpecificationHash(targetspec), sourcespec, GetSpecificationHash(sourcespec), filluninitialized, fillmissinggroups);
+}
+
+bool ConfigurationSpecification::ConversionPlan::IsCompatible(const ConfigurationSpecification& targetspec, size_t targethash, const ConfigurationSpecification& sourcespec, size_t sourcehash, bool filluninitialized, bool fillmissinggroups) const
+{
+    // the hashes can collide, so equal hashes still compare the groups
+    return _filluninitialized == filluninitialized && _fillmissinggroups == fillmissinggroups && _targethash == targethash && _sourcehash == sourcehash && _vtargetgroups == targetspec._vgroups && _vsourcegroups == sourcespec._vgroups;
+}
+
+size_t ConfigurationSpecification::ConversionPlan::GetSpecificationHash(const ConfigurationSpecification& spec)
+{
+    size_t seed = spec._vgroups.size();
+    for(const Group& g : spec._vgroups) {
+        boost::hash_combine(seed, g.offset);
+        boost::hash_combine(seed, g.dof);
+        boost::hash_combine(seed, g.name);
+        boost::hash_combine(seed, g.interpolation);
+    }
+    return seed;
+}
+
+void ConfigurationSpecification::ConversionPlan::Convert(std::vector<dReal>::iterator ittargetdata, const dReal* psourcedata, size_t numpoints, EnvironmentBaseConstPtr penv) const
+{
+    if( numpoints == 0 ) {
+        return;
+    }
+    if( _vcopyruns.size() == 1 && _vcopyruns[0].targetoffset == 0 && _vcopyruns[0].sourceoffset == 0 && _vcopyruns[0].dof == _targetdof && _targetdof == _sourcedof ) {
+        // same layout, so all the points are one contiguous block
+        std::copy(psourcedata, psourcedata+numpoints*_sourcedof, ittargetdata);
+    }
+    else if( _vcopyruns.size() > 0 ) {
+        std::vector<dReal>::iterator ittarget = ittargetdata;
+        const dReal* psource = psourcedata;
+        for(size_t ipoint = 0; ipoint < numpoints; ++ipoint) {
+            if( ipoint != 0 ) {
+                ittarget += _targetdof;
+                psource += _sourcedof;
             }
-            else if( name != "deltatime" ) {
-                // messages are too frequent
-                //RAVELOG_VERBOSE(str(boost::format("cannot initialize unknown group '%s'")%name));
+            for(const CopyRun& copyrun : _vcopyruns) {
+                std::copy(psource+copyrun.sourceoffset, psource+copyrun.sourceoffset+copyrun.dof, ittarget+copyrun.targetoffset);
             }
-            int offset = targetspec._vgroups[igroup].offset;
-            for(size_t i = 0; i < numpoints; ++i, offset += targetspec.GetDOF()) {
-                for(size_t j = 0; j < vdefaultvalues.size(); ++j) {
-                    *(ittargetdata+offset+j) = vdefaultvalues[j];
-                }
+        }
+    }
+
+    for(const std::pair<int, int>& convertgroup : _vconvertgroups) {
+        const Group& gtarget = _vtargetgroups[convertgroup.first];
+        const Group& gsource = _vsourcegroups[convertgroup.second];
+        ConfigurationSpecification::ConvertGroupData(ittargetdata+gtarget.offset, _targetdof, gtarget, psourcedata+gsource.offset, _sourcedof, gsource, numpoints, penv, _filluninitialized);
+    }
+
+    if( _filluninitialized && _fillmissinggroups ) {
+        for(int igroup : _vmissinggroups) {
+            _FillDefaultGroupData(ittargetdata, _targetdof, _vtargetgroups[igroup], numpoints, penv);
+        }
+    }
+}
+
+ConfigurationSpecification::ConversionPlanConstPtr ConfigurationSpecification::GetConversionPlan(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, bool filluninitialized)
+{
+    // plans of the calling thread, the most recently used is at the back
+    static thread_local std::vector<ConversionPlanConstPtr> s_vrecentplans;
+    static const size_t s_nMaxRecentPlans = 16;
+    const size_t targethash = ConversionPlan::GetSpecificationHash(targetspec), sourcehash = ConversionPlan::GetSpecificationHash(sourcespec);
+    for(int iplan = (int)s_vrecentplans.size()-1; iplan >= 0; --iplan) {
+        if( s_vrecentplans[iplan]->IsCompatible(targetspec, targethash, sourcespec, sourcehash, filluninitialized, filluninitialized) ) {
+            ConversionPlanConstPtr pplan = s_vrecentplans[iplan];
+            if( iplan+1 != (int)s_vrecentplans.size() ) {
+                s_vrecentplans.erase(s_vrecentplans.begin()+iplan);
+                s_vrecentplans.push_back(pplan);
             }
+            return pplan;
         }
     }
+
+    ConversionPlanConstPtr pplan(new ConversionPlan(targetspec, sourcespec, filluninitialized, filluninitialized));
+    if( s_vrecentplans.size() >= s_nMaxRecentPlans ) {
+        s_vrecentplans.erase(s_vrecentplans.begin());
+    }
+    s_vrecentplans.push_back(pplan);
+    return pplan;
+}
+
+void ConfigurationSpecification::ConvertData(std::vector<dReal>::iterator ittargetdata, const ConfigurationSpecification &targetspec, std::vector<dReal>::const_iterator itsourcedata, const ConfigurationSpecification &sourcespec, size_t numpoints, EnvironmentBaseConstPtr penv, bool filluninitialized)
+{
+    if( numpoints == 0 ) {
+        return;
+    }
+    GetConversionPlan(targetspec, sourcespec, filluninitialized)->Convert(ittargetdata, sourcespec.GetDOF() > 0 ? &(*itsourcedata) : NULL, numpoints, penv);
 }
 
 std::string ConfigurationSpecification::GetInterpolationDerivative(const std::string& interpolation, int deriv)
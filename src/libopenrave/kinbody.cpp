@@ -2120,6 +2120,7 @@ void KinBody::SetDOFValues(const std::vector<dReal>& vJointValues, uint32_t chec
 void KinBody::SetDOFValues(const dReal* pJointValues, int dof, uint32_t checklimits, const std::vector<int>& dofindices)
 {
     CHECK_INTERNAL_COMPUTATION;
+    OPENRAVE_PROFILE_SCOPE("kinbody.SetDOFValues");
     if( dof == 0 || _veclinks.size() == 0) {
         return;
     }
@@ -3466,37 +3467,136 @@ void KinBody::ComputeHessianAxisAngle(int linkindex, std::vector<dReal>& hessian
 void KinBody::ComputeInverseDynamics(std::vector<dReal>& doftorques, const std::vector<dReal>& vDOFAccelerations, const KinBody::ForceTorqueMap& mapExternalForceTorque) const
 {
     CHECK_INTERNAL_COMPUTATION;
+    _ComputeInverseDynamics(doftorques, vDOFAccelerations, mapExternalForceTorque, GetEnv()->GetPhysicsEngine()->GetGravity(), true, true);
+}
+
+void KinBody::ComputeInverseDynamicsBatch(std::vector<dReal>& doftorques, const std::vector<dReal>& vDOFValues, const std::vector<dReal>& vDOFVelocities, const std::vector<dReal>& vDOFAccelerations, const KinBody::ForceTorqueMap& mapExternalForceTorque)
+{
+    CHECK_INTERNAL_COMPUTATION;
+    const int dof = GetDOF();
+    if( dof == 0 ) {
+        doftorques.resize(0);
+        return;
+    }
+    OPENRAVE_ASSERT_OP_FORMAT((int)(vDOFValues.size()%dof), ==, 0, "env=%s, body %s dof values size %d is not a multiple of dof %d", GetEnv()->GetNameId()%GetName()%vDOFValues.size()%dof, ORE_InvalidArguments);
+    const size_t numsamples = vDOFValues.size()/dof;
+    OPENRAVE_ASSERT_FORMAT(vDOFVelocities.size() == 0 || vDOFVelocities.size() == vDOFValues.size(), "env=%s, body %s dof velocities size %d does not match dof values size %d", GetEnv()->GetNameId()%GetName()%vDOFVelocities.size()%vDOFValues.size(), ORE_InvalidArguments);
+    OPENRAVE_ASSERT_FORMAT(vDOFAccelerations.size() == 0 || vDOFAccelerations.size() == vDOFValues.size(), "env=%s, body %s dof accelerations size %d does not match dof values size %d", GetEnv()->GetNameId()%GetName()%vDOFAccelerations.size()%vDOFValues.size(), ORE_InvalidArguments);
+
+    doftorques.resize(numsamples*dof);
+    KinBodyStateSaver saver(shared_kinbody(), Save_LinkTransformation|Save_LinkVelocities);
+    const Vector vgravity = GetEnv()->GetPhysicsEngine()->GetGravity();
+    std::vector<dReal>& vsamplevelocities = _vDynamicsSampleVelocitiesCache;
+    std::vector<dReal>& vsampleaccelerations = _vDynamicsSampleAccelerationsCache;
+    std::vector<dReal>& vsampletorques = _vDynamicsSampleTorquesCache;
+    vsamplevelocities.resize(dof);
+    if( vDOFVelocities.size() == 0 ) {
+        std::fill(vsamplevelocities.begin(), vsamplevelocities.end(), 0);
+    }
+    vsampleaccelerations.resize(vDOFAccelerations.size() > 0 ? dof : 0);
+    for(size_t isample = 0; isample < numsamples; ++isample) {
+        SetDOFValues(&vDOFValues[isample*dof], dof, CLA_Nothing);
+        if( vDOFVelocities.size() > 0 ) {
+            std::copy(vDOFVelocities.begin()+isample*dof, vDOFVelocities.begin()+(isample+1)*dof, vsamplevelocities.begin());
+        }
+        SetDOFVelocities(vsamplevelocities, CLA_Nothing);
+        if( vDOFAccelerations.size() > 0 ) {
+            std::copy(vDOFAccelerations.begin()+isample*dof, vDOFAccelerations.begin()+(isample+1)*dof, vsampleaccelerations.begin());
+        }
+        _ComputeInverseDynamics(vsampletorques, vsampleaccelerations, mapExternalForceTorque, vgravity, true, true);
+        std::copy(vsampletorques.begin(), vsampletorques.end(), doftorques.begin()+isample*dof);
+    }
+}
+
+void KinBody::ComputeMassMatrix(std::vector<dReal>& vMassMatrix) const
+{
+    CHECK_INTERNAL_COMPUTATION;
+    const int dof = GetDOF();
+    vMassMatrix.resize(dof*dof);
+    std::vector<dReal>& vunitaccelerations = _vDynamicsSampleAccelerationsCache;
+    std::vector<dReal>& vcolumn = _vDynamicsSampleTorquesCache;
+    vunitaccelerations.resize(dof);
+    std::fill(vunitaccelerations.begin(), vunitaccelerations.end(), 0);
+    const ForceTorqueMap mapNoExternalForceTorque;
+    // column i of M is the torque needed for a unit acceleration of dof i with no velocity and no gravity
+    for(int idof = 0; idof < dof; ++idof) {
+        vunitaccelerations[idof] = 1;
+        _ComputeInverseDynamics(vcolumn, vunitaccelerations, mapNoExternalForceTorque, Vector(), false, false);
+        vunitaccelerations[idof] = 0;
+        for(int jdof = 0; jdof < dof; ++jdof) {
+            vMassMatrix[jdof*dof+idof] = vcolumn[jdof];
+        }
+    }
+    // remove numerical asymmetry
+    for(int idof = 0; idof < dof; ++idof) {
+        for(int jdof = idof+1; jdof < dof; ++jdof) {
+            dReal f = 0.5*(vMassMatrix[idof*dof+jdof] + vMassMatrix[jdof*dof+idof]);
+            vMassMatrix[idof*dof+jdof] = f;
+            vMassMatrix[jdof*dof+idof] = f;
+        }
+    }
+}
+
+void KinBody::ComputeCoriolisTorques(std::vector<dReal>& vCoriolisTorques) const
+{
+    CHECK_INTERNAL_COMPUTATION;
+    _ComputeInverseDynamics(vCoriolisTorques, std::vector<dReal>(), ForceTorqueMap(), Vector(), true, false);
+}
+
+void KinBody::ComputeGravityTorques(std::vector<dReal>& vGravityTorques) const
+{
+    CHECK_INTERNAL_COMPUTATION;
+    _ComputeInverseDynamics(vGravityTorques, std::vector<dReal>(), ForceTorqueMap(), GetEnv()->GetPhysicsEngine()->GetGravity(), false, false);
+}
+
+void KinBody::_ComputeInverseDynamics(std::vector<dReal>& doftorques, const std::vector<dReal>& vDOFAccelerations, const KinBody::ForceTorqueMap& mapExternalForceTorque, const Vector& vgravity, bool bUseVelocities, bool bAddFriction) const
+{
     doftorques.resize(GetDOF());
     if( _vecjoints.size() == 0 ) {
         return;
     }
 
-    Vector vgravity = GetEnv()->GetPhysicsEngine()->GetGravity();
-    std::vector<dReal> vDOFVelocities;
-    std::vector<pair<Vector, Vector> > vLinkVelocities, vLinkAccelerations; // linear, angular
-    _ComputeDOFLinkVelocities(vDOFVelocities, vLinkVelocities);
-    // check if all velocities are 0, if yes, then can simplify some computations since only have contributions from dofacell and external forces
+    std::vector<dReal>& vDOFVelocities = _vDynamicsDOFVelocitiesCache;
+    std::vector<pair<Vector, Vector> >& vLinkVelocities = _vDynamicsLinkVelocitiesCache; // linear, angular
+    std::vector<pair<Vector, Vector> >& vLinkAccelerations = _vDynamicsLinkAccelerationsCache;
     bool bHasVelocity = false;
-    FOREACH(it,vDOFVelocities) {
-        if( RaveFabs(*it) > g_fEpsilonLinear ) {
-            bHasVelocity = true;
-            break;
+    if( bUseVelocities ) {
+        _ComputeDOFLinkVelocities(vDOFVelocities, vLinkVelocities);
+        // check if all velocities are 0, if yes, then can simplify some computations since only have contributions from dofacell and external forces
+        FOREACH(it,vDOFVelocities) {
+            if( RaveFabs(*it) > g_fEpsilonLinear ) {
+                bHasVelocity = true;
+                break;
+            }
         }
     }
+    else {
+        vLinkVelocities.resize(_veclinks.size());
+        std::fill(vLinkVelocities.begin(), vLinkVelocities.end(), std::make_pair(Vector(), Vector()));
+    }
     if( !bHasVelocity ) {
         vDOFVelocities.resize(0);
     }
-    AccelerationMap externalaccelerations;
-    externalaccelerations[0] = make_pair(-vgravity, Vector());
-    AccelerationMapPtr pexternalaccelerations(&externalaccelerations, utils::null_deleter());
-    _ComputeLinkAccelerations(vDOFVelocities, vDOFAccelerations, vLinkVelocities, vLinkAccelerations, pexternalaccelerations);
+
+    // the map is kept between calls so that setting the gravity does not allocate
+    if( !_pDynamicsExternalAccelerationsCache ) {
+        _pDynamicsExternalAccelerationsCache.reset(new AccelerationMap());
+    }
+    _pDynamicsExternalAccelerationsCache->clear();
+    (*_pDynamicsExternalAccelerationsCache)[0] = make_pair(-vgravity, Vector());
+    vLinkAccelerations.resize(_veclinks.size());
+    std::fill(vLinkAccelerations.begin(), vLinkAccelerations.end(), std::make_pair(Vector(), Vector())); // _ComputeLinkAccelerations accumulates into the base
+    _ComputeLinkAccelerations(vDOFVelocities, vDOFAccelerations, vLinkVelocities, vLinkAccelerations, _pDynamicsExternalAccelerationsCache);
 
     // all valuess are in the global coordinate system
     // Given the velocity/acceleration of the object is on point A, to change to B do:
     // v_B = v_A + angularvel x (B-A)
     // a_B = a_A + angularaccel x (B-A) + angularvel x (angularvel x (B-A))
     // forward recursion
-    std::vector<Vector> vLinkCOMLinearAccelerations(_veclinks.size()), vLinkCOMMomentOfInertia(_veclinks.size());
+    std::vector<Vector>& vLinkCOMLinearAccelerations = _vDynamicsLinkCOMLinearAccelerationsCache;
+    std::vector<Vector>& vLinkCOMMomentOfInertia = _vDynamicsLinkCOMMomentOfInertiaCache;
+    vLinkCOMLinearAccelerations.resize(_veclinks.size());
+    vLinkCOMMomentOfInertia.resize(_veclinks.size());
     for(size_t i = 0; i < vLinkVelocities.size(); ++i) {
         Vector vglobalcomfromlink = _veclinks.at(i)->GetGlobalCOM() - _veclinks.at(i)->_info._t.trans;
         Vector vangularaccel = vLinkAccelerations.at(i).second;
@@ -3507,15 +3607,16 @@ void KinBody::ComputeInverseDynamics(std::vector<dReal>& doftorques, const std::
     }
 
     // backward recursion
-    std::vector< std::pair<Vector, Vector> > vLinkForceTorques(_veclinks.size());
+    std::vector< std::pair<Vector, Vector> >& vLinkForceTorques = _vDynamicsLinkForceTorquesCache;
+    vLinkForceTorques.resize(_veclinks.size());
+    std::fill(vLinkForceTorques.begin(), vLinkForceTorques.end(), std::make_pair(Vector(), Vector()));
     FOREACHC(it,mapExternalForceTorque) {
         vLinkForceTorques.at(it->first) = it->second;
     }
     std::fill(doftorques.begin(),doftorques.end(),0);
 
-    std::vector<std::pair<int,dReal> > vDofindexDerivativePairs;
+    std::vector<std::pair<int,dReal> >& vDofindexDerivativePairs = _vDynamicsPartialsCache;
     std::map< std::pair<Mimic::DOFFormat, int>, dReal > mapcachedpartials;
-
     // go backwards
     for(size_t ijoint = 0; ijoint < _vTopologicallySortedJointsAll.size(); ++ijoint) {
         JointPtr pjoint = _vTopologicallySortedJointsAll.at(_vTopologicallySortedJointsAll.size()-1-ijoint);
@@ -3547,7 +3648,7 @@ void KinBody::ComputeInverseDynamics(std::vector<dReal>& doftorques, const std::
             // see if any friction needs to be added. Only add if the velocity is non-zero since with zero velocity do not know the exact torque on the joint...
             if( !!pjoint->_info._infoElectricMotor ) {
                 const ElectricMotorActuatorInfoPtr pActuatorInfo = pjoint->_info._infoElectricMotor;
-                if( pjoint->GetDOFIndex() < (int)vDOFVelocities.size() ) {
+                if( bAddFriction && pjoint->GetDOFIndex() < (int)vDOFVelocities.size() ) {
                     if( vDOFVelocities.at(pjoint->GetDOFIndex()) > g_fEpsilonLinear ) {
                         fFriction += pActuatorInfo->coloumb_friction;
                     }
@@ -3557,7 +3658,7 @@ void KinBody::ComputeInverseDynamics(std::vector<dReal>& doftorques, const std::
                     fFriction += vDOFVelocities.at(pjoint->GetDOFIndex())*pActuatorInfo->viscous_friction;
 
                 }
-                if (pActuatorInfo->rotor_inertia > 0.0) {
+                if (pActuatorInfo->rotor_inertia > 0.0 && pjoint->GetDOFIndex() < (int)vDOFAccelerations.size()) {
                     // converting inertia on motor side to load side requires multiplying by gear ratio squared because inertia unit is mass * distance^2
                     const dReal fInertiaOnLoadSide = pActuatorInfo->rotor_inertia * pActuatorInfo->gear_ratio * pActuatorInfo->gear_ratio;
                     fRotorAccelerationTorque += vDOFAccelerations.at(pjoint->GetDOFIndex()) * fInertiaOnLoadSide;
@@ -3896,7 +3997,9 @@ void KinBody::_ComputeLinkAccelerations(const std::vector<dReal>& vDOFVelocities
 
     Transform tdelta;
     Vector vlocalaxis;
-    std::vector<uint8_t> vlinkscomputed(_veclinks.size(),0);
+    std::vector<uint8_t>& vlinkscomputed = _vLinksAccelerationComputedCache;
+    vlinkscomputed.resize(_veclinks.size());
+    std::fill(vlinkscomputed.begin(), vlinkscomputed.end(), 0);
     vlinkscomputed[0] = 1;
 
     // compute the link accelerations going through topological order
@@ -5506,6 +5609,8 @@ void KinBody::_ResetInternalCollisionCache()
     FOREACH(it,_vNonAdjacentLinks) {
         it->resize(0);
     }
+    _vLinkPairCulling.clear();
+    _vLinkPairCullingIndices.clear();
 }
 
 bool CompareNonAdjacentFarthest(int pair0, int pair1)
@@ -5906,6 +6011,11 @@ void KinBody::_PostprocessChangedParameters(uint32_t parameters)
     if( (parameters&Prop_LinkEnable) == Prop_LinkEnable ) {
     }
 
+    // link pair culling depends on the geometry and the joint ranges
+    if( _vLinkPairCullingIndices.size() > 0 && !!(parameters & (Prop_LinkGeometry|Prop_LinkGeometryGroup|Prop_JointLimits|Prop_JointOffset)) ) {
+        _ResetInternalCollisionCache();
+    }
+
     std::list<UserDataWeakPtr> listRegisteredCallbacks;
     uint32_t index = 0;
     while(parameters && index < _vlistRegisteredCallbacks.size()) {
@@ -18,8 +18,11 @@
 
 namespace OpenRAVE {
 
+static const size_t s_nMaxLinkPairCullingDOF = 16; ///< link pairs moved relative to each other by more dofs are not culled, bounds on the distance are too loose to prove anything
+
 bool KinBody::CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const
 {
+    OPENRAVE_PROFILE_SCOPE("collision.CheckSelfCollision");
     if( !collisionchecker ) {
         collisionchecker = _selfcollisionchecker;
         if( !collisionchecker ) {
@@ -507,4 +510,233 @@ bool KinBody::CheckLinkSelfCollision(int ilinkindex, const Transform& tlinktrans
     return bincollision;
 }
 
+int KinBody::ComputeSelfCollisionLinkPairCulling(int maxevaluations)
+{
+    OPENRAVE_ASSERT_FORMAT(_nHierarchyComputed == 2, "env=%s, body %s internal structures need to be computed", GetEnv()->GetNameId()%GetName(), ORE_NotInitialized);
+    _ResetInternalCollisionCache(); // start from the full list of non-adjacent links
+    const std::vector<int> vnonadjacentlinks = GetNonAdjacentLinks(0);
+    if( _vClosedLoops.size() > 0 ) {
+        RAVELOG_WARN_FORMAT("env=%s, body %s has closed loops, cannot compute link pair culling", GetEnv()->GetNameId()%GetName());
+        return 0;
+    }
+    for(const JointPtr& pjoint : _vecjoints) {
+        if( pjoint->IsMimic() ) {
+            RAVELOG_WARN_FORMAT("env=%s, body %s has mimic joint %s, cannot compute link pair culling", GetEnv()->GetNameId()%GetName()%pjoint->GetName());
+            return 0;
+        }
+    }
+    for(const JointPtr& pjoint : _vPassiveJoints) {
+        if( pjoint->IsMimic() ) {
+            RAVELOG_WARN_FORMAT("env=%s, body %s has mimic joint %s, cannot compute link pair culling", GetEnv()->GetNameId()%GetName()%pjoint->GetName());
+            return 0;
+        }
+    }
+
+    const int numlinks = _veclinks.size();
+    KinBodyStateSaver saver(shared_kinbody(), Save_LinkTransformation);
+
+    // bounding sphere of every link in its local frame, negative radius if the link has no geometry
+    std::vector<Vector> vlocalcenters(numlinks);
+    std::vector<dReal> vradii(numlinks, -1);
+    for(int ilink = 0; ilink < numlinks; ++ilink) {
+        if( _veclinks[ilink]->GetGeometries().size() > 0 ) {
+            const AABB ab = _veclinks[ilink]->ComputeLocalAABB();
+            vlocalcenters[ilink] = ab.pos;
+            vradii[ilink] = RaveSqrt(ab.extents.lengthsqr3());
+        }
+    }
+
+    std::vector<dReal> vdoflower, vdofupper;
+    GetDOFLimits(vdoflower, vdofupper);
+
+    _vLinkPairCullingIndices.resize(numlinks*numlinks);
+    std::fill(_vLinkPairCullingIndices.begin(), _vLinkPairCullingIndices.end(), -1);
+    std::vector<int> vremainingpairs;
+    vremainingpairs.reserve(vnonadjacentlinks.size());
+    LinkPairCulling culling;
+    std::vector<dReal> vlipschitz, vvalues, vcells, vcell;
+    std::vector<JointPtr> vchainjoints;
+    for(int pair : vnonadjacentlinks) {
+        const int ilink0 = pair&0xffff, ilink1 = (pair>>16)&0xffff;
+        if( vradii[ilink0] < 0 || vradii[ilink1] < 0 ) {
+            continue; // a link without geometry cannot collide
+        }
+
+        // only the dofs moving one link relative to the other change the distance between the links
+        culling.vdofindices.resize(0);
+        culling.vlower.resize(0);
+        culling.vupper.resize(0);
+        culling.vcircular.resize(0);
+        culling.vnodes.resize(0);
+        vlipschitz.resize(0);
+        bool bSupported = true;
+        for(int idof = 0; idof < GetDOF() && bSupported; ++idof) {
+            const bool bAffects0 = DoesDOFAffectLink(idof, ilink0) != 0;
+            const bool bAffects1 = DoesDOFAffectLink(idof, ilink1) != 0;
+            if( bAffects0 == bAffects1 ) {
+                continue;
+            }
+            const JointPtr& pjoint = _vecjoints.at(_vDOFIndices.at(idof));
+            if( pjoint->GetDOF() != 1 || !(pjoint->IsRevolute(0) || pjoint->IsPrismatic(0)) ) {
+                bSupported = false;
+                break;
+            }
+            dReal flower = vdoflower.at(idof), fupper = vdofupper.at(idof);
+            if( pjoint->IsCircular(0) ) {
+                flower = -PI;
+                fupper = PI;
+            }
+
+            // bound on how much the sphere center of the moving link can move when the dof changes by one
+            dReal flipschitz = 1;
+            if( pjoint->IsRevolute(0) ) {
+                // distance from the joint axis is bounded by the length of the chain of anchors to the sphere center. prismatic joints in the chain can extend it by their range
+                const int imovinglink = bAffects0 ? ilink0 : ilink1;
+                if( !GetChain(pjoint->GetHierarchyChildLink()->GetIndex(), imovinglink, vchainjoints) ) {
+                    bSupported = false;
+                    break;
+                }
+                flipschitz = 0;
+                Vector vprevanchor = pjoint->GetAnchor();
+                for(const JointPtr& pchainjoint : vchainjoints) {
+                    const Vector vanchor = pchainjoint->GetAnchor();
+                    flipschitz += RaveSqrt((vanchor - vprevanchor).lengthsqr3());
+                    if( pchainjoint->GetDOF() > 0 && pchainjoint->GetDOFIndex() >= 0 && pchainjoint->IsPrismatic(0) ) {
+                        flipschitz += vdofupper.at(pchainjoint->GetDOFIndex()) - vdoflower.at(pchainjoint->GetDOFIndex());
+                    }
+                    vprevanchor = vanchor;
+                }
+                flipschitz += RaveSqrt((_veclinks[imovinglink]->GetTransform()*vlocalcenters[imovinglink] - vprevanchor).lengthsqr3());
+            }
+            if( !std::isfinite(fupper - flower) || !std::isfinite(flipschitz) ) {
+                bSupported = false;
+                break;
+            }
+            culling.vdofindices.push_back(idof);
+            culling.vlower.push_back(flower);
+            culling.vupper.push_back(fupper);
+            culling.vcircular.push_back(pjoint->IsCircular(0));
+            vlipschitz.push_back(flipschitz);
+        }
+        if( !bSupported || culling.vdofindices.size() > s_nMaxLinkPairCullingDOF ) {
+            vremainingpairs.push_back(pair);
+            continue;
+        }
+        if( culling.vdofindices.size() == 0 ) {
+            continue; // relative pose is fixed and the pair was not colliding at the initial configuration
+        }
+
+        // breadth-first subdivision of the dof ranges. vcells holds the lower values followed by the upper values of every node
+        const int ndof = culling.vdofindices.size();
+        vvalues.resize(ndof);
+        vcell.resize(2*ndof);
+        vcells.resize(0);
+        vcells.insert(vcells.end(), culling.vlower.begin(), culling.vlower.end());
+        vcells.insert(vcells.end(), culling.vupper.begin(), culling.vupper.end());
+        LinkPairCullingNode root;
+        root.splitvalue = 0;
+        root.firstchild = -1;
+        root.splitdof = 0;
+        root.bCollisionFree = 0;
+        culling.vnodes.push_back(root);
+        int numfree = 0;
+        for(int inode = 0, numevaluations = 0; inode < (int)culling.vnodes.size() && numevaluations < maxevaluations; ++inode, ++numevaluations) {
+            std::copy(vcells.begin() + 2*ndof*inode, vcells.begin() + 2*ndof*(inode+1), vcell.begin());
+            dReal fmaxchange = 0, fbestwidth = 0;
+            int ibestdof = -1;
+            for(int idof = 0; idof < ndof; ++idof) {
+                vvalues[idof] = 0.5*(vcell[idof] + vcell[ndof+idof]);
+                const dReal fwidth = (vcell[ndof+idof] - vcell[idof])*vlipschitz[idof];
+                fmaxchange += 0.5*fwidth;
+                if( fwidth > fbestwidth ) {
+                    fbestwidth = fwidth;
+                    ibestdof = idof;
+                }
+            }
+            SetDOFValues(vvalues, CLA_Nothing, culling.vdofindices);
+            const Vector vcenter0 = _veclinks[ilink0]->GetTransform()*vlocalcenters[ilink0];
+            const Vector vcenter1 = _veclinks[ilink1]->GetTransform()*vlocalcenters[ilink1];
+            const dReal fgap = RaveSqrt((vcenter0 - vcenter1).lengthsqr3()) - vradii[ilink0] - vradii[ilink1];
+            if( fgap > fmaxchange ) {
+                culling.vnodes[inode].bCollisionFree = 1;
+                ++numfree;
+                continue;
+            }
+            if( ibestdof < 0 || fbestwidth <= g_fEpsilonLinear ) {
+                continue;
+            }
+
+            LinkPairCullingNode child = root;
+            culling.vnodes[inode].firstchild = culling.vnodes.size();
+            culling.vnodes[inode].splitdof = ibestdof;
+            culling.vnodes[inode].splitvalue = vvalues[ibestdof];
+            culling.vnodes.push_back(child);
+            culling.vnodes.push_back(child);
+            vcell[ndof+ibestdof] = vvalues[ibestdof];
+            vcells.insert(vcells.end(), vcell.begin(), vcell.end());
+            vcell[ndof+ibestdof] = vcells[2*ndof*inode + ndof + ibestdof];
+            vcell[ibestdof] = vvalues[ibestdof];
+            vcells.insert(vcells.end(), vcell.begin(), vcell.end());
+        }
+
+        if( culling.vnodes[0].bCollisionFree ) {
+            continue; // cannot collide anywhere in the joint limits
+        }
+        vremainingpairs.push_back(pair);
+        if( numfree > 0 ) {
+            _vLinkPairCullingIndices[ilink0*numlinks+ilink1] = _vLinkPairCullingIndices[ilink1*numlinks+ilink0] = _vLinkPairCulling.size();
+            _vLinkPairCulling.push_back(culling);
+        }
+    }
+
+    const int numremoved = vnonadjacentlinks.size() - vremainingpairs.size();
+    // vremainingpairs keeps the order of vnonadjacentlinks, so no need to sort again
+    _vNonAdjacentLinks[0].swap(vremainingpairs);
+    for(size_t ioptions = 1; ioptions < _vNonAdjacentLinks.size(); ++ioptions) {
+        _vNonAdjacentLinks[ioptions].resize(0);
+    }
+    _nNonAdjacentLinkCache = 0;
+    if( _vLinkPairCulling.size() == 0 && numremoved == 0 ) {
+        _vLinkPairCullingIndices.clear(); // nothing to undo when the geometry changes
+    }
+    RAVELOG_DEBUG_FORMAT("env=%s, body %s removed %d/%d non-adjacent link pairs, %d pairs are culled depending on the dof values", GetEnv()->GetNameId()%GetName()%numremoved%vnonadjacentlinks.size()%_vLinkPairCulling.size());
+    return numremoved;
+}
+
+bool KinBody::IsLinkPairCollisionFree(int linkindex0, int linkindex1) const
+{
+    if( _vLinkPairCullingIndices.size() == 0 ) {
+        return false;
+    }
+    const int numlinks = _veclinks.size();
+    if( linkindex0 < 0 || linkindex0 >= numlinks || linkindex1 < 0 || linkindex1 >= numlinks ) {
+        return false;
+    }
+    const int32_t index = _vLinkPairCullingIndices[linkindex0*numlinks+linkindex1];
+    if( index < 0 ) {
+        return false;
+    }
+    const LinkPairCulling& culling = _vLinkPairCulling[index];
+    dReal vvalues[s_nMaxLinkPairCullingDOF];
+    for(size_t idof = 0; idof < culling.vdofindices.size(); ++idof) {
+        dReal fvalue = _vecjoints[_vDOFIndices[culling.vdofindices[idof]]]->GetValue(0);
+        if( culling.vcircular[idof] ) {
+            fvalue = culling.vlower[idof] + fmod(fvalue - culling.vlower[idof], 2*PI);
+            if( fvalue < culling.vlower[idof] ) {
+                fvalue += 2*PI;
+            }
+        }
+        if( fvalue < culling.vlower[idof] || fvalue > culling.vupper[idof] ) {
+            return false; // outside of the analyzed range
+        }
+        vvalues[idof] = fvalue;
+    }
+    int inode = 0;
+    while( culling.vnodes[inode].firstchild >= 0 ) {
+        const LinkPairCullingNode& node = culling.vnodes[inode];
+        inode = vvalues[node.splitdof] < node.splitvalue ? node.firstchild : node.firstchild + 1;
+    }
+    return !!culling.vnodes[inode].bCollisionFree;
+}
+
 } // end namespace OpenRAVE
@@ -18,8 +18,11 @@
 
 namespace OpenRAVE {
 
-KinBody::KinBodyStateSaver::KinBodyStateSaver(KinBodyPtr pbody, int options) : _pbody(pbody), _options(options), _bRestoreOnDestructor(true)
+KinBody::KinBodyStateSaver::KinBodyStateSaver(KinBodyPtr pbody, int options) : _pbody(pbody), _options(options), _nSavedUpdateStamp(0), _bRestoreOnDestructor(true)
 {
+    if( _options & Save_Lightweight ) {
+        _pbody->_AcquireStateSaverBuffers(_vLinkTransforms, _vdoflastsetvalues, _vEnabledLinks);
+    }
     if( _options & Save_LinkTransformation ) {
         _pbody->GetLinkTransformations(_vLinkTransforms, _vdoflastsetvalues);
     }
@@ -49,6 +52,7 @@ KinBody::KinBodyStateSaver::KinBodyStateSaver(KinBodyPtr pbody, int options) : _
     if( _options & Save_GrabbedBodies ) {
         _vGrabbedBodies = _pbody->_vGrabbedBodies;
     }
+    _nSavedUpdateStamp = _pbody->GetUpdateStamp();
 }
 
 KinBody::KinBodyStateSaver::~KinBodyStateSaver()
@@ -56,6 +60,9 @@ KinBody::KinBodyStateSaver::~KinBodyStateSaver()
     if( _bRestoreOnDestructor && !!_pbody && _pbody->GetEnvironmentBodyIndex() != 0 ) {
         _RestoreKinBody(_pbody);
     }
+    if( (_options & Save_Lightweight) && !!_pbody ) {
+        _pbody->_ReleaseStateSaverBuffers(_vLinkTransforms, _vdoflastsetvalues, _vEnabledLinks);
+    }
 }
 
 void KinBody::KinBodyStateSaver::Restore(boost::shared_ptr<KinBody> body)
@@ -166,7 +173,10 @@ void KinBody::KinBodyStateSaver::_RestoreKinBody(boost::shared_ptr<KinBody> pbod
         }
     }
     if( _options & Save_LinkTransformation ) {
-        pbody->SetLinkTransformations(_vLinkTransforms, _vdoflastsetvalues);
+        // with Save_Lightweight, skip restoring if nothing changed since the state was saved in order to avoid the change callbacks
+        if( !(_options & Save_Lightweight) || pbody != _pbody || pbody->GetUpdateStamp() != _nSavedUpdateStamp || pbody->_vGrabbedBodies.size() > 0 ) {
+            pbody->SetLinkTransformations(_vLinkTransforms, _vdoflastsetvalues);
+        }
 //        if( IS_DEBUGLEVEL(Level_Warn) ) {
 //            stringstream ss; ss << std::setprecision(std::numeric_limits<dReal>::digits10+1);
 //            ss << "restoring kinbody " << pbody->GetName() << " to values=[";
@@ -207,11 +217,17 @@ void KinBody::KinBodyStateSaver::_RestoreKinBody(boost::shared_ptr<KinBody> pbod
     if( _options & Save_JointResolutions ) {
         pbody->SetDOFResolutions(_vDOFResolutions);
     }
+    if( pbody == _pbody ) {
+        _nSavedUpdateStamp = pbody->GetUpdateStamp();
+    }
 }
 
 
-KinBody::KinBodyStateSaverRef::KinBodyStateSaverRef(KinBody& body, int options) : _body(body), _options(options), _bRestoreOnDestructor(true), _bReleased(false)
+KinBody::KinBodyStateSaverRef::KinBodyStateSaverRef(KinBody& body, int options) : _body(body), _options(options), _nSavedUpdateStamp(0), _bRestoreOnDestructor(true), _bReleased(false)
 {
+    if( _options & Save_Lightweight ) {
+        body._AcquireStateSaverBuffers(_vLinkTransforms, _vdoflastsetvalues, _vEnabledLinks);
+    }
     if( _options & Save_LinkTransformation ) {
         body.GetLinkTransformations(_vLinkTransforms, _vdoflastsetvalues);
     }
@@ -241,6 +257,7 @@ KinBody::KinBodyStateSaverRef::KinBodyStateSaverRef(KinBody& body, int options)
     if( _options & Save_JointResolutions ) {
         body.GetDOFResolutions(_vDOFResolutions);
     }
+    _nSavedUpdateStamp = body.GetUpdateStamp();
 }
 
 KinBody::KinBodyStateSaverRef::~KinBodyStateSaverRef()
@@ -248,6 +265,9 @@ KinBody::KinBodyStateSaverRef::~KinBodyStateSaverRef()
     if( _bRestoreOnDestructor && !_bReleased && _body.GetEnvironmentBodyIndex() != 0 ) {
         _RestoreKinBody(_body);
     }
+    if( (_options & Save_Lightweight) && !_bReleased ) {
+        _body._ReleaseStateSaverBuffers(_vLinkTransforms, _vdoflastsetvalues, _vEnabledLinks);
+    }
 }
 
 void KinBody::KinBodyStateSaverRef::Restore()
@@ -339,7 +359,10 @@ void KinBody::KinBodyStateSaverRef::_RestoreKinBody(KinBody& body)
         }
     }
     if( _options & Save_LinkTransformation ) {
-        body.SetLinkTransformations(_vLinkTransforms, _vdoflastsetvalues);
+        // with Save_Lightweight, skip restoring if nothing changed since the state was saved in order to avoid the change callbacks
+        if( !(_options & Save_Lightweight) || &body != &_body || body.GetUpdateStamp() != _nSavedUpdateStamp || body._vGrabbedBodies.size() > 0 ) {
+            body.SetLinkTransformations(_vLinkTransforms, _vdoflastsetvalues);
+        }
 //        if( IS_DEBUGLEVEL(Level_Warn) ) {
 //            stringstream ss; ss << std::setprecision(std::numeric_limits<dReal>::digits10+1);
 //            ss << "restoring kinbody " << body.GetName() << " to values=[";
@@ -380,6 +403,29 @@ void KinBody::KinBodyStateSaverRef::_RestoreKinBody(KinBody& body)
     if( _options & Save_JointResolutions ) {
         body.SetDOFResolutions(_vDOFResolutions);
     }
+    if( &body == &_body ) {
+        _nSavedUpdateStamp = body.GetUpdateStamp();
+    }
+}
+
+void KinBody::_AcquireStateSaverBuffers(std::vector<Transform>& vLinkTransforms, std::vector<dReal>& vdoflastsetvalues, std::vector<uint8_t>& vEnabledLinks)
+{
+    if( _vStateSaverBuffersPool.size() > 0 ) {
+        StateSaverBuffers& buffers = _vStateSaverBuffersPool.back();
+        vLinkTransforms.swap(buffers.vLinkTransforms);
+        vdoflastsetvalues.swap(buffers.vdoflastsetvalues);
+        vEnabledLinks.swap(buffers.vEnabledLinks);
+        _vStateSaverBuffersPool.pop_back();
+    }
+}
+
+void KinBody::_ReleaseStateSaverBuffers(std::vector<Transform>& vLinkTransforms, std::vector<dReal>& vdoflastsetvalues, std::vector<uint8_t>& vEnabledLinks)
+{
+    _vStateSaverBuffersPool.resize(_vStateSaverBuffersPool.size()+1); // only allocates when more savers are nested than ever before
+    StateSaverBuffers& buffers = _vStateSaverBuffersPool.back();
+    buffers.vLinkTransforms.swap(vLinkTransforms);
+    buffers.vdoflastsetvalues.swap(vdoflastsetvalues);
+    buffers.vEnabledLinks.swap(vEnabledLinks);
 }
 
 } // end namespace OpenRAVE
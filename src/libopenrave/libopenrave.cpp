@@ -30,6 +30,8 @@
 
 #include <locale>
 #include <set>
+#include <array>
+#include <unordered_map>
 
 #include "plugindatabase_virtual.h"
 #include "plugindatabase.h"
@@ -444,14 +446,6 @@ public:
             RAVELOG_WARN("failed to set to C locale: %s\n",e.what());
         }
 
-        // since initialization depends on _pdatabase, have pdatabase be local until it is complete
-#if OPENRAVE_STATIC_PLUGINS
-        boost::shared_ptr<RaveDatabase> pdatabase = boost::make_shared<StaticRaveDatabase>();
-#else
-        boost::shared_ptr<RaveDatabase> pdatabase = boost::make_shared<DynamicRaveDatabase>();
-#endif // OPENRAVE_STATIC_PLUGINS
-        pdatabase->Init();
-
         char* phomedir = getenv("OPENRAVE_HOME"); // getenv not thread-safe?
         if( phomedir == NULL ) {
 #ifndef _WIN32
@@ -469,6 +463,15 @@ public:
         CreateDirectory(_homedirectory.c_str(),NULL);
 #endif
 
+        // since initialization depends on _pdatabase, have pdatabase be local until it is complete.
+        // home directory has to be set before since the plugin manifest is cached there.
+#if OPENRAVE_STATIC_PLUGINS
+        boost::shared_ptr<RaveDatabase> pdatabase = boost::make_shared<StaticRaveDatabase>();
+#else
+        boost::shared_ptr<RaveDatabase> pdatabase = boost::make_shared<DynamicRaveDatabase>();
+#endif // OPENRAVE_STATIC_PLUGINS
+        pdatabase->Init(bLoadAllPlugins);
+
 #ifdef _WIN32
         const char* delim = ";";
 #else
@@ -2095,6 +2098,76 @@ AABB TriMesh::ComputeAABB() const
     return ab;
 }
 
+void TriMesh::Simplify(dReal fErrorTolerance, TriMesh& simplified) const
+{
+    BOOST_ASSERT(&simplified != this);
+    simplified.Clear();
+    if( vertices.size() == 0 || indices.size() < 3 ) {
+        return;
+    }
+    const AABB ab = ComputeAABB();
+    // any point of a cell is within the cell diagonal of the cluster mean
+    const dReal fCellSize = fErrorTolerance/RaveSqrt(dReal(3));
+    const dReal fMaxCells = dReal(1 << 21); // cell coordinates are packed into 21 bits each
+    if( fErrorTolerance <= 0 || 2*ab.extents.x >= fCellSize*fMaxCells || 2*ab.extents.y >= fCellSize*fMaxCells || 2*ab.extents.z >= fCellSize*fMaxCells ) {
+        simplified = *this;
+        return;
+    }
+
+    const Vector vmin = ab.pos - ab.extents;
+    const dReal fInvCellSize = 1/fCellSize;
+    std::unordered_map<uint64_t, int32_t> mapCellClusters;
+    std::vector<int32_t> vVertexClusters(vertices.size(), -1);
+    std::vector<int32_t> vClusterCounts;
+    for(size_t i = 0; i < indices.size(); ++i) {
+        const int32_t ivertex = indices[i];
+        if( vVertexClusters.at(ivertex) >= 0 ) {
+            continue;
+        }
+        const Vector v = (vertices[ivertex] - vmin)*fInvCellSize;
+        const uint64_t key = (uint64_t)v.x | ((uint64_t)v.y << 21) | ((uint64_t)v.z << 42);
+        std::unordered_map<uint64_t, int32_t>::iterator it = mapCellClusters.find(key);
+        if( it == mapCellClusters.end() ) {
+            it = mapCellClusters.emplace(key, (int32_t)simplified.vertices.size()).first;
+            simplified.vertices.push_back(Vector());
+            vClusterCounts.push_back(0);
+        }
+        vVertexClusters[ivertex] = it->second;
+        simplified.vertices[it->second] += vertices[ivertex];
+        vClusterCounts[it->second] += 1;
+    }
+    for(size_t icluster = 0; icluster < simplified.vertices.size(); ++icluster) {
+        simplified.vertices[icluster] *= dReal(1)/vClusterCounts[icluster];
+    }
+
+    // remove collapsed triangles and keep only the first of triangles sharing the same vertices
+    std::vector< std::pair<std::array<int32_t, 3>, size_t> > vSortedTriangles;
+    vSortedTriangles.reserve(indices.size()/3);
+    for(size_t itri = 0; itri+2 < indices.size(); itri += 3) {
+        std::array<int32_t, 3> tri = {{vVertexClusters[indices[itri]], vVertexClusters[indices[itri+1]], vVertexClusters[indices[itri+2]]}};
+        if( tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2] ) {
+            continue;
+        }
+        std::sort(tri.begin(), tri.end());
+        vSortedTriangles.emplace_back(tri, itri);
+    }
+    std::sort(vSortedTriangles.begin(), vSortedTriangles.end());
+    std::vector<size_t> vKeptTriangles;
+    vKeptTriangles.reserve(vSortedTriangles.size());
+    for(size_t i = 0; i < vSortedTriangles.size(); ++i) {
+        if( i == 0 || vSortedTriangles[i].first != vSortedTriangles[i-1].first ) {
+            vKeptTriangles.push_back(vSortedTriangles[i].second);
+        }
+    }
+    std::sort(vKeptTriangles.begin(), vKeptTriangles.end());
+    simplified.indices.resize(3*vKeptTriangles.size());
+    for(size_t i = 0; i < vKeptTriangles.size(); ++i) {
+        for(int j = 0; j < 3; ++j) {
+            simplified.indices[3*i+j] = vVertexClusters[indices[vKeptTriangles[i]+j]];
+        }
+    }
+}
+
 void TriMesh::serialize(std::ostream& o, int options) const
 {
     o << vertices.size() << " ";
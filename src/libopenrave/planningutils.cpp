@@ -25,6 +25,12 @@
 
 #include <boost/bind/bind.hpp>
 
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 using namespace boost::placeholders;
 
 namespace OpenRAVE {
@@ -401,6 +407,13 @@ class TrajectoryVerifier
 public:
     TrajectoryVerifier(PlannerBase::PlannerParametersConstPtr parameters) : _parameters(parameters) {
         VerifyParameters();
+        _velspec = _parameters->_configurationspecification.ConvertToVelocitySpecification();
+        _fresolutionmean = 0;
+        FOREACHC(it,_parameters->_vConfigResolution) {
+            _fresolutionmean += *it;
+        }
+        _fresolutionmean /= _parameters->_vConfigResolution.size();
+        _filterreturn.reset(new ConstraintFilterReturn());
     }
 
     void VerifyParameters() {
@@ -412,22 +425,48 @@ public:
 
     void VerifyTrajectory(TrajectoryBaseConstPtr trajectory, dReal samplingstep)
     {
-        OPENRAVE_ASSERT_FORMAT0(!!trajectory,"need valid trajectory",ORE_InvalidArguments);
+        VerifyWaypoints(trajectory);
 
-        ConfigurationSpecification velspec =  _parameters->_configurationspecification.ConvertToVelocitySpecification();
+        if( !!_parameters->_checkpathvelocityconstraintsfn && trajectory->GetNumWaypoints() >= 2 ) {
 
-        dReal fresolutionmean = 0;
-        FOREACHC(it,_parameters->_vConfigResolution) {
-            fresolutionmean += *it;
+            if( trajectory->GetDuration() > 0 && samplingstep > 0 ) {
+                // use sampling and check segment constraints
+                std::vector<dReal> vsampletimes;
+                ComputeSampleTimes(trajectory, samplingstep, vsampletimes);
+                const IntervalType interval = GetSampleInterval(trajectory);
+                std::vector<dReal> vprevdata, vprevdatavel, vdata, vdatavel;
+                trajectory->Sample(vprevdata,vsampletimes.at(0),_parameters->_configurationspecification);
+                trajectory->Sample(vprevdatavel,vsampletimes.at(0),_velspec);
+                for(size_t isample = 1; isample < vsampletimes.size(); ++isample) {
+                    trajectory->Sample(vdata,vsampletimes[isample],_parameters->_configurationspecification);
+                    trajectory->Sample(vdatavel,vsampletimes[isample],_velspec);
+                    VerifySegment(trajectory, interval, vsampletimes[isample-1], vprevdata, vprevdatavel, vsampletimes[isample], vdata, vdatavel);
+                    vprevdata.swap(vdata);
+                    vprevdatavel.swap(vdatavel);
+                }
+            }
+            else {
+                std::vector<dReal> vdata;
+                for(size_t i = 0; i < trajectory->GetNumWaypoints(); ++i) {
+                    trajectory->GetWaypoint(i,vdata,_parameters->_configurationspecification);
+                    if( _parameters->CheckPathAllConstraints(vdata,vdata,std::vector<dReal>(), std::vector<dReal>(), 0, IT_OpenStart) != 0 ) {
+                        throw OPENRAVE_EXCEPTION_FORMAT(_("CheckPathAllConstraints, failed at %d, wrote trajectory to %s"),i%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
+                    }
+                }
+            }
         }
-        fresolutionmean /= _parameters->_vConfigResolution.size();
+    }
+
+    /// \brief checks the limits, the velocity limits, and the state functions at every waypoint
+    void VerifyWaypoints(TrajectoryBaseConstPtr trajectory)
+    {
+        OPENRAVE_ASSERT_FORMAT0(!!trajectory,"need valid trajectory",ORE_InvalidArguments);
 
         dReal fthresh = 5e-5f;
-        vector<dReal> deltaq(_parameters->GetDOF(),0);
         std::vector<dReal> vdata, vdatavel, vdiff;
         for(size_t ipoint = 0; ipoint < trajectory->GetNumWaypoints(); ++ipoint) {
             trajectory->GetWaypoint(ipoint,vdata,_parameters->_configurationspecification);
-            trajectory->GetWaypoint(ipoint,vdatavel,velspec);
+            trajectory->GetWaypoint(ipoint,vdatavel,_velspec);
             BOOST_ASSERT((int)vdata.size()==_parameters->GetDOF());
             BOOST_ASSERT((int)vdatavel.size()==_parameters->GetDOF());
             for(size_t i = 0; i < vdata.size(); ++i) {
@@ -459,107 +498,102 @@ public:
                     throw OPENRAVE_EXCEPTION_FORMAT(_("neighstatefn is rejecting configuration %d, wrote trajectory %s"),ipoint%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
                 }
                 dReal fdist = _parameters->_distmetricfn(newq,vdata);
-                OPENRAVE_ASSERT_OP_FORMAT(fdist,<=,0.01 * fresolutionmean, "neighstatefn is rejecting configuration %d, wrote trajectory %s",ipoint%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
+                OPENRAVE_ASSERT_OP_FORMAT(fdist,<=,0.01 * _fresolutionmean, "neighstatefn is rejecting configuration %d, wrote trajectory %s",ipoint%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
             }
         }
+    }
 
-        if( !!_parameters->_checkpathvelocityconstraintsfn && trajectory->GetNumWaypoints() >= 2 ) {
+    /// \brief computes the sorted times of the waypoints and of the samples every samplingstep. Times closer than 1e-5s to the previous time are removed.
+    static void ComputeSampleTimes(TrajectoryBaseConstPtr trajectory, dReal samplingstep, std::vector<dReal>& vsampletimes)
+    {
+        // have to make sure that sampling interval doesn't include a waypoint. otherwise interpolation could become inconsistent!
+        std::vector<dReal> vabstimes;
+        vabstimes.reserve(trajectory->GetNumWaypoints() + (trajectory->GetDuration()/samplingstep) + 1);
+        ConfigurationSpecification deltatimespec;
+        deltatimespec.AddDeltaTimeGroup();
+        trajectory->GetWaypoints(0, trajectory->GetNumWaypoints(), vabstimes, deltatimespec);
+        dReal totaltime = 0;
+        FOREACH(ittime, vabstimes) {
+            totaltime += *ittime;
+            *ittime = totaltime;
+        }
+        for(dReal ftime = 0; ftime < trajectory->GetDuration(); ftime += samplingstep ) {
+            vabstimes.push_back(ftime);
+        }
+        vsampletimes.resize(vabstimes.size());
+        std::merge(vabstimes.begin(), vabstimes.begin()+trajectory->GetNumWaypoints(), vabstimes.begin()+trajectory->GetNumWaypoints(), vabstimes.end(), vsampletimes.begin());
+        size_t numsampletimes = 1;
+        for(size_t isample = 1; isample < vsampletimes.size(); ++isample) {
+            if( vsampletimes[isample] >= vsampletimes[numsampletimes-1] + 1e-5 ) {
+                vsampletimes[numsampletimes++] = vsampletimes[isample];
+            }
+        }
+        vsampletimes.resize(numsampletimes);
+    }
 
-            if( trajectory->GetDuration() > 0 && samplingstep > 0 ) {
-                // use sampling and check segment constraints
-                // have to make sure that sampling interval doesn't include a waypoint. otherwise interpolation could become inconsistent!
-                std::vector<dReal> vabstimes, vsampletimes;
-                vabstimes.reserve(trajectory->GetNumWaypoints() + (trajectory->GetDuration()/samplingstep) + 1);
-                ConfigurationSpecification deltatimespec;
-                deltatimespec.AddDeltaTimeGroup();
-                trajectory->GetWaypoints(0, trajectory->GetNumWaypoints(), vabstimes, deltatimespec);
-                dReal totaltime = 0;
-                FOREACH(ittime, vabstimes) {
-                    totaltime += *ittime;
-                    *ittime = totaltime;
-                }
-                for(dReal ftime = 0; ftime < trajectory->GetDuration(); ftime += samplingstep ) {
-                    vabstimes.push_back(ftime);
-                }
-                vsampletimes.resize(vabstimes.size());
-                std::merge(vabstimes.begin(), vabstimes.begin()+trajectory->GetNumWaypoints(), vabstimes.begin()+trajectory->GetNumWaypoints(), vabstimes.end(), vsampletimes.begin());
-
-                // Check if the trajectory has all-linear interpolation
-                ConfigurationSpecification trajspec = trajectory->GetConfigurationSpecification();
-                vector<ConfigurationSpecification::Group>::const_iterator itvaluesgroup = trajspec.FindCompatibleGroup("joint_values", false);
-                vector<ConfigurationSpecification::Group>::const_iterator itvelocitiesgroup = trajspec.FindCompatibleGroup("joint_velocities", false);
-                vector<ConfigurationSpecification::Group>::const_iterator itaccelerationsgroup = trajspec.FindCompatibleGroup("joint_accelerations", false);
-                bool bHasAllLinearInterpolation = false;
-                if( (itvaluesgroup == trajspec._vgroups.end() || itvaluesgroup->interpolation == "linear") &&
-                    (itvelocitiesgroup == trajspec._vgroups.end() || itvelocitiesgroup->interpolation == "linear") &&
-                    (itaccelerationsgroup == trajspec._vgroups.end() || itaccelerationsgroup->interpolation == "linear") ) {
-                    bHasAllLinearInterpolation = true;
-                }
-                IntervalType interval = bHasAllLinearInterpolation ? (IntervalType)(IT_Closed | IT_AllLinear) : IT_Closed;
-
-                std::vector<dReal> vprevdata, vprevdatavel;
-                ConstraintFilterReturnPtr filterreturn(new ConstraintFilterReturn());
-                trajectory->Sample(vprevdata,0,_parameters->_configurationspecification);
-                trajectory->Sample(vprevdatavel,0,velspec);
-                std::vector<dReal>::iterator itprevtime = vsampletimes.begin();
-                for(std::vector<dReal>::iterator itsampletime = vsampletimes.begin()+1; itsampletime != vsampletimes.end(); ++itsampletime) {
-                    if (*itsampletime < *itprevtime + 1e-5 ) {
-                        continue;
-                    }
-                    filterreturn->Clear();
-                    trajectory->Sample(vdata,*itsampletime,_parameters->_configurationspecification);
-                    trajectory->Sample(vdatavel,*itsampletime,velspec);
-                    dReal deltatime = *itsampletime - *itprevtime;
-                    vdiff = vdata;
-                    _parameters->_diffstatefn(vdiff,vprevdata);
-                    for(size_t i = 0; i < _parameters->_vConfigVelocityLimit.size(); ++i) {
-                        dReal velthresh = _parameters->_vConfigVelocityLimit.at(i)*deltatime+fthresh;
-                        OPENRAVE_ASSERT_OP_FORMAT(RaveFabs(vdiff.at(i)), <=, velthresh, "time %fs-%fs, dof %d traveled %f, but maxvelocity only allows %f, wrote trajectory to %s",*itprevtime%*itsampletime%i%RaveFabs(vdiff.at(i))%velthresh%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
-                    }
-                    if( _parameters->CheckPathAllConstraints(vprevdata,vdata,vprevdatavel, vdatavel, deltatime, interval, 0xffff|CFO_FillCheckedConfiguration, filterreturn) != 0 ) {
-                        if( IS_DEBUGLEVEL(Level_Verbose) ) {
-                            _parameters->CheckPathAllConstraints(vprevdata,vdata,vprevdatavel, vdatavel, deltatime, interval, 0xffff|CFO_FillCheckedConfiguration, filterreturn);
-                        }
-                        throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, CheckPathAllConstraints failed, wrote trajectory to %s"),*itprevtime%*itsampletime%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
-                    }
-                    OPENRAVE_ASSERT_OP(filterreturn->_configurations.size()%_parameters->GetDOF(),==,0);
-                    std::vector<dReal>::iterator itprevconfig = filterreturn->_configurations.begin();
-                    std::vector<dReal>::iterator itcurconfig = itprevconfig + _parameters->GetDOF();
-                    for(; itcurconfig != filterreturn->_configurations.end(); itcurconfig += _parameters->GetDOF()) {
-                        std::vector<dReal> vprevconfig(itprevconfig,itprevconfig+_parameters->GetDOF());
-                        std::vector<dReal> vcurconfig(itcurconfig,itcurconfig+_parameters->GetDOF());
-                        for(int i = 0; i < _parameters->GetDOF(); ++i) {
-                            deltaq.at(i) = vcurconfig.at(i) - vprevconfig.at(i);
-                        }
-                        if( _parameters->SetStateValues(vprevconfig, 0) != 0 ) {
-                            throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, failed to set state values"), *itprevtime%*itsampletime, ORE_InconsistentConstraints);
-                        }
-                        vector<dReal> vtemp = vprevconfig;
-                        if( _parameters->_neighstatefn(vtemp,deltaq,NSO_OnlyHardConstraints) == NSS_Failed ) {
-                            throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, neighstatefn is rejecting configurations from CheckPathAllConstraints, wrote trajectory to %s"),*itprevtime%*itsampletime%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
-                        }
-                        else {
-                            dReal fprevdist = _parameters->_distmetricfn(vprevconfig,vtemp);
-                            dReal fcurdist = _parameters->_distmetricfn(vcurconfig,vtemp);
-                            if( fprevdist > g_fEpsilonLinear ) {
-                                OPENRAVE_ASSERT_OP_FORMAT(fprevdist, >, fcurdist, "time %fs-%fs, neighstatefn returned a configuration closer to the previous configuration %f than the expected current %f, wrote trajectory to %s",*itprevtime%*itsampletime%fprevdist%fcurdist%DumpTrajectory(trajectory), ORE_InconsistentConstraints);
-                            }
-                        }
-                        itprevconfig=itcurconfig;
-                    }
-                    vprevdata.swap(vdata);
-                    vprevdatavel.swap(vdatavel);
-                    itprevtime = itsampletime;
-                }
+    /// \brief returns the interval to check the segments between samples with
+    static IntervalType GetSampleInterval(TrajectoryBaseConstPtr trajectory)
+    {
+        // Check if the trajectory has all-linear interpolation
+        const ConfigurationSpecification& trajspec = trajectory->GetConfigurationSpecification();
+        vector<ConfigurationSpecification::Group>::const_iterator itvaluesgroup = trajspec.FindCompatibleGroup("joint_values", false);
+        vector<ConfigurationSpecification::Group>::const_iterator itvelocitiesgroup = trajspec.FindCompatibleGroup("joint_velocities", false);
+        vector<ConfigurationSpecification::Group>::const_iterator itaccelerationsgroup = trajspec.FindCompatibleGroup("joint_accelerations", false);
+        bool bHasAllLinearInterpolation = false;
+        if( (itvaluesgroup == trajspec._vgroups.end() || itvaluesgroup->interpolation == "linear") &&
+            (itvelocitiesgroup == trajspec._vgroups.end() || itvelocitiesgroup->interpolation == "linear") &&
+            (itaccelerationsgroup == trajspec._vgroups.end() || itaccelerationsgroup->interpolation == "linear") ) {
+            bHasAllLinearInterpolation = true;
+        }
+        return bHasAllLinearInterpolation ? (IntervalType)(IT_Closed | IT_AllLinear) : IT_Closed;
+    }
+
+    /// \brief checks the segment between two consecutive samples of the trajectory
+    ///
+    /// \param vprevdata, vprevdatavel the sampled values and velocities at prevtime
+    /// \param vdata, vdatavel the sampled values and velocities at time
+    void VerifySegment(TrajectoryBaseConstPtr trajectory, IntervalType interval, dReal prevtime, const std::vector<dReal>& vprevdata, const std::vector<dReal>& vprevdatavel, dReal time, const std::vector<dReal>& vdata, const std::vector<dReal>& vdatavel)
+    {
+        dReal fthresh = 5e-5f;
+        _filterreturn->Clear();
+        dReal deltatime = time - prevtime;
+        _vdiff = vdata;
+        _parameters->_diffstatefn(_vdiff,vprevdata);
+        for(size_t i = 0; i < _parameters->_vConfigVelocityLimit.size(); ++i) {
+            dReal velthresh = _parameters->_vConfigVelocityLimit.at(i)*deltatime+fthresh;
+            OPENRAVE_ASSERT_OP_FORMAT(RaveFabs(_vdiff.at(i)), <=, velthresh, "time %fs-%fs, dof %d traveled %f, but maxvelocity only allows %f, wrote trajectory to %s",prevtime%time%i%RaveFabs(_vdiff.at(i))%velthresh%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
+        }
+        if( _parameters->CheckPathAllConstraints(vprevdata,vdata,vprevdatavel, vdatavel, deltatime, interval, 0xffff|CFO_FillCheckedConfiguration, _filterreturn) != 0 ) {
+            if( IS_DEBUGLEVEL(Level_Verbose) ) {
+                _parameters->CheckPathAllConstraints(vprevdata,vdata,vprevdatavel, vdatavel, deltatime, interval, 0xffff|CFO_FillCheckedConfiguration, _filterreturn);
+            }
+            throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, CheckPathAllConstraints failed, wrote trajectory to %s"),prevtime%time%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
+        }
+        OPENRAVE_ASSERT_OP(_filterreturn->_configurations.size()%_parameters->GetDOF(),==,0);
+        _vdeltaq.resize(_parameters->GetDOF());
+        std::vector<dReal>::iterator itprevconfig = _filterreturn->_configurations.begin();
+        std::vector<dReal>::iterator itcurconfig = itprevconfig + _parameters->GetDOF();
+        for(; itcurconfig != _filterreturn->_configurations.end(); itcurconfig += _parameters->GetDOF()) {
+            std::vector<dReal> vprevconfig(itprevconfig,itprevconfig+_parameters->GetDOF());
+            std::vector<dReal> vcurconfig(itcurconfig,itcurconfig+_parameters->GetDOF());
+            for(int i = 0; i < _parameters->GetDOF(); ++i) {
+                _vdeltaq.at(i) = vcurconfig.at(i) - vprevconfig.at(i);
+            }
+            if( _parameters->SetStateValues(vprevconfig, 0) != 0 ) {
+                throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, failed to set state values"), prevtime%time, ORE_InconsistentConstraints);
+            }
+            vector<dReal> vtemp = vprevconfig;
+            if( _parameters->_neighstatefn(vtemp,_vdeltaq,NSO_OnlyHardConstraints) == NSS_Failed ) {
+                throw OPENRAVE_EXCEPTION_FORMAT(_("time %fs-%fs, neighstatefn is rejecting configurations from CheckPathAllConstraints, wrote trajectory to %s"),prevtime%time%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
             }
             else {
-                for(size_t i = 0; i < trajectory->GetNumWaypoints(); ++i) {
-                    trajectory->GetWaypoint(i,vdata,_parameters->_configurationspecification);
-                    if( _parameters->CheckPathAllConstraints(vdata,vdata,std::vector<dReal>(), std::vector<dReal>(), 0, IT_OpenStart) != 0 ) {
-                        throw OPENRAVE_EXCEPTION_FORMAT(_("CheckPathAllConstraints, failed at %d, wrote trajectory to %s"),i%DumpTrajectory(trajectory),ORE_InconsistentConstraints);
-                    }
+                dReal fprevdist = _parameters->_distmetricfn(vprevconfig,vtemp);
+                dReal fcurdist = _parameters->_distmetricfn(vcurconfig,vtemp);
+                if( fprevdist > g_fEpsilonLinear ) {
+                    OPENRAVE_ASSERT_OP_FORMAT(fprevdist, >, fcurdist, "time %fs-%fs, neighstatefn returned a configuration closer to the previous configuration %f than the expected current %f, wrote trajectory to %s",prevtime%time%fprevdist%fcurdist%DumpTrajectory(trajectory), ORE_InconsistentConstraints);
                 }
             }
+            itprevconfig=itcurconfig;
         }
     }
 
@@ -572,8 +606,16 @@ public:
         return filename;
     }
 
+    inline const ConfigurationSpecification& GetVelocitySpecification() const {
+        return _velspec;
+    }
+
 protected:
     PlannerBase::PlannerParametersConstPtr _parameters;
+    ConfigurationSpecification _velspec; ///< velocity specification of the parameters
+    dReal _fresolutionmean; ///< mean of the configuration resolutions
+    ConstraintFilterReturnPtr _filterreturn;
+    std::vector<dReal> _vdiff, _vdeltaq;
 };
 
 void VerifyTrajectory(PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory, dReal samplingstep)
@@ -587,6 +629,277 @@ void VerifyTrajectory(PlannerBase::PlannerParametersConstPtr parameters, Traject
     v.VerifyTrajectory(trajectory,samplingstep);
 }
 
+/// \brief orders the indices [begin,end) coarse to fine: the middle first, then the middles of both halves, and so on
+static void _GetBisectionOrder(int begin, int end, std::vector<int>& vorder)
+{
+    vorder.resize(0);
+    vorder.reserve(max(0, end-begin));
+    std::deque< std::pair<int, int> > ranges;
+    ranges.emplace_back(begin, end);
+    while( !ranges.empty() ) {
+        const std::pair<int, int> range = ranges.front();
+        ranges.pop_front();
+        if( range.first >= range.second ) {
+            continue;
+        }
+        const int middle = range.first + (range.second-range.first)/2;
+        vorder.push_back(middle);
+        ranges.emplace_back(range.first, middle);
+        ranges.emplace_back(middle+1, range.second);
+    }
+}
+
+/// \brief environment, trajectory, and parameters of one thread of ParallelTrajectoryVerifier
+class ParallelTrajectoryVerifier::CloneVerifier
+{
+public:
+    CloneVerifier(EnvironmentBasePtr penv) : _penv(penv->CloneSelf(Clone_Bodies)) {
+    }
+    ~CloneVerifier() {
+        _penv->Destroy();
+    }
+
+    /// \brief synchronizes the clone with penv and trajectory, and the parameters of the clone with parameters. Rebuilds the parameters of the clone only if the specification or its bodies changed.
+    ///
+    /// Assumes that penv and the clone are locked.
+    void Update(EnvironmentBasePtr penv, PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory)
+    {
+        // Clone re-uses the bodies that did not change since the last call
+        _penv->Clone(penv, Clone_Bodies);
+        if( !_ptrajectory || _ptrajectory->GetXMLId() != trajectory->GetXMLId() ) {
+            _ptrajectory = RaveCreateTrajectory(_penv, trajectory->GetXMLId());
+        }
+        _ptrajectory->Clone(trajectory, 0);
+
+        parameters->_configurationspecification.ExtractUsedBodies(_penv, _vnewusedbodies);
+        if( !_pparameters || _spec != parameters->_configurationspecification || _vusedbodies != _vnewusedbodies ) {
+            _pparameters.reset(new PlannerBase::PlannerParameters());
+            _pparameters->SetConfigurationSpecification(_penv, parameters->_configurationspecification);
+            _spec = parameters->_configurationspecification;
+            _vusedbodies.swap(_vnewusedbodies);
+        }
+        // the caller can verify against stricter limits than the limits of the bodies
+        _pparameters->_vConfigLowerLimit = parameters->_vConfigLowerLimit;
+        _pparameters->_vConfigUpperLimit = parameters->_vConfigUpperLimit;
+        _pparameters->_vConfigVelocityLimit = parameters->_vConfigVelocityLimit;
+        _pparameters->_vConfigAccelerationLimit = parameters->_vConfigAccelerationLimit;
+        _pparameters->_vConfigJerkLimit = parameters->_vConfigJerkLimit;
+        _pparameters->_vConfigResolution = parameters->_vConfigResolution;
+        _pverifier.reset(new TrajectoryVerifier(_pparameters));
+    }
+
+    /// \brief returns true if the state and constraint functions of parameters are of the same type as the ones SetConfigurationSpecification sets, so the functions of the clone check the same constraints
+    bool HasSameFunctions(const PlannerBase::PlannerParameters& parameters) const
+    {
+        return parameters._checkpathvelocityconstraintsfn.target_type() == _pparameters->_checkpathvelocityconstraintsfn.target_type()
+               && parameters._neighstatefn.target_type() == _pparameters->_neighstatefn.target_type()
+               && parameters._setstatevaluesfn.target_type() == _pparameters->_setstatevaluesfn.target_type()
+               && parameters._getstatefn.target_type() == _pparameters->_getstatefn.target_type()
+               && parameters._diffstatefn.target_type() == _pparameters->_diffstatefn.target_type()
+               && parameters._distmetricfn.target_type() == _pparameters->_distmetricfn.target_type();
+    }
+
+    inline EnvironmentBasePtr GetEnv() const {
+        return _penv;
+    }
+    inline TrajectoryBasePtr GetTrajectory() const {
+        return _ptrajectory;
+    }
+    inline TrajectoryVerifier& GetVerifier() const {
+        return *_pverifier;
+    }
+
+private:
+    EnvironmentBasePtr _penv;
+    TrajectoryBasePtr _ptrajectory;
+    PlannerBase::PlannerParametersPtr _pparameters;
+    ConfigurationSpecification _spec; ///< specification _pparameters was built for
+    std::vector<KinBodyPtr> _vusedbodies, _vnewusedbodies; ///< bodies of the clone _pparameters was built for
+    boost::shared_ptr<TrajectoryVerifier> _pverifier;
+};
+
+ParallelTrajectoryVerifier::ParallelTrajectoryVerifier(int numthreads) : _numthreads(numthreads)
+{
+}
+
+ParallelTrajectoryVerifier::~ParallelTrajectoryVerifier()
+{
+}
+
+void ParallelTrajectoryVerifier::VerifyTrajectory(PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory, dReal samplingstep)
+{
+    OPENRAVE_ASSERT_FORMAT0(!!trajectory,"need valid trajectory",ORE_InvalidArguments);
+    EnvironmentBasePtr penv = trajectory->GetEnv();
+    if( !parameters ) {
+        PlannerBase::PlannerParametersPtr newparams(new PlannerBase::PlannerParameters());
+        newparams->SetConfigurationSpecification(penv, trajectory->GetConfigurationSpecification().GetTimeDerivativeSpecification(0));
+        parameters = newparams;
+    }
+    TrajectoryVerifier verifier(parameters);
+    if( !parameters->_checkpathvelocityconstraintsfn || trajectory->GetNumWaypoints() < 2 || trajectory->GetDuration() <= 0 || samplingstep <= 0 ) {
+        // no sampled segments to check
+        verifier.VerifyTrajectory(trajectory, samplingstep);
+        return;
+    }
+
+    std::vector<dReal> vsampletimes;
+    TrajectoryVerifier::ComputeSampleTimes(trajectory, samplingstep, vsampletimes);
+    const int numsegments = (int)vsampletimes.size()-1;
+    int numthreads = _numthreads > 0 ? _numthreads : max(1, (int)std::thread::hardware_concurrency());
+    numthreads = min(numthreads, numsegments);
+    if( numthreads <= 1 ) {
+        verifier.VerifyTrajectory(trajectory, samplingstep);
+        return;
+    }
+    const IntervalType interval = TrajectoryVerifier::GetSampleInterval(trajectory);
+
+    // every thread checks a contiguous shard of the segments in its own clone
+    std::vector< std::vector<int> > vsegmentorders(numthreads);
+    for(int ithread = 0; ithread < numthreads; ++ithread) {
+        if( ithread >= (int)_vcloneverifiers.size() ) {
+            _vcloneverifiers.push_back(CloneVerifierPtr(new CloneVerifier(penv)));
+        }
+        CloneVerifier& cloneverifier = *_vcloneverifiers[ithread];
+        {
+            EnvironmentLock lockclone(cloneverifier.GetEnv()->GetMutex());
+            cloneverifier.Update(penv, parameters, trajectory);
+        }
+        if( ithread == 0 && !cloneverifier.HasSameFunctions(*parameters) ) {
+            RAVELOG_DEBUG_FORMAT("env=%s, parameters have custom state or constraint functions that cannot be checked on clones, so verifying on the calling thread", penv->GetNameId());
+            verifier.VerifyTrajectory(trajectory, samplingstep);
+            return;
+        }
+        _GetBisectionOrder((numsegments*ithread)/numthreads, (numsegments*(ithread+1))/numthreads, vsegmentorders[ithread]);
+    }
+
+    // the waypoints are few, only the sampled segments are checked in parallel
+    verifier.VerifyWaypoints(trajectory);
+
+    // segment isegment goes from vsampletimes[isegment] to vsampletimes[isegment+1].
+    // once a segment fails, the segments after it cannot change the result and are skipped by all threads.
+    std::atomic<int> earliestfailedsegment(numsegments);
+    std::mutex mutexfailure;
+    std::exception_ptr pfailure;
+    const ConfigurationSpecification& spec = parameters->_configurationspecification;
+    auto verifyshard = [&](int ithread) {
+        const CloneVerifier& cloneverifier = *_vcloneverifiers[ithread];
+        EnvironmentLock lockclone(cloneverifier.GetEnv()->GetMutex());
+        TrajectoryBasePtr pclonetrajectory = cloneverifier.GetTrajectory();
+        TrajectoryVerifier& clonetrajectoryverifier = cloneverifier.GetVerifier();
+        const ConfigurationSpecification& velspec = clonetrajectoryverifier.GetVelocitySpecification();
+        std::vector<dReal> vprevdata, vprevdatavel, vdata, vdatavel;
+        for(int isegment : vsegmentorders[ithread]) {
+            if( isegment >= earliestfailedsegment.load() ) {
+                continue;
+            }
+            try {
+                pclonetrajectory->Sample(vprevdata, vsampletimes[isegment], spec);
+                pclonetrajectory->Sample(vprevdatavel, vsampletimes[isegment], velspec);
+                pclonetrajectory->Sample(vdata, vsampletimes[isegment+1], spec);
+                pclonetrajectory->Sample(vdatavel, vsampletimes[isegment+1], velspec);
+                clonetrajectoryverifier.VerifySegment(pclonetrajectory, interval, vsampletimes[isegment], vprevdata, vprevdatavel, vsampletimes[isegment+1], vdata, vdatavel);
+            }
+            catch(...) {
+                std::lock_guard<std::mutex> lockfailure(mutexfailure);
+                if( isegment < earliestfailedsegment.load() ) {
+                    earliestfailedsegment = isegment;
+                    pfailure = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> vthreads;
+    vthreads.reserve(numthreads-1);
+    for(int ithread = 1; ithread < numthreads; ++ithread) {
+        vthreads.emplace_back(verifyshard, ithread);
+    }
+    verifyshard(0);
+    for(std::thread& thread : vthreads) {
+        thread.join();
+    }
+    if( !!pfailure ) {
+        RAVELOG_DEBUG_FORMAT("env=%s, trajectory fails at %fs, segment %d/%d", penv->GetNameId()%vsampletimes[earliestfailedsegment.load()]%earliestfailedsegment.load()%numsegments);
+        std::rethrow_exception(pfailure);
+    }
+}
+
+/// \brief verifiers of VerifyTrajectoryParallel, keyed by the environment id and the number of threads. A verifier is taken out of the map while it is used, so concurrent calls never share one.
+static std::mutex s_mutexParallelTrajectoryVerifiers;
+static std::map< std::pair<int, int>, std::pair<EnvironmentBaseWeakPtr, ParallelTrajectoryVerifierPtr> > s_mapParallelTrajectoryVerifiers;
+static bool s_bParallelTrajectoryVerifiersDestroyCallback = false;
+
+/// \brief destroys the clones of the cached verifiers with the runtime
+static void _ClearParallelTrajectoryVerifiers()
+{
+    std::map< std::pair<int, int>, std::pair<EnvironmentBaseWeakPtr, ParallelTrajectoryVerifierPtr> > mapverifiers;
+    {
+        std::lock_guard<std::mutex> lock(s_mutexParallelTrajectoryVerifiers);
+        mapverifiers.swap(s_mapParallelTrajectoryVerifiers);
+        s_bParallelTrajectoryVerifiersDestroyCallback = false;
+    }
+}
+
+/// \brief puts the verifier back into the cache and drops the verifiers of destroyed environments
+static void _ReleaseParallelTrajectoryVerifier(const std::pair<int, int>& key, EnvironmentBasePtr penv, ParallelTrajectoryVerifierPtr pverifier)
+{
+    std::vector<ParallelTrajectoryVerifierPtr> vexpiredverifiers; // destroyed outside of the lock
+    bool bRegisterDestroyCallback = false;
+    {
+        std::lock_guard<std::mutex> lock(s_mutexParallelTrajectoryVerifiers);
+        std::map< std::pair<int, int>, std::pair<EnvironmentBaseWeakPtr, ParallelTrajectoryVerifierPtr> >::iterator it = s_mapParallelTrajectoryVerifiers.begin();
+        while(it != s_mapParallelTrajectoryVerifiers.end()) {
+            if( it->second.first.expired() ) {
+                vexpiredverifiers.push_back(it->second.second);
+                it = s_mapParallelTrajectoryVerifiers.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        s_mapParallelTrajectoryVerifiers[key] = std::make_pair(EnvironmentBaseWeakPtr(penv), pverifier);
+        bRegisterDestroyCallback = !s_bParallelTrajectoryVerifiersDestroyCallback;
+        s_bParallelTrajectoryVerifiersDestroyCallback = true;
+    }
+    if( bRegisterDestroyCallback ) {
+        RaveAddCallbackForDestroy(_ClearParallelTrajectoryVerifiers);
+    }
+}
+
+void VerifyTrajectoryParallel(PlannerBase::PlannerParametersConstPtr parameters, TrajectoryBaseConstPtr trajectory, dReal samplingstep, int numthreads)
+{
+    OPENRAVE_ASSERT_FORMAT0(!!trajectory,"need valid trajectory",ORE_InvalidArguments);
+    EnvironmentBasePtr penv = trajectory->GetEnv();
+    const std::pair<int, int> key(penv->GetId(), numthreads);
+    ParallelTrajectoryVerifierPtr pverifier, pexpiredverifier;
+    {
+        std::lock_guard<std::mutex> lock(s_mutexParallelTrajectoryVerifiers);
+        std::map< std::pair<int, int>, std::pair<EnvironmentBaseWeakPtr, ParallelTrajectoryVerifierPtr> >::iterator it = s_mapParallelTrajectoryVerifiers.find(key);
+        if( it != s_mapParallelTrajectoryVerifiers.end() ) {
+            // the id can be re-used by a new environment
+            if( it->second.first.lock() == penv ) {
+                pverifier = it->second.second;
+            }
+            else {
+                pexpiredverifier = it->second.second;
+            }
+            s_mapParallelTrajectoryVerifiers.erase(it);
+        }
+    }
+    pexpiredverifier.reset();
+    if( !pverifier ) {
+        pverifier.reset(new ParallelTrajectoryVerifier(numthreads));
+    }
+    try {
+        pverifier->VerifyTrajectory(parameters, trajectory, samplingstep);
+    }
+    catch(...) {
+        _ReleaseParallelTrajectoryVerifier(key, penv, pverifier);
+        throw;
+    }
+    _ReleaseParallelTrajectoryVerifier(key, penv, pverifier);
+}
+
 PlannerStatus _PlanActiveDOFTrajectory(TrajectoryBasePtr traj, RobotBasePtr probot, bool hastimestamps, dReal fmaxvelmult, dReal fmaxaccelmult, const std::string& plannername, bool bsmooth, const std::string& plannerparameters)
 {
     if( traj->GetNumWaypoints() == 1 ) {
@@ -2369,6 +2682,7 @@ int DynamicsCollisionConstraint::_SetAndCheckState(PlannerBase::PlannerParameter
 
 int DynamicsCollisionConstraint::_CheckState(const std::vector<dReal>& vdofvelocities, const std::vector<dReal>& vdofaccels, int options, ConstraintFilterReturnPtr filterreturn)
 {
+    OPENRAVE_PROFILE_COUNT("constraint.CheckState", 1);
     options &= _filtermask;
     if( (options&CFO_CheckUserConstraints) && !!_usercheckfns[0] ) {
         if( !_usercheckfns[0]() ) {
@@ -2585,6 +2899,7 @@ inline std::ostream& RaveSerializeValues(std::ostream& O, const std::vector<dRea
 
 int DynamicsCollisionConstraint::Check(const std::vector<dReal>& q0, const std::vector<dReal>& q1, const std::vector<dReal>& dq0, const std::vector<dReal>& dq1, dReal timeelapsed, IntervalType interval, int options, ConstraintFilterReturnPtr filterreturn)
 {
+    OPENRAVE_PROFILE_SCOPE("constraint.Check");
     int maskoptions = options&_filtermask;
     int maskinterval = interval & IT_IntervalMask;
     int maskinterpolation = interval & IT_InterpolationMask;
@@ -3633,6 +3948,7 @@ int DynamicsCollisionConstraint::Check(const std::vector<dReal>& q0, const std::
                                        const std::vector<dReal>& ddq0, const std::vector<dReal>& ddq1,
                                        dReal timeelapsed, IntervalType interval, int options, ConstraintFilterReturnPtr filterreturn)
 {
+    OPENRAVE_PROFILE_SCOPE("constraint.Check");
     if( !!filterreturn ) {
         filterreturn->Clear();
     }
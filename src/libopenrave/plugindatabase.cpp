@@ -21,7 +21,10 @@
 #include <functional>
 #include <mutex>
 
+#include <fstream>
+
 #include <openrave/openraveexception.h>
+#include <openrave/openravejson.h>
 #include <openrave/logging.h>
 
 #ifdef HAVE_BOOST_FILESYSTEM
@@ -130,8 +133,23 @@ DynamicRaveDatabase::~DynamicRaveDatabase()
     Destroy();
 }
 
-void DynamicRaveDatabase::Init()
+void DynamicRaveDatabase::Init(bool bLoadAllPlugins)
 {
+    _bLoadAllPlugins = bLoadAllPlugins;
+    const char* pOPENRAVE_PLUGINS_MANIFEST = getenv("OPENRAVE_PLUGINS_MANIFEST"); // getenv not thread-safe?
+    if( !!pOPENRAVE_PLUGINS_MANIFEST ) {
+        _manifestfilename = pOPENRAVE_PLUGINS_MANIFEST; // empty disables the manifest
+    }
+    else {
+        const std::string homedirectory = RaveGetHomeDirectory();
+        if( !homedirectory.empty() ) {
+            _manifestfilename = homedirectory + s_filesep + "plugins.manifest.json";
+        }
+    }
+    if( !_manifestfilename.empty() ) {
+        _ReadPluginManifest();
+    }
+
     const char* pOPENRAVE_PLUGINS = getenv("OPENRAVE_PLUGINS"); // getenv not thread-safe?
     std::vector<std::string> vplugindirs;
     if (!!pOPENRAVE_PLUGINS) {
@@ -202,6 +220,9 @@ void DynamicRaveDatabase::Init()
         RAVELOG_DEBUG_FORMAT("Looking for plugins in %s", entry);
         _LoadPluginsFromPath(entry);
     }
+    if( _bManifestModified ) {
+        _WritePluginManifest();
+    }
 }
 
 void DynamicRaveDatabase::ReloadPlugins()
@@ -258,7 +279,7 @@ void DynamicRaveDatabase::_LoadPluginsFromPath(const std::string& strpath, bool
     } else if (fs::is_regular_file(path)) {
         // Check that the file has a platform-appropriate extension
         if (0 == strpath.compare(strpath.size() - PLUGIN_EXT.size(), PLUGIN_EXT.size(), PLUGIN_EXT)) {
-            _LoadPlugin(path.string());
+            _AddPluginFromManifest(path.string());
         }
     } else {
         RAVELOG_WARN_FORMAT("Path is not a valid directory or file: %s", strpath);
@@ -296,7 +317,7 @@ void DynamicRaveDatabase::_LoadPluginsFromPath(const std::string& strpath, bool
         }
         ::closedir(dirptr);
     } else if (S_ISREG(sb.st_mode)) {
-        _LoadPlugin(strpath);
+        _AddPluginFromManifest(strpath);
     } else {
         // Not a directory or file, ignore it
     }
@@ -307,18 +328,17 @@ void DynamicRaveDatabase::_LoadPluginsFromPath(const std::string& strpath, bool
     RAVELOG_VERBOSE_FORMAT("%s", e.what());
 }
 
-bool DynamicRaveDatabase::_LoadPlugin(const std::string& strpath)
+RavePlugin* DynamicRaveDatabase::_OpenPlugin(const std::string& strpath, DynamicLibrary& dylib)
 {
-    DynamicLibrary dylib(strpath);
     if (!dylib) {
         RAVELOG_WARN_FORMAT("Failed to load shared object %s", strpath);
-        return false;
+        return nullptr;
     }
     std::string errstr;
     void* psym = dylib.LoadSymbol("CreatePlugin", errstr);
     if (!psym) {
         RAVELOG_WARN_FORMAT("%s, might not be an OpenRAVE plugin.", errstr);
-        return false;
+        return nullptr;
     }
     RavePlugin* plugin = nullptr;
     try {
@@ -326,6 +346,13 @@ bool DynamicRaveDatabase::_LoadPlugin(const std::string& strpath)
     } catch (const std::exception& e) {
         RAVELOG_WARN_FORMAT("Failed to construct a RavePlugin from %s: %s", strpath % e.what());
     }
+    return plugin;
+}
+
+bool DynamicRaveDatabase::_LoadPlugin(const std::string& strpath)
+{
+    DynamicLibrary dylib(strpath);
+    RavePlugin* plugin = _OpenPlugin(strpath, dylib);
     if (!plugin) {
         return false;
     }
@@ -337,6 +364,239 @@ bool DynamicRaveDatabase::_LoadPlugin(const std::string& strpath)
     return true;
 }
 
+/// \brief gets the modification time and size used to validate manifest entries
+static bool _GetPluginFileStamp(const std::string& strpath, int64_t& mtime, int64_t& filesize)
+{
+#ifdef HAVE_BOOST_FILESYSTEM
+    boost::system::error_code ec;
+    const fs::path path(strpath);
+    mtime = static_cast<int64_t>(fs::last_write_time(path, ec));
+    if( ec ) {
+        return false;
+    }
+    filesize = static_cast<int64_t>(fs::file_size(path, ec));
+    return !ec;
+#else
+    struct stat sb;
+    if( ::stat(strpath.c_str(), &sb) != 0 ) {
+        return false;
+    }
+    mtime = static_cast<int64_t>(sb.st_mtime);
+    filesize = static_cast<int64_t>(sb.st_size);
+    return true;
+#endif
+}
+
+bool DynamicRaveDatabase::_AddPluginFromManifest(const std::string& strpath)
+{
+    if( _manifestfilename.empty() ) {
+        return _LoadPlugin(strpath);
+    }
+    int64_t mtime = 0, filesize = 0;
+    if( !_GetPluginFileStamp(strpath, mtime, filesize) ) {
+        return _LoadPlugin(strpath);
+    }
+
+    std::map<std::string, PluginManifestEntry>::iterator itentry = _mapManifest.find(strpath);
+    const bool bValidEntry = itentry != _mapManifest.end() && itentry->second.mtime == mtime && itentry->second.filesize == filesize;
+    if( bValidEntry && !_bLoadAllPlugins ) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _vPlugins.emplace_back(boost::make_shared<LazyPlugin>(*this, strpath, itentry->second));
+        _vPlugins.back()->SetPluginPath(strpath);
+        RAVELOG_VERBOSE_FORMAT("Found %s at %s from the plugin manifest, deferring loading.", itentry->second.pluginname % strpath);
+        return true;
+    }
+
+    if( !_LoadPlugin(strpath) ) {
+        if( itentry != _mapManifest.end() ) {
+            _mapManifest.erase(itentry);
+            _bManifestModified = true;
+        }
+        return false;
+    }
+    if( !bValidEntry ) {
+        PluginManifestEntry entry;
+        entry.mtime = mtime;
+        entry.filesize = filesize;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            entry.pluginname = _vPlugins.back()->GetPluginName();
+            entry.interfaces = _vPlugins.back()->GetInterfaces();
+        }
+        _mapManifest[strpath] = std::move(entry);
+        _bManifestModified = true;
+    }
+    return true;
+}
+
+void DynamicRaveDatabase::_ReadPluginManifest()
+{
+    _mapManifest.clear();
+    std::ifstream f(_manifestfilename.c_str());
+    if( !f ) {
+        return;
+    }
+    try {
+        rapidjson::Document doc;
+        orjson::ParseJson(doc, f);
+        std::string version;
+        orjson::LoadJsonValueByKey(doc, "openraveVersion", version);
+        if( version != OPENRAVE_VERSION_STRING ) {
+            RAVELOG_DEBUG_FORMAT("plugin manifest %s was written by openrave %s, ignoring", _manifestfilename % version);
+            return;
+        }
+        rapidjson::Value::ConstMemberIterator itplugins = doc.FindMember("plugins");
+        if( itplugins == doc.MemberEnd() || !itplugins->value.IsArray() ) {
+            return;
+        }
+        for (const rapidjson::Value& rPlugin : itplugins->value.GetArray()) {
+            std::string strpath;
+            PluginManifestEntry entry;
+            orjson::LoadJsonValueByKey(rPlugin, "path", strpath);
+            orjson::LoadJsonValueByKey(rPlugin, "mtime", entry.mtime);
+            orjson::LoadJsonValueByKey(rPlugin, "fileSize", entry.filesize);
+            orjson::LoadJsonValueByKey(rPlugin, "name", entry.pluginname);
+            rapidjson::Value::ConstMemberIterator itinterfaces = rPlugin.FindMember("interfaces");
+            if( strpath.empty() || itinterfaces == rPlugin.MemberEnd() || !itinterfaces->value.IsArray() ) {
+                continue;
+            }
+            for (const rapidjson::Value& rInterface : itinterfaces->value.GetArray()) {
+                int type = 0;
+                std::vector<std::string> names;
+                orjson::LoadJsonValueByKey(rInterface, "type", type);
+                orjson::LoadJsonValueByKey(rInterface, "names", names);
+                entry.interfaces[static_cast<InterfaceType>(type)] = std::move(names);
+            }
+            _mapManifest[strpath] = std::move(entry);
+        }
+    }
+    catch (const std::exception& ex) {
+        RAVELOG_WARN_FORMAT("failed to read plugin manifest %s, rebuilding it: %s", _manifestfilename % ex.what());
+        _mapManifest.clear();
+    }
+}
+
+void DynamicRaveDatabase::_WritePluginManifest()
+{
+    rapidjson::Document doc;
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    orjson::SetJsonValueByKey(doc, "openraveVersion", std::string(OPENRAVE_VERSION_STRING), allocator);
+    rapidjson::Value rPlugins(rapidjson::kArrayType);
+    for (const std::pair<const std::string, PluginManifestEntry>& manifestentry : _mapManifest) {
+        rapidjson::Value rPlugin(rapidjson::kObjectType);
+        orjson::SetJsonValueByKey(rPlugin, "path", manifestentry.first, allocator);
+        orjson::SetJsonValueByKey(rPlugin, "mtime", manifestentry.second.mtime, allocator);
+        orjson::SetJsonValueByKey(rPlugin, "fileSize", manifestentry.second.filesize, allocator);
+        orjson::SetJsonValueByKey(rPlugin, "name", manifestentry.second.pluginname, allocator);
+        rapidjson::Value rInterfaces(rapidjson::kArrayType);
+        for (const std::pair<const InterfaceType, std::vector<std::string> >& interfaceentry : manifestentry.second.interfaces) {
+            rapidjson::Value rInterface(rapidjson::kObjectType);
+            orjson::SetJsonValueByKey(rInterface, "type", static_cast<int>(interfaceentry.first), allocator);
+            orjson::SetJsonValueByKey(rInterface, "names", interfaceentry.second, allocator);
+            rInterfaces.PushBack(rInterface, allocator);
+        }
+        rPlugin.AddMember("interfaces", rInterfaces, allocator);
+        rPlugins.PushBack(rPlugin, allocator);
+    }
+    doc.AddMember("plugins", rPlugins, allocator);
+
+    // write to a temporary file first so that concurrently starting processes never read a partial manifest
+    const std::string tempfilename = _manifestfilename + ".tmp" + boost::lexical_cast<std::string>(utils::GetMicroTime());
+    {
+        std::ofstream f(tempfilename.c_str());
+        if( !f ) {
+            RAVELOG_DEBUG_FORMAT("cannot write plugin manifest %s", tempfilename);
+            return;
+        }
+        orjson::DumpJson(doc, f);
+    }
+    if( std::rename(tempfilename.c_str(), _manifestfilename.c_str()) != 0 ) {
+        RAVELOG_DEBUG_FORMAT("failed to move plugin manifest to %s", _manifestfilename);
+        std::remove(tempfilename.c_str());
+        return;
+    }
+    _bManifestModified = false;
+}
+
+DynamicRaveDatabase::LazyPlugin::LazyPlugin(DynamicRaveDatabase& database, const std::string& strpath, const PluginManifestEntry& entry)
+    : _database(database)
+    , _pluginname(entry.pluginname)
+    , _interfaces(entry.interfaces)
+{
+    SetPluginPath(strpath);
+}
+
+void DynamicRaveDatabase::LazyPlugin::OnRaveInitialized()
+{
+    std::lock_guard<std::mutex> lock(_mutexload);
+    _bRaveInitialized = true;
+    if( !!_pplugin ) {
+        _pplugin->OnRaveInitialized();
+    }
+}
+
+void DynamicRaveDatabase::LazyPlugin::OnRavePreDestroy()
+{
+    std::lock_guard<std::mutex> lock(_mutexload);
+    if( !!_pplugin ) {
+        _pplugin->OnRavePreDestroy();
+    }
+}
+
+void DynamicRaveDatabase::LazyPlugin::Destroy()
+{
+    std::lock_guard<std::mutex> lock(_mutexload);
+    if( !!_pplugin ) {
+        _pplugin->Destroy();
+        _pplugin.reset();
+    }
+}
+
+PluginPtr DynamicRaveDatabase::LazyPlugin::_Load()
+{
+    if( !!_pplugin || _bLoadFailed ) {
+        return _pplugin;
+    }
+    RAVELOG_DEBUG_FORMAT("loading deferred plugin %s from %s", _pluginname % _pluginpath);
+    DynamicLibrary dylib(_pluginpath);
+    RavePlugin* plugin = _OpenPlugin(_pluginpath, dylib);
+    if( !plugin ) {
+        _bLoadFailed = true;
+        return PluginPtr();
+    }
+    {
+        // keep the library open as long as the plugin and its interfaces, like _LoadPlugin does
+        std::lock_guard<std::mutex> lock(_database._mutex);
+        _database._mapLibraryHandles.emplace(_pluginpath, std::move(dylib));
+    }
+    _pplugin.reset(plugin);
+    _pplugin->SetPluginPath(_pluginpath);
+    if( _bRaveInitialized ) {
+        _pplugin->OnRaveInitialized();
+    }
+    return _pplugin;
+}
+
+InterfaceBasePtr DynamicRaveDatabase::LazyPlugin::CreateInterface(InterfaceType type, const std::string& interfacename, std::istream& sinput, EnvironmentBasePtr penv)
+{
+    PluginPtr pplugin;
+    {
+        std::lock_guard<std::mutex> lock(_mutexload);
+        pplugin = _Load();
+    }
+    if( !pplugin ) {
+        return InterfaceBasePtr();
+    }
+    // the real plugin parses the name again, so pass the remaining creation arguments along with it
+    std::string name = interfacename;
+    std::string remaining((std::istreambuf_iterator<char>(sinput)), std::istreambuf_iterator<char>());
+    if( !remaining.empty() ) {
+        name += remaining;
+    }
+    return pplugin->OpenRAVECreateInterface(type, name, RaveGetInterfaceHash(type), OPENRAVE_ENVIRONMENT_HASH, penv);
+}
+
 } // namespace OpenRAVE
 
 #endif // !OPENRAVE_STATIC_PLUGINS
@@ -26,6 +26,7 @@
 
 #include <mutex>
 #include <boost/shared_ptr.hpp>
+#include <map>
 #include <unordered_map>
 
 namespace OpenRAVE {
@@ -37,7 +38,10 @@ public:
     DynamicRaveDatabase(DynamicRaveDatabase&&) = default;
     ~DynamicRaveDatabase() override;
 
-    void Init() override; ///< Initializes by identifying environment variables and loading paths from $OPENRAVE_PLUGINS, then loads plugins
+    /// \brief Initializes by identifying environment variables and loading paths from $OPENRAVE_PLUGINS, then loads plugins
+    ///
+    /// \param bLoadAllPlugins if false, plugins whose interfaces are already recorded in the plugin manifest are not opened until one of their interfaces is created
+    void Init(bool bLoadAllPlugins) override;
 
     void ReloadPlugins() override;
     bool LoadPlugin(const std::string& libraryname) override;
@@ -58,11 +62,70 @@ private:
         void* _handle;
     };
 
+    /// \brief what the plugin manifest remembers about one shared object
+    struct PluginManifestEntry
+    {
+        int64_t mtime = 0; ///< last modification time of the shared object, entry is stale if it differs
+        int64_t filesize = 0;
+        std::string pluginname;
+        RavePlugin::InterfaceMap interfaces;
+    };
+
+    /// \brief Stands in for a plugin recorded in the manifest, only opens the shared object on the first CreateInterface.
+    class LazyPlugin final : public RavePlugin
+    {
+public:
+        LazyPlugin(DynamicRaveDatabase& database, const std::string& strpath, const PluginManifestEntry& entry);
+
+        void OnRaveInitialized() override;
+        void OnRavePreDestroy() override;
+        void Destroy() override;
+
+        const InterfaceMap& GetInterfaces() const override
+        {
+            return _interfaces;
+        }
+
+        const std::string& GetPluginName() const override
+        {
+            return _pluginname;
+        }
+
+protected:
+        OpenRAVE::InterfaceBasePtr CreateInterface(OpenRAVE::InterfaceType type, const std::string& interfacename, std::istream& sinput, OpenRAVE::EnvironmentBasePtr penv) override;
+
+private:
+        /// \brief opens the shared object if it is not open yet. _mutexload has to be locked.
+        PluginPtr _Load();
+
+        DynamicRaveDatabase& _database; ///< keeps the library handle once opened, owns this plugin
+        std::string _pluginname;
+        InterfaceMap _interfaces;
+        std::mutex _mutexload;
+        PluginPtr _pplugin; ///< the real plugin once opened
+        bool _bLoadFailed = false;
+        bool _bRaveInitialized = false;
+    };
+
     void _LoadPluginsFromPath(const std::string&, bool recurse = false);
     bool _LoadPlugin(const std::string&); ///< Attempts to load a RavePlugin from a shared object, fails liberally if the right symbols cannot be found. Locks _mutex.
 
+    /// \brief checks the manifest for strpath and registers a LazyPlugin if the entry is still valid, otherwise loads the plugin and records it.
+    bool _AddPluginFromManifest(const std::string& strpath);
+
+    /// \brief opens the shared object and constructs its RavePlugin, does not register it.
+    static RavePlugin* _OpenPlugin(const std::string& strpath, DynamicLibrary& dylib);
+
+    void _ReadPluginManifest();
+    void _WritePluginManifest();
+
     std::vector<std::string> _vPluginDirs; ///< List of plugin directories
     std::unordered_map<std::string, DynamicLibrary> _mapLibraryHandles; ///< A map of paths to *open* shared object handles.
+
+    std::string _manifestfilename; ///< where the plugin manifest is cached, empty if not used
+    std::map<std::string, PluginManifestEntry> _mapManifest; ///< plugin path -> recorded interfaces
+    bool _bLoadAllPlugins = true;
+    bool _bManifestModified = false;
 };
 
 } // end namespace OpenRAVE
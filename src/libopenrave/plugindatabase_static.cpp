@@ -27,7 +27,7 @@
 
 namespace OpenRAVE {
 
-void StaticRaveDatabase::Init()
+void StaticRaveDatabase::Init(bool bLoadAllPlugins)
 {
     _vPlugins.emplace_back(boost::make_shared<BaseRobotsPlugin>());      _vPlugins.back()->SetPluginPath("__static__");
     _vPlugins.emplace_back(boost::make_shared<BaseControllersPlugin>()); _vPlugins.back()->SetPluginPath("__static__");
@@ -28,7 +28,8 @@ class RaveDatabase
 public:
     virtual ~RaveDatabase() {}
 
-    virtual void Init() = 0;
+    /// \param bLoadAllPlugins if false, the database may defer opening plugins until their interfaces are needed
+    virtual void Init(bool bLoadAllPlugins) = 0;
     virtual void Destroy();
     virtual InterfaceBasePtr Create(EnvironmentBasePtr penv, InterfaceType type, std::string name);
     virtual void OnRaveInitialized();
@@ -96,7 +97,7 @@ class StaticRaveDatabase final : public RaveDatabase {
 public:
     ~StaticRaveDatabase() override {}
 
-    void Init() override;
+    void Init(bool bLoadAllPlugins) override;
     void ReloadPlugins() override {}
     bool LoadPlugin(const std::string& libraryname) override;
 };
@@ -0,0 +1,397 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2026 OpenRAVE Contributors
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "libopenrave.h"
+
+#include <deque>
+#include <limits>
+#include <mutex>
+
+namespace OpenRAVE {
+
+std::atomic<bool> g_bRaveProfilingEnabled(false);
+
+namespace {
+
+static const uint64_t s_nProfileEventCapacity = 1<<14; ///< number of most recent scopes kept per thread, power of 2
+static const uint32_t s_nProfileSlotCapacity = 1<<10; ///< maximum number of distinct names per thread, power of 2
+
+/// \brief bumped by RaveResetProfiling, buffers of an older generation are ignored until their thread clears them
+static std::atomic<uint64_t> s_nProfileGeneration(1);
+
+/// \brief one recorded scope. The fields are relaxed atomics since the scopes are read by other threads while the owning thread writes.
+struct ProfileEvent
+{
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> starttime;
+    std::atomic<uint64_t> duration;
+};
+
+/// \brief accumulated statistics of one name in the open addressing table of a thread
+struct ProfileSlot
+{
+    std::atomic<const char*> name; ///< NULL if unused
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> totalns;
+    std::atomic<uint64_t> minns;
+    std::atomic<uint64_t> maxns;
+    std::atomic<bool> bcounter;
+};
+
+typedef std::vector< std::pair<const char*, std::pair<uint64_t, uint64_t> > > ProfileEventList; ///< name, start time and duration of scopes
+
+/// \brief adds the statistics of one thread to the ones accumulated in mapstatistics
+static void _MergeProfileStatistics(std::map<std::string, ProfileStatistics>& mapstatistics, const ProfileStatistics& statistics)
+{
+    std::map<std::string, ProfileStatistics>::iterator it = mapstatistics.find(statistics.name);
+    if( it == mapstatistics.end() ) {
+        mapstatistics[statistics.name] = statistics;
+        return;
+    }
+    ProfileStatistics& merged = it->second;
+    if( merged.count == 0 || (statistics.count > 0 && statistics.minns < merged.minns) ) {
+        merged.minns = statistics.minns;
+    }
+    merged.count += statistics.count;
+    merged.totalns += statistics.totalns;
+    merged.maxns = std::max(merged.maxns, statistics.maxns);
+}
+
+/// \brief buffers of one thread. Only the owning thread writes, so all updates are plain relaxed loads and stores.
+class ProfileThreadBuffer
+{
+public:
+    ProfileThreadBuffer(int threadindex) : _threadindex(threadindex), _vevents(s_nProfileEventCapacity), _vslots(s_nProfileSlotCapacity), _nwrite(0), _generation(0)
+    {
+        _Clear();
+    }
+
+    void AddScope(const char* name, uint64_t starttime, uint64_t duration)
+    {
+        _CheckGeneration();
+        uint64_t index = _nwrite.load(std::memory_order_relaxed);
+        // readers that see the new event see that the slot is being overwritten, see GetEvents
+        std::atomic_thread_fence(std::memory_order_release);
+        ProfileEvent& event = _vevents[index & (s_nProfileEventCapacity-1)];
+        event.name.store(name, std::memory_order_relaxed);
+        event.starttime.store(starttime, std::memory_order_relaxed);
+        event.duration.store(duration, std::memory_order_relaxed);
+        _nwrite.store(index+1, std::memory_order_release);
+
+        ProfileSlot* pslot = _FindSlot(name, false);
+        if( !!pslot ) {
+            pslot->count.store(pslot->count.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+            pslot->totalns.store(pslot->totalns.load(std::memory_order_relaxed)+duration, std::memory_order_relaxed);
+            if( duration < pslot->minns.load(std::memory_order_relaxed) ) {
+                pslot->minns.store(duration, std::memory_order_relaxed);
+            }
+            if( duration > pslot->maxns.load(std::memory_order_relaxed) ) {
+                pslot->maxns.store(duration, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void AddCount(const char* name, int64_t count)
+    {
+        _CheckGeneration();
+        ProfileSlot* pslot = _FindSlot(name, true);
+        if( !!pslot ) {
+            pslot->count.store(pslot->count.load(std::memory_order_relaxed)+count, std::memory_order_relaxed);
+        }
+    }
+
+    /// \brief called by other threads, adds the statistics of this thread to mapstatistics. Returns false if the buffer was cleared while reading.
+    bool GetStatistics(std::map<std::string, ProfileStatistics>& mapstatistics) const
+    {
+        uint64_t generation = _generation.load(std::memory_order_acquire);
+        if( generation != s_nProfileGeneration.load(std::memory_order_acquire) ) {
+            return true;
+        }
+        std::vector<ProfileStatistics> vstatistics;
+        for(const ProfileSlot& slot : _vslots) {
+            const char* name = slot.name.load(std::memory_order_acquire);
+            if( !name ) {
+                continue;
+            }
+            ProfileStatistics statistics;
+            statistics.name = name;
+            statistics.count = slot.count.load(std::memory_order_relaxed);
+            statistics.bcounter = slot.bcounter.load(std::memory_order_relaxed);
+            if( !statistics.bcounter ) {
+                statistics.totalns = slot.totalns.load(std::memory_order_relaxed);
+                statistics.minns = slot.minns.load(std::memory_order_relaxed);
+                statistics.maxns = slot.maxns.load(std::memory_order_relaxed);
+            }
+            vstatistics.push_back(statistics);
+        }
+        if( _generation.load(std::memory_order_acquire) != generation ) {
+            return false;
+        }
+        for(const ProfileStatistics& statistics : vstatistics) {
+            _MergeProfileStatistics(mapstatistics, statistics);
+        }
+        return true;
+    }
+
+    /// \brief called by other threads, returns the scopes still in the ring buffer in the order they were recorded
+    void GetEvents(ProfileEventList& vevents) const
+    {
+        vevents.clear();
+        uint64_t generation = _generation.load(std::memory_order_acquire);
+        if( generation != s_nProfileGeneration.load(std::memory_order_acquire) ) {
+            return;
+        }
+        uint64_t nend = _nwrite.load(std::memory_order_acquire);
+        uint64_t nstart = nend > s_nProfileEventCapacity ? nend - s_nProfileEventCapacity : 0;
+        vevents.reserve(nend-nstart);
+        for(uint64_t index = nstart; index < nend; ++index) {
+            const ProfileEvent& event = _vevents[index & (s_nProfileEventCapacity-1)];
+            vevents.push_back(std::make_pair(event.name.load(std::memory_order_relaxed), std::make_pair(event.starttime.load(std::memory_order_relaxed), event.duration.load(std::memory_order_relaxed))));
+        }
+        // discard the scopes the owning thread overwrote while copying, the event of index nwritten could be in the middle of being written
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t nwritten = _nwrite.load(std::memory_order_relaxed);
+        if( _generation.load(std::memory_order_acquire) != generation ) {
+            vevents.clear();
+        }
+        else if( nwritten + 1 > nstart + s_nProfileEventCapacity ) {
+            uint64_t noverwritten = std::min(nwritten + 1 - nstart - s_nProfileEventCapacity, (uint64_t)vevents.size());
+            vevents.erase(vevents.begin(), vevents.begin()+noverwritten);
+        }
+    }
+
+    inline int GetThreadIndex() const {
+        return _threadindex;
+    }
+
+private:
+    /// \brief clears the buffers if RaveResetProfiling was called since the last record
+    inline void _CheckGeneration()
+    {
+        uint64_t generation = s_nProfileGeneration.load(std::memory_order_acquire);
+        if( _generation.load(std::memory_order_relaxed) != generation ) {
+            _Clear();
+            _generation.store(generation, std::memory_order_release);
+        }
+    }
+
+    void _Clear()
+    {
+        for(ProfileSlot& slot : _vslots) {
+            slot.name.store(NULL, std::memory_order_relaxed);
+            slot.count.store(0, std::memory_order_relaxed);
+            slot.totalns.store(0, std::memory_order_relaxed);
+            slot.minns.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+            slot.maxns.store(0, std::memory_order_relaxed);
+            slot.bcounter.store(false, std::memory_order_relaxed);
+        }
+        _nwrite.store(0, std::memory_order_relaxed);
+    }
+
+    /// \brief returns the slot of name, inserting it if necessary. Returns NULL if the table is full.
+    ProfileSlot* _FindSlot(const char* name, bool bcounter)
+    {
+        uint32_t index = (uint32_t)(((uintptr_t)name >> 3) * 2654435761u) & (s_nProfileSlotCapacity-1);
+        for(uint32_t probe = 0; probe < s_nProfileSlotCapacity; ++probe) {
+            ProfileSlot& slot = _vslots[(index+probe) & (s_nProfileSlotCapacity-1)];
+            const char* slotname = slot.name.load(std::memory_order_relaxed);
+            if( slotname == name ) {
+                return &slot;
+            }
+            if( !slotname ) {
+                slot.bcounter.store(bcounter, std::memory_order_relaxed);
+                slot.name.store(name, std::memory_order_release);
+                return &slot;
+            }
+        }
+        return NULL;
+    }
+
+    int _threadindex;
+    std::vector<ProfileEvent> _vevents; ///< ring buffer of the most recent scopes
+    std::vector<ProfileSlot> _vslots;
+    std::atomic<uint64_t> _nwrite; ///< total number of scopes written since the last clear
+    std::atomic<uint64_t> _generation;
+};
+
+typedef boost::shared_ptr<ProfileThreadBuffer> ProfileThreadBufferPtr;
+
+static const size_t s_nMaxFinishedProfileThreads = 8; ///< number of exited threads whose most recent scopes are kept for the trace
+
+/// \brief most recent scopes of a thread that exited
+struct FinishedProfileThread
+{
+    int threadindex;
+    ProfileEventList vevents;
+};
+
+/// \brief all the thread buffers, the mutex is only taken once per thread and when querying
+static std::mutex s_mutexProfileBuffers;
+static std::vector<ProfileThreadBufferPtr> s_vProfileBuffers; ///< buffers of the running threads
+static std::map<std::string, ProfileStatistics> s_mapFinishedProfileStatistics; ///< statistics of the threads that exited since the last reset
+static std::deque<FinishedProfileThread> s_listFinishedProfileThreads; ///< scopes of the last s_nMaxFinishedProfileThreads threads that exited since the last reset
+static int s_nProfileThreadIndex = 0;
+
+/// \brief owns the buffer of the calling thread. When the thread exits, folds the buffer into the finished statistics and frees it.
+class ProfileThreadBufferHolder
+{
+public:
+    ~ProfileThreadBufferHolder()
+    {
+        if( !_pbuffer ) {
+            return;
+        }
+        // the owning thread does not write anymore, and holding the mutex keeps RaveResetProfiling from running in between.
+        // statistics and scopes recorded before the last reset are ignored by the buffer
+        std::lock_guard<std::mutex> lock(s_mutexProfileBuffers);
+        FinishedProfileThread finished;
+        finished.threadindex = _pbuffer->GetThreadIndex();
+        _pbuffer->GetEvents(finished.vevents);
+        _pbuffer->GetStatistics(s_mapFinishedProfileStatistics);
+        if( finished.vevents.size() > 0 ) {
+            if( s_listFinishedProfileThreads.size() >= s_nMaxFinishedProfileThreads ) {
+                s_listFinishedProfileThreads.pop_front();
+            }
+            s_listFinishedProfileThreads.push_back(std::move(finished));
+        }
+        s_vProfileBuffers.erase(std::remove(s_vProfileBuffers.begin(), s_vProfileBuffers.end(), _pbuffer), s_vProfileBuffers.end());
+    }
+
+    inline ProfileThreadBuffer& GetBuffer()
+    {
+        if( !_pbuffer ) {
+            std::lock_guard<std::mutex> lock(s_mutexProfileBuffers);
+            _pbuffer.reset(new ProfileThreadBuffer(s_nProfileThreadIndex++));
+            s_vProfileBuffers.push_back(_pbuffer);
+        }
+        return *_pbuffer;
+    }
+
+private:
+    ProfileThreadBufferPtr _pbuffer;
+};
+
+static thread_local ProfileThreadBufferHolder s_profileThreadBufferHolder;
+
+/// \brief writes s as a JSON string
+static void _WriteJsonString(std::ostream& os, const char* s)
+{
+    os << '"';
+    for(; *s != 0; ++s) {
+        if( *s == '"' || *s == '\\' ) {
+            os << '\\' << *s;
+        }
+        else if( (unsigned char)*s >= 0x20 ) {
+            os << *s;
+        }
+    }
+    os << '"';
+}
+
+} // end namespace
+
+void RaveSetProfilingEnabled(bool bEnabled)
+{
+    g_bRaveProfilingEnabled.store(bEnabled, std::memory_order_relaxed);
+}
+
+void RaveProfileScope(const char* name, uint64_t starttime, uint64_t duration)
+{
+    s_profileThreadBufferHolder.GetBuffer().AddScope(name, starttime, duration);
+}
+
+void RaveProfileCount(const char* name, int64_t count)
+{
+    s_profileThreadBufferHolder.GetBuffer().AddCount(name, count);
+}
+
+void RaveGetProfileStatistics(std::vector<ProfileStatistics>& vstatistics)
+{
+    std::vector<ProfileThreadBufferPtr> vbuffers;
+    std::map<std::string, ProfileStatistics> mapstatistics;
+    {
+        std::lock_guard<std::mutex> lock(s_mutexProfileBuffers);
+        vbuffers = s_vProfileBuffers;
+        mapstatistics = s_mapFinishedProfileStatistics;
+    }
+    for(const ProfileThreadBufferPtr& pbuffer : vbuffers) {
+        // the owning thread only clears its buffer once after a reset, so retrying terminates
+        while( !pbuffer->GetStatistics(mapstatistics) ) {
+        }
+    }
+    vstatistics.clear();
+    vstatistics.reserve(mapstatistics.size());
+    for(std::map<std::string, ProfileStatistics>::const_iterator it = mapstatistics.begin(); it != mapstatistics.end(); ++it) {
+        vstatistics.push_back(it->second);
+    }
+}
+
+void RaveWriteProfileChromeTrace(std::ostream& os)
+{
+    std::vector<ProfileThreadBufferPtr> vbuffers;
+    std::vector<FinishedProfileThread> vthreads;
+    {
+        std::lock_guard<std::mutex> lock(s_mutexProfileBuffers);
+        vbuffers = s_vProfileBuffers;
+        vthreads.assign(s_listFinishedProfileThreads.begin(), s_listFinishedProfileThreads.end());
+    }
+    const size_t numfinished = vthreads.size();
+    vthreads.resize(numfinished + vbuffers.size());
+    for(size_t ibuffer = 0; ibuffer < vbuffers.size(); ++ibuffer) {
+        vthreads[numfinished+ibuffer].threadindex = vbuffers[ibuffer]->GetThreadIndex();
+        vbuffers[ibuffer]->GetEvents(vthreads[numfinished+ibuffer].vevents);
+    }
+    uint64_t starttime = std::numeric_limits<uint64_t>::max();
+    for(const FinishedProfileThread& thread : vthreads) {
+        for(const std::pair<const char*, std::pair<uint64_t, uint64_t> >& event : thread.vevents) {
+            starttime = std::min(starttime, event.second.first);
+        }
+    }
+
+    std::ios_base::fmtflags oldflags = os.flags();
+    std::streamsize oldprecision = os.precision();
+    os << std::fixed << std::setprecision(3);
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool bfirst = true;
+    for(const FinishedProfileThread& thread : vthreads) {
+        int tid = thread.threadindex;
+        if( thread.vevents.size() > 0 ) {
+            if( !bfirst ) {
+                os << ",";
+            }
+            bfirst = false;
+            os << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid << ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+        }
+        for(const std::pair<const char*, std::pair<uint64_t, uint64_t> >& event : thread.vevents) {
+            os << ",\n{\"name\":";
+            _WriteJsonString(os, event.first);
+            os << ",\"cat\":\"openrave\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid << ",\"ts\":" << (event.second.first - starttime)*1e-3 << ",\"dur\":" << event.second.second*1e-3 << "}";
+        }
+    }
+    os << "\n]}\n";
+    os.flags(oldflags);
+    os.precision(oldprecision);
+}
+
+void RaveResetProfiling()
+{
+    s_nProfileGeneration.fetch_add(1, std::memory_order_acq_rel);
+    std::lock_guard<std::mutex> lock(s_mutexProfileBuffers);
+    s_mapFinishedProfileStatistics.clear();
+    s_listFinishedProfileThreads.clear();
+}
+
+} // end namespace OpenRAVE
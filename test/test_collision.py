@@ -82,6 +82,31 @@ class RunCollision(EnvironmentSetup):
             assert(not target1.CheckSelfCollision())
             assert(self.env.CheckCollision(target1,report))
 
+    def test_selfcollisionlinkpairculling(self):
+        self.log.info('culled link pairs should never be in collision')
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        robot=env.GetRobots()[0]
+        with env:
+            links = robot.GetLinks()
+            nonadjacent = robot.GetNonAdjacentLinks()
+            numremoved = robot.ComputeSelfCollisionLinkPairCulling()
+            assert(numremoved >= 0)
+            culledpairs = set(nonadjacent) - set(robot.GetNonAdjacentLinks())
+            assert(len(culledpairs) == numremoved)
+            lower,upper = robot.GetDOFLimits()
+            for i in range(200):
+                robot.SetDOFValues(lower+random.rand(len(lower))*(upper-lower))
+                for index0,index1 in nonadjacent:
+                    if (index0,index1) in culledpairs or robot.IsLinkPairCollisionFree(index0,index1):
+                        assert(not env.CheckCollision(links[index0],links[index1]))
+
+            # changing the joint limits invalidates the culling
+            robot.SetDOFLimits(lower+0.01,upper-0.01)
+            assert(set(robot.GetNonAdjacentLinks()) == set(nonadjacent))
+            for index0,index1 in nonadjacent:
+                assert(not robot.IsLinkPairCollisionFree(index0,index1))
+
     def test_attachedbodiescollision(self):
         with self.env:
             self.LoadEnv('data/lab1.env.xml')
@@ -271,6 +296,59 @@ class RunCollision(EnvironmentSetup):
         manip.CheckEndEffectorCollision(report)
         assert(len(report.collisionInfos)==4)
 
+    def test_indexonlyreport(self):
+        env=self.env
+        env.GetCollisionChecker().SetCollisionOptions(CollisionOptions.AllLinkCollisions)
+        self.LoadEnv('data/lab1.env.xml')
+        robot = env.GetRobots()[0]
+        manip = robot.GetManipulators()[0]
+        body1 = env.GetKinBody('mug1')
+        body2 = env.GetKinBody('mug2')
+
+        body1.SetTransform(manip.GetEndEffector().GetTransform())
+        body2.SetTransform(manip.GetEndEffector().GetTransform())
+
+        report = CollisionReport()
+        env.CheckCollision(robot,report=report)
+        assert(not report.bIndexOnly)
+        names = sorted([(info.bodyLinkGeom1Name, info.bodyLinkGeom2Name) for info in report.collisionInfos])
+
+        indexreport = CollisionReport()
+        indexreport.bIndexOnly = True
+        env.CheckCollision(robot,report=indexreport)
+        assert(indexreport.bIndexOnly)
+        assert(len(indexreport.collisionInfos)==len(report.collisionInfos))
+        for info in indexreport.collisionInfos:
+            assert(info.bodyLinkGeom1Name == '' and info.bodyLinkGeom2Name == '')
+            assert(info.bodyIndex1 == robot.GetEnvironmentBodyIndex())
+            assert(info.bodyIndex2 in [body1.GetEnvironmentBodyIndex(), body2.GetEnvironmentBodyIndex()])
+            assert(info.linkIndex1 >= 0 and info.linkIndex2 >= 0)
+
+        # the links can be matched without the names
+        for info in indexreport.collisionInfos:
+            body = env.GetBodyFromEnvironmentBodyIndex(info.bodyIndex2)
+            assert(info.FindFirstMatchingLinkIndex(robot.GetLinks()) == info.linkIndex1)
+            assert(info.FindSecondMatchingLinkIndex(body.GetLinks()) == info.linkIndex2)
+            assert(info.FindFirstMatchingLinkIndex(body.GetLinks()) == -1)
+            assert(info.FindSecondMatchingLinkIndex(robot.GetLinks()) == -1)
+
+        assert(indexreport.ResolveNames(env))
+        indexnames = sorted([(info.bodyLinkGeom1Name, info.bodyLinkGeom2Name) for info in indexreport.collisionInfos])
+        assert(indexnames == names)
+
+        # FindSecondMatchingLinkIndex has to look at the second collision when the names are set
+        for info in report.collisionInfos:
+            bodyname, linkname, geomname = info.ExtractSecondBodyLinkGeomNames()
+            body = env.GetKinBody(bodyname)
+            assert(info.FindSecondMatchingLinkIndex(body.GetLinks()) == body.GetLink(linkname).GetIndex())
+            assert(info.FindSecondMatchingLinkIndex(robot.GetLinks()) == -1)
+            bodyname, linkname, geomname = info.ExtractFirstBodyLinkGeomNames()
+            assert(info.FindFirstMatchingLinkIndex(robot.GetLinks()) == robot.GetLink(linkname).GetIndex())
+
+        # the mode is kept by Reset
+        indexreport.Reset()
+        assert(indexreport.bIndexOnly)
+
 #generate_classes(RunCollision, globals(), [('ode','ode'),('bullet','bullet')])
 
 class test_ode(RunCollision):
@@ -281,6 +359,117 @@ class test_fcl(RunCollision):
     def __init__(self):
         RunCollision.__init__(self, 'fcl_')
 
+    def test_clonesharedgeometries(self):
+        self.log.info('a checker cloned with the bodies reuses the mesh geometries of the reference and reports the same collisions')
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot = env.GetRobots()[0]
+        manip = robot.GetManipulators()[0]
+        mug = env.GetKinBody('mug1')
+        lower,upper = robot.GetDOFLimits()
+        random.seed(0)
+        configurations = [lower+random.rand(len(lower))*(upper-lower) for i in range(20)]
+
+        def checkcollisions(cloneenv):
+            results = []
+            with cloneenv:
+                clonerobot = cloneenv.GetRobot(robot.GetName())
+                clonemug = cloneenv.GetKinBody(mug.GetName())
+                clonemug.SetTransform(clonerobot.GetManipulators()[0].GetEndEffector().GetTransform())
+                report = CollisionReport()
+                assert(cloneenv.CheckCollision(clonerobot,report=report))
+                results.append(sorted([(info.bodyLinkGeom1Name, info.bodyLinkGeom2Name) for info in report.collisionInfos]))
+                clonemug.SetTransform(eye(4))
+                for values in configurations:
+                    clonerobot.SetDOFValues(values)
+                    report = CollisionReport()
+                    bcollision = cloneenv.CheckCollision(clonerobot,report=report)
+                    bselfcollision = clonerobot.CheckSelfCollision()
+                    results.append((bcollision, bselfcollision, sorted([(info.bodyLinkGeom1Name, info.bodyLinkGeom2Name) for info in report.collisionInfos])))
+            return results
+
+        with env:
+            # the bodies have to be initialized in the reference checker for their geometries to be shared
+            env.CheckCollision(robot)
+            expectedresults = checkcollisions(env)
+            assert(len(expectedresults[0]) > 0)
+            robot.SetDOFValues(lower)
+            cloneenv = env.CloneSelf(CloningOptions.Bodies)
+        try:
+            cloneresults = checkcollisions(cloneenv)
+            assert(cloneresults == expectedresults)
+            numshared = int(cloneenv.GetCollisionChecker().SendCommand('GetNumSharedGeometries'))
+            assert(numshared > 0)
+            # the reference keeps working on its own geometries
+            assert(checkcollisions(env) == expectedresults)
+        finally:
+            cloneenv.Destroy()
+
+    def test_convexdecomposition(self):
+        self.log.info('decompose a non-convex mesh into convex pieces and check that fcl reports the same collisions with them')
+        env=self.env
+        # extruded U, its notch is outside of every convex piece but inside the convex hull of the whole mesh
+        polygon = [(-0.3,-0.3),(0.3,-0.3),(0.3,-0.2),(0.3,0.3),(0.2,0.3),(0.2,-0.2),(-0.2,-0.2),(-0.2,0.3),(-0.3,0.3),(-0.3,-0.2)]
+        height = 0.1
+        numpoints = len(polygon)
+        vertices = [(x,y,0) for x,y in polygon] + [(x,y,height) for x,y in polygon]
+        indices = []
+        for i0,i1,i2 in [(0,1,2),(0,2,5),(0,5,6),(0,6,9),(2,3,4),(2,4,5),(9,6,7),(9,7,8)]:
+            indices.append([i0,i2,i1])
+            indices.append([numpoints+i0,numpoints+i1,numpoints+i2])
+        for i in range(numpoints):
+            inext = (i+1)%numpoints
+            indices.append([i,inext,numpoints+inext])
+            indices.append([i,numpoints+inext,numpoints+i])
+        vertices = array(vertices)
+        with env:
+            ubody = RaveCreateKinBody(env,'')
+            ubody.InitFromTrimesh(TriMesh(vertices,array(indices,int32)),True)
+            ubody.SetName('ubody')
+            env.Add(ubody)
+            box = RaveCreateKinBody(env,'')
+            box.InitFromBoxes(array([[0,0,0,0.04,0.04,0.04]]),True)
+            box.SetName('box')
+            env.Add(box)
+
+            # positions of the box that clearly collide with the arms and the base of the U, or are clearly free inside the notch and around it
+            positions = [([0.25,0,0.05],True), ([-0.25,0.1,0.05],True), ([0,-0.25,0.05],True), ([0,0.1,0.05],False), ([0,0.1,0.25],False), ([0.6,0,0.05],False), ([0,-0.6,0.05],False)]
+            def checkpositions():
+                results = []
+                for position,bcolliding in positions:
+                    T = eye(4)
+                    T[0:3,3] = position
+                    box.SetTransform(T)
+                    results.append(env.CheckCollision(box,ubody))
+                return results
+            expectedresults = checkpositions()
+            assert(expectedresults == [bcolliding for position,bcolliding in positions])
+
+            module = RaveCreateModule(env,'ConvexDecomposition')
+            numpieces = int(module.SendCommand('Build body ubody nocache'))
+            assert(numpieces > 1)
+            geometryinfos = ubody.GetLinks()[0].GetGeometriesFromGroup('convexdecomposition')
+            assert(len(geometryinfos) == numpieces)
+            for geometryinfo in geometryinfos:
+                mesh = geometryinfo.GetCollisionMesh()
+                assert(len(mesh.indices) >= 4)
+                # the pieces are in the frame of the source geometry, which is the identity here
+                assert(all(numpy.min(mesh.vertices,0) >= numpy.min(vertices,0)-1e-3))
+                assert(all(numpy.max(mesh.vertices,0) <= numpy.max(vertices,0)+1e-3))
+                # every vertex of a convex piece is on the same side of each of its faces
+                for triangle in mesh.indices:
+                    v0,v1,v2 = mesh.vertices[triangle]
+                    normal = cross(v1-v0,v2-v0)
+                    if linalg.norm(normal) <= 1e-9:
+                        continue
+                    distances = dot(mesh.vertices-v0,normal/linalg.norm(normal))
+                    assert(all(distances <= 1e-4) or all(distances >= -1e-4))
+
+            checker = env.GetCollisionChecker()
+            assert(checker.SendCommand('SetConvexGeometryGroup convexdecomposition') is not None)
+            assert(checker.SetBodyGeometryGroup(ubody,'convexdecomposition'))
+            assert(checkpositions() == expectedresults)
+
 # class test_bullet(RunCollision):
 #     def __init__(self):
 #         RunCollision.__init__(self, 'bullet')
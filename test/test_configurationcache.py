@@ -310,3 +310,74 @@ class TestConfigurationCache(EnvironmentSetup):
                 cachedcollisions, cachedcollisionhits, cachedfreehits, cachesize = cachechecker.SendCommand('GetSelfCacheStatistics').split()
                 assert(int(cachesize)==0)
                 self.log.info('self cache reset test passed')
+
+    def _FillCacheChecker(self, env, robot, cachechecker, numsamples=300, delta=0.05):
+        originalvalues = robot.GetActiveDOFValues()
+        sampler = RaveCreateSpaceSampler(env, u'MT19937')
+        sampler.SetSpaceDOF(robot.GetActiveDOF())
+        with robot:
+            for iter in range(numsamples):
+                robot.SetActiveDOFValues(originalvalues + delta*(sampler.SampleSequence(SampleDataType.Real,1)-0.5))
+                env.CheckCollision(robot)
+        return int(cachechecker.SendCommand('GetCacheStatistics').split()[3])
+
+    def test_sharewithclones(self):
+        env = self.env
+        self.LoadEnv('data/lab1.env.xml')
+        with env:
+            robot = env.GetRobots()[0]
+            robot.SetActiveDOFs(range(7))
+            cachechecker = RaveCreateCollisionChecker(env,'CacheChecker')
+            assert(cachechecker.SendCommand('TrackRobotState %s'%robot.GetName()) is not None)
+            env.SetCollisionChecker(cachechecker)
+            cachesize = self._FillCacheChecker(env, robot, cachechecker)
+            assert(cachesize > 0)
+
+        # sharing is off by default
+        for bShare in [None, True, False]:
+            if bShare is not None:
+                cachechecker.SendCommand('SetShareCacheWithClones %d'%bShare)
+            cloneenv = env.CloneSelf(CloningOptions.Bodies)
+            try:
+                with cloneenv:
+                    clonechecker = cloneenv.GetCollisionChecker()
+                    clonecachesize = int(clonechecker.SendCommand('GetCacheStatistics').split()[3])
+                    if bShare:
+                        assert(clonecachesize == cachesize)
+                        # changing the clone environment makes the clone cache private, the reference cache has to stay the same
+                        cloneenv.Remove(cloneenv.GetBodies()[1])
+                        assert(int(cachechecker.SendCommand('GetCacheStatistics').split()[3]) == cachesize)
+                    else:
+                        assert(clonecachesize == 0)
+            finally:
+                cloneenv.Destroy()
+
+    def test_localizedinvalidation(self):
+        env = self.env
+        self.LoadEnv('data/lab1.env.xml')
+        with env:
+            robot = env.GetRobots()[0]
+            robot.SetActiveDOFs(range(7))
+            cachechecker = RaveCreateCollisionChecker(env,'CacheChecker')
+            assert(cachechecker.SendCommand('TrackRobotState %s'%robot.GetName()) is not None)
+            env.SetCollisionChecker(cachechecker)
+            assert(cachechecker.SendCommand('SetLinkSpherePadding 0.01') is not None)
+            cachesize = self._FillCacheChecker(env, robot, cachechecker)
+            assert(cachesize > 0)
+
+            box = RaveCreateKinBody(env,'')
+            box.SetName('invalidationbox')
+            box.InitFromBoxes(array([[0,0,0,0.02,0.02,0.02]]),True)
+            Tbox = eye(4)
+            Tbox[0:3,3] = robot.GetTransform()[0:3,3] + [20,20,20]
+            box.SetTransform(Tbox)
+            env.Add(box)
+            # a body far away from all robot links does not invalidate anything
+            assert(int(cachechecker.SendCommand('GetCacheStatistics').split()[3]) == cachesize)
+
+            Tbox[0:3,3] = robot.GetActiveManipulator().GetTransform()[0:3,3]
+            box.SetTransform(Tbox)
+            # the configurations around the current one all have the end effector close to the box
+            newcachesize = int(cachechecker.SendCommand('GetCacheStatistics').split()[3])
+            assert(newcachesize < cachesize)
+            assert(int(cachechecker.SendCommand('ValidateCache')) == 1)
@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 from common_test_openrave import *
+import struct
 
 class RunController(EnvironmentSetup):
     def __init__(self,controllername):
@@ -69,3 +70,134 @@ class test_ideal(RunController):
 #     def __init__(self):
 #         RunController.__init__(self, 'bullet')
 # 
+
+class test_streaming(EnvironmentSetup):
+    def _InitStreaming(self):
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        robot=env.GetRobots()[0]
+        with env:
+            dofindices = robot.GetActiveManipulator().GetArmIndices()
+            controller = RaveCreateController(env,'streamingcontroller')
+            robot.SetController(controller,dofindices,0)
+            robot.SetActiveDOFs(dofindices)
+            lower,upper = robot.GetActiveDOFLimits()
+            traj = RaveCreateTrajectory(env,'')
+            traj.Init(robot.GetActiveConfigurationSpecification('quadratic'))
+            traj.Insert(0,r_[robot.GetActiveDOFValues(),numpy.minimum(upper-0.01,robot.GetActiveDOFValues()+0.3)])
+            ret=planningutils.RetimeActiveDOFTrajectory(traj,robot,False,1,1,'ParabolicTrajectoryRetimer2')
+            assert(ret.statusCode==PlannerStatusCode.HasSolution)
+        return robot, controller, dofindices, traj
+
+    def _GetBufferState(self, controller):
+        writeindex, readindex, trajectoryendindex, capacity, generation = [int(s) for s in controller.SendCommand('GetBufferState').split()]
+        return writeindex, readindex, trajectoryendindex, capacity, generation
+
+    def _GetExpectedSetpoint(self, robot, dofindices, traj, index):
+        data = traj.Sample(min(traj.GetDuration(), index*0.001))
+        spec = traj.GetConfigurationSpecification()
+        return spec.ExtractJointValues(data,robot,dofindices,0), spec.ExtractJointValues(data,robot,dofindices,1)
+
+    def test_commands(self):
+        robot, controller, dofindices, traj = self._InitStreaming()
+        writeindex, readindex, trajectoryendindex, capacity, generation = self._GetBufferState(controller)
+        assert(writeindex == 0 and readindex == 0 and trajectoryendindex == 0 and capacity == 4096)
+        # the capacity is rounded up to a power of two and every recreation starts a new generation
+        assert(controller.SendCommand('SetBufferCapacity 100') is not None)
+        assert(self._GetBufferState(controller)[3:] == (128, generation+1))
+        assert(controller.SendCommand('SetServoRate 500') is not None)
+        assert(self._GetBufferState(controller)[3:] == (128, generation+2))
+        assert(controller.SendCommand('SetServoRate 1000') is not None)
+        for command in ['SetServoRate 0', 'SetServoRate -1', 'SetBufferCapacity 0', 'SetLookahead -0.1', 'OpenSharedMemory']:
+            assert(controller.SendCommand(command) is None)
+        assert(self._GetBufferState(controller)[3:] == (128, generation+3))
+        # paused controllers do not accept trajectories
+        assert(controller.SendCommand('Pause 1') is not None)
+        assert(not robot.GetController().SetPath(traj))
+        assert(controller.SendCommand('Pause 0') is not None)
+        assert(robot.GetController().SetPath(traj))
+        assert(not robot.GetController().IsDone())
+        assert(self._GetBufferState(controller)[2] == int(ceil(traj.GetDuration()/0.001))+1)
+
+    def test_wraparound(self):
+        self.log.info('the controller consumes its own setpoints through a ring buffer much smaller than the trajectory')
+        env=self.env
+        robot, controller, dofindices, traj = self._InitStreaming()
+        assert(controller.SendCommand('SetBufferCapacity 16') is not None)
+        assert(controller.SendCommand('SetLookahead 0.01') is not None)
+        assert(robot.GetController().SetPath(traj))
+        numsteps = 0
+        while not robot.GetController().IsDone():
+            env.StepSimulation(0.002)
+            writeindex, readindex, trajectoryendindex, capacity, generation = self._GetBufferState(controller)
+            assert(readindex <= writeindex <= readindex+capacity)
+            values, velocities = self._GetExpectedSetpoint(robot, dofindices, traj, readindex-1)
+            assert(transdist(robot.GetDOFValues(dofindices), values) <= g_epsilon)
+            numsteps += 1
+            assert(numsteps < 10000)
+        assert(readindex > 4*capacity)
+        assert(transdist(robot.GetDOFValues(dofindices), traj.GetWaypoint(-1,robot.GetActiveConfigurationSpecification())) <= g_epsilon)
+
+    def test_sharedmemory(self):
+        self.log.info('an external consumer reads the setpoints from shared memory, the producer never overruns it and closes the old buffer when recreating it')
+        import mmap
+        env=self.env
+        robot, controller, dofindices, traj = self._InitStreaming()
+        dof = len(dofindices)
+        # offsets of streamingringbuffer.h
+        headersize, writeoffset, readoffset, closedoffset, generationoffset = 320, 64, 128, 256, 24
+        samplesize = 16*dof
+        shmname = 'openravestreamingtest%d'%os.getpid()
+        shmfilename = os.path.join('/dev/shm',shmname)
+        assert(controller.SendCommand('SetBufferCapacity 16') is not None)
+        assert(controller.SendCommand('SetLookahead 1.0') is not None)
+        assert(controller.SendCommand('OpenSharedMemory /'+shmname) is not None)
+        try:
+            def openbuffer():
+                with open(shmfilename,'r+b') as f:
+                    return mmap.mmap(f.fileno(), 0)
+            buf = openbuffer()
+            magic, version, bufferdof, capacity = struct.unpack_from('<IIII', buf, 0)
+            assert(version == 2 and bufferdof == dof and capacity == 16)
+            generation = struct.unpack_from('<Q', buf, generationoffset)[0]
+            assert(robot.GetController().SetPath(traj))
+
+            # without a consumer, the producer fills the buffer once and does not overwrite the unread setpoints
+            for i in range(10):
+                env.StepSimulation(0.01)
+            writeindex, readindex = struct.unpack_from('<Q', buf, writeoffset)[0], struct.unpack_from('<Q', buf, readoffset)[0]
+            assert(readindex == 0 and writeindex == capacity)
+            assert(not robot.GetController().IsDone())
+
+            # consume several times around the ring
+            readindex = 0
+            while readindex < 5*capacity:
+                writeindex = struct.unpack_from('<Q', buf, writeoffset)[0]
+                assert(readindex < writeindex <= readindex+capacity)
+                while readindex < writeindex:
+                    sample = struct.unpack_from('<%dd'%(2*dof), buf, headersize + samplesize*(readindex%capacity))
+                    values, velocities = self._GetExpectedSetpoint(robot, dofindices, traj, readindex)
+                    assert(transdist(array(sample[:dof]), values) <= g_epsilon)
+                    assert(transdist(array(sample[dof:]), velocities) <= g_epsilon)
+                    readindex += 1
+                struct.pack_into('<Q', buf, readoffset, readindex)
+                env.StepSimulation(0.01)
+            # the robot mirrors the last consumed setpoint
+            values, velocities = self._GetExpectedSetpoint(robot, dofindices, traj, readindex-1)
+            assert(transdist(robot.GetDOFValues(dofindices), values) <= g_epsilon)
+
+            # recreating the buffer closes the mapping of the consumer, the name then holds the next generation
+            assert(struct.unpack_from('<I', buf, closedoffset)[0] == 0)
+            assert(controller.SendCommand('SetServoRate 500') is not None)
+            assert(struct.unpack_from('<I', buf, closedoffset)[0] == 1)
+            buf.close()
+            buf = openbuffer()
+            assert(struct.unpack_from('<I', buf, closedoffset)[0] == 0)
+            assert(struct.unpack_from('<Q', buf, generationoffset)[0] == generation+1)
+            assert(controller.SendCommand('CloseSharedMemory') is not None)
+            assert(struct.unpack_from('<I', buf, closedoffset)[0] == 1)
+            assert(not os.path.exists(shmfilename))
+            buf.close()
+        finally:
+            if os.path.exists(shmfilename):
+                os.remove(shmfilename)
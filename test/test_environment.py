@@ -14,6 +14,8 @@
 from common_test_openrave import *
 from subprocess import Popen, PIPE
 import shutil
+import struct
+import tempfile
 import threading
 
 class TestEnvironment(EnvironmentSetup):
@@ -262,3 +264,239 @@ class TestEnvironment(EnvironmentSetup):
         # thread is done, so should be able to lock
         assert(env.Lock(1.0))
         env.Unlock()
+
+    def test_cameraraytracing(self):
+        self.log.info('ray traced camera images should report the depth and body of a box at a known distance')
+        env=self.env
+        with env:
+            box = RaveCreateKinBody(env,'')
+            # the face toward the camera is at z=1.4
+            box.InitFromBoxes(array([[0,0,1.5,0.2,0.2,0.1]]),True)
+            box.SetName('box')
+            env.Add(box)
+            sensor = RaveCreateSensor(env,'BaseCamera')
+            sensor.SetName('camera')
+            assert(sensor.SendCommand('setintrinsic 100 100 16 16') is not None)
+            assert(sensor.SendCommand('setdims 32 32') is not None)
+            assert(sensor.SendCommand('SetRayTracing 1 numthreads 4') is not None)
+            env.Add(sensor)
+            sensor.SetTransform(eye(4))
+            sensor.Configure(Sensor.ConfigureCommand.PowerOn)
+        for iframe in range(2):
+            # the second frame reuses the render threads of the first
+            env.StepSimulation(0.5)
+            data = sensor.GetSensorData(Sensor.Type.Camera)
+            assert(data.depthdata.shape == (32,32))
+            assert(data.bodyindices.shape == (32,32))
+            assert(data.pointclouddata.shape == (32,32,3))
+            # the box spans the pixels within 100*0.2/1.4 of the principal point
+            assert(abs(data.depthdata[16,16]-1.4) <= 1e-4)
+            assert(data.bodyindices[16,16] == box.GetEnvironmentBodyIndex())
+            assert(transdist(data.pointclouddata[16,16],[0,0,1.4]) <= 1e-3)
+            assert(data.depthdata[0,0] == 0)
+            assert(data.bodyindices[0,0] == 0)
+        sensor.Configure(Sensor.ConfigureCommand.PowerOff)
+
+    def test_profiling(self):
+        self.log.info('profiling statistics of exited threads are kept until reset')
+        env=self.env
+        profiler = RaveCreateModule(env,'Profiler')
+        trajstr = '''<trajectory>
+<configuration>
+<group name="deltatime" offset="1" dof="1" interpolation=""/>
+<group name="joint_values VP-5243I 6" offset="0" dof="1" interpolation="linear"/>
+</configuration>
+<data count="2">
+0 0 1 1 </data>
+</trajectory>
+'''
+        numthreads = 4
+        numsamples = 100
+        # every thread samples its own trajectory since sampling uses internal caches
+        trajs = []
+        for ithread in range(numthreads):
+            traj = RaveCreateTrajectory(env,'')
+            traj.deserialize(trajstr)
+            trajs.append(traj)
+
+        def samplethread(traj):
+            for isample in range(numsamples):
+                traj.Sample(isample/float(numsamples))
+
+        def getsamplestatistics():
+            output = profiler.SendJSONCommand('GetStatistics', {})
+            for statistics in output['statistics']:
+                if statistics['name'] == 'trajectory.Sample':
+                    return statistics
+            return None
+
+        try:
+            profiler.SendJSONCommand('SetEnabled', {'enabled': True, 'reset': True})
+            for iround in range(2):
+                threads = [threading.Thread(target=samplethread,args=(traj,)) for traj in trajs]
+                for t in threads:
+                    t.start()
+                for t in threads:
+                    t.join()
+                # the threads exited, their buffers are folded into the statistics
+                statistics = getsamplestatistics()
+                assert(statistics is not None)
+                assert(not statistics['isCounter'])
+                assert(statistics['count'] == (iround+1)*numthreads*numsamples)
+                assert(statistics['minNs'] <= statistics['meanNs'] <= statistics['maxNs'])
+
+            trace = profiler.SendJSONCommand('GetChromeTrace', {})
+            sampleevents = [event for event in trace['traceEvents'] if event['name'] == 'trajectory.Sample']
+            assert(len(sampleevents) > 0)
+            assert(len(set([event['tid'] for event in sampleevents])) > 1)
+
+            profiler.SendJSONCommand('Reset', {})
+            assert(getsamplestatistics() is None)
+            trace = profiler.SendJSONCommand('GetChromeTrace', {})
+            assert(len([event for event in trace['traceEvents'] if event['name'] == 'trajectory.Sample']) == 0)
+        finally:
+            profiler.SendJSONCommand('SetEnabled', {'enabled': False, 'reset': True})
+
+    def test_staterecorder(self):
+        self.log.info('recorded states are restored from cleanly closed logs and from logs without an index')
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        robot=env.GetRobots()[0]
+        with env:
+            box = RaveCreateKinBody(env,'')
+            box.SetName('box')
+            box.InitFromBoxes(array([[0,0,0,0.02,0.02,0.02]]),True)
+            env.Add(box)
+        recorder = RaveCreateModule(env,'staterecorder')
+        tempdir = tempfile.mkdtemp()
+        try:
+            filename = os.path.join(tempdir,'states.log')
+            # 2 frames per chunk, so the 5 frames are written in 3 chunks
+            assert(recorder.SendCommand('Start chunkframes 2 everystep 0 filename %s'%filename) is not None)
+            lower,upper = robot.GetDOFLimits()
+            recordedstates = []
+            for iframe in range(5):
+                timestamp = 1000*(iframe+1)
+                with env:
+                    robot.SetDOFValues(lower+(upper-lower)*(0.2+0.15*iframe))
+                    if iframe == 4:
+                        box.SetTransform(robot.GetActiveManipulator().GetTransform())
+                        robot.Grab(box)
+                    else:
+                        box.SetTransform(matrixFromPose([1,0,0,0,1+0.1*iframe,0,0.5]))
+                    recordedstates.append((timestamp, robot.GetLinkTransformations(), robot.GetDOFValues(), box.GetTransform(), iframe == 4))
+                assert(recorder.SendCommand('Record %d'%timestamp) is not None)
+            assert(recorder.SendCommand('Stop') is not None)
+            numcaptured, numdropped, numchunks, numbytes = [int(value) for value in recorder.SendCommand('GetStatistics').split()]
+            assert(numcaptured == 5 and numdropped == 0 and numchunks == 3)
+
+            def checkrestore(logfilename, expectedstates):
+                with env:
+                    robot.ReleaseAllGrabbed()
+                    robot.SetDOFValues(lower)
+                    box.SetTransform(eye(4))
+                assert(recorder.SendCommand('Open %s'%logfilename) is not None)
+                timerange = [int(value) for value in recorder.SendCommand('GetTimeRange').split()]
+                assert(timerange == [expectedstates[0][0], expectedstates[-1][0]])
+                for timestamp, linktransforms, dofvalues, boxtransform, bgrabbing in expectedstates:
+                    # restoring between two frames gives the earlier frame
+                    for restoretimestamp in [timestamp, timestamp+500]:
+                        assert(int(recorder.SendCommand('Restore %d'%restoretimestamp)) == timestamp)
+                        with env:
+                            assert(transdist(robot.GetDOFValues(),dofvalues) <= g_epsilon)
+                            assert(transdist(robot.GetLinkTransformations(),linktransforms) <= g_epsilon)
+                            assert(transdist(box.GetTransform(),boxtransform) <= g_epsilon)
+                            assert((robot.IsGrabbing(box) is not None) == bgrabbing)
+                assert(recorder.SendCommand('Restore %d'%(expectedstates[0][0]-1)) is None)
+
+            checkrestore(filename, recordedstates)
+
+            # a recorder that did not stop cleanly leaves no index, the footer is the last 16 bytes
+            data = open(filename,'rb').read()
+            indexoffset, indexnumchunks, indexmagic = struct.unpack('<QII', data[-16:])
+            assert(indexnumchunks == 3)
+            uncleanfilename = os.path.join(tempdir,'unclean.log')
+            open(uncleanfilename,'wb').write(data[:indexoffset])
+            checkrestore(uncleanfilename, recordedstates)
+            # the last chunk was only partially written, so only the first two chunks are restored
+            open(uncleanfilename,'wb').write(data[:indexoffset-4])
+            checkrestore(uncleanfilename, recordedstates[:4])
+        finally:
+            recorder.SendCommand('Stop')
+            shutil.rmtree(tempdir)
+
+    def test_collisionlods(self):
+        self.log.info('the collisionlods load attribute creates decimated geometry groups and caches them in the database')
+        env=self.env
+        # latitude/longitude sphere with about 2000 triangles, enough to be decimated
+        radius = 0.1
+        numlat, numlong = 24, 48
+        vertices = [[0,0,radius], [0,0,-radius]]
+        for ilat in range(1,numlat):
+            theta = pi*ilat/numlat
+            for ilong in range(numlong):
+                phi = 2*pi*ilong/numlong
+                vertices.append([radius*sin(theta)*cos(phi), radius*sin(theta)*sin(phi), radius*cos(theta)])
+        def ringindex(ilat, ilong):
+            return 2 + (ilat-1)*numlong + (ilong%numlong)
+        indices = []
+        for ilong in range(numlong):
+            indices.append([0, ringindex(1,ilong), ringindex(1,ilong+1)])
+            indices.append([1, ringindex(numlat-1,ilong+1), ringindex(numlat-1,ilong)])
+            for ilat in range(1,numlat-1):
+                indices.append([ringindex(ilat,ilong), ringindex(ilat+1,ilong), ringindex(ilat+1,ilong+1)])
+                indices.append([ringindex(ilat,ilong), ringindex(ilat+1,ilong+1), ringindex(ilat,ilong+1)])
+
+        # a tolerance that no previous run used, so that the first load has to decimate
+        errortolerance = float('%.6g'%(0.01+1e-6*random.randint(1,10000)))
+        lodattributes = {'collisionlods':'coarse %.6g'%errortolerance}
+        cachepattern = 'collisionlod.*.%.6g'%errortolerance
+        databasedir = os.path.dirname(RaveFindDatabaseFile('collisionlod', False))
+        tempdir = tempfile.mkdtemp()
+        try:
+            filename = os.path.join(tempdir,'sphere.dae')
+            scratchenv = Environment()
+            try:
+                body = RaveCreateKinBody(scratchenv,'')
+                body.InitFromTrimesh(TriMesh(array(vertices),array(indices,int32)),True)
+                body.SetName('sphere')
+                scratchenv.Add(body)
+                scratchenv.Save(filename)
+            finally:
+                scratchenv.Destroy()
+
+            def loadsphere():
+                with env:
+                    for body in env.GetBodies():
+                        env.Remove(body)
+                assert(env.Load(filename, lodattributes))
+                with env:
+                    assert(len(env.GetBodies()) == 1)
+                    link = env.GetBodies()[0].GetLinks()[0]
+                    assert(link.GetGroupNumGeometries('coarse') == len(link.GetGeometries()))
+                    return link.GetGeometries()[0].GetCollisionMesh(), link.GetGeometriesFromGroup('coarse')[0].GetCollisionMesh()
+
+            mesh, coarsemesh = loadsphere()
+            assert(0 < len(coarsemesh.indices) < len(mesh.indices))
+            for vertex in coarsemesh.vertices:
+                assert(min(sqrt(sum((mesh.vertices-vertex)**2,1))) <= errortolerance+g_epsilon)
+            cachefilenames = fnmatch.filter(os.listdir(databasedir), cachepattern)
+            assert(len(cachefilenames) == 1)
+            cachefilename = os.path.join(databasedir, cachefilenames[0])
+
+            # replace the cached mesh with a single triangle, which the next load has to return instead of decimating again
+            realsize = struct.unpack('<I', open(cachefilename,'rb').read(4))[0]
+            realformat = 'd' if realsize == 8 else 'f'
+            markervertices = [[0,0,0,0],[0.01,0,0,0],[0,0.01,0,0]]
+            with open(cachefilename,'wb') as f:
+                f.write(struct.pack('<III', realsize, 3, 3))
+                for vertex in markervertices:
+                    f.write(struct.pack('<4'+realformat, *vertex))
+                f.write(struct.pack('<3i', 0, 1, 2))
+            mesh, coarsemesh = loadsphere()
+            assert(len(coarsemesh.indices) == 1)
+            assert(transdist(coarsemesh.vertices, array(markervertices)[:,0:3]) <= g_epsilon)
+        finally:
+            for cachefilename in fnmatch.filter(os.listdir(databasedir), cachepattern):
+                os.remove(os.path.join(databasedir, cachefilename))
+            shutil.rmtree(tempdir)
@@ -76,3 +76,43 @@ def test_quatRotateDirection():
         T = matrixFromQuat(quatRotateDirection(sourcedir,targetdir))
         assert( transdist(dot(T[0:3,0:3],sourcedir),targetdir) <= g_epsilon )
         
+
+def test_trimeshsimplify():
+    log.info('simplified meshes should have fewer triangles and every vertex within the error tolerance of the original vertices')
+    # latitude/longitude sphere with about 5000 triangles
+    radius = 0.1
+    numlat, numlong = 40, 64
+    vertices = [[0,0,radius], [0,0,-radius]]
+    for ilat in range(1,numlat):
+        theta = pi*ilat/numlat
+        for ilong in range(numlong):
+            phi = 2*pi*ilong/numlong
+            vertices.append([radius*sin(theta)*cos(phi), radius*sin(theta)*sin(phi), radius*cos(theta)])
+    vertices = array(vertices)
+    def ringindex(ilat, ilong):
+        return 2 + (ilat-1)*numlong + (ilong%numlong)
+    indices = []
+    for ilong in range(numlong):
+        indices.append([0, ringindex(1,ilong), ringindex(1,ilong+1)])
+        indices.append([1, ringindex(numlat-1,ilong+1), ringindex(numlat-1,ilong)])
+        for ilat in range(1,numlat-1):
+            indices.append([ringindex(ilat,ilong), ringindex(ilat+1,ilong), ringindex(ilat+1,ilong+1)])
+            indices.append([ringindex(ilat,ilong), ringindex(ilat+1,ilong+1), ringindex(ilat,ilong+1)])
+    mesh = TriMesh(vertices, array(indices,int32))
+
+    for errortolerance in [0.002, 0.01, 0.03]:
+        simplified = mesh.Simplify(errortolerance)
+        assert(0 < len(simplified.indices) < len(mesh.indices))
+        assert(len(simplified.vertices) < len(mesh.vertices))
+        assert(all(simplified.indices >= 0) and all(simplified.indices < len(simplified.vertices)))
+        for triangle in simplified.indices:
+            assert(len(set(triangle)) == 3)
+        for vertex in simplified.vertices:
+            assert(min(sqrt(sum((vertices-vertex)**2,1))) <= errortolerance+g_epsilon)
+            # the clustered vertices move inside the surface, so the simplified mesh is not conservative
+            assert(sqrt(sum(vertex**2)) <= radius+g_epsilon)
+
+    # a non-positive tolerance copies the mesh
+    copied = mesh.Simplify(0)
+    assert(transdist(copied.vertices, vertices) <= g_epsilon)
+    assert(all(copied.indices == array(indices)))
@@ -549,3 +549,46 @@ class TestIkSolver(EnvironmentSetup):
         
         sol = r.GetActiveManipulator().FindIKSolution(Tee, 0)
         assert( sol is None)
+
+    def test_numericalik(self):
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        with env:
+            robot=env.GetRobots()[0]
+            manip=robot.GetActiveManipulator()
+            iksolver=RaveCreateIkSolver(env,'numericalik numseeds 2000 numthreads 2')
+            assert(manip.SetIkSolver(iksolver))
+            lower,upper = robot.GetDOFLimits(manip.GetArmIndices())
+            randomstate = numpy.random.RandomState(0)
+
+            # converges on reachable poses
+            numsuccess = 0
+            for itry in range(10):
+                values = lower + (upper-lower)*(0.1+0.8*randomstate.rand(len(lower)))
+                robot.SetDOFValues(values,manip.GetArmIndices())
+                Tgoal = manip.GetTransform()
+                robot.SetDOFValues(zeros(len(lower)),manip.GetArmIndices())
+                sol = manip.FindIKSolution(Tgoal,IkFilterOptions.IgnoreSelfCollisions)
+                if sol is not None:
+                    robot.SetDOFValues(sol,manip.GetArmIndices())
+                    assert(transdist(manip.GetTransform(),Tgoal) <= 1e-4)
+                    numsuccess += 1
+            assert(numsuccess >= 8)
+
+            # solutions respect the joint limits
+            robot.SetDOFValues(0.5*(lower+upper),manip.GetArmIndices())
+            Tgoal = manip.GetTransform()
+            newlower = lower + 0.3*(upper-lower)
+            newupper = upper - 0.3*(upper-lower)
+            robot.SetDOFLimits(newlower,newupper,manip.GetArmIndices())
+            sols = manip.FindIKSolutions(Tgoal,IkFilterOptions.IgnoreSelfCollisions)
+            assert(len(sols) > 0)
+            for sol in sols:
+                assert(all(sol >= newlower-g_epsilon) and all(sol <= newupper+g_epsilon))
+            robot.SetDOFLimits(lower,upper,manip.GetArmIndices())
+
+            # fails on targets out of reach
+            Tfar = array(Tgoal)
+            Tfar[0:3,3] += [10,0,0]
+            assert(manip.FindIKSolution(Tfar,IkFilterOptions.IgnoreSelfCollisions) is None)
+            assert(len(manip.FindIKSolutions(Tfar,IkFilterOptions.IgnoreSelfCollisions)) == 0)
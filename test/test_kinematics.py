@@ -528,6 +528,53 @@ class TestKinematics(EnvironmentSetup):
                         assert( transdist(-torquegravity, gravitypartials) < 0.1*deltastep*len(gravitypartials))
                         assert( transdist(torquegravity, testtorque_e-testtorque_e2) <= 1e-10 )
 
+    def test_inversedynamicsbatch(self):
+        self.log.info('verify batched inverse dynamics and the mass matrix, coriolis, and gravity terms')
+        env=self.env
+        with env:
+            env.GetPhysicsEngine().SetGravity([0,0,-9.8])
+            self.LoadEnv('robots/barrettwam.robot.xml')
+            body = env.GetBodies()[0]
+            dof = body.GetDOF()
+            lower,upper = body.GetDOFLimits()
+            vellimits = body.GetDOFVelocityLimits()
+            numsamples = 5
+            dofvalues = array([lower+random.rand(dof)*(upper-lower) for i in range(numsamples)])
+            dofvelocities = array([(2*random.rand(dof)-1)*vellimits for i in range(numsamples)])
+            dofaccelerations = 10*random.rand(numsamples,dof)-5
+
+            initialvalues = body.GetDOFValues()
+            initialvelocities = body.GetDOFVelocities()
+            torques = body.ComputeInverseDynamicsBatch(dofvalues.flatten(), dofvelocities.flatten(), dofaccelerations.flatten())
+            assert(torques.shape == (numsamples,dof))
+            # the batch call should restore the state of the body
+            assert(transdist(body.GetDOFValues(),initialvalues) <= g_epsilon)
+            assert(transdist(body.GetDOFVelocities(),initialvelocities) <= g_epsilon)
+            for isample in range(numsamples):
+                body.SetDOFValues(dofvalues[isample])
+                body.SetDOFVelocities(dofvelocities[isample])
+                assert(transdist(torques[isample], body.ComputeInverseDynamics(dofaccelerations[isample])) <= g_epsilon)
+
+            # velocities and accelerations default to zero
+            torques = body.ComputeInverseDynamicsBatch(dofvalues.flatten())
+            for isample in range(numsamples):
+                body.SetDOFValues(dofvalues[isample])
+                body.SetDOFVelocities(zeros(dof))
+                assert(transdist(torques[isample], body.ComputeInverseDynamics(None)) <= g_epsilon)
+
+            body.SetDOFValues(dofvalues[0])
+            body.SetDOFVelocities(dofvelocities[0])
+            M = body.ComputeMassMatrix()
+            assert(M.shape == (dof,dof))
+            assert(transdist(M, M.transpose()) <= g_epsilon)
+            for i in range(dof):
+                testaccel = zeros(dof)
+                testaccel[i] = 1.0
+                torque_m, torque_c, torque_e = body.ComputeInverseDynamics(testaccel,None,returncomponents=True)
+                assert(transdist(M[:,i], torque_m) <= g_epsilon)
+            assert(transdist(body.ComputeCoriolisTorques(), torque_c) <= g_epsilon)
+            assert(transdist(body.ComputeGravityTorques(), torque_e) <= g_epsilon)
+
     def test_hessian(self):
         self.log.info('check the jacobian and hessian computation')
         env=self.env
@@ -690,6 +737,62 @@ class TestKinematics(EnvironmentSetup):
             
             body.SetLinkEnableStates(body.GetLinkEnableStates())
 
+    def test_lightweightstatesaver(self):
+        self.log.info('state savers with Save_Lightweight should restore the same state as the regular savers')
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        robot=env.GetRobots()[0]
+        with env:
+            options = KinBody.SaveParameters.LinkTransformation|KinBody.SaveParameters.LinkEnable|KinBody.SaveParameters.Lightweight
+            lower,upper = robot.GetDOFLimits()
+            values0 = lower+random.rand(robot.GetDOF())*(upper-lower)
+            robot.SetDOFValues(values0)
+            T0 = robot.GetTransform()
+            linktransforms0 = robot.GetLinkTransformations()
+            enablestates0 = robot.GetLinkEnableStates()
+            T1 = array(T0)
+            T1[0:3,3] += [0.1,0.2,0.3]
+            for i in range(10):
+                # nested savers each take a pooled buffer
+                with robot.CreateKinBodyStateSaver(options):
+                    robot.SetDOFValues(lower+random.rand(robot.GetDOF())*(upper-lower))
+                    values1 = robot.GetDOFValues()
+                    with robot.CreateKinBodyStateSaver(options):
+                        robot.SetTransform(T1)
+                        robot.GetLinks()[-1].Enable(False)
+                    assert(transdist(robot.GetDOFValues(),values1) <= g_epsilon)
+                    assert(transdist(robot.GetTransform(),T0) <= g_epsilon)
+                    assert(all(robot.GetLinkEnableStates() == enablestates0))
+                    # a saver whose body did not change restores nothing but should still hold the same state
+                    with robot.CreateKinBodyStateSaver(options):
+                        pass
+                    assert(transdist(robot.GetDOFValues(),values1) <= g_epsilon)
+                assert(transdist(robot.GetDOFValues(),values0) <= g_epsilon)
+                assert(transdist(array(robot.GetLinkTransformations()).flatten(),array(linktransforms0).flatten()) <= g_epsilon)
+
+            # explicitly restoring in the middle updates the saved stamp, later changes are still restored
+            with robot.CreateKinBodyStateSaver(options) as statesaver:
+                robot.SetTransform(T1)
+                statesaver.Restore()
+                assert(transdist(robot.GetTransform(),T0) <= g_epsilon)
+                robot.SetDOFValues(lower)
+            assert(transdist(robot.GetDOFValues(),values0) <= g_epsilon)
+
+            # grabbed bodies are always restored
+            box = RaveCreateKinBody(env,'')
+            box.InitFromBoxes(array([[0,0,0,0.02,0.02,0.02]]),True)
+            box.SetName('box')
+            env.Add(box)
+            box.SetTransform(robot.GetActiveManipulator().GetTransform())
+            robot.Grab(box)
+            Tbox = box.GetTransform()
+            with robot.CreateRobotStateSaver(options|KinBody.SaveParameters.GrabbedBodies):
+                robot.SetDOFValues(lower)
+                assert(transdist(box.GetTransform(),Tbox) > g_epsilon)
+            assert(transdist(robot.GetDOFValues(),values0) <= g_epsilon)
+            assert(transdist(box.GetTransform(),Tbox) <= g_epsilon)
+            robot.ReleaseAllGrabbed()
+
     def test_geometrychange(self):
         self.log.info('change geometry and test if changes are updated')
         env=self.env
@@ -882,6 +985,78 @@ class TestKinematics(EnvironmentSetup):
         newspec=pickle.loads(s)
         assert(newspec==spec)
 
+    def test_specificationconversion(self):
+        self.log.info('ConvertData prepares a plan for every pair of specifications, the plan has to convert like ConvertGroupData does group by group')
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        with env:
+            robot=env.GetRobots()[0]
+            name = robot.GetName()
+            robot.SetDOFValues(0.1*arange(1,robot.GetDOF()+1))
+            robot.SetTransform(matrixFromPose([cos(0.25),0,0,sin(0.25),0.5,-0.2,0.1]))
+
+            def CreateSpec(groups):
+                spec = ConfigurationSpecification()
+                for groupname, dof, interpolation in groups:
+                    spec.AddGroup(groupname, dof, interpolation)
+                return spec
+
+            def ConvertDataReference(sourcespec, targetspec, sourcedata, numpoints, filluninitialized):
+                # converts group by group like ConvertData did before it prepared plans
+                targetdata = zeros(targetspec.GetDOF()*numpoints)
+                for gtarget in targetspec.GetGroups():
+                    gsource = sourcespec.FindCompatibleGroup(gtarget.name,False)
+                    if gsource is not None:
+                        targetdata = sourcespec.ConvertGroupData(targetdata,targetspec,gtarget,sourcedata,gsource,numpoints,env,filluninitialized)
+                    elif filluninitialized:
+                        tokens = gtarget.name.split()
+                        if tokens[0] == 'joint_values':
+                            defaultvalues = env.GetKinBody(tokens[1]).GetDOFValues([int(index) for index in tokens[2:]])
+                        elif tokens[0] == 'affine_transform':
+                            defaultvalues = RaveGetAffineDOFValuesFromTransform(env.GetKinBody(tokens[1]).GetTransform(),int(tokens[2]))
+                        elif tokens[0] == 'outputSignals':
+                            defaultvalues = -ones(gtarget.dof)
+                        else:
+                            defaultvalues = zeros(gtarget.dof)
+                        for ipoint in range(numpoints):
+                            offset = ipoint*targetspec.GetDOF()+gtarget.offset
+                            targetdata[offset:(offset+gtarget.dof)] = defaultvalues
+                return targetdata
+
+            transformdofs = int(DOFAffine.Transform)
+            xyrotationdofs = int(DOFAffine.X)|int(DOFAffine.Y)|int(DOFAffine.RotationAxis)
+            armspec = CreateSpec([('joint_values %s 0 1 2 3 4 5 6'%name,7,'linear')])
+            testspecs = [
+                # reordered joint indices
+                (armspec, CreateSpec([('joint_values %s 6 4 2 0 1 3 5'%name,7,'linear')])),
+                # partial overlap, the joints 0, 1 and 8 are not in the source
+                (CreateSpec([('joint_values %s 2 3 4 7'%name,4,'linear')]), CreateSpec([('joint_values %s 0 1 2 3 7 8'%name,6,'linear')])),
+                # missing groups
+                (armspec, CreateSpec([('joint_values %s 0 1 2 3 4 5 6'%name,7,'linear'), ('joint_velocities %s 0 1 2 3 4 5 6'%name,7,'next'), ('joint_values %s 7 8 9 10'%name,4,'linear'), ('outputSignals',3,'next'), ('affine_transform %s %d'%(name,transformdofs),7,'linear'), ('deltatime',1,'')])),
+                # outputSignals in both
+                (CreateSpec([('outputSignals',3,'next'), ('joint_values %s 0 1'%name,2,'linear')]), CreateSpec([('joint_values %s 1 0'%name,2,'linear'), ('outputSignals',3,'next')])),
+                # affine groups with the same and with different dofs
+                (CreateSpec([('affine_transform %s %d'%(name,transformdofs),7,'linear'), ('joint_values %s 0 1'%name,2,'linear')]), CreateSpec([('joint_values %s 0 1'%name,2,'linear'), ('affine_transform %s %d'%(name,transformdofs),7,'linear')])),
+                (CreateSpec([('affine_transform %s %d'%(name,transformdofs),7,'linear')]), CreateSpec([('affine_transform %s %d'%(name,xyrotationdofs),3,'linear')])),
+            ]
+            numpoints = 5
+            for itry in range(2):
+                # the second pass converts with the cached plans
+                for sourcespec, targetspec in testspecs:
+                    sourcedata = zeros(sourcespec.GetDOF()*numpoints)
+                    for ipoint in range(numpoints):
+                        pointdata = sourcedata[ipoint*sourcespec.GetDOF():(ipoint+1)*sourcespec.GetDOF()]
+                        pointdata[:] = 0.01*(ipoint+1)*arange(1,sourcespec.GetDOF()+1)
+                        for gsource in sourcespec.GetGroups():
+                            if gsource.name.startswith('affine_transform'):
+                                # the rotation has to be a valid quaternion
+                                pointdata[gsource.offset:(gsource.offset+gsource.dof)] = r_[0.1*ipoint,0.2,-0.1*ipoint,quatFromAxisAngle([0,0,0.3*ipoint])]
+                    for filluninitialized in [True, False]:
+                        expecteddata = ConvertDataReference(sourcespec, targetspec, sourcedata, numpoints, filluninitialized)
+                        targetdata = sourcespec.ConvertData(targetspec, sourcedata, numpoints, env, filluninitialized)
+                        assert(len(targetdata) == len(expecteddata))
+                        assert(numpy.max(abs(targetdata-expecteddata)) <= g_epsilon)
+
     def test_enablelinks(self):
         env=self.env
         self.LoadEnv('data/lab1.env.xml')
@@ -1120,3 +1295,39 @@ class TestKinematics(EnvironmentSetup):
         assert(robot.CheckSelfCollision())
         robot.SetNonCollidingConfiguration()
         assert(not robot.CheckSelfCollision())
+
+    def test_getintoarrays(self):
+        self.log.info('the Into getters should fill the given arrays with the same values as the copying getters')
+        env=self.env
+        robot=self.LoadRobot('robots/barrettwam.robot.xml')
+        with env:
+            lower,upper = robot.GetDOFLimits()
+            robot.SetDOFValues(lower+0.3*(upper-lower))
+            robot.SetDOFVelocities(0.1*arange(1,robot.GetDOF()+1))
+
+            dofvalues = numpy.empty(robot.GetDOF())
+            robot.GetDOFValuesInto(dofvalues)
+            assert(dofvalues.shape == (robot.GetDOF(),))
+            assert(transdist(dofvalues, robot.GetDOFValues()) <= g_epsilon)
+
+            dofvelocities = numpy.empty(robot.GetDOF())
+            robot.GetDOFVelocitiesInto(dofvelocities)
+            assert(dofvelocities.shape == (robot.GetDOF(),))
+            assert(transdist(dofvelocities, robot.GetDOFVelocities()) <= g_epsilon)
+
+            linkposes = numpy.empty((len(robot.GetLinks()),7))
+            robot.GetLinkTransformPosesInto(linkposes)
+            assert(transdist(linkposes, robot.GetLinkTransformPoses()) <= g_epsilon)
+            for ilink,link in enumerate(robot.GetLinks()):
+                assert(transdist(linkposes[ilink], link.GetTransformPose()) <= g_epsilon)
+
+            # the arrays are reused, so changing the state has to show up in the next call
+            robot.SetDOFValues(lower+0.6*(upper-lower))
+            robot.GetDOFValuesInto(dofvalues)
+            assert(transdist(dofvalues, robot.GetDOFValues()) <= g_epsilon)
+            robot.GetLinkTransformPosesInto(linkposes)
+            assert(transdist(linkposes, robot.GetLinkTransformPoses()) <= g_epsilon)
+
+            # arrays of the wrong size are rejected
+            assert_raises(openrave_exception, robot.GetDOFValuesInto, numpy.empty(robot.GetDOF()+1))
+            assert_raises(openrave_exception, robot.GetLinkTransformPosesInto, numpy.empty((len(robot.GetLinks())-1,7)))
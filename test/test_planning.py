@@ -247,6 +247,42 @@ class RunPlanning(EnvironmentSetup):
             traj = basemanip.MoveHandStraight(direction=array([ 0.78915764,  0.13771766,  0.59855163]),starteematrix=Tee,stepsize=0.01,minsteps=60,maxsteps=80,execute=False,outputtrajobj=True)
             self.RunTrajectory(robot,traj)
             
+    def test_movehandstraightdifferentialik(self):
+        self.log.info('MoveHandStraight with differential ik has to keep the end effector on the line')
+        env = self.env
+        with env:
+            self.LoadEnv('data/lab1.env.xml')
+            robot = env.GetRobots()[0]
+            ikmodel = databases.inversekinematics.InverseKinematicsModel(robot=robot,iktype=IkParameterization.Type.Transform6D)
+            if not ikmodel.load():
+                ikmodel.autogenerate()
+            manip = robot.GetActiveManipulator()
+            armindices = manip.GetArmIndices()
+            basemanip = interfaces.BaseManipulation(robot)
+            robot.SetDOFValues(array([ -5.90848599e-02, 9.54294051e-01, 0, 2.22628339e+00, 9.99200722e-15, -3.89847865e-02, 1.51171147e+00, 0, 0, 0, 0]))
+            assert(not env.CheckCollision(robot))
+            initialvalues = robot.GetDOFValues()
+            Tstart = manip.GetTransform()
+            for direction in [array([0,0,-1.0]), array([0,0,1.0])]:
+                robot.SetDOFValues(initialvalues)
+                stepsize = 0.004
+                traj = basemanip.MoveHandStraight(direction=direction,stepsize=stepsize,minsteps=5,maxsteps=10,execute=False,outputtrajobj=True,differentialik=1)
+                spec = traj.GetConfigurationSpecification()
+                distances = []
+                with robot:
+                    for iwaypoint in range(traj.GetNumWaypoints()):
+                        robot.SetDOFValues(spec.ExtractJointValues(traj.GetWaypoint(iwaypoint),robot,armindices,0),armindices)
+                        T = manip.GetTransform()
+                        offset = T[0:3,3]-Tstart[0:3,3]
+                        distance = dot(offset,direction)
+                        # the tracked points are on the line, the orientation is kept
+                        assert(sqrt(sum((offset-distance*direction)**2)) <= 1e-3)
+                        assert(sum(abs(T[0:3,0:3]-Tstart[0:3,0:3])) <= 1e-2)
+                        distances.append(distance)
+                assert(distances[0] <= g_epsilon)
+                assert(distances[-1] >= 5*stepsize-1e-3)
+                assert(all(diff(distances) >= -1e-4))
+
     def test_movetohandpositiongrab(self):
         env=self.env
         self.LoadEnv('data/hanoi_complex2.env.xml')
@@ -613,6 +649,56 @@ class RunPlanning(EnvironmentSetup):
             self.RunTrajectory(robot,traj1)
             self.RunTrajectory(robot,traj2)
 
+    def test_lazyedgevalidation(self):
+        self.log.info('BiRRT with lazy edge validation has to return a path whose every segment is collision free')
+        env = self.env
+        self.LoadEnv('data/hironxtable.env.xml')
+        robot = env.GetRobots()[0]
+        with env:
+            manip = robot.SetActiveManipulator('leftarm_torso')
+            robot.SetActiveDOFs(manip.GetArmIndices())
+            start = robot.GetActiveDOFValues()
+            goal = array(start)
+            goal[0] = -0.556
+            goal[3] = -1.86
+            robot.SetActiveDOFValues(goal)
+            assert(not env.CheckCollision(robot) and not robot.CheckSelfCollision())
+            # clutter the straight line between the start and the goal so that the trees have to go around
+            for i, alpha in enumerate([0.3,0.5,0.7]):
+                robot.SetActiveDOFValues(start+alpha*(goal-start))
+                box = RaveCreateKinBody(env,'')
+                box.InitFromBoxes(array([r_[manip.GetTransform()[0:3,3],0.03,0.03,0.03]]),True)
+                box.SetName('clutter%d'%i)
+                env.Add(box,True)
+                for values in [start, goal]:
+                    robot.SetActiveDOFValues(values)
+                    if env.CheckCollision(robot,box):
+                        env.Remove(box)
+                        break
+            robot.SetActiveDOFValues(start)
+            assert(not env.CheckCollision(robot) and not robot.CheckSelfCollision())
+
+            for lazy in [1, 0]:
+                for iplan in range(3):
+                    parameters = Planner.PlannerParameters()
+                    parameters.SetRobotActiveJoints(robot)
+                    parameters.SetGoalConfig(goal)
+                    parameters.SetExtraParameters('<lazyedgevalidation>%d</lazyedgevalidation>'%lazy)
+                    parameters.SetMaxIterations(5000)
+                    # check the raw path of the planner
+                    parameters.SetPostProcessing('', '')
+                    planner = RaveCreatePlanner(env,'BiRRT')
+                    assert(planner.InitPlan(robot,parameters))
+                    traj = RaveCreateTrajectory(env,'')
+                    assert(planner.PlanPath(traj).statusCode & PlannerStatusCode.HasSolution)
+                    waypoints = traj.GetWaypoints(0,traj.GetNumWaypoints(),robot.GetActiveConfigurationSpecification()).reshape((traj.GetNumWaypoints(),robot.GetActiveDOF()))
+                    assert(transdist(waypoints[0],start) <= g_epsilon)
+                    assert(transdist(waypoints[-1],goal) <= g_epsilon)
+                    zerovelocities = zeros(robot.GetActiveDOF())
+                    for q0, q1 in zip(waypoints[:-1], waypoints[1:]):
+                        assert(parameters.CheckPathAllConstraints(q0,q1,zerovelocities,zerovelocities,0,Interval.Closed) == 0)
+                    robot.SetActiveDOFValues(start)
+
     def test_jittertransform(self):
         env=self.env
         self.LoadEnv('data/lab1.env.xml')
@@ -627,6 +713,36 @@ class RunPlanning(EnvironmentSetup):
             assert(success)
             assert(not env.CheckCollision(collisionbody))
 
+    def test_grasperforceclosuremethods(self):
+        env = self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot=env.GetRobots()[0]
+        gmodel = databases.grasping.GraspingModel(robot=robot,target=env.GetKinBody('mug1'))
+        if not gmodel.load():
+            gmodel.numthreads = 2 # at least two threads
+            gmodel.generate(approachrays=gmodel.computeBoxApproachRays(delta=0.04))
+            gmodel.save()
+
+        with env:
+            grasp = gmodel.grasps[0]
+            results = {}
+            for method in ['qhull', 'wrenchspace']:
+                with robot:
+                    robot.SetActiveManipulator(gmodel.manip)
+                    robot.SetTransform(eye(4))
+                    robot.SetDOFValues(grasp[gmodel.graspindices.get('igrasppreshape')],gmodel.manip.GetGripperIndices())
+                    robot.SetActiveDOFs(gmodel.manip.GetGripperIndices(),DOFAffine.X|DOFAffine.Y|DOFAffine.Z)
+                    contacts,finalconfig,mindist,volume = gmodel.grasper.Grasp(direction=grasp[gmodel.graspindices.get('igraspdir')], roll=grasp[gmodel.graspindices.get('igrasproll')], position=grasp[gmodel.graspindices.get('igrasppos')], standoff=grasp[gmodel.graspindices.get('igraspstandoff')], manipulatordirection=grasp[gmodel.graspindices.get('imanipulatordirection')], target=gmodel.target, forceclosure=True, execute=False, outputfinal=True, translationstepmult=gmodel.translationstepmult, finestep=gmodel.finestep, forceclosuremethod=method)
+                    results[method] = (mindist, volume)
+
+            qhullmindist, qhullvolume = results['qhull']
+            mindist, volume = results['wrenchspace']
+            self.log.info('qhull mindist=%e volume=%e, wrenchspace mindist=%e volume=%e', qhullmindist, qhullvolume, mindist, volume)
+            assert(qhullmindist > 0)
+            # both compute the distance of the origin to the hull, only the wrenchspace volume is a lower bound
+            assert(abs(mindist-qhullmindist) <= 1e-6*max(1.0,qhullmindist))
+            assert(volume > 0 and volume <= qhullvolume*(1+1e-6))
+
 #generate_classes(RunPlanning, globals(), [('ode','ode'),('bullet','bullet')])
 
 class test_ode(RunPlanning):
@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 from common_test_openrave import *
+import threading
 
 class TestTrajectory(EnvironmentSetup):
 
@@ -892,3 +893,218 @@ class TestTrajectory(EnvironmentSetup):
         planningutils.SegmentTrajectory(traj, startoffset, duration)
         assert( abs(traj.GetDuration() - (duration-startoffset)) <= g_epsilon )
 
+
+    def test_sampleinto(self):
+        env=self.env
+        trajstr = '''<trajectory>
+<configuration>
+<group name="deltatime" offset="2" dof="1" interpolation=""/>
+<group name="joint_velocities VP-5243I 6" offset="1" dof="1" interpolation="linear"/>
+<group name="joint_values VP-5243I 6" offset="0" dof="1" interpolation="quadratic"/>
+</configuration>
+<data count="2">
+0.009999999999999789 0 0 0.01 0 1.097258033075657e-08 </data>
+</trajectory>
+'''
+        traj=RaveCreateTrajectory(env, '')
+        traj.deserialize(trajstr)
+        dof = traj.GetConfigurationSpecification().GetDOF()
+        times = linspace(0, traj.GetDuration(), 17)
+        points = traj.SamplePoints2D(times)
+        assert(points.shape == (len(times), dof))
+        out = zeros((len(times), dof))
+        traj.SamplePoints2DInto(out, times)
+        assert(transdist(out, points) <= g_epsilon)
+        out1 = zeros(dof)
+        traj.SampleInto(out1, times[5])
+        assert(transdist(out1, traj.Sample(times[5])) <= g_epsilon)
+        assert(transdist(traj.GetAllWaypoints2D()[-1], traj.GetWaypoint(-1)) <= g_epsilon)
+
+        # the timing of the trajectory is recomputed on the first sample after a modification, which has to happen before the GIL is released
+        waypoint = traj.GetWaypoint(-1)
+        waypoint[2] = 0.02
+        traj.Insert(traj.GetNumWaypoints(), waypoint)
+        times = linspace(0, traj.GetDuration(), 17)
+        expectedpoints = array([traj.Sample(sampletime) for sampletime in times])
+        outs = [zeros((len(times), dof)) for ithread in range(4)]
+        threads = [threading.Thread(target=traj.SamplePoints2DInto, args=(out, times)) for out in outs]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        for out in outs:
+            assert(transdist(out, expectedpoints) <= g_epsilon)
+        traj.Insert(traj.GetNumWaypoints(), waypoint)
+        traj.SampleInto(out1, traj.GetDuration())
+        assert(transdist(out1, traj.GetWaypoint(-1)) <= g_epsilon)
+
+    def test_quinticsmootherlimits(self):
+        self.log.info('the quintic smoother output should respect the position, velocity and acceleration limits')
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        robot=env.GetRobots()[0]
+        with env:
+            robot.SetActiveDOFs(robot.GetActiveManipulator().GetArmIndices())
+            dof = robot.GetActiveDOF()
+            robot.SetDOFJerkLimits(100*ones(robot.GetDOF()))
+            lower,upper = robot.GetActiveDOFLimits()
+            vellimits = robot.GetActiveDOFMaxVel()
+            accellimits = robot.GetActiveDOFMaxAccel()
+            basevalues = robot.GetActiveDOFValues()
+            traj = RaveCreateTrajectory(env,'')
+            traj.Init(robot.GetActiveConfigurationSpecification('linear'))
+            for i,delta in enumerate([0, 0.4, -0.3, 0.2]):
+                # alternate the direction of the dofs so that several of them hit their extrema inside a chunk
+                waypoint = basevalues + delta*array([(-1)**(i+j) for j in range(dof)])
+                traj.Insert(traj.GetNumWaypoints(), numpy.minimum(numpy.maximum(waypoint, lower+0.01), upper-0.01))
+            ret=planningutils.SmoothActiveDOFTrajectory(traj,robot,maxvelmult=1,maxaccelmult=1,plannername='quinticsmoother')
+            assert(ret.statusCode==PlannerStatusCode.HasSolution)
+            spec = traj.GetConfigurationSpecification()
+            indices = robot.GetActiveDOFIndices()
+            for t in linspace(0, traj.GetDuration(), 1001):
+                data = traj.Sample(t)
+                values = spec.ExtractJointValues(data,robot,indices,0)
+                velocities = spec.ExtractJointValues(data,robot,indices,1)
+                accelerations = spec.ExtractJointValues(data,robot,indices,2)
+                assert(all(values >= lower-g_epsilon) and all(values <= upper+g_epsilon))
+                assert(all(abs(velocities) <= vellimits*(1+1e-6)+g_epsilon))
+                assert(all(abs(accelerations) <= accellimits*(1+1e-6)+g_epsilon))
+
+    def test_verifytrajectoryparallel(self):
+        self.log.info('the parallel verifier should agree with the sequential one, including on collisions in the last shard')
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        robot=env.GetRobots()[0]
+        with env:
+            robot.SetActiveDOFs(robot.GetActiveManipulator().GetArmIndices())
+            finalvalues = numpy.minimum(0.5,robot.GetActiveDOFLimits()[1])
+            traj = RaveCreateTrajectory(env,'')
+            traj.Init(robot.GetActiveConfigurationSpecification())
+            traj.Insert(0,zeros(robot.GetActiveDOF()))
+            traj.Insert(1,finalvalues)
+            traj.Insert(2,zeros(robot.GetActiveDOF()))
+            ret=planningutils.RetimeActiveDOFTrajectory(traj,robot,False,maxvelmult=1,maxaccelmult=1,plannername='parabolictrajectoryretimer')
+            assert(ret.statusCode==PlannerStatusCode.HasSolution)
+
+            verifier = planningutils.ParallelTrajectoryVerifier(4)
+            for itry in range(3):
+                # repeated calls reuse the cached clones
+                planningutils.VerifyTrajectory(None,traj,samplingstep=0.002)
+                planningutils.VerifyTrajectoryParallel(None,traj,samplingstep=0.002,numthreads=4)
+                verifier.VerifyTrajectory(None,traj,samplingstep=0.002)
+
+            # put a small box where the hand is at 80% of the trajectory, which is inside the last of the 4 shards and away from every waypoint
+            activespec = robot.GetActiveConfigurationSpecification()
+            robot.SetActiveDOFValues(traj.Sample(0.8*traj.GetDuration(),activespec))
+            box = RaveCreateKinBody(env,'')
+            box.SetName('obstacle')
+            box.InitFromBoxes(array([[0,0,0,0.02,0.02,0.02]]),True)
+            box.SetTransform(robot.GetActiveManipulator().GetTransform())
+            env.Add(box)
+            assert(env.CheckCollision(robot,box))
+            for iwaypoint in range(traj.GetNumWaypoints()):
+                robot.SetActiveDOFValues(traj.GetWaypoint(iwaypoint,activespec))
+                assert(not env.CheckCollision(robot,box))
+
+            parameters = Planner.PlannerParameters()
+            parameters.SetRobotActiveJoints(robot)
+            for verifyfn in [lambda params: planningutils.VerifyTrajectory(params,traj,samplingstep=0.002),
+                             lambda params: planningutils.VerifyTrajectoryParallel(params,traj,samplingstep=0.002,numthreads=4),
+                             lambda params: verifier.VerifyTrajectory(params,traj,samplingstep=0.002)]:
+                # SetRobotActiveJoints installs functions the clones cannot reproduce, so the parallel verifiers fall back to the sequential check
+                for params in [None, parameters]:
+                    try:
+                        verifyfn(params)
+                        raise ValueError('collision with the obstacle was not reported')
+                    except openrave_exception as ex:
+                        pass
+
+            # the cached clones have to follow the environment once the obstacle is gone
+            box.SetTransform(matrixFromPose([1,0,0,0,5,5,5]))
+            planningutils.VerifyTrajectoryParallel(None,traj,samplingstep=0.002,numthreads=4)
+            verifier.VerifyTrajectory(None,traj,samplingstep=0.002)
+
+    def test_toppraretimer(self):
+        self.log.info('toppra output should respect the velocity, acceleration and torque limits at its grid points and be as fast as the parabolic retimer')
+        env=self.env
+        self.LoadEnv('robots/barrettwam.robot.xml')
+        robot=env.GetRobots()[0]
+        with env:
+            armindices = robot.GetActiveManipulator().GetArmIndices()
+            robot.SetActiveDOFs(armindices)
+            dof = robot.GetActiveDOF()
+            vellimits = robot.GetActiveDOFMaxVel()
+            accellimits = robot.GetActiveDOFMaxAccel()
+            lower,upper = robot.GetActiveDOFLimits()
+            waypoints = [zeros(dof), numpy.minimum(0.5,upper-0.01), numpy.maximum(-0.3,lower+0.01)]
+            origtraj = RaveCreateTrajectory(env,'')
+            origtraj.Init(robot.GetActiveConfigurationSpecification())
+            for waypoint in waypoints:
+                origtraj.Insert(origtraj.GetNumWaypoints(),waypoint)
+
+            def retime(plannername, plannerparameters=''):
+                traj = RaveClone(origtraj,0)
+                ret = planningutils.RetimeActiveDOFTrajectory(traj,robot,False,maxvelmult=1,maxaccelmult=1,plannername=plannername,plannerparameters=plannerparameters)
+                assert(ret.statusCode==PlannerStatusCode.HasSolution)
+                return traj
+
+            def getwaypointstates(traj):
+                # the limits are enforced at the grid points, which are the waypoints of the output
+                spec = traj.GetConfigurationSpecification()
+                for iwaypoint in range(traj.GetNumWaypoints()):
+                    data = traj.GetWaypoint(iwaypoint)
+                    yield spec.ExtractJointValues(data,robot,armindices,0), spec.ExtractJointValues(data,robot,armindices,1), spec.ExtractJointValues(data,robot,armindices,2)
+
+            def computetorques(values, velocities, accelerations):
+                with robot.CreateRobotStateSaver(KinBody.SaveParameters.LinkTransformation|KinBody.SaveParameters.LinkVelocities):
+                    robot.SetActiveDOFValues(values)
+                    fullvelocities = zeros(robot.GetDOF())
+                    fullvelocities[armindices] = velocities
+                    robot.SetDOFVelocities(fullvelocities)
+                    fullaccelerations = zeros(robot.GetDOF())
+                    fullaccelerations[armindices] = accelerations
+                    return robot.ComputeInverseDynamics(fullaccelerations)[armindices]
+
+            orgtorquelimits = robot.GetDOFTorqueLimits()
+            try:
+                # without torque limits the path is the same as the parabolic retimer's, so the durations only differ by the discretization
+                fulltorquelimits = zeros(robot.GetDOF())
+                robot.SetDOFTorqueLimits(fulltorquelimits)
+                parabolictraj = retime('parabolictrajectoryretimer')
+                toppratraj = retime('toppratrajectoryretimer','<gridpoints>200</gridpoints>')
+                assert(abs(toppratraj.GetDuration()-parabolictraj.GetDuration()) <= 0.05*parabolictraj.GetDuration())
+                maxtorques = zeros(dof)
+                maxstatictorques = zeros(dof)
+                for values, velocities, accelerations in getwaypointstates(toppratraj):
+                    assert(all(values >= lower-g_epsilon) and all(values <= upper+g_epsilon))
+                    assert(all(abs(velocities) <= vellimits*(1+1e-6)+g_epsilon))
+                    assert(all(abs(accelerations) <= accellimits*(1+1e-6)+g_epsilon))
+                    maxtorques = numpy.maximum(maxtorques, abs(computetorques(values, velocities, accelerations)))
+                    maxstatictorques = numpy.maximum(maxstatictorques, abs(computetorques(values, zeros(dof), zeros(dof))))
+
+                # torque limits below the unconstrained torques, but above gravity so that the path stays controllable
+                torquelimits = numpy.maximum(0.7*maxtorques, 1.2*maxstatictorques+0.1)
+                fulltorquelimits[armindices] = torquelimits
+                robot.SetDOFTorqueLimits(fulltorquelimits)
+                torquetraj = retime('toppratrajectoryretimer','<gridpoints>200</gridpoints>')
+                assert(torquetraj.GetDuration() >= toppratraj.GetDuration()-g_epsilon)
+                for values, velocities, accelerations in getwaypointstates(torquetraj):
+                    assert(all(abs(velocities) <= vellimits*(1+1e-6)+g_epsilon))
+                    assert(all(abs(accelerations) <= accellimits*(1+1e-6)+g_epsilon))
+                    assert(all(abs(computetorques(values, velocities, accelerations)) <= torquelimits*(1+1e-3)+1e-6))
+
+                # torque limits that cannot even hold the arm against gravity are ignored when the configuration space is not the active dofs
+                fulltorquelimits[:] = 1e-3
+                robot.SetDOFTorqueLimits(fulltorquelimits)
+                otherindices = range(robot.GetDOF()-dof, robot.GetDOF())
+                otherspec = robot.GetConfigurationSpecificationIndices(otherindices,'linear')
+                traj = RaveCreateTrajectory(env,'')
+                traj.Init(otherspec)
+                traj.Insert(0,r_[robot.GetDOFValues(otherindices),robot.GetDOFValues(otherindices)+0.1])
+                parameters = Planner.PlannerParameters()
+                parameters.SetConfigurationSpecification(env,otherspec)
+                planner = RaveCreatePlanner(env,'toppratrajectoryretimer')
+                assert(planner.InitPlan(robot,parameters))
+                assert(planner.PlanPath(traj).statusCode & PlannerStatusCode.HasSolution)
+            finally:
+                robot.SetDOFTorqueLimits(orgtorquelimits)